@@ -0,0 +1,224 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_ioStream_file.h>
+#include <cxa_stringUtils.h>
+
+
+// ******** local macro definitions ********
+#define DEFAULT_NUM_REPEATS				7
+
+#ifndef CXA_BENCH_VERSION
+	#define CXA_BENCH_VERSION			"unknown"
+#endif
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static uint64_t getTime_ns(void);
+static int compareDoubles(const void* aIn, const void* bIn);
+static void printUsage(const char *const progNameIn);
+
+
+// ********  local variable declarations *********
+static const char* filter = NULL;
+static size_t numRepeats = DEFAULT_NUM_REPEATS;
+
+static cxa_ioStream_file_t ios_stderr;
+
+static cxa_bench_result_t results[CXA_BENCH_MAXNUM_RESULTS];
+static size_t numResults = 0;
+
+static size_t numChecksPassed = 0;
+static size_t numChecksFailed = 0;
+
+
+// ******** global function implementations ********
+void cxa_bench_init(const char *const filterIn, size_t numRepeatsIn)
+{
+	filter = filterIn;
+	numRepeats = (numRepeatsIn == 0) ? DEFAULT_NUM_REPEATS : numRepeatsIn;
+	if( numRepeats > CXA_BENCH_MAXNUM_REPEATS ) numRepeats = CXA_BENCH_MAXNUM_REPEATS;
+	numResults = 0;
+	numChecksPassed = 0;
+	numChecksFailed = 0;
+}
+
+
+void cxa_bench_run(const char *const nameIn, size_t numItersIn, size_t bytesPerIterIn, cxa_bench_cb_run_t cbIn, void* userVarIn)
+{
+	cxa_assert(nameIn);
+	cxa_assert(numItersIn > 0);
+	cxa_assert(cbIn);
+
+	if( (filter != NULL) && (strstr(nameIn, filter) == NULL) ) return;
+	cxa_assert(numResults < CXA_BENCH_MAXNUM_RESULTS);
+
+	// warm up caches / branch predictors (not recorded)
+	cbIn(numItersIn, userVarIn);
+
+	double nsPerIter[CXA_BENCH_MAXNUM_REPEATS];
+	for( size_t i = 0; i < numRepeats; i++ )
+	{
+		uint64_t startTime_ns = getTime_ns();
+		cbIn(numItersIn, userVarIn);
+		nsPerIter[i] = (double)(getTime_ns() - startTime_ns) / (double)numItersIn;
+	}
+	qsort(nsPerIter, numRepeats, sizeof(*nsPerIter), compareDoubles);
+
+	cxa_bench_result_t* newResult = &results[numResults++];
+	cxa_stringUtils_copy(newResult->name, nameIn, sizeof(newResult->name));
+	newResult->numIters = numItersIn;
+	newResult->bytesPerIter = bytesPerIterIn;
+	newResult->best_nsPerIter = nsPerIter[0];
+	newResult->median_nsPerIter = nsPerIter[numRepeats / 2];
+
+	fprintf(stderr, "%-48s %12.1f ns/op (best %.1f)\n", newResult->name, newResult->median_nsPerIter, newResult->best_nsPerIter);
+}
+
+
+void cxa_bench_check(const char *const nameIn, cxa_bench_cb_check_t cbIn, void* userVarIn)
+{
+	cxa_assert(nameIn);
+	cxa_assert(cbIn);
+
+	if( (filter != NULL) && (strstr(nameIn, filter) == NULL) ) return;
+
+	bool wasSuccessful = cbIn(userVarIn);
+	if( wasSuccessful ) numChecksPassed++;
+	else numChecksFailed++;
+
+	fprintf(stderr, "%-48s %12s\n", nameIn, wasSuccessful ? "ok" : "FAILED");
+}
+
+
+void cxa_bench_writeJson(FILE* fileIn)
+{
+	cxa_assert(fileIn);
+
+	fprintf(fileIn, "{\n");
+	fprintf(fileIn, "\t\"version\": \"%s\",\n", CXA_BENCH_VERSION);
+	fprintf(fileIn, "\t\"compiler\": \"%s\",\n", __VERSION__);
+	fprintf(fileIn, "\t\"repeats\": %zu,\n", numRepeats);
+	fprintf(fileIn, "\t\"checks\": {\"passed\": %zu, \"failed\": %zu},\n", numChecksPassed, numChecksFailed);
+	fprintf(fileIn, "\t\"results\": [");
+	for( size_t i = 0; i < numResults; i++ )
+	{
+		cxa_bench_result_t* currResult = &results[i];
+
+		fprintf(fileIn, "%s\n\t\t{\"name\": \"%s\", \"iterations\": %zu, \"median_ns_per_op\": %.3f, \"best_ns_per_op\": %.3f, \"ops_per_sec\": %.0f",
+				((i == 0) ? "" : ","), currResult->name, currResult->numIters,
+				currResult->median_nsPerIter, currResult->best_nsPerIter,
+				(currResult->median_nsPerIter > 0.0) ? (1.0e9 / currResult->median_nsPerIter) : 0.0);
+		if( currResult->bytesPerIter > 0 )
+		{
+			fprintf(fileIn, ", \"bytes_per_op\": %zu, \"mb_per_sec\": %.3f", currResult->bytesPerIter,
+					(currResult->median_nsPerIter > 0.0) ? ((double)currResult->bytesPerIter * 1.0e3 / currResult->median_nsPerIter) : 0.0);
+		}
+		fprintf(fileIn, "}");
+	}
+	fprintf(fileIn, "\n\t]\n}\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char* outputPath = NULL;
+	const char* filterIn = NULL;
+	size_t numRepeatsIn = DEFAULT_NUM_REPEATS;
+
+	int opt;
+	while( (opt = getopt(argc, argv, "o:f:r:h")) != -1 )
+	{
+		switch( opt )
+		{
+			case 'o':
+				outputPath = optarg;
+				break;
+
+			case 'f':
+				filterIn = optarg;
+				break;
+
+			case 'r':
+				numRepeatsIn = (size_t)strtoul(optarg, NULL, 10);
+				break;
+
+			default:
+				printUsage(argv[0]);
+				return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	// make sure failed asserts are visible
+	cxa_ioStream_file_init(&ios_stderr);
+	cxa_ioStream_file_setFile(&ios_stderr, stderr);
+	cxa_assert_setIoStream(&ios_stderr.super);
+
+	cxa_bench_init(filterIn, numRepeatsIn);
+
+	cxa_bench_suite_collections();
+	cxa_bench_suite_mqtt();
+	cxa_bench_suite_mqttRpc();
+	cxa_bench_suite_protocolParsers();
+	cxa_bench_suite_stateMachine();
+	cxa_bench_suite_btle();
+	cxa_bench_suite_nvs();
+	cxa_bench_suite_network();
+	cxa_bench_suite_http();
+	cxa_bench_suite_misc();
+
+	FILE* outFile = (outputPath != NULL) ? fopen(outputPath, "w") : stdout;
+	if( outFile == NULL )
+	{
+		fprintf(stderr, "unable to open '%s'\n", outputPath);
+		return 1;
+	}
+	cxa_bench_writeJson(outFile);
+	if( outFile != stdout ) fclose(outFile);
+
+	if( numChecksFailed > 0 )
+	{
+		fprintf(stderr, "%zu check(s) failed\n", numChecksFailed);
+		return 1;
+	}
+	return 0;
+}
+
+
+// ******** local function implementations ********
+static uint64_t getTime_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+
+static int compareDoubles(const void* aIn, const void* bIn)
+{
+	double a = *(const double*)aIn;
+	double b = *(const double*)bIn;
+	return (a > b) - (a < b);
+}
+
+
+static void printUsage(const char *const progNameIn)
+{
+	fprintf(stderr, "usage: %s [-o results.json] [-f nameFilter] [-r numRepeats]\n", progNameIn);
+}
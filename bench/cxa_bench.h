@@ -0,0 +1,181 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_BENCH_H_
+#define CXA_BENCH_H_
+
+
+/**
+ * @file
+ * Minimal harness for host-side micro-benchmarks. Each benchmark is a
+ * callback that performs the measured operation a given number of times.
+ * The harness runs it once to warm up, then repeats the timed run and
+ * records the best and median time per operation so that results from
+ * different versions of the library can be compared.
+ *
+ * Suites can also register checks: behaviour that can't be timed
+ * meaningfully (or that a benchmark relies on) is verified once, and any
+ * failure makes the harness exit non-zero.
+ *
+ * @note This file is only built for the host (see bench/CMakeLists.txt)
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * static void bench_fifoQueue(size_t numItersIn, void* userVarIn)
+ * {
+ * 		for( size_t i = 0; i < numItersIn; i++ ) ...
+ * }
+ *
+ * void cxa_bench_suite_collections(void)
+ * {
+ * 		cxa_bench_run("fixedFifo/queueDequeue", 1000000, 0, bench_fifoQueue, NULL);
+ * }
+ *
+ * static bool check_fifoOrder(void* userVarIn)
+ * {
+ * 		...
+ * 		cxa_bench_expect(value == 42);
+ * 		return true;
+ * }
+ * @endcode
+ */
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_BENCH_MAXNUM_RESULTS
+	#define CXA_BENCH_MAXNUM_RESULTS				128
+#endif
+
+#ifndef CXA_BENCH_MAXNUM_REPEATS
+	#define CXA_BENCH_MAXNUM_REPEATS				31
+#endif
+
+#ifndef CXA_BENCH_MAXLEN_NAME_BYTES
+	#define CXA_BENCH_MAXLEN_NAME_BYTES				48
+#endif
+
+/**
+ * @public
+ * @brief Keeps the compiler from optimizing away a computed value
+ */
+#define cxa_bench_doNotOptimize(valIn)				__asm__ volatile("" : : "g"(valIn) : "memory")
+
+/**
+ * @public
+ * @brief Fails the current check (returning false) if the condition isn't met
+ */
+#define cxa_bench_expect(condIn)																	\
+	do																								\
+	{																								\
+		if( !(condIn) )																				\
+		{																							\
+			fprintf(stderr, "    %s:%d: expected '%s'\n", __FILE__, __LINE__, #condIn);				\
+			return false;																			\
+		}																							\
+	} while( 0 )
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief Performs the benchmarked operation numItersIn times
+ */
+typedef void (*cxa_bench_cb_run_t)(size_t numItersIn, void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Verifies a behaviour (see ::cxa_bench_expect)
+ *
+ * @return true if the check passed
+ */
+typedef bool (*cxa_bench_cb_check_t)(void* userVarIn);
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	char name[CXA_BENCH_MAXLEN_NAME_BYTES];
+	size_t numIters;
+	size_t bytesPerIter;
+
+	double best_nsPerIter;
+	double median_nsPerIter;
+}cxa_bench_result_t;
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Configures the harness
+ *
+ * @param[in] filterIn if non-NULL, only benchmarks whose name contains
+ * 		this string are run
+ * @param[in] numRepeatsIn number of timed runs per benchmark
+ * 		(clamped to CXA_BENCH_MAXNUM_REPEATS)
+ */
+void cxa_bench_init(const char *const filterIn, size_t numRepeatsIn);
+
+
+/**
+ * @public
+ * @brief Runs and records a single benchmark
+ *
+ * @param[in] nameIn unique name of the benchmark ("<module>/<operation>")
+ * @param[in] numItersIn number of operations performed per timed run
+ * @param[in] bytesPerIterIn number of bytes processed by each operation
+ * 		(used to report throughput, 0 if not applicable)
+ * @param[in] cbIn the benchmark callback
+ * @param[in] userVarIn passed to the callback
+ */
+void cxa_bench_run(const char *const nameIn, size_t numItersIn, size_t bytesPerIterIn, cxa_bench_cb_run_t cbIn, void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Runs a single check (subject to the same filter as benchmarks)
+ *
+ * @param[in] nameIn unique name of the check ("<module>/<behaviour>")
+ * @param[in] cbIn the check callback
+ * @param[in] userVarIn passed to the callback
+ */
+void cxa_bench_check(const char *const nameIn, cxa_bench_cb_check_t cbIn, void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Writes all recorded results as a single JSON object
+ */
+void cxa_bench_writeJson(FILE* fileIn);
+
+
+/**
+ * @public
+ * @brief Individual benchmark suites
+ */
+void cxa_bench_suite_collections(void);
+void cxa_bench_suite_mqtt(void);
+void cxa_bench_suite_mqttRpc(void);
+void cxa_bench_suite_protocolParsers(void);
+void cxa_bench_suite_stateMachine(void);
+void cxa_bench_suite_btle(void);
+void cxa_bench_suite_nvs(void);
+void cxa_bench_suite_network(void);
+void cxa_bench_suite_http(void);
+void cxa_bench_suite_misc(void);
+
+
+#endif
@@ -0,0 +1,733 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_btle_central.h>
+#include <cxa_btle_connection.h>
+#include <cxa_btle_connectionPool.h>
+#include <cxa_ioStream_loopback.h>
+#include <cxa_protocolParser_cleProto.h>
+#include <cxa_runLoop.h>
+
+
+// ******** local macro definitions ********
+#define THREADID_BTLE					5
+
+#define NUM_LINKS						4
+#define NUM_WRITES_PER_READ				3
+#define OPS_PER_LINK_PER_BATCH			(1 + NUM_WRITES_PER_READ)
+#define MAX_ITERATIONS_PER_BATCH		4096
+#define MAX_NUM_SPINS					2000
+
+#define SIM_NUM_TX_CREDITS				4
+#define SIM_READ_SIZE_BYTES				8
+#define RX_BUFFER_SIZE_BYTES			64
+
+#define SVC_UUID						"c0ffee00-0000-1000-8000-00805f9b34fb"
+#define CHAR_UUID						"c0ffee01-0000-1000-8000-00805f9b34fb"
+#define UNKNOWN_CHAR_UUID				"c0ffeeff-0000-1000-8000-00805f9b34fb"
+
+#define DUPCACHE_WINDOW_MS				100
+
+
+// ******** local type definitions ********
+/**
+ * BGAPI-style messages exchanged between the simulated stack (host) and the
+ * simulated controller: [msgId, connHandle, payload...]
+ */
+typedef enum
+{
+	SIM_CMD_CONNECT = 0x01,
+	SIM_CMD_DISCONNECT,
+	SIM_CMD_READ,
+	SIM_CMD_WRITE,
+	SIM_CMD_WRITE_NORESP,
+	SIM_CMD_CHANGE_NOTI,
+
+	SIM_EVT_CONNECTION_OPENED = 0x81,
+	SIM_EVT_CONNECTION_CLOSED,
+	SIM_EVT_READ_COMPLETE,
+	SIM_EVT_WRITE_COMPLETE,
+	SIM_EVT_TX_COMPLETE,
+	SIM_EVT_NOTI_CHANGED
+}simMsgId_t;
+
+
+typedef struct
+{
+	cxa_btle_connection_t super;
+	bool isUsed;
+	uint8_t handle;
+}simConnection_t;
+
+
+typedef struct
+{
+	cxa_btle_central_t super;
+	simConnection_t conns[NUM_LINKS];
+}simCentral_t;
+
+
+// ******** local function prototypes ********
+static bool check_scanFilter_addressPrefix(void* userVarIn);
+static bool check_pool_resubscribe(void* userVarIn);
+static bool check_pool_txCreditsKick(void* userVarIn);
+static bool check_pool_rejectedWriteCmd(void* userVarIn);
+
+static void bench_pool(size_t numItersIn, void* userVarIn);
+
+static bool check_scanFilter_serviceUuid(void* userVarIn);
+static bool check_scanFilter_companyId(void* userVarIn);
+static bool check_dupCache(void* userVarIn);
+static bool scanFilter_passes(const char *const addrIn);
+static bool advert_passes(const char *const addrIn, uint8_t *const advDataIn, size_t advDataSize_bytesIn);
+static void cb_onAdvertRx(cxa_btle_advPacket_t* packetIn, void* userVarIn);
+
+static bool spinUntil(size_t *const counterIn, size_t targetIn);
+static bool spinUntilConnected(cxa_btle_connectionPool_link_t *const linkIn);
+static bool deliverNotification(cxa_btle_connectionPool_link_t *const linkIn);
+static void controller_dropConnection(cxa_btle_connectionPool_link_t *const linkIn);
+
+static void sim_sendCommand(uint8_t msgIdIn, uint8_t handleIn, void *const payloadIn, size_t payloadSize_bytesIn);
+static void sim_sendEvent(uint8_t msgIdIn, uint8_t handleIn, void *const payloadIn, size_t payloadSize_bytesIn);
+
+static void controller_onCommand(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+static void host_onEvent(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+
+static cxa_btle_central_state_t scm_getState(cxa_btle_central_t *const superIn);
+static void scm_startScan(cxa_btle_central_t *const superIn, bool isActiveIn);
+static void scm_stopScan(cxa_btle_central_t *const superIn);
+static void scm_startConnection(cxa_btle_central_t *const superIn, cxa_eui48_t *const addrIn, bool isRandomAddrIn);
+
+static void scm_stopConnection(cxa_btle_connection_t *const superIn);
+static void scm_readFromCharacteristic(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn);
+static void scm_writeToCharacteristic(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *const dataIn);
+static bool scm_writeToCharacteristic_noResponse(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *const dataIn);
+static void scm_changeNotifications(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, bool enableNotificationsIn);
+
+static void cb_onReadComplete(bool wasSuccessfulIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn);
+static void cb_onSubscribed(const char *const serviceUuidIn, const char *const characteristicUuidIn, bool wasSuccessfulIn, void* userVarIn);
+static void cb_onNotiRx(const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+// host -> controller
+static cxa_ioStream_loopback_t cmdPipe;
+static cxa_protocolParser_cleProto_t cmdPipe_pp;
+static cxa_fixedByteBuffer_t cmdPipe_rxFbb;
+static uint8_t cmdPipe_rxFbb_raw[RX_BUFFER_SIZE_BYTES];
+
+// controller -> host
+static cxa_ioStream_loopback_t evtPipe;
+static cxa_protocolParser_cleProto_t evtPipe_pp;
+static cxa_fixedByteBuffer_t evtPipe_rxFbb;
+static uint8_t evtPipe_rxFbb_raw[RX_BUFFER_SIZE_BYTES];
+
+static simCentral_t simCentral;
+
+static cxa_btle_connectionPool_t pool;
+static cxa_btle_connectionPool_link_t* links[NUM_LINKS];
+
+static bool controller_isHandleUsed[NUM_LINKS];
+
+static size_t numReadsCompleted = 0;
+static size_t numWritesReceived = 0;
+static size_t numAdvertsReceived = 0;
+static size_t numNotiChangesReceived = 0;
+static size_t numSubscribed = 0;
+static size_t numNotisReceived = 0;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_btle(void)
+{
+	// the simulated controller sits on the other end of a pair of loopbacks
+	cxa_ioStream_loopback_init(&cmdPipe);
+	cxa_fixedByteBuffer_initStd(&cmdPipe_rxFbb, cmdPipe_rxFbb_raw);
+	cxa_protocolParser_cleProto_init(&cmdPipe_pp, &cmdPipe.super, &cmdPipe_rxFbb, THREADID_BTLE);
+	cxa_protocolParser_addPacketListener(&cmdPipe_pp.super, controller_onCommand, NULL);
+
+	cxa_ioStream_loopback_init(&evtPipe);
+	cxa_fixedByteBuffer_initStd(&evtPipe_rxFbb, evtPipe_rxFbb_raw);
+	cxa_protocolParser_cleProto_init(&evtPipe_pp, &evtPipe.super, &evtPipe_rxFbb, THREADID_BTLE);
+	cxa_protocolParser_addPacketListener(&evtPipe_pp.super, host_onEvent, NULL);
+
+	cxa_btle_central_init(&simCentral.super, scm_getState, scm_startScan, scm_stopScan, scm_startConnection);
+	for( size_t i = 0; i < NUM_LINKS; i++ )
+	{
+		simConnection_t* currConn = &simCentral.conns[i];
+		currConn->isUsed = false;
+		currConn->handle = (uint8_t)i;
+		cxa_btle_connection_init(&currConn->super, &simCentral.super, scm_stopConnection, scm_readFromCharacteristic, scm_writeToCharacteristic, scm_changeNotifications);
+		cxa_btle_connection_enableWriteNoResponse(&currConn->super, scm_writeToCharacteristic_noResponse, SIM_NUM_TX_CREDITS);
+	}
+
+	cxa_btle_connectionPool_init(&pool, &simCentral.super, THREADID_BTLE);
+	for( size_t i = 0; i < NUM_LINKS; i++ )
+	{
+		cxa_eui48_t addr = { .bytes = {0x30, 0xAE, 0xA4, 0x01, 0x74, (uint8_t)i} };
+		links[i] = cxa_btle_connectionPool_addLink(&pool, &addr, false, true, NULL, NULL, NULL);
+		cxa_assert(links[i]);
+	}
+
+	// run the startup callbacks
+	cxa_runLoop_iterate(THREADID_BTLE);
+
+	cxa_bench_check("btle/scanFilter_addressPrefix", check_scanFilter_addressPrefix, NULL);
+	cxa_bench_check("btle/scanFilter_serviceUuid", check_scanFilter_serviceUuid, NULL);
+	cxa_bench_check("btle/scanFilter_companyId", check_scanFilter_companyId, NULL);
+	cxa_bench_check("btle/duplicateCache", check_dupCache, NULL);
+	cxa_bench_check("btle/connectionPool_resubscribe", check_pool_resubscribe, links[0]);
+	cxa_bench_check("btle/connectionPool_txCreditsKick", check_pool_txCreditsKick, links[1]);
+	cxa_bench_check("btle/connectionPool_rejectedWriteCmd", check_pool_rejectedWriteCmd, links[2]);
+
+	cxa_bench_run("btle/connectionPool_4links_rw", 20000, 0, bench_pool, NULL);
+}
+
+
+// ******** local function implementations ********
+static bool check_scanFilter_addressPrefix(void* userVarIn)
+{
+	numAdvertsReceived = 0;
+	cxa_btle_central_startScan_passive(&simCentral.super, NULL, cb_onAdvertRx, NULL);
+
+	// an OUI, in printed order
+	uint8_t oui[] = {0x30, 0xAE, 0xA4};
+	cxa_bench_expect(cxa_btle_central_addScanFilter_addressPrefix(&simCentral.super, oui, sizeof(oui)));
+	cxa_bench_expect(scanFilter_passes("30:AE:A4:01:74:90"));
+	cxa_bench_expect(scanFilter_passes("30:AE:A4:FF:FF:FF"));
+	cxa_bench_expect(!scanFilter_passes("90:74:01:A4:AE:30"));
+	cxa_bench_expect(!scanFilter_passes("30:AE:A5:01:74:90"));
+	cxa_bench_expect(!scanFilter_passes("31:AE:A4:01:74:90"));
+
+	// a whole address
+	cxa_btle_central_clearScanFilters(&simCentral.super);
+	uint8_t addr[] = {0x30, 0xAE, 0xA4, 0x01, 0x74, 0x90};
+	cxa_bench_expect(cxa_btle_central_addScanFilter_addressPrefix(&simCentral.super, addr, sizeof(addr)));
+	cxa_bench_expect(scanFilter_passes("30:AE:A4:01:74:90"));
+	cxa_bench_expect(!scanFilter_passes("30:AE:A4:01:74:91"));
+
+	cxa_btle_central_clearScanFilters(&simCentral.super);
+	cxa_btle_central_stopScan(&simCentral.super, NULL, NULL);
+	cxa_bench_expect(numAdvertsReceived == 3);
+
+	return true;
+}
+
+
+static bool check_scanFilter_serviceUuid(void* userVarIn)
+{
+	numAdvertsReceived = 0;
+	cxa_btle_central_startScan_passive(&simCentral.super, NULL, cb_onAdvertRx, NULL);
+
+	// 16-bit: on air as little endian, anywhere in the list
+	cxa_btle_uuid_t uuid16;
+	cxa_bench_expect(cxa_btle_uuid_initFromString(&uuid16, "180F"));
+	cxa_bench_expect(cxa_btle_central_addScanFilter_serviceUuid(&simCentral.super, &uuid16));
+	uint8_t adv16[] = {0x02, 0x01, 0x06, 0x05, 0x03, 0x0A, 0x18, 0x0F, 0x18};
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", adv16, sizeof(adv16)));
+	uint8_t adv16_bigEndian[] = {0x02, 0x01, 0x06, 0x03, 0x03, 0x18, 0x0F};
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", adv16_bigEndian, sizeof(adv16_bigEndian)));
+
+	// 128-bit: on air reversed from its printed form
+	cxa_btle_central_clearScanFilters(&simCentral.super);
+	cxa_btle_uuid_t uuid128;
+	cxa_bench_expect(cxa_btle_uuid_initFromString(&uuid128, SVC_UUID));
+	cxa_bench_expect(cxa_btle_central_addScanFilter_serviceUuid(&simCentral.super, &uuid128));
+	uint8_t adv128[] = {0x11, 0x07, 0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00, 0x00, 0xEE, 0xFF, 0xC0};
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", adv128, sizeof(adv128)));
+	uint8_t adv128_printedOrder[] = {0x11, 0x07, 0xC0, 0xFF, 0xEE, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0x80, 0x5F, 0x9B, 0x34, 0xFB};
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", adv128_printedOrder, sizeof(adv128_printedOrder)));
+
+	// a 128-bit filter doesn't match 16-bit fields (and vice versa)
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", adv16, sizeof(adv16)));
+
+	cxa_btle_central_clearScanFilters(&simCentral.super);
+	cxa_btle_central_stopScan(&simCentral.super, NULL, NULL);
+	cxa_bench_expect(numAdvertsReceived == 2);
+
+	return true;
+}
+
+
+static bool check_scanFilter_companyId(void* userVarIn)
+{
+	numAdvertsReceived = 0;
+	cxa_btle_central_startScan_passive(&simCentral.super, NULL, cb_onAdvertRx, NULL);
+
+	// company ID is little endian at the start of the manufacturer data
+	cxa_bench_expect(cxa_btle_central_addScanFilter_companyId(&simCentral.super, 0x02E5));
+	uint8_t advMan[] = {0x02, 0x01, 0x06, 0x05, 0xFF, 0xE5, 0x02, 0x01, 0x02};
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advMan, sizeof(advMan)));
+	uint8_t advMan_otherCompany[] = {0x02, 0x01, 0x06, 0x05, 0xFF, 0x02, 0xE5, 0x01, 0x02};
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", advMan_otherCompany, sizeof(advMan_otherCompany)));
+	cxa_bench_expect(!scanFilter_passes("02:00:00:00:00:01"));
+
+	// filters are OR'd together
+	cxa_btle_uuid_t uuid16;
+	cxa_bench_expect(cxa_btle_uuid_initFromString(&uuid16, "180F"));
+	cxa_bench_expect(cxa_btle_central_addScanFilter_serviceUuid(&simCentral.super, &uuid16));
+	uint8_t adv16[] = {0x02, 0x01, 0x06, 0x03, 0x03, 0x0F, 0x18};
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", adv16, sizeof(adv16)));
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advMan, sizeof(advMan)));
+
+	cxa_btle_central_clearScanFilters(&simCentral.super);
+	cxa_btle_central_stopScan(&simCentral.super, NULL, NULL);
+	cxa_bench_expect(numAdvertsReceived == 3);
+
+	return true;
+}
+
+
+static bool check_dupCache(void* userVarIn)
+{
+	cxa_btle_central_startScan_passive(&simCentral.super, NULL, cb_onAdvertRx, NULL);
+	cxa_btle_central_setDuplicateWindow_ms(&simCentral.super, DUPCACHE_WINDOW_MS);
+
+	// the same payload from the same address is dropped inside the window...
+	uint8_t advA[] = {0x02, 0x01, 0x06, 0x03, 0xFF, 0x01, 0x02};
+	uint8_t advB[] = {0x02, 0x01, 0x06, 0x03, 0xFF, 0x01, 0x03};
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advA, sizeof(advA)));
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", advA, sizeof(advA)));
+	cxa_bench_expect(advert_passes("02:00:00:00:00:02", advA, sizeof(advA)));
+
+	// ...but not a changed payload
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advB, sizeof(advB)));
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", advB, sizeof(advB)));
+
+	// and it's reported again once the window has passed
+	usleep((DUPCACHE_WINDOW_MS + 10) * 1000);
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advB, sizeof(advB)));
+
+	// overfilling the cache evicts the stalest address (02:...:02)...
+	cxa_eui48_string_t addrStr;
+	for( size_t i = 0; i < (CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES - 1); i++ )
+	{
+		snprintf(addrStr.str, sizeof(addrStr.str), "02:00:00:00:01:%02X", (unsigned int)i);
+		cxa_bench_expect(advert_passes(addrStr.str, advA, sizeof(advA)));
+	}
+	cxa_bench_expect(!advert_passes("02:00:00:00:00:01", advB, sizeof(advB)));
+	cxa_bench_expect(advert_passes("02:00:00:00:00:02", advA, sizeof(advA)));
+
+	// ...which in turn evicted the next stalest (02:...:01), while the newest stay cached
+	cxa_bench_expect(advert_passes("02:00:00:00:00:01", advB, sizeof(advB)));
+	cxa_bench_expect(!advert_passes(addrStr.str, advA, sizeof(advA)));
+
+	cxa_btle_central_setDuplicateWindow_ms(&simCentral.super, 0);
+	cxa_btle_central_stopScan(&simCentral.super, NULL, NULL);
+
+	return true;
+}
+
+
+static bool check_pool_resubscribe(void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* link = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_bench_expect(spinUntilConnected(link));
+
+	numSubscribed = 0;
+	numNotisReceived = 0;
+	size_t prevNumNotiChanges = numNotiChangesReceived;
+	cxa_bench_expect(cxa_btle_connectionPool_queueSubscribe(link, SVC_UUID, CHAR_UUID, cb_onSubscribed, cb_onNotiRx, NULL));
+	cxa_bench_expect(spinUntil(&numSubscribed, 1));
+	cxa_bench_expect(numNotiChangesReceived == (prevNumNotiChanges + 1));
+	cxa_bench_expect(deliverNotification(link));
+
+	// the peripheral drops us...
+	controller_dropConnection(link);
+	for( int i = 0; (i < MAX_NUM_SPINS) && cxa_btle_connectionPool_link_isConnected(link); i++ ) cxa_runLoop_iterate(THREADID_BTLE);
+	cxa_bench_expect(!cxa_btle_connectionPool_link_isConnected(link));
+
+	// ...and once we're back (after standing off) the subscription is too, without being asked
+	cxa_bench_expect(spinUntilConnected(link));
+	cxa_bench_expect(spinUntil(&numSubscribed, 2));
+	cxa_bench_expect(numNotiChangesReceived == (prevNumNotiChanges + 2));
+	cxa_bench_expect(deliverNotification(link));
+	cxa_bench_expect(numNotisReceived == 2);
+
+	return true;
+}
+
+
+static bool check_pool_txCreditsKick(void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* link = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_bench_expect(spinUntilConnected(link));
+	cxa_btle_connection_t* conn = link->conn;
+	cxa_bench_expect(cxa_btle_connection_getNumTxCredits(conn) == SIM_NUM_TX_CREDITS);
+
+	// more than the controller can buffer: the rest wait for credits
+	static uint8_t writeData[CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES];
+	size_t expectedNumWrites = numWritesReceived + (2 * SIM_NUM_TX_CREDITS);
+	for( size_t i = 0; i < (2 * SIM_NUM_TX_CREDITS); i++ )
+	{
+		cxa_bench_expect(cxa_btle_connectionPool_queueWrite_noResponse(link, SVC_UUID, CHAR_UUID, writeData, sizeof(writeData)));
+	}
+	cxa_bench_expect(cxa_btle_connection_getNumTxCredits(conn) == 0);
+	cxa_bench_expect(cxa_btle_connectionPool_link_getNumQueuedOps(link) == SIM_NUM_TX_CREDITS);
+
+	// credits coming back send them right away, not on the next runLoop iteration
+	cxa_btle_connection_notify_txCreditsAvailable(conn, SIM_NUM_TX_CREDITS);
+	cxa_bench_expect(cxa_btle_connectionPool_link_getNumQueuedOps(link) == 0);
+	cxa_bench_expect(cxa_btle_connection_getNumTxCredits(conn) == 0);
+
+	// let the controller catch up
+	cxa_bench_expect(spinUntil(&numWritesReceived, expectedNumWrites));
+	for( int i = 0; i < 4; i++ ) cxa_runLoop_iterate(THREADID_BTLE);
+	cxa_bench_expect(cxa_btle_connection_getNumTxCredits(conn) == SIM_NUM_TX_CREDITS);
+
+	return true;
+}
+
+
+static bool check_pool_rejectedWriteCmd(void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* link = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_bench_expect(spinUntilConnected(link));
+	cxa_btle_connection_t* conn = link->conn;
+
+	// the stack refuses the first one (with credits to spare)...
+	static uint8_t writeData[CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES];
+	size_t expectedNumWrites = numWritesReceived + 1;
+	size_t expectedNumReads = numReadsCompleted + 1;
+	cxa_bench_expect(cxa_btle_connectionPool_queueWrite_noResponse(link, SVC_UUID, UNKNOWN_CHAR_UUID, writeData, sizeof(writeData)));
+	cxa_bench_expect(cxa_btle_connectionPool_queueWrite_noResponse(link, SVC_UUID, CHAR_UUID, writeData, sizeof(writeData)));
+	cxa_bench_expect(cxa_btle_connectionPool_queueRead(link, SVC_UUID, CHAR_UUID, cb_onReadComplete, NULL));
+
+	// ...which is dropped instead of holding up everything behind it
+	cxa_bench_expect(cxa_btle_connectionPool_link_getNumDroppedWriteCmds(link) == 1);
+	cxa_bench_expect(spinUntil(&numWritesReceived, expectedNumWrites));
+	cxa_bench_expect(spinUntil(&numReadsCompleted, expectedNumReads));
+	cxa_bench_expect(cxa_btle_connectionPool_link_getNumQueuedOps(link) == 0);
+
+	for( int i = 0; i < 4; i++ ) cxa_runLoop_iterate(THREADID_BTLE);
+	cxa_bench_expect(cxa_btle_connection_getNumTxCredits(conn) == SIM_NUM_TX_CREDITS);
+
+	return true;
+}
+
+
+static void bench_pool(size_t numItersIn, void* userVarIn)
+{
+	static uint8_t writeData[CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES];
+
+	for( size_t i = 0; i < numItersIn; i += (NUM_LINKS * OPS_PER_LINK_PER_BATCH) )
+	{
+		size_t expectedNumReads = numReadsCompleted + NUM_LINKS;
+		size_t expectedNumWrites = numWritesReceived + (NUM_LINKS * NUM_WRITES_PER_READ);
+
+		// each link gets a burst of writes followed by a read of the result...
+		for( size_t j = 0; j < NUM_LINKS; j++ )
+		{
+			for( size_t k = 0; k < NUM_WRITES_PER_READ; k++ )
+			{
+				cxa_assert( cxa_btle_connectionPool_queueWrite_noResponse(links[j], SVC_UUID, CHAR_UUID, writeData, sizeof(writeData)) );
+			}
+			cxa_assert( cxa_btle_connectionPool_queueRead(links[j], SVC_UUID, CHAR_UUID, cb_onReadComplete, NULL) );
+		}
+
+		// ...then let the pool and the simulated controller work through them
+		for( size_t j = 0; (numReadsCompleted < expectedNumReads) || (numWritesReceived < expectedNumWrites); j++ )
+		{
+			cxa_assert_msg((j < MAX_ITERATIONS_PER_BATCH), "pool stalled");
+			cxa_runLoop_iterate(THREADID_BTLE);
+		}
+	}
+}
+
+
+static bool scanFilter_passes(const char *const addrIn)
+{
+	// flags only
+	uint8_t advData[] = {0x02, 0x01, 0x06};
+	return advert_passes(addrIn, advData, sizeof(advData));
+}
+
+
+static bool advert_passes(const char *const addrIn, uint8_t *const advDataIn, size_t advDataSize_bytesIn)
+{
+	cxa_eui48_t addr;
+	cxa_assert(cxa_eui48_initFromString(&addr, addrIn));
+
+	cxa_btle_advPacket_t packet;
+	cxa_assert(cxa_btle_advPacket_init(&packet, addr.bytes, false, -50, advDataIn, advDataSize_bytesIn));
+
+	size_t prevNumAdverts = numAdvertsReceived;
+	cxa_btle_central_notify_advertRx(&simCentral.super, &packet);
+	return (numAdvertsReceived != prevNumAdverts);
+}
+
+
+static void cb_onAdvertRx(cxa_btle_advPacket_t* packetIn, void* userVarIn)
+{
+	numAdvertsReceived++;
+}
+
+
+static bool spinUntil(size_t *const counterIn, size_t targetIn)
+{
+	for( int i = 0; (i < MAX_NUM_SPINS) && (*counterIn < targetIn); i++ )
+	{
+		cxa_runLoop_iterate(THREADID_BTLE);
+		usleep(1000);
+	}
+	return (*counterIn >= targetIn);
+}
+
+
+static bool spinUntilConnected(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	for( int i = 0; (i < MAX_NUM_SPINS) && !cxa_btle_connectionPool_link_isConnected(linkIn); i++ )
+	{
+		cxa_runLoop_iterate(THREADID_BTLE);
+		usleep(1000);
+	}
+
+	// and let anything it kicked off settle
+	for( int i = 0; i < 4; i++ ) cxa_runLoop_iterate(THREADID_BTLE);
+	return cxa_btle_connectionPool_link_isConnected(linkIn);
+}
+
+
+static bool deliverNotification(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	uint8_t data_raw[] = {0x42};
+	cxa_fixedByteBuffer_t data;
+	cxa_fixedByteBuffer_init_inPlace(&data, sizeof(data_raw), data_raw, sizeof(data_raw));
+
+	size_t prevNumNotis = numNotisReceived;
+	cxa_btle_connection_notify_notiIndiRx(linkIn->conn, SVC_UUID, CHAR_UUID, &data);
+	return (numNotisReceived != prevNumNotis);
+}
+
+
+static void controller_dropConnection(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	uint8_t handle = ((simConnection_t*)linkIn->conn)->handle;
+
+	controller_isHandleUsed[handle] = false;
+	sim_sendEvent(SIM_EVT_CONNECTION_CLOSED, handle, NULL, 0);
+}
+
+
+static void sim_sendCommand(uint8_t msgIdIn, uint8_t handleIn, void *const payloadIn, size_t payloadSize_bytesIn)
+{
+	uint8_t packet_raw[RX_BUFFER_SIZE_BYTES];
+	cxa_fixedByteBuffer_t packet;
+	cxa_fixedByteBuffer_initStd(&packet, packet_raw);
+
+	cxa_assert( cxa_fixedByteBuffer_append_uint8(&packet, msgIdIn) &&
+				cxa_fixedByteBuffer_append_uint8(&packet, handleIn) &&
+				((payloadSize_bytesIn == 0) || cxa_fixedByteBuffer_append(&packet, payloadIn, payloadSize_bytesIn)) );
+	cxa_assert( cxa_protocolParser_writePacket(&cmdPipe_pp.super, &packet) );
+}
+
+
+static void sim_sendEvent(uint8_t msgIdIn, uint8_t handleIn, void *const payloadIn, size_t payloadSize_bytesIn)
+{
+	uint8_t packet_raw[RX_BUFFER_SIZE_BYTES];
+	cxa_fixedByteBuffer_t packet;
+	cxa_fixedByteBuffer_initStd(&packet, packet_raw);
+
+	cxa_assert( cxa_fixedByteBuffer_append_uint8(&packet, msgIdIn) &&
+				cxa_fixedByteBuffer_append_uint8(&packet, handleIn) &&
+				((payloadSize_bytesIn == 0) || cxa_fixedByteBuffer_append(&packet, payloadIn, payloadSize_bytesIn)) );
+	cxa_assert( cxa_protocolParser_writePacket(&evtPipe_pp.super, &packet) );
+}
+
+
+static void controller_onCommand(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
+{
+	uint8_t msgId, handle;
+	if( !cxa_fixedByteBuffer_get_uint8(packetIn, 0, msgId) || !cxa_fixedByteBuffer_get_uint8(packetIn, 1, handle) ) return;
+
+	switch( msgId )
+	{
+		case SIM_CMD_CONNECT:
+		{
+			// echo the address back with the first free handle
+			uint8_t newHandle = 0;
+			while( (newHandle < NUM_LINKS) && controller_isHandleUsed[newHandle] ) newHandle++;
+			if( newHandle == NUM_LINKS ) return;
+			controller_isHandleUsed[newHandle] = true;
+
+			sim_sendEvent(SIM_EVT_CONNECTION_OPENED, newHandle, cxa_fixedByteBuffer_get_pointerToIndex(packetIn, 2), sizeof(((cxa_eui48_t*)NULL)->bytes));
+			break;
+		}
+
+		case SIM_CMD_DISCONNECT:
+			if( handle < NUM_LINKS ) controller_isHandleUsed[handle] = false;
+			sim_sendEvent(SIM_EVT_CONNECTION_CLOSED, handle, NULL, 0);
+			break;
+
+		case SIM_CMD_READ:
+		{
+			uint8_t readData[SIM_READ_SIZE_BYTES] = {0};
+			sim_sendEvent(SIM_EVT_READ_COMPLETE, handle, readData, sizeof(readData));
+			break;
+		}
+
+		case SIM_CMD_WRITE:
+			sim_sendEvent(SIM_EVT_WRITE_COMPLETE, handle, NULL, 0);
+			break;
+
+		case SIM_CMD_WRITE_NORESP:
+		{
+			// no response from the peer, just the controller freeing its buffer
+			uint8_t numCompleted = 1;
+			numWritesReceived++;
+			sim_sendEvent(SIM_EVT_TX_COMPLETE, handle, &numCompleted, sizeof(numCompleted));
+			break;
+		}
+
+		case SIM_CMD_CHANGE_NOTI:
+			numNotiChangesReceived++;
+			sim_sendEvent(SIM_EVT_NOTI_CHANGED, handle, cxa_fixedByteBuffer_get_pointerToIndex(packetIn, 2), 1);
+			break;
+	}
+}
+
+
+static void host_onEvent(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
+{
+	uint8_t msgId, handle;
+	if( !cxa_fixedByteBuffer_get_uint8(packetIn, 0, msgId) || !cxa_fixedByteBuffer_get_uint8(packetIn, 1, handle) ) return;
+	if( handle >= NUM_LINKS ) return;
+	simConnection_t* conn = &simCentral.conns[handle];
+
+	switch( msgId )
+	{
+		case SIM_EVT_CONNECTION_OPENED:
+		{
+			cxa_eui48_t targetAddr;
+			if( !cxa_fixedByteBuffer_get(packetIn, 2, false, targetAddr.bytes, sizeof(targetAddr.bytes)) ) return;
+
+			cxa_assert(!conn->isUsed);
+			conn->isUsed = true;
+			cxa_btle_connection_setTargetAddress(&conn->super, &targetAddr);
+			cxa_btle_central_notify_connectionStarted(&simCentral.super, true, &conn->super);
+			break;
+		}
+
+		case SIM_EVT_CONNECTION_CLOSED:
+			conn->isUsed = false;
+			cxa_btle_connection_notify_connectionClose(&conn->super, CXA_BTLE_CONNECTION_DISCONNECT_REASON_USER_REQUESTED);
+			break;
+
+		case SIM_EVT_READ_COMPLETE:
+		{
+			cxa_fixedByteBuffer_t readData;
+			cxa_fixedByteBuffer_init_subBufferRemainingElems(&readData, packetIn, 2);
+			cxa_btle_connection_notify_readComplete(&conn->super, SVC_UUID, CHAR_UUID, true, &readData);
+			break;
+		}
+
+		case SIM_EVT_WRITE_COMPLETE:
+			cxa_btle_connection_notify_writeComplete(&conn->super, SVC_UUID, CHAR_UUID, true);
+			break;
+
+		case SIM_EVT_TX_COMPLETE:
+		{
+			uint8_t numCompleted;
+			if( !cxa_fixedByteBuffer_get_uint8(packetIn, 2, numCompleted) ) return;
+			cxa_btle_connection_notify_txCreditsAvailable(&conn->super, numCompleted);
+			break;
+		}
+
+		case SIM_EVT_NOTI_CHANGED:
+		{
+			uint8_t isEnabled;
+			if( !cxa_fixedByteBuffer_get_uint8(packetIn, 2, isEnabled) ) return;
+			cxa_btle_connection_notify_notiIndiSubscriptionChanged(&conn->super, SVC_UUID, CHAR_UUID, true, isEnabled);
+			break;
+		}
+	}
+}
+
+
+static cxa_btle_central_state_t scm_getState(cxa_btle_central_t *const superIn)
+{
+	return CXA_BTLE_CENTRAL_STATE_READY;
+}
+
+
+static void scm_startScan(cxa_btle_central_t *const superIn, bool isActiveIn)
+{
+	cxa_btle_central_notify_scanStart(superIn, false);
+}
+
+
+static void scm_stopScan(cxa_btle_central_t *const superIn)
+{
+	cxa_btle_central_notify_scanStop(superIn);
+}
+
+
+static void scm_startConnection(cxa_btle_central_t *const superIn, cxa_eui48_t *const addrIn, bool isRandomAddrIn)
+{
+	sim_sendCommand(SIM_CMD_CONNECT, 0, addrIn->bytes, sizeof(addrIn->bytes));
+}
+
+
+static void scm_stopConnection(cxa_btle_connection_t *const superIn)
+{
+	sim_sendCommand(SIM_CMD_DISCONNECT, ((simConnection_t*)superIn)->handle, NULL, 0);
+}
+
+
+static void scm_readFromCharacteristic(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn)
+{
+	sim_sendCommand(SIM_CMD_READ, ((simConnection_t*)superIn)->handle, NULL, 0);
+}
+
+
+static void scm_writeToCharacteristic(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *const dataIn)
+{
+	sim_sendCommand(SIM_CMD_WRITE, ((simConnection_t*)superIn)->handle, cxa_fixedByteBuffer_get_pointerToIndex(dataIn, 0), cxa_fixedByteBuffer_getSize_bytes(dataIn));
+}
+
+
+static bool scm_writeToCharacteristic_noResponse(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *const dataIn)
+{
+	// like a real stack, refuse a characteristic that isn't in the peer's GATT table
+	if( strcmp(characteristicUuidIn, CHAR_UUID) != 0 ) return false;
+
+	sim_sendCommand(SIM_CMD_WRITE_NORESP, ((simConnection_t*)superIn)->handle, cxa_fixedByteBuffer_get_pointerToIndex(dataIn, 0), cxa_fixedByteBuffer_getSize_bytes(dataIn));
+	return true;
+}
+
+
+static void scm_changeNotifications(cxa_btle_connection_t *const superIn, const char *const serviceUuidIn, const char *const characteristicUuidIn, bool enableNotificationsIn)
+{
+	uint8_t isEnabled = enableNotificationsIn;
+	sim_sendCommand(SIM_CMD_CHANGE_NOTI, ((simConnection_t*)superIn)->handle, &isEnabled, sizeof(isEnabled));
+}
+
+
+static void cb_onReadComplete(bool wasSuccessfulIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn)
+{
+	cxa_assert(wasSuccessfulIn);
+	numReadsCompleted++;
+}
+
+
+static void cb_onSubscribed(const char *const serviceUuidIn, const char *const characteristicUuidIn, bool wasSuccessfulIn, void* userVarIn)
+{
+	if( wasSuccessfulIn ) numSubscribed++;
+}
+
+
+static void cb_onNotiRx(const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn)
+{
+	numNotisReceived++;
+}
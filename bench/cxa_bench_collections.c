@@ -0,0 +1,537 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include <cxa_array.h>
+#include <cxa_assert.h>
+#include <cxa_fixedByteBuffer.h>
+#include <cxa_fixedFifo.h>
+#include <cxa_fixedFifo_spsc.h>
+#include <cxa_linkedField.h>
+
+
+// ******** local macro definitions ********
+#define ARRAY_NUM_ELEMS					64
+#define FIFO_NUM_ELEMS					64
+#define FIFO_BULK_NUM_BYTES				32
+#define SPSC_SMALL_NUM_ELEMS			8
+#define SPSC_THREADED_NUM_ELEMS			(1 << 18)
+#define SPSC_THREADED_MAX_BULK_ELEMS	13
+#define FBB_NUM_BYTES					256
+#define LF_FIELD_NUM_BYTES				16
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool check_spsc_wraparound(void* userVarIn);
+static bool check_spsc_fullEmpty(void* userVarIn);
+static bool check_spsc_bulkAcrossWrap(void* userVarIn);
+static bool check_spsc_twoThreads(void* userVarIn);
+static void* spsc_producerThread(void* userVarIn);
+
+static void bench_array_appendClear(size_t numItersIn, void* userVarIn);
+static void bench_array_get(size_t numItersIn, void* userVarIn);
+static void bench_array_iterate(size_t numItersIn, void* userVarIn);
+static void bench_array_insertRemoveFront(size_t numItersIn, void* userVarIn);
+
+static void bench_fifo_queueDequeue(size_t numItersIn, void* userVarIn);
+static void bench_fifo_bulkQueueDequeue(size_t numItersIn, void* userVarIn);
+static void bench_spsc_queueDequeue(size_t numItersIn, void* userVarIn);
+static void bench_spsc_bulkQueueDequeue(size_t numItersIn, void* userVarIn);
+
+static void bench_fbb_appendUint32(size_t numItersIn, void* userVarIn);
+static void bench_fbb_getUint16BE(size_t numItersIn, void* userVarIn);
+static void bench_fbb_insertRemoveFront(size_t numItersIn, void* userVarIn);
+static void bench_fbb_lengthPrefixedCString(size_t numItersIn, void* userVarIn);
+
+static void bench_lf_buildChain(size_t numItersIn, void* userVarIn);
+static void bench_lf_insertRemoveFirst(size_t numItersIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static cxa_array_t array;
+static uint32_t array_raw[ARRAY_NUM_ELEMS];
+
+static cxa_fixedFifo_t fifo;
+static uint8_t fifo_raw[FIFO_NUM_ELEMS];
+
+static cxa_fixedFifo_spsc_t spsc;
+static uint8_t spsc_raw[FIFO_NUM_ELEMS];
+static uint16_t spscSmall_raw[SPSC_SMALL_NUM_ELEMS];
+static uint32_t spscThreaded_raw[FIFO_NUM_ELEMS];
+
+static cxa_fixedByteBuffer_t fbb;
+static uint8_t fbb_raw[FBB_NUM_BYTES];
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_collections(void)
+{
+	cxa_bench_check("fixedFifo_spsc/wraparound", check_spsc_wraparound, NULL);
+	cxa_bench_check("fixedFifo_spsc/fullEmpty", check_spsc_fullEmpty, NULL);
+	cxa_bench_check("fixedFifo_spsc/bulkAcrossWrap", check_spsc_bulkAcrossWrap, NULL);
+	cxa_bench_check("fixedFifo_spsc/twoThreads", check_spsc_twoThreads, NULL);
+
+	cxa_bench_run("array/appendClear_64", 100000, 0, bench_array_appendClear, NULL);
+	cxa_bench_run("array/get", 10000000, 0, bench_array_get, NULL);
+	cxa_bench_run("array/iterate_64", 1000000, 0, bench_array_iterate, NULL);
+	cxa_bench_run("array/insertRemoveFront_63", 1000000, 0, bench_array_insertRemoveFront, NULL);
+
+	cxa_bench_run("fixedFifo/queueDequeue", 10000000, 1, bench_fifo_queueDequeue, NULL);
+	cxa_bench_run("fixedFifo/bulkQueueDequeue_32", 1000000, FIFO_BULK_NUM_BYTES, bench_fifo_bulkQueueDequeue, NULL);
+	cxa_bench_run("fixedFifo_spsc/queueDequeue", 10000000, 1, bench_spsc_queueDequeue, NULL);
+	cxa_bench_run("fixedFifo_spsc/bulkQueueDequeue_32", 1000000, FIFO_BULK_NUM_BYTES, bench_spsc_bulkQueueDequeue, NULL);
+
+	cxa_bench_run("fixedByteBuffer/appendUint32BE_64", 100000, 4 * 64, bench_fbb_appendUint32, NULL);
+	cxa_bench_run("fixedByteBuffer/getUint16BE", 10000000, 2, bench_fbb_getUint16BE, NULL);
+	cxa_bench_run("fixedByteBuffer/insertRemoveFront", 1000000, 0, bench_fbb_insertRemoveFront, NULL);
+	cxa_bench_run("fixedByteBuffer/lengthPrefixedCString", 1000000, 0, bench_fbb_lengthPrefixedCString, NULL);
+
+	cxa_bench_run("linkedField/buildChain_4", 1000000, 4 * LF_FIELD_NUM_BYTES, bench_lf_buildChain, NULL);
+	cxa_bench_run("linkedField/insertRemoveFirst", 1000000, 0, bench_lf_insertRemoveFirst, NULL);
+}
+
+
+// ******** local function implementations ********
+static bool check_spsc_wraparound(void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spscSmall_raw);
+	cxa_bench_expect(cxa_fixedFifo_spsc_getMaxSize_elems(&spsc) == SPSC_SMALL_NUM_ELEMS);
+
+	// varying depths so the indices wrap at different points, several times over
+	uint16_t nextIn = 0, nextOut = 0;
+	for( size_t i = 0; i < (4 * SPSC_SMALL_NUM_ELEMS); i++ )
+	{
+		size_t depth = (i % SPSC_SMALL_NUM_ELEMS) + 1;
+		for( size_t j = 0; j < depth; j++, nextIn++ ) cxa_bench_expect(cxa_fixedFifo_spsc_queue(&spsc, &nextIn));
+		cxa_bench_expect(cxa_fixedFifo_spsc_getSize_elems(&spsc) == depth);
+
+		uint16_t val;
+		cxa_bench_expect(cxa_fixedFifo_spsc_peek(&spsc, &val) && (val == nextOut));
+		for( size_t j = 0; j < depth; j++, nextOut++ )
+		{
+			cxa_bench_expect(cxa_fixedFifo_spsc_dequeue(&spsc, &val) && (val == nextOut));
+		}
+	}
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc));
+
+	return true;
+}
+
+
+static bool check_spsc_fullEmpty(void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spscSmall_raw);
+
+	// start part way through the buffer
+	uint16_t val = 0;
+	for( size_t i = 0; i < (SPSC_SMALL_NUM_ELEMS / 2) + 1; i++ )
+	{
+		cxa_bench_expect(cxa_fixedFifo_spsc_queue(&spsc, &val));
+		cxa_bench_expect(cxa_fixedFifo_spsc_dequeue(&spsc, NULL));
+	}
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc) && !cxa_fixedFifo_spsc_isFull(&spsc));
+	cxa_bench_expect(!cxa_fixedFifo_spsc_peek(&spsc, NULL) && !cxa_fixedFifo_spsc_dequeue(&spsc, NULL));
+
+	// every slot is usable (none reserved to tell full from empty)
+	for( val = 0; val < SPSC_SMALL_NUM_ELEMS; val++ )
+	{
+		cxa_bench_expect(cxa_fixedFifo_spsc_getFreeSize_elems(&spsc) == (SPSC_SMALL_NUM_ELEMS - val));
+		cxa_bench_expect(cxa_fixedFifo_spsc_queue(&spsc, &val));
+	}
+	cxa_bench_expect(cxa_fixedFifo_spsc_isFull(&spsc) && !cxa_fixedFifo_spsc_isEmpty(&spsc));
+	cxa_bench_expect(cxa_fixedFifo_spsc_getSize_elems(&spsc) == SPSC_SMALL_NUM_ELEMS);
+	cxa_bench_expect(cxa_fixedFifo_spsc_getFreeSize_elems(&spsc) == 0);
+
+	// new elements are dropped, the old ones are untouched
+	cxa_bench_expect(!cxa_fixedFifo_spsc_queue(&spsc, &val));
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkQueue(&spsc, &val, 1) == 0);
+	for( uint16_t i = 0; i < SPSC_SMALL_NUM_ELEMS; i++ )
+	{
+		cxa_bench_expect(cxa_fixedFifo_spsc_dequeue(&spsc, &val) && (val == i));
+	}
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc) && !cxa_fixedFifo_spsc_dequeue(&spsc, NULL));
+
+	// clear empties a full fifo
+	for( val = 0; val < SPSC_SMALL_NUM_ELEMS; val++ ) cxa_bench_expect(cxa_fixedFifo_spsc_queue(&spsc, &val));
+	cxa_fixedFifo_spsc_clear(&spsc);
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc) && (cxa_fixedFifo_spsc_getFreeSize_elems(&spsc) == SPSC_SMALL_NUM_ELEMS));
+
+	return true;
+}
+
+
+static bool check_spsc_bulkAcrossWrap(void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spscSmall_raw);
+
+	// three slots before the end of the buffer
+	uint16_t pad = 0;
+	for( size_t i = 0; i < (SPSC_SMALL_NUM_ELEMS - 3); i++ )
+	{
+		cxa_bench_expect(cxa_fixedFifo_spsc_queue(&spsc, &pad));
+		cxa_bench_expect(cxa_fixedFifo_spsc_dequeue(&spsc, NULL));
+	}
+
+	// a bulk queue that spans the end of the buffer
+	uint16_t in[SPSC_SMALL_NUM_ELEMS + 2];
+	for( uint16_t i = 0; i < (sizeof(in)/sizeof(*in)); i++ ) in[i] = 100 + i;
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkQueue(&spsc, in, 6) == 6);
+
+	// more than will fit is truncated
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkQueue(&spsc, &in[6], 4) == (SPSC_SMALL_NUM_ELEMS - 6));
+	cxa_bench_expect(cxa_fixedFifo_spsc_isFull(&spsc));
+
+	// a bulk dequeue that spans the end of the buffer
+	uint16_t out[SPSC_SMALL_NUM_ELEMS + 2];
+	memset(out, 0, sizeof(out));
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkDequeue(&spsc, out, 5) == 5);
+	cxa_bench_expect(memcmp(out, in, 5 * sizeof(*out)) == 0);
+
+	// discarding, then asking for more than there is
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkDequeue(&spsc, NULL, 1) == 1);
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkDequeue(&spsc, out, sizeof(out)/sizeof(*out)) == (SPSC_SMALL_NUM_ELEMS - 6));
+	cxa_bench_expect(memcmp(out, &in[6], (SPSC_SMALL_NUM_ELEMS - 6) * sizeof(*out)) == 0);
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc));
+	cxa_bench_expect(cxa_fixedFifo_spsc_bulkDequeue(&spsc, out, 1) == 0);
+
+	return true;
+}
+
+
+static bool check_spsc_twoThreads(void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spscThreaded_raw);
+
+	pthread_t producer;
+	cxa_bench_expect(pthread_create(&producer, NULL, spsc_producerThread, NULL) == 0);
+
+	// every value arrives exactly once, in order (keep draining regardless so the producer can finish)
+	bool isInOrder = true;
+	uint32_t nextExpected = 0;
+	size_t numElemsToDequeue = 1;
+	while( nextExpected < SPSC_THREADED_NUM_ELEMS )
+	{
+		uint32_t vals[SPSC_THREADED_MAX_BULK_ELEMS];
+		size_t numElems = cxa_fixedFifo_spsc_bulkDequeue(&spsc, vals, numElemsToDequeue);
+		for( size_t i = 0; i < numElems; i++, nextExpected++ )
+		{
+			if( vals[i] != nextExpected ) isInOrder = false;
+		}
+		numElemsToDequeue = (numElemsToDequeue % SPSC_THREADED_MAX_BULK_ELEMS) + 1;
+
+		// hand over after every batch: on a single core the producer would otherwise
+		// only ever refill an empty fifo, and its batches would never span the wrap
+		sched_yield();
+	}
+
+	pthread_join(producer, NULL);
+	cxa_bench_expect(isInOrder);
+	cxa_bench_expect(cxa_fixedFifo_spsc_isEmpty(&spsc));
+
+	return true;
+}
+
+
+static void* spsc_producerThread(void* userVarIn)
+{
+	// a mix of single and bulk queues, retrying whatever didn't fit
+	uint32_t nextVal = 0;
+	size_t numElemsToQueue = 1;
+	while( nextVal < SPSC_THREADED_NUM_ELEMS )
+	{
+		uint32_t vals[SPSC_THREADED_MAX_BULK_ELEMS];
+		size_t numElems = numElemsToQueue;
+		if( numElems > (SPSC_THREADED_NUM_ELEMS - nextVal) ) numElems = SPSC_THREADED_NUM_ELEMS - nextVal;
+		for( size_t i = 0; i < numElems; i++ ) vals[i] = nextVal + i;
+
+		size_t numQueued = (numElems == 1) ?
+						   (cxa_fixedFifo_spsc_queue(&spsc, vals) ? 1 : 0) :
+						   cxa_fixedFifo_spsc_bulkQueue(&spsc, vals, numElems);
+		nextVal += numQueued;
+		if( numQueued == 0 ) sched_yield();
+		numElemsToQueue = (numElemsToQueue % SPSC_THREADED_MAX_BULK_ELEMS) + 1;
+	}
+
+	return NULL;
+}
+
+
+static void bench_array_appendClear(size_t numItersIn, void* userVarIn)
+{
+	cxa_array_initStd(&array, array_raw);
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		for( uint32_t j = 0; j < ARRAY_NUM_ELEMS; j++ )
+		{
+			cxa_array_append(&array, &j);
+		}
+		cxa_bench_doNotOptimize(array_raw[ARRAY_NUM_ELEMS-1]);
+		cxa_array_clear(&array);
+	}
+}
+
+
+static void bench_array_get(size_t numItersIn, void* userVarIn)
+{
+	cxa_array_initStd(&array, array_raw);
+	for( uint32_t j = 0; j < ARRAY_NUM_ELEMS; j++ ) cxa_array_append(&array, &j);
+
+	// deterministic pseudo-random access pattern
+	uint32_t index = 1;
+	uint32_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		index = (index * 1103515245u) + 12345u;
+		uint32_t* val = (uint32_t*)cxa_array_get(&array, (index >> 16) % ARRAY_NUM_ELEMS);
+		sum += *val;
+	}
+	cxa_bench_doNotOptimize(sum);
+}
+
+
+static void bench_array_iterate(size_t numItersIn, void* userVarIn)
+{
+	cxa_array_initStd(&array, array_raw);
+	for( uint32_t j = 0; j < ARRAY_NUM_ELEMS; j++ ) cxa_array_append(&array, &j);
+
+	uint32_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_array_iterate(&array, currVal, uint32_t)
+		{
+			sum += *currVal;
+		}
+		cxa_bench_doNotOptimize(sum);
+	}
+}
+
+
+static void bench_array_insertRemoveFront(size_t numItersIn, void* userVarIn)
+{
+	cxa_array_initStd(&array, array_raw);
+	for( uint32_t j = 0; j < (ARRAY_NUM_ELEMS-1); j++ ) cxa_array_append(&array, &j);
+
+	uint32_t newVal = 0xA5A5A5A5;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_array_insert(&array, 0, &newVal);
+		cxa_array_remove_atIndex(&array, 0);
+	}
+	cxa_bench_doNotOptimize(array_raw[0]);
+}
+
+
+static void bench_fifo_queueDequeue(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedFifo_initStd(&fifo, CXA_FF_ON_FULL_DROP, fifo_raw);
+
+	uint8_t val = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		uint8_t newVal = (uint8_t)i;
+		cxa_fixedFifo_queue(&fifo, &newVal);
+		cxa_fixedFifo_dequeue(&fifo, &val);
+	}
+	cxa_bench_doNotOptimize(val);
+}
+
+
+static void bench_fifo_bulkQueueDequeue(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedFifo_initStd(&fifo, CXA_FF_ON_FULL_DROP, fifo_raw);
+
+	uint8_t data[FIFO_BULK_NUM_BYTES];
+	for( size_t i = 0; i < sizeof(data); i++ ) data[i] = (uint8_t)i;
+
+	// offset the fifo so the bulk operations regularly wrap
+	uint8_t pad = 0;
+	for( size_t i = 0; i < (FIFO_NUM_ELEMS - (FIFO_BULK_NUM_BYTES / 2)); i++ )
+	{
+		cxa_fixedFifo_queue(&fifo, &pad);
+		cxa_fixedFifo_dequeue(&fifo, NULL);
+	}
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedFifo_bulkQueue(&fifo, data, sizeof(data));
+
+		void* elems;
+		size_t numRemaining = sizeof(data);
+		while( numRemaining > 0 )
+		{
+			size_t numAvailable = cxa_fixedFifo_bulkDequeue_peek(&fifo, &elems);
+			if( numAvailable > numRemaining ) numAvailable = numRemaining;
+			cxa_bench_doNotOptimize(elems);
+			cxa_fixedFifo_bulkDequeue(&fifo, numAvailable);
+			numRemaining -= numAvailable;
+		}
+	}
+}
+
+
+static void bench_spsc_queueDequeue(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spsc_raw);
+
+	uint8_t val = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		uint8_t newVal = (uint8_t)i;
+		cxa_fixedFifo_spsc_queue(&spsc, &newVal);
+		cxa_fixedFifo_spsc_dequeue(&spsc, &val);
+	}
+	cxa_bench_doNotOptimize(val);
+}
+
+
+static void bench_spsc_bulkQueueDequeue(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedFifo_spsc_initStd(&spsc, spsc_raw);
+
+	uint8_t data[FIFO_BULK_NUM_BYTES];
+	for( size_t i = 0; i < sizeof(data); i++ ) data[i] = (uint8_t)i;
+
+	// offset the fifo so the bulk operations regularly wrap
+	uint8_t pad = 0;
+	for( size_t i = 0; i < (FIFO_NUM_ELEMS - (FIFO_BULK_NUM_BYTES / 2)); i++ )
+	{
+		cxa_fixedFifo_spsc_queue(&spsc, &pad);
+		cxa_fixedFifo_spsc_dequeue(&spsc, NULL);
+	}
+
+	uint8_t out[FIFO_BULK_NUM_BYTES];
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedFifo_spsc_bulkQueue(&spsc, data, sizeof(data));
+		cxa_fixedFifo_spsc_bulkDequeue(&spsc, out, sizeof(out));
+		cxa_bench_doNotOptimize(out[0]);
+	}
+}
+
+
+static void bench_fbb_appendUint32(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		for( uint32_t j = 0; j < 64; j++ )
+		{
+			cxa_fixedByteBuffer_append_uint32BE(&fbb, j);
+		}
+		cxa_bench_doNotOptimize(fbb_raw[FBB_NUM_BYTES-1]);
+		cxa_fixedByteBuffer_clear(&fbb);
+	}
+}
+
+
+static void bench_fbb_getUint16BE(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+	for( size_t j = 0; j < FBB_NUM_BYTES; j++ ) cxa_fixedByteBuffer_append_uint8(&fbb, (uint8_t)j);
+
+	uint16_t val = 0;
+	uint32_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedByteBuffer_get_uint16BE(&fbb, (i % (FBB_NUM_BYTES-1)), val);
+		sum += val;
+	}
+	cxa_bench_doNotOptimize(sum);
+}
+
+
+static void bench_fbb_insertRemoveFront(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+	for( size_t j = 0; j < (FBB_NUM_BYTES / 2); j++ ) cxa_fixedByteBuffer_append_uint8(&fbb, (uint8_t)j);
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedByteBuffer_insert_uint32(&fbb, 0, 0xA5A5A5A5);
+		cxa_fixedByteBuffer_remove_uint32(&fbb, 0);
+	}
+	cxa_bench_doNotOptimize(fbb_raw[0]);
+}
+
+
+static void bench_fbb_lengthPrefixedCString(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+
+	char* str;
+	uint16_t strLen_bytes;
+	bool isNullTerm;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedByteBuffer_clear(&fbb);
+		cxa_fixedByteBuffer_append_lengthPrefixedCString_uint16BE(&fbb, "devices/sensor/temperature", false);
+		cxa_fixedByteBuffer_get_lengthPrefixedCString_uint16BE(&fbb, 0, &str, &strLen_bytes, &isNullTerm);
+		cxa_bench_doNotOptimize(str);
+	}
+}
+
+
+static void bench_lf_buildChain(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+
+	uint8_t data[LF_FIELD_NUM_BYTES];
+	memset(data, 0x5A, sizeof(data));
+
+	cxa_linkedField_t fields[4];
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_fixedByteBuffer_clear(&fbb);
+
+		// mirrors how messages are built: append to each field in order
+		cxa_linkedField_initRoot(&fields[0], &fbb, 0, 0);
+		cxa_linkedField_append(&fields[0], data, sizeof(data));
+		for( size_t j = 1; j < 4; j++ )
+		{
+			cxa_linkedField_initChild(&fields[j], &fields[j-1], 0);
+			cxa_linkedField_append(&fields[j], data, sizeof(data));
+		}
+		cxa_bench_doNotOptimize(fbb_raw[0]);
+	}
+}
+
+
+static void bench_lf_insertRemoveFirst(size_t numItersIn, void* userVarIn)
+{
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_raw);
+
+	uint8_t data[LF_FIELD_NUM_BYTES];
+	memset(data, 0x5A, sizeof(data));
+
+	cxa_linkedField_t fields[4];
+	cxa_linkedField_initRoot(&fields[0], &fbb, 0, 0);
+	cxa_linkedField_append(&fields[0], data, sizeof(data));
+	for( size_t j = 1; j < 4; j++ )
+	{
+		cxa_linkedField_initChild(&fields[j], &fields[j-1], 0);
+		cxa_linkedField_append(&fields[j], data, sizeof(data));
+	}
+
+	// modifying the first field shifts all of the following fields
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_linkedField_insert_uint8(&fields[0], 0, 0xA5);
+		cxa_linkedField_remove_uint8(&fields[0], 0);
+	}
+	cxa_bench_doNotOptimize(fbb_raw[0]);
+}
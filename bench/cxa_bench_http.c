@@ -0,0 +1,491 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_network_httpClient.h>
+#include <cxa_posix_runLoop.h>
+#include <cxa_runLoop.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+// own thread so we don't also iterate the entries of other suites
+#define RUNLOOP_THREADID					6
+#define TICK_PERIOD_MS						10
+#define REQUEST_TIMEOUT_MS					2000
+#define MAX_NUM_SPINS						1000
+
+#define SERVER_LINE_MAXLEN_BYTES			256
+#define SERVER_BODY_MAXLEN_BYTES			4096
+
+#define CHUNKED_BODY_NUM_WRITES				100
+#define CHUNKED_BODY_WRITE_SIZE_BYTES		5
+
+// long enough for the client to reuse the connection before it goes away
+#define SERVER_IDLE_CLOSE_DELAY_MS			50
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	int listenSocket;
+	uint16_t portNum;
+
+	// written by the accept thread, read once a response has arrived
+	volatile int numAccepted;
+}server_t;
+
+
+typedef struct
+{
+	bool isDone;
+	bool wasSuccessful;
+	uint16_t status;
+	char body[128];
+
+	char streamedBody[128];
+	size_t numBodyWritesRemaining;
+}transaction_t;
+
+
+// ******** local function prototypes ********
+static bool check_contentLengthKeepAlive(void* userVarIn);
+static bool check_chunkedRequest(void* userVarIn);
+static bool check_chunkedResponse(void* userVarIn);
+static bool check_informationalNoContent(void* userVarIn);
+static bool check_readUntilClose(void* userVarIn);
+static bool check_staleConnectionRetry(void* userVarIn);
+
+static bool server_start(server_t *const serverIn);
+static void* server_acceptThread(void* userVarIn);
+static void* server_connectionThread(void* userVarIn);
+static int server_readLine(int fdIn, char *const lineOut, size_t maxLen_bytesIn);
+static bool server_readBytes(int fdIn, char *const buffOut, size_t numBytesIn);
+static void server_writeString(int fdIn, const char *const stringIn);
+
+static bool runTransaction(transaction_t *const transIn, cxa_network_httpClient_method_t methodIn, const char *const urlIn,
+						   cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn, bool sendChunkedIn, bool streamResponseIn);
+
+static void cb_tick(void* userVarIn);
+static bool cb_genBody_json(cxa_network_httpClient_t *const clientIn, cxa_ioStream_t *const iosIn, void* userVarIn);
+static bool cb_genBody_smallWrites(cxa_network_httpClient_t *const clientIn, cxa_ioStream_t *const iosIn, void* userVarIn);
+static void cb_onResponseData(cxa_network_httpClient_t *const clientIn, uint16_t statusIn, uint8_t *const dataIn, size_t dataLen_bytesIn, void* userVarIn);
+static void cb_onComplete(cxa_network_httpClient_t *const clientIn, bool didCompleteSuccessfully, uint16_t statusIn, char* bodyIn, size_t bodyLen_bytesIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static server_t server;
+static cxa_network_httpClient_t httpClient;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_http(void)
+{
+	if( !server_start(&server) )
+	{
+		fprintf(stderr, "http: unable to start local server\n");
+		return;
+	}
+
+	// something has to be timed so that waiting for events can't block forever
+	cxa_runLoop_addTimedEntry(RUNLOOP_THREADID, TICK_PERIOD_MS, NULL, cb_tick, NULL);
+	cxa_network_httpClient_init(&httpClient, RUNLOOP_THREADID);
+	cxa_runLoop_iterate(RUNLOOP_THREADID);				// startup callbacks (state machine)
+
+	cxa_bench_check("http/contentLength_keepAlive", check_contentLengthKeepAlive, &server);
+	cxa_bench_check("http/chunkedRequest", check_chunkedRequest, &server);
+	cxa_bench_check("http/chunkedResponse", check_chunkedResponse, &server);
+	cxa_bench_check("http/informationalNoContent", check_informationalNoContent, &server);
+	cxa_bench_check("http/readUntilClose", check_readUntilClose, &server);
+	cxa_bench_check("http/staleConnectionRetry", check_staleConnectionRetry, &server);
+}
+
+
+// ******** local function implementations ********
+static bool check_contentLengthKeepAlive(void* userVarIn)
+{
+	server_t* srv = (server_t*)userVarIn;
+
+	transaction_t trans;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_POST, "/echo", cb_genBody_json, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	cxa_bench_expect(strcmp(trans.body, "POST 13 chunks=0") == 0);
+	int numAccepted = srv->numAccepted;
+
+	// the second request should reuse the connection
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/echo", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	cxa_bench_expect(strcmp(trans.body, "GET 0 chunks=0") == 0);
+	cxa_bench_expect(srv->numAccepted == numAccepted);
+
+	return true;
+}
+
+
+static bool check_chunkedRequest(void* userVarIn)
+{
+	transaction_t trans;
+	trans.numBodyWritesRemaining = CHUNKED_BODY_NUM_WRITES;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_PUT, "/echo", cb_genBody_smallWrites, true, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+
+	// small writes should be collected into full chunks
+	size_t numBodyBytes = CHUNKED_BODY_NUM_WRITES * CHUNKED_BODY_WRITE_SIZE_BYTES;
+	size_t numExpectedChunks = (numBodyBytes + CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES - 1) / CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES;
+	char expectedBody[sizeof(trans.body)];
+	snprintf(expectedBody, sizeof(expectedBody), "PUT %zu chunks=%zu", numBodyBytes, numExpectedChunks);
+	cxa_bench_expect(strcmp(trans.body, expectedBody) == 0);
+
+	return true;
+}
+
+
+static bool check_chunkedResponse(void* userVarIn)
+{
+	transaction_t trans;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/chunked", NULL, false, true));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 201));
+	cxa_bench_expect(strcmp(trans.streamedBody, "hello, world!") == 0);
+
+	return true;
+}
+
+
+static bool check_informationalNoContent(void* userVarIn)
+{
+	transaction_t trans;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_POST, "/noContent", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 204));
+
+	return true;
+}
+
+
+static bool check_readUntilClose(void* userVarIn)
+{
+	transaction_t trans;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/untilClose", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	cxa_bench_expect(strcmp(trans.body, "until close body") == 0);
+
+	return true;
+}
+
+
+static bool check_staleConnectionRetry(void* userVarIn)
+{
+	server_t* srv = (server_t*)userVarIn;
+
+	// the server closes this (keep-alive) connection shortly after responding...
+	transaction_t trans;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/idleClose", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	int numAccepted = srv->numAccepted;
+
+	// ...so a GET sent on it is quietly retried on a new connection
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/echo", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	cxa_bench_expect(strcmp(trans.body, "GET 0 chunks=0") == 0);
+	cxa_bench_expect(srv->numAccepted == (numAccepted + 1));
+
+	// ...but a POST that made it out isn't (the server might have acted on it)
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_GET, "/idleClose", NULL, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	numAccepted = srv->numAccepted;
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_POST, "/echo", cb_genBody_json, false, false));
+	cxa_bench_expect(!trans.wasSuccessful);
+	cxa_bench_expect(srv->numAccepted == numAccepted);
+
+	// retrying it is up to the caller
+	cxa_bench_expect(runTransaction(&trans, CXA_NETWORK_HTTPCLIENT_METHOD_POST, "/echo", cb_genBody_json, false, false));
+	cxa_bench_expect(trans.wasSuccessful && (trans.status == 200));
+	cxa_bench_expect(strcmp(trans.body, "POST 13 chunks=0") == 0);
+	cxa_bench_expect(srv->numAccepted == (numAccepted + 1));
+
+	return true;
+}
+
+
+static bool server_start(server_t *const serverIn)
+{
+	cxa_assert(serverIn);
+
+	serverIn->numAccepted = 0;
+
+	serverIn->listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if( serverIn->listenSocket < 0 ) return false;
+
+	struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK), .sin_port = 0 };
+	socklen_t addrLen = sizeof(addr);
+	if( (bind(serverIn->listenSocket, (struct sockaddr*)&addr, sizeof(addr)) != 0) ||
+		(listen(serverIn->listenSocket, 4) != 0) ||
+		(getsockname(serverIn->listenSocket, (struct sockaddr*)&addr, &addrLen) != 0) )
+	{
+		close(serverIn->listenSocket);
+		return false;
+	}
+	serverIn->portNum = ntohs(addr.sin_port);
+
+	pthread_t thread;
+	if( pthread_create(&thread, NULL, server_acceptThread, (void*)serverIn) != 0 ) return false;
+	pthread_detach(thread);
+
+	return true;
+}
+
+
+static void* server_acceptThread(void* userVarIn)
+{
+	server_t* srv = (server_t*)userVarIn;
+
+	while( 1 )
+	{
+		int fd = accept(srv->listenSocket, NULL, NULL);
+		if( fd < 0 ) break;
+		srv->numAccepted++;
+
+		pthread_t thread;
+		if( pthread_create(&thread, NULL, server_connectionThread, (void*)(intptr_t)fd) != 0 )
+		{
+			close(fd);
+			continue;
+		}
+		pthread_detach(thread);
+	}
+
+	return NULL;
+}
+
+
+static void* server_connectionThread(void* userVarIn)
+{
+	int fd = (int)(intptr_t)userVarIn;
+	char line[SERVER_LINE_MAXLEN_BYTES];
+	char body[SERVER_BODY_MAXLEN_BYTES];
+
+	// one request at a time for as long as the client keeps the connection open
+	while( server_readLine(fd, line, sizeof(line)) >= 0 )
+	{
+		char method[16], path[64];
+		if( sscanf(line, "%15s %63s", method, path) != 2 ) break;
+
+		long contentLength_bytes = 0;
+		bool isChunked = false;
+		bool shouldClose = false;
+		int lineLen;
+		while( (lineLen = server_readLine(fd, line, sizeof(line))) > 0 )
+		{
+			if( strncasecmp(line, "Content-Length:", 15) == 0 ) contentLength_bytes = atol(&line[15]);
+			if( (strncasecmp(line, "Transfer-Encoding:", 18) == 0) && (strstr(line, "chunked") != NULL) ) isChunked = true;
+			if( strncasecmp(line, "Connection: close", 17) == 0 ) shouldClose = true;
+		}
+		if( lineLen < 0 ) break;
+
+		size_t bodyLen_bytes = 0;
+		int numChunks = 0;
+		if( isChunked )
+		{
+			while( 1 )
+			{
+				if( server_readLine(fd, line, sizeof(line)) < 0 ) goto done;
+				size_t chunkSize_bytes = strtoul(line, NULL, 16);
+				if( chunkSize_bytes == 0 )
+				{
+					server_readLine(fd, line, sizeof(line));
+					break;
+				}
+				if( ((bodyLen_bytes + chunkSize_bytes) > sizeof(body)) ||
+					!server_readBytes(fd, &body[bodyLen_bytes], chunkSize_bytes) ||
+					(server_readLine(fd, line, sizeof(line)) != 0) ) goto done;
+				bodyLen_bytes += chunkSize_bytes;
+				numChunks++;
+			}
+		}
+		else if( contentLength_bytes > 0 )
+		{
+			if( ((size_t)contentLength_bytes > sizeof(body)) || !server_readBytes(fd, body, contentLength_bytes) ) break;
+			bodyLen_bytes = contentLength_bytes;
+		}
+
+		if( strcmp(path, "/echo") == 0 )
+		{
+			char respBody[64];
+			snprintf(respBody, sizeof(respBody), "%s %zu chunks=%d", method, bodyLen_bytes, numChunks);
+			char resp[128];
+			snprintf(resp, sizeof(resp), "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n%s", strlen(respBody), respBody);
+			server_writeString(fd, resp);
+		}
+		else if( strcmp(path, "/chunked") == 0 )
+		{
+			// chunk extensions and trailers should be ignored
+			server_writeString(fd, "HTTP/1.1 201 Created\r\ntransfer-encoding: chunked\r\n\r\n5\r\nhello\r\n7;ext=1\r\n, world\r\n");
+			usleep(10000);
+			server_writeString(fd, "1\r\n!\r\n0\r\nX-Trailer: y\r\n\r\n");
+		}
+		else if( strcmp(path, "/noContent") == 0 )
+		{
+			server_writeString(fd, "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 204 No Content\r\n\r\n");
+		}
+		else if( strcmp(path, "/untilClose") == 0 )
+		{
+			server_writeString(fd, "HTTP/1.0 200 OK\r\n\r\nuntil close body");
+			break;
+		}
+		else if( strcmp(path, "/idleClose") == 0 )
+		{
+			// looks like keep-alive, but we time out the connection (without reading the next request)
+			server_writeString(fd, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+			usleep(SERVER_IDLE_CLOSE_DELAY_MS * 1000);
+			break;
+		}
+		else
+		{
+			server_writeString(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+		}
+
+		if( shouldClose ) break;
+	}
+
+done:
+	close(fd);
+	return NULL;
+}
+
+
+static int server_readLine(int fdIn, char *const lineOut, size_t maxLen_bytesIn)
+{
+	size_t numBytes = 0;
+	while( numBytes < (maxLen_bytesIn - 1) )
+	{
+		char currChar;
+		if( read(fdIn, &currChar, 1) != 1 ) return -1;
+		lineOut[numBytes++] = currChar;
+
+		if( (numBytes >= 2) && (lineOut[numBytes-2] == '\r') && (lineOut[numBytes-1] == '\n') )
+		{
+			lineOut[numBytes-2] = 0;
+			return (int)(numBytes - 2);
+		}
+	}
+	return -1;
+}
+
+
+static bool server_readBytes(int fdIn, char *const buffOut, size_t numBytesIn)
+{
+	size_t numBytesSoFar = 0;
+	while( numBytesSoFar < numBytesIn )
+	{
+		ssize_t numBytesRead = read(fdIn, &buffOut[numBytesSoFar], numBytesIn - numBytesSoFar);
+		if( numBytesRead <= 0 ) return false;
+		numBytesSoFar += numBytesRead;
+	}
+	return true;
+}
+
+
+static void server_writeString(int fdIn, const char *const stringIn)
+{
+	// the client notices anything short
+	ssize_t numBytesWritten = write(fdIn, stringIn, strlen(stringIn));
+	(void)numBytesWritten;
+}
+
+
+static bool runTransaction(transaction_t *const transIn, cxa_network_httpClient_method_t methodIn, const char *const urlIn,
+						   cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn, bool sendChunkedIn, bool streamResponseIn)
+{
+	cxa_assert(transIn);
+
+	transIn->isDone = false;
+	transIn->wasSuccessful = false;
+	transIn->status = 0;
+	transIn->body[0] = 0;
+	transIn->streamedBody[0] = 0;
+
+	// leave room to terminate the body
+	if( !cxa_network_httpClient_request_async(&httpClient, methodIn, "127.0.0.1", server.portNum, false,
+											  urlIn, REQUEST_TIMEOUT_MS, true,
+											  NULL, cb_genBodyIn, sendChunkedIn,
+											  streamResponseIn ? cb_onResponseData : NULL, cb_onComplete,
+											  streamResponseIn ? NULL : (uint8_t*)transIn->body, streamResponseIn ? 0 : (sizeof(transIn->body) - 1),
+											  (void*)transIn) ) return false;
+
+	for( int i = 0; (i < MAX_NUM_SPINS) && !transIn->isDone; i++ )
+	{
+		cxa_runLoop_iterate(RUNLOOP_THREADID);
+		cxa_posix_runLoop_waitForEvents(RUNLOOP_THREADID);
+	}
+
+	return transIn->isDone;
+}
+
+
+static void cb_tick(void* userVarIn)
+{
+}
+
+
+static bool cb_genBody_json(cxa_network_httpClient_t *const clientIn, cxa_ioStream_t *const iosIn, void* userVarIn)
+{
+	cxa_ioStream_writeString(iosIn, "{\"a\":1,");
+	cxa_ioStream_writeString(iosIn, "\"b\":2}");
+	return false;
+}
+
+
+static bool cb_genBody_smallWrites(cxa_network_httpClient_t *const clientIn, cxa_ioStream_t *const iosIn, void* userVarIn)
+{
+	transaction_t* trans = (transaction_t*)userVarIn;
+	cxa_assert(trans);
+
+	// a few writes per call (and yield in between)
+	for( int i = 0; (i < 10) && (trans->numBodyWritesRemaining > 0); i++, trans->numBodyWritesRemaining-- )
+	{
+		cxa_ioStream_writeBytes(iosIn, "abcde", CHUNKED_BODY_WRITE_SIZE_BYTES);
+	}
+	return (trans->numBodyWritesRemaining > 0);
+}
+
+
+static void cb_onResponseData(cxa_network_httpClient_t *const clientIn, uint16_t statusIn, uint8_t *const dataIn, size_t dataLen_bytesIn, void* userVarIn)
+{
+	transaction_t* trans = (transaction_t*)userVarIn;
+	cxa_assert(trans);
+
+	size_t currLen_bytes = strlen(trans->streamedBody);
+	size_t numFree_bytes = sizeof(trans->streamedBody) - currLen_bytes - 1;
+	size_t numToCopy_bytes = (dataLen_bytesIn < numFree_bytes) ? dataLen_bytesIn : numFree_bytes;
+	memcpy(&trans->streamedBody[currLen_bytes], dataIn, numToCopy_bytes);
+	trans->streamedBody[currLen_bytes + numToCopy_bytes] = 0;
+}
+
+
+static void cb_onComplete(cxa_network_httpClient_t *const clientIn, bool didCompleteSuccessfully, uint16_t statusIn, char* bodyIn, size_t bodyLen_bytesIn, void* userVarIn)
+{
+	transaction_t* trans = (transaction_t*)userVarIn;
+	cxa_assert(trans);
+
+	trans->isDone = true;
+	trans->wasSuccessful = didCompleteSuccessfully;
+	trans->status = statusIn;
+	if( (bodyIn != NULL) && (bodyLen_bytesIn < sizeof(trans->body)) ) trans->body[bodyLen_bytesIn] = 0;
+}
@@ -0,0 +1,279 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_ioStream.h>
+#include <cxa_numberUtils.h>
+#include <cxa_stringUtils.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define TOPIC_STRING					"v1/->/30:AE:A4:01:74:90/streams/amb_temp/onUpdate"
+#define HEX_NUM_BYTES					32
+#define STRING_BUFFER_SIZE_BYTES		128
+#define CRC_NUM_BYTES					256
+
+// the standard check value for CRC-16/ARC
+#define CRC_CHECK_STRING				"123456789"
+#define CRC_CHECK_VALUE					0xBB3D
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static void bench_startsWith(size_t numItersIn, void* userVarIn);
+static void bench_equals(size_t numItersIn, void* userVarIn);
+static void bench_indexOfFirstOccurence(size_t numItersIn, void* userVarIn);
+static void bench_countOccurences(size_t numItersIn, void* userVarIn);
+static void bench_replaceFirstOccurence(size_t numItersIn, void* userVarIn);
+static void bench_copyConcat(size_t numItersIn, void* userVarIn);
+static void bench_bytesToHexString(size_t numItersIn, void* userVarIn);
+static void bench_hexStringToBytes(size_t numItersIn, void* userVarIn);
+static void bench_parseString(size_t numItersIn, void* userVarIn);
+
+static bool check_crc16_knownAnswer(void* userVarIn);
+static void bench_crc16(size_t numItersIn, void* userVarIn);
+
+static void bench_logger_formatted(size_t numItersIn, void* userVarIn);
+static void bench_logger_memDump(size_t numItersIn, void* userVarIn);
+
+static bool nullIoStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static cxa_ioStream_readStatus_t nullIoStream_cb_readByte(uint8_t *const byteOut, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+static const char topicString[] = TOPIC_STRING;
+static const char topicStringCopy[] = TOPIC_STRING;
+
+static uint8_t hexBytes[HEX_NUM_BYTES];
+static uint8_t crcBytes[CRC_NUM_BYTES];
+static char hexString[(HEX_NUM_BYTES * 2) + 1];
+
+static cxa_ioStream_t nullIoStream;
+static size_t nullIoStream_numBytesWritten = 0;
+
+static cxa_logger_t logger;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_misc(void)
+{
+	for( size_t i = 0; i < sizeof(hexBytes); i++ ) hexBytes[i] = (uint8_t)(i * 7);
+	cxa_assert( cxa_stringUtils_bytesToHexString(hexBytes, sizeof(hexBytes), false, hexString, sizeof(hexString)) );
+
+	cxa_bench_run("stringUtils/startsWith_withLengths", 10000000, 0, bench_startsWith, NULL);
+	cxa_bench_run("stringUtils/equals_withLengths", 10000000, sizeof(topicString)-1, bench_equals, NULL);
+	cxa_bench_run("stringUtils/indexOfFirstOccurence", 1000000, sizeof(topicString)-1, bench_indexOfFirstOccurence, NULL);
+	cxa_bench_run("stringUtils/countOccurences", 1000000, sizeof(topicString)-1, bench_countOccurences, NULL);
+	cxa_bench_run("stringUtils/replaceFirstOccurence", 1000000, sizeof(topicString)-1, bench_replaceFirstOccurence, NULL);
+	cxa_bench_run("stringUtils/copyConcat", 1000000, sizeof(topicString)-1, bench_copyConcat, NULL);
+	cxa_bench_run("stringUtils/bytesToHexString_32", 100000, HEX_NUM_BYTES, bench_bytesToHexString, NULL);
+	cxa_bench_run("stringUtils/hexStringToBytes_32", 1000000, HEX_NUM_BYTES, bench_hexStringToBytes, NULL);
+	cxa_bench_run("stringUtils/parseString", 1000000, 0, bench_parseString, NULL);
+
+	cxa_bench_check("numberUtils/crc16_knownAnswer", check_crc16_knownAnswer, NULL);
+	for( size_t i = 0; i < sizeof(crcBytes); i++ ) crcBytes[i] = (uint8_t)(i * 13);
+	cxa_bench_run("numberUtils/crc16_256", 200000, CRC_NUM_BYTES, bench_crc16, NULL);
+
+	// logger output goes to a stream that just counts bytes
+	cxa_ioStream_init(&nullIoStream);
+	cxa_ioStream_bind(&nullIoStream, nullIoStream_cb_readByte, nullIoStream_cb_writeBytes, NULL);
+	cxa_logger_setGlobalIoStream(&nullIoStream);
+	cxa_logger_init(&logger, "bench");
+
+	cxa_bench_run("logger/formattedLine", 200000, 0, bench_logger_formatted, NULL);
+	cxa_bench_run("logger/memDump_32", 200000, HEX_NUM_BYTES, bench_logger_memDump, NULL);
+}
+
+
+// ******** local function implementations ********
+static void bench_startsWith(size_t numItersIn, void* userVarIn)
+{
+	static const char prefix[] = "v1/->/";
+
+	size_t numMatches = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		numMatches += cxa_stringUtils_startsWith_withLengths(topicString, sizeof(topicString)-1, prefix, sizeof(prefix)-1);
+	}
+	cxa_bench_doNotOptimize(numMatches);
+}
+
+
+static void bench_equals(size_t numItersIn, void* userVarIn)
+{
+	size_t numMatches = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		numMatches += cxa_stringUtils_equals_withLengths(topicString, sizeof(topicString)-1, topicStringCopy, sizeof(topicStringCopy)-1);
+	}
+	cxa_bench_doNotOptimize(numMatches);
+}
+
+
+static void bench_indexOfFirstOccurence(size_t numItersIn, void* userVarIn)
+{
+	static const char element[] = "onUpdate";
+
+	ssize_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		sum += cxa_stringUtils_indexOfFirstOccurence_withLengths(topicString, sizeof(topicString)-1, element, sizeof(element)-1);
+	}
+	cxa_bench_doNotOptimize(sum);
+}
+
+
+static void bench_countOccurences(size_t numItersIn, void* userVarIn)
+{
+	size_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		sum += cxa_stringUtils_countOccurences_withLengths(topicString, sizeof(topicString)-1, "/", 1);
+	}
+	cxa_bench_doNotOptimize(sum);
+}
+
+
+static void bench_replaceFirstOccurence(size_t numItersIn, void* userVarIn)
+{
+	char buffer[STRING_BUFFER_SIZE_BYTES];
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		// replacement is done in place so we need a fresh copy each time
+		memcpy(buffer, topicString, sizeof(topicString));
+		bool success = cxa_stringUtils_replaceFirstOccurence(buffer, "amb_temp", "tmp");
+		cxa_bench_doNotOptimize(success);
+	}
+}
+
+
+static void bench_copyConcat(size_t numItersIn, void* userVarIn)
+{
+	char buffer[STRING_BUFFER_SIZE_BYTES];
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_stringUtils_copy(buffer, "v1/->/", sizeof(buffer));
+		cxa_stringUtils_concat(buffer, "30:AE:A4:01:74:90", sizeof(buffer));
+		cxa_stringUtils_concat(buffer, "/streams/amb_temp/onUpdate", sizeof(buffer));
+		cxa_bench_doNotOptimize(buffer);
+	}
+}
+
+
+static void bench_bytesToHexString(size_t numItersIn, void* userVarIn)
+{
+	char buffer[sizeof(hexString)];
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		bool success = cxa_stringUtils_bytesToHexString(hexBytes, sizeof(hexBytes), false, buffer, sizeof(buffer));
+		cxa_bench_doNotOptimize(success);
+	}
+}
+
+
+static void bench_hexStringToBytes(size_t numItersIn, void* userVarIn)
+{
+	uint8_t buffer[HEX_NUM_BYTES];
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		bool success = cxa_stringUtils_hexStringToBytes(hexString, sizeof(buffer), false, buffer);
+		cxa_bench_doNotOptimize(success);
+	}
+}
+
+
+static void bench_parseString(size_t numItersIn, void* userVarIn)
+{
+	static const char* inputs[] = { "12345", "-42", "3.14159", "onUpdate" };
+	char buffer[16];
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_stringUtils_parseResult_t result;
+		cxa_stringUtils_copy(buffer, inputs[i % (sizeof(inputs)/sizeof(*inputs))], sizeof(buffer));
+		bool success = cxa_stringUtils_parseString(buffer, &result);
+		cxa_bench_doNotOptimize(success);
+		cxa_bench_doNotOptimize(result.dataType);
+	}
+}
+
+
+static bool check_crc16_knownAnswer(void* userVarIn)
+{
+	char checkString[] = CRC_CHECK_STRING;
+	size_t checkLen_bytes = sizeof(checkString) - 1;
+	cxa_bench_expect(cxa_numberUtils_crc16_oneShot(checkString, checkLen_bytes) == CRC_CHECK_VALUE);
+
+	// same answer a piece at a time
+	uint16_t crc = cxa_numberUtils_crc16_update(0, checkString, 4);
+	crc = cxa_numberUtils_crc16_update(crc, &checkString[4], checkLen_bytes - 4);
+	cxa_bench_expect(crc == CRC_CHECK_VALUE);
+
+	crc = 0;
+	for( size_t i = 0; i < checkLen_bytes; i++ ) crc = cxa_numberUtils_crc16_step(crc, (uint8_t)checkString[i]);
+	cxa_bench_expect(crc == CRC_CHECK_VALUE);
+
+	return true;
+}
+
+
+static void bench_crc16(size_t numItersIn, void* userVarIn)
+{
+	uint16_t crc = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		crc ^= cxa_numberUtils_crc16_oneShot(crcBytes, sizeof(crcBytes));
+	}
+	cxa_bench_doNotOptimize(crc);
+}
+
+
+static void bench_logger_formatted(size_t numItersIn, void* userVarIn)
+{
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_logger_info(&logger, "rx packet %d from '%s' (%d bytes)", (int)i, "30:AE:A4:01:74:90", 64);
+	}
+	cxa_bench_doNotOptimize(nullIoStream_numBytesWritten);
+}
+
+
+static void bench_logger_memDump(size_t numItersIn, void* userVarIn)
+{
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_logger_debug_memDump(&logger, "payload: ", hexBytes, sizeof(hexBytes), NULL);
+	}
+	cxa_bench_doNotOptimize(nullIoStream_numBytesWritten);
+}
+
+
+static bool nullIoStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	nullIoStream_numBytesWritten += bufferSize_bytesIn;
+	return true;
+}
+
+
+static cxa_ioStream_readStatus_t nullIoStream_cb_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	return CXA_IOSTREAM_READSTAT_NODATA;
+}
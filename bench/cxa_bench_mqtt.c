@@ -0,0 +1,613 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_fixedFifo.h>
+#include <cxa_mqtt_client.h>
+#include <cxa_mqtt_message.h>
+#include <cxa_mqtt_message_connack.h>
+#include <cxa_mqtt_message_connect.h>
+#include <cxa_mqtt_message_pingRequest.h>
+#include <cxa_mqtt_message_pingResponse.h>
+#include <cxa_mqtt_message_puback.h>
+#include <cxa_mqtt_message_pubcomp.h>
+#include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_pubrec.h>
+#include <cxa_mqtt_message_pubrel.h>
+#include <cxa_mqtt_message_suback.h>
+#include <cxa_mqtt_message_subscribe.h>
+#include <cxa_mqtt_topicTrie.h>
+#include <cxa_runLoop.h>
+#include <cxa_stringUtils.h>
+
+
+// ******** local macro definitions ********
+#define MSG_BUFFER_SIZE_BYTES			256
+#define PUBLISH_PAYLOAD_SIZE_BYTES		64
+#define PUBLISH_TOPIC					"v1/->/30:AE:A4:01:74:90/streams/amb_temp/onUpdate"
+
+#define TRIE_MAXNUM_NODES				64
+#define TRIE_MAXNUM_VALUES				32
+
+// own thread so we don't also iterate the entries of other suites
+#define CLIENT_RUNLOOP_THREADID			8
+#define CLIENT_TOPIC					"bench/retained"
+#define CLIENT_MAXNUM_HELD				3
+#define CLIENT_MAX_ITERATIONS			64
+#define CLIENT_DEEP_FILTER				"v1/->/node/child/grandchild/method/+/#"
+#define CLIENT_DEEP_TOPIC				"v1/->/node/child/grandchild/method/setState/now"
+
+
+// ******** local type definitions ********
+typedef enum
+{
+	ENC_CONNECT,
+	ENC_CONNACK,
+	ENC_PUBLISH_QOS0,
+	ENC_PUBLISH_QOS1,
+	ENC_PUBACK,
+	ENC_PUBREC,
+	ENC_PUBREL,
+	ENC_PUBCOMP,
+	ENC_SUBSCRIBE,
+	ENC_SUBACK,
+	ENC_PINGREQ,
+	ENC_PINGRESP,
+	ENC_NUM_TYPES
+}encodedType_t;
+
+
+typedef struct
+{
+	const char* name;
+	uint8_t bytes[MSG_BUFFER_SIZE_BYTES];
+	size_t numBytes;
+}encodedMessage_t;
+
+
+typedef struct
+{
+	cxa_mqtt_client_t client;
+	cxa_ioStream_t ios;
+	cxa_fixedFifo_t rxFifo;
+	uint8_t rxFifo_raw[MSG_BUFFER_SIZE_BYTES * 2];
+
+	// subscribers hold on to every message they receive
+	cxa_mqtt_message_t* held[CLIENT_MAXNUM_HELD];
+	size_t numReceived;
+
+	// the "connection" drops on the next read
+	bool failNextRead;
+
+	// what the client sent
+	size_t numConnectsSent;
+	uint16_t dupPacketIds[CXA_MQTT_CLIENT_MAXNUM_INFLIGHT];
+	size_t numDupPublishesSent;
+}clientCheck_t;
+
+
+// ******** local function prototypes ********
+static bool check_client_retainedPublish(void* userVarIn);
+static bool check_client_fullWindowReconnect(void* userVarIn);
+static bool check_client_subscribeLimits(void* userVarIn);
+
+static bool encodeMessage(encodedType_t typeIn, cxa_mqtt_message_t *const msgIn);
+
+static void bench_encode(size_t numItersIn, void* userVarIn);
+static void bench_decode(size_t numItersIn, void* userVarIn);
+static void bench_topicTrie_match(size_t numItersIn, void* userVarIn);
+
+static void cb_onTrieMatch(void *const valueIn, void *const userVarIn);
+
+static void client_iterateUntilReceived(clientCheck_t *const ccIn, size_t numReceivedIn);
+static void client_iterateUntilConnected(clientCheck_t *const ccIn, bool isConnectedIn);
+static bool client_feedPublish(clientCheck_t *const ccIn, char *const payloadIn);
+static bool client_isPayload(cxa_mqtt_message_t *const msgIn, char *const payloadIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static void cb_onPublish_hold(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+							  char* topicNameIn, size_t topicNameLen_bytesIn, void* payloadIn, size_t payloadLen_bytesIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static cxa_mqtt_message_t msg;
+static cxa_fixedByteBuffer_t msgFbb;
+static uint8_t msgFbb_raw[MSG_BUFFER_SIZE_BYTES];
+
+static uint8_t publishPayload[PUBLISH_PAYLOAD_SIZE_BYTES];
+
+static encodedMessage_t encodedMessages[ENC_NUM_TYPES] = {
+	[ENC_CONNECT] = { .name = "connect" },
+	[ENC_CONNACK] = { .name = "connack" },
+	[ENC_PUBLISH_QOS0] = { .name = "publish_qos0_64" },
+	[ENC_PUBLISH_QOS1] = { .name = "publish_qos1_64" },
+	[ENC_PUBACK] = { .name = "puback" },
+	[ENC_PUBREC] = { .name = "pubrec" },
+	[ENC_PUBREL] = { .name = "pubrel" },
+	[ENC_PUBCOMP] = { .name = "pubcomp" },
+	[ENC_SUBSCRIBE] = { .name = "subscribe" },
+	[ENC_SUBACK] = { .name = "suback" },
+	[ENC_PINGREQ] = { .name = "pingreq" },
+	[ENC_PINGRESP] = { .name = "pingresp" },
+};
+
+// no encoder exists for SUBACK (we never send one)
+static const uint8_t subackBytes[] = { 0x90, 0x03, 0x12, 0x34, 0x01 };
+
+static cxa_mqtt_topicTrie_t trie;
+static cxa_mqtt_topicTrie_node_t trie_nodes[TRIE_MAXNUM_NODES];
+static cxa_mqtt_topicTrie_value_t trie_values[TRIE_MAXNUM_VALUES];
+
+static const char* trieFilters[] = {
+	"v1/->/30:AE:A4:01:74:90/#",
+	"v1/<-/30:AE:A4:01:74:90/#",
+	"v1/^^/+/streams/+/onUpdate",
+	"v1/^^/30:AE:A4:01:74:90/streams/upstreamConnState/onStreamUpdate",
+	"$aws/things/+/shadow/update/accepted",
+	"$aws/things/+/shadow/update/rejected",
+	"$aws/things/+/shadow/get/accepted",
+	"devices/+/status",
+	"devices/+/config/#",
+	"broadcast/#",
+};
+
+static const char* trieTopics[] = {
+	PUBLISH_TOPIC,
+	"v1/^^/30:AE:A4:01:74:90/streams/upstreamConnState/onStreamUpdate",
+	"$aws/things/thermostat/shadow/update/accepted",
+	"devices/1234/config/network/wifi",
+	"devices/1234/unmatched",
+	"some/other/topic/entirely",
+};
+
+static clientCheck_t clientCheck;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_mqtt(void)
+{
+	for( size_t i = 0; i < sizeof(publishPayload); i++ ) publishPayload[i] = (uint8_t)i;
+	cxa_fixedByteBuffer_initStd(&msgFbb, msgFbb_raw);
+
+	// pre-encode everything so the decode benchmarks have input
+	for( encodedType_t currType = 0; currType < ENC_NUM_TYPES; currType++ )
+	{
+		encodedMessage_t* currEnc = &encodedMessages[currType];
+
+		cxa_assert( encodeMessage(currType, &msg) );
+		currEnc->numBytes = cxa_fixedByteBuffer_getSize_bytes(&msgFbb);
+		cxa_assert(currEnc->numBytes <= sizeof(currEnc->bytes));
+		memcpy(currEnc->bytes, cxa_fixedByteBuffer_get_pointerToIndex(&msgFbb, 0), currEnc->numBytes);
+	}
+
+	char benchName[CXA_BENCH_MAXLEN_NAME_BYTES];
+	for( encodedType_t currType = 0; currType < ENC_NUM_TYPES; currType++ )
+	{
+		if( currType == ENC_SUBACK ) continue;
+
+		snprintf(benchName, sizeof(benchName), "mqtt/encode_%s", encodedMessages[currType].name);
+		cxa_bench_run(benchName, 200000, encodedMessages[currType].numBytes, bench_encode, (void*)currType);
+	}
+	for( encodedType_t currType = 0; currType < ENC_NUM_TYPES; currType++ )
+	{
+		snprintf(benchName, sizeof(benchName), "mqtt/decode_%s", encodedMessages[currType].name);
+		cxa_bench_run(benchName, 200000, encodedMessages[currType].numBytes, bench_decode, &encodedMessages[currType]);
+	}
+
+	cxa_mqtt_topicTrie_init(&trie, trie_nodes, TRIE_MAXNUM_NODES, trie_values, TRIE_MAXNUM_VALUES);
+	for( size_t i = 0; i < sizeof(trieFilters)/sizeof(*trieFilters); i++ )
+	{
+		cxa_assert( cxa_mqtt_topicTrie_add(&trie, trieFilters[i], (void*)trieFilters[i]) );
+	}
+	cxa_bench_run("mqtt/topicTrie_match", 1000000, 0, bench_topicTrie_match, NULL);
+
+	// the "broker" is whatever we queue into rxFifo
+	cxa_fixedFifo_initStd(&clientCheck.rxFifo, CXA_FF_ON_FULL_DROP, clientCheck.rxFifo_raw);
+	cxa_ioStream_init(&clientCheck.ios);
+	cxa_ioStream_bind(&clientCheck.ios, cb_ioStream_readByte, cb_ioStream_writeBytes, &clientCheck);
+	cxa_mqtt_client_init(&clientCheck.client, &clientCheck.ios, 0, "bench", CLIENT_RUNLOOP_THREADID);
+	cxa_assert( cxa_mqtt_client_subscribe(&clientCheck.client, CLIENT_TOPIC, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, &clientCheck) );
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+
+	cxa_bench_check("mqtt/client_retainedPublish", check_client_retainedPublish, &clientCheck);
+	cxa_bench_check("mqtt/client_fullWindowReconnect", check_client_fullWindowReconnect, &clientCheck);
+	cxa_bench_check("mqtt/client_subscribeLimits", check_client_subscribeLimits, &clientCheck);
+}
+
+
+// ******** local function implementations ********
+static bool check_client_retainedPublish(void* userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+
+	// the client ignores packets until it is actually connecting
+	cxa_bench_expect(cxa_mqtt_client_connect(&cc->client, NULL, NULL, 0));
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	uint8_t connAck[] = { 0x20, 0x02, 0x00, CXA_MQTT_CONNACK_RETCODE_ACCEPTED };
+	cxa_bench_expect(cxa_fixedFifo_bulkQueue(&cc->rxFifo, connAck, sizeof(connAck)));
+	for( size_t i = 0; (i < CLIENT_MAX_ITERATIONS) && !cxa_mqtt_client_isConnected(&cc->client); i++ ) cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	cxa_bench_expect(cxa_mqtt_client_isConnected(&cc->client));
+	size_t numFreeMsgs = cxa_mqtt_messageFactory_getNumFreeMessages();
+
+	cxa_protocolParser_rxPoolStats_t stats;
+	cxa_protocolParser_getRxPoolStats(&cc->client.mpp.super, &stats);
+	cxa_bench_expect((stats.numBuffers == CXA_MQTT_CLIENT_NUM_RX_MESSAGES) && (stats.numExhausted == 0));
+
+	// each held message moves the client on to its next receive message...
+	cxa_bench_expect(client_feedPublish(cc, "first"));
+	client_iterateUntilReceived(cc, 1);
+	cxa_bench_expect(client_feedPublish(cc, "second"));
+	client_iterateUntilReceived(cc, 2);
+	cxa_bench_expect(cc->numReceived == CXA_MQTT_CLIENT_NUM_RX_MESSAGES);
+
+	// ...until they're all held, then it stops reading
+	cxa_bench_expect(client_feedPublish(cc, "third"));
+	client_iterateUntilReceived(cc, 3);
+	cxa_bench_expect(cc->numReceived == CXA_MQTT_CLIENT_NUM_RX_MESSAGES);
+	cxa_protocolParser_getRxPoolStats(&cc->client.mpp.super, &stats);
+	cxa_bench_expect((stats.numFree == 0) && (stats.numExhausted == 1));
+	cxa_bench_expect(client_isPayload(cc->held[0], "first"));
+	cxa_bench_expect(client_isPayload(cc->held[1], "second"));
+
+	// dereferencing one lets the client read the next publish into it
+	cxa_mqtt_messageFactory_decrementMessageRefCount(cc->held[0]);
+	client_iterateUntilReceived(cc, 3);
+	cxa_bench_expect(cc->numReceived == 3);
+	cxa_bench_expect(cc->held[2] == cc->held[0]);
+	cxa_bench_expect(client_isPayload(cc->held[1], "second"));
+	cxa_bench_expect(client_isPayload(cc->held[2], "third"));
+
+	cxa_mqtt_messageFactory_decrementMessageRefCount(cc->held[1]);
+	cxa_mqtt_messageFactory_decrementMessageRefCount(cc->held[2]);
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	cxa_protocolParser_getRxPoolStats(&cc->client.mpp.super, &stats);
+	cxa_bench_expect(stats.numFree == (CXA_MQTT_CLIENT_NUM_RX_MESSAGES - 1));
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() == numFreeMsgs);
+
+	cxa_mqtt_client_disconnect(&cc->client);
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+
+	return true;
+}
+
+
+static bool check_client_fullWindowReconnect(void* userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+
+	cxa_fixedFifo_clear(&cc->rxFifo);
+	cc->failNextRead = false;
+
+	uint8_t connAck[] = { 0x20, 0x02, 0x00, CXA_MQTT_CONNACK_RETCODE_ACCEPTED };
+	cxa_bench_expect(cxa_mqtt_client_connect(&cc->client, NULL, NULL, 0));
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	cxa_bench_expect(cxa_fixedFifo_bulkQueue(&cc->rxFifo, connAck, sizeof(connAck)));
+	client_iterateUntilConnected(cc, true);
+	cxa_bench_expect(cxa_mqtt_client_isConnected(&cc->client));
+	size_t numFreeMsgs = cxa_mqtt_messageFactory_getNumFreeMessages();
+
+	// nobody acknowledges: fill the window
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		cxa_bench_expect(cxa_mqtt_client_publish(&cc->client, CXA_MQTT_QOS_ATLEAST_ONCE, false, CLIENT_TOPIC, "qos1", 4));
+	}
+	cxa_bench_expect(cxa_mqtt_client_getNumInFlight(&cc->client) == CXA_MQTT_CLIENT_MAXNUM_INFLIGHT);
+	cxa_bench_expect(!cxa_mqtt_client_publish(&cc->client, CXA_MQTT_QOS_ATLEAST_ONCE, false, CLIENT_TOPIC, "qos1", 4));
+
+	// control traffic still has a message
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() >= 1);
+	cxa_bench_expect(cxa_mqtt_client_publish(&cc->client, CXA_MQTT_QOS_ATMOST_ONCE, false, CLIENT_TOPIC, "qos0", 4));
+
+	// drop the connection...the window stays full
+	cc->failNextRead = true;
+	client_iterateUntilConnected(cc, false);
+	cxa_bench_expect(!cxa_mqtt_client_isConnected(&cc->client));
+	cxa_bench_expect(cxa_mqtt_client_getNumInFlight(&cc->client) == CXA_MQTT_CLIENT_MAXNUM_INFLIGHT);
+
+	// we can still reconnect...
+	cc->numConnectsSent = 0;
+	cc->numDupPublishesSent = 0;
+	cxa_bench_expect(cxa_mqtt_client_connect(&cc->client, NULL, NULL, 0));
+	cxa_bench_expect(cc->numConnectsSent == 1);
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	cxa_bench_expect(cxa_fixedFifo_bulkQueue(&cc->rxFifo, connAck, sizeof(connAck)));
+	client_iterateUntilConnected(cc, true);
+	cxa_bench_expect(cxa_mqtt_client_isConnected(&cc->client));
+
+	// ...and the whole window is retransmitted (as duplicates)
+	cxa_bench_expect(cc->numDupPublishesSent == CXA_MQTT_CLIENT_MAXNUM_INFLIGHT);
+
+	// which can now be acknowledged
+	for( size_t i = 0; i < cc->numDupPublishesSent; i++ )
+	{
+		uint8_t pubAck[] = { 0x40, 0x02, (uint8_t)(cc->dupPacketIds[i] >> 8), (uint8_t)cc->dupPacketIds[i] };
+		cxa_bench_expect(cxa_fixedFifo_bulkQueue(&cc->rxFifo, pubAck, sizeof(pubAck)));
+	}
+	for( size_t i = 0; (i < CLIENT_MAX_ITERATIONS) && (cxa_mqtt_client_getNumInFlight(&cc->client) > 0); i++ ) cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+	cxa_bench_expect(cxa_mqtt_client_getNumInFlight(&cc->client) == 0);
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() == numFreeMsgs);
+
+	cxa_mqtt_client_disconnect(&cc->client);
+	cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+
+	return true;
+}
+
+
+static bool check_client_subscribeLimits(void* userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+
+	size_t numSubscriptions = cxa_array_getSize_elems(&cc->client.subscriptions);
+	size_t numNodes = cc->client.subscriptionTrie.numNodes;
+	cxa_bench_expect(numSubscriptions < CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS);
+
+	// one level per trie node can never fit (the root takes a node)...refused, and nothing is left behind
+	char tooDeep[CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES];
+	tooDeep[0] = 0;
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES; i++ )
+	{
+		cxa_assert( cxa_stringUtils_concat(tooDeep, (i == 0) ? "x" : "/x", sizeof(tooDeep)) );
+	}
+	cxa_bench_expect(!cxa_mqtt_client_subscribe(&cc->client, tooDeep, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	cxa_bench_expect(cxa_array_getSize_elems(&cc->client.subscriptions) == numSubscriptions);
+	cxa_bench_expect(cc->client.subscriptionTrie.numNodes == numNodes);
+
+	// malformed and too-long filters are refused too
+	cxa_bench_expect(!cxa_mqtt_client_subscribe(&cc->client, "bench/re#", CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	char tooLong[CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES + 1];
+	memset(tooLong, 'x', sizeof(tooLong) - 1);
+	tooLong[sizeof(tooLong) - 1] = 0;
+	cxa_bench_expect(!cxa_mqtt_client_subscribe(&cc->client, tooLong, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	cxa_bench_expect(cxa_array_getSize_elems(&cc->client.subscriptions) == numSubscriptions);
+
+	// a realistically deep filter fits in the default trie (subscribing again is a no-op)...and matches
+	cxa_bench_expect(cxa_mqtt_client_subscribe(&cc->client, CLIENT_DEEP_FILTER, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	cxa_bench_expect(cxa_mqtt_client_subscribe(&cc->client, CLIENT_DEEP_FILTER, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	cxa_bench_expect(cxa_mqtt_topicTrie_match(&cc->client.subscriptionTrie, CLIENT_DEEP_TOPIC, strlen(CLIENT_DEEP_TOPIC), NULL, NULL) == 1);
+
+	// once the subscriptions are full, further subscribes are refused
+	for( size_t i = cxa_array_getSize_elems(&cc->client.subscriptions); i < CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS; i++ )
+	{
+		char filter[CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES];
+		snprintf(filter, sizeof(filter), "bench/%zu", i);
+		cxa_bench_expect(cxa_mqtt_client_subscribe(&cc->client, filter, CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+	}
+	cxa_bench_expect(cxa_array_getSize_elems(&cc->client.subscriptions) == CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS);
+	cxa_bench_expect(!cxa_mqtt_client_subscribe(&cc->client, "bench/other", CXA_MQTT_QOS_ATMOST_ONCE, cb_onPublish_hold, cc));
+
+	return true;
+}
+
+
+static bool encodeMessage(encodedType_t typeIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_fixedByteBuffer_clear(&msgFbb);
+	cxa_mqtt_message_initEmpty(msgIn, &msgFbb);
+
+	bool retVal = false;
+	switch( typeIn )
+	{
+		case ENC_CONNECT:
+			retVal = cxa_mqtt_message_connect_init(msgIn, "30:AE:A4:01:74:90", "user", (uint8_t*)"password", 8,
+												   CXA_MQTT_QOS_ATMOST_ONCE, false, "v1/^^/30:AE:A4:01:74:90/state", "{\"value_num\":0}", 15,
+												   true, 60);
+			break;
+
+		case ENC_CONNACK:
+			retVal = cxa_mqtt_message_connack_init(msgIn, false, CXA_MQTT_CONNACK_RETCODE_ACCEPTED);
+			break;
+
+		case ENC_PUBLISH_QOS0:
+			retVal = cxa_mqtt_message_publish_init(msgIn, false, CXA_MQTT_QOS_ATMOST_ONCE, false, PUBLISH_TOPIC, 0, publishPayload, sizeof(publishPayload));
+			break;
+
+		case ENC_PUBLISH_QOS1:
+			retVal = cxa_mqtt_message_publish_init(msgIn, false, CXA_MQTT_QOS_ATLEAST_ONCE, false, PUBLISH_TOPIC, 0x1234, publishPayload, sizeof(publishPayload));
+			break;
+
+		case ENC_PUBACK:
+			retVal = cxa_mqtt_message_puback_init(msgIn, 0x1234);
+			break;
+
+		case ENC_PUBREC:
+			retVal = cxa_mqtt_message_pubrec_init(msgIn, 0x1234);
+			break;
+
+		case ENC_PUBREL:
+			retVal = cxa_mqtt_message_pubrel_init(msgIn, 0x1234);
+			break;
+
+		case ENC_PUBCOMP:
+			retVal = cxa_mqtt_message_pubcomp_init(msgIn, 0x1234);
+			break;
+
+		case ENC_SUBSCRIBE:
+			retVal = cxa_mqtt_message_subscribe_init(msgIn, 0x1234, "v1/->/30:AE:A4:01:74:90/#", CXA_MQTT_QOS_ATMOST_ONCE);
+			break;
+
+		case ENC_SUBACK:
+			// already complete
+			return cxa_fixedByteBuffer_append(&msgFbb, (uint8_t*)subackBytes, sizeof(subackBytes));
+
+		case ENC_PINGREQ:
+			retVal = cxa_mqtt_message_pingRequest_init(msgIn);
+			break;
+
+		case ENC_PINGRESP:
+			retVal = cxa_mqtt_message_pingResponse_init(msgIn);
+			break;
+
+		default:
+			break;
+	}
+
+	// same as cxa_protocolParser_mqtt does before writing
+	return retVal && cxa_mqtt_message_updateVariableLengthField(msgIn);
+}
+
+
+static void bench_encode(size_t numItersIn, void* userVarIn)
+{
+	encodedType_t type = (encodedType_t)(uintptr_t)userVarIn;
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		bool success = encodeMessage(type, &msg);
+		cxa_bench_doNotOptimize(success);
+	}
+}
+
+
+static void bench_decode(size_t numItersIn, void* userVarIn)
+{
+	encodedMessage_t* enc = (encodedMessage_t*)userVarIn;
+	cxa_assert(enc);
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		// same steps as a message arriving via cxa_protocolParser_mqtt
+		cxa_fixedByteBuffer_clear(&msgFbb);
+		cxa_fixedByteBuffer_append(&msgFbb, enc->bytes, enc->numBytes);
+		cxa_mqtt_message_initEmpty(&msg, &msgFbb);
+		if( !cxa_mqtt_message_validateReceivedBytes(&msg) ) cxa_assert(false);
+
+		// and access the field(s) a receiver would use
+		if( cxa_mqtt_message_getType(&msg) == CXA_MQTT_MSGTYPE_PUBLISH )
+		{
+			char* topicName;
+			uint16_t topicNameLen_bytes;
+			cxa_linkedField_t* lf_payload;
+			cxa_mqtt_message_publish_getTopicName(&msg, &topicName, &topicNameLen_bytes);
+			cxa_mqtt_message_publish_getPayload(&msg, &lf_payload);
+			cxa_bench_doNotOptimize(topicName);
+			cxa_bench_doNotOptimize(lf_payload);
+		}
+	}
+}
+
+
+static void bench_topicTrie_match(size_t numItersIn, void* userVarIn)
+{
+	size_t numTopics = sizeof(trieTopics)/sizeof(*trieTopics);
+	size_t topicLens[sizeof(trieTopics)/sizeof(*trieTopics)];
+	for( size_t i = 0; i < numTopics; i++ ) topicLens[i] = strlen(trieTopics[i]);
+
+	size_t numMatches = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		size_t index = i % numTopics;
+		numMatches += cxa_mqtt_topicTrie_match(&trie, trieTopics[index], topicLens[index], cb_onTrieMatch, NULL);
+	}
+	cxa_bench_doNotOptimize(numMatches);
+}
+
+
+static void cb_onTrieMatch(void *const valueIn, void *const userVarIn)
+{
+	cxa_bench_doNotOptimize(valueIn);
+}
+
+
+static void client_iterateUntilReceived(clientCheck_t *const ccIn, size_t numReceivedIn)
+{
+	cxa_assert(ccIn);
+
+	for( size_t i = 0; (i < CLIENT_MAX_ITERATIONS) && (ccIn->numReceived < numReceivedIn); i++ ) cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+}
+
+
+static void client_iterateUntilConnected(clientCheck_t *const ccIn, bool isConnectedIn)
+{
+	cxa_assert(ccIn);
+
+	for( size_t i = 0; (i < CLIENT_MAX_ITERATIONS) && (cxa_mqtt_client_isConnected(&ccIn->client) != isConnectedIn); i++ ) cxa_runLoop_iterate(CLIENT_RUNLOOP_THREADID);
+}
+
+
+static bool client_feedPublish(clientCheck_t *const ccIn, char *const payloadIn)
+{
+	cxa_assert(ccIn);
+	cxa_assert(payloadIn);
+
+	cxa_fixedByteBuffer_clear(&msgFbb);
+	cxa_mqtt_message_initEmpty(&msg, &msgFbb);
+	return cxa_mqtt_message_publish_init(&msg, false, CXA_MQTT_QOS_ATMOST_ONCE, false, CLIENT_TOPIC, 0, payloadIn, strlen(payloadIn)) &&
+		   cxa_mqtt_message_updateVariableLengthField(&msg) &&
+		   cxa_fixedFifo_bulkQueue(&ccIn->rxFifo, cxa_fixedByteBuffer_get_pointerToIndex(&msgFbb, 0), cxa_fixedByteBuffer_getSize_bytes(&msgFbb));
+}
+
+
+static bool client_isPayload(cxa_mqtt_message_t *const msgIn, char *const payloadIn)
+{
+	cxa_linkedField_t* lf_payload;
+	if( (msgIn == NULL) || !cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) ) return false;
+
+	size_t payloadLen_bytes = strlen(payloadIn);
+	return (cxa_linkedField_getSize_bytes(lf_payload) == payloadLen_bytes) &&
+		   (memcmp(cxa_linkedField_get_pointerToIndex(lf_payload, 0), payloadIn, payloadLen_bytes) == 0);
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+
+	if( cc->failNextRead )
+	{
+		cc->failNextRead = false;
+		return CXA_IOSTREAM_READSTAT_ERROR;
+	}
+
+	return cxa_fixedFifo_dequeue(&cc->rxFifo, byteOut) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+	uint8_t* bytes = (uint8_t*)buffIn;
+	if( bufferSize_bytesIn < 2 ) return true;
+
+	if( (bytes[0] & 0xF0) == 0x10 ) cc->numConnectsSent++;
+
+	// PUBLISH | DUP | QOS1: fixed header, (single byte) remaining length, topic, packetId
+	if( (bytes[0] == 0x3A) && (bytes[1] < 0x80) && (cc->numDupPublishesSent < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT) )
+	{
+		size_t topicLen_bytes = ((size_t)bytes[2] << 8) | bytes[3];
+		size_t packetIdIndex = 4 + topicLen_bytes;
+		if( (packetIdIndex + 2) <= bufferSize_bytesIn )
+		{
+			cc->dupPacketIds[cc->numDupPublishesSent++] = ((uint16_t)bytes[packetIdIndex] << 8) | bytes[packetIdIndex + 1];
+		}
+	}
+
+	return true;
+}
+
+
+static void cb_onPublish_hold(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+							  char* topicNameIn, size_t topicNameLen_bytesIn, void* payloadIn, size_t payloadLen_bytesIn, void* userVarIn)
+{
+	clientCheck_t* cc = (clientCheck_t*)userVarIn;
+	cxa_assert(cc);
+
+	if( cc->numReceived >= CLIENT_MAXNUM_HELD ) return;
+
+	cxa_mqtt_messageFactory_incrementMessageRefCount(msgIn);
+	cc->held[cc->numReceived++] = msgIn;
+}
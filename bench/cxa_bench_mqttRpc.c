@@ -0,0 +1,308 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_mqtt_client.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_rpc_node_root.h>
+#include <cxa_runLoop.h>
+#include <cxa_timeDiff.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+// own thread so we don't also iterate the entries of other suites
+#define RUNLOOP_THREADID					7
+#define REMOTE_TIMEOUT_MS					60000
+
+// short timeouts for the deadline check, issued out of order (7 is coprime with the table size)
+#define SHORT_TIMEOUT_BASE_MS				20
+#define SHORT_TIMEOUT_STEP_MS				5
+#define SHORT_TIMEOUT_MS(i)					(SHORT_TIMEOUT_BASE_MS + ((((i) * 7) % CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS) * SHORT_TIMEOUT_STEP_MS))
+#define MAX_NUM_SPINS						1000
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_mqtt_rpc_methodRetVal_t lastRetVal;
+	uint8_t lastValue;
+	unsigned int numResponses;
+}responses_t;
+
+
+typedef struct
+{
+	uint32_t timeout_ms;
+	uint16_t requestId;
+}timedRequest_t;
+
+
+typedef struct
+{
+	timedRequest_t requests[CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS];
+
+	cxa_timeDiff_t td_start;
+	size_t numTimeouts;
+	bool wasOutOfOrder;
+	bool wasEarly;
+	bool wasNotTimeout;
+	uint32_t lastTimeout_ms;
+}timeoutCheck_t;
+
+
+// ******** local function prototypes ********
+static bool check_localRoundTrip(void* userVarIn);
+static bool check_responseMatching(void* userVarIn);
+static bool check_timeoutOrder(void* userVarIn);
+
+static void bench_localRoundTrip(size_t numItersIn, void* userVarIn);
+
+static bool injectResponse(const char *const topicIn, uint16_t requestIdIn);
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static cxa_mqtt_rpc_methodRetVal_t cb_method_increment(cxa_mqtt_rpc_node_t *const nodeIn, cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const responseParamsIn, void* userVarIn);
+static void cb_onResponse(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_methodRetVal_t retValIn, cxa_linkedField_t *const payloadIn, void* userVarIn);
+static void cb_onTimedResponse(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_methodRetVal_t retValIn, cxa_linkedField_t *const payloadIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static cxa_ioStream_t ios_offline;
+static cxa_mqtt_client_t mqttClient;
+static cxa_mqtt_rpc_node_root_t rootNode;
+static cxa_mqtt_rpc_node_t subNode;
+
+static responses_t responses;
+static timeoutCheck_t timeoutCheck;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_mqttRpc(void)
+{
+	// never connected: local requests don't need the broker
+	cxa_ioStream_init(&ios_offline);
+	cxa_ioStream_bind(&ios_offline, cb_ioStream_readByte, cb_ioStream_writeBytes, NULL);
+	cxa_mqtt_client_init(&mqttClient, &ios_offline, 0, "bench", RUNLOOP_THREADID);
+	cxa_mqtt_rpc_node_root_init(&rootNode, &mqttClient, false, "30:AE:A4:01:74:90");
+	cxa_mqtt_rpc_node_init_formattedString(&subNode, &rootNode.super, "sensor");
+	cxa_mqtt_rpc_node_addMethod(&subNode, "increment", cb_method_increment, NULL);
+	cxa_runLoop_iterate(RUNLOOP_THREADID);				// startup callbacks (state machines)
+
+	cxa_bench_check("mqttRpc/localRoundTrip", check_localRoundTrip, &responses);
+	cxa_bench_check("mqttRpc/responseMatching", check_responseMatching, &responses);
+	cxa_bench_check("mqttRpc/timeoutOrder", check_timeoutOrder, &timeoutCheck);
+
+	cxa_bench_run("mqttRpc/localRoundTrip", 100000, 0, bench_localRoundTrip, &responses);
+}
+
+
+// ******** local function implementations ********
+static bool check_localRoundTrip(void* userVarIn)
+{
+	responses_t* resp = (responses_t*)userVarIn;
+
+	uint8_t params_raw[1];
+	cxa_fixedByteBuffer_t params;
+	cxa_fixedByteBuffer_initStd(&params, params_raw);
+	cxa_fixedByteBuffer_append_uint8(&params, 41);
+
+	// local requests are answered before executeMethod returns
+	memset(resp, 0, sizeof(*resp));
+	size_t numFreeMsgs = cxa_mqtt_messageFactory_getNumFreeMessages();
+	cxa_bench_expect(cxa_mqtt_rpc_node_executeMethod(&subNode, "increment", "~/sensor", &params, cb_onResponse, resp));
+	cxa_bench_expect(resp->numResponses == 1);
+	cxa_bench_expect(resp->lastRetVal == CXA_MQTT_RPC_METHODRETVAL_SUCCESS);
+	cxa_bench_expect(resp->lastValue == 42);
+
+	cxa_bench_expect(cxa_mqtt_rpc_node_executeMethod(&subNode, "doesNotExist", "~/sensor", NULL, cb_onResponse, resp));
+	cxa_bench_expect(resp->numResponses == 2);
+	cxa_bench_expect(resp->lastRetVal == CXA_MQTT_RPC_METHODRETVAL_FAIL_METHOD_DNE);
+
+	// nothing leaked
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() == numFreeMsgs);
+
+	return true;
+}
+
+
+static bool check_responseMatching(void* userVarIn)
+{
+	responses_t* resp = (responses_t*)userVarIn;
+	memset(resp, 0, sizeof(*resp));
+
+	size_t numFreeMsgs = cxa_mqtt_messageFactory_getNumFreeMessages();
+
+	// a request to another device...never answered while we're offline
+	uint16_t requestId;
+	cxa_bench_expect(cxa_mqtt_rpc_node_executeMethod_withTimeout(&subNode, "getTemp", "/remote/thermostat", NULL,
+																REMOTE_TIMEOUT_MS, cb_onResponse, resp, &requestId));
+	cxa_bench_expect(resp->numResponses == 0);
+
+	// same id, but a different method or a different node: somebody else's response
+	cxa_bench_expect(!injectResponse("/remote/thermostat/<-getHumidity", requestId));
+	cxa_bench_expect(!injectResponse("/remote/thermostat/<-getTempX", requestId));
+	cxa_bench_expect(!injectResponse("/remote/other/<-getTemp", requestId));
+	cxa_bench_expect(!injectResponse("/remote/<-getTemp", requestId));
+	cxa_bench_expect(!injectResponse("~/remote/thermostat/<-getTemp", requestId));
+	cxa_bench_expect(resp->numResponses == 0);
+
+	// ours
+	cxa_bench_expect(injectResponse("/remote/thermostat/<-getTemp", requestId));
+	cxa_bench_expect(resp->numResponses == 1);
+	cxa_bench_expect(resp->lastRetVal == CXA_MQTT_RPC_METHODRETVAL_SUCCESS);
+
+	// and only once
+	cxa_bench_expect(!injectResponse("/remote/thermostat/<-getTemp", requestId));
+	cxa_bench_expect(!cxa_mqtt_rpc_node_cancelRequest(&subNode, requestId));
+	cxa_bench_expect(resp->numResponses == 1);
+
+	// unclaimed responses are dropped (without leaking a message)
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() == numFreeMsgs);
+
+	return true;
+}
+
+
+static bool check_timeoutOrder(void* userVarIn)
+{
+	timeoutCheck_t* tc = (timeoutCheck_t*)userVarIn;
+	memset(tc, 0, sizeof(*tc));
+	cxa_timeDiff_init(&tc->td_start);
+
+	size_t numFreeMsgs = cxa_mqtt_messageFactory_getNumFreeMessages();
+
+	// fill the table with remote requests whose deadlines don't follow the order they're sent in...
+	for( size_t i = 0; i < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS; i++ )
+	{
+		tc->requests[i].timeout_ms = SHORT_TIMEOUT_MS(i);
+		cxa_bench_expect(cxa_mqtt_rpc_node_executeMethod_withTimeout(&subNode, "getTemp", "/remote/thermostat", NULL,
+																	tc->requests[i].timeout_ms, cb_onTimedResponse, &tc->requests[i], &tc->requests[i].requestId));
+	}
+	cxa_bench_expect(!cxa_mqtt_rpc_node_executeMethod_withTimeout(&subNode, "getTemp", "/remote/thermostat", NULL,
+																 REMOTE_TIMEOUT_MS, cb_onTimedResponse, NULL, NULL));
+
+	// ...they still time out in deadline order, none early
+	for( int i = 0; (i < MAX_NUM_SPINS) && (tc->numTimeouts < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS); i++ )
+	{
+		cxa_runLoop_iterate(RUNLOOP_THREADID);
+		usleep(1000);
+	}
+	cxa_bench_expect(tc->numTimeouts == CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS);
+	cxa_bench_expect(!tc->wasOutOfOrder && !tc->wasEarly && !tc->wasNotTimeout);
+
+	// and the whole table is available again
+	for( size_t i = 0; i < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS; i++ )
+	{
+		cxa_bench_expect(cxa_mqtt_rpc_node_executeMethod_withTimeout(&subNode, "getTemp", "/remote/thermostat", NULL,
+																	REMOTE_TIMEOUT_MS, cb_onTimedResponse, &tc->requests[i], &tc->requests[i].requestId));
+	}
+	cxa_bench_expect(!cxa_mqtt_rpc_node_executeMethod_withTimeout(&subNode, "getTemp", "/remote/thermostat", NULL,
+																 REMOTE_TIMEOUT_MS, cb_onTimedResponse, NULL, NULL));
+	for( size_t i = 0; i < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS; i++ )
+	{
+		cxa_bench_expect(cxa_mqtt_rpc_node_cancelRequest(&subNode, tc->requests[i].requestId));
+	}
+
+	cxa_bench_expect(cxa_mqtt_messageFactory_getNumFreeMessages() == numFreeMsgs);
+
+	return true;
+}
+
+
+static void bench_localRoundTrip(size_t numItersIn, void* userVarIn)
+{
+	responses_t* resp = (responses_t*)userVarIn;
+
+	uint8_t params_raw[1];
+	cxa_fixedByteBuffer_t params;
+	cxa_fixedByteBuffer_initStd(&params, params_raw);
+	cxa_fixedByteBuffer_append_uint8(&params, 0);
+
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		if( !cxa_mqtt_rpc_node_executeMethod(&subNode, "increment", "~/sensor", &params, cb_onResponse, resp) ) cxa_assert(false);
+	}
+}
+
+
+static bool injectResponse(const char *const topicIn, uint16_t requestIdIn)
+{
+	// a successful response, as the responding node would send it (return value first)
+	char topic[CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES];
+	snprintf(topic, sizeof(topic), "%s/%04X", topicIn, requestIdIn);
+	uint8_t payload[] = { CXA_MQTT_RPC_METHODRETVAL_SUCCESS };
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_empty();
+	cxa_assert(msg);
+	cxa_assert(cxa_mqtt_message_publish_init(msg, false, CXA_MQTT_QOS_ATMOST_ONCE, false, topic, 0, payload, sizeof(payload)));
+
+	// local responses make their way down from the root
+	unsigned int prevNumResponses = responses.numResponses;
+	char* topicName;
+	uint16_t topicNameLen_bytes;
+	cxa_assert(cxa_mqtt_message_publish_getTopicName(msg, &topicName, &topicNameLen_bytes));
+	rootNode.super.scm_handleMessage_downstream(&rootNode.super, topicName, topicNameLen_bytes, msg);
+	cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+
+	return (responses.numResponses != prevNumResponses);
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	return CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	return true;
+}
+
+
+static cxa_mqtt_rpc_methodRetVal_t cb_method_increment(cxa_mqtt_rpc_node_t *const nodeIn, cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const responseParamsIn, void* userVarIn)
+{
+	uint8_t value;
+	if( !cxa_linkedField_get_uint8(paramsIn, 0, value) ) return CXA_MQTT_RPC_METHODRETVAL_FAIL_INVALIDPARAMS;
+
+	return cxa_linkedField_append_uint8(responseParamsIn, value + 1) ? CXA_MQTT_RPC_METHODRETVAL_SUCCESS : CXA_MQTT_RPC_METHODRETVAL_FAIL_INTERNAL;
+}
+
+
+static void cb_onResponse(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_methodRetVal_t retValIn, cxa_linkedField_t *const payloadIn, void* userVarIn)
+{
+	responses_t* resp = (responses_t*)userVarIn;
+
+	resp->numResponses++;
+	resp->lastRetVal = retValIn;
+	if( payloadIn != NULL ) cxa_linkedField_get_uint8(payloadIn, 0, resp->lastValue);
+}
+
+
+static void cb_onTimedResponse(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_methodRetVal_t retValIn, cxa_linkedField_t *const payloadIn, void* userVarIn)
+{
+	timedRequest_t* req = (timedRequest_t*)userVarIn;
+	cxa_assert(req);
+	timeoutCheck_t* tc = &timeoutCheck;
+
+	if( retValIn != CXA_MQTT_RPC_METHODRETVAL_FAIL_TIMEOUT ) tc->wasNotTimeout = true;
+	if( req->timeout_ms < tc->lastTimeout_ms ) tc->wasOutOfOrder = true;
+	if( cxa_timeDiff_getElapsedTime_ms(&tc->td_start) < req->timeout_ms ) tc->wasEarly = true;
+
+	tc->lastTimeout_ms = req->timeout_ms;
+	tc->numTimeouts++;
+}
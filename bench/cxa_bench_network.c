@@ -0,0 +1,245 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_network_factory.h>
+#include <cxa_posix_network_tcpClient.h>
+#include <cxa_posix_network_tcpServer.h>
+#include <cxa_posix_network_tcpServer_connectedClient.h>
+#include <cxa_posix_runLoop.h>
+#include <cxa_runLoop.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+// own thread so we don't also iterate the entries of other suites
+#define RUNLOOP_THREADID					6
+#define TICK_PERIOD_MS						10
+#define CONNECT_TIMEOUT_MS					1000
+#define MAX_NUM_SPINS						50
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_network_tcpServer_t* server;
+	cxa_network_tcpClient_t* client;
+	cxa_network_tcpServer_connectedClient_t* connectedClient;
+
+	unsigned int numConnects;
+	unsigned int numClientDisconnects;
+	unsigned int numServerConnects;
+	unsigned int numServerDisconnects;
+}loopback_t;
+
+
+// ******** local function prototypes ********
+static bool check_tcpLoopback(void* userVarIn);
+
+static void bench_readBytes_idle(size_t numItersIn, void* userVarIn);
+
+static void spin(int numItersIn);
+static bool spinUntil(unsigned int *const counterIn, unsigned int targetIn);
+static bool readAll(cxa_ioStream_t *const ioStreamIn, uint8_t *const buffIn, size_t numBytesIn);
+
+static void cb_tick(void* userVarIn);
+static void cb_client_onConnect(cxa_network_tcpClient_t *const clientIn, void* userVarIn);
+static void cb_client_onConnectFail(cxa_network_tcpClient_t *const clientIn, void* userVarIn);
+static void cb_client_onDisconnect(cxa_network_tcpClient_t *const clientIn, void* userVarIn);
+static void cb_server_onConnect(cxa_network_tcpServer_t *const serverIn, cxa_network_tcpServer_connectedClient_t* clientIn, void* userVarIn);
+static void cb_connectedClient_onDisconnect(cxa_network_tcpServer_connectedClient_t *const clientIn, void *userVarIn);
+
+
+// ********  local variable declarations *********
+static loopback_t loopback;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_network(void)
+{
+	// something has to be timed so that waiting for events can't block forever
+	cxa_runLoop_addTimedEntry(RUNLOOP_THREADID, TICK_PERIOD_MS, NULL, cb_tick, NULL);
+
+	memset(&loopback, 0, sizeof(loopback));
+	cxa_bench_check("network/tcpLoopback", check_tcpLoopback, &loopback);
+
+	// the loopback check leaves the client connected
+	if( (loopback.client != NULL) && cxa_network_tcpClient_isConnected(loopback.client) )
+	{
+		cxa_bench_run("network/tcpClient_readBytes_idle", 1000000, 0, bench_readBytes_idle, &loopback);
+		cxa_network_tcpClient_disconnect(loopback.client);
+		spin(2);
+	}
+}
+
+
+// ******** local function implementations ********
+static bool check_tcpLoopback(void* userVarIn)
+{
+	loopback_t* lb = (loopback_t*)userVarIn;
+	cxa_assert(lb);
+
+	lb->server = cxa_network_factory_reserveTcpServer(RUNLOOP_THREADID);
+	cxa_bench_expect(lb->server != NULL);
+	cxa_network_tcpServer_addListener(lb->server, cb_server_onConnect, lb);
+	cxa_bench_expect(cxa_network_tcpServer_listen(lb->server, 0));
+	uint16_t portNum = cxa_posix_network_tcpServer_getListeningPort((cxa_posix_network_tcpServer_t*)lb->server);
+	cxa_bench_expect(portNum != 0);
+
+	lb->client = cxa_network_factory_reserveTcpClient(RUNLOOP_THREADID);
+	cxa_bench_expect(lb->client != NULL);
+	cxa_network_tcpClient_addListener(lb->client, cb_client_onConnect, cb_client_onConnectFail, cb_client_onDisconnect, lb);
+	cxa_posix_network_tcpClient_t* posixClient = (cxa_posix_network_tcpClient_t*)lb->client;
+
+	cxa_bench_expect(cxa_network_tcpClient_connectToHost(lb->client, "127.0.0.1", portNum, false, CONNECT_TIMEOUT_MS));
+	cxa_bench_expect(spinUntil(&lb->numConnects, 1));
+	cxa_bench_expect(spinUntil(&lb->numServerConnects, 1));
+	cxa_bench_expect(lb->connectedClient != NULL);
+	cxa_posix_network_tcpServer_connectedClient_t* posixCc = (cxa_posix_network_tcpServer_connectedClient_t*)lb->connectedClient;
+
+	cxa_ioStream_t* ios_client = cxa_network_tcpClient_getIoStream(lb->client);
+	cxa_ioStream_t* ios_cc = cxa_network_tcpServer_connectedClient_getIoStream(lb->connectedClient);
+
+	// client -> server
+	uint8_t buff[32];
+	cxa_bench_expect(cxa_ioStream_writeString(ios_client, "hello world"));
+	cxa_bench_expect(readAll(ios_cc, buff, 11));
+	cxa_bench_expect(memcmp(buff, "hello world", 11) == 0);
+
+	// once drained, reads must not touch the socket until the runLoop says so
+	size_t numBytesRead = 0;
+	cxa_bench_expect(cxa_ioStream_readBytes(ios_cc, buff, sizeof(buff), &numBytesRead) == CXA_IOSTREAM_READSTAT_NODATA);
+	cxa_bench_expect(!posixCc->isReadable);
+
+	// server -> client (vectored)
+	cxa_ioStream_ioVec_t vecs[] = { {"ab", 2}, {"cdef", 4} };
+	cxa_bench_expect(cxa_ioStream_writeVectored(ios_cc, vecs, sizeof(vecs)/sizeof(*vecs)));
+	cxa_bench_expect(readAll(ios_client, buff, 6));
+	cxa_bench_expect(memcmp(buff, "abcdef", 6) == 0);
+	cxa_bench_expect(cxa_ioStream_readBytes(ios_client, buff, sizeof(buff), &numBytesRead) == CXA_IOSTREAM_READSTAT_NODATA);
+	cxa_bench_expect(!posixClient->isReadable);
+
+	// new data sets the flag again
+	cxa_bench_expect(cxa_ioStream_writeString(ios_cc, "x"));
+	for( int i = 0; (i < MAX_NUM_SPINS) && !posixClient->isReadable; i++ ) spin(1);
+	cxa_bench_expect(posixClient->isReadable);
+	cxa_bench_expect(readAll(ios_client, buff, 1));
+	cxa_bench_expect(buff[0] == 'x');
+
+	// server closes, client notices without reading
+	cxa_network_tcpServer_connectedClient_unbindAndClose(lb->connectedClient);
+	cxa_bench_expect(spinUntil(&lb->numClientDisconnects, 1));
+	cxa_bench_expect(!cxa_network_tcpClient_isConnected(lb->client));
+
+	// reconnect, client closes, server notices
+	cxa_bench_expect(cxa_network_tcpClient_connectToHost(lb->client, "127.0.0.1", portNum, false, CONNECT_TIMEOUT_MS));
+	cxa_bench_expect(spinUntil(&lb->numConnects, 2));
+	cxa_bench_expect(spinUntil(&lb->numServerConnects, 2));
+	unsigned int prevNumServerDisconnects = lb->numServerDisconnects;
+	cxa_network_tcpClient_disconnect(lb->client);
+	cxa_bench_expect(spinUntil(&lb->numServerDisconnects, prevNumServerDisconnects + 1));
+	cxa_bench_expect(!cxa_network_tcpServer_connectedClient_isBound(lb->connectedClient));
+
+	// leave a connection up for the benchmarks
+	cxa_bench_expect(cxa_network_tcpClient_connectToHost(lb->client, "127.0.0.1", portNum, false, CONNECT_TIMEOUT_MS));
+	cxa_bench_expect(spinUntil(&lb->numConnects, 3));
+	cxa_bench_expect(spinUntil(&lb->numServerConnects, 3));
+
+	return true;
+}
+
+
+static void bench_readBytes_idle(size_t numItersIn, void* userVarIn)
+{
+	loopback_t* lb = (loopback_t*)userVarIn;
+	cxa_ioStream_t* ios = cxa_network_tcpClient_getIoStream(lb->client);
+
+	uint8_t buff[16];
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		size_t numBytesRead = 0;
+		cxa_ioStream_readStatus_t rs = cxa_ioStream_readBytes(ios, buff, sizeof(buff), &numBytesRead);
+		cxa_bench_doNotOptimize(rs);
+	}
+}
+
+
+static void spin(int numItersIn)
+{
+	for( int i = 0; i < numItersIn; i++ )
+	{
+		cxa_runLoop_iterate(RUNLOOP_THREADID);
+		cxa_posix_runLoop_waitForEvents(RUNLOOP_THREADID);
+	}
+}
+
+
+static bool spinUntil(unsigned int *const counterIn, unsigned int targetIn)
+{
+	for( int i = 0; (i < MAX_NUM_SPINS) && (*counterIn < targetIn); i++ ) spin(1);
+	return (*counterIn >= targetIn);
+}
+
+
+static bool readAll(cxa_ioStream_t *const ioStreamIn, uint8_t *const buffIn, size_t numBytesIn)
+{
+	size_t numBytesSoFar = 0;
+	for( int i = 0; (i < MAX_NUM_SPINS) && (numBytesSoFar < numBytesIn); i++ )
+	{
+		spin(1);
+
+		size_t numBytesRead = 0;
+		if( cxa_ioStream_readBytes(ioStreamIn, &buffIn[numBytesSoFar], numBytesIn - numBytesSoFar, &numBytesRead) == CXA_IOSTREAM_READSTAT_ERROR ) return false;
+		numBytesSoFar += numBytesRead;
+	}
+	return (numBytesSoFar == numBytesIn);
+}
+
+
+static void cb_tick(void* userVarIn)
+{
+}
+
+
+static void cb_client_onConnect(cxa_network_tcpClient_t *const clientIn, void* userVarIn)
+{
+	((loopback_t*)userVarIn)->numConnects++;
+}
+
+
+static void cb_client_onConnectFail(cxa_network_tcpClient_t *const clientIn, void* userVarIn)
+{
+}
+
+
+static void cb_client_onDisconnect(cxa_network_tcpClient_t *const clientIn, void* userVarIn)
+{
+	((loopback_t*)userVarIn)->numClientDisconnects++;
+}
+
+
+static void cb_server_onConnect(cxa_network_tcpServer_t *const serverIn, cxa_network_tcpServer_connectedClient_t* clientIn, void* userVarIn)
+{
+	loopback_t* lb = (loopback_t*)userVarIn;
+
+	lb->numServerConnects++;
+	lb->connectedClient = clientIn;
+	cxa_network_tcpServer_connectedClient_addListener(clientIn, cb_connectedClient_onDisconnect, lb);
+}
+
+
+static void cb_connectedClient_onDisconnect(cxa_network_tcpServer_connectedClient_t *const clientIn, void *userVarIn)
+{
+	((loopback_t*)userVarIn)->numServerDisconnects++;
+}
@@ -0,0 +1,496 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_posix_nvsManager.h>
+
+
+// ******** local macro definitions ********
+#define NUM_KEYS						32
+#define KEY_SIZE_BYTES					16
+
+#define PEM_SIZE_BYTES					1700
+#define BLOB_SIZE_BYTES					6000
+#define LEGACY_BIG_SIZE_BYTES			(CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES + 808)
+#define LEGACY_LONG_KEY					"aKeyFromTheOldLayoutThatIsTooLongForTheLog"
+
+#define MAX_NUM_COMPACTION_COMMITS		20000
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool check_largeValues(void* userVarIn);
+static bool check_truncatedLog(void* userVarIn);
+static bool check_corruptedLog(void* userVarIn);
+static bool check_uncommittedBatch(void* userVarIn);
+static bool check_eraseAllReplay(void* userVarIn);
+static bool check_compactionConcurrentCommits(void* userVarIn);
+static bool check_legacyFiles(void* userVarIn);
+
+static void bench_get_uint32(size_t numItersIn, void* userVarIn);
+static void bench_set_uint32(size_t numItersIn, void* userVarIn);
+static void bench_setCommit(size_t numItersIn, void* userVarIn);
+
+static void openStore(const char *const nameIn);
+static void reopenStore(void);
+static size_t getLogSize_bytes(void);
+static bool hasUint32(const char *const keyIn, uint32_t expectedIn);
+static bool hasBlob(const char *const keyIn, const uint8_t *const expectedIn, size_t expectedSize_bytesIn);
+static void writeFile(const char *const nameIn, const void *const dataIn, size_t numBytesIn);
+static void fillPattern(uint8_t *const bufferIn, size_t numBytesIn, uint8_t seedIn);
+
+static void removeDir(const char *const pathIn);
+static void cleanup(void);
+
+
+// ********  local variable declarations *********
+static char keys[NUM_KEYS][KEY_SIZE_BYTES];
+
+// every store lives under a scratch directory which is removed on exit
+static char baseDir[] = "/tmp/cxa_bench_nvs_XXXXXX";
+static char storeDir[PATH_MAX];
+
+static uint8_t valueBuffer[LEGACY_BIG_SIZE_BYTES + 1];
+static uint8_t readBuffer[LEGACY_BIG_SIZE_BYTES + 1];
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_nvs(void)
+{
+	cxa_assert(mkdtemp(baseDir) != NULL);
+	atexit(cleanup);
+
+	cxa_bench_check("nvsManager/largeValues", check_largeValues, NULL);
+	cxa_bench_check("nvsManager/truncatedLog", check_truncatedLog, NULL);
+	cxa_bench_check("nvsManager/corruptedLog", check_corruptedLog, NULL);
+	cxa_bench_check("nvsManager/uncommittedBatchDiscarded", check_uncommittedBatch, NULL);
+	cxa_bench_check("nvsManager/eraseAllReplay", check_eraseAllReplay, NULL);
+	cxa_bench_check("nvsManager/compactionConcurrentCommits", check_compactionConcurrentCommits, NULL);
+	cxa_bench_check("nvsManager/legacyFiles", check_legacyFiles, NULL);
+
+	// the benchmarks start from an empty log
+	openStore("bench");
+	for( size_t i = 0; i < NUM_KEYS; i++ )
+	{
+		snprintf(keys[i], sizeof(keys[i]), "key_%d", (int)i);
+		cxa_assert(cxa_nvsManager_set_uint32(keys[i], (uint32_t)i));
+	}
+	cxa_assert(cxa_nvsManager_commit());
+
+	cxa_bench_run("nvsManager/get_uint32", 1000000, 0, bench_get_uint32, NULL);
+	cxa_bench_run("nvsManager/set_uint32", 200000, 0, bench_set_uint32, NULL);
+	cxa_bench_run("nvsManager/setCommit_uint32", 2000, 0, bench_setCommit, NULL);
+}
+
+
+// ******** local function implementations ********
+static bool check_largeValues(void* userVarIn)
+{
+	openStore("largeValues");
+
+	// a PEM private key (as stored by the mqtt connectionManager) and a larger blob
+	static char pem[PEM_SIZE_BYTES + 1];
+	for( size_t i = 0; i < PEM_SIZE_BYTES; i++ ) pem[i] = (char)('A' + (i % 26));
+	pem[PEM_SIZE_BYTES] = 0;
+	static uint8_t blob[BLOB_SIZE_BYTES];
+	fillPattern(blob, sizeof(blob), 1);
+
+	cxa_bench_expect(cxa_nvsManager_set_cString("clientKey", pem));
+	cxa_bench_expect(cxa_nvsManager_set_blob("blob", blob, sizeof(blob)));
+	cxa_bench_expect(cxa_nvsManager_commit());
+
+	// too large for a single value...refused, previous value untouched
+	cxa_bench_expect(!cxa_nvsManager_set_blob("blob", valueBuffer, CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES + 1));
+	cxa_bench_expect(hasBlob("blob", blob, sizeof(blob)));
+
+	// values that keep growing move to the end of the pool until it has to be compacted
+	size_t growSize_bytes = 0;
+	for( size_t i = 0; i < 64; i++ )
+	{
+		growSize_bytes = 100 + (i * 50);
+		fillPattern(valueBuffer, growSize_bytes, (uint8_t)i);
+		cxa_bench_expect(cxa_nvsManager_set_blob("grow", valueBuffer, growSize_bytes));
+		cxa_bench_expect(cxa_nvsManager_set_uint32("counter", (uint32_t)i));
+	}
+	cxa_bench_expect(cxa_nvsManager_commit());
+
+	// all values together are limited by the pool
+	size_t numBig = 0;
+	char bigKey[KEY_SIZE_BYTES];
+	fillPattern(valueBuffer, CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES, 0xA5);
+	for( ; numBig < (CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES / CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES); numBig++ )
+	{
+		snprintf(bigKey, sizeof(bigKey), "big_%d", (int)numBig);
+		if( !cxa_nvsManager_set_blob(bigKey, valueBuffer, CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES) ) break;
+	}
+	cxa_bench_expect(numBig < (CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES / CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES));
+	cxa_posix_nvsManager_stats_t stats;
+	cxa_posix_nvsManager_getStats(&stats);
+	cxa_bench_expect(stats.valuePool_numBytesUsed <= CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES);
+	for( size_t i = 0; i < numBig; i++ )
+	{
+		snprintf(bigKey, sizeof(bigKey), "big_%d", (int)i);
+		cxa_bench_expect(cxa_nvsManager_erase(bigKey));
+	}
+	cxa_bench_expect(cxa_nvsManager_commit());
+
+	// everything survives a restart
+	reopenStore();
+	static char pemOut[PEM_SIZE_BYTES + 1];
+	cxa_bench_expect(cxa_nvsManager_get_cString("clientKey", pemOut, sizeof(pemOut)));
+	cxa_bench_expect(strcmp(pemOut, pem) == 0);
+	cxa_bench_expect(!cxa_nvsManager_get_cString("clientKey", pemOut, PEM_SIZE_BYTES));
+	cxa_bench_expect(hasBlob("blob", blob, sizeof(blob)));
+	fillPattern(valueBuffer, growSize_bytes, 63);
+	cxa_bench_expect(hasBlob("grow", valueBuffer, growSize_bytes));
+	cxa_bench_expect(hasUint32("counter", 63));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("big_0"));
+
+	return true;
+}
+
+
+static bool check_truncatedLog(void* userVarIn)
+{
+	openStore("truncatedLog");
+
+	cxa_bench_expect(cxa_nvsManager_set_uint32("a", 1) && cxa_nvsManager_commit());
+	cxa_bench_expect(cxa_nvsManager_set_uint32("b", 2) && cxa_nvsManager_set_cString("c", "three") && cxa_nvsManager_commit());
+	size_t goodSize_bytes = getLogSize_bytes();
+	cxa_bench_expect(cxa_nvsManager_set_uint32("a", 10) && cxa_nvsManager_set_uint32("d", 4) && cxa_nvsManager_commit());
+
+	// power lost partway through writing the last batch
+	cxa_posix_nvsManager_deinit();
+	char logPath[PATH_MAX];
+	cxa_assert(snprintf(logPath, sizeof(logPath), "%s/%s", storeDir, CXA_POSIX_NVSMANAGER_LOG_FILENAME) < (int)sizeof(logPath));
+	cxa_bench_expect(truncate(logPath, (off_t)(goodSize_bytes + 5)) == 0);
+	cxa_posix_nvsManager_init(storeDir);
+
+	// the last batch is gone as a whole, the earlier ones are intact
+	cxa_bench_expect(hasUint32("a", 1));
+	cxa_bench_expect(hasUint32("b", 2));
+	char value[8];
+	cxa_bench_expect(cxa_nvsManager_get_cString("c", value, sizeof(value)) && (strcmp(value, "three") == 0));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("d"));
+
+	// the torn batch is cut off the file so new batches aren't stuck behind it
+	cxa_bench_expect(getLogSize_bytes() == goodSize_bytes);
+	cxa_bench_expect(cxa_nvsManager_set_uint32("d", 5) && cxa_nvsManager_commit());
+	reopenStore();
+	cxa_bench_expect(hasUint32("a", 1));
+	cxa_bench_expect(hasUint32("d", 5));
+
+	return true;
+}
+
+
+static bool check_corruptedLog(void* userVarIn)
+{
+	openStore("corruptedLog");
+
+	cxa_bench_expect(cxa_nvsManager_set_uint32("a", 1) && cxa_nvsManager_commit());
+	size_t firstBatchEnd_bytes = getLogSize_bytes();
+	cxa_bench_expect(cxa_nvsManager_set_uint32("b", 2) && cxa_nvsManager_commit());
+	cxa_bench_expect(cxa_nvsManager_set_uint32("c", 3) && cxa_nvsManager_commit());
+
+	// flip a bit in the value of b's record (header(4) + key(1) + value)
+	cxa_posix_nvsManager_deinit();
+	char logPath[PATH_MAX];
+	cxa_assert(snprintf(logPath, sizeof(logPath), "%s/%s", storeDir, CXA_POSIX_NVSMANAGER_LOG_FILENAME) < (int)sizeof(logPath));
+	FILE* logFile = fopen(logPath, "r+b");
+	cxa_assert(logFile);
+	uint8_t currByte;
+	cxa_assert((fseek(logFile, (long)(firstBatchEnd_bytes + 5), SEEK_SET) == 0) && (fread(&currByte, 1, 1, logFile) == 1));
+	currByte ^= 0x01;
+	cxa_assert((fseek(logFile, (long)(firstBatchEnd_bytes + 5), SEEK_SET) == 0) && (fwrite(&currByte, 1, 1, logFile) == 1));
+	fclose(logFile);
+	cxa_posix_nvsManager_init(storeDir);
+
+	// nothing after a damaged record can be trusted
+	cxa_bench_expect(hasUint32("a", 1));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("b"));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("c"));
+	cxa_bench_expect(getLogSize_bytes() == firstBatchEnd_bytes);
+
+	return true;
+}
+
+
+static bool check_uncommittedBatch(void* userVarIn)
+{
+	openStore("uncommittedBatch");
+
+	cxa_bench_expect(cxa_nvsManager_set_uint32("x", 1) && cxa_nvsManager_commit());
+	size_t committedSize_bytes = getLogSize_bytes();
+
+	// visible right away...
+	cxa_bench_expect(cxa_nvsManager_set_uint32("x", 2));
+	cxa_bench_expect(cxa_nvsManager_set_uint32("y", 5));
+	cxa_bench_expect(cxa_nvsManager_erase("x") && !cxa_nvsManager_doesKeyExist("x"));
+	cxa_bench_expect(cxa_nvsManager_set_uint32("x", 3));
+	cxa_bench_expect(hasUint32("x", 3) && hasUint32("y", 5));
+	cxa_bench_expect(getLogSize_bytes() == committedSize_bytes);
+
+	// ...but lost with the power
+	reopenStore();
+	cxa_bench_expect(hasUint32("x", 1));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("y"));
+
+	return true;
+}
+
+
+static bool check_eraseAllReplay(void* userVarIn)
+{
+	openStore("eraseAllReplay");
+
+	cxa_bench_expect(cxa_nvsManager_set_uint32("a", 1) && cxa_nvsManager_set_cString("b", "two") && cxa_nvsManager_commit());
+	cxa_bench_expect(cxa_nvsManager_eraseAll());
+	cxa_bench_expect(cxa_nvsManager_set_uint32("c", 3));
+	cxa_bench_expect(cxa_nvsManager_commit());
+	cxa_bench_expect(cxa_nvsManager_set_uint32("d", 4) && cxa_nvsManager_commit());
+
+	// replaying the log applies the eraseAll in order: before c, after a and b
+	reopenStore();
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("a"));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("b"));
+	cxa_bench_expect(hasUint32("c", 3));
+	cxa_bench_expect(hasUint32("d", 4));
+
+	// an eraseAll that was never committed doesn't happen
+	cxa_bench_expect(cxa_nvsManager_eraseAll() && !cxa_nvsManager_doesKeyExist("c"));
+	reopenStore();
+	cxa_bench_expect(hasUint32("c", 3));
+	cxa_bench_expect(hasUint32("d", 4));
+
+	return true;
+}
+
+
+static bool check_compactionConcurrentCommits(void* userVarIn)
+{
+	openStore("compaction");
+
+	static char compactKeys[NUM_KEYS][KEY_SIZE_BYTES];
+	uint32_t expectedValues[NUM_KEYS];
+	for( size_t i = 0; i < NUM_KEYS; i++ )
+	{
+		snprintf(compactKeys[i], sizeof(compactKeys[i]), "ckey_%d", (int)i);
+		expectedValues[i] = 0;
+		cxa_bench_expect(cxa_nvsManager_set_uint32(compactKeys[i], 0));
+	}
+	cxa_bench_expect(cxa_nvsManager_commit());
+
+	// keep committing while the log is rewritten underneath us, so that
+	// some batches have to be carried over to the compacted log
+	cxa_posix_nvsManager_stats_t stats;
+	for( size_t i = 1; i <= MAX_NUM_COMPACTION_COMMITS; i++ )
+	{
+		size_t keyIndex = (i * 7) % NUM_KEYS;
+		expectedValues[keyIndex] = (uint32_t)i;
+		cxa_bench_expect(cxa_nvsManager_set_uint32(compactKeys[keyIndex], (uint32_t)i) && cxa_nvsManager_commit());
+
+		cxa_posix_nvsManager_getStats(&stats);
+		if( (stats.numCompactions >= 2) && (stats.numTailBatches > 0) ) break;
+	}
+	cxa_bench_expect(stats.numCompactions >= 2);
+	cxa_bench_expect(stats.numTailBatches > 0);
+	cxa_bench_expect(stats.numCompactions_failed == 0);
+
+	for( size_t i = 0; i < NUM_KEYS; i++ ) cxa_bench_expect(hasUint32(compactKeys[i], expectedValues[i]));
+
+	// and the compacted log (with its carried over tail) holds every one of them
+	reopenStore();
+	cxa_posix_nvsManager_getStats(&stats);
+	cxa_bench_expect(stats.logSize_bytes < (2 * CXA_POSIX_NVSMANAGER_COMPACT_MIN_BYTES));
+	for( size_t i = 0; i < NUM_KEYS; i++ ) cxa_bench_expect(hasUint32(compactKeys[i], expectedValues[i]));
+
+	return true;
+}
+
+
+static bool check_legacyFiles(void* userVarIn)
+{
+	// files written by the old (file per key) implementation, before there was a log
+	cxa_assert(snprintf(storeDir, sizeof(storeDir), "%s/legacyFiles", baseDir) < (int)sizeof(storeDir));
+	cxa_assert(mkdir(storeDir, 0755) == 0);
+	static uint8_t bigCert[LEGACY_BIG_SIZE_BYTES];
+	fillPattern(bigCert, sizeof(bigCert), 7);
+	writeFile("wifiSsid", "home", 4);
+	writeFile("bigCert", bigCert, sizeof(bigCert));
+	writeFile(LEGACY_LONG_KEY, "x", 1);
+
+	for( int i = 0; i < 2; i++ )
+	{
+		// first time around the log is created (and small values imported), then it already exists
+		if( i == 0 ) openStore("legacyFiles");
+		else reopenStore();
+
+		char value[8];
+		cxa_bench_expect(cxa_nvsManager_get_cString("wifiSsid", value, sizeof(value)) && (strcmp(value, "home") == 0));
+
+		// couldn't be imported, but still readable
+		size_t actualSize_bytes = 0;
+		cxa_bench_expect(cxa_nvsManager_doesKeyExist("bigCert"));
+		cxa_bench_expect(cxa_nvsManager_get_blob("bigCert", readBuffer, sizeof(readBuffer), &actualSize_bytes));
+		cxa_bench_expect((actualSize_bytes == sizeof(bigCert)) && (memcmp(readBuffer, bigCert, sizeof(bigCert)) == 0));
+		cxa_bench_expect(!cxa_nvsManager_get_blob("bigCert", readBuffer, sizeof(bigCert) - 1, NULL));
+		cxa_bench_expect(cxa_nvsManager_get_cString(LEGACY_LONG_KEY, value, sizeof(value)) && (strcmp(value, "x") == 0));
+	}
+
+	// erasing a key also removes its old file, so it doesn't come back
+	cxa_bench_expect(cxa_nvsManager_erase("bigCert"));
+	cxa_bench_expect(cxa_nvsManager_erase("wifiSsid"));
+	cxa_bench_expect(cxa_nvsManager_commit());
+	reopenStore();
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("bigCert"));
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist("wifiSsid"));
+	cxa_bench_expect(cxa_nvsManager_doesKeyExist(LEGACY_LONG_KEY));
+
+	// as does erasing everything
+	cxa_bench_expect(cxa_nvsManager_eraseAll() && cxa_nvsManager_commit());
+	reopenStore();
+	cxa_bench_expect(!cxa_nvsManager_doesKeyExist(LEGACY_LONG_KEY));
+
+	return true;
+}
+
+
+static void bench_get_uint32(size_t numItersIn, void* userVarIn)
+{
+	uint32_t sum = 0;
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		uint32_t value;
+		if( cxa_nvsManager_get_uint32(keys[i % NUM_KEYS], &value) ) sum += value;
+	}
+	cxa_bench_doNotOptimize(sum);
+}
+
+
+static void bench_set_uint32(size_t numItersIn, void* userVarIn)
+{
+	// batched...only the implicit commits of a full batch buffer hit the disk
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_nvsManager_set_uint32(keys[i % NUM_KEYS], (uint32_t)i);
+	}
+	cxa_nvsManager_commit();
+}
+
+
+static void bench_setCommit(size_t numItersIn, void* userVarIn)
+{
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_nvsManager_set_uint32(keys[i % NUM_KEYS], (uint32_t)i);
+		cxa_nvsManager_commit();
+	}
+}
+
+
+static void openStore(const char *const nameIn)
+{
+	cxa_posix_nvsManager_deinit();
+
+	cxa_assert(snprintf(storeDir, sizeof(storeDir), "%s/%s", baseDir, nameIn) < (int)sizeof(storeDir));
+	struct stat dirStat;
+	if( stat(storeDir, &dirStat) != 0 ) cxa_assert(mkdir(storeDir, 0755) == 0);
+	cxa_posix_nvsManager_init(storeDir);
+}
+
+
+static void reopenStore(void)
+{
+	// anything uncommitted is lost, just like a power cycle
+	cxa_posix_nvsManager_deinit();
+	cxa_posix_nvsManager_init(storeDir);
+}
+
+
+static size_t getLogSize_bytes(void)
+{
+	cxa_posix_nvsManager_stats_t stats;
+	cxa_posix_nvsManager_getStats(&stats);
+	return stats.logSize_bytes;
+}
+
+
+static bool hasUint32(const char *const keyIn, uint32_t expectedIn)
+{
+	uint32_t value;
+	return cxa_nvsManager_get_uint32(keyIn, &value) && (value == expectedIn);
+}
+
+
+static bool hasBlob(const char *const keyIn, const uint8_t *const expectedIn, size_t expectedSize_bytesIn)
+{
+	size_t actualSize_bytes = 0;
+	return cxa_nvsManager_get_blob(keyIn, readBuffer, sizeof(readBuffer), &actualSize_bytes) &&
+		   (actualSize_bytes == expectedSize_bytesIn) && (memcmp(readBuffer, expectedIn, expectedSize_bytesIn) == 0);
+}
+
+
+static void writeFile(const char *const nameIn, const void *const dataIn, size_t numBytesIn)
+{
+	char filePath[PATH_MAX];
+	cxa_assert(snprintf(filePath, sizeof(filePath), "%s/%s", storeDir, nameIn) < (int)sizeof(filePath));
+
+	FILE* file = fopen(filePath, "wb");
+	cxa_assert(file);
+	cxa_assert(fwrite(dataIn, numBytesIn, 1, file) == 1);
+	fclose(file);
+}
+
+
+static void fillPattern(uint8_t *const bufferIn, size_t numBytesIn, uint8_t seedIn)
+{
+	for( size_t i = 0; i < numBytesIn; i++ ) bufferIn[i] = (uint8_t)((i * 31) + seedIn);
+}
+
+
+static void removeDir(const char *const pathIn)
+{
+	DIR* dir = opendir(pathIn);
+	if( dir == NULL ) return;
+
+	struct dirent* currEntry;
+	while( (currEntry = readdir(dir)) != NULL )
+	{
+		if( (strcmp(currEntry->d_name, ".") == 0) || (strcmp(currEntry->d_name, "..") == 0) ) continue;
+
+		char currPath[PATH_MAX];
+		if( snprintf(currPath, sizeof(currPath), "%s/%s", pathIn, currEntry->d_name) >= (int)sizeof(currPath) ) continue;
+		struct stat currStat;
+		if( lstat(currPath, &currStat) != 0 ) continue;
+
+		if( S_ISDIR(currStat.st_mode) ) removeDir(currPath);
+		else unlink(currPath);
+	}
+	closedir(dir);
+	rmdir(pathIn);
+}
+
+
+static void cleanup(void)
+{
+	cxa_posix_nvsManager_deinit();
+	removeDir(baseDir);
+}
@@ -0,0 +1,320 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_ioStream_loopback.h>
+#include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_protocolParser_cleProto.h>
+#include <cxa_protocolParser_crlf.h>
+#include <cxa_protocolParser_mqtt.h>
+#include <cxa_runLoop.h>
+
+
+// ******** local macro definitions ********
+#define PACKETS_PER_BATCH				8
+#define PAYLOAD_SIZE_BYTES				64
+#define RX_BUFFER_SIZE_BYTES			256
+#define MAX_ITERATIONS_PER_BATCH		(PACKETS_PER_BATCH * 64)
+
+// v2 frame: 0x80 0x81 len[2] payload crc[2] 0x82
+#define CLEPROTO_V2_HEADER_SIZE_BYTES	4
+#define CLEPROTO_V2_TRAILER_SIZE_BYTES	3
+
+// each parser gets its own runLoop thread so idle parsers don't skew the others
+#define THREADID_CRLF					1
+#define THREADID_CLEPROTO				2
+#define THREADID_MQTT					3
+#define THREADID_CLEPROTO_V2			4
+
+#define POOL_NUM_BUFFERS				3
+#define POOL_NUM_PACKETS				(POOL_NUM_BUFFERS + 1)
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_protocolParser_t* pp;
+	int threadId;
+
+	cxa_fixedByteBuffer_t* txPacket;
+	size_t numPacketsReceived;
+}parserBench_t;
+
+
+typedef struct
+{
+	cxa_protocolParser_cleProto_t pp;
+	cxa_ioStream_loopback_t loopback;
+	cxa_fixedByteBuffer_t rxFbbs[POOL_NUM_BUFFERS];
+	uint8_t rxFbbs_raw[POOL_NUM_BUFFERS][RX_BUFFER_SIZE_BYTES];
+
+	// every packet is retained until the check releases it
+	cxa_fixedByteBuffer_t* retained[POOL_NUM_PACKETS];
+	size_t numPacketsReceived;
+}rxPoolCheck_t;
+
+
+// ******** local function prototypes ********
+static bool check_iterationsPerPacket(void* userVarIn);
+static bool check_rxPool(void* userVarIn);
+static bool check_cleProtoV2_corruptedFrame(void* userVarIn);
+
+static void bench_parser(size_t numItersIn, void* userVarIn);
+
+static void cb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+static void cb_onPacketReceived_retain(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+static cxa_ioStream_loopback_t crlf_loopback;
+static cxa_protocolParser_crlf_t crlf_pp;
+static cxa_fixedByteBuffer_t crlf_rxFbb;
+static uint8_t crlf_rxFbb_raw[RX_BUFFER_SIZE_BYTES];
+static cxa_fixedByteBuffer_t crlf_txFbb;
+static uint8_t crlf_txFbb_raw[RX_BUFFER_SIZE_BYTES];
+
+static cxa_ioStream_loopback_t cle_loopback;
+static cxa_protocolParser_cleProto_t cle_pp;
+static cxa_fixedByteBuffer_t cle_rxFbb;
+static uint8_t cle_rxFbb_raw[RX_BUFFER_SIZE_BYTES];
+static cxa_fixedByteBuffer_t cle_txFbb;
+static uint8_t cle_txFbb_raw[RX_BUFFER_SIZE_BYTES];
+
+static cxa_ioStream_loopback_t cle2_loopback;
+static cxa_protocolParser_cleProto_t cle2_pp;
+static cxa_fixedByteBuffer_t cle2_rxFbb;
+static uint8_t cle2_rxFbb_raw[RX_BUFFER_SIZE_BYTES];
+
+static cxa_ioStream_loopback_t mqtt_loopback;
+static cxa_protocolParser_mqtt_t mqtt_pp;
+
+static parserBench_t benches[4];
+
+static rxPoolCheck_t rxPoolCheck;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_protocolParsers(void)
+{
+	uint8_t payload[PAYLOAD_SIZE_BYTES];
+	for( size_t i = 0; i < sizeof(payload); i++ ) payload[i] = (uint8_t)i;
+
+	// crlf: printable line (the terminator is added by the parser)
+	cxa_ioStream_loopback_init(&crlf_loopback);
+	cxa_fixedByteBuffer_initStd(&crlf_rxFbb, crlf_rxFbb_raw);
+	cxa_protocolParser_crlf_init(&crlf_pp, &crlf_loopback.super, &crlf_rxFbb, THREADID_CRLF);
+	cxa_fixedByteBuffer_initStd(&crlf_txFbb, crlf_txFbb_raw);
+	for( size_t i = 0; i < PAYLOAD_SIZE_BYTES; i++ ) cxa_fixedByteBuffer_append_uint8(&crlf_txFbb, (uint8_t)('A' + (i % 26)));
+	benches[0] = (parserBench_t){ .pp = &crlf_pp.super, .threadId = THREADID_CRLF, .txPacket = &crlf_txFbb };
+
+	// cleProto: binary payload
+	cxa_ioStream_loopback_init(&cle_loopback);
+	cxa_fixedByteBuffer_initStd(&cle_rxFbb, cle_rxFbb_raw);
+	cxa_protocolParser_cleProto_init(&cle_pp, &cle_loopback.super, &cle_rxFbb, THREADID_CLEPROTO);
+	cxa_fixedByteBuffer_initStd(&cle_txFbb, cle_txFbb_raw);
+	cxa_fixedByteBuffer_append(&cle_txFbb, payload, sizeof(payload));
+	benches[1] = (parserBench_t){ .pp = &cle_pp.super, .threadId = THREADID_CLEPROTO, .txPacket = &cle_txFbb };
+
+	// cleProto with crc framing: same payload
+	cxa_ioStream_loopback_init(&cle2_loopback);
+	cxa_fixedByteBuffer_initStd(&cle2_rxFbb, cle2_rxFbb_raw);
+	cxa_protocolParser_cleProto_init(&cle2_pp, &cle2_loopback.super, &cle2_rxFbb, THREADID_CLEPROTO_V2);
+	cxa_protocolParser_cleProto_setFraming(&cle2_pp, CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2);
+	benches[3] = (parserBench_t){ .pp = &cle2_pp.super, .threadId = THREADID_CLEPROTO_V2, .txPacket = &cle_txFbb };
+
+	// mqtt: the parser validates against the messageFactory so both buffers must come from it
+	cxa_mqtt_message_t* rxMsg = cxa_mqtt_messageFactory_getFreeMessage_empty();
+	cxa_mqtt_message_t* txMsg = cxa_mqtt_messageFactory_getFreeMessage_empty();
+	cxa_assert(rxMsg && txMsg);
+	cxa_assert( cxa_mqtt_message_publish_init(txMsg, false, CXA_MQTT_QOS_ATMOST_ONCE, false, "v1/->/30:AE:A4:01:74:90/streams/amb_temp/onUpdate", 0, payload, sizeof(payload)) );
+	cxa_ioStream_loopback_init(&mqtt_loopback);
+	cxa_protocolParser_mqtt_init(&mqtt_pp, &mqtt_loopback.super, rxMsg->buffer, THREADID_MQTT);
+	benches[2] = (parserBench_t){ .pp = &mqtt_pp.super, .threadId = THREADID_MQTT, .txPacket = txMsg->buffer };
+
+	// run the startup callbacks
+	for( size_t i = 0; i < sizeof(benches)/sizeof(*benches); i++ ) cxa_runLoop_iterate(benches[i].threadId);
+	cxa_protocolParser_crlf_resume(&crlf_pp);
+
+	for( size_t i = 0; i < sizeof(benches)/sizeof(*benches); i++ )
+	{
+		cxa_protocolParser_addPacketListener(benches[i].pp, cb_onPacketReceived, &benches[i]);
+	}
+
+	cxa_bench_check("protocolParser/crlf_onePacketPerIteration", check_iterationsPerPacket, &benches[0]);
+	cxa_bench_check("protocolParser/cleProto_onePacketPerIteration", check_iterationsPerPacket, &benches[1]);
+	cxa_bench_check("protocolParser/cleProto_v2_onePacketPerIteration", check_iterationsPerPacket, &benches[3]);
+	cxa_bench_check("protocolParser/mqtt_onePacketPerIteration", check_iterationsPerPacket, &benches[2]);
+	cxa_bench_check("protocolParser/cleProto_rxPool", check_rxPool, &rxPoolCheck);
+	cxa_bench_check("protocolParser/cleProto_v2_corruptedFrame", check_cleProtoV2_corruptedFrame, &benches[3]);
+
+	cxa_bench_run("protocolParser/crlf_rx_64", 100000, cxa_fixedByteBuffer_getSize_bytes(benches[0].txPacket), bench_parser, &benches[0]);
+	cxa_bench_run("protocolParser/cleProto_rx_64", 100000, cxa_fixedByteBuffer_getSize_bytes(benches[1].txPacket), bench_parser, &benches[1]);
+	cxa_bench_run("protocolParser/cleProto_v2_rx_64", 100000, cxa_fixedByteBuffer_getSize_bytes(benches[3].txPacket), bench_parser, &benches[3]);
+	cxa_bench_run("protocolParser/mqtt_rx_publish_64", 100000, cxa_fixedByteBuffer_getSize_bytes(benches[2].txPacket), bench_parser, &benches[2]);
+}
+
+
+// ******** local function implementations ********
+static bool check_iterationsPerPacket(void* userVarIn)
+{
+	parserBench_t* pb = (parserBench_t*)userVarIn;
+	cxa_assert(pb);
+
+	// settle into the packet loop first (leaving idle takes an extra iteration)
+	size_t expectedNumPackets = pb->numPacketsReceived + 1;
+	cxa_bench_expect(cxa_protocolParser_writePacket(pb->pp, pb->txPacket));
+	for( size_t i = 0; (i < MAX_ITERATIONS_PER_BATCH) && (pb->numPacketsReceived < expectedNumPackets); i++ ) cxa_runLoop_iterate(pb->threadId);
+	cxa_bench_expect(pb->numPacketsReceived == expectedNumPackets);
+
+	// a backlog of packets drains at exactly one packet per iteration
+	for( size_t i = 0; i < PACKETS_PER_BATCH; i++ ) cxa_bench_expect(cxa_protocolParser_writePacket(pb->pp, pb->txPacket));
+	for( size_t i = 0; i < PACKETS_PER_BATCH; i++ )
+	{
+		cxa_runLoop_iterate(pb->threadId);
+		cxa_bench_expect(pb->numPacketsReceived == (expectedNumPackets + i + 1));
+	}
+
+	return true;
+}
+
+
+static bool check_rxPool(void* userVarIn)
+{
+	rxPoolCheck_t* rpc = (rxPoolCheck_t*)userVarIn;
+	cxa_assert(rpc);
+
+	// the buffer given at init seeds the pool
+	cxa_ioStream_loopback_init(&rpc->loopback);
+	for( size_t i = 0; i < POOL_NUM_BUFFERS; i++ ) cxa_fixedByteBuffer_initStd(&rpc->rxFbbs[i], rpc->rxFbbs_raw[i]);
+	cxa_protocolParser_cleProto_init(&rpc->pp, &rpc->loopback.super, &rpc->rxFbbs[0], THREADID_CLEPROTO);
+	for( size_t i = 1; i < POOL_NUM_BUFFERS; i++ ) cxa_protocolParser_addRxBuffer(&rpc->pp.super, &rpc->rxFbbs[i]);
+	cxa_protocolParser_addPacketListener(&rpc->pp.super, cb_onPacketReceived_retain, rpc);
+
+	cxa_protocolParser_rxPoolStats_t stats;
+	cxa_protocolParser_getRxPoolStats(&rpc->pp.super, &stats);
+	cxa_bench_expect((stats.numBuffers == POOL_NUM_BUFFERS) && (stats.numFree == (POOL_NUM_BUFFERS - 1)) && (stats.numExhausted == 0));
+
+	// one more packet than buffers: the last one waits in the ioStream
+	for( uint8_t i = 0; i < POOL_NUM_PACKETS; i++ )
+	{
+		uint8_t payload[] = { i, 'p', 'o', 'o', 'l' };
+		cxa_bench_expect(cxa_protocolParser_writePacket_bytes(&rpc->pp.super, payload, sizeof(payload)));
+	}
+	for( size_t i = 0; i < MAX_ITERATIONS_PER_BATCH; i++ ) cxa_runLoop_iterate(THREADID_CLEPROTO);
+	cxa_bench_expect(rpc->numPacketsReceived == POOL_NUM_BUFFERS);
+	cxa_protocolParser_getRxPoolStats(&rpc->pp.super, &stats);
+	cxa_bench_expect((stats.numFree == 0) && (stats.minNumFree == 0) && (stats.numExhausted == 1));
+
+	// retained packets weren't overwritten
+	for( size_t i = 0; i < POOL_NUM_BUFFERS; i++ )
+	{
+		uint8_t seqNum;
+		cxa_bench_expect(cxa_fixedByteBuffer_get_uint8(rpc->retained[i], 0, seqNum) && (seqNum == i));
+	}
+
+	// releasing one resumes reception (into the released buffer)
+	cxa_protocolParser_releaseBuffer(&rpc->pp.super, rpc->retained[0]);
+	for( size_t i = 0; (i < MAX_ITERATIONS_PER_BATCH) && (rpc->numPacketsReceived < POOL_NUM_PACKETS); i++ ) cxa_runLoop_iterate(THREADID_CLEPROTO);
+	cxa_bench_expect(rpc->numPacketsReceived == POOL_NUM_PACKETS);
+	cxa_bench_expect(rpc->retained[POOL_NUM_BUFFERS] == rpc->retained[0]);
+	for( size_t i = 1; i < POOL_NUM_PACKETS; i++ )
+	{
+		uint8_t seqNum;
+		cxa_bench_expect(cxa_fixedByteBuffer_get_uint8(rpc->retained[i], 0, seqNum) && (seqNum == i));
+	}
+
+	for( size_t i = 1; i < POOL_NUM_PACKETS; i++ ) cxa_protocolParser_releaseBuffer(&rpc->pp.super, rpc->retained[i]);
+	cxa_protocolParser_getRxPoolStats(&rpc->pp.super, &stats);
+	cxa_bench_expect((stats.numFree == (POOL_NUM_BUFFERS - 1)) && (stats.numExhausted == 2));
+
+	return true;
+}
+
+
+static bool check_cleProtoV2_corruptedFrame(void* userVarIn)
+{
+	parserBench_t* pb = (parserBench_t*)userVarIn;
+	cxa_assert(pb);
+
+	// grab a good frame off the wire
+	uint8_t frame[RX_BUFFER_SIZE_BYTES];
+	size_t frameSize_bytes = 0;
+	cxa_bench_expect(cxa_protocolParser_writePacket(pb->pp, pb->txPacket));
+	cxa_bench_expect(cxa_ioStream_readBytes(pb->pp->ioStream, frame, sizeof(frame), &frameSize_bytes) == CXA_IOSTREAM_READSTAT_GOTDATA);
+	cxa_bench_expect(frameSize_bytes == (CLEPROTO_V2_HEADER_SIZE_BYTES + cxa_fixedByteBuffer_getSize_bytes(pb->txPacket) + CLEPROTO_V2_TRAILER_SIZE_BYTES));
+
+	// one bit flipped in the payload, then in the crc itself
+	size_t corruptIndices[] = { CLEPROTO_V2_HEADER_SIZE_BYTES + 10, frameSize_bytes - CLEPROTO_V2_TRAILER_SIZE_BYTES };
+	for( size_t i = 0; i < sizeof(corruptIndices)/sizeof(*corruptIndices); i++ )
+	{
+		size_t prevNumPackets = pb->numPacketsReceived;
+
+		frame[corruptIndices[i]] ^= 0x01;
+		cxa_bench_expect(cxa_ioStream_writeBytes(pb->pp->ioStream, frame, frameSize_bytes));
+		frame[corruptIndices[i]] ^= 0x01;
+		for( size_t j = 0; j < MAX_ITERATIONS_PER_BATCH; j++ ) cxa_runLoop_iterate(pb->threadId);
+		cxa_bench_expect(pb->numPacketsReceived == prevNumPackets);
+
+		// ...and the parser has resynchronized for the next good one
+		cxa_bench_expect(cxa_ioStream_writeBytes(pb->pp->ioStream, frame, frameSize_bytes));
+		for( size_t j = 0; (j < MAX_ITERATIONS_PER_BATCH) && (pb->numPacketsReceived == prevNumPackets); j++ ) cxa_runLoop_iterate(pb->threadId);
+		cxa_bench_expect(pb->numPacketsReceived == (prevNumPackets + 1));
+	}
+
+	return true;
+}
+
+
+static void bench_parser(size_t numItersIn, void* userVarIn)
+{
+	parserBench_t* pb = (parserBench_t*)userVarIn;
+	cxa_assert(pb);
+
+	for( size_t i = 0; i < numItersIn; i += PACKETS_PER_BATCH )
+	{
+		size_t numInBatch = ((numItersIn - i) < PACKETS_PER_BATCH) ? (numItersIn - i) : PACKETS_PER_BATCH;
+		size_t expectedNumPackets = pb->numPacketsReceived + numInBatch;
+
+		// frame and write into the loopback...
+		for( size_t j = 0; j < numInBatch; j++ )
+		{
+			if( !cxa_protocolParser_writePacket(pb->pp, pb->txPacket) ) cxa_assert(false);
+		}
+
+		// ...then let the parser pull them back out
+		for( size_t j = 0; pb->numPacketsReceived < expectedNumPackets; j++ )
+		{
+			cxa_assert_msg((j < MAX_ITERATIONS_PER_BATCH), "parser stalled");
+			cxa_runLoop_iterate(pb->threadId);
+		}
+	}
+}
+
+
+static void cb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
+{
+	parserBench_t* pb = (parserBench_t*)userVarIn;
+	cxa_assert(pb);
+
+	pb->numPacketsReceived++;
+}
+
+
+static void cb_onPacketReceived_retain(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
+{
+	rxPoolCheck_t* rpc = (rxPoolCheck_t*)userVarIn;
+	cxa_assert(rpc);
+
+	if( rpc->numPacketsReceived >= POOL_NUM_PACKETS ) return;
+	if( cxa_protocolParser_retainBuffer(&rpc->pp.super, packetIn) ) rpc->retained[rpc->numPacketsReceived++] = packetIn;
+}
@@ -0,0 +1,325 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_bench.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_posix_runLoop.h>
+#include <cxa_runLoop.h>
+#include <cxa_stateMachine.h>
+#include <cxa_timeBase.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define RUNLOOP_THREADID					0
+// own thread so nothing else keeps it polling
+#define IDLE_RUNLOOP_THREADID				9
+#define IDLE_MAX_HOP_TIME_MS				20
+#define IDLE_MAX_WAIT_MS					2000
+#define TRACE_MAXLEN_BYTES					128
+
+// states CHAIN_FIRST..(CHAIN_LAST-1) transition to the next one from their state callback
+#define CHAIN_FIRST							10
+#define CHAIN_LAST							13
+#define STATE_OTHER							5
+#define STATE_POLLED						6
+
+#define EVENT_GO							7
+#define EVENT_GUARDED						8
+#define EVENT_UNKNOWN						99
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_stateMachine_t sm;
+	char trace[TRACE_MAXLEN_BYTES];
+	bool isGuardOpen;
+}smCheck_t;
+
+
+// ******** local function prototypes ********
+static bool check_chaining(void* userVarIn);
+static bool check_outOfOrderIds(void* userVarIn);
+static bool check_events(void* userVarIn);
+static bool check_idleHops(void* userVarIn);
+
+static void bench_transition(size_t numItersIn, void* userVarIn);
+
+static void addState(smCheck_t *const smcIn, int idIn);
+static void iterate(smCheck_t *const smcIn);
+static uint32_t executeUntilState(smCheck_t *const smcIn, int stateIdIn);
+static void appendTrace(smCheck_t *const smcIn, char typeIn, int idIn);
+
+static void stateCb_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void* userVarIn);
+static void stateCb_state(cxa_stateMachine_t *const smIn, void *userVarIn);
+static bool guardCb(cxa_stateMachine_t *const smIn, int eventIdIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static smCheck_t smc_chaining;
+static smCheck_t smc_outOfOrder;
+static smCheck_t smc_events;
+static smCheck_t smc_idle;
+
+
+// ******** global function implementations ********
+void cxa_bench_suite_stateMachine(void)
+{
+	cxa_bench_check("stateMachine/runToCompletion_chaining", check_chaining, &smc_chaining);
+	cxa_bench_check("stateMachine/outOfOrderIds", check_outOfOrderIds, &smc_outOfOrder);
+	cxa_bench_check("stateMachine/eventGuardsWildcards", check_events, &smc_events);
+	cxa_bench_check("stateMachine/idleThreadHops", check_idleHops, &smc_idle);
+
+	// the chaining machine is left with run-to-completion on
+	cxa_bench_run("stateMachine/transition_runToCompletion", 200000, 0, bench_transition, &smc_chaining);
+}
+
+
+// ******** local function implementations ********
+static bool check_chaining(void* userVarIn)
+{
+	smCheck_t* smc = (smCheck_t*)userVarIn;
+
+	cxa_stateMachine_init(&smc->sm, "chain", RUNLOOP_THREADID);
+	for( int i = CHAIN_FIRST; i <= CHAIN_LAST; i++ ) addState(smc, i);
+	cxa_stateMachine_setInitialState(&smc->sm, CHAIN_FIRST);
+
+	// classic: one transition _or_ one state update per iteration
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E10 ") == 0);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "S10 ") == 0);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E11 ") == 0);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 11);
+
+	// run-to-completion: chained transitions happen immediately (within the bound)
+	cxa_stateMachine_transition(&smc->sm, CHAIN_FIRST);
+	cxa_stateMachine_setRunToCompletion(&smc->sm, 2);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E10 S10 E11 S11 ") == 0);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E12 S12 E13 S13 ") == 0);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "S13 ") == 0);
+
+	cxa_stateMachine_transition(&smc->sm, CHAIN_FIRST);
+	cxa_stateMachine_setRunToCompletion(&smc->sm, 10);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E10 S10 E11 S11 E12 S12 E13 S13 ") == 0);
+
+	// transitionNow only performs the requested transition
+	cxa_stateMachine_transitionNow(&smc->sm, CHAIN_FIRST);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == CHAIN_FIRST);
+	iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == CHAIN_LAST);
+
+	return true;
+}
+
+
+static bool check_outOfOrderIds(void* userVarIn)
+{
+	smCheck_t* smc = (smCheck_t*)userVarIn;
+
+	// ids don't match the order in which the states were added
+	static const int ids[] = {13, CHAIN_FIRST, 12, 11, STATE_OTHER};
+	cxa_stateMachine_init(&smc->sm, "ooo", RUNLOOP_THREADID);
+	for( size_t i = 0; i < sizeof(ids)/sizeof(*ids); i++ ) addState(smc, ids[i]);
+	cxa_stateMachine_setInitialState(&smc->sm, CHAIN_FIRST);
+	cxa_stateMachine_setRunToCompletion(&smc->sm, 10);
+
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E10 S10 E11 S11 E12 S12 E13 S13 ") == 0);
+
+	cxa_stateMachine_transition(&smc->sm, STATE_OTHER);
+	iterate(smc);
+	cxa_bench_expect(strcmp(smc->trace, "E5 S5 ") == 0);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == STATE_OTHER);
+
+	return true;
+}
+
+
+static bool check_events(void* userVarIn)
+{
+	smCheck_t* smc = (smCheck_t*)userVarIn;
+
+	cxa_stateMachine_init(&smc->sm, "events", RUNLOOP_THREADID);
+	for( int i = 0; i < 4; i++ ) addState(smc, i);
+	cxa_stateMachine_setInitialState(&smc->sm, 0);
+	cxa_stateMachine_addEventTransition(&smc->sm, 0, EVENT_GO, 1, NULL, NULL);
+	cxa_stateMachine_addEventTransition(&smc->sm, CXA_STATE_MACHINE_STATE_UNKNOWN, EVENT_GUARDED, 2, guardCb, smc);
+	cxa_stateMachine_addEventTransition(&smc->sm, CXA_STATE_MACHINE_STATE_UNKNOWN, EVENT_GUARDED, 3, NULL, NULL);
+	iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 0);
+
+	// guard closed: falls through to the next (wildcard) transition, EVENT_GO no longer applies
+	smc->isGuardOpen = false;
+	cxa_bench_expect(cxa_stateMachine_postEvent(&smc->sm, EVENT_GUARDED));
+	cxa_bench_expect(cxa_stateMachine_postEvent(&smc->sm, EVENT_GO));
+	iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 3);
+	iterate(smc);
+	iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 3);
+
+	// guard open
+	smc->isGuardOpen = true;
+	cxa_bench_expect(cxa_stateMachine_postEvent(&smc->sm, EVENT_GUARDED));
+	iterate(smc);
+	iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 2);
+
+	// bounded queue
+	size_t numQueued = 0;
+	while( cxa_stateMachine_postEvent(&smc->sm, EVENT_UNKNOWN) ) numQueued++;
+	cxa_bench_expect(numQueued == CXA_STATE_MACHINE_EVENT_QUEUE_SIZE);
+	for( int i = 0; i <= CXA_STATE_MACHINE_EVENT_QUEUE_SIZE; i++ ) iterate(smc);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == 2);
+
+	return true;
+}
+
+
+static bool check_idleHops(void* userVarIn)
+{
+	smCheck_t* smc = (smCheck_t*)userVarIn;
+
+	// one transition per iteration, the last state has nothing to poll
+	cxa_stateMachine_init(&smc->sm, "idle", IDLE_RUNLOOP_THREADID);
+	for( int i = CHAIN_FIRST; i < CHAIN_LAST; i++ ) addState(smc, i);
+	cxa_stateMachine_addState(&smc->sm, CHAIN_LAST, "s", stateCb_enter, NULL, NULL, (void*)smc);
+	cxa_stateMachine_addState(&smc->sm, STATE_OTHER, "s", stateCb_enter, NULL, NULL, (void*)smc);
+	addState(smc, STATE_POLLED);
+	cxa_stateMachine_addEventTransition(&smc->sm, CHAIN_LAST, EVENT_GO, CHAIN_FIRST, NULL, NULL);
+	cxa_stateMachine_setInitialState(&smc->sm, STATE_OTHER);
+	executeUntilState(smc, STATE_OTHER);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == STATE_OTHER);
+	cxa_bench_expect(cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_IDLE);
+
+	// every hop is pending work, so the thread never sleeps in between
+	cxa_stateMachine_transition(&smc->sm, CHAIN_FIRST);
+	uint32_t elapsed_ms = executeUntilState(smc, CHAIN_LAST);
+	cxa_bench_expect(cxa_stateMachine_getCurrentState(&smc->sm) == CHAIN_LAST);
+	cxa_bench_expect(elapsed_ms < IDLE_MAX_HOP_TIME_MS);
+	cxa_bench_expect(cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_IDLE);
+
+	// neither does a posted event
+	cxa_bench_expect(cxa_stateMachine_postEvent(&smc->sm, EVENT_GO));
+	cxa_bench_expect(cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_PENDINGWORK);
+	elapsed_ms = executeUntilState(smc, CHAIN_FIRST);
+	cxa_bench_expect(elapsed_ms < IDLE_MAX_HOP_TIME_MS);
+	elapsed_ms = executeUntilState(smc, CHAIN_LAST);
+	cxa_bench_expect(elapsed_ms < IDLE_MAX_HOP_TIME_MS);
+
+	// states with a state callback are updated right after entering, then polled
+	cxa_stateMachine_transition(&smc->sm, STATE_POLLED);
+	smc->trace[0] = 0;
+	cxa_runLoop_iterate(IDLE_RUNLOOP_THREADID);
+	cxa_bench_expect(strcmp(smc->trace, "E6 ") == 0);
+	cxa_bench_expect(cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_PENDINGWORK);
+	cxa_runLoop_iterate(IDLE_RUNLOOP_THREADID);
+	cxa_bench_expect(strcmp(smc->trace, "E6 S6 ") == 0);
+	cxa_bench_expect(cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_MUSTPOLL);
+
+	return true;
+}
+
+
+static void bench_transition(size_t numItersIn, void* userVarIn)
+{
+	smCheck_t* smc = (smCheck_t*)userVarIn;
+
+	// one request walks the whole chain in a single iteration
+	for( size_t i = 0; i < numItersIn; i++ )
+	{
+		cxa_stateMachine_transition(&smc->sm, CHAIN_FIRST);
+		cxa_runLoop_iterate(RUNLOOP_THREADID);
+	}
+}
+
+
+static void addState(smCheck_t *const smcIn, int idIn)
+{
+	cxa_assert(smcIn);
+	cxa_assert((idIn >= 0) && (idIn < CXA_STATE_MACHINE_MAXNUM_STATES));
+
+	cxa_stateMachine_addState(&smcIn->sm, idIn, "s", stateCb_enter, stateCb_state, NULL, (void*)smcIn);
+}
+
+
+static void iterate(smCheck_t *const smcIn)
+{
+	cxa_assert(smcIn);
+
+	smcIn->trace[0] = 0;
+	cxa_runLoop_iterate(RUNLOOP_THREADID);
+}
+
+
+static uint32_t executeUntilState(smCheck_t *const smcIn, int stateIdIn)
+{
+	cxa_assert(smcIn);
+
+	// what cxa_runLoop_execute does (sleeping whenever the thread is idle)
+	uint64_t startTime_us = cxa_timeBase_getCount64_us();
+	uint32_t elapsed_ms = 0;
+	while( elapsed_ms < IDLE_MAX_WAIT_MS )
+	{
+		cxa_runLoop_iterate(IDLE_RUNLOOP_THREADID);
+		if( cxa_stateMachine_getCurrentState(&smcIn->sm) == stateIdIn ) break;
+
+		// nothing would ever wake us
+		if( (cxa_runLoop_getUntimedState(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_UNTIMED_IDLE) &&
+			(cxa_runLoop_getTimeToNextDeadline_ms(IDLE_RUNLOOP_THREADID) == CXA_RUNLOOP_NO_DEADLINE) ) break;
+		cxa_posix_runLoop_waitForEvents(IDLE_RUNLOOP_THREADID);
+
+		elapsed_ms = (uint32_t)((cxa_timeBase_getCount64_us() - startTime_us) / 1000);
+	}
+
+	return (uint32_t)((cxa_timeBase_getCount64_us() - startTime_us) / 1000);
+}
+
+
+static void appendTrace(smCheck_t *const smcIn, char typeIn, int idIn)
+{
+	cxa_assert(smcIn);
+
+	// stop once full (the benchmark never clears it)
+	size_t currLen_bytes = strlen(smcIn->trace);
+	if( (currLen_bytes + 8) > sizeof(smcIn->trace) ) return;
+	snprintf(&smcIn->trace[currLen_bytes], sizeof(smcIn->trace) - currLen_bytes, "%c%d ", typeIn, idIn);
+}
+
+
+static void stateCb_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void* userVarIn)
+{
+	appendTrace((smCheck_t*)userVarIn, 'E', cxa_stateMachine_getCurrentState(smIn));
+}
+
+
+static void stateCb_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	int currState = cxa_stateMachine_getCurrentState(smIn);
+	appendTrace((smCheck_t*)userVarIn, 'S', currState);
+
+	if( (currState >= CHAIN_FIRST) && (currState < CHAIN_LAST) ) cxa_stateMachine_transition(smIn, currState + 1);
+}
+
+
+static bool guardCb(cxa_stateMachine_t *const smIn, int eventIdIn, void* userVarIn)
+{
+	return ((smCheck_t*)userVarIn)->isGuardOpen;
+}
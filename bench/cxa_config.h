@@ -0,0 +1,24 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_CONFIG_H_
+#define CXA_CONFIG_H_
+
+
+/**
+ * @file
+ * Library configuration for the host-side benchmarks. Sizing options that
+ * the benchmarks depend on are set in bench/CMakeLists.txt so they are
+ * visible next to the sources they apply to.
+ */
+
+
+// ******** global macro definitions ********
+#define CXA_ASSERT_LINE_NUM_ENABLE
+#define CXA_ASSERT_MSG_ENABLE
+
+
+#endif
@@ -18,6 +18,11 @@
  * maximum value of the counter into account. It is not possible to judge elapsed time
  * beyond the range returned by ::cxa_timeBase_getMaxCount_us.
  *
+ * The 64-bit counts (::cxa_timeBase_getCount64_us, ::cxa_timeBase_getCount64_ns) do not
+ * overflow during the lifetime of the device and are not affected by changes to the
+ * wall-clock time. Prefer these for new code. Architectures without a native 64-bit
+ * counter implement them using ::cxa_timeBase_extendCount64_us.
+ *
  * @note This file contains the base functionality for a timeBase object available across all architectures. Additional
  *		functionality, including initialization is available in the architecture-specific implementation.
  *
@@ -68,4 +73,40 @@ uint32_t cxa_timeBase_getCount_us(void);
 uint32_t cxa_timeBase_getMaxCount_us(void);
 
 
+/**
+ * @public
+ * @brief Returns the current monotonic, relative time in microseconds.
+ * Unlike ::cxa_timeBase_getCount_us, this value will not overflow.
+ *
+ * @return the current time of the timeBase, in microseconds
+ */
+uint64_t cxa_timeBase_getCount64_us(void);
+
+
+/**
+ * @public
+ * @brief Same as ::cxa_timeBase_getCount64_us, but in nanoseconds.
+ *
+ * @note the resolution of the returned value depends on the underlying
+ * 		timing mechanism (it may only change once per microsecond or less)
+ *
+ * @return the current time of the timeBase, in nanoseconds
+ */
+uint64_t cxa_timeBase_getCount64_ns(void);
+
+
+/**
+ * @protected
+ * @brief Extends ::cxa_timeBase_getCount_us to 64 bits by accumulating the
+ * time elapsed since the previous call. For use by architectures that only
+ * have a limited-range counter.
+ *
+ * @note must be called at least once per ::cxa_timeBase_getMaxCount_us
+ * 		(the runLoop does this every iteration)
+ *
+ * @return the current time of the timeBase, in microseconds
+ */
+uint64_t cxa_timeBase_extendCount64_us(void);
+
+
 #endif // CXA_TIMEBASE_H_
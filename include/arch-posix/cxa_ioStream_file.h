@@ -37,5 +37,6 @@ struct cxa_ioStream_file
 void cxa_ioStream_file_init(cxa_ioStream_file_t *const ioStreamIn);
 void cxa_ioStream_file_setFile(cxa_ioStream_file_t *const ioStreamIn, FILE *const fileIn);
 void cxa_ioStream_file_close(cxa_ioStream_file_t *const ioStreamIn);
+int cxa_ioStream_file_getFileDescriptor(cxa_ioStream_file_t *const ioStreamIn);
 
 #endif // CXA_IOSTREAM_FILE_H_
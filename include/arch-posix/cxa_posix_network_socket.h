@@ -0,0 +1,90 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains socket helpers shared by the POSIX tcpClient and
+ * tcpServer_connectedClient implementations.
+ *
+ * @note This file contains functionality restricted to the CXA POSIX implementation.
+ */
+#ifndef CXA_POSIX_NETWORK_SOCKET_H_
+#define CXA_POSIX_NETWORK_SOCKET_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cxa_ioStream.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_IDLE_S
+	#define CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_IDLE_S				30
+#endif
+
+#ifndef CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_INTERVAL_S
+	#define CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_INTERVAL_S			5
+#endif
+
+#ifndef CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_COUNT
+	#define CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_COUNT				3
+#endif
+
+#ifndef CXA_POSIX_NETWORK_SOCKET_WRITE_TIMEOUT_MS
+	#define CXA_POSIX_NETWORK_SOCKET_WRITE_TIMEOUT_MS				2000
+#endif
+
+
+// ******** global type definitions *********
+
+
+// ******** global function prototypes ********
+/**
+ * @protected
+ * @brief Disables Nagle's algorithm and enables TCP keepalive
+ * 		(see CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_*)
+ *
+ * @param[in] socketIn the (connected or connecting) socket
+ */
+void cxa_posix_network_socket_setOptions(int socketIn);
+
+
+/**
+ * @protected
+ * @brief Performs a single non-blocking read
+ *
+ * @return CXA_IOSTREAM_READSTAT_ERROR if the peer closed the connection or
+ * 		an error occurred (the caller should close the socket)
+ */
+cxa_ioStream_readStatus_t cxa_posix_network_socket_read(int socketIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
+
+
+/**
+ * @protected
+ * @brief Writes all of the supplied segments (in as few system calls as
+ * 		possible), waiting for the socket to become writable as needed
+ *
+ * @return false if no progress was made for CXA_POSIX_NETWORK_SOCKET_WRITE_TIMEOUT_MS
+ * 		or an error occurred (the caller should close the socket)
+ */
+bool cxa_posix_network_socket_writeVectored(int socketIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn);
+
+
+/**
+ * @protected
+ * @brief Checks (without consuming data) whether the peer has closed the
+ * 		connection. Intended to be called when the socket becomes readable.
+ *
+ * @return true if the connection has been closed (or has errored)
+ */
+bool cxa_posix_network_socket_isClosedByPeer(int socketIn);
+
+
+#endif // CXA_POSIX_NETWORK_SOCKET_H_
@@ -0,0 +1,87 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a POSIX (BSD socket) implementation of ::cxa_network_tcpClient_t.
+ *
+ * Connections are made asynchronously using non-blocking sockets. Socket
+ * readiness is monitored via ::cxa_posix_runLoop_addFd_events so idle
+ * connections don't need to be polled. This requires CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+ * (checked at compile time) and a thread run by ::cxa_runLoop_execute (or
+ * one that calls ::cxa_posix_runLoop_waitForEvents between iterations).
+ * Hostname resolution (getaddrinfo) is synchronous.
+ *
+ * TLS is not supported by this implementation.
+ *
+ * @note This file contains functionality restricted to the CXA POSIX implementation.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_network_tcpClient_t* myClient = cxa_network_factory_reserveTcpClient(CXA_RUNLOOP_THREADID_DEFAULT);
+ * cxa_network_tcpClient_addListener(myClient, cb_onConnect, cb_onConnectFail, cb_onDisconnect, NULL);
+ * cxa_network_tcpClient_connectToHost(myClient, "127.0.0.1", 1883, false, 5000);
+ * @endcode
+ */
+#ifndef CXA_POSIX_NETWORK_TCPCLIENT_H_
+#define CXA_POSIX_NETWORK_TCPCLIENT_H_
+
+
+// ******** includes ********
+#include <cxa_network_tcpClient.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_network_tcpClient_t object
+ */
+typedef struct cxa_posix_network_tcpClient cxa_posix_network_tcpClient_t;
+
+
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_POSIX_NETWORK_TCPCLIENT_STATE_IDLE,
+	CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTING,
+	CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED
+}cxa_posix_network_tcpClient_state_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_network_tcpClient
+{
+	cxa_network_tcpClient_t super;
+
+	int threadId;
+	int socket;
+	cxa_posix_network_tcpClient_state_t state;
+
+	// set when the runLoop reports incoming data, cleared once it's drained
+	bool isReadable;
+
+	uint32_t connectTimeout_ms;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @private
+ */
+void cxa_posix_network_tcpClient_init(cxa_posix_network_tcpClient_t *const netClientIn, int threadIdIn);
+
+
+#endif // CXA_POSIX_NETWORK_TCPCLIENT_H_
@@ -0,0 +1,83 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a POSIX (BSD socket) implementation of ::cxa_network_tcpServer_t.
+ *
+ * The listening socket (and every connected client) is monitored via
+ * ::cxa_posix_runLoop_addFd_events so nothing is polled while idle. This
+ * requires CXA_RUNLOOP_POSIX_EVENTS_ENABLE (checked at compile time) and a
+ * thread run by ::cxa_runLoop_execute (or one that calls
+ * ::cxa_posix_runLoop_waitForEvents between iterations). Connections are accepted until
+ * CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS are connected...further
+ * connections are accepted and immediately closed.
+ *
+ * @note Each connected client consumes one of CXA_POSIX_RUNLOOP_MAXNUM_FDS
+ *
+ * @note This file contains functionality restricted to the CXA POSIX implementation.
+ */
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_H_
+#define CXA_POSIX_NETWORK_TCPSERVER_H_
+
+
+// ******** includes ********
+#include <cxa_network_tcpServer.h>
+
+#include <cxa_posix_network_tcpServer_connectedClient.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS
+	#define CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS			4
+#endif
+
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_BACKLOG
+	#define CXA_POSIX_NETWORK_TCPSERVER_BACKLOG						16
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_network_tcpServer_t object
+ */
+typedef struct cxa_posix_network_tcpServer cxa_posix_network_tcpServer_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_network_tcpServer
+{
+	cxa_network_tcpServer_t super;
+
+	int threadId;
+	int listenSocket;
+
+	cxa_posix_network_tcpServer_connectedClient_t connectedClients[CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS];
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @protected
+ */
+void cxa_posix_network_tcpServer_init(cxa_posix_network_tcpServer_t *const netServerIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Returns the port on which the server is listening (useful when
+ * 		listening on port 0, ie. an OS-assigned port)
+ *
+ * @return the port number, or 0 if not listening
+ */
+uint16_t cxa_posix_network_tcpServer_getListeningPort(cxa_posix_network_tcpServer_t *const netServerIn);
+
+
+#endif // CXA_POSIX_NETWORK_TCPSERVER_H_
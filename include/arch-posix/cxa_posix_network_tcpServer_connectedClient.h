@@ -0,0 +1,63 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
+#define CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
+
+
+// ******** includes ********
+#include <netinet/in.h>
+
+#include <cxa_network_tcpServer_connectedClient.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_network_tcpServer_connectedClient_t object
+ */
+typedef struct cxa_posix_network_tcpServer_connectedClient cxa_posix_network_tcpServer_connectedClient_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_network_tcpServer_connectedClient
+{
+	cxa_network_tcpServer_connectedClient_t super;
+
+	int threadId;
+	int socket;
+
+	// set when the runLoop reports incoming data, cleared once it's drained
+	bool isReadable;
+	char descriptiveString[23];			// "aaa.bbb.ccc.ddd::eeeee"
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @protected
+ */
+void cxa_posix_network_tcpServer_connectedClient_initUnbound(cxa_posix_network_tcpServer_connectedClient_t *const ccIn, int threadIdIn);
+
+
+/**
+ * @protected
+ * @brief Takes ownership of an accepted (non-blocking) socket
+ *
+ * @return true on success, false if the socket could not be monitored
+ * 		(the socket is closed)
+ */
+bool cxa_posix_network_tcpServer_connectedClient_bindToSocket(cxa_posix_network_tcpServer_connectedClient_t *const ccIn,
+															  int socketIn,
+															  struct sockaddr_in * clientAddressIn);
+
+
+#endif // CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
@@ -8,17 +8,168 @@
 #define CXA_POSIX_NVSMANAGER_H_
 
 
+/**
+ * @file
+ * Implements ::cxa_nvsManager.h on Linux using a single append-only log file
+ * (CXA_POSIX_NVSMANAGER_LOG_FILENAME in the directory passed to
+ * ::cxa_posix_nvsManager_init).
+ *
+ * Every key/value is cached in RAM and indexed by a hash table when the log
+ * is loaded at startup, so gets never touch the filesystem. Sets and erases
+ * take effect in the cache immediately but are only buffered for the log:
+ * ::cxa_nvsManager_commit appends the whole batch, terminated by a commit
+ * record, and issues a single fsync. If the batch buffer fills up it is
+ * committed implicitly.
+ *
+ * Every record carries a CRC. When the log is loaded, anything after the
+ * last intact commit record (a torn write or an uncommitted batch) is
+ * discarded, so a batch is either applied completely or not at all.
+ *
+ * Once the log holds more than twice the data needed to represent the
+ * current values, a background thread rewrites it to a temporary file and
+ * atomically renames it into place.
+ *
+ * #### Limits: ####
+ * - at most CXA_POSIX_NVSMANAGER_MAXNUM_KEYS keys, each 1 to
+ *   CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES bytes long (not counting the
+ *   terminator)
+ * - each value (including a cString's terminator) may be up to
+ *   CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES, but all values together must
+ *   fit in CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES
+ *
+ * Sets exceeding any of these fail (and leave the previous value in place).
+ *
+ * @note Values written by the previous (file per key) implementation are
+ * 		imported as blobs the first time the log is created. Files that can't
+ * 		be imported (eg. too large, or found after the log was created) are
+ * 		logged as errors but left in place and remain readable through
+ * 		::cxa_nvsManager_get_cString / ::cxa_nvsManager_get_blob until
+ * 		the key is erased or set.
+ */
+
+
 // ******** includes ********
+#include <cxa_nvsManager.h>
+#include <cxa_config.h>
 
 
 // ******** global macro definitions ********
+#ifndef CXA_POSIX_NVSMANAGER_LOG_FILENAME
+	#define CXA_POSIX_NVSMANAGER_LOG_FILENAME				"nvs.log"
+#endif
+
+#ifndef CXA_POSIX_NVSMANAGER_MAXNUM_KEYS
+	#define CXA_POSIX_NVSMANAGER_MAXNUM_KEYS				64
+#endif
+
+/**
+ * Number of slots in the hash index. Must be a power of two and at least
+ * twice CXA_POSIX_NVSMANAGER_MAXNUM_KEYS
+ */
+#ifndef CXA_POSIX_NVSMANAGER_INDEX_SIZE
+	#define CXA_POSIX_NVSMANAGER_INDEX_SIZE					128
+#endif
+
+#ifndef CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES
+	#define CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES			32
+#endif
+
+/**
+ * Largest single value (eg. a PEM certificate or private key)
+ */
+#ifndef CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES
+	#define CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES			8192
+#endif
+
+/**
+ * RAM shared by all cached values...values are stored back-to-back rather
+ * than in fixed size slots
+ */
+#ifndef CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES
+	#define CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES			65536
+#endif
+
+/**
+ * Size of the batch buffer. Must hold at least one record of the largest
+ * value (plus its commit record)
+ */
+#ifndef CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES
+	#define CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES		16384
+#endif
+
+/**
+ * Logs smaller than this are never compacted
+ */
+#ifndef CXA_POSIX_NVSMANAGER_COMPACT_MIN_BYTES
+	#define CXA_POSIX_NVSMANAGER_COMPACT_MIN_BYTES			16384
+#endif
+
+
+#if (CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES < 1) || (CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES > 255)
+	#error "CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES must be 1..255 (record key length is one byte)"
+#endif
+
+#if (CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES > 65535)
+	#error "CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES must be <= 65535 (record value length is two bytes)"
+#endif
+
+#if (CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES < CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES)
+	#error "CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES must be able to hold the largest value"
+#endif
+
+#if (CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES < (CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES + CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES + 12))
+	#error "CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES must hold a record of the largest value plus a commit record"
+#endif
 
 
 // ******** global type definitions *********
+/**
+ * @public
+ * @brief Log statistics, see ::cxa_posix_nvsManager_getStats
+ */
+typedef struct
+{
+	size_t logSize_bytes;
+	size_t valuePool_numBytesUsed;
+
+	uint32_t numCompactions;
+	uint32_t numCompactions_failed;
+	uint32_t numTailBatches;
+}cxa_posix_nvsManager_stats_t;
 
 
 // ******** global function prototypes ********
+/**
+ * @public
+ * @brief Loads (or creates) the log in the given directory and starts the
+ * 		background compaction thread
+ *
+ * @param[in] nvsDirIn directory in which the log is stored (must exist)
+ */
 void cxa_posix_nvsManager_init(char *const nvsDirIn);
 
 
+/**
+ * @public
+ * @brief Waits for a compaction in progress, stops the compaction thread
+ * 		and closes the log
+ *
+ * Changes that haven't been committed are discarded (as if power had been
+ * lost). ::cxa_posix_nvsManager_init may be called again afterwards, with
+ * the same or a different directory.
+ */
+void cxa_posix_nvsManager_deinit(void);
+
+
+/**
+ * @public
+ * @brief Returns the current state of the log. numTailBatches counts the
+ * 		batches committed while a compaction was in progress (and carried
+ * 		over to the compacted log once it finished).
+ *
+ * @param[out] statsOut filled with the current statistics
+ */
+void cxa_posix_nvsManager_getStats(cxa_posix_nvsManager_stats_t *const statsOut);
+
+
 #endif
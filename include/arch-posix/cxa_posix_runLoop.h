@@ -0,0 +1,169 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains an event-driven idle mechanism for ::cxa_runLoop_execute on
+ * Linux. Rather than spinning, the runLoop blocks (via epoll) until one of the
+ * following occurs:
+ *   1. a registered file descriptor becomes readable
+ *   2. the next timed entry / delayed one-shot is due
+ *   3. an entry is added / dispatched from another thread (via an eventfd)
+ *
+ * Untimed entries added with ::cxa_runLoop_addEntry_idleAware report whether
+ * they have work pending: the runLoop doesn't sleep while one does, and
+ * otherwise relies on the events above to wake it. Entries added with
+ * ::cxa_runLoop_addEntry_pollAware (eg. state machines) may also ask to be
+ * polled. Other untimed entries (::cxa_runLoop_addEntry) can't say. While any
+ * entry must be polled, the runLoop sleeps for at most
+ * ::CXA_POSIX_RUNLOOP_MAX_POLLPERIOD_MS between iterations. Register the fds
+ * such entries read from if they need to react faster than that.
+ *
+ * Enable by defining CXA_RUNLOOP_POSIX_EVENTS_ENABLE in cxa_config.h.
+ *
+ * @note This file contains functionality restricted to the CXA POSIX implementation.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_posix_usart_t myUsart;
+ * cxa_posix_usart_init_noHH(&myUsart, "/dev/ttyUSB0", B115200);
+ *
+ * // wake the runLoop whenever we receive data
+ * cxa_posix_runLoop_addFd(CXA_RUNLOOP_THREADID_DEFAULT, cxa_posix_usart_getFileDescriptor(&myUsart), NULL, NULL);
+ *
+ * // sleeps when idle
+ * cxa_runLoop_execute(CXA_RUNLOOP_THREADID_DEFAULT);
+ * @endcode
+ */
+#ifndef CXA_POSIX_RUNLOOP_H_
+#define CXA_POSIX_RUNLOOP_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_RUNLOOP_MAXNUM_FDS
+	#define CXA_POSIX_RUNLOOP_MAXNUM_FDS				16
+#endif
+
+/**
+ * Upper bound on how long the runLoop sleeps while it has untimed entries that
+ * aren't idle-aware
+ */
+#ifndef CXA_POSIX_RUNLOOP_MAX_POLLPERIOD_MS
+	#define CXA_POSIX_RUNLOOP_MAX_POLLPERIOD_MS			100
+#endif
+
+/**
+ * @public
+ * Flags for ::cxa_posix_runLoop_addFd_events / ::cxa_posix_runLoop_modifyFd
+ */
+#define CXA_POSIX_RUNLOOP_FDEVENT_READABLE				0x01
+#define CXA_POSIX_RUNLOOP_FDEVENT_WRITABLE				0x02
+#define CXA_POSIX_RUNLOOP_FDEVENT_EDGETRIGGERED			0x04
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief Called (from the context of the runLoop thread) when a registered
+ * file descriptor becomes readable (or writable, if requested). Errors and
+ * hang-ups are always reported.
+ *
+ * @param[in] fdIn the file descriptor that is now readable
+ * @param[in] userVarIn the user variable passed to ::cxa_posix_runLoop_addFd
+ */
+typedef void (*cxa_posix_runLoop_cb_fdReadable_t)(int fdIn, void *const userVarIn);
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Registers a file descriptor that will wake the specified runLoop
+ * thread when readable.
+ *
+ * @note The file descriptor is level-triggered: the runLoop will not sleep
+ * 		while data remains unread.
+ *
+ * @param[in] threadIdIn the runLoop thread that should be woken
+ * @param[in] fdIn the file descriptor to monitor
+ * @param[in] cbIn optional callback (may be NULL if the data is consumed by
+ * 		an existing runLoop entry)
+ * @param[in] userVarIn user variable passed to the callback
+ *
+ * @return true on success
+ */
+bool cxa_posix_runLoop_addFd(int threadIdIn, int fdIn, cxa_posix_runLoop_cb_fdReadable_t cbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_posix_runLoop_addFd but allows the caller to choose
+ * which events are monitored.
+ *
+ * @note Edge-triggered fds only wake the runLoop when new events arrive, so
+ * 		the owner doesn't need to consume all data from within the callback
+ * 		(eg. a socket that is read by an existing runLoop entry).
+ *
+ * @param[in] eventsIn bitwise-or of CXA_POSIX_RUNLOOP_FDEVENT_* flags
+ *
+ * @return true on success
+ */
+bool cxa_posix_runLoop_addFd_events(int threadIdIn, int fdIn, uint8_t eventsIn, cxa_posix_runLoop_cb_fdReadable_t cbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Changes the events monitored for a previously registered file
+ * descriptor (eg. from writable to readable once a connection completes).
+ *
+ * @param[in] threadIdIn the runLoop thread the fd was registered with
+ * @param[in] fdIn the file descriptor
+ * @param[in] eventsIn bitwise-or of CXA_POSIX_RUNLOOP_FDEVENT_* flags
+ *
+ * @return true on success
+ */
+bool cxa_posix_runLoop_modifyFd(int threadIdIn, int fdIn, uint8_t eventsIn);
+
+/**
+ * @public
+ * @brief Stops monitoring a previously registered file descriptor. Must be
+ * called before the file descriptor is closed.
+ *
+ * @param[in] threadIdIn the runLoop thread the fd was registered with
+ * @param[in] fdIn the file descriptor
+ */
+void cxa_posix_runLoop_removeFd(int threadIdIn, int fdIn);
+
+/**
+ * @public
+ * @brief Wakes the specified thread if it is currently sleeping. Safe to call
+ * from any thread.
+ *
+ * @param[in] threadIdIn the runLoop thread to wake
+ */
+void cxa_posix_runLoop_wake(int threadIdIn);
+
+/**
+ * @protected
+ * @brief Called by the runLoop whenever an entry is added or dispatched.
+ */
+void cxa_posix_runLoop_notifyWorkAdded(int threadIdIn);
+
+/**
+ * @protected
+ * @brief Called by ::cxa_runLoop_execute between iterations. Blocks until the
+ * specified thread has work to do.
+ */
+void cxa_posix_runLoop_waitForEvents(int threadIdIn);
+
+
+#endif // CXA_POSIX_RUNLOOP_H_
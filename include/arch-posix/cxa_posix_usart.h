@@ -81,4 +81,14 @@ bool cxa_posix_usart_init_noHH(cxa_posix_usart_t *const usartIn, char *const pat
 void cxa_posix_usart_close(cxa_posix_usart_t *const usartIn);
 
 
+/**
+ * Returns the underlying file descriptor (eg. for use with ::cxa_posix_runLoop_addFd).
+ *
+ * @param[in] usartIn pointer to the pre-initialized serial port
+ *
+ * @return the file descriptor of the serial port
+ */
+int cxa_posix_usart_getFileDescriptor(cxa_posix_usart_t *const usartIn);
+
+
 #endif // CXA_POSIX_USART_H_
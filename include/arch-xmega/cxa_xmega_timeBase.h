@@ -37,6 +37,7 @@
 
 // ******** includes ********
 #include <stdint.h>
+#include <cxa_timeBase.h>
 #include <cxa_xmega_timer32.h>
 
 
@@ -17,6 +17,10 @@
 
 
 // ******** global macro definitions ********
+#define CXA_BTLE_ADVPACKET_MAXNUM_DATA_BYTES				31
+
+// every field is at least a length and type byte
+#define CXA_BTLE_ADVPACKET_MAXNUM_FIELDS					(CXA_BTLE_ADVPACKET_MAXNUM_DATA_BYTES / 2)
 
 
 // ******** global type definitions *********
@@ -32,6 +36,8 @@ typedef struct cxa_btle_advPacket cxa_btle_advPacket_t;
 typedef enum
 {
 	CXA_BTLE_ADVFIELDTYPE_FLAGS = 0x01,
+	CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS16 = 0x02,
+	CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS16 = 0x03,
 	CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS = 0x06,
 	CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS = 0x07,
 	CXA_BTLE_ADVFIELDTYPE_TXPOWER = 0x0A,
@@ -73,6 +79,18 @@ typedef struct
 }cxa_btle_advField_t;
 
 
+/**
+ * @private
+ * @brief Location of a single field within the packet data (built once at init)
+ */
+typedef struct
+{
+	uint8_t byteIndex;
+	uint8_t length;
+	uint8_t type;
+}cxa_btle_advPacket_fieldIndex_t;
+
+
 /**
  * @private
  */
@@ -83,11 +101,21 @@ struct cxa_btle_advPacket
 	int rssi;
 
 	cxa_fixedByteBuffer_t fbb_data;
-	uint8_t fbb_data_raw[32];
+	uint8_t fbb_data_raw[CXA_BTLE_ADVPACKET_MAXNUM_DATA_BYTES+1];
+
+	cxa_btle_advPacket_fieldIndex_t fields[CXA_BTLE_ADVPACKET_MAXNUM_FIELDS];
+	uint8_t numFields;
 };
 
 
 // ******** global function prototypes ********
+/**
+ * @public
+ * @brief Copies the advertisement data and indexes its fields (in a single
+ * 		pass) so subsequent field accesses don't need to re-parse the packet
+ *
+ * @return true if the packet was well-formed, false if not
+ */
 bool cxa_btle_advPacket_init(cxa_btle_advPacket_t *const advPacketIn,
 							 uint8_t *const sourceAddrBytesIn, bool isRandomAddressIn,
 							 int rssiIn,
@@ -100,8 +128,24 @@ cxa_eui48_t* cxa_btle_advPacket_getAddress(cxa_btle_advPacket_t *const advPacket
 bool cxa_btle_advPacket_getNumFields(cxa_btle_advPacket_t *const advPacketIn, size_t *const numAdvFieldsOut);
 bool cxa_btle_advPacket_getField(cxa_btle_advPacket_t *const advPacketIn, size_t fieldIndexIn, cxa_btle_advField_t *const fieldOut);
 
+/**
+ * @public
+ * @brief Returns the first field of the given type
+ *
+ * @return true if the packet contains a field of the given type
+ */
+bool cxa_btle_advPacket_getField_byType(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advFieldType_t typeIn, cxa_btle_advField_t *const fieldOut);
+
 bool cxa_btle_advPacket_isAdvertisingService(cxa_btle_advPacket_t *const advPacketIn, const char *const uuidIn);
 
+/**
+ * @public
+ * @brief Binary version of ::cxa_btle_advPacket_isAdvertisingService. The
+ * 		UUID is compared directly against the bytes of the service UUID
+ * 		fields of matching size (no per-UUID conversion)
+ */
+bool cxa_btle_advPacket_isAdvertisingService_uuid(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_uuid_t *const uuidIn);
+
 bool cxa_btle_advField_getNumUuids(cxa_btle_advField_t *const advFieldIn, size_t* numUuidsOut);
 bool cxa_btle_advField_getUuid(cxa_btle_advField_t *const advFieldIn, size_t uuidIndexIn, cxa_btle_uuid_t *const uuidOut);
 
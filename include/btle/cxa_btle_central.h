@@ -19,6 +19,7 @@
 #include <cxa_eui48.h>
 #include <cxa_fixedByteBuffer.h>
 #include <cxa_logger_header.h>
+#include <cxa_timeDiff.h>
 #include <cxa_uuid128.h>
 
 
@@ -31,6 +32,16 @@
 	#define CXA_BTLE_CENTRAL_MAXNUM_CONNECTIONS				2
 #endif
 
+#ifndef CXA_BTLE_CENTRAL_MAXNUM_SCANFILTERS
+	#define CXA_BTLE_CENTRAL_MAXNUM_SCANFILTERS				4
+#endif
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	#ifndef CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES
+		#define CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES	16
+	#endif
+#endif
+
 
 // ******** global type definitions *********
 /**
@@ -127,6 +138,53 @@ typedef struct
 }cxa_btle_central_listener_entry_t;
 
 
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_BTLE_CENTRAL_SCANFILTER_SERVICE_UUID,
+	CXA_BTLE_CENTRAL_SCANFILTER_ADDR_PREFIX,
+	CXA_BTLE_CENTRAL_SCANFILTER_COMPANY_ID
+}cxa_btle_central_scanFilter_type_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_btle_central_scanFilter_type_t type;
+
+	union
+	{
+		cxa_btle_uuid_t serviceUuid;
+
+		// stored like cxa_eui48_t (reversed), prefix in the last numBytes
+		struct
+		{
+			uint8_t bytes[sizeof(((cxa_eui48_t*)0)->bytes)];
+			uint8_t numBytes;
+		}addrPrefix;
+
+		uint16_t companyId;
+	};
+}cxa_btle_central_scanFilter_entry_t;
+
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_eui48_t addr;
+	uint32_t dataHash;
+	cxa_timeDiff_t td_lastReported;
+}cxa_btle_central_dupCache_entry_t;
+#endif
+
+
 /**
  * @private
  */
@@ -135,6 +193,15 @@ struct cxa_btle_central
 	cxa_array_t listeners;
 	cxa_btle_central_listener_entry_t listeners_raw[CXA_BTLE_CENTRAL_MAXNUM_LISTENERS];
 
+	cxa_array_t scanFilters;
+	cxa_btle_central_scanFilter_entry_t scanFilters_raw[CXA_BTLE_CENTRAL_MAXNUM_SCANFILTERS];
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	cxa_btle_central_dupCache_entry_t dupCache[CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES];
+	size_t dupCache_numEntries;
+	uint32_t dupCache_window_ms;
+#endif
+
 	bool hasActivityAvailable;
 
 	struct
@@ -216,6 +283,57 @@ void cxa_btle_central_stopScan(cxa_btle_central_t *const btlecIn,
 							   void* userVarIn);
 
 
+/**
+ * @public
+ * @brief Only advertisements which match at least one scan filter are
+ * 		passed to the onAdvertRx callback (all advertisements are passed
+ * 		if no filters have been added). Filters are checked in binary
+ * 		form against the pre-indexed advertisement.
+ *
+ * @return false if there is no room for another filter
+ * 		(see CXA_BTLE_CENTRAL_MAXNUM_SCANFILTERS)
+ */
+bool cxa_btle_central_addScanFilter_serviceUuid(cxa_btle_central_t *const btlecIn, cxa_btle_uuid_t *const uuidIn);
+
+
+/**
+ * @public
+ * @brief Matches advertisements whose address starts with the given bytes
+ * 		(in the order printed by ::cxa_eui48_toString), eg. an OUI:
+ * 		{0x30, 0xAE, 0xA4} matches 30:AE:A4:01:74:90. Note that this is the
+ * 		reverse of the order of cxa_eui48_t.bytes.
+ */
+bool cxa_btle_central_addScanFilter_addressPrefix(cxa_btle_central_t *const btlecIn, uint8_t *const prefixBytesIn, size_t numPrefixBytesIn);
+
+
+/**
+ * @public
+ * @brief Matches advertisements containing manufacturer specific data
+ * 		from the given company identifier
+ */
+bool cxa_btle_central_addScanFilter_companyId(cxa_btle_central_t *const btlecIn, uint16_t companyIdIn);
+
+
+/**
+ * @public
+ */
+void cxa_btle_central_clearScanFilters(cxa_btle_central_t *const btlecIn);
+
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+/**
+ * @public
+ * @brief Suppresses advertisements with the same address and payload as
+ * 		one reported within the last window_msIn milliseconds. The cache
+ * 		holds CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES addresses (oldest
+ * 		evicted first) and is cleared whenever a scan is started.
+ *
+ * @param[in] window_msIn the suppression window, 0 disables suppression
+ */
+void cxa_btle_central_setDuplicateWindow_ms(cxa_btle_central_t *const btlecIn, uint32_t window_msIn);
+#endif
+
+
 /**
  * @public
  */
@@ -47,6 +47,15 @@ typedef void (*cxa_btle_connection_cb_onConnectionClosed_t)(cxa_btle_connection_
 															void* userVarIn);
 
 
+/**
+ * @public
+ * @brief Called each time the controller hands back tx credits (see
+ * 		::cxa_btle_connection_setOnTxCreditsAvailableCb)
+ */
+typedef void (*cxa_btle_connection_cb_onTxCreditsAvailable_t)(cxa_btle_connection_t *const connIn,
+															  void* userVarIn);
+
+
 /**
  * @public
  */
@@ -101,6 +110,17 @@ typedef void (*cxa_btle_connection_scm_writeToCharacteristic_t)(cxa_btle_connect
 																const char *const characteristicUuidIn,
 																cxa_fixedByteBuffer_t *const dataIn);
 
+/**
+ * @protected
+ * @brief Hands a write command (no ATT response) to the controller
+ *
+ * @return true if the controller accepted the packet, false if it was dropped
+ */
+typedef bool (*cxa_btle_connection_scm_writeToCharacteristic_noResponse_t)(cxa_btle_connection_t *const superIn,
+																		   const char *const serviceUuidIn,
+																		   const char *const characteristicUuidIn,
+																		   cxa_fixedByteBuffer_t *const dataIn);
+
 /**
  * @protected
  */
@@ -142,6 +162,12 @@ struct cxa_btle_connection
 			void* userVar;
 		}connectionClosed;
 
+		struct
+		{
+			cxa_btle_connection_cb_onTxCreditsAvailable_t func;
+			void* userVar;
+		}txCreditsAvailable;
+
 		struct
 		{
 			cxa_btle_connection_cb_onReadComplete_t func;
@@ -173,9 +199,14 @@ struct cxa_btle_connection
 
 		cxa_btle_connection_scm_readFromCharacteristic_t readFromCharacteristic;
 		cxa_btle_connection_scm_writeToCharacteristic_t writeToCharacteristic;
+		cxa_btle_connection_scm_writeToCharacteristic_noResponse_t writeToCharacteristic_noResponse;
 
 		cxa_btle_connection_scm_changeNotifications_t changeNotifications;
 	}scms;
+
+	// controller tx buffers available for write commands
+	size_t numTxCredits;
+	size_t maxNumTxCredits;
 };
 
 
@@ -191,6 +222,24 @@ void cxa_btle_connection_init(cxa_btle_connection_t *const connIn,
 							  cxa_btle_connection_scm_changeNotifications_t scm_changeNotiIndisIn);
 
 
+/**
+ * @protected
+ * @brief Enables write commands (write-without-response) for this connection
+ *
+ * Write commands are flow controlled by the controller rather than by the
+ * peer: each one consumes a tx credit, and the subclass hands credits back
+ * (via ::cxa_btle_connection_notify_txCreditsAvailable) as the controller
+ * frees its buffers.
+ *
+ * @param[in] scm_writeNoRespIn subclass method which queues a write command
+ * @param[in] maxNumTxCreditsIn number of packets the controller can buffer
+ * 		for this connection
+ */
+void cxa_btle_connection_enableWriteNoResponse(cxa_btle_connection_t *const connIn,
+											   cxa_btle_connection_scm_writeToCharacteristic_noResponse_t scm_writeNoRespIn,
+											   size_t maxNumTxCreditsIn);
+
+
 /**
  * @protected
  */
@@ -206,6 +255,20 @@ void cxa_btle_connection_setOnClosedCb(cxa_btle_connection_t *const connIn,
 									   void* userVarIn);
 
 
+/**
+ * @public
+ * @brief Sets a callback for when write commands can be sent again
+ *
+ * Unlike the other callbacks this one stays registered (until the
+ * connection closes) since credits come back many times per connection.
+ * Use it to send write commands that were held back for lack of credits
+ * without waiting for the next runLoop iteration.
+ */
+void cxa_btle_connection_setOnTxCreditsAvailableCb(cxa_btle_connection_t *const connIn,
+												   cxa_btle_connection_cb_onTxCreditsAvailable_t cbIn,
+												   void* userVarIn);
+
+
 /**
  * @public
  */
@@ -245,6 +308,44 @@ void cxa_btle_connection_writeToCharacteristic_ptr(cxa_btle_connection_t *const
 												   void *userVarIn);
 
 
+/**
+ * @public
+ * @brief Writes to a characteristic without waiting for a response
+ *
+ * Fails immediately if the connection doesn't support write commands or
+ * the controller has no tx credits left.
+ *
+ * @return true if the write was handed to the controller
+ */
+bool cxa_btle_connection_writeToCharacteristic_noResponse(cxa_btle_connection_t *const connIn,
+														  const char *const serviceUuidIn,
+														  const char *const characteristicUuidIn,
+														  cxa_fixedByteBuffer_t *const dataIn);
+
+
+/**
+ * @public
+ */
+bool cxa_btle_connection_writeToCharacteristic_noResponse_ptr(cxa_btle_connection_t *const connIn,
+															  const char *const serviceUuidIn,
+															  const char *const characteristicUuidIn,
+															  void *const dataIn,
+															  size_t numBytesIn);
+
+
+/**
+ * @public
+ */
+bool cxa_btle_connection_isWriteNoResponseSupported(cxa_btle_connection_t *const connIn);
+
+
+/**
+ * @public
+ * @return the number of write commands that can currently be queued
+ */
+size_t cxa_btle_connection_getNumTxCredits(cxa_btle_connection_t *const connIn);
+
+
 /**
  * @public
  */
@@ -287,6 +388,14 @@ void cxa_btle_connection_notify_writeComplete(cxa_btle_connection_t *const connI
 											  bool wasSuccessfulIn);
 
 
+/**
+ * @protected
+ * @brief Returns tx credits once the controller has sent buffered write commands
+ */
+void cxa_btle_connection_notify_txCreditsAvailable(cxa_btle_connection_t *const connIn,
+												   size_t numCreditsIn);
+
+
 /**
  * @protected
  */
@@ -0,0 +1,366 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_BTLE_CONNECTIONPOOL_H_
+#define CXA_BTLE_CONNECTIONPOOL_H_
+
+
+/**
+ * @file
+ * Keeps connections open to several peripherals at once and feeds each of
+ * them from its own queue of GATT operations.
+ *
+ * Each peripheral is represented by a "link". Operations may be queued on a
+ * link at any time: the pool connects to the peripheral on demand, issues
+ * the operations as fast as the link allows, and (for non-persistent links)
+ * drops the connection again once the queue has drained and another link is
+ * waiting for a connection slot.
+ *
+ * Scheduling is round-robin across links. The central only supports a
+ * single connection attempt at a time so links take turns connecting, and
+ * a link that fails to connect backs off exponentially (between
+ * CXA_BTLE_CONNECTIONPOOL_STANDOFF_MIN_MS and CXA_BTLE_CONNECTIONPOOL_STANDOFF_MAX_MS)
+ * without holding up the others.
+ *
+ * Within a link, requests (read, write, subscribe) are issued one at a time
+ * as required by ATT, but the next one goes out as soon as the previous one
+ * completes rather than on the next runLoop iteration. Writes without
+ * response don't wait for the peer at all: consecutive ones are batched to
+ * the controller until it runs out of tx credits.
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_btle_connectionPool_init(&pool, btlec, CXA_RUNLOOP_THREADID_DEFAULT);
+ * cxa_btle_connectionPool_link_t* link = cxa_btle_connectionPool_addLink(&pool, &sensorAddr, false, false, NULL, NULL, NULL);
+ *
+ * cxa_btle_connectionPool_queueWrite_noResponse(link, SVC_UUID, CTRL_CHAR_UUID, &cmd, sizeof(cmd));
+ * cxa_btle_connectionPool_queueRead(link, SVC_UUID, DATA_CHAR_UUID, cb_onDataRead, NULL);
+ * @endcode
+ *
+ * @note UUID strings passed to the queue functions are NOT copied and must
+ * 		remain valid until the operation completes
+ */
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <cxa_btle_central.h>
+#include <cxa_btle_connection.h>
+#include <cxa_config.h>
+#include <cxa_eui48.h>
+#include <cxa_fixedFifo.h>
+#include <cxa_logger_header.h>
+#include <cxa_timeDiff.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_BTLE_CONNECTIONPOOL_MAXNUM_LINKS
+	#define CXA_BTLE_CONNECTIONPOOL_MAXNUM_LINKS					4
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_MAXNUM_ACTIVE_LINKS
+	#define CXA_BTLE_CONNECTIONPOOL_MAXNUM_ACTIVE_LINKS				CXA_BTLE_CENTRAL_MAXNUM_CONNECTIONS
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_MAXNUM_QUEUED_OPS
+	#define CXA_BTLE_CONNECTIONPOOL_MAXNUM_QUEUED_OPS				8
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES
+	#define CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES				20
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_MAXNUM_OPS_PER_TURN
+	#define CXA_BTLE_CONNECTIONPOOL_MAXNUM_OPS_PER_TURN				4
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_STANDOFF_MIN_MS
+	#define CXA_BTLE_CONNECTIONPOOL_STANDOFF_MIN_MS					250
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_STANDOFF_MAX_MS
+	#define CXA_BTLE_CONNECTIONPOOL_STANDOFF_MAX_MS					30000
+#endif
+
+#ifndef CXA_BTLE_CONNECTIONPOOL_IDLE_DISCONNECT_MS
+	#define CXA_BTLE_CONNECTIONPOOL_IDLE_DISCONNECT_MS				1000
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct cxa_btle_connectionPool cxa_btle_connectionPool_t;
+
+
+/**
+ * @public
+ */
+typedef struct cxa_btle_connectionPool_link cxa_btle_connectionPool_link_t;
+
+
+/**
+ * @public
+ * @brief Called each time the link (re)connects. Subscriptions made on
+ * 		persistent links are restored automatically (queued ahead of this
+ * 		call), those on other links must be re-queued by the caller.
+ */
+typedef void (*cxa_btle_connectionPool_cb_onConnected_t)(cxa_btle_connectionPool_link_t *const linkIn, void* userVarIn);
+
+
+/**
+ * @public
+ */
+typedef void (*cxa_btle_connectionPool_cb_onDisconnected_t)(cxa_btle_connectionPool_link_t *const linkIn, void* userVarIn);
+
+
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_BTLE_CONNECTIONPOOL_OPTYPE_READ,
+	CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE,
+	CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE_NORESPONSE,
+	CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE
+}cxa_btle_connectionPool_opType_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_btle_connectionPool_opType_t type;
+
+	const char* serviceUuid_str;
+	const char* characteristicUuid_str;
+
+	uint8_t data[CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES];
+	size_t numDataBytes;
+
+	union
+	{
+		cxa_btle_connection_cb_onReadComplete_t onReadComplete;
+		cxa_btle_connection_cb_onWriteComplete_t onWriteComplete;
+		cxa_btle_connection_cb_onNotiIndiSubscriptionChanged_t onSubscribed;
+	}cb;
+	cxa_btle_connection_cb_onNotiIndiRx_t cb_onRx;
+	void* userVar;
+}cxa_btle_connectionPool_op_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	bool isUsed;
+	bool isSubscribed;
+	cxa_btle_connectionPool_link_t* link;
+
+	// what we need to subscribe again after a reconnect
+	const char* serviceUuid_str;
+	const char* characteristicUuid_str;
+	cxa_btle_connection_cb_onNotiIndiSubscriptionChanged_t cb_onSubscribed;
+
+	cxa_btle_connection_cb_onNotiIndiRx_t cb_onRx;
+	void* userVar;
+}cxa_btle_connectionPool_subscription_t;
+
+
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE,
+	CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTING,
+	CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED,
+	CXA_BTLE_CONNECTIONPOOL_LINKSTATE_DISCONNECTING,
+	CXA_BTLE_CONNECTIONPOOL_LINKSTATE_STANDOFF
+}cxa_btle_connectionPool_linkState_t;
+
+
+/**
+ * @private
+ */
+struct cxa_btle_connectionPool_link
+{
+	cxa_btle_connectionPool_t* pool;
+
+	cxa_eui48_t targetAddr;
+	bool isRandomAddr;
+	bool isPersistent;
+
+	cxa_btle_connectionPool_linkState_t state;
+	cxa_btle_connection_t* conn;
+
+	cxa_timeDiff_t td_standoff;
+	uint32_t standoff_ms;
+	cxa_timeDiff_t td_idle;
+
+	cxa_fixedFifo_t ops;
+	cxa_btle_connectionPool_op_t ops_raw[CXA_BTLE_CONNECTIONPOOL_MAXNUM_QUEUED_OPS];
+
+	cxa_btle_connectionPool_op_t inFlightOp;
+	bool hasInFlightOp;
+	bool isServicing;
+	size_t numDroppedWriteCmds;
+
+	cxa_btle_connectionPool_subscription_t subs[CXA_BTLE_CONNECTION_MAXNUM_NOTIINDI_SUBSCRIPTIONS];
+
+	cxa_btle_connectionPool_cb_onConnected_t cb_onConnected;
+	cxa_btle_connectionPool_cb_onDisconnected_t cb_onDisconnected;
+	void* userVar;
+};
+
+
+/**
+ * @private
+ */
+struct cxa_btle_connectionPool
+{
+	cxa_btle_central_t* btlec;
+
+	cxa_btle_connectionPool_link_t links[CXA_BTLE_CONNECTIONPOOL_MAXNUM_LINKS];
+	size_t numLinks;
+
+	cxa_btle_connectionPool_link_t* connectingLink;
+	size_t nextServiceIndex;
+	size_t nextConnectIndex;
+
+	cxa_logger_t logger;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the pool and registers it with the runLoop
+ *
+ * @param[in] poolIn pointer to the pre-allocated pool object
+ * @param[in] btlecIn the central used to open connections
+ * @param[in] threadIdIn runLoop thread on which links are serviced
+ */
+void cxa_btle_connectionPool_init(cxa_btle_connectionPool_t *const poolIn, cxa_btle_central_t *const btlecIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Adds a peripheral to the pool
+ *
+ * @param[in] isPersistentIn if true, the pool keeps this link connected even
+ * 		when it has no queued operations (eg. for notifications)
+ *
+ * @return the new link, or NULL if CXA_BTLE_CONNECTIONPOOL_MAXNUM_LINKS
+ * 		links have already been added
+ */
+cxa_btle_connectionPool_link_t* cxa_btle_connectionPool_addLink(cxa_btle_connectionPool_t *const poolIn,
+																 cxa_eui48_t *const targetAddrIn,
+																 bool isRandomAddrIn,
+																 bool isPersistentIn,
+																 cxa_btle_connectionPool_cb_onConnected_t cb_onConnectedIn,
+																 cxa_btle_connectionPool_cb_onDisconnected_t cb_onDisconnectedIn,
+																 void* userVarIn);
+
+
+/**
+ * @public
+ * @return true if the read was queued, false if the link's queue is full
+ */
+bool cxa_btle_connectionPool_queueRead(cxa_btle_connectionPool_link_t *const linkIn,
+									   const char *const serviceUuidIn,
+									   const char *const characteristicUuidIn,
+									   cxa_btle_connection_cb_onReadComplete_t cbIn,
+									   void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Queues an acknowledged write. The data is copied.
+ *
+ * @return true if the write was queued, false if the link's queue is full
+ * 		or the data is larger than CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES
+ */
+bool cxa_btle_connectionPool_queueWrite(cxa_btle_connectionPool_link_t *const linkIn,
+										const char *const serviceUuidIn,
+										const char *const characteristicUuidIn,
+										void *const dataIn,
+										size_t numBytesIn,
+										cxa_btle_connection_cb_onWriteComplete_t cbIn,
+										void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Queues a write without response. The data is copied.
+ *
+ * If the connection doesn't support write commands, this is sent as a
+ * regular (acknowledged) write instead.
+ *
+ * @return true if the write was queued, false if the link's queue is full
+ * 		or the data is larger than CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES
+ */
+bool cxa_btle_connectionPool_queueWrite_noResponse(cxa_btle_connectionPool_link_t *const linkIn,
+												   const char *const serviceUuidIn,
+												   const char *const characteristicUuidIn,
+												   void *const dataIn,
+												   size_t numBytesIn);
+
+
+/**
+ * @public
+ * @brief Queues a subscription to notifications/indications
+ *
+ * On persistent links the subscription is re-issued each time the link
+ * reconnects (cb_onSubscribedIn is called again with the result), so the
+ * UUID strings must remain valid for as long as the link exists.
+ *
+ * @return true if the subscription was queued, false if the link's queue is full
+ */
+bool cxa_btle_connectionPool_queueSubscribe(cxa_btle_connectionPool_link_t *const linkIn,
+											const char *const serviceUuidIn,
+											const char *const characteristicUuidIn,
+											cxa_btle_connection_cb_onNotiIndiSubscriptionChanged_t cb_onSubscribedIn,
+											cxa_btle_connection_cb_onNotiIndiRx_t cb_onRxIn,
+											void* userVarIn);
+
+
+/**
+ * @public
+ */
+bool cxa_btle_connectionPool_link_isConnected(cxa_btle_connectionPool_link_t *const linkIn);
+
+
+/**
+ * @public
+ * @return the number of operations waiting to be issued (not counting one
+ * 		that is currently in flight)
+ */
+size_t cxa_btle_connectionPool_link_getNumQueuedOps(cxa_btle_connectionPool_link_t *const linkIn);
+
+
+/**
+ * @public
+ * @return the number of write commands (writes without response) that the
+ * 		connection rejected for a reason other than a lack of tx credits.
+ * 		These are dropped so they don't block the rest of the queue.
+ */
+size_t cxa_btle_connectionPool_link_getNumDroppedWriteCmds(cxa_btle_connectionPool_link_t *const linkIn);
+
+
+/**
+ * @public
+ * @return the number of links that are connected or in the process of
+ * 		connecting / disconnecting
+ */
+size_t cxa_btle_connectionPool_getNumActiveLinks(cxa_btle_connectionPool_t *const poolIn);
+
+
+#endif
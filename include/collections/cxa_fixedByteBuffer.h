@@ -127,6 +127,11 @@ typedef struct cxa_fixedByteBuffer cxa_fixedByteBuffer_t;
 struct cxa_fixedByteBuffer
 {
 	cxa_array_t bytes;
+
+	// only used for buffers initialized with headroom (NULL otherwise)
+	uint8_t* headroomBase;
+	size_t headroomBase_maxSize_bytes;
+	size_t initialHeadroom_bytes;
 };
 
 
@@ -160,6 +165,25 @@ void cxa_fixedByteBuffer_init(cxa_fixedByteBuffer_t *const fbbIn, void *const bu
 void cxa_fixedByteBuffer_init_inPlace(cxa_fixedByteBuffer_t *const fbbIn, const size_t currNumElemsIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn);
 
 
+/**
+ * @public
+ * @brief Initializes the pre-allocated fixedByteBuffer such that the first
+ * 		headroom_bytesIn of the specified memory are reserved in front of the
+ * 		data. Inserts near the front of the buffer (eg. prepending a header) will
+ * 		grow the buffer backwards into the headroom rather than moving all
+ * 		following bytes. Removes near the front of the buffer return bytes to
+ * 		the headroom. ::cxa_fixedByteBuffer_clear restores the original headroom.
+ *
+ * @param[in] fbbIn pointer to the pre-allocated fixedByteBuffer object
+ * @param[in] bufferLocIn pointer to the pre-allocated chunk of memory that will
+ * 		be used to store elements in the buffer (including headroom)
+ * @param[in] bufferMaxSize_bytesIn the maximum size of the chunk of memory (buffer) in bytes
+ * @param[in] headroom_bytesIn the number of bytes (from bufferMaxSize_bytesIn) to reserve
+ * 		in front of the data
+ */
+void cxa_fixedByteBuffer_init_withHeadroom(cxa_fixedByteBuffer_t *const fbbIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn, const size_t headroom_bytesIn);
+
+
 /**
  * @public
  * @brief Initializes a new subBuffer whose bytes are stored within another fixedByteBuffer. This
@@ -321,6 +345,21 @@ bool cxa_fixedByteBuffer_get_lengthPrefixedCString_uint16BE(cxa_fixedByteBuffer_
 bool cxa_fixedByteBuffer_replace(cxa_fixedByteBuffer_t *const fbbIn, const size_t indexIn, uint8_t *const ptrIn, const size_t numBytesIn);
 bool cxa_fixedByteBuffer_replace_cString(cxa_fixedByteBuffer_t *const fbbIn, const size_t indexIn, char *const stringIn);
 
+/**
+ * @public
+ * @brief Inserts the specified bytes into the buffer. For buffers initialized with
+ * 		::cxa_fixedByteBuffer_init_withHeadroom, bytes preceding the index are moved
+ * 		backwards into the headroom (if there is room and it requires less copying).
+ * 		Otherwise, all following bytes are moved up.
+ *
+ * @param[in] fbbIn pointer to the pre-initialized cxa_fixedByteBuffer_t object
+ * @param[in] indexIn the index at which the first inserted byte should reside
+ * @param[in] ptrIn pointer to the bytes to insert
+ * @param[in] numBytesIn the number of bytes to insert
+ *
+ * @return true if the insert was successful, false if there wasn't enough space
+ * 		or the index was out-of-bounds
+ */
 bool cxa_fixedByteBuffer_insert(cxa_fixedByteBuffer_t *const fbbIn, const size_t indexIn, uint8_t *const ptrIn, const size_t numBytesIn);
 
 /**
@@ -367,6 +406,18 @@ size_t cxa_fixedByteBuffer_getMaxSize_bytes(cxa_fixedByteBuffer_t *const fbbIn);
 size_t cxa_fixedByteBuffer_getFreeSize_bytes(cxa_fixedByteBuffer_t *const fbbIn);
 
 
+/**
+ * @public
+ * @brief Determines the number of unused bytes remaining in front of the data
+ * 		(see ::cxa_fixedByteBuffer_init_withHeadroom)
+ *
+ * @param[in] fbbIn pointer to the pre-initialized fixedByteBuffer object
+ *
+ * @return the number of bytes available for growing the buffer backwards
+ */
+size_t cxa_fixedByteBuffer_getHeadroom_bytes(cxa_fixedByteBuffer_t *const fbbIn);
+
+
 /**
  * @public
  * @brief Determines if this buffer is currently full (::cxa_fixedByteBuffer_getCurrSize == ::cxa_fixedByteBuffer_getMaxSize)
@@ -0,0 +1,212 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a single-producer / single-consumer variant of ::cxa_fixedFifo_t.
+ * Exactly one context (thread or ISR) may queue and exactly one context may dequeue
+ * without any additional locking (ie. no ::cxa_criticalSection_enter).
+ *
+ * Unlike ::cxa_fixedFifo_t, the maximum number of elements must be a power of two
+ * and the FIFO can hold all of them (no slot is reserved to distinguish full from empty).
+ * Full FIFOs always drop new elements (the producer cannot dequeue).
+ *
+ * @note This object should work across all architecture-specific implementations
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_fixedFifo_spsc_t rxFifo;
+ * uint8_t rxFifo_raw[64];				// must be a power-of-two number of elements
+ *
+ * cxa_fixedFifo_spsc_initStd(&rxFifo, rxFifo_raw);
+ *
+ * // producer (eg. rx ISR / reader thread)
+ * cxa_fixedFifo_spsc_bulkQueue(&rxFifo, rxBytes, numRxBytes);
+ *
+ * // consumer (eg. runLoop)
+ * uint8_t buff[16];
+ * size_t numBytes = cxa_fixedFifo_spsc_bulkDequeue(&rxFifo, buff, sizeof(buff));
+ * @endcode
+ */
+#ifndef CXA_FIXED_FIFO_SPSC_H_
+#define CXA_FIXED_FIFO_SPSC_H_
+
+
+// ******** includes ********
+#include <stdlib.h>
+#include <stdbool.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+/**
+ * @public
+ * @brief Shortcut to initialize the fifo with a buffer of an explict data type
+ *
+ * @param[in] fifoIn pointer to FIFO to initialize
+ * @param[in] bufferIn pointer to the declared c-style array which
+ * 		will contain the data for the FIFO.
+ */
+#define cxa_fixedFifo_spsc_initStd(fifoIn, bufferIn)						cxa_fixedFifo_spsc_init((fifoIn), sizeof(*(bufferIn)), ((void*)(bufferIn)), sizeof(bufferIn))
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_fixedFifo_spsc_t object
+ */
+typedef struct cxa_fixedFifo_spsc cxa_fixedFifo_spsc_t;
+
+
+/**
+ * @private
+ */
+struct cxa_fixedFifo_spsc
+{
+	void *bufferLoc;
+
+	size_t datatypeSize_bytes;
+	size_t indexMask;
+
+	// free-running counters...only written by the producer / consumer respectively
+	volatile size_t insertCount;
+	volatile size_t removeCount;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the FIFO using the specified buffer (which is empty) to store elements
+ *
+ * @param[in] fifoIn pointer to the pre-allocated cxa_fixedFifo_spsc_t object
+ * @param[in] datatypeSize_bytesIn the size of each element that will be inserted
+ * 		into the FIFO (all elements MUST be the same size)
+ * @param[in] bufferLocIn pointer to the pre-allocated chunk of memory that will
+ * 		be used to store elements in the FIFO (the buffer)
+ * @param[in] bufferMaxSize_bytesIn the maximum size of the chunk of memory (buffer) in bytes.
+ * 		Must hold a power-of-two number of elements.
+ */
+void cxa_fixedFifo_spsc_init(cxa_fixedFifo_spsc_t *const fifoIn, const size_t datatypeSize_bytesIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn);
+
+/**
+ * @public
+ * @brief Clears the contents of the FIFO
+ *
+ * @note Must only be called when neither the producer nor the consumer is active
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ */
+void cxa_fixedFifo_spsc_clear(cxa_fixedFifo_spsc_t *const fifoIn);
+
+/**
+ * @public
+ * @brief Queues an element in the FIFO (producer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] elemIn pointer to the element which will be copied
+ * 		into the FIFO's buffer
+ *
+ * @return true if the element was queued, false if the FIFO was full
+ */
+bool cxa_fixedFifo_spsc_queue(cxa_fixedFifo_spsc_t *const fifoIn, const void *const elemIn);
+
+/**
+ * @public
+ * @brief Queues as many of the specified elements as will fit (producer only).
+ * Performs at most two contiguous copies.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] elemsIn pointer to the contiguous elements which will be copied
+ * @param[in] numElemsIn the number of elements to copy
+ *
+ * @return the number of elements actually queued
+ */
+size_t cxa_fixedFifo_spsc_bulkQueue(cxa_fixedFifo_spsc_t *const fifoIn, const void *const elemsIn, size_t numElemsIn);
+
+/**
+ * @public
+ * @brief "Peeks" at the next element in the FIFO without removing it (consumer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemOut pointer to where the element should be copied. May be
+ * 		NULL if no copy is desired.
+ *
+ * @return true if the FIFO was not empty
+ */
+bool cxa_fixedFifo_spsc_peek(cxa_fixedFifo_spsc_t *const fifoIn, void *elemOut);
+
+/**
+ * @public
+ * @brief Dequeues an element from the FIFO (consumer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemOut pointer to where the element should be copied. May be
+ * 		NULL if no copy is desired.
+ *
+ * @return true if the FIFO was not empty, false if the FIFO was empty
+ */
+bool cxa_fixedFifo_spsc_dequeue(cxa_fixedFifo_spsc_t *const fifoIn, void *elemOut);
+
+/**
+ * @public
+ * @brief Dequeues up to the specified number of elements (consumer only).
+ * Performs at most two contiguous copies.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut pointer to where the elements should be copied. May be
+ * 		NULL if the elements should simply be discarded.
+ * @param[in] maxNumElemsIn the maximum number of elements to dequeue
+ *
+ * @return the number of elements actually dequeued
+ */
+size_t cxa_fixedFifo_spsc_bulkDequeue(cxa_fixedFifo_spsc_t *const fifoIn, void *elemsOut, size_t maxNumElemsIn);
+
+/**
+ * @public
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the number of elements currently in the FIFO
+ */
+size_t cxa_fixedFifo_spsc_getSize_elems(cxa_fixedFifo_spsc_t *const fifoIn);
+
+/**
+ * @public
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the number of elements that can currently be queued
+ */
+size_t cxa_fixedFifo_spsc_getFreeSize_elems(cxa_fixedFifo_spsc_t *const fifoIn);
+
+/**
+ * @public
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the maximum number of the elements the FIFO can hold
+ */
+size_t cxa_fixedFifo_spsc_getMaxSize_elems(cxa_fixedFifo_spsc_t *const fifoIn);
+
+/**
+ * @public
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return true if the FIFO cannot hold any more elements
+ */
+bool cxa_fixedFifo_spsc_isFull(cxa_fixedFifo_spsc_t *const fifoIn);
+
+/**
+ * @public
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return true if the FIFO does not currently contain any elements
+ */
+bool cxa_fixedFifo_spsc_isEmpty(cxa_fixedFifo_spsc_t *const fifoIn);
+
+
+#endif // CXA_FIXED_FIFO_SPSC_H_
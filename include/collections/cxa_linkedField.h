@@ -69,15 +69,26 @@ struct cxa_fixedByteBuffer_linkedField
 {
 	cxa_fixedByteBuffer_t* parent;
 
+	cxa_linkedField_t* root;
 	cxa_linkedField_t* prev;
 	cxa_linkedField_t* next;
 
+	// cached (updated as fields in front of us change size)
 	size_t startIndex;
 
 	bool isFixedLength;
 	size_t maxFixedLength_bytes;
 
 	size_t currSize_bytes;
+
+	// only maintained in the root field (applies to the entire chain)
+	struct
+	{
+		cxa_linkedField_t* tail;
+		size_t fixedFieldsLen_bytes;
+		size_t numUnfilledFixedFields;
+		bool isBuilderMode;
+	}chain;
 };
 
 
@@ -88,6 +99,21 @@ bool cxa_linkedField_initRoot_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_fix
 bool cxa_linkedField_initChild(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn, const size_t initialSize_bytesIn);
 bool cxa_linkedField_initChild_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn, const size_t maxLen_bytesIn);
 
+/**
+ * @public
+ * @brief Enables/disables builder mode for the entire chain containing this field
+ *
+ * While in builder mode, the chain is append-only: bytes may only be appended
+ * to the last field in the chain (which must end at the end of the parent buffer)
+ * so no existing bytes are ever shifted. Inserts elsewhere and removes fail.
+ * Intended for the common construct-then-send case where fields are initialized
+ * and filled in order. Builder mode is cleared whenever the root is (re)initialized.
+ *
+ * @param[in] fbbLfIn any initialized field in the chain
+ * @param[in] isBuilderModeIn true to enter builder mode, false to allow arbitrary edits
+ */
+void cxa_linkedField_setBuilderMode(cxa_linkedField_t *const fbbLfIn, bool isBuilderModeIn);
+
 bool cxa_linkedField_append(cxa_linkedField_t *const fbbLfIn, uint8_t *const ptrIn, const size_t numBytesIn);
 bool cxa_linkedField_append_lengthPrefixedField_uint16BE(cxa_linkedField_t *const fbbLfIn, uint8_t *const ptrIn, const uint16_t numBytesIn);
 
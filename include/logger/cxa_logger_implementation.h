@@ -184,6 +184,38 @@
 #define cxa_logger_stepDebug_memDump(msgIn, ptrIn, lenIn)	cxa_logger_stepDebug_memDump_impl(__FILE__, __LINE__, (ptrIn), (lenIn), (msgIn))
 #define cxa_logger_stepDebug_memDump_fbb(msgIn, fbbIn)		cxa_logger_stepDebug_memDump_impl(__FILE__, __LINE__, cxa_fixedByteBuffer_get_pointerToIndex((fbbIn),0), cxa_fixedByteBuffer_getSize_bytes((fbbIn)), (msgIn))
 
+/**
+ * Define CXA_LOGGER_DEFERRED_ENABLE to move formatting and output off of the
+ * logging call. Log statements are captured (timestamp, logger, level, format
+ * pointer and raw arguments) into a fixed pool of records which are formatted
+ * and written (in batches) by a runLoop entry on CXA_LOGGER_DEFERRED_THREADID.
+ *
+ * @note format strings, prefixes and postfixes must be string literals (or otherwise
+ * 		outlive the flush). String arguments are copied.
+ */
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	#ifndef CXA_LOGGER_DEFERRED_NUM_RECORDS
+		// must be a power of two
+		#define CXA_LOGGER_DEFERRED_NUM_RECORDS					16
+	#endif
+
+	#ifndef CXA_LOGGER_DEFERRED_RECORD_PAYLOAD_SIZE_BYTES
+		#define CXA_LOGGER_DEFERRED_RECORD_PAYLOAD_SIZE_BYTES	48
+	#endif
+
+	#ifndef CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES
+		#define CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES		256
+	#endif
+
+	#ifndef CXA_LOGGER_DEFERRED_MAX_RECORDS_PER_FLUSH
+		#define CXA_LOGGER_DEFERRED_MAX_RECORDS_PER_FLUSH		8
+	#endif
+
+	#ifndef CXA_LOGGER_DEFERRED_THREADID
+		#define CXA_LOGGER_DEFERRED_THREADID					CXA_RUNLOOP_THREADID_DEFAULT
+	#endif
+#endif
+
 
 // ******** global type definitions *********
 
@@ -229,6 +261,25 @@ void cxa_logger_init_formattedString(cxa_logger_t *const loggerIn, const char *n
 cxa_logger_t* cxa_logger_getSysLog(void);
 
 
+/**
+ * @public
+ * @brief Formats and writes any log statements that have been captured
+ * 		but not yet output (eg. before a reset). Does nothing unless
+ * 		CXA_LOGGER_DEFERRED_ENABLE is defined.
+ */
+void cxa_logger_flush(void);
+
+/**
+ * @public
+ * @brief Returns the number of log statements that were discarded because
+ * 		the deferred record pool was full
+ *
+ * @return the number of dropped log statements (always 0 unless
+ * 		CXA_LOGGER_DEFERRED_ENABLE is defined)
+ */
+size_t cxa_logger_getNumDroppedLines(void);
+
+
 /**
  * @private
  */
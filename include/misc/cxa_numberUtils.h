@@ -35,8 +35,22 @@
 
 
 // ******** global function prototypes ********
+/**
+ * @public
+ * @brief Calculates the CRC-16/ARC (poly 0xA001 reflected, init 0x0000)
+ * 		of the given data. Table-driven unless CXA_NUMBERUTILS_CRC16_BITWISE
+ * 		is set to 1 (the table costs 512 bytes of flash to gain speed)
+ */
 uint16_t cxa_numberUtils_crc16_oneShot(void* dataIn, size_t dataLen_bytesIn);
 
+/**
+ * @public
+ * @brief Continues a CRC-16 calculation across a block of bytes. Start with
+ * 		a crcIn of 0; feeding data in pieces gives the same result as
+ * 		::cxa_numberUtils_crc16_oneShot over the whole
+ */
+uint16_t cxa_numberUtils_crc16_update(uint16_t crcIn, void* dataIn, size_t dataLen_bytesIn);
+
 uint16_t cxa_numberUtils_crc16_step(uint16_t crcIn, uint8_t byteIn);
 
 
@@ -13,6 +13,8 @@
 #include <cxa_ioStream.h>
 #include <cxa_logger_header.h>
 #include <cxa_mqtt_message.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_mqtt_topicTrie.h>
 #include <cxa_protocolParser_mqtt.h>
 #include <cxa_stateMachine.h>
 #include <cxa_timeDiff.h>
@@ -28,6 +30,63 @@
 	#define CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS			2
 #endif
 
+/**
+ * Number of nodes in the subscription topic trie (one per unique topic
+ * filter level across all subscriptions, plus one root node). The default
+ * allows 8 levels per subscription (eg. "v1/->/<node>/<child>/<method>/#"
+ * with unshared prefixes). Subscriptions that don't fit are refused by
+ * ::cxa_mqtt_client_subscribe.
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES
+	#define CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES		((CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS * 8) + 1)
+#endif
+
+/**
+ * Number of factory messages the protocol parser receives into. With
+ * CXA_PROTOCOLPARSER_RXPOOL_ENABLE, a subscriber may keep a received
+ * message (via cxa_mqtt_messageFactory_incrementMessageRefCount) and the
+ * client keeps receiving into the next one until it is dereferenced.
+ * Without it, received messages must not be kept past the callback.
+ */
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	#ifndef CXA_MQTT_CLIENT_NUM_RX_MESSAGES
+		#define CXA_MQTT_CLIENT_NUM_RX_MESSAGES				2
+	#endif
+	#if (CXA_MQTT_CLIENT_NUM_RX_MESSAGES < 1) || (CXA_MQTT_CLIENT_NUM_RX_MESSAGES > CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS)
+		#error "CXA_MQTT_CLIENT_NUM_RX_MESSAGES must be at least 1 and at most CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS"
+	#endif
+#else
+	#define CXA_MQTT_CLIENT_NUM_RX_MESSAGES					1
+#endif
+
+/**
+ * Maximum number of outgoing QOS1/QOS2 messages awaiting acknowledgment.
+ * Each in-flight PUBLISH holds a reference to its message until it is
+ * acknowledged so, together with the messages the protocol parser receives
+ * into, it must fit in CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES. One message is
+ * always left over for control traffic (CONNECT, SUBSCRIBE, QOS0 publishes):
+ * without it, a client that lost its connection with a full window could
+ * never reconnect to have the window acknowledged.
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_INFLIGHT
+	#define CXA_MQTT_CLIENT_MAXNUM_INFLIGHT				(CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES - CXA_MQTT_CLIENT_NUM_RX_MESSAGES - 1)
+#endif
+#if (CXA_MQTT_CLIENT_MAXNUM_INFLIGHT < 1) || ((CXA_MQTT_CLIENT_MAXNUM_INFLIGHT + CXA_MQTT_CLIENT_NUM_RX_MESSAGES + 1) > CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES)
+	#error "CXA_MQTT_CLIENT_MAXNUM_INFLIGHT must be at least 1 and leave CXA_MQTT_CLIENT_NUM_RX_MESSAGES (plus one control message) of CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES"
+#endif
+
+/**
+ * Maximum number of incoming QOS2 messages that have been received but not
+ * yet released (used to suppress duplicate deliveries)
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2
+	#define CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2			2
+#endif
+
+#ifndef CXA_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS
+	#define CXA_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS			10000
+#endif
+
 
 #ifndef CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES
 	#define CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES		72
@@ -97,7 +156,13 @@ typedef enum
 /**
  * @private
  */
-typedef struct
+typedef struct cxa_mqtt_client_subscriptionEntry cxa_mqtt_client_subscriptionEntry_t;
+
+
+/**
+ * @private
+ */
+struct cxa_mqtt_client_subscriptionEntry
 {
 	uint16_t packetId;
 	cxa_mqtt_client_subscriptionState_t state;
@@ -107,7 +172,36 @@ typedef struct
 	cxa_mqtt_client_cb_onPublish_t cb_onPublish;
 
 	void* userVar;
-}cxa_mqtt_client_subscriptionEntry_t;
+
+	// used to chain matching subscriptions while dispatching a PUBLISH
+	cxa_mqtt_client_subscriptionEntry_t* nextMatch;
+};
+
+
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE,
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK,
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC,
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP
+}cxa_mqtt_client_inFlightState_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_mqtt_client_inFlightState_t state;
+	uint16_t packetId;
+
+	// only valid while awaiting PUBACK / PUBREC
+	cxa_mqtt_message_t* msg;
+	cxa_timeDiff_t td_retransmit;
+}cxa_mqtt_client_inFlightEntry_t;
 
 
 /**
@@ -123,6 +217,23 @@ struct cxa_mqtt_client
 	cxa_array_t subscriptions;
 	cxa_mqtt_client_subscriptionEntry_t subscriptions_raw[CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS];
 
+	cxa_mqtt_topicTrie_t subscriptionTrie;
+	cxa_mqtt_topicTrie_node_t subscriptionTrie_nodes[CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES];
+	cxa_mqtt_topicTrie_value_t subscriptionTrie_values[CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS];
+
+	// slots are independent of packetId (looked up by search)
+	cxa_mqtt_client_inFlightEntry_t inFlight[CXA_MQTT_CLIENT_MAXNUM_INFLIGHT];
+
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	// messages our protocol parser receives into (and whether a subscriber still holds them)
+	cxa_mqtt_message_t* rxMsgs[CXA_MQTT_CLIENT_NUM_RX_MESSAGES];
+	bool rxMsgs_isRetained[CXA_MQTT_CLIENT_NUM_RX_MESSAGES];
+#endif
+
+	// packetIds of received QOS2 messages awaiting PUBREL (0 is unused)
+	uint16_t inboundQos2PacketIds[CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2];
+	size_t inboundQos2NextIndex;
+
 	int threadId;
 
 	cxa_stateMachine_t stateMachine;
@@ -135,6 +246,7 @@ struct cxa_mqtt_client
 	uint16_t keepAliveTimeout_s;
 	char* clientId;
 	uint16_t currPacketId;
+	bool cleanSession;
 
 	struct{
 		cxa_mqtt_qosLevel_t qos;
@@ -163,15 +275,66 @@ void cxa_mqtt_client_addListener(cxa_mqtt_client_t *const clientIn,
 								 cxa_mqtt_client_cb_onActivity_t cb_onActivityIn,
 								 void *const userVarIn);
 
+/**
+ * @public
+ * @brief Sets whether the server should discard session state on the next connect
+ *
+ * Defaults to true. When false, the server will retain our subscriptions and
+ * in-flight QOS2 state across connections (required for exactly-once delivery
+ * across a reconnect).
+ *
+ * @param[in] clientIn the pre-initialized client
+ * @param[in] cleanSessionIn true to request a clean session
+ */
+void cxa_mqtt_client_setCleanSession(cxa_mqtt_client_t *const clientIn, bool cleanSessionIn);
+
 bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const usernameIn, uint8_t *const passwordIn, uint16_t passwordLen_bytesIn);
 bool cxa_mqtt_client_isConnected(cxa_mqtt_client_t *const clientIn);
 void cxa_mqtt_client_disconnect(cxa_mqtt_client_t *const clientIn);
 
 bool cxa_mqtt_client_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
 							 char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn);
+/**
+ * @public
+ * @brief Publishes a pre-initialized PUBLISH message
+ *
+ * For QOS1 and QOS2 messages, the client assigns the packet id and holds a
+ * reference to the message until delivery completes. The message will be
+ * retransmitted (with the DUP flag set) if it is not acknowledged within
+ * CXA_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS and replayed upon reconnection.
+ * The caller must not modify the message after publishing it at QOS > 0.
+ *
+ * @param[in] clientIn the pre-initialized client
+ * @param[in] msgIn the PUBLISH message to send
+ *
+ * @return true if the message was sent (QOS0) or accepted for delivery (QOS1/2),
+ * 		false if not connected or the in-flight window is full
+ */
 bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
 
-void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn);
+/**
+ * @public
+ * @return the number of QOS1/QOS2 messages currently awaiting acknowledgment
+ */
+size_t cxa_mqtt_client_getNumInFlight(cxa_mqtt_client_t *const clientIn);
+
+/**
+ * @public
+ * @brief Subscribes to the given topic filter
+ *
+ * Subscriptions made while disconnected are sent upon connection.
+ *
+ * @param[in] clientIn the pre-initialized client
+ * @param[in] topicFilterIn the topic filter (may contain '+' and '#' wildcards)
+ * @param[in] qosIn the maximum QOS at which to receive matching messages
+ * @param[in] cb_onPublishIn callback for each matching PUBLISH message
+ * @param[in] userVarIn user variable passed to the callback
+ *
+ * @return true if subscribed (or already subscribed), false if the topic filter
+ * 		is malformed or too long, or there is no room for it (see
+ * 		CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS and CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES)
+ */
+bool cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn);
 
 
 /**
@@ -15,27 +15,95 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Messages are allocated from up to three size classes. Requests are served
+ * from the smallest class that fits (falling back to larger classes when
+ * exhausted). The large class is used by ::cxa_mqtt_messageFactory_getFreeMessage_empty
+ * and must contain at least one message. Set a class's count to 0 to disable it.
+ *
+ * An MQTT client needs at least three large messages: one to receive into,
+ * one in-flight QOS1/QOS2 publish and one for control traffic
+ * (see CXA_MQTT_CLIENT_MAXNUM_INFLIGHT).
+ */
 #ifndef CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES
-	#define CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES			2
+	#define CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES			3
 #endif
 
 #ifndef CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES
 	#define CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES		64
 #endif
 
+#ifndef CXA_MQTT_MESSAGEFACTORY_NUM_MEDIUM_MESSAGES
+	#define CXA_MQTT_MESSAGEFACTORY_NUM_MEDIUM_MESSAGES		0
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES	32
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_NUM_SMALL_MESSAGES
+	#define CXA_MQTT_MESSAGEFACTORY_NUM_SMALL_MESSAGES		2
+#endif
+
+// large enough for PINGREQ, PUBACK, PUBREC, PUBREL, PUBCOMP
+#ifndef CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES	8
+#endif
+
+/**
+ * Bytes reserved in front of each medium and large message (in addition to
+ * the message size) so topic segments can be prepended without moving the
+ * rest of the message (see ::cxa_fixedByteBuffer_init_withHeadroom). Size
+ * this to the longest prefix typically added while routing a message
+ * (eg. RPC node paths). Set to 0 to disable.
+ */
+#ifndef CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES			32
+#endif
+
 
 // ******** global type definitions *********
 
 
 // ******** global function prototypes ********
 size_t cxa_mqtt_messageFactory_getNumFreeMessages(void);
+
+/**
+ * @public
+ * @brief Reserves a message from the large size class
+ *
+ * @return the reserved message (reference count of 1) or NULL if none are available
+ */
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_empty(void);
 
+/**
+ * @public
+ * @brief Reserves a message from the smallest size class that can hold
+ * 		the requested number of bytes
+ *
+ * @param[in] minSize_bytesIn the minimum buffer size required
+ *
+ * @return the reserved message (reference count of 1) or NULL if none are available
+ */
+cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_sized(size_t minSize_bytesIn);
+
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffer_t *const fbbIn);
 
 void cxa_mqtt_messageFactory_incrementMessageRefCount(cxa_mqtt_message_t *const msgIn);
 void cxa_mqtt_messageFactory_decrementMessageRefCount(cxa_mqtt_message_t *const msgIn);
 uint8_t cxa_mqtt_messageFactory_getReferenceCountForMessage(cxa_mqtt_message_t *const msgIn);
 
+/**
+ * @public
+ * @return the maximum number of messages that have been reserved simultaneously
+ */
+size_t cxa_mqtt_messageFactory_getHighWaterMark(void);
+
+/**
+ * @public
+ * @return the number of reservations that failed because no suitable message was free
+ */
+size_t cxa_mqtt_messageFactory_getNumFailedAllocations(void);
+
 
 #endif /* CXA_MQTT_MESSAGEFACTORY_H_ */
@@ -0,0 +1,174 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_MQTT_TOPICTRIE_H_
+#define CXA_MQTT_TOPICTRIE_H_
+
+
+/**
+ * @file
+ * A statically-allocated trie of MQTT topic filters, keyed by topic level.
+ * Matching a topic visits one trie level per topic level (plus any '+'
+ * branches) rather than comparing the topic against every filter.
+ *
+ * Topics are matched in-place as length-delimited strings (they do not
+ * need to be null-terminated, and are not modified).
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_mqtt_topicTrie_t trie;
+ * cxa_mqtt_topicTrie_node_t trie_nodes[16];
+ * cxa_mqtt_topicTrie_value_t trie_values[4];
+ *
+ * cxa_mqtt_topicTrie_initStd(&trie, trie_nodes, trie_values);
+ * cxa_mqtt_topicTrie_add(&trie, "sensors/+/temp", (void*)&myHandler);
+ *
+ * ...
+ *
+ * cxa_mqtt_topicTrie_match(&trie, topicName, topicNameLen_bytes, cb_onMatch, NULL);
+ * @endcode
+ */
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// ******** global macro definitions ********
+/**
+ * @public
+ * @brief Shortcut to initialize a trie with c-style arrays for storage
+ */
+#define cxa_mqtt_topicTrie_initStd(trieIn, nodesIn, valuesIn)			cxa_mqtt_topicTrie_init((trieIn), (nodesIn), (sizeof(nodesIn)/sizeof(*(nodesIn))), (valuesIn), (sizeof(valuesIn)/sizeof(*(valuesIn))))
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_mqtt_topicTrie_t object
+ */
+typedef struct cxa_mqtt_topicTrie cxa_mqtt_topicTrie_t;
+
+
+/**
+ * @public
+ * @brief Callback called for each value whose filter matches a topic
+ *
+ * @param[in] valueIn the value supplied to ::cxa_mqtt_topicTrie_add
+ * @param[in] userVarIn the user variable supplied to ::cxa_mqtt_topicTrie_match
+ */
+typedef void (*cxa_mqtt_topicTrie_cb_onMatch_t)(void *const valueIn, void *const userVarIn);
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	// points into the filter string supplied to ::cxa_mqtt_topicTrie_add
+	const char* level;
+	uint16_t levelLen_bytes;
+
+	int16_t firstChild;
+	int16_t nextSibling;
+	int16_t plusChild;
+	int16_t hashChild;
+
+	int16_t firstValue;
+}cxa_mqtt_topicTrie_node_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	void* value;
+	int16_t next;
+}cxa_mqtt_topicTrie_value_t;
+
+
+/**
+ * @private
+ */
+struct cxa_mqtt_topicTrie
+{
+	cxa_mqtt_topicTrie_node_t* nodes;
+	size_t maxNumNodes;
+	size_t numNodes;
+
+	cxa_mqtt_topicTrie_value_t* values;
+	size_t maxNumValues;
+	size_t numValues;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the trie using the provided storage
+ *
+ * @param[in] trieIn pointer to the trie to initialize
+ * @param[in] nodesIn storage for the nodes of the trie (one per unique filter level, plus a root)
+ * @param[in] maxNumNodesIn the number of elements in nodesIn
+ * @param[in] valuesIn storage for the values of the trie (one per added filter)
+ * @param[in] maxNumValuesIn the number of elements in valuesIn
+ */
+void cxa_mqtt_topicTrie_init(cxa_mqtt_topicTrie_t *const trieIn,
+							 cxa_mqtt_topicTrie_node_t *const nodesIn, size_t maxNumNodesIn,
+							 cxa_mqtt_topicTrie_value_t *const valuesIn, size_t maxNumValuesIn);
+
+
+/**
+ * @public
+ * @brief Removes all filters from the trie
+ *
+ * @param[in] trieIn pointer to the pre-initialized trie
+ */
+void cxa_mqtt_topicTrie_clear(cxa_mqtt_topicTrie_t *const trieIn);
+
+
+/**
+ * @public
+ * @brief Adds a filter to the trie
+ *
+ * The trie references the filter string directly so it must remain valid
+ * (and unchanged) for the lifetime of the trie.
+ *
+ * @param[in] trieIn pointer to the pre-initialized trie
+ * @param[in] filterIn null-terminated topic filter (may contain '+' and '#' wildcards)
+ * @param[in] valueIn value passed to the match callback when this filter matches
+ *
+ * @return true on success, false if the filter is malformed or the trie
+ * 		doesn't have enough free nodes/values for it (the trie is unchanged)
+ */
+bool cxa_mqtt_topicTrie_add(cxa_mqtt_topicTrie_t *const trieIn, const char *const filterIn, void *const valueIn);
+
+
+/**
+ * @public
+ * @brief Calls the provided callback for every value whose filter matches
+ * 		the given topic
+ *
+ * Per the MQTT specification, topics beginning with '$' are not matched by
+ * filters beginning with a wildcard.
+ *
+ * @param[in] trieIn pointer to the pre-initialized trie
+ * @param[in] topicIn the topic name (need not be null-terminated)
+ * @param[in] topicLen_bytesIn the length of the topic name
+ * @param[in] cbIn callback called for each match
+ * @param[in] userVarIn user variable passed to the callback
+ *
+ * @return the number of matches
+ */
+size_t cxa_mqtt_topicTrie_match(cxa_mqtt_topicTrie_t *const trieIn, const char *const topicIn, size_t topicLen_bytesIn,
+								cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn);
+
+
+#endif /* CXA_MQTT_TOPICTRIE_H_ */
@@ -25,6 +25,10 @@ typedef enum
 	CXA_MQTT_MSGTYPE_CONNECT=1,
 	CXA_MQTT_MSGTYPE_CONNACK=2,
 	CXA_MQTT_MSGTYPE_PUBLISH=3,
+	CXA_MQTT_MSGTYPE_PUBACK=4,
+	CXA_MQTT_MSGTYPE_PUBREC=5,
+	CXA_MQTT_MSGTYPE_PUBREL=6,
+	CXA_MQTT_MSGTYPE_PUBCOMP=7,
 	CXA_MQTT_MSGTYPE_SUBSCRIBE=8,
 	CXA_MQTT_MSGTYPE_SUBACK=9,
 	CXA_MQTT_MSGTYPE_PINGREQ=12,
@@ -36,8 +40,8 @@ typedef enum
 typedef enum
 {
 	CXA_MQTT_QOS_ATMOST_ONCE=0,
-	//CXA_MQTT_QOS_ATLEAST_ONCE=1, -- not supported
-	//CXA_MQTT_QOS_EXACTLY_ONCE=2 -- not supported
+	CXA_MQTT_QOS_ATLEAST_ONCE=1,
+	CXA_MQTT_QOS_EXACTLY_ONCE=2
 }cxa_mqtt_qosLevel_t;
 
 
@@ -89,6 +93,12 @@ struct cxa_mqtt_message
 		cxa_linkedField_t field_packetId;
 		cxa_linkedField_t field_payload;
 	}fields_publish;
+
+	// shared by PUBACK, PUBREC, PUBREL, and PUBCOMP
+	struct
+	{
+		cxa_linkedField_t field_packetId;
+	}fields_publishResponse;
 };
 
 
@@ -0,0 +1,32 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_MQTT_MESSAGE_PUB_REL_H_
+#define CXA_MQTT_MESSAGE_PUB_REL_H_
+
+
+// ******** includes ********
+#include <cxa_mqtt_message.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+
+
+// ******** global function prototypes ********
+bool cxa_mqtt_message_pubrel_init(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn);
+
+bool cxa_mqtt_message_pubrel_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut);
+
+
+/**
+ * @protected
+ */
+bool cxa_mqtt_message_pubrel_validateReceivedBytes(cxa_mqtt_message_t *const msgIn);
+
+#endif /* CXA_MQTT_MESSAGE_PUB_REL_H_ */
@@ -31,12 +31,22 @@
 	#define CXA_MQTT_RPCNODE_MAXLEN_NAME_BYTES			32
 #endif
 
+// fully-qualified path from the local root (eg. "root/subNode/node")
+#ifndef CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES
+	#define CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES			64
+#endif
+
 #ifndef CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES
 	#define CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES			24
 #endif
 
+// shared by all nodes (request ids are unique across the local tree)
 #ifndef CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS
-	#define CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS		2
+	#define CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS		32
+#endif
+
+#ifndef CXA_MQTT_RPCNODE_REQUEST_TIMEOUT_MS
+	#define CXA_MQTT_RPCNODE_REQUEST_TIMEOUT_MS			3000
 #endif
 
 #define CXA_MQTT_RPC_VERSION								"v1"
@@ -45,6 +55,8 @@
 #define CXA_MQTT_RPCNODE_RESP_PREFIX						"<-"
 #define CXA_MQTT_RPCNODE_NOTI_PREFIX						"^^"
 #define CXA_MQTT_RPCNODE_CONNSTATE_STREAM_NAME			"upstreamConnState"
+#define CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_CONN			"{\"value_num\":1}"
+#define CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_DISCONN		"{\"value_num\":0}"
 
 
 // ******** global type definitions *********
@@ -121,10 +133,20 @@ typedef struct
  */
 typedef struct
 {
-	char name[CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES];
-	char id[5];
+	cxa_mqtt_rpc_node_t* node;
+	uint16_t id;
+
+	// responses echo the request topic...the id alone isn't unique across devices
+	char methodName[CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES];
+	uint16_t pathCrc;
+
+	cxa_timeDiff_t td_sent;
+	uint32_t timeout_ms;
 
-	cxa_timeDiff_t td_timeout;
+	// indices into the in-flight table (chained by hash bucket, ordered by deadline)
+	uint16_t nextInBucket;
+	uint16_t prevByDeadline;
+	uint16_t nextByDeadline;
 
 	cxa_mqtt_rpc_cb_methodResponse_t cb;
 	void *userVar;
@@ -139,15 +161,17 @@ struct cxa_mqtt_rpc_node
 	cxa_mqtt_rpc_node_t* parentNode;
 	char name[CXA_MQTT_RPCNODE_MAXLEN_NAME_BYTES];
 
+	// cached at init so topics don't need to be built by walking the tree
+	char path[CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES];
+	size_t pathLen_bytes;
+	size_t localPathStartIndex;
+
 	cxa_array_t subNodes;
 	cxa_mqtt_rpc_node_t* subNodes_raw[CXA_MQTT_RPCNODE_MAXNUM_SUBNODES];
 
 	cxa_array_t methods;
 	cxa_mqtt_rpc_node_methodEntry_t methods_raw[CXA_MQTT_RPCNODE_MAXNUM_METHODS];
 
-	cxa_array_t outstandingRequests;
-	cxa_mqtt_rpc_node_outstandingRequest_t outstandingRequests_raw[CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS];
-
 	cxa_mqtt_rpc_node_scm_handleMessage_upstream_t scm_handleMessage_upstream;
 	cxa_mqtt_rpc_node_scm_handleMessage_downstream_t scm_handleMessage_downstream;
 	cxa_mqtt_rpc_node_scm_getClient_t scm_getClient;
@@ -188,12 +212,45 @@ void cxa_mqtt_rpc_node_addMethod(cxa_mqtt_rpc_node_t *const nodeIn, char *const
 
 /**
  * @public
+ * @brief Sends a request to the given method without blocking. If
+ * 		a callback is provided, it is called once the response arrives
+ * 		or after CXA_MQTT_RPCNODE_REQUEST_TIMEOUT_MS
+ * 		(with CXA_MQTT_RPC_METHODRETVAL_FAIL_TIMEOUT)
+ *
+ * @return true if the request was sent
  */
 bool cxa_mqtt_rpc_node_executeMethod(cxa_mqtt_rpc_node_t *const nodeIn,
 									 char *const methodNameIn, char *const pathToNodeIn, cxa_fixedByteBuffer_t *const paramsIn,
 									 cxa_mqtt_rpc_cb_methodResponse_t responseCbIn, void* userVarIn);
 
 
+/**
+ * @public
+ * @brief Same as cxa_mqtt_rpc_node_executeMethod but with a per-request
+ * 		timeout. Up to CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS requests
+ * 		may be in flight at once
+ *
+ * @param requestIdOut optional, receives the id of the request
+ * 		(for use with cxa_mqtt_rpc_node_cancelRequest)
+ *
+ * @return true if the request was sent
+ */
+bool cxa_mqtt_rpc_node_executeMethod_withTimeout(cxa_mqtt_rpc_node_t *const nodeIn,
+												 char *const methodNameIn, char *const pathToNodeIn, cxa_fixedByteBuffer_t *const paramsIn,
+												 uint32_t timeout_msIn, cxa_mqtt_rpc_cb_methodResponse_t responseCbIn, void* userVarIn,
+												 uint16_t *const requestIdOut);
+
+
+/**
+ * @public
+ * @brief Forgets an outstanding request sent by this node. Its
+ * 		callback will not be called
+ *
+ * @return true if the request was outstanding
+ */
+bool cxa_mqtt_rpc_node_cancelRequest(cxa_mqtt_rpc_node_t *const nodeIn, uint16_t requestIdIn);
+
+
 /**
  * @public
  */
@@ -209,4 +266,12 @@ bool cxa_mqtt_rpc_node_publishNotification_appendSubTopic(cxa_mqtt_rpc_node_t *c
 cxa_mqtt_client_t* cxa_mqtt_rpc_node_getClient(cxa_mqtt_rpc_node_t *const nodeIn);
 
 
+/**
+ * @protected
+ * @brief Prepends the local-root-relative path of this node (eg. "~/subNode/node/")
+ * 		to the topic of the given publish message
+ */
+bool cxa_mqtt_rpc_node_prependLocalPathToTopic(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_message_t *const msgIn);
+
+
 #endif // CXA_MQTT_RPC_NODE_H_
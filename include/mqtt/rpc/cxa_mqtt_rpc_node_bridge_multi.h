@@ -23,6 +23,11 @@
 	#define CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES			4
 #endif
 
+// must be a power of 2
+#ifndef CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS
+	#define CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS			8
+#endif
+
 
 // ******** global type definitions *********
 typedef struct cxa_mqtt_rpc_node_bridge_multi cxa_mqtt_rpc_node_bridge_multi_t;
@@ -33,13 +38,34 @@ typedef cxa_mqtt_rpc_node_bridge_authorization_t (*cxa_mqtt_rpc_node_bridge_mult
 																											char* provisionedNameOut, size_t maxProvisionedNameLen_bytesIn,
 																											void *userVarIn);
 
+/**
+ * @public
+ * @brief Routing statistics for a single remote node (see ::cxa_mqtt_rpc_node_bridge_multi_getRouteStats)
+ */
+typedef struct
+{
+	const char* clientId;
+	const char* mappedName;
+
+	uint32_t numMessages;
+	uint32_t numBytes;
+}cxa_mqtt_rpc_node_bridge_multi_routeStats_t;
+
+
 /**
  * @private
  */
 typedef struct
 {
 	char clientId[CXA_MQTT_RPC_NODE_BRIDGE_CLIENTID_MAXLEN_BYTES];
+	uint8_t clientIdLen_bytes;
 	char mappedName[CXA_MQTT_RPC_NODE_BRIDGE_MAPPEDNAME_MAXLEN_BYTES];
+
+	bool isUsed;
+	int16_t next;								// next in bucket (or next free)
+
+	uint32_t numMessages;
+	uint32_t numBytes;
 }cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t;
 
 
@@ -50,8 +76,13 @@ struct cxa_mqtt_rpc_node_bridge_multi
 {
 	cxa_mqtt_rpc_node_bridge_t super;
 
-	cxa_array_t remoteNodes;
-	cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t remoteNodes_raw[CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES];
+	// hashed by clientId (chained through the entries themselves)
+	cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t remoteNodes[CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES];
+	int16_t routeBuckets[CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS];
+	int16_t firstFreeRemoteNode;
+	size_t numRemoteNodes;
+
+	uint32_t numUnroutableMessages;
 
 	cxa_mqtt_rpc_node_bridge_multi_cb_authenticateClient_t cb_localAuth;
 	void* localAuthUserVar;
@@ -68,4 +99,45 @@ void cxa_mqtt_rpc_node_bridge_multi_setAuthCb(cxa_mqtt_rpc_node_bridge_multi_t *
 size_t cxa_mqtt_rpc_node_bridge_multi_getNumRemoteNodes(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn);
 void cxa_mqtt_rpc_node_bridge_multi_clearRemoteNodes(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn);
 
+/**
+ * @public
+ * @brief Removes the route for a remote node which has disconnected
+ *
+ * This is done automatically when the remote node's connection state
+ * stream (::CXA_MQTT_RPCNODE_CONNSTATE_STREAM_NAME, normally its last-will)
+ * reports that it has disconnected. Call this directly if the transport
+ * detects the disconnect some other way.
+ *
+ * @param[in] nodeIn pointer to the pre-initialized bridge
+ * @param[in] clientIdIn the clientId with which the remote node connected
+ *
+ * @return true if the remote node was found (and removed)
+ */
+bool cxa_mqtt_rpc_node_bridge_multi_removeRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn);
+
+/**
+ * @public
+ * @brief Retrieves the routing statistics for a remote node
+ *
+ * @param[in] nodeIn pointer to the pre-initialized bridge
+ * @param[in] indexIn index of the remote node (0 to ::cxa_mqtt_rpc_node_bridge_multi_getNumRemoteNodes - 1)
+ * @param[out] statsOut the statistics for the remote node
+ *
+ * @return true if the index was valid and statsOut was populated
+ */
+bool cxa_mqtt_rpc_node_bridge_multi_getRouteStats(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, size_t indexIn, cxa_mqtt_rpc_node_bridge_multi_routeStats_t *const statsOut);
+
+/**
+ * @public
+ * @return the number of upstream messages which were dropped because they
+ * 		didn't match a connected remote node
+ */
+uint32_t cxa_mqtt_rpc_node_bridge_multi_getNumUnroutableMessages(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn);
+
+/**
+ * @public
+ * @brief Resets the counters of all routes (and the unroutable message count)
+ */
+void cxa_mqtt_rpc_node_bridge_multi_resetRouteStats(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn);
+
 #endif // CXA_MQTT_RPC_NODEBRIDGE_MULTI_H_
@@ -0,0 +1,49 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_MQTT_RPC_NODE_RUNLOOPPROFILER_H_
+#define CXA_MQTT_RPC_NODE_RUNLOOPPROFILER_H_
+
+
+/**
+ * @file
+ * An RPC node ("runLoop") exposing the runLoop entry statistics gathered when
+ * CXA_RUNLOOP_PROFILER_ENABLE is defined. Methods:
+ *
+ * "getStats": returns one line per entry (see cxa_runLoop_profiler.h),
+ * 		truncated to the size of the response
+ * "resetStats": clears the statistics of all entries
+ */
+
+
+// ******** includes ********
+#include <cxa_mqtt_rpc_node.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct cxa_mqtt_rpc_node_runLoopProfiler cxa_mqtt_rpc_node_runLoopProfiler_t;
+
+
+/**
+ * @private
+ */
+struct cxa_mqtt_rpc_node_runLoopProfiler
+{
+	cxa_mqtt_rpc_node_t super;
+};
+
+
+// ******** global function prototypes ********
+void cxa_mqtt_rpc_node_runLoopProfiler_init(cxa_mqtt_rpc_node_runLoopProfiler_t *const nodeIn, cxa_mqtt_rpc_node_t *const parentNodeIn);
+
+
+#endif
@@ -13,6 +13,7 @@
 #include <cxa_array.h>
 #include <cxa_fixedByteBuffer.h>
 #include <cxa_ioStream.h>
+#include <cxa_ioStream_buffered.h>
 #include <cxa_ioStream_nullablePassthrough.h>
 #include <cxa_logger_header.h>
 #include <cxa_network_tcpClient.h>
@@ -31,10 +32,39 @@
 #define CXA_NETWORK_HTTPCLIENT_HOSTNAME_MAX_LEN_BYTES	64
 #endif
 
-#ifndef CXA_NETWORK_HTTPCLIENT_RESPONSE_LINE_BUFFERLEN_BYTES
+#ifndef CXA_NETWORK_HTTPCLIENT_HEADER_LINE_BUFFERLEN_BYTES
 #define CXA_NETWORK_HTTPCLIENT_HEADER_LINE_BUFFERLEN_BYTES		92
 #endif
 
+#ifndef CXA_NETWORK_HTTPCLIENT_TX_BUFFERLEN_BYTES
+#define CXA_NETWORK_HTTPCLIENT_TX_BUFFERLEN_BYTES		128
+#endif
+
+/**
+ * Chunked request bodies are collected into chunks of (up to) this size so
+ * that many small writes from the body generator don't each carry their own
+ * chunk header
+ */
+#ifndef CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES
+#define CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES		256
+#endif
+
+/**
+ * Number of persistent (keep-alive) connections kept per client. Each
+ * connection reserves its own tcpClient from the network factory (if the
+ * factory runs out, the client makes do with fewer).
+ */
+#ifndef CXA_NETWORK_HTTPCLIENT_MAXNUM_CONNECTIONS
+#define CXA_NETWORK_HTTPCLIENT_MAXNUM_CONNECTIONS		2
+#endif
+
+/**
+ * Pooled connections which sit idle longer than this are closed
+ */
+#ifndef CXA_NETWORK_HTTPCLIENT_KEEPALIVE_TIMEOUT_MS
+#define CXA_NETWORK_HTTPCLIENT_KEEPALIVE_TIMEOUT_MS		30000
+#endif
+
 
 // ******** global type definitions *********
 /**
@@ -44,6 +74,17 @@
 typedef struct cxa_network_httpClient cxa_network_httpClient_t;
 
 
+/**
+ * @public
+ */
+typedef enum
+{
+	CXA_NETWORK_HTTPCLIENT_METHOD_GET,
+	CXA_NETWORK_HTTPCLIENT_METHOD_PUT,
+	CXA_NETWORK_HTTPCLIENT_METHOD_POST,
+}cxa_network_httpClient_method_t;
+
+
 /**
  * @public
  * Callback that is called periodically once a transaction is initiated and
@@ -68,15 +109,20 @@ typedef bool (*cxa_network_httpClient_cb_asyncGenHeaders_t)(cxa_network_httpClie
 
 /**
  * @public
- * Callback that is called periodically once `cxa_network_httpClient_post_async` is initiated
- * and a connection to the server is established. This function should be used to generate the
- * body of the message. Due to the possible length of the message and buffering concerns, this
- * function streams the body to the server in real-time via the provided ioStream. For large
+ * Callback that is called periodically once `cxa_network_httpClient_post_async` (or
+ * `cxa_network_httpClient_request_async`) is initiated and a connection to the server is
+ * established. This function should be used to generate the body of the message. Due to the
+ * possible length of the message and buffering concerns, this function streams the body to the server in real-time via the provided ioStream. For large
  * messages, the body should be broken into smaller chunks and sent one-at-a-time. After each
  * chunk is sent to the ioStream, return `true` from this function to allow other tasks processor
  * time. This function will continue to be called periodically until either the server closes the
  * connection or this function returns false
  *
+ * Unless the body is sent chunked, this function is called through the entire body twice:
+ * once to calculate the Content-Length and again to actually send the body. When sending
+ * chunked, it is only called once and writes are collected into chunks of up to
+ * CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES (larger writes are sent as a chunk of their own).
+ *
  * @param clientIn the client performing the post operation
  * @param iosIn the ioStream which is presently connected to the server
  * @param userVarIn the previously-provided user variable
@@ -89,6 +135,24 @@ typedef bool (*cxa_network_httpClient_cb_postAsyncGenBody_t)(cxa_network_httpCli
 															 void* userVarIn);
 
 
+/**
+ * @public
+ * Callback that is called as the body of the response is received (if provided, the
+ * response body is streamed through this callback rather than collected in the
+ * response body buffer). Chunked responses are de-chunked before reaching this callback.
+ *
+ * @param clientIn the client performing the request
+ * @param statusIn the HTTP status code of the response
+ * @param dataIn the next bytes of the response body. Points directly into the receive
+ * 			buffer...only valid for the duration of this call
+ * @param dataLen_bytesIn the number of bytes at dataIn
+ * @param userVarIn the previously-provided user variable
+ */
+typedef void (*cxa_network_httpClient_cb_onResponseData_t)(cxa_network_httpClient_t *const clientIn,
+														   uint16_t statusIn, uint8_t *const dataIn, size_t dataLen_bytesIn,
+														   void* userVarIn);
+
+
 /**
  * @public
  * Callback that is called once `cxa_network_httpClient_post_async` is initiated. This function
@@ -99,7 +163,8 @@ typedef bool (*cxa_network_httpClient_cb_postAsyncGenBody_t)(cxa_network_httpCli
  * 			false (and all data being sent/received successfully). False if the connection was closed
  * 			before the operation could complete.
  * @param statusIn the HTTP status code (valid if 'didCompleteSuccesssfully' is true)
- * @param bodyIn the body of the response (valid if 'didCompleteSuccesssfully' is true)
+ * @param bodyIn the body of the response (valid if 'didCompleteSuccesssfully' is true, NULL
+ * 			if the body was streamed or discarded)
  * @param bodySize_bytesIn number of bytes in the body (valid if 'didCompleteSuccesssfully' is true)
  */
 typedef void (*cxa_network_httpClient_cb_onPostComplete_t)(cxa_network_httpClient_t *const clientIn,
@@ -110,36 +175,74 @@ typedef void (*cxa_network_httpClient_cb_onPostComplete_t)(cxa_network_httpClien
 
 /**
  * @private
+ * A single (possibly persistent) connection to a server
  */
-struct cxa_network_httpClient
+typedef struct
 {
+	cxa_network_httpClient_t* parent;
 	cxa_network_tcpClient_t* tcpClient;
 
+	char hostname[CXA_NETWORK_HTTPCLIENT_HOSTNAME_MAX_LEN_BYTES+1];
+	uint16_t portNum;
+	bool useTls;
+
+	// true if the server will keep the connection open after the current response
+	bool isReusable;
+	cxa_timeDiff_t td_idle;
+
+	cxa_fixedByteBuffer_t headerLineBuffer;
+	uint8_t headerLineBuffer_raw[CXA_NETWORK_HTTPCLIENT_HEADER_LINE_BUFFERLEN_BYTES];
+	cxa_protocolParser_crlf_t headerLineParser;
+}cxa_network_httpClient_connection_t;
+
+
+/**
+ * @private
+ */
+struct cxa_network_httpClient
+{
+	cxa_network_httpClient_connection_t connections[CXA_NETWORK_HTTPCLIENT_MAXNUM_CONNECTIONS];
+	size_t numConnections;
+	cxa_network_httpClient_connection_t* currConnection;
+	bool isCurrConnectionReused;
+	bool hasRetried;
+	bool isRequestSent;
+
 	struct {
 		cxa_network_httpClient_cb_asyncGenHeaders_t genHeaders;
 		cxa_network_httpClient_cb_postAsyncGenBody_t genBody;
+		cxa_network_httpClient_cb_onResponseData_t responseData;
 		cxa_network_httpClient_cb_onPostComplete_t postComplete;
 
 		void* userVar;
 	}cbs;
 
+	cxa_network_httpClient_method_t method;
 	char hostname[CXA_NETWORK_HTTPCLIENT_HOSTNAME_MAX_LEN_BYTES+1];
 	char url[CXA_NETWORK_HTTPCLIENT_URL_MAX_LEN_BYTES+1];
 	uint16_t portNum;
 	bool useTls;
 	uint32_t timeout_ms;
 	bool keepOpen;
+	bool hasRequestBody;
+	bool sendChunked;
+	bool isBusy;
 
-	cxa_fixedByteBuffer_t headerLineBuffer;
-	uint8_t headerLineBuffer_raw[CXA_NETWORK_HTTPCLIENT_HEADER_LINE_BUFFERLEN_BYTES];
-	cxa_protocolParser_crlf_t headerLineParser;
-
+	cxa_ioStream_buffered_t ios_tx;
+	uint8_t ios_tx_raw[CXA_NETWORK_HTTPCLIENT_TX_BUFFERLEN_BYTES];
 	cxa_ioStream_nullablePassthrough_t ios_bodyGeneration;
+	cxa_ioStream_t ios_chunkedBody;
+	uint8_t chunkBuffer[CXA_NETWORK_HTTPCLIENT_CHUNK_BUFFERLEN_BYTES];
+	size_t chunkBuffer_currSize_bytes;
 
 	cxa_timeDiff_t td_receptionTimeout;
 
 	uint16_t responseStatusCode;
+	bool hasResponseContentLength;
+	bool isResponseChunked;
+	bool isResponseUntilClose;
 	size_t responseContentLength_bytes;
+	size_t responseRemaining_bytes;
 
 	uint8_t* responseBodyBuffer;
 	size_t responseBody_currSize_bytes;
@@ -159,10 +262,50 @@ void cxa_network_httpClient_init(cxa_network_httpClient_t *const netClientIn, in
 
 /**
  * @public
+ * @brief Starts an HTTP/1.1 request
+ *
+ * If a pooled connection to the same host is still open (from a previous
+ * request with keepOpenIn set), it is reused rather than connecting again.
+ * If that connection turns out to have been closed by the server, the request
+ * is retried once on a new connection. PUT and POST requests are only retried
+ * if the failure happened before the whole request was sent: after that the
+ * server may already have acted on it, so the request completes unsuccessfully
+ * and retrying is left to the caller.
+ *
+ * @param methodIn the request method
+ * @param keepOpenIn true to keep the connection open (in the pool) after the response
+ * @param cb_genBodyIn generates the request body. May be NULL (GET requests with
+ * 			a NULL body generator are sent without a body)
+ * @param sendChunkedIn true to send the request body with 'Transfer-Encoding: chunked'
+ * 			(cb_genBodyIn is only called once), false to send a Content-Length
+ * @param cb_responseDataIn if non-NULL, the response body is streamed to this callback
+ * 			(and not stored in responseBodyBufferIn)
+ * @param responseBodyBufferIn buffer in which to store the response body, NULL if body should
+ * 			be discarded (or is being streamed)
+ *
+ * @return true if the request was started, false if a request is already in progress
+ */
+bool cxa_network_httpClient_request_async(cxa_network_httpClient_t *const netClientIn,
+										  cxa_network_httpClient_method_t methodIn,
+										  char *const hostNameIn, uint16_t portNumIn, bool useTlsIn,
+										  const char *const urlIn, uint32_t timeout_msIn, bool keepOpenIn,
+										  cxa_network_httpClient_cb_asyncGenHeaders_t cb_genHeadersIn,
+										  cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn, bool sendChunkedIn,
+										  cxa_network_httpClient_cb_onResponseData_t cb_responseDataIn,
+										  cxa_network_httpClient_cb_onPostComplete_t cb_completeIn,
+										  uint8_t *const responseBodyBufferIn, size_t responseBody_maxSize_bytesIn,
+										  void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Shortcut for a POST request (with a Content-Length) via ::cxa_network_httpClient_request_async
  *
  * @param responseBodyBufferIn buffer in which to store the response body, NULL if body should be discarded
+ *
+ * @return true if the request was started, false if a request is already in progress
  */
-void cxa_network_httpClient_post_async(cxa_network_httpClient_t *const netClientIn,
+bool cxa_network_httpClient_post_async(cxa_network_httpClient_t *const netClientIn,
 								 	   char *const hostNameIn, uint16_t portNumIn, bool useTlsIn,
 									   const char *const urlIn, uint32_t timeout_msIn, bool keepOpenIn,
 									   cxa_network_httpClient_cb_asyncGenHeaders_t cb_genHeadersIn,
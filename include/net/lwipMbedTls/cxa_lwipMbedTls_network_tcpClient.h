@@ -31,6 +31,10 @@
 	#define CXA_LWIPMBEDTLS_NETWORK_TCPCLIENT_MAXPORTNUMLEN_BYTES			5
 #endif
 
+#ifndef CXA_LWIPMBEDTLS_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES
+	#define CXA_LWIPMBEDTLS_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES			512
+#endif
+
 
 // ******** global type definitions *********
 /**
@@ -54,6 +58,11 @@ struct cxa_lwipMbedTls_network_tcpClient
 	cxa_timeDiff_t td_writeTimeout;
 	cxa_stateMachine_t stateMachine;
 
+	// decrypted data (so we don't go through mbedtls for every byte)
+	uint8_t rxBuffer[CXA_LWIPMBEDTLS_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES];
+	size_t rxBuffer_numBytes;
+	size_t rxBuffer_readIndex;
+
 	bool useClientCert;
 	struct
 	{
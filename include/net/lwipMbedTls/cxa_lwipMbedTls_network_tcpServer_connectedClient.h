@@ -17,6 +17,9 @@
 
 
 // ******** global macro definitions ********
+#ifndef CXA_LWIPMBEDTLS_NETWORK_TCPSERVER_CONNECTEDCLIENT_RXBUFFER_SIZE_BYTES
+	#define CXA_LWIPMBEDTLS_NETWORK_TCPSERVER_CONNECTEDCLIENT_RXBUFFER_SIZE_BYTES		256
+#endif
 
 
 // ******** global type definitions *********
@@ -38,6 +41,11 @@ struct cxa_lwipMbedTls_network_tcpServer_connectedClient
 	char descriptiveString[23];			// "aaa.bbb.ccc.ddd::eeeee"
 
 	cxa_timeDiff_t td_writeTimeout;
+
+	// so we don't need a recv call for every byte
+	uint8_t rxBuffer[CXA_LWIPMBEDTLS_NETWORK_TCPSERVER_CONNECTEDCLIENT_RXBUFFER_SIZE_BYTES];
+	size_t rxBuffer_numBytes;
+	size_t rxBuffer_readIndex;
 };
 
 
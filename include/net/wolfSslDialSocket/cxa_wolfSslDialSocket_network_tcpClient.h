@@ -27,6 +27,10 @@
 	#define CXA_WOLFSSLDIALSOCKET_NETWORK_TCPCLIENT_MAXPORTNUMLEN_BYTES			5
 #endif
 
+#ifndef CXA_WOLFSSLDIALSOCKET_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES
+	#define CXA_WOLFSSLDIALSOCKET_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES			512
+#endif
+
 
 // ******** global type definitions *********
 /**
@@ -51,6 +55,11 @@ struct cxa_wolfSslDialSocket_network_tcpClient
 
 	cxa_stateMachine_t stateMachine;
 
+	// decrypted data (so we don't go through wolfSSL for every byte)
+	uint8_t rxBuffer[CXA_WOLFSSLDIALSOCKET_NETWORK_TCPCLIENT_RXBUFFER_SIZE_BYTES];
+	size_t rxBuffer_numBytes;
+	size_t rxBuffer_readIndex;
+
 	bool useClientCert;
 	struct
 	{
@@ -15,10 +15,27 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Messages are allocated from two size classes. Requests are served from the
+ * smallest class that fits (falling back to the large class when exhausted).
+ * ::cxa_rpc_messageFactory_getFreeMessage_empty always uses the large class.
+ */
 #ifndef CXA_RPC_MSGFACTORY_POOL_NUM_MSGS
 	#define CXA_RPC_MSGFACTORY_POOL_NUM_MSGS				2
 #endif
 
+#ifndef CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES
+	#define CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES			256
+#endif
+
+#ifndef CXA_RPC_MSGFACTORY_POOL_NUM_SMALL_MSGS
+	#define CXA_RPC_MSGFACTORY_POOL_NUM_SMALL_MSGS			0
+#endif
+
+#ifndef CXA_RPC_MSGFACTORY_SMALL_BUFFER_SIZE_BYTES
+	#define CXA_RPC_MSGFACTORY_SMALL_BUFFER_SIZE_BYTES		32
+#endif
+
 
 // ******** global type definitions *********
 
@@ -28,6 +45,7 @@ void cxa_rpc_messageFactory_init(void);
 
 size_t cxa_rpc_messageFactory_getNumFreeMessages(void);
 cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void);
+cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_sized(size_t minSize_bytesIn);
 
 cxa_rpc_message_t* cxa_rpc_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffer_t *const fbbIn);
 
@@ -35,4 +53,7 @@ void cxa_rpc_messageFactory_incrementMessageRefCount(cxa_rpc_message_t *const ms
 void cxa_rpc_messageFactory_decrementMessageRefCount(cxa_rpc_message_t *const msgIn);
 uint8_t cxa_rpc_messageFactory_getReferenceCountForMessage(cxa_rpc_message_t *const msgIn);
 
+size_t cxa_rpc_messageFactory_getHighWaterMark(void);
+size_t cxa_rpc_messageFactory_getNumFailedAllocations(void);
+
 #endif // CXA_RPC_NODE_H_
@@ -10,6 +10,7 @@
 
 // ******** includes ********
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <cxa_config.h>
 
@@ -19,8 +20,20 @@
 	#define CXA_RUNLOOP_MAXNUM_ENTRIES				10
 #endif
 
+#ifndef CXA_RUNLOOP_MAXNUM_THREADS
+	#define CXA_RUNLOOP_MAXNUM_THREADS				2
+#endif
+
 #define CXA_RUNLOOP_THREADID_DEFAULT				0
 
+#define CXA_RUNLOOP_NO_DEADLINE						UINT32_MAX
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	#ifndef CXA_RUNLOOP_PROFILER_NUM_HIST_BUCKETS
+		#define CXA_RUNLOOP_PROFILER_NUM_HIST_BUCKETS		16
+	#endif
+#endif
+
 
 // ******** global type definitions *********
 /**
@@ -29,16 +42,185 @@
 typedef void (*cxa_runLoop_cb_t)(void* userVarIn);
 
 
+/**
+ * @public
+ * @brief Called (from the context of the entry's thread) to determine
+ * whether an untimed entry needs to run again before the thread sleeps
+ *
+ * @return true if the entry has work pending
+ */
+typedef bool (*cxa_runLoop_cb_hasPendingWork_t)(void* userVarIn);
+
+
+/**
+ * @public
+ * @brief Describes the untimed entries of a thread (see
+ * 		::cxa_runLoop_getUntimedState)
+ */
+typedef enum
+{
+	CXA_RUNLOOP_UNTIMED_IDLE,
+	CXA_RUNLOOP_UNTIMED_MUSTPOLL,
+	CXA_RUNLOOP_UNTIMED_PENDINGWORK
+}cxa_runLoop_untimedState_t;
+
+
+/**
+ * @public
+ * @brief Called (from the context of the entry's thread) to determine
+ * whether an untimed entry has work pending, must be polled (eg. it checks
+ * for a condition nothing will wake the thread for) or is idle
+ */
+typedef cxa_runLoop_untimedState_t (*cxa_runLoop_cb_getUntimedState_t)(void* userVarIn);
+
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+/**
+ * @public
+ * @brief Execution statistics for a single runLoop entry (see ::cxa_runLoop_getEntryStats)
+ *
+ * Execution times are bucketed by log2: bucket 0 counts executions which took
+ * 0us, bucket i counts executions which took [2^(i-1), 2^i) microseconds and
+ * the last bucket counts everything longer.
+ */
+typedef struct
+{
+	const char* name;
+	cxa_runLoop_cb_t updateCb;
+	int threadId;
+	uint32_t execPeriod_ms;
+
+	uint32_t numCalls;
+	uint64_t totalExecTime_us;
+	uint32_t maxExecTime_us;
+	uint32_t execTimeHist[CXA_RUNLOOP_PROFILER_NUM_HIST_BUCKETS];
+
+	// timed entries only...how long after their deadline they actually ran
+	uint32_t numLateCalls;
+	uint32_t totalLateness_ms;
+	uint32_t maxLateness_ms;
+}cxa_runLoop_entryStats_t;
+#endif
+
+
 // ******** global function prototypes ********
 void cxa_runLoop_addEntry(int threadIdIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 void cxa_runLoop_addTimedEntry(int threadIdIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 void cxa_runLoop_clearAllEntries(void);
 
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addEntry, but names the entry for profiling
+ * 		(see ::cxa_runLoop_getEntryStats)
+ *
+ * @param[in] nameIn a name for the entry (must remain valid for the
+ * 		lifetime of the entry). May be NULL.
+ */
+void cxa_runLoop_addEntry_named(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addTimedEntry, but names the entry for
+ * 		profiling (see ::cxa_runLoop_getEntryStats)
+ *
+ * @param[in] nameIn a name for the entry (must remain valid for the
+ * 		lifetime of the entry). May be NULL.
+ */
+void cxa_runLoop_addTimedEntry_named(int threadIdIn, const char *const nameIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addEntry_named, but the entry reports
+ * 		whether it has work pending. Threads with an idle mechanism (see
+ * 		cxa_posix_runLoop.h) only poll such an entry while it does, and
+ * 		otherwise rely on an fd / dispatch to wake them.
+ *
+ * @param[in] nameIn a name for the entry (may be NULL)
+ * @param[in] hasPendingWorkCbIn called between iterations
+ */
+void cxa_runLoop_addEntry_idleAware(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_hasPendingWork_t hasPendingWorkCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addEntry_idleAware, but for entries which
+ * 		only need to be polled some of the time (eg. state machines, see
+ * 		::cxa_runLoop_cb_getUntimedState_t)
+ *
+ * @param[in] nameIn a name for the entry (may be NULL)
+ * @param[in] getUntimedStateCbIn called between iterations
+ */
+void cxa_runLoop_addEntry_pollAware(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_getUntimedState_t getUntimedStateCbIn, void *const userVarIn);
+
 void cxa_runLoop_dispatchNextIteration(int threadIdIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 void cxa_runLoop_dispatchAfter(int threadIdIn, uint32_t delay_msIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 
+/**
+ * @public
+ * @brief Determines how long the specified thread can sleep before its
+ * next entry needs to run.
+ *
+ * @note Untimed entries (added via ::cxa_runLoop_addEntry) are polled every
+ * 		iteration and are not considered deadlines. Use
+ * 		::cxa_runLoop_getUntimedState to determine whether they need to run.
+ *
+ * @param[in] threadIdIn the thread in question
+ *
+ * @return 0 if there are new entries or one-shots that should run on the
+ * 		next iteration, the number of milliseconds until the next timed entry
+ * 		is due, or ::CXA_RUNLOOP_NO_DEADLINE if there is nothing scheduled
+ */
+uint32_t cxa_runLoop_getTimeToNextDeadline_ms(int threadIdIn);
+
+/**
+ * @public
+ * @brief Must be called from the context of the specified thread
+ *
+ * @param[in] threadIdIn the thread in question
+ *
+ * @return CXA_RUNLOOP_UNTIMED_PENDINGWORK if an idle-aware entry has work
+ * 		pending, CXA_RUNLOOP_UNTIMED_MUSTPOLL if the thread has untimed
+ * 		entries that can't report their state or that asked to be polled,
+ * 		or CXA_RUNLOOP_UNTIMED_IDLE otherwise
+ */
+cxa_runLoop_untimedState_t cxa_runLoop_getUntimedState(int threadIdIn);
+
+/**
+ * @public
+ * @brief Runs a single iteration of the specified thread
+ *
+ * @note If CXA_RUNLOOP_CACHED_NOW_ENABLE is defined, the timeBase is read once
+ * 		at the start of the iteration and all ::cxa_timeDiff_t checks made
+ * 		during the iteration (on this thread) use that value
+ *
+ * @param[in] threadIdIn the thread to iterate
+ *
+ * @return the duration of the iteration, in microseconds
+ */
 uint32_t cxa_runLoop_iterate(int threadIdIn);
 void cxa_runLoop_execute(int threadIdIn);
 
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+/**
+ * @public
+ * @brief Retrieves the execution statistics for a started (non-one-shot)
+ * 		runLoop entry. Iterate indexIn from 0 until this returns false.
+ *
+ * @note statistics are updated by the thread which owns each entry without
+ * 		locking, so values read from another thread may be slightly inconsistent
+ *
+ * @param[in] indexIn index of the entry (across all threads)
+ * @param[out] statsOut the entry's statistics
+ *
+ * @return true if statsOut is valid, false if there is no entry at indexIn
+ */
+bool cxa_runLoop_getEntryStats(size_t indexIn, cxa_runLoop_entryStats_t *const statsOut);
+
+/**
+ * @public
+ * @brief Clears the execution statistics of all entries
+ */
+void cxa_runLoop_resetEntryStats(void);
+#endif
+
 
 #endif // CXA_RUN_LOOP_H_
@@ -0,0 +1,72 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_RUNLOOP_PROFILER_H_
+#define CXA_RUNLOOP_PROFILER_H_
+
+
+/**
+ * @file
+ * Human-readable reporting of the per-entry runLoop statistics gathered when
+ * CXA_RUNLOOP_PROFILER_ENABLE is defined (see ::cxa_runLoop_getEntryStats).
+ * Each entry is reported on a single line:
+ *
+ * @code
+ * <name> t<threadId> p<period>ms calls:<n> avg:<us>us max:<us>us late:<n> maxLate:<ms>ms hist:<b0>,<b1>,...
+ * @endcode
+ *
+ * where hist is the log2 execution time histogram (trailing empty buckets omitted).
+ */
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <cxa_ioStream.h>
+#include <cxa_runLoop.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_RUNLOOP_PROFILER_MAXLEN_LINE_BYTES
+	#define CXA_RUNLOOP_PROFILER_MAXLEN_LINE_BYTES		160
+#endif
+
+
+// ******** global type definitions *********
+
+
+// ******** global function prototypes ********
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+/**
+ * @public
+ * @brief Formats the statistics of a single entry as a (null-terminated) line
+ *
+ * @param[in] statsIn the statistics to format
+ * @param[out] lineOut buffer to receive the line
+ * @param[in] maxLen_bytesIn the size of lineOut
+ *
+ * @return true if the entire line fit in lineOut
+ */
+bool cxa_runLoop_profiler_formatEntry(const cxa_runLoop_entryStats_t *const statsIn, char *const lineOut, size_t maxLen_bytesIn);
+
+/**
+ * @public
+ * @brief Writes one line per runLoop entry to the given ioStream
+ *
+ * @param[in] ioStreamIn the ioStream to which the report should be written
+ */
+void cxa_runLoop_profiler_writeReport(cxa_ioStream_t *const ioStreamIn);
+
+/**
+ * @public
+ * @brief Adds "rl_stats" (print the report) and "rl_resetStats" commands to ::cxa_console
+ */
+void cxa_runLoop_profiler_addConsoleCommands(void);
+#endif
+
+
+#endif
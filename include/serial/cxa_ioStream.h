@@ -51,6 +51,23 @@ typedef enum
 typedef cxa_ioStream_readStatus_t (*cxa_ioStream_cb_readByte_t)(uint8_t *const byteOut, void *const userVarIn);
 
 
+/**
+ * @public
+ * @brief Read as many bytes as are immediately available (up to a maximum)
+ * 		from the ioStream. Optional, see ::cxa_ioStream_bindReadBytes
+ *
+ * @param[out] buffOut pointer to a location at which to store the received bytes
+ * @param[in] maxNumBytesIn the maximum number of bytes to store in buffOut (always > 0)
+ * @param[out] numBytesReadOut the number of bytes actually stored in buffOut
+ * @param[in] userVarIn pointer to the user-supplied variable passed to
+ * 		::cxa_ioStream_bind
+ *
+ * @return the return status of the read (CXA_IOSTREAM_READSTAT_GOTDATA if
+ * 		numBytesReadOut > 0)
+ */
+typedef cxa_ioStream_readStatus_t (*cxa_ioStream_cb_readBytes_t)(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
+
+
 /**
  * @public
  * @brief Write bytes to the ioStream.
@@ -69,10 +86,40 @@ typedef cxa_ioStream_readStatus_t (*cxa_ioStream_cb_readByte_t)(uint8_t *const b
 typedef bool (*cxa_ioStream_cb_writeBytes_t)(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
+/**
+ * @public
+ * @brief A single segment of a vectored (scatter / gather) write
+ */
+typedef struct
+{
+	void* buff;
+	size_t bufferSize_bytes;
+}cxa_ioStream_ioVec_t;
+
+
+/**
+ * @public
+ * @brief Write multiple segments to the ioStream with a single underlying
+ * 		operation (eg. writev). Optional, see ::cxa_ioStream_bindWriteVectored
+ *
+ * @param[in] vecsIn the segments to write, in order
+ * @param[in] numVecsIn the number of segments in vecsIn
+ * @param[in] userVarIn pointer to the user-supplied variable passed to
+ * 		::cxa_ioStream_bind
+ *
+ * @return true if all bytes were sent / queued to be sent, false if there
+ * 		was an error with the underlying ioStream. If false, number of bytes
+ * 		queued or sent is undetermined.
+ */
+typedef bool (*cxa_ioStream_cb_writeVectored_t)(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn);
+
+
 struct cxa_ioStream
 {
 	cxa_ioStream_cb_readByte_t readCb;
+	cxa_ioStream_cb_readBytes_t readBytesCb;
 	cxa_ioStream_cb_writeBytes_t writeCb;
+	cxa_ioStream_cb_writeVectored_t writeVectoredCb;
 
 	void *userVar;
 };
@@ -83,15 +130,19 @@ void cxa_ioStream_init(cxa_ioStream_t *const ioStreamIn);
 
 void cxa_ioStream_bind(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readByte_t readCbIn, cxa_ioStream_cb_writeBytes_t writeCbIn, void *const userVarIn);
 void cxa_ioStream_unbind(cxa_ioStream_t *const ioStreamIn);
+void cxa_ioStream_bindReadBytes(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readBytes_t readBytesCbIn);
+void cxa_ioStream_bindWriteVectored(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_writeVectored_t writeVectoredCbIn);
 bool cxa_ioStream_isBound(cxa_ioStream_t *const ioStreamIn);
 
 cxa_ioStream_readStatus_t cxa_ioStream_readByte(cxa_ioStream_t *const ioStreamIn, uint8_t *const byteOut);
+cxa_ioStream_readStatus_t cxa_ioStream_readBytes(cxa_ioStream_t *const ioStreamIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
 bool cxa_ioStream_waitForCharSequence_withTimeout(cxa_ioStream_t *const ioStreamIn, const char* targetSeqIn, uint32_t timeout_msIn);
 
 void cxa_ioStream_clearReadBuffer(cxa_ioStream_t *const ioStreamIn);
 
 bool cxa_ioStream_writeByte(cxa_ioStream_t *const ioStreamIn, uint8_t byteIn);
 bool cxa_ioStream_writeBytes(cxa_ioStream_t *const ioStreamIn, void* buffIn, size_t bufferSize_bytesIn);
+bool cxa_ioStream_writeVectored(cxa_ioStream_t *const ioStreamIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn);
 bool cxa_ioStream_writeBytes_hex(cxa_ioStream_t *const ioStreamIn, void* buffIn, size_t bufferSize_bytesIn);
 bool cxa_ioStream_writeFixedByteBuffer(cxa_ioStream_t *const ioStreamIn, cxa_fixedByteBuffer_t *const fbbIn);
 bool cxa_ioStream_writeString(cxa_ioStream_t *const ioStreamIn, const char* stringIn);
@@ -0,0 +1,116 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_IOSTREAM_BUFFERED_H_
+#define CXA_IOSTREAM_BUFFERED_H_
+
+
+/**
+ * @file
+ * An ioStream which coalesces small writes into a user-supplied buffer before
+ * passing them to an underlying ioStream. Buffered data is written when the
+ * buffer fills, when ::cxa_ioStream_buffered_flush is called, or (optionally)
+ * once per runLoop iteration. Writes that don't fit are sent along with the
+ * buffered data as a single vectored write (see ::cxa_ioStream_writeVectored).
+ *
+ * Reads pass directly through to the underlying ioStream.
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_ioStream_buffered_t bufStream;
+ * uint8_t bufStream_raw[256];
+ *
+ * cxa_ioStream_buffered_initStd(&bufStream, cxa_usart_getIoStream(&myUsart), bufStream_raw);
+ * cxa_ioStream_buffered_enableRunLoopFlush(&bufStream, CXA_RUNLOOP_THREADID_DEFAULT);
+ *
+ * cxa_ioStream_writeString(&bufStream.super, "hello ");
+ * cxa_ioStream_writeFormattedLine(&bufStream.super, "%d", 42);	// one underlying write (at end of iteration)
+ * @endcode
+ */
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <cxa_ioStream.h>
+
+
+// ******** global macro definitions ********
+/**
+ * @public
+ * @brief Shortcut to initialize the buffered ioStream with a c-style array for storage
+ */
+#define cxa_ioStream_buffered_initStd(ioStreamIn, underlyingStreamIn, bufferIn)		cxa_ioStream_buffered_init((ioStreamIn), (underlyingStreamIn), (void*)(bufferIn), sizeof(bufferIn))
+
+#ifndef CXA_IOSTREAM_BUFFERED_MAXNUM_VECS
+	#define CXA_IOSTREAM_BUFFERED_MAXNUM_VECS			4
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct
+{
+	cxa_ioStream_t super;
+	cxa_ioStream_t* underlyingStream;
+
+	uint8_t* buffer;
+	size_t maxSize_bytes;
+	size_t size_bytes;
+}cxa_ioStream_buffered_t;
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the buffered ioStream
+ *
+ * @param[in] ioStreamIn pointer to the pre-allocated buffered ioStream
+ * @param[in] underlyingStreamIn the ioStream to which buffered data is written
+ * @param[in] bufferIn storage for buffered data
+ * @param[in] bufferSize_bytesIn the size of bufferIn
+ */
+void cxa_ioStream_buffered_init(cxa_ioStream_buffered_t *const ioStreamIn, cxa_ioStream_t *const underlyingStreamIn,
+								void *const bufferIn, size_t bufferSize_bytesIn);
+
+
+/**
+ * @public
+ * @brief Flushes the buffer at the end of every iteration of the given runLoop
+ * 		thread (strictly, during the iteration after all previously-added entries)
+ *
+ * @param[in] ioStreamIn pointer to the pre-initialized buffered ioStream
+ * @param[in] threadIdIn the runLoop thread on which to flush
+ */
+void cxa_ioStream_buffered_enableRunLoopFlush(cxa_ioStream_buffered_t *const ioStreamIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Writes any buffered data to the underlying ioStream
+ *
+ * @param[in] ioStreamIn pointer to the pre-initialized buffered ioStream
+ *
+ * @return true on success (or if there was nothing to write), false if the
+ * 		underlying write failed (buffered data is discarded)
+ */
+bool cxa_ioStream_buffered_flush(cxa_ioStream_buffered_t *const ioStreamIn);
+
+
+/**
+ * @public
+ * @param[in] ioStreamIn pointer to the pre-initialized buffered ioStream
+ *
+ * @return the number of bytes waiting to be written to the underlying ioStream
+ */
+size_t cxa_ioStream_buffered_getNumBufferedBytes(cxa_ioStream_buffered_t *const ioStreamIn);
+
+
+#endif // CXA_IOSTREAM_BUFFERED_H_
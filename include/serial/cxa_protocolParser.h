@@ -27,6 +27,14 @@
 #ifndef CXA_PROTOCOLPARSER_MAXNUM_PACKETLISTENERS
 	#define CXA_PROTOCOLPARSER_MAXNUM_PACKETLISTENERS		1
 #endif
+#ifndef CXA_PROTOCOLPARSER_RXCHUNK_SIZE_BYTES
+	#define CXA_PROTOCOLPARSER_RXCHUNK_SIZE_BYTES			64
+#endif
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	#ifndef CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS
+		#define CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS	4
+	#endif
+#endif
 
 
 // ******** global type definitions *********
@@ -124,6 +132,31 @@ typedef struct
 }cxa_protocolParser_packetListener_entry_t;
 
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+/**
+ * @public
+ * @brief Receive buffer pool statistics, see ::cxa_protocolParser_getRxPoolStats
+ */
+typedef struct
+{
+	size_t numBuffers;
+	size_t numFree;
+	size_t minNumFree;
+	uint32_t numExhausted;
+}cxa_protocolParser_rxPoolStats_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_fixedByteBuffer_t* fbb;
+	size_t refCount;
+}cxa_protocolParser_rxPoolEntry_t;
+#endif
+
+
 /**
  * @private
  */
@@ -141,8 +174,20 @@ struct cxa_protocolParser
 
 	cxa_ioStream_t* ioStream;
 
+	uint8_t rxChunk[CXA_PROTOCOLPARSER_RXCHUNK_SIZE_BYTES];
+	size_t rxChunk_size_bytes;
+	size_t rxChunk_index;
+
 	cxa_fixedByteBuffer_t* currBuffer;
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	cxa_array_t rxPool;
+	cxa_protocolParser_rxPoolEntry_t rxPool_raw[CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS];
+	bool rxPool_isStalled;
+	size_t rxPool_minNumFree;
+	uint32_t rxPool_numExhausted;
+#endif
+
 	cxa_protocolParser_scm_isInErrorState_t scm_isInError;
 	cxa_protocolParser_scm_canSetBuffer_t scm_canSetBuffer;
 	cxa_protocolParser_scm_gotoIdle_t scm_gotoIdle;
@@ -257,6 +302,64 @@ bool cxa_protocolParser_writePacket(cxa_protocolParser_t *const ppIn, cxa_fixedB
  */
 bool cxa_protocolParser_writePacket_bytes(cxa_protocolParser_t *const ppIn, void* bytesIn, size_t numBytesIn);
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+/**
+ * @public
+ * @brief Adds a buffer to the parser's receive pool. The buffer passed
+ * 		to the parser's init function is added automatically.
+ *
+ * Packet listeners that need a received packet beyond the duration of
+ * their callback call ::cxa_protocolParser_retainBuffer. The parser then
+ * continues receiving into the next free pool buffer rather than waiting
+ * for a new buffer via ::cxa_protocolParser_setBuffer. If no buffer is
+ * free, the parser stops reading from the ioStream (leaving the data
+ * buffered there) until one is released.
+ *
+ * Parsers whose owner supplies the buffers (eg. cxa_mqtt_client, which
+ * receives into messageFactory messages) add them here themselves.
+ *
+ * @param[in] ppIn pointer to the pre-initialized protocolParser
+ * @param[in] fbbIn pointer to the pre-initialized buffer to add
+ */
+void cxa_protocolParser_addRxBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn);
+
+/**
+ * @public
+ * @brief Takes a reference to a received packet buffer (typically from
+ * 		within a packetListener callback). Must be balanced by a call to
+ * 		::cxa_protocolParser_releaseBuffer from the parser's thread.
+ *
+ * @param[in] ppIn pointer to the pre-initialized protocolParser
+ * @param[in] fbbIn the buffer passed to the packetListener callback
+ *
+ * @return true if the buffer belongs to the receive pool and is now
+ * 		retained, false if it does not (and must be copied instead)
+ */
+bool cxa_protocolParser_retainBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn);
+
+/**
+ * @public
+ * @brief Drops a reference taken by ::cxa_protocolParser_retainBuffer.
+ * 		Once the last reference is dropped the buffer returns to the pool.
+ *
+ * @param[in] ppIn pointer to the pre-initialized protocolParser
+ * @param[in] fbbIn the previously retained buffer
+ */
+void cxa_protocolParser_releaseBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn);
+
+/**
+ * @public
+ * @brief Returns the current state of the receive pool. numExhausted is
+ * 		the number of times the parser had to stop receiving because
+ * 		every buffer was retained; minNumFree is the low-water mark of
+ * 		free buffers since they were added.
+ *
+ * @param[in] ppIn pointer to the pre-initialized protocolParser
+ * @param[out] statsOut filled with the current statistics
+ */
+void cxa_protocolParser_getRxPoolStats(cxa_protocolParser_t *const ppIn, cxa_protocolParser_rxPoolStats_t *const statsOut);
+#endif
+
 /**
  * @public
  * @brief Resets the protocol parser if an ioException has occurred.
@@ -269,6 +372,28 @@ bool cxa_protocolParser_writePacket_bytes(cxa_protocolParser_t *const ppIn, void
 void cxa_protocolParser_resetError(cxa_protocolParser_t *const ppIn);
 
 
+/**
+ * @protected
+ * @brief Returns the received bytes which have not yet been consumed by the
+ * 		parser, reading a new chunk from the ioStream if none remain. Bytes
+ * 		remain available (across packets) until ::cxa_protocolParser_consumeRxBytes
+ *
+ * @param[in] ppIn pointer to the pre-initialized protocolParser
+ * @param[out] bytesOut set to the first unconsumed byte
+ * @param[out] numBytesOut set to the number of unconsumed bytes at bytesOut
+ *
+ * @return CXA_IOSTREAM_READSTAT_GOTDATA if numBytesOut > 0
+ */
+cxa_ioStream_readStatus_t cxa_protocolParser_peekRxBytes(cxa_protocolParser_t *const ppIn, uint8_t **const bytesOut, size_t *const numBytesOut);
+
+
+/**
+ * @protected
+ * @brief Marks bytes returned by ::cxa_protocolParser_peekRxBytes as consumed
+ */
+void cxa_protocolParser_consumeRxBytes(cxa_protocolParser_t *const ppIn, size_t numBytesIn);
+
+
 /**
  * @protected
  */
@@ -20,10 +20,30 @@
 typedef struct cxa_protocolParser_cleProto cxa_protocolParser_cleProto_t;
 
 
+/**
+ * @public
+ * @brief On-the-wire framing. Both ends of the link must agree.
+ *
+ * V1: 0x80 0x81 <lenLE16> <payload> 0x82
+ * V2: 0x80 0x81 <lenLE16> <payload> <crc16LE> 0x82
+ *
+ * len counts everything after the length field. The V2 crc is
+ * CRC-16/ARC (see ::cxa_numberUtils_crc16_oneShot) over the length
+ * field and payload.
+ */
+typedef enum
+{
+	CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V1,
+	CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2
+}cxa_protocolParser_cleProto_framing_t;
+
+
 struct cxa_protocolParser_cleProto
 {
 	cxa_protocolParser_t super;
 
+	cxa_protocolParser_cleProto_framing_t framing;
+
 	cxa_stateMachine_t stateMachine;
 };
 
@@ -31,5 +51,13 @@ struct cxa_protocolParser_cleProto
 // ******** global function prototypes ********
 void cxa_protocolParser_cleProto_init(cxa_protocolParser_cleProto_t *const clePpIn, cxa_ioStream_t *const ioStreamIn, cxa_fixedByteBuffer_t *const buffIn, int threadIdIn);
 
+/**
+ * @public
+ * @brief Selects the framing used for both transmit and receive
+ * 		(defaults to ::CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V1). Any
+ * 		partially received packet is discarded.
+ */
+void cxa_protocolParser_cleProto_setFraming(cxa_protocolParser_cleProto_t *const clePpIn, cxa_protocolParser_cleProto_framing_t framingIn);
+
 
 #endif /* CXA_PROTOCOLPARSER_CLE_H_ */
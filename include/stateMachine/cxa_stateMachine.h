@@ -19,6 +19,9 @@
 #ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
 	#include <cxa_timeDiff.h>
 #endif
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+	#include <cxa_fixedFifo.h>
+#endif
 
 
 // ******** global macro definitions ********
@@ -26,6 +29,16 @@
 	#define CXA_STATE_MACHINE_MAXNUM_STATES				16
 #endif
 
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+	#ifndef CXA_STATE_MACHINE_MAXNUM_EVENT_TRANSITIONS
+		#define CXA_STATE_MACHINE_MAXNUM_EVENT_TRANSITIONS		8
+	#endif
+
+	#ifndef CXA_STATE_MACHINE_EVENT_QUEUE_SIZE
+		#define CXA_STATE_MACHINE_EVENT_QUEUE_SIZE				4
+	#endif
+#endif
+
 #define CXA_STATE_MACHINE_STATE_UNKNOWN						-1
 
 
@@ -44,6 +57,9 @@ typedef void (*cxa_stateMachine_cb_entered_t)(cxa_stateMachine_t *const smIn, in
 typedef void (*cxa_stateMachine_cb_state_t)(cxa_stateMachine_t *const smIn, void *userVarIn);
 typedef void (*cxa_stateMachine_cb_leaving_t)(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn);
 typedef void (*cxa_stateMachine_cb_left_t)(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn);
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+typedef bool (*cxa_stateMachine_cb_guard_t)(cxa_stateMachine_t *const smIn, int eventIdIn, void* userVarIn);
+#endif
 
 
 /**
@@ -82,6 +98,22 @@ typedef struct
 }cxa_stateMachine_state_t;
 
 
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+/**
+ * @private
+ */
+typedef struct
+{
+	int fromStateId;
+	int eventId;
+	int toStateId;
+
+	cxa_stateMachine_cb_guard_t cb_guard;
+	void *userVar;
+}cxa_stateMachine_eventTransition_t;
+#endif
+
+
 /**
  * @public
  */
@@ -91,6 +123,8 @@ struct cxa_stateMachine
 	cxa_stateMachine_state_t* nextState;
 
 	bool hasStarted;
+	bool isStateUpdatePending;
+	uint8_t maxTransitionsPerUpdate;
 
 	cxa_array_t states;
 	cxa_stateMachine_state_t states_raw[CXA_STATE_MACHINE_MAXNUM_STATES];
@@ -103,6 +137,14 @@ struct cxa_stateMachine
 		bool timedStatesEnabled;
 		cxa_timeDiff_t td_timedTransition;
 	#endif
+
+	#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+		cxa_array_t eventTransitions;
+		cxa_stateMachine_eventTransition_t eventTransitions_raw[CXA_STATE_MACHINE_MAXNUM_EVENT_TRANSITIONS];
+
+		cxa_fixedFifo_t eventQueue;
+		int eventQueue_raw[CXA_STATE_MACHINE_EVENT_QUEUE_SIZE+1];		// fifo always keeps one slot empty
+	#endif
 };
 
 
@@ -132,6 +174,55 @@ void cxa_stateMachine_addState_timed_full(cxa_stateMachine_t *const smIn, int id
 
 void cxa_stateMachine_setInitialState(cxa_stateMachine_t *const smIn, int stateIdIn);
 
+/**
+ * @public
+ * @brief Enables run-to-completion processing of transitions
+ *
+ * By default, each runLoop iteration either performs a single transition _or_
+ * calls the current state's state callback. With run-to-completion enabled, a
+ * transition is followed (in the same iteration) by the new state's state
+ * callback, and any transitions requested along the way are processed
+ * immediately...up to the given number of transitions per iteration. Any
+ * further transition is deferred to the next iteration as usual.
+ *
+ * @param maxTransitionsPerUpdateIn the maximum number of transitions per runLoop
+ * 		iteration (0 restores the default behavior)
+ */
+void cxa_stateMachine_setRunToCompletion(cxa_stateMachine_t *const smIn, uint8_t maxTransitionsPerUpdateIn);
+
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+/**
+ * @public
+ * @brief Adds a transition which is triggered by a posted event
+ *
+ * @param fromStateIdIn the state in which this transition applies
+ * 		(CXA_STATE_MACHINE_STATE_UNKNOWN for any state)
+ * @param eventIdIn the event which triggers this transition
+ * @param toStateIdIn the state to which we should transition
+ * @param cb_guardIn optional callback which must return true for the
+ * 		transition to occur (NULL for an unconditional transition)
+ */
+void cxa_stateMachine_addEventTransition(cxa_stateMachine_t *const smIn, int fromStateIdIn, int eventIdIn, int toStateIdIn,
+		cxa_stateMachine_cb_guard_t cb_guardIn, void *userVarIn);
+
+/**
+ * @public
+ * @brief Queues an event for the state machine
+ *
+ * Events are dispatched from the runLoop (in order) whenever no other
+ * transition is pending. The first matching event transition (in the order
+ * they were added) whose guard passes is taken. Events which don't trigger
+ * a transition are discarded.
+ *
+ * A pending event (like a pending transition) keeps the state machine's
+ * runLoop thread from sleeping, but posting doesn't wake that thread: call
+ * this from the state machine's own thread.
+ *
+ * @return true if the event was queued, false if the queue is full
+ */
+bool cxa_stateMachine_postEvent(cxa_stateMachine_t *const smIn, int eventIdIn);
+#endif
+
 void cxa_stateMachine_transition(cxa_stateMachine_t *const smIn, int stateIdIn);
 void cxa_stateMachine_transitionNow(cxa_stateMachine_t *const smIn, int stateIdIn);
 
@@ -12,6 +12,13 @@
  *
  * @note This object should work across all architecture-specific implementations
  *
+ * Time is measured using the 64-bit timeBase count so there are no wraparound
+ * hazards. When CXA_RUNLOOP_CACHED_NOW_ENABLE is defined, the runLoop reads the
+ * timeBase once at the start of each iteration and every timeDiff evaluated
+ * during that iteration uses that value (saving a clock read per check). In
+ * this case, code that waits for time to pass _within_ a single runLoop
+ * iteration must use ::cxa_timeDiff_isElapsed_uncached_ms.
+ *
  *
  * #### Example Usage: ####
  *
@@ -42,16 +49,23 @@
 // ******** includes ********
 #include <stdint.h>
 #include <stdbool.h>
+#include <cxa_config.h>
 #include <cxa_timeBase.h>
 
 
 // ******** global macro definitions ********
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+	#ifndef CXA_TIMEDIFF_THREAD_LOCAL
+		// the cached value is per-thread (define as empty on single-threaded targets without TLS)
+		#define CXA_TIMEDIFF_THREAD_LOCAL			__thread
+	#endif
+#endif
 
 
 // ******** global type definitions *********
 typedef struct
 {
-	uint32_t startTime_us;
+	uint64_t startTime_us;
 }cxa_timeDiff_t;
 
 
@@ -86,6 +100,16 @@ void cxa_timeDiff_setStartTime_now(cxa_timeDiff_t *const tdIn);
  */
 uint32_t cxa_timeDiff_getElapsedTime_ms(cxa_timeDiff_t *const tdIn);
 
+/**
+ * @public
+ *
+ * @param[in] tdIn the pre-initialized timeDiff
+ *
+ * @return the amount of time (in microseconds) since a call to
+ * 		setStartTime_now (as indicated by the reference timeBase)
+ */
+uint64_t cxa_timeDiff_getElapsedTime_us(cxa_timeDiff_t *const tdIn);
+
 /**
  * @public
  *
@@ -94,12 +118,24 @@ uint32_t cxa_timeDiff_getElapsedTime_ms(cxa_timeDiff_t *const tdIn);
  *
  * @return true if the specified amount of time has elapsed since the last
  * 		call to setStartTime_now. Once true is returned, this timeDiff
- * 		will return true until the following occurs:
- * 		1. setStartTime_now is called again
- * 		2. the timeBase "rolls" over
+ * 		will return true until setStartTime_now is called again
  */
 bool cxa_timeDiff_isElapsed_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn);
 
+/**
+ * @public
+ * @brief Same as ::cxa_timeDiff_isElapsed_ms, but always reads the timeBase
+ * (even if the runLoop has cached the current time for this iteration).
+ * Use this when blocking until a timeout expires.
+ *
+ * @param[in] tdIn the pre-initialized timeDiff
+ * @param[in] msIn the desired number of milliseconds
+ *
+ * @return true if the specified amount of time has elapsed since the last
+ * 		call to setStartTime_now
+ */
+bool cxa_timeDiff_isElapsed_uncached_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn);
+
 /**
  * @public
  * This is a convenience method which combines calls to isElapsed_ms and
@@ -116,5 +152,23 @@ bool cxa_timeDiff_isElapsed_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn);
  */
 bool cxa_timeDiff_isElapsed_recurring_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn);
 
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+/**
+ * @protected
+ * @brief Called by the runLoop at the start of each iteration. Until
+ * ::cxa_timeDiff_clearCachedNow is called, all timeDiffs on the calling
+ * thread will use this value as the current time.
+ *
+ * @param[in] now_usIn the current value of ::cxa_timeBase_getCount64_us
+ */
+void cxa_timeDiff_setCachedNow(uint64_t now_usIn);
+
+/**
+ * @protected
+ * @brief Called by the runLoop at the end of each iteration
+ */
+void cxa_timeDiff_clearCachedNow(void);
+#endif
+
 
 #endif // CXA_TIMEBASE_H_
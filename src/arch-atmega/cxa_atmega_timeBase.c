@@ -48,6 +48,18 @@ uint32_t cxa_timeBase_getMaxCount_us(void)
 }
 
 
+uint64_t cxa_timeBase_getCount64_us(void)
+{
+	return cxa_timeBase_extendCount64_us();
+}
+
+
+uint64_t cxa_timeBase_getCount64_ns(void)
+{
+	return cxa_timeBase_getCount64_us() * 1000;
+}
+
+
 // ******** local function implementations ********
 static void timer8_cb_onOverflow(cxa_atmega_timer_t *const timerIn, void *userVarIn)
 {
@@ -8,6 +8,7 @@
 
 // ******** includes ********
 #include <cxa_assert.h>
+#include <cxa_timeBase.h>
 #include <em_rtcc.h>
 
 
@@ -36,4 +37,16 @@ uint32_t cxa_timeBase_getMaxCount_us(void)
 }
 
 
+uint64_t cxa_timeBase_getCount64_us(void)
+{
+	return cxa_timeBase_extendCount64_us();
+}
+
+
+uint64_t cxa_timeBase_getCount64_ns(void)
+{
+	return cxa_timeBase_getCount64_us() * 1000;
+}
+
+
 // ******** local function implementations ********
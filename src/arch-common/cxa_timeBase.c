@@ -0,0 +1,59 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_timeBase.h"
+
+
+// ******** includes ********
+#include <stdbool.h>
+
+#include <cxa_assert.h>
+#include <cxa_criticalSection.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+static bool isExtendedCountInit = false;
+static uint32_t extendedCount_last_us;
+static uint64_t extendedCount_us;
+
+
+// ******** global function implementations ********
+uint64_t cxa_timeBase_extendCount64_us(void)
+{
+	cxa_criticalSection_enter();
+
+	// read inside the critical section so concurrent callers can't see the count go backwards
+	uint32_t curr_us = cxa_timeBase_getCount_us();
+	if( !isExtendedCountInit )
+	{
+		extendedCount_us = curr_us;
+		isExtendedCountInit = true;
+	}
+	else
+	{
+		extendedCount_us += (curr_us >= extendedCount_last_us) ?
+							(curr_us - extendedCount_last_us) :
+							((cxa_timeBase_getMaxCount_us() - extendedCount_last_us) + curr_us);
+	}
+	extendedCount_last_us = curr_us;
+	uint64_t retVal = extendedCount_us;
+
+	cxa_criticalSection_exit();
+
+	return retVal;
+}
+
+
+// ******** local function implementations ********
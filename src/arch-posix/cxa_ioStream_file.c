@@ -28,6 +28,7 @@
 static bool set_blocking(cxa_ioStream_file_t *const ioStreamIn, bool should_block);
 
 static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
@@ -63,6 +64,7 @@ void cxa_ioStream_file_setFile(cxa_ioStream_file_t *const ioStreamIn, FILE *cons
 
 	// get ready for use
 	cxa_ioStream_bind(&ioStreamIn->super, read_cb, write_cb, (void*)ioStreamIn);
+	cxa_ioStream_bindReadBytes(&ioStreamIn->super, readBytes_cb);
 }
 
 
@@ -80,6 +82,14 @@ void cxa_ioStream_file_close(cxa_ioStream_file_t *const ioStreamIn)
 }
 
 
+int cxa_ioStream_file_getFileDescriptor(cxa_ioStream_file_t *const ioStreamIn)
+{
+	cxa_assert(ioStreamIn);
+
+	return (ioStreamIn->file != NULL) ? fileno(ioStreamIn->file) : -1;
+}
+
+
 // ******** local function implementations ********
 static bool set_blocking(cxa_ioStream_file_t *const ioStreamIn, bool should_block)
 {
@@ -118,6 +128,23 @@ static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const use
 }
 
 
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_assert(userVarIn);
+	cxa_ioStream_file_t* ioStreamIn = (cxa_ioStream_file_t*)userVarIn;
+
+	int fd = fileno(ioStreamIn->file);
+	cxa_assert(fd >= 0);
+
+	// perform our read and check the return value
+	ssize_t retVal_read = read(fd, buffOut, maxNumBytesIn);
+	if( retVal_read < 0 ) return CXA_IOSTREAM_READSTAT_ERROR;
+
+	*numBytesReadOut = (size_t)retVal_read;
+	return (retVal_read == 0) ? CXA_IOSTREAM_READSTAT_NODATA : CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
 static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_assert(userVarIn);
@@ -0,0 +1,98 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mutex.h"
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <pthread.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+#ifndef CXA_POSIX_MAXNUM_MUTEX
+#define CXA_POSIX_MAXNUM_MUTEX		4
+#endif
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_mutex_t super;
+
+	pthread_mutex_t mutex;
+}cxa_posix_mutex_t;
+
+
+typedef struct
+{
+	bool isUsed;
+	cxa_posix_mutex_t mutex;
+}mutexEntry_t;
+
+
+// ******** local function prototypes ********
+static void init(void);
+
+
+// ********  local variable declarations *********
+static bool isInit = false;
+static mutexEntry_t mutexEntries[CXA_POSIX_MAXNUM_MUTEX];
+static pthread_mutex_t reserveMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ******** global function implementations ********
+cxa_mutex_t* cxa_mutex_reserve(void)
+{
+	cxa_mutex_t* retVal = NULL;
+
+	pthread_mutex_lock(&reserveMutex);
+	if( !isInit ) init();
+
+	for( size_t i = 0; i < sizeof(mutexEntries)/sizeof(*mutexEntries); i++ )
+	{
+		if( !mutexEntries[i].isUsed )
+		{
+			mutexEntries[i].isUsed = true;
+			retVal = &mutexEntries[i].mutex.super;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&reserveMutex);
+
+	// NULL if there are no free mutexs
+	return retVal;
+}
+
+
+void cxa_mutex_aquire(cxa_mutex_t *const mutexIn)
+{
+	cxa_assert(mutexIn);
+
+	pthread_mutex_lock(&((cxa_posix_mutex_t*)mutexIn)->mutex);
+}
+
+
+void cxa_mutex_release(cxa_mutex_t *const mutexIn)
+{
+	cxa_assert(mutexIn);
+
+	pthread_mutex_unlock(&((cxa_posix_mutex_t*)mutexIn)->mutex);
+}
+
+
+// ******** local function implementations ********
+static void init(void)
+{
+	for( size_t i = 0; i < sizeof(mutexEntries)/sizeof(*mutexEntries); i++ )
+	{
+		mutexEntries[i].isUsed = false;
+		pthread_mutex_init(&mutexEntries[i].mutex.mutex, NULL);
+	}
+
+	isInit = true;
+}
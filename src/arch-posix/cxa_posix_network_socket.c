@@ -0,0 +1,160 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_network_socket.h"
+
+
+// ******** includes ********
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cxa_assert.h>
+#include <cxa_timeDiff.h>
+
+
+// ******** local macro definitions ********
+#define MAXNUM_IOVECS_PER_WRITE					8
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool waitForWritable(int socketIn, cxa_timeDiff_t *const tdIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_socket_setOptions(int socketIn)
+{
+	int optVal = 1;
+
+	// we're usually sending small, latency-sensitive messages
+	setsockopt(socketIn, IPPROTO_TCP, TCP_NODELAY, &optVal, sizeof(optVal));
+
+	// make sure we notice peers that disappear without closing
+	setsockopt(socketIn, SOL_SOCKET, SO_KEEPALIVE, &optVal, sizeof(optVal));
+#ifdef TCP_KEEPIDLE
+	optVal = CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_IDLE_S;
+	setsockopt(socketIn, IPPROTO_TCP, TCP_KEEPIDLE, &optVal, sizeof(optVal));
+#endif
+	optVal = CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_INTERVAL_S;
+	setsockopt(socketIn, IPPROTO_TCP, TCP_KEEPINTVL, &optVal, sizeof(optVal));
+	optVal = CXA_POSIX_NETWORK_SOCKET_KEEPALIVE_COUNT;
+	setsockopt(socketIn, IPPROTO_TCP, TCP_KEEPCNT, &optVal, sizeof(optVal));
+}
+
+
+cxa_ioStream_readStatus_t cxa_posix_network_socket_read(int socketIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
+{
+	cxa_assert(buffOut);
+	cxa_assert(numBytesReadOut);
+
+	*numBytesReadOut = 0;
+	if( maxNumBytesIn == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+
+	ssize_t retVal_recv;
+	do
+	{
+		retVal_recv = recv(socketIn, buffOut, maxNumBytesIn, 0);
+	} while( (retVal_recv < 0) && (errno == EINTR) );
+
+	// per man page: for TCP sockets, 0 means the peer has closed its half of the connection
+	if( retVal_recv == 0 ) return CXA_IOSTREAM_READSTAT_ERROR;
+	if( retVal_recv < 0 ) return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? CXA_IOSTREAM_READSTAT_NODATA : CXA_IOSTREAM_READSTAT_ERROR;
+
+	*numBytesReadOut = (size_t)retVal_recv;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
+bool cxa_posix_network_socket_writeVectored(int socketIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn)
+{
+	cxa_timeDiff_t td_writeTimeout;
+	cxa_timeDiff_init(&td_writeTimeout);
+
+	struct iovec iovs[MAXNUM_IOVECS_PER_WRITE];
+	while( numVecsIn > 0 )
+	{
+		size_t numIovs = (numVecsIn < MAXNUM_IOVECS_PER_WRITE) ? numVecsIn : MAXNUM_IOVECS_PER_WRITE;
+		for( size_t i = 0; i < numIovs; i++ )
+		{
+			iovs[i].iov_base = vecsIn[i].buff;
+			iovs[i].iov_len = vecsIn[i].bufferSize_bytes;
+		}
+		vecsIn += numIovs;
+		numVecsIn -= numIovs;
+
+		// sendmsg may not write everything...skip past whatever it did write and try again
+		struct iovec* currIov = iovs;
+		while( numIovs > 0 )
+		{
+			struct msghdr msg = { .msg_iov = currIov, .msg_iovlen = numIovs };
+			ssize_t retVal_send = sendmsg(socketIn, &msg, MSG_NOSIGNAL);
+			if( retVal_send < 0 )
+			{
+				if( errno == EINTR ) continue;
+				if( ((errno == EAGAIN) || (errno == EWOULDBLOCK)) && waitForWritable(socketIn, &td_writeTimeout) ) continue;
+				return false;
+			}
+
+			// we made progress...reset our timeout
+			cxa_timeDiff_setStartTime_now(&td_writeTimeout);
+
+			size_t numBytesSent = (size_t)retVal_send;
+			while( (numIovs > 0) && (numBytesSent >= currIov->iov_len) )
+			{
+				numBytesSent -= currIov->iov_len;
+				currIov++;
+				numIovs--;
+			}
+			if( numIovs > 0 )
+			{
+				currIov->iov_base = ((uint8_t*)currIov->iov_base) + numBytesSent;
+				currIov->iov_len -= numBytesSent;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+bool cxa_posix_network_socket_isClosedByPeer(int socketIn)
+{
+	uint8_t tmpByte;
+	ssize_t retVal_recv;
+	do
+	{
+		retVal_recv = recv(socketIn, &tmpByte, 1, MSG_PEEK);
+	} while( (retVal_recv < 0) && (errno == EINTR) );
+
+	if( retVal_recv == 0 ) return true;
+	if( retVal_recv < 0 ) return !((errno == EAGAIN) || (errno == EWOULDBLOCK));
+	return false;
+}
+
+
+// ******** local function implementations ********
+static bool waitForWritable(int socketIn, cxa_timeDiff_t *const tdIn)
+{
+	uint32_t elapsed_ms = cxa_timeDiff_getElapsedTime_ms(tdIn);
+	if( elapsed_ms >= CXA_POSIX_NETWORK_SOCKET_WRITE_TIMEOUT_MS ) return false;
+
+	// sleep until the kernel has room in its send buffer (rather than spinning)
+	struct pollfd pfd = { .fd = socketIn, .events = POLLOUT };
+	int retVal_poll = poll(&pfd, 1, (int)(CXA_POSIX_NETWORK_SOCKET_WRITE_TIMEOUT_MS - elapsed_ms));
+	if( retVal_poll < 0 ) return (errno == EINTR);
+
+	return (retVal_poll > 0) && !(pfd.revents & (POLLERR | POLLHUP | POLLNVAL));
+}
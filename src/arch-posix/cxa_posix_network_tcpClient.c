@@ -0,0 +1,324 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_network_tcpClient.h"
+
+
+// ******** includes ********
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include <cxa_assert.h>
+#include <cxa_posix_network_socket.h>
+#include <cxa_posix_runLoop.h>
+#include <cxa_runLoop.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#ifndef CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+	#error "cxa_posix_network_tcpClient requires CXA_RUNLOOP_POSIX_EVENTS_ENABLE (connects complete, and data arrives, via the runLoop's fd callbacks)"
+#endif
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static void closeSocket(cxa_posix_network_tcpClient_t *const netClientIn);
+static void handleConnectFail(cxa_posix_network_tcpClient_t *const netClientIn);
+static void handleDisconnect(cxa_posix_network_tcpClient_t *const netClientIn);
+
+static bool scm_connectToHost(cxa_network_tcpClient_t *const superIn, char *const hostNameIn, uint16_t portNumIn, bool useTlsIn, uint32_t timeout_msIn);
+static void scm_disconnectFromHost(cxa_network_tcpClient_t *const superIn);
+static bool scm_isConnected(cxa_network_tcpClient_t *const superIn);
+
+static void cb_onSocketEvent(int fdIn, void *const userVarIn);
+static void cb_onConnectTimeout(void* userVarIn);
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool cb_ioStream_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_tcpClient_init(cxa_posix_network_tcpClient_t *const netClientIn, int threadIdIn)
+{
+	cxa_assert(netClientIn);
+
+	// set some defaults
+	netClientIn->threadId = threadIdIn;
+	netClientIn->socket = -1;
+	netClientIn->state = CXA_POSIX_NETWORK_TCPCLIENT_STATE_IDLE;
+	netClientIn->isReadable = false;
+	netClientIn->connectTimeout_ms = 0;
+
+	// initialize our super class
+	cxa_network_tcpClient_init(&netClientIn->super, scm_connectToHost, NULL, scm_disconnectFromHost, scm_isConnected);
+}
+
+
+// ******** local function implementations ********
+static void closeSocket(cxa_posix_network_tcpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	cxa_ioStream_unbind(&netClientIn->super.ioStream);
+
+	if( netClientIn->socket >= 0 )
+	{
+		cxa_posix_runLoop_removeFd(netClientIn->threadId, netClientIn->socket);
+		close(netClientIn->socket);
+	}
+	netClientIn->socket = -1;
+	netClientIn->state = CXA_POSIX_NETWORK_TCPCLIENT_STATE_IDLE;
+}
+
+
+static void handleConnectFail(cxa_posix_network_tcpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	closeSocket(netClientIn);
+	cxa_network_tcpClient_notify_connectFail(&netClientIn->super);
+}
+
+
+static void handleDisconnect(cxa_posix_network_tcpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	if( netClientIn->state != CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED ) return;
+
+	cxa_logger_info(&netClientIn->super.logger, "disconnected");
+	closeSocket(netClientIn);
+	cxa_network_tcpClient_notify_disconnect(&netClientIn->super);
+}
+
+
+static bool scm_connectToHost(cxa_network_tcpClient_t *const superIn, char *const hostNameIn, uint16_t portNumIn, bool useTlsIn, uint32_t timeout_msIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)superIn;
+	cxa_assert(netClientIn);
+	cxa_assert(hostNameIn);
+
+	// make sure we are currently idle
+	if( netClientIn->state != CXA_POSIX_NETWORK_TCPCLIENT_STATE_IDLE )
+	{
+		cxa_logger_trace(&netClientIn->super.logger, "not idle, cannot connect");
+		return false;
+	}
+
+	if( useTlsIn )
+	{
+		cxa_logger_warn(&netClientIn->super.logger, "TLS not supported");
+		return false;
+	}
+
+	// resolve our host
+	char portNumStr[6];
+	snprintf(portNumStr, sizeof(portNumStr), "%d", portNumIn);
+	struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM, .ai_protocol = IPPROTO_TCP };
+	struct addrinfo* addrs = NULL;
+	int retVal_gai = getaddrinfo(hostNameIn, portNumStr, &hints, &addrs);
+	if( (retVal_gai != 0) || (addrs == NULL) )
+	{
+		cxa_logger_warn(&netClientIn->super.logger, "unable to resolve '%s': %s", hostNameIn, gai_strerror(retVal_gai));
+		return false;
+	}
+
+	// create our socket and start the connection (completion is reported via the runLoop)
+	netClientIn->socket = socket(addrs->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, addrs->ai_protocol);
+	if( netClientIn->socket < 0 )
+	{
+		cxa_logger_warn(&netClientIn->super.logger, "error creating socket: %s", strerror(errno));
+		freeaddrinfo(addrs);
+		return false;
+	}
+	cxa_posix_network_socket_setOptions(netClientIn->socket);
+
+	cxa_logger_info(&netClientIn->super.logger, "connecting to '%s:%d'", hostNameIn, portNumIn);
+	int retVal_connect = connect(netClientIn->socket, addrs->ai_addr, addrs->ai_addrlen);
+	freeaddrinfo(addrs);
+	if( (retVal_connect < 0) && (errno != EINPROGRESS) )
+	{
+		cxa_logger_warn(&netClientIn->super.logger, "connect failed: %s", strerror(errno));
+		closeSocket(netClientIn);
+		return false;
+	}
+
+	// even if we connected immediately, we'll complete on the next iteration (like every other connect)
+	if( !cxa_posix_runLoop_addFd_events(netClientIn->threadId, netClientIn->socket, CXA_POSIX_RUNLOOP_FDEVENT_WRITABLE, cb_onSocketEvent, (void*)netClientIn) )
+	{
+		closeSocket(netClientIn);
+		return false;
+	}
+	netClientIn->state = CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTING;
+
+	// setup our timeout (0 means wait for the OS to give up)
+	netClientIn->connectTimeout_ms = timeout_msIn;
+	cxa_timeDiff_setStartTime_now(&netClientIn->super.td_genPurp);
+	if( timeout_msIn > 0 ) cxa_runLoop_dispatchAfter(netClientIn->threadId, timeout_msIn, cb_onConnectTimeout, (void*)netClientIn);
+
+	return true;
+}
+
+
+static void scm_disconnectFromHost(cxa_network_tcpClient_t *const superIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)superIn;
+	cxa_assert(netClientIn);
+
+	switch( netClientIn->state )
+	{
+		case CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTING:
+			handleConnectFail(netClientIn);
+			break;
+
+		case CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED:
+			handleDisconnect(netClientIn);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+static bool scm_isConnected(cxa_network_tcpClient_t *const superIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)superIn;
+	cxa_assert(netClientIn);
+
+	return (netClientIn->state == CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED);
+}
+
+
+static void cb_onSocketEvent(int fdIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	if( fdIn != netClientIn->socket ) return;
+
+	if( netClientIn->state == CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTING )
+	{
+		// writable means our connect has completed (one way or another)
+		int sockErr = 0;
+		socklen_t sockErrLen = sizeof(sockErr);
+		if( (getsockopt(netClientIn->socket, SOL_SOCKET, SO_ERROR, &sockErr, &sockErrLen) < 0) || (sockErr != 0) )
+		{
+			cxa_logger_warn(&netClientIn->super.logger, "connect failed: %s", strerror(sockErr));
+			handleConnectFail(netClientIn);
+			return;
+		}
+
+		// from now on we only care about incoming data (edge-triggered since our reader is a separate runLoop entry)
+		if( !cxa_posix_runLoop_modifyFd(netClientIn->threadId, netClientIn->socket, CXA_POSIX_RUNLOOP_FDEVENT_READABLE | CXA_POSIX_RUNLOOP_FDEVENT_EDGETRIGGERED) )
+		{
+			handleConnectFail(netClientIn);
+			return;
+		}
+
+		// data may have arrived before we started watching for it
+		netClientIn->isReadable = true;
+		cxa_ioStream_bind(&netClientIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)netClientIn);
+		cxa_ioStream_bindReadBytes(&netClientIn->super.ioStream, cb_ioStream_readBytes);
+		cxa_ioStream_bindWriteVectored(&netClientIn->super.ioStream, cb_ioStream_writeVectored);
+		netClientIn->state = CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED;
+
+		cxa_logger_info(&netClientIn->super.logger, "connected");
+		cxa_network_tcpClient_notify_connect(&netClientIn->super);
+	}
+	else if( netClientIn->state == CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED )
+	{
+		// data is consumed by our ioStream's reader...but we should notice closure even if nobody reads
+		netClientIn->isReadable = true;
+		if( cxa_posix_network_socket_isClosedByPeer(netClientIn->socket) ) handleDisconnect(netClientIn);
+	}
+}
+
+
+static void cb_onConnectTimeout(void* userVarIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	// this may be from a previous connection attempt
+	if( (netClientIn->state != CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTING) ||
+		!cxa_timeDiff_isElapsed_ms(&netClientIn->super.td_genPurp, netClientIn->connectTimeout_ms) ) return;
+
+	cxa_logger_warn(&netClientIn->super.logger, "connect timed out");
+	handleConnectFail(netClientIn);
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	uint8_t rxByte;
+	size_t numBytesRead;
+	cxa_ioStream_readStatus_t retVal = cb_ioStream_readBytes(&rxByte, 1, &numBytesRead, userVarIn);
+	if( (retVal == CXA_IOSTREAM_READSTAT_GOTDATA) && (byteOut != NULL) ) *byteOut = rxByte;
+
+	return retVal;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+	cxa_assert(numBytesReadOut);
+
+	// nothing new since we last drained the socket...don't bother the kernel
+	if( !netClientIn->isReadable )
+	{
+		*numBytesReadOut = 0;
+		return CXA_IOSTREAM_READSTAT_NODATA;
+	}
+
+	cxa_ioStream_readStatus_t retVal = cxa_posix_network_socket_read(netClientIn->socket, buffOut, maxNumBytesIn, numBytesReadOut);
+	if( retVal == CXA_IOSTREAM_READSTAT_NODATA ) netClientIn->isReadable = false;
+	else if( retVal == CXA_IOSTREAM_READSTAT_ERROR ) handleDisconnect(netClientIn);
+
+	return retVal;
+}
+
+
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	cxa_ioStream_ioVec_t vec = { .buff = buffIn, .bufferSize_bytes = bufferSize_bytesIn };
+	return cb_ioStream_writeVectored(&vec, 1, userVarIn);
+}
+
+
+static bool cb_ioStream_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpClient_t* netClientIn = (cxa_posix_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	// make sure we are connected
+	if( netClientIn->state != CXA_POSIX_NETWORK_TCPCLIENT_STATE_CONNECTED ) return false;
+
+	if( !cxa_posix_network_socket_writeVectored(netClientIn->socket, vecsIn, numVecsIn) )
+	{
+		cxa_logger_warn(&netClientIn->super.logger, "error during write: %s", strerror(errno));
+		handleDisconnect(netClientIn);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,214 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_network_tcpServer.h"
+
+
+// ******** includes ********
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <cxa_assert.h>
+#include <cxa_posix_runLoop.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#ifndef CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+	#error "cxa_posix_network_tcpServer requires CXA_RUNLOOP_POSIX_EVENTS_ENABLE (connections are accepted from the runLoop's fd callbacks)"
+#endif
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static cxa_posix_network_tcpServer_connectedClient_t* getFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn);
+
+static bool scm_listen(cxa_network_tcpServer_t *const superIn, uint16_t portNumIn);
+static void scm_stopListening(cxa_network_tcpServer_t *const superIn);
+
+static void cb_onListenSocketReadable(int fdIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_tcpServer_init(cxa_posix_network_tcpServer_t *const netServerIn, int threadIdIn)
+{
+	cxa_assert(netServerIn);
+
+	// set some defaults
+	netServerIn->threadId = threadIdIn;
+	netServerIn->listenSocket = -1;
+
+	// initialize our client connections
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		cxa_posix_network_tcpServer_connectedClient_initUnbound(&netServerIn->connectedClients[i], threadIdIn);
+	}
+
+	// initialize our super class
+	cxa_network_tcpServer_init(&netServerIn->super, scm_listen, scm_stopListening);
+}
+
+
+uint16_t cxa_posix_network_tcpServer_getListeningPort(cxa_posix_network_tcpServer_t *const netServerIn)
+{
+	cxa_assert(netServerIn);
+
+	if( netServerIn->listenSocket < 0 ) return 0;
+
+	struct sockaddr_in serverAddress;
+	socklen_t serverAddressLength = sizeof(serverAddress);
+	if( getsockname(netServerIn->listenSocket, (struct sockaddr *)&serverAddress, &serverAddressLength) < 0 ) return 0;
+
+	return ntohs(serverAddress.sin_port);
+}
+
+
+// ******** local function implementations ********
+static cxa_posix_network_tcpServer_connectedClient_t* getFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn)
+{
+	cxa_assert(netServerIn);
+
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		if( !cxa_network_tcpServer_connectedClient_isBound(&netServerIn->connectedClients[i].super) ) return &netServerIn->connectedClients[i];
+	}
+
+	return NULL;
+}
+
+
+static bool scm_listen(cxa_network_tcpServer_t *const superIn, uint16_t portNumIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)superIn;
+	cxa_assert(netServerIn);
+
+	// make sure we're able to listen
+	if( netServerIn->listenSocket >= 0 )
+	{
+		cxa_logger_warn(&netServerIn->super.logger, "bad state for listening");
+		return false;
+	}
+
+	// create a socket that we will listen upon
+	int listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+	if( listenSocket < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error creating socket: %s", strerror(errno));
+		return false;
+	}
+
+	// allow quick restarts (while old connections are in TIME_WAIT)
+	int optVal = 1;
+	setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &optVal, sizeof(optVal));
+
+	// bind our server socket to a port
+	struct sockaddr_in serverAddress;
+	memset(&serverAddress, 0, sizeof(serverAddress));
+	serverAddress.sin_family = AF_INET;
+	serverAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+	serverAddress.sin_port = htons(portNumIn);
+	if( bind(listenSocket, (struct sockaddr *)&serverAddress, sizeof(serverAddress)) < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error binding port %d: %s", portNumIn, strerror(errno));
+		close(listenSocket);
+		return false;
+	}
+
+	// flag the socket as listening for new connections
+	if( listen(listenSocket, CXA_POSIX_NETWORK_TCPSERVER_BACKLOG) < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error listening: %s", strerror(errno));
+		close(listenSocket);
+		return false;
+	}
+
+	// pending connections make our socket readable
+	if( !cxa_posix_runLoop_addFd(netServerIn->threadId, listenSocket, cb_onListenSocketReadable, (void*)netServerIn) )
+	{
+		close(listenSocket);
+		return false;
+	}
+
+	netServerIn->listenSocket = listenSocket;
+	cxa_logger_info(&netServerIn->super.logger, "listening on port %d", cxa_posix_network_tcpServer_getListeningPort(netServerIn));
+
+	return true;
+}
+
+
+static void scm_stopListening(cxa_network_tcpServer_t *const superIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)superIn;
+	cxa_assert(netServerIn);
+
+	if( netServerIn->listenSocket < 0 ) return;
+
+	cxa_logger_info(&netServerIn->super.logger, "stopping listening");
+
+	// first our clients
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		cxa_network_tcpServer_connectedClient_unbindAndClose(&netServerIn->connectedClients[i].super);
+	}
+
+	// now our server
+	cxa_posix_runLoop_removeFd(netServerIn->threadId, netServerIn->listenSocket);
+	close(netServerIn->listenSocket);
+	netServerIn->listenSocket = -1;
+}
+
+
+static void cb_onListenSocketReadable(int fdIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)userVarIn;
+	cxa_assert(netServerIn);
+
+	// accept everything that is pending (a listener may stop us mid-way)
+	while( (netServerIn->listenSocket >= 0) && (fdIn == netServerIn->listenSocket) )
+	{
+		struct sockaddr_in clientAddress;
+		socklen_t clientAddressLength = sizeof(clientAddress);
+		int clientSock = accept(netServerIn->listenSocket, (struct sockaddr *)&clientAddress, &clientAddressLength);
+		if( clientSock < 0 )
+		{
+			if( (errno == EINTR) || (errno == ECONNABORTED) ) continue;
+			if( (errno != EAGAIN) && (errno != EWOULDBLOCK) ) cxa_logger_error(&netServerIn->super.logger, "error accepting: %s", strerror(errno));
+			return;
+		}
+
+		fcntl(clientSock, F_SETFL, fcntl(clientSock, F_GETFL, 0) | O_NONBLOCK);
+		fcntl(clientSock, F_SETFD, FD_CLOEXEC);
+
+		char str[INET_ADDRSTRLEN];
+		inet_ntop(AF_INET, &clientAddress.sin_addr, str, sizeof(str));
+
+		// if we're full, close it now (rather than leaving it in our backlog)
+		cxa_posix_network_tcpServer_connectedClient_t* targetClient = getFreeConnectedClient(netServerIn);
+		if( targetClient == NULL )
+		{
+			cxa_logger_warn(&netServerIn->super.logger, "no free clients, rejecting connection from %s", str);
+			close(clientSock);
+			continue;
+		}
+
+		cxa_logger_info(&netServerIn->super.logger, "got connection from %s", str);
+		if( cxa_posix_network_tcpServer_connectedClient_bindToSocket(targetClient, clientSock, &clientAddress) )
+		{
+			cxa_network_tcpServer_notifyConnect(&netServerIn->super, &targetClient->super);
+		}
+	}
+}
@@ -0,0 +1,214 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_network_tcpServer_connectedClient.h"
+
+
+// ******** includes ********
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#include <cxa_assert.h>
+#include <cxa_posix_network_socket.h>
+#include <cxa_posix_runLoop.h>
+#include <cxa_stringUtils.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool scm_isBound(cxa_network_tcpServer_connectedClient_t *const superIn);
+static void scm_unbindAndClose(cxa_network_tcpServer_connectedClient_t *const superIn);
+static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *const superIn);
+
+static void cb_onSocketReadable(int fdIn, void *const userVarIn);
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool cb_ioStream_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_tcpServer_connectedClient_initUnbound(cxa_posix_network_tcpServer_connectedClient_t *const ccIn, int threadIdIn)
+{
+	cxa_assert(ccIn);
+
+	cxa_network_tcpServer_connectedClient_initUnbound(&ccIn->super, scm_isBound, scm_unbindAndClose, scm_getDescriptiveString);
+
+	ccIn->threadId = threadIdIn;
+	ccIn->socket = -1;
+	ccIn->isReadable = false;
+	ccIn->descriptiveString[0] = 0;
+}
+
+
+bool cxa_posix_network_tcpServer_connectedClient_bindToSocket(cxa_posix_network_tcpServer_connectedClient_t *const ccIn,
+															  int socketIn,
+															  struct sockaddr_in * clientAddressIn)
+{
+	cxa_assert(ccIn);
+	cxa_assert(socketIn >= 0);
+	cxa_assert(clientAddressIn);
+	cxa_assert(!scm_isBound(&ccIn->super));
+
+	cxa_posix_network_socket_setOptions(socketIn);
+
+	// edge-triggered since our reader is a separate runLoop entry (we just note that there's data and watch for closure)
+	if( !cxa_posix_runLoop_addFd_events(ccIn->threadId, socketIn, CXA_POSIX_RUNLOOP_FDEVENT_READABLE | CXA_POSIX_RUNLOOP_FDEVENT_EDGETRIGGERED,
+										cb_onSocketReadable, (void*)ccIn) )
+	{
+		close(socketIn);
+		return false;
+	}
+
+	ccIn->socket = socketIn;
+	ccIn->isReadable = true;
+	cxa_ioStream_bind(&ccIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)ccIn);
+	cxa_ioStream_bindReadBytes(&ccIn->super.ioStream, cb_ioStream_readBytes);
+	cxa_ioStream_bindWriteVectored(&ccIn->super.ioStream, cb_ioStream_writeVectored);
+
+	ccIn->descriptiveString[0] = 0;
+	inet_ntop(AF_INET, &clientAddressIn->sin_addr, ccIn->descriptiveString, sizeof(ccIn->descriptiveString));
+	cxa_stringUtils_concat_formattedString(ccIn->descriptiveString, sizeof(ccIn->descriptiveString), "::%d", ntohs(clientAddressIn->sin_port));
+
+	cxa_logger_debug(&ccIn->super.logger, "bound to socket %d", socketIn);
+
+	return true;
+}
+
+
+// ******** local function implementations ********
+static bool scm_isBound(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	return (ccIn->socket >= 0);
+}
+
+
+static void scm_unbindAndClose(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	if( ccIn->socket < 0 ) return;
+
+	cxa_logger_debug(&ccIn->super.logger, "unbinding and closing");
+
+	cxa_ioStream_unbind(&ccIn->super.ioStream);
+	cxa_posix_runLoop_removeFd(ccIn->threadId, ccIn->socket);
+	close(ccIn->socket);
+	ccIn->socket = -1;
+
+	// notify our listeners...then forget them (they were added for this connection, we'll be reused)
+	cxa_network_tcpServer_connectedClient_notifyDisconnected(&ccIn->super);
+	cxa_array_clear(&ccIn->super.listeners);
+}
+
+
+static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	return ccIn->descriptiveString;
+}
+
+
+static void cb_onSocketReadable(int fdIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	if( fdIn != ccIn->socket ) return;
+
+	ccIn->isReadable = true;
+	if( !cxa_posix_network_socket_isClosedByPeer(ccIn->socket) ) return;
+
+	cxa_logger_debug(&ccIn->super.logger, "connection closed");
+	scm_unbindAndClose(&ccIn->super);
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	uint8_t rxByte;
+	size_t numBytesRead;
+	cxa_ioStream_readStatus_t retVal = cb_ioStream_readBytes(&rxByte, 1, &numBytesRead, userVarIn);
+	if( (retVal == CXA_IOSTREAM_READSTAT_GOTDATA) && (byteOut != NULL) ) *byteOut = rxByte;
+
+	return retVal;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+	cxa_assert(numBytesReadOut);
+
+#ifdef CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+	// nothing new since we last drained the socket...don't bother the kernel
+	if( !ccIn->isReadable )
+	{
+		*numBytesReadOut = 0;
+		return CXA_IOSTREAM_READSTAT_NODATA;
+	}
+#endif
+
+	cxa_ioStream_readStatus_t retVal = cxa_posix_network_socket_read(ccIn->socket, buffOut, maxNumBytesIn, numBytesReadOut);
+	if( retVal == CXA_IOSTREAM_READSTAT_NODATA )
+	{
+		ccIn->isReadable = false;
+	}
+	else if( retVal == CXA_IOSTREAM_READSTAT_ERROR )
+	{
+		cxa_logger_debug(&ccIn->super.logger, "connection closed");
+		scm_unbindAndClose(&ccIn->super);
+	}
+
+	return retVal;
+}
+
+
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	cxa_ioStream_ioVec_t vec = { .buff = buffIn, .bufferSize_bytes = bufferSize_bytesIn };
+	return cb_ioStream_writeVectored(&vec, 1, userVarIn);
+}
+
+
+static bool cb_ioStream_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	// make sure we are connected
+	if( !scm_isBound(&ccIn->super) ) return false;
+
+	if( !cxa_posix_network_socket_writeVectored(ccIn->socket, vecsIn, numVecsIn) )
+	{
+		cxa_logger_warn(&ccIn->super.logger, "error during write: %s", strerror(errno));
+		scm_unbindAndClose(&ccIn->super);
+		return false;
+	}
+
+	return true;
+}
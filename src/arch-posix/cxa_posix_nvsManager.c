@@ -4,15 +4,23 @@
  *
  * @author Christopher Armenio
  */
-#include "cxa_nvsManager.h"
+#include "cxa_posix_nvsManager.h"
 
 
 // ******** includes ********
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <cxa_assert.h>
+#include <cxa_numberUtils.h>
 #include <cxa_stringUtils.h>
 
 
@@ -21,40 +29,220 @@
 
 
 // ******** local macro definitions ********
+#define FILE_MAGIC							"CXNV"
+#define FILE_VERSION						1
+#define FILEHEADER_SIZE_BYTES				8
+#define TMPFILE_SUFFIX						".tmp"
+
+// record: type(1) keyLen(1) valueLen(2) key value crc16(2)...all little endian
+#define RECORDHEADER_SIZE_BYTES				4
+#define RECORDCRC_SIZE_BYTES				2
+#define RECORD_OVERHEAD_BYTES				(RECORDHEADER_SIZE_BYTES + RECORDCRC_SIZE_BYTES)
+#define MAX_RECORD_SIZE_BYTES				(RECORD_OVERHEAD_BYTES + CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES + CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES)
+
+#define SNAPSHOT_SIZE_BYTES					(FILEHEADER_SIZE_BYTES + (CXA_POSIX_NVSMANAGER_MAXNUM_KEYS * (RECORD_OVERHEAD_BYTES + CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES)) + \
+											 CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES + RECORD_OVERHEAD_BYTES)
+#define COMPACT_TAIL_SIZE_BYTES				(CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES * 4)
+#define READ_BUFFER_SIZE_BYTES				65536
+
+#define INDEX_EMPTY							-1
+#define INDEX_DELETED						-2
 
 
 // ******** local type definitions ********
+typedef enum
+{
+	RECTYPE_CSTRING = 1,
+	RECTYPE_UINT8,
+	RECTYPE_UINT32,
+	RECTYPE_BLOB,
+	RECTYPE_ERASE,
+	RECTYPE_ERASEALL,
+	RECTYPE_COMMIT
+}recordType_t;
+
+
+typedef struct
+{
+	bool isUsed;
+	recordType_t type;
+
+	char key[CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES+1];
+	size_t keyLen;
+	uint32_t hash;
+
+	// in valuePool
+	size_t valueOffset;
+	size_t valueSize_bytes;
+}entry_t;
 
 
 // ******** local function prototypes ********
-static bool getKeyAndDir(const char *const keyIn, char *const keyAndDirInOut, size_t maxKeyAndDirSize_bytesIn);
+static bool getPath(const char *const suffixIn, char *const pathOut, size_t maxPathSize_bytesIn);
+static uint32_t hashKey(const char *const keyIn, size_t keyLenIn);
+
+static entry_t* index_find(const char *const keyIn, size_t keyLenIn, uint32_t hashIn);
+static void index_insert(int16_t entryIndexIn);
+static void index_rebuild(void);
+
+static bool cache_canStore(entry_t *const entryIn, size_t valueLenIn);
+static bool cache_apply(recordType_t typeIn, const char *const keyIn, size_t keyLenIn, const uint8_t *const valueIn, size_t valueLenIn);
+static entry_t* cache_get(const char *const keyIn);
+static size_t cache_getLogSize_bytes(void);
+
+static uint8_t* pool_getValue(entry_t *const entryIn);
+static void pool_store(entry_t *const entryIn, const uint8_t *const valueIn, size_t valueLenIn);
+static void pool_compact(void);
+
+static size_t buildRecord(uint8_t *const bufferOut, recordType_t typeIn, const char *const keyIn, size_t keyLenIn, const uint8_t *const valueIn, size_t valueLenIn);
+static size_t readRecord(FILE *const fileIn, uint8_t *const recordOut);
+
+static bool update_locked(recordType_t typeIn, const char *const keyIn, const uint8_t *const valueIn, size_t valueLenIn);
+static bool commit_locked(void);
+static bool writeAll(int fdIn, const uint8_t *const bufferIn, size_t numBytesIn);
+
+static bool loadLog(void);
+
+static bool legacy_getPath(const char *const nameIn, char *const pathOut, size_t maxPathSize_bytesIn);
+static void legacy_scan(bool shouldImportIn);
+static bool legacy_get(const char *const keyIn, uint8_t *const valueOut, size_t maxOutputSize_bytesIn, bool addTerminatorIn, size_t *const actualOutputSize_bytesOut);
+static bool legacy_erase(const char *const keyIn);
+static void legacy_eraseAll(void);
+
+static void* compactionThread(void* userVarIn);
 
 
 // ********  local variable declarations *********
-static char NVS_DIR[255];
+static char NVS_DIR[PATH_MAX];
+static char logPath[PATH_MAX];
+static char tmpPath[PATH_MAX];
 
 static bool isInit = false;
 static cxa_logger_t logger;
 
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond_compact = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t cond_compactDone = PTHREAD_COND_INITIALIZER;
+static pthread_t compactThread;
+
+static entry_t entries[CXA_POSIX_NVSMANAGER_MAXNUM_KEYS];
+static int16_t hashIndex[CXA_POSIX_NVSMANAGER_INDEX_SIZE];
+static size_t index_numDeleted;
+
+static uint8_t valuePool[CXA_POSIX_NVSMANAGER_VALUE_POOL_BYTES];
+static size_t valuePool_end;
+static size_t valuePool_numLiveBytes;
+
+// files from the old layout that aren't in the log (read straight from disk)
+static bool legacy_hasUnimported;
+
+static int logFd = -1;
+static size_t logSize_bytes;
+
+static uint8_t pending[CXA_POSIX_NVSMANAGER_MAXNUM_PENDING_BYTES];
+static size_t pending_numBytes;
+
+static bool compact_isRequested;
+static bool compact_isInProgress;
+static bool compact_isAborted;
+static bool compact_isStopRequested;
+static uint8_t compact_snapshot[SNAPSHOT_SIZE_BYTES];
+static uint8_t compact_tail[COMPACT_TAIL_SIZE_BYTES];
+static size_t compact_tail_numBytes;
+
+static uint8_t recordBuffer[MAX_RECORD_SIZE_BYTES];
+
+static uint32_t stats_numCompactions;
+static uint32_t stats_numCompactions_failed;
+static uint32_t stats_numTailBatches;
+
 
 // ******** global function implementations ********
 void cxa_posix_nvsManager_init(char *const nvsDirIn)
 {
+	cxa_assert(nvsDirIn);
 	cxa_assert_msg(strlen(nvsDirIn) < (sizeof(NVS_DIR)-1), "nvs directory too long");
+	cxa_assert_msg(((CXA_POSIX_NVSMANAGER_INDEX_SIZE & (CXA_POSIX_NVSMANAGER_INDEX_SIZE-1)) == 0) &&
+				   (CXA_POSIX_NVSMANAGER_INDEX_SIZE >= (2 * CXA_POSIX_NVSMANAGER_MAXNUM_KEYS)), "bad index size");
+	if( isInit ) return;
 
 	cxa_logger_init(&logger, "nvsManager");
 
 	cxa_stringUtils_copy(NVS_DIR, nvsDirIn, sizeof(NVS_DIR));
+	cxa_assert_msg(getPath(CXA_POSIX_NVSMANAGER_LOG_FILENAME, logPath, sizeof(logPath)) &&
+				   getPath(CXA_POSIX_NVSMANAGER_LOG_FILENAME TMPFILE_SUFFIX, tmpPath, sizeof(tmpPath)), "nvs path too long");
+
+	pthread_mutex_lock(&mutex);
+	memset(entries, 0, sizeof(entries));
+	index_rebuild();
+	valuePool_end = 0;
+	valuePool_numLiveBytes = 0;
+	legacy_hasUnimported = false;
+	pending_numBytes = 0;
+	compact_isRequested = false;
+	compact_isInProgress = false;
+	compact_isStopRequested = false;
+	stats_numCompactions = 0;
+	stats_numCompactions_failed = 0;
+	stats_numTailBatches = 0;
+
+	// a leftover temp file is an interrupted compaction...the log itself is still intact
+	unlink(tmpPath);
+	cxa_assert_msg(loadLog(), "unable to open nvs log");
+	pthread_mutex_unlock(&mutex);
+
+	cxa_assert(pthread_create(&compactThread, NULL, compactionThread, NULL) == 0);
 
 	isInit = true;
 }
 
 
+void cxa_posix_nvsManager_deinit(void)
+{
+	if( !isInit ) return;
+
+	// the compaction thread owns the log while it's swapping it out
+	pthread_mutex_lock(&mutex);
+	while( compact_isInProgress ) pthread_cond_wait(&cond_compactDone, &mutex);
+	compact_isStopRequested = true;
+	pthread_cond_signal(&cond_compact);
+	pthread_mutex_unlock(&mutex);
+	pthread_join(compactThread, NULL);
+
+	close(logFd);
+	logFd = -1;
+	pending_numBytes = 0;
+	isInit = false;
+}
+
+
+void cxa_posix_nvsManager_getStats(cxa_posix_nvsManager_stats_t *const statsOut)
+{
+	cxa_assert(isInit);
+	cxa_assert(statsOut);
+
+	pthread_mutex_lock(&mutex);
+	statsOut->logSize_bytes = logSize_bytes;
+	statsOut->valuePool_numBytesUsed = valuePool_numLiveBytes;
+	statsOut->numCompactions = stats_numCompactions;
+	statsOut->numCompactions_failed = stats_numCompactions_failed;
+	statsOut->numTailBatches = stats_numTailBatches;
+	pthread_mutex_unlock(&mutex);
+}
+
+
 bool cxa_nvsManager_doesKeyExist(const char *const keyIn)
 {
 	cxa_assert(isInit);
-	cxa_assert_failWithMsg("not implemented");
-	return false;
+	cxa_assert(keyIn);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = (cache_get(keyIn) != NULL);
+	bool shouldCheckLegacy = !retVal && legacy_hasUnimported;
+	pthread_mutex_unlock(&mutex);
+
+	if( shouldCheckLegacy ) retVal = legacy_get(keyIn, NULL, 0, false, NULL);
+	return retVal;
 }
 
 
@@ -63,62 +251,113 @@ bool cxa_nvsManager_get_cString(const char *const keyIn, char *const valueOut, s
 	cxa_assert(isInit);
 	cxa_assert(keyIn);
 
-	char keyAndDir[64];
-	if( !getKeyAndDir(keyIn, keyAndDir, sizeof(keyAndDir)) ) return false;
-
-	FILE* file = fopen(keyAndDir, "r");
-	if( file == NULL ) return false;
+	pthread_mutex_lock(&mutex);
+	entry_t* entry = cache_get(keyIn);
 
-	if( valueOut != NULL )
+	// blobs are allowed for values imported from the old file-per-key layout
+	bool retVal = (entry != NULL) && ((entry->type == RECTYPE_CSTRING) || (entry->type == RECTYPE_BLOB));
+	if( retVal && (valueOut != NULL) )
 	{
-		size_t numBytesRead = 0;
-
-		// read one byte at a time
-		while( fread(((void*)&valueOut[numBytesRead]), 1, 1, file) == 1 )
+		if( entry->type == RECTYPE_CSTRING )
 		{
-			numBytesRead++;
-			if( numBytesRead == maxOutputSize_bytes ) break;
+			retVal = (entry->valueSize_bytes <= maxOutputSize_bytes);
+			if( retVal ) memcpy(valueOut, pool_getValue(entry), entry->valueSize_bytes);
 		}
-
-		// make sure we didn't have an error
-		if( ferror(file) != 0 )
+		else
 		{
-			fclose(file);
-			return false;
+			retVal = (entry->valueSize_bytes < maxOutputSize_bytes);
+			if( retVal )
+			{
+				memcpy(valueOut, pool_getValue(entry), entry->valueSize_bytes);
+				valueOut[entry->valueSize_bytes] = 0;
+			}
 		}
-
-		// make sure everything is null terminated
-		valueOut[numBytesRead] = 0;
 	}
+	bool shouldCheckLegacy = (entry == NULL) && legacy_hasUnimported;
+	pthread_mutex_unlock(&mutex);
 
-	// close our file
-	fclose(file);
-
-	return true;
+	if( shouldCheckLegacy ) retVal = legacy_get(keyIn, (uint8_t*)valueOut, maxOutputSize_bytes, true, NULL);
+	return retVal;
 }
 
 
 bool cxa_nvsManager_set_cString(const char *const keyIn, char *const valueIn)
 {
 	cxa_assert(isInit);
-	cxa_assert_failWithMsg("not implemented");
-	return false;
+	cxa_assert(keyIn);
+	cxa_assert(valueIn);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = update_locked(RECTYPE_CSTRING, keyIn, (uint8_t*)valueIn, strlen(valueIn)+1);
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "set error: '%s'", keyIn);
+	return retVal;
+}
+
+
+bool cxa_nvsManager_get_uint8(const char *const keyIn, uint8_t *const valueOut)
+{
+	cxa_assert(isInit);
+	cxa_assert(keyIn);
+
+	pthread_mutex_lock(&mutex);
+	entry_t* entry = cache_get(keyIn);
+	bool retVal = (entry != NULL) && (entry->type == RECTYPE_UINT8);
+	if( retVal && (valueOut != NULL) ) *valueOut = pool_getValue(entry)[0];
+	pthread_mutex_unlock(&mutex);
+
+	return retVal;
+}
+
+
+bool cxa_nvsManager_set_uint8(const char *const keyIn, uint8_t valueIn)
+{
+	cxa_assert(isInit);
+	cxa_assert(keyIn);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = update_locked(RECTYPE_UINT8, keyIn, &valueIn, sizeof(valueIn));
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "set error: '%s'", keyIn);
+	return retVal;
 }
 
 
 bool cxa_nvsManager_get_uint32(const char *const keyIn, uint32_t *const valueOut)
 {
 	cxa_assert(isInit);
-	cxa_assert_failWithMsg("not implemented");
-	return false;
+	cxa_assert(keyIn);
+
+	pthread_mutex_lock(&mutex);
+	entry_t* entry = cache_get(keyIn);
+	bool retVal = (entry != NULL) && (entry->type == RECTYPE_UINT32);
+	if( retVal && (valueOut != NULL) )
+	{
+		uint8_t* value = pool_getValue(entry);
+		*valueOut = ((uint32_t)value[0] << 0) | ((uint32_t)value[1] << 8) |
+					((uint32_t)value[2] << 16) | ((uint32_t)value[3] << 24);
+	}
+	pthread_mutex_unlock(&mutex);
+
+	return retVal;
 }
 
 
 bool cxa_nvsManager_set_uint32(const char *const keyIn, uint32_t valueIn)
 {
 	cxa_assert(isInit);
-	cxa_assert_failWithMsg("not implemented");
-	return false;
+	cxa_assert(keyIn);
+
+	uint8_t value_le[] = { (uint8_t)(valueIn >> 0), (uint8_t)(valueIn >> 8), (uint8_t)(valueIn >> 16), (uint8_t)(valueIn >> 24) };
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = update_locked(RECTYPE_UINT32, keyIn, value_le, sizeof(value_le));
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "set error: '%s'", keyIn);
+	return retVal;
 }
 
 
@@ -127,90 +366,675 @@ bool cxa_nvsManager_get_blob(const char *const keyIn, uint8_t *const valueOut, s
 	cxa_assert(isInit);
 	cxa_assert(keyIn);
 
-	char keyAndDir[64];
-	if( !getKeyAndDir(keyIn, keyAndDir, sizeof(keyAndDir)) ) return false;
+	pthread_mutex_lock(&mutex);
+	entry_t* entry = cache_get(keyIn);
+	bool retVal = (entry != NULL) && (entry->type == RECTYPE_BLOB);
+	if( retVal && (valueOut != NULL) )
+	{
+		retVal = (entry->valueSize_bytes <= maxOutputSize_bytesIn);
+		if( retVal ) memcpy(valueOut, pool_getValue(entry), entry->valueSize_bytes);
+	}
+	if( retVal && (actualOutputSize_bytesOut != NULL) ) *actualOutputSize_bytesOut = entry->valueSize_bytes;
+	bool shouldCheckLegacy = (entry == NULL) && legacy_hasUnimported;
+	pthread_mutex_unlock(&mutex);
 
-	FILE* file = fopen(keyAndDir, "r");
-	if( file == NULL ) return false;
+	if( shouldCheckLegacy ) retVal = legacy_get(keyIn, valueOut, maxOutputSize_bytesIn, false, actualOutputSize_bytesOut);
+	return retVal;
+}
+
+
+bool cxa_nvsManager_set_blob(const char *const keyIn, uint8_t *const valueIn, size_t blobSize_bytesIn)
+{
+	cxa_assert(isInit);
+	cxa_assert(keyIn);
+	cxa_assert((valueIn != NULL) || (blobSize_bytesIn == 0));
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = update_locked(RECTYPE_BLOB, keyIn, valueIn, blobSize_bytesIn);
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "set error: '%s'", keyIn);
+	return retVal;
+}
+
+
+bool cxa_nvsManager_erase(const char *const keyIn)
+{
+	cxa_assert(isInit);
+	cxa_assert(keyIn);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = (cache_get(keyIn) != NULL) && update_locked(RECTYPE_ERASE, keyIn, NULL, 0);
+
+	// imported files stay on disk...don't let them come back
+	if( legacy_erase(keyIn) ) retVal = true;
+	pthread_mutex_unlock(&mutex);
+
+	return retVal;
+}
+
+
+bool cxa_nvsManager_eraseAll(void)
+{
+	cxa_assert(isInit);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = update_locked(RECTYPE_ERASEALL, "", NULL, 0);
+	if( retVal ) legacy_eraseAll();
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "erase error");
+	return retVal;
+}
+
+
+bool cxa_nvsManager_commit(void)
+{
+	cxa_assert(isInit);
+
+	pthread_mutex_lock(&mutex);
+	bool retVal = commit_locked();
+	pthread_mutex_unlock(&mutex);
+
+	if( !retVal ) cxa_logger_warn(&logger, "commit error: %d", errno);
+	return retVal;
+}
+
+
+// ******** local function implementations ********
+static bool getPath(const char *const suffixIn, char *const pathOut, size_t maxPathSize_bytesIn)
+{
+	cxa_assert(suffixIn);
+	cxa_assert(pathOut);
+
+	memset(pathOut, 0, maxPathSize_bytesIn);
+	if( !cxa_stringUtils_concat(pathOut, NVS_DIR, maxPathSize_bytesIn) ) return false;
+	if( !cxa_stringUtils_concat(pathOut, "/", maxPathSize_bytesIn) ) return false;
+	if( !cxa_stringUtils_concat(pathOut, suffixIn, maxPathSize_bytesIn) ) return false;
+
+	return true;
+}
+
+
+static uint32_t hashKey(const char *const keyIn, size_t keyLenIn)
+{
+	// FNV-1a
+	uint32_t retVal = 2166136261u;
+	for( size_t i = 0; i < keyLenIn; i++ )
+	{
+		retVal ^= (uint8_t)keyIn[i];
+		retVal *= 16777619u;
+	}
+	return retVal;
+}
+
+
+static entry_t* index_find(const char *const keyIn, size_t keyLenIn, uint32_t hashIn)
+{
+	for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_INDEX_SIZE; i++ )
+	{
+		int16_t currSlot = hashIndex[(hashIn + i) & (CXA_POSIX_NVSMANAGER_INDEX_SIZE-1)];
+		if( currSlot == INDEX_EMPTY ) break;
+		if( currSlot == INDEX_DELETED ) continue;
+
+		entry_t* currEntry = &entries[currSlot];
+		if( (currEntry->hash == hashIn) && (currEntry->keyLen == keyLenIn) && (memcmp(currEntry->key, keyIn, keyLenIn) == 0) ) return currEntry;
+	}
+	return NULL;
+}
+
+
+static void index_insert(int16_t entryIndexIn)
+{
+	uint32_t hash = entries[entryIndexIn].hash;
+	for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_INDEX_SIZE; i++ )
+	{
+		int16_t* currSlot = &hashIndex[(hash + i) & (CXA_POSIX_NVSMANAGER_INDEX_SIZE-1)];
+		if( (*currSlot == INDEX_EMPTY) || (*currSlot == INDEX_DELETED) )
+		{
+			if( *currSlot == INDEX_DELETED ) index_numDeleted--;
+			*currSlot = entryIndexIn;
+			return;
+		}
+	}
+
+	// can't happen...the index is at least twice the number of entries
+	cxa_assert(false);
+}
+
+
+static void index_rebuild(void)
+{
+	for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_INDEX_SIZE; i++ ) hashIndex[i] = INDEX_EMPTY;
+	index_numDeleted = 0;
+
+	for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS; i++ )
+	{
+		if( entries[i].isUsed ) index_insert((int16_t)i);
+	}
+}
+
+
+static bool cache_canStore(entry_t *const entryIn, size_t valueLenIn)
+{
+	// a new key needs a free entry...
+	if( entryIn == NULL )
+	{
+		bool hasFreeEntry = false;
+		for( size_t i = 0; (i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS) && !hasFreeEntry; i++ ) hasFreeEntry = !entries[i].isUsed;
+		if( !hasFreeEntry ) return false;
+	}
+
+	// ...and the value has to fit alongside all the others (replacing the old one)
+	size_t numLiveBytes = valuePool_numLiveBytes - ((entryIn != NULL) ? entryIn->valueSize_bytes : 0);
+	return ((numLiveBytes + valueLenIn) <= sizeof(valuePool));
+}
+
+
+static bool cache_apply(recordType_t typeIn, const char *const keyIn, size_t keyLenIn, const uint8_t *const valueIn, size_t valueLenIn)
+{
+	if( typeIn == RECTYPE_COMMIT ) return true;
+
+	if( typeIn == RECTYPE_ERASEALL )
+	{
+		memset(entries, 0, sizeof(entries));
+		index_rebuild();
+		valuePool_end = 0;
+		valuePool_numLiveBytes = 0;
+		return true;
+	}
+
+	uint32_t hash = hashKey(keyIn, keyLenIn);
+	entry_t* entry = index_find(keyIn, keyLenIn, hash);
 
-	if( valueOut != NULL )
+	if( typeIn == RECTYPE_ERASE )
 	{
-		size_t numBytesRead = 0;
+		if( entry == NULL ) return true;
+		entry->isUsed = false;
+		valuePool_numLiveBytes -= entry->valueSize_bytes;
 
-		// read one byte at a time
-		while( fread(((void*)&valueOut[numBytesRead]), 1, 1, file) == 1 )
+		// tombstone the slot so later probes keep going
+		for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_INDEX_SIZE; i++ )
 		{
-			numBytesRead++;
-			if( numBytesRead == maxOutputSize_bytesIn ) break;
+			int16_t* currSlot = &hashIndex[(hash + i) & (CXA_POSIX_NVSMANAGER_INDEX_SIZE-1)];
+			if( *currSlot == (int16_t)(entry - entries) )
+			{
+				*currSlot = INDEX_DELETED;
+				index_numDeleted++;
+				break;
+			}
 		}
+		if( index_numDeleted > (CXA_POSIX_NVSMANAGER_INDEX_SIZE / 4) ) index_rebuild();
+		return true;
+	}
+
+	if( !cache_canStore(entry, valueLenIn) ) return false;
 
-		// make sure we didn't have an error
-		if( ferror(file) != 0 )
+	if( entry == NULL )
+	{
+		for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS; i++ )
 		{
-			fclose(file);
-			return false;
+			if( !entries[i].isUsed )
+			{
+				entry = &entries[i];
+				break;
+			}
 		}
+		cxa_assert(entry);
 
-		// set our output size if desired
-		if( actualOutputSize_bytesOut != NULL ) *actualOutputSize_bytesOut = numBytesRead;
+		entry->isUsed = true;
+		memcpy(entry->key, keyIn, keyLenIn);
+		entry->key[keyLenIn] = 0;
+		entry->keyLen = keyLenIn;
+		entry->hash = hash;
+		entry->valueOffset = 0;
+		entry->valueSize_bytes = 0;
+		index_insert((int16_t)(entry - entries));
 	}
 
-	// close our file
-	fclose(file);
+	entry->type = typeIn;
+	pool_store(entry, valueIn, valueLenIn);
 
 	return true;
 }
 
 
-bool cxa_nvsManager_set_blob(const char *const keyIn, uint8_t *const valueIn, size_t blobSize_bytesIn)
+static entry_t* cache_get(const char *const keyIn)
 {
-	cxa_assert(isInit);
-	cxa_assert(keyIn);
+	size_t keyLen = strlen(keyIn);
+	if( (keyLen == 0) || (keyLen > CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES) ) return NULL;
 
-	char keyAndDir[64];
-	if( !getKeyAndDir(keyIn, keyAndDir, sizeof(keyAndDir)) ) return false;
+	return index_find(keyIn, keyLen, hashKey(keyIn, keyLen));
+}
 
-	FILE* file = fopen(keyAndDir, "w");
-	if( file == NULL ) return false;
 
-	if( fwrite((void*)valueIn, blobSize_bytesIn, 1, file) != 1 )
+static size_t cache_getLogSize_bytes(void)
+{
+	// size of a freshly compacted log holding the current values
+	size_t retVal = FILEHEADER_SIZE_BYTES + RECORD_OVERHEAD_BYTES;
+	for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS; i++ )
+	{
+		if( entries[i].isUsed ) retVal += RECORD_OVERHEAD_BYTES + entries[i].keyLen + entries[i].valueSize_bytes;
+	}
+	return retVal;
+}
+
+
+static uint8_t* pool_getValue(entry_t *const entryIn)
+{
+	return &valuePool[entryIn->valueOffset];
+}
+
+
+static void pool_store(entry_t *const entryIn, const uint8_t *const valueIn, size_t valueLenIn)
+{
+	valuePool_numLiveBytes -= entryIn->valueSize_bytes;
+	valuePool_numLiveBytes += valueLenIn;
+
+	// most updates keep the same size (or shrink) so they stay where they are
+	if( valueLenIn > entryIn->valueSize_bytes )
+	{
+		// otherwise it goes at the end, closing the gaps first if needed
+		entryIn->valueSize_bytes = 0;
+		if( (valuePool_end + valueLenIn) > sizeof(valuePool) ) pool_compact();
+		cxa_assert((valuePool_end + valueLenIn) <= sizeof(valuePool));
+
+		entryIn->valueOffset = valuePool_end;
+		valuePool_end += valueLenIn;
+	}
+
+	if( valueLenIn > 0 ) memcpy(pool_getValue(entryIn), valueIn, valueLenIn);
+	entryIn->valueSize_bytes = valueLenIn;
+}
+
+
+static void pool_compact(void)
+{
+	// slide the values down in address order (they never overlap so each fits below the next)
+	size_t newEnd = 0;
+	while( 1 )
+	{
+		entry_t* nextEntry = NULL;
+		for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS; i++ )
+		{
+			entry_t* currEntry = &entries[i];
+			if( !currEntry->isUsed || (currEntry->valueSize_bytes == 0) || (currEntry->valueOffset < newEnd) ) continue;
+			if( (nextEntry == NULL) || (currEntry->valueOffset < nextEntry->valueOffset) ) nextEntry = currEntry;
+		}
+		if( nextEntry == NULL ) break;
+
+		if( nextEntry->valueOffset != newEnd ) memmove(&valuePool[newEnd], pool_getValue(nextEntry), nextEntry->valueSize_bytes);
+		nextEntry->valueOffset = newEnd;
+		newEnd += nextEntry->valueSize_bytes;
+	}
+	valuePool_end = newEnd;
+}
+
+
+static size_t buildRecord(uint8_t *const bufferOut, recordType_t typeIn, const char *const keyIn, size_t keyLenIn, const uint8_t *const valueIn, size_t valueLenIn)
+{
+	cxa_assert(keyLenIn <= CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES);
+	cxa_assert(valueLenIn <= CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES);
+
+	size_t numBytes = 0;
+	bufferOut[numBytes++] = (uint8_t)typeIn;
+	bufferOut[numBytes++] = (uint8_t)keyLenIn;
+	bufferOut[numBytes++] = (uint8_t)(valueLenIn >> 0);
+	bufferOut[numBytes++] = (uint8_t)(valueLenIn >> 8);
+	if( keyLenIn > 0 ) memcpy(&bufferOut[numBytes], keyIn, keyLenIn);
+	numBytes += keyLenIn;
+	if( valueLenIn > 0 ) memcpy(&bufferOut[numBytes], valueIn, valueLenIn);
+	numBytes += valueLenIn;
+
+	uint16_t crc = cxa_numberUtils_crc16_oneShot(bufferOut, numBytes);
+	bufferOut[numBytes++] = (uint8_t)(crc >> 0);
+	bufferOut[numBytes++] = (uint8_t)(crc >> 8);
+
+	return numBytes;
+}
+
+
+static size_t readRecord(FILE *const fileIn, uint8_t *const recordOut)
+{
+	if( fread(recordOut, RECORDHEADER_SIZE_BYTES, 1, fileIn) != 1 ) return 0;
+
+	recordType_t type = (recordType_t)recordOut[0];
+	size_t keyLen = recordOut[1];
+	size_t valueLen = (size_t)recordOut[2] | ((size_t)recordOut[3] << 8);
+	if( (type < RECTYPE_CSTRING) || (type > RECTYPE_COMMIT) ||
+		(keyLen > CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES) ||
+		(valueLen > CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES) ) return 0;
+
+	size_t bodySize_bytes = keyLen + valueLen + RECORDCRC_SIZE_BYTES;
+	if( fread(&recordOut[RECORDHEADER_SIZE_BYTES], bodySize_bytes, 1, fileIn) != 1 ) return 0;
+
+	size_t crcIndex = RECORDHEADER_SIZE_BYTES + keyLen + valueLen;
+	uint16_t crc = (uint16_t)recordOut[crcIndex] | ((uint16_t)recordOut[crcIndex+1] << 8);
+	if( cxa_numberUtils_crc16_oneShot(recordOut, crcIndex) != crc ) return 0;
+
+	return crcIndex + RECORDCRC_SIZE_BYTES;
+}
+
+
+static bool update_locked(recordType_t typeIn, const char *const keyIn, const uint8_t *const valueIn, size_t valueLenIn)
+{
+	size_t keyLen = strlen(keyIn);
+	if( (typeIn != RECTYPE_ERASEALL) && ((keyLen == 0) || (keyLen > CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES)) ) return false;
+	if( valueLenIn > CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES ) return false;
+
+	// make sure the cache can take it before we log anything
+	if( (typeIn != RECTYPE_ERASE) && (typeIn != RECTYPE_ERASEALL) && !cache_canStore(cache_get(keyIn), valueLenIn) ) return false;
+
+	// always leave room for the commit record
+	size_t recordSize_bytes = RECORD_OVERHEAD_BYTES + keyLen + valueLenIn;
+	if( (pending_numBytes + recordSize_bytes + RECORD_OVERHEAD_BYTES) > sizeof(pending) )
+	{
+		if( !commit_locked() ) return false;
+	}
+	pending_numBytes += buildRecord(&pending[pending_numBytes], typeIn, keyIn, keyLen, valueIn, valueLenIn);
+
+	return cache_apply(typeIn, keyIn, keyLen, valueIn, valueLenIn);
+}
+
+
+static bool commit_locked(void)
+{
+	if( pending_numBytes == 0 ) return true;
+
+	size_t batchSize_bytes = pending_numBytes + buildRecord(&pending[pending_numBytes], RECTYPE_COMMIT, "", 0, NULL, 0);
+
+	// one write and one sync for the whole batch
+	if( !writeAll(logFd, pending, batchSize_bytes) || (fdatasync(logFd) != 0) )
 	{
-		fclose(file);
+		// don't leave a partial batch in front of the next one
+		int errnoSave = errno;
+		if( ftruncate(logFd, (off_t)logSize_bytes) != 0 ) cxa_logger_error(&logger, "unable to truncate log: %d", errno);
+		lseek(logFd, 0, SEEK_END);
+		errno = errnoSave;
 		return false;
 	}
+	logSize_bytes += batchSize_bytes;
+
+	// the compaction thread needs to append this to its new log as well
+	if( compact_isInProgress )
+	{
+		if( (compact_tail_numBytes + batchSize_bytes) <= sizeof(compact_tail) )
+		{
+			memcpy(&compact_tail[compact_tail_numBytes], pending, batchSize_bytes);
+			compact_tail_numBytes += batchSize_bytes;
+			stats_numTailBatches++;
+		}
+		else compact_isAborted = true;
+	}
+	pending_numBytes = 0;
+
+	if( !compact_isInProgress && (logSize_bytes > CXA_POSIX_NVSMANAGER_COMPACT_MIN_BYTES) &&
+		(logSize_bytes > (2 * cache_getLogSize_bytes())) )
+	{
+		compact_isRequested = true;
+	}
+	if( compact_isRequested ) pthread_cond_signal(&cond_compact);
 
-	fclose(file);
 	return true;
 }
 
 
-bool cxa_nvsManager_erase(const char *const keyIn)
+static bool writeAll(int fdIn, const uint8_t *const bufferIn, size_t numBytesIn)
 {
-	cxa_assert(isInit);
-	cxa_assert(keyIn);
+	size_t numBytesWritten = 0;
+	while( numBytesWritten < numBytesIn )
+	{
+		ssize_t retVal = write(fdIn, &bufferIn[numBytesWritten], numBytesIn - numBytesWritten);
+		if( retVal < 0 )
+		{
+			if( errno == EINTR ) continue;
+			return false;
+		}
+		numBytesWritten += (size_t)retVal;
+	}
+	return true;
+}
+
+
+static bool loadLog(void)
+{
+	logFd = open(logPath, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if( logFd < 0 ) return false;
+
+	struct stat logStat;
+	if( fstat(logFd, &logStat) != 0 ) return false;
+
+	// brand new log...write our header and bring over anything from the old layout
+	if( logStat.st_size == 0 )
+	{
+		uint8_t header[FILEHEADER_SIZE_BYTES] = { FILE_MAGIC[0], FILE_MAGIC[1], FILE_MAGIC[2], FILE_MAGIC[3], FILE_VERSION, 0, 0, 0 };
+		if( !writeAll(logFd, header, sizeof(header)) || (fsync(logFd) != 0) ) return false;
+		logSize_bytes = sizeof(header);
+
+		legacy_scan(true);
+		return true;
+	}
+
+	FILE* logFile = fopen(logPath, "rb");
+	if( logFile == NULL ) return false;
+	static char readBuffer[READ_BUFFER_SIZE_BYTES];
+	setvbuf(logFile, readBuffer, _IOFBF, sizeof(readBuffer));
+
+	uint8_t header[FILEHEADER_SIZE_BYTES];
+	if( (fread(header, sizeof(header), 1, logFile) != 1) || (memcmp(header, FILE_MAGIC, 4) != 0) || (header[4] != FILE_VERSION) )
+	{
+		fclose(logFile);
+		cxa_logger_error(&logger, "'%s' is not a valid nvs log", logPath);
+		return false;
+	}
+
+	// first pass: find the end of the last complete batch...
+	size_t validEnd_bytes = sizeof(header);
+	size_t currPos_bytes = sizeof(header);
+	size_t recordSize_bytes;
+	while( (recordSize_bytes = readRecord(logFile, recordBuffer)) > 0 )
+	{
+		currPos_bytes += recordSize_bytes;
+		if( recordBuffer[0] == RECTYPE_COMMIT ) validEnd_bytes = currPos_bytes;
+	}
+
+	// ...second pass: apply everything up to it
+	fseek(logFile, sizeof(header), SEEK_SET);
+	for( currPos_bytes = sizeof(header); currPos_bytes < validEnd_bytes; currPos_bytes += recordSize_bytes )
+	{
+		recordSize_bytes = readRecord(logFile, recordBuffer);
+		cxa_assert(recordSize_bytes > 0);
 
-	char keyAndDir[64];
-	if( !getKeyAndDir(keyIn, keyAndDir, sizeof(keyAndDir)) ) return false;
+		size_t keyLen = recordBuffer[1];
+		size_t valueLen = (size_t)recordBuffer[2] | ((size_t)recordBuffer[3] << 8);
+		if( !cache_apply((recordType_t)recordBuffer[0], (char*)&recordBuffer[RECORDHEADER_SIZE_BYTES], keyLen,
+						 &recordBuffer[RECORDHEADER_SIZE_BYTES + keyLen], valueLen) )
+		{
+			cxa_logger_error(&logger, "no room for '%.*s' (too many keys or values), dropped", (int)keyLen, (char*)&recordBuffer[RECORDHEADER_SIZE_BYTES]);
+		}
+	}
+	fclose(logFile);
+
+	// anything past the last commit is a torn write or an uncommitted batch
+	if( validEnd_bytes < (size_t)logStat.st_size )
+	{
+		cxa_logger_warn(&logger, "discarding %d bytes of incomplete data", (int)((size_t)logStat.st_size - validEnd_bytes));
+		if( (ftruncate(logFd, (off_t)validEnd_bytes) != 0) || (fsync(logFd) != 0) ) return false;
+	}
+	logSize_bytes = validEnd_bytes;
+	lseek(logFd, 0, SEEK_END);
 
-	return (remove(keyAndDir) == 0);
+	cxa_logger_debug(&logger, "loaded %d bytes", (int)logSize_bytes);
+	legacy_scan(false);
+	return true;
 }
 
 
-bool cxa_nvsManager_commit(void)
+static bool legacy_getPath(const char *const nameIn, char *const pathOut, size_t maxPathSize_bytesIn)
 {
-	cxa_assert(isInit);
-	cxa_assert_failWithMsg("not implemented");
-	return false;
+	// the old layout kept one file per key right in the nvs directory
+	if( (nameIn[0] == 0) || (nameIn[0] == '.') || (strchr(nameIn, '/') != NULL) ||
+		(strcmp(nameIn, CXA_POSIX_NVSMANAGER_LOG_FILENAME) == 0) ||
+		(strcmp(nameIn, CXA_POSIX_NVSMANAGER_LOG_FILENAME TMPFILE_SUFFIX) == 0) ) return false;
+
+	return getPath(nameIn, pathOut, maxPathSize_bytesIn);
 }
 
 
-// ******** local function implementations ********
-static bool getKeyAndDir(const char *const keyIn, char *const keyAndDirInOut, size_t maxKeyAndDirSize_bytesIn)
+static void legacy_scan(bool shouldImportIn)
 {
-	memset(keyAndDirInOut, 0, maxKeyAndDirSize_bytesIn);
-	if( !cxa_stringUtils_concat(keyAndDirInOut, NVS_DIR, maxKeyAndDirSize_bytesIn) ) return false;
-	if( !cxa_stringUtils_concat(keyAndDirInOut, "/", maxKeyAndDirSize_bytesIn) ) return false;
-	if( !cxa_stringUtils_concat(keyAndDirInOut, keyIn, maxKeyAndDirSize_bytesIn) ) return false;
+	DIR* dir = opendir(NVS_DIR);
+	if( dir == NULL ) return;
 
-	return true;
+	struct dirent* currEntry;
+	while( (currEntry = readdir(dir)) != NULL )
+	{
+		char filePath[PATH_MAX];
+		struct stat fileStat;
+		if( !legacy_getPath(currEntry->d_name, filePath, sizeof(filePath)) ||
+			(stat(filePath, &fileStat) != 0) || !S_ISREG(fileStat.st_mode) ) continue;
+
+		// already in the log (imported when it was created, or set since)
+		if( cache_get(currEntry->d_name) != NULL ) continue;
+
+		if( shouldImportIn )
+		{
+			size_t valueSize_bytes;
+			if( (strlen(currEntry->d_name) <= CXA_POSIX_NVSMANAGER_MAXLEN_KEY_BYTES) &&
+				(fileStat.st_size <= CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES) &&
+				legacy_get(currEntry->d_name, recordBuffer, CXA_POSIX_NVSMANAGER_MAXNUM_VALUE_BYTES, false, &valueSize_bytes) &&
+				update_locked(RECTYPE_BLOB, currEntry->d_name, recordBuffer, valueSize_bytes) )
+			{
+				cxa_logger_info(&logger, "imported '%s'", currEntry->d_name);
+				continue;
+			}
+		}
+
+		// never silently lose a value...it's still served from its file
+		cxa_logger_error(&logger, "'%s' (%d bytes) not in log, reading it from the old layout", currEntry->d_name, (int)fileStat.st_size);
+		legacy_hasUnimported = true;
+	}
+	closedir(dir);
+
+	if( shouldImportIn ) commit_locked();
+}
+
+
+static bool legacy_get(const char *const keyIn, uint8_t *const valueOut, size_t maxOutputSize_bytesIn, bool addTerminatorIn, size_t *const actualOutputSize_bytesOut)
+{
+	char filePath[PATH_MAX];
+	if( !legacy_getPath(keyIn, filePath, sizeof(filePath)) ) return false;
+
+	FILE* file = fopen(filePath, "rb");
+	if( file == NULL ) return false;
+
+	struct stat fileStat;
+	bool retVal = (fstat(fileno(file), &fileStat) == 0) && S_ISREG(fileStat.st_mode);
+	size_t fileSize_bytes = retVal ? (size_t)fileStat.st_size : 0;
+	if( retVal && (valueOut != NULL) )
+	{
+		retVal = ((fileSize_bytes + (addTerminatorIn ? 1 : 0)) <= maxOutputSize_bytesIn) &&
+				 ((fileSize_bytes == 0) || (fread(valueOut, fileSize_bytes, 1, file) == 1));
+		if( retVal && addTerminatorIn ) valueOut[fileSize_bytes] = 0;
+	}
+	if( retVal && (actualOutputSize_bytesOut != NULL) ) *actualOutputSize_bytesOut = fileSize_bytes;
+	fclose(file);
+
+	return retVal;
+}
+
+
+static bool legacy_erase(const char *const keyIn)
+{
+	char filePath[PATH_MAX];
+	return legacy_getPath(keyIn, filePath, sizeof(filePath)) && (unlink(filePath) == 0);
+}
+
+
+static void legacy_eraseAll(void)
+{
+	DIR* dir = opendir(NVS_DIR);
+	if( dir == NULL ) return;
+
+	struct dirent* currEntry;
+	while( (currEntry = readdir(dir)) != NULL )
+	{
+		char filePath[PATH_MAX];
+		struct stat fileStat;
+		if( !legacy_getPath(currEntry->d_name, filePath, sizeof(filePath)) ||
+			(stat(filePath, &fileStat) != 0) || !S_ISREG(fileStat.st_mode) ) continue;
+
+		unlink(filePath);
+	}
+	closedir(dir);
+
+	legacy_hasUnimported = false;
+}
+
+
+static void* compactionThread(void* userVarIn)
+{
+	pthread_mutex_lock(&mutex);
+	while( 1 )
+	{
+		// only snapshot committed state
+		while( !compact_isStopRequested && (!compact_isRequested || (pending_numBytes != 0)) ) pthread_cond_wait(&cond_compact, &mutex);
+		if( compact_isStopRequested ) break;
+		compact_isRequested = false;
+
+		size_t snapshotSize_bytes = 0;
+		uint8_t header[FILEHEADER_SIZE_BYTES] = { FILE_MAGIC[0], FILE_MAGIC[1], FILE_MAGIC[2], FILE_MAGIC[3], FILE_VERSION, 0, 0, 0 };
+		memcpy(compact_snapshot, header, sizeof(header));
+		snapshotSize_bytes += sizeof(header);
+		for( size_t i = 0; i < CXA_POSIX_NVSMANAGER_MAXNUM_KEYS; i++ )
+		{
+			entry_t* currEntry = &entries[i];
+			if( !currEntry->isUsed ) continue;
+			snapshotSize_bytes += buildRecord(&compact_snapshot[snapshotSize_bytes], currEntry->type, currEntry->key, currEntry->keyLen,
+											  pool_getValue(currEntry), currEntry->valueSize_bytes);
+		}
+		snapshotSize_bytes += buildRecord(&compact_snapshot[snapshotSize_bytes], RECTYPE_COMMIT, "", 0, NULL, 0);
+
+		compact_isInProgress = true;
+		compact_isAborted = false;
+		compact_tail_numBytes = 0;
+		pthread_mutex_unlock(&mutex);
+
+		// the slow part...commits carry on against the old log in the meantime
+		int tmpFd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		bool wasSuccessful = (tmpFd >= 0) && writeAll(tmpFd, compact_snapshot, snapshotSize_bytes) && (fdatasync(tmpFd) == 0);
+
+		pthread_mutex_lock(&mutex);
+		compact_isInProgress = false;
+		wasSuccessful = wasSuccessful && !compact_isAborted &&
+						writeAll(tmpFd, compact_tail, compact_tail_numBytes) && (fdatasync(tmpFd) == 0) &&
+						(rename(tmpPath, logPath) == 0);
+		if( wasSuccessful )
+		{
+			// make sure the rename itself is durable
+			int dirFd = open(NVS_DIR, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if( dirFd >= 0 )
+			{
+				fsync(dirFd);
+				close(dirFd);
+			}
+
+			close(logFd);
+			logFd = tmpFd;
+			logSize_bytes = snapshotSize_bytes + compact_tail_numBytes;
+			stats_numCompactions++;
+			cxa_logger_debug(&logger, "compacted to %d bytes", (int)logSize_bytes);
+		}
+		else
+		{
+			if( tmpFd >= 0 ) close(tmpFd);
+			unlink(tmpPath);
+			stats_numCompactions_failed++;
+			cxa_logger_warn(&logger, "compaction failed");
+		}
+		pthread_cond_broadcast(&cond_compactDone);
+	}
+	pthread_mutex_unlock(&mutex);
+
+	return NULL;
 }
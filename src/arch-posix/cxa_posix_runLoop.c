@@ -0,0 +1,294 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_runLoop.h"
+
+
+// ******** includes ********
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cxa_assert.h>
+#include <cxa_runLoop.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_TRACE
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define MAX_EVENTS_PER_WAIT				8
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	bool isUsed;
+	int threadId;
+
+	int fd;
+	cxa_posix_runLoop_cb_fdReadable_t cb;
+	void *userVar;
+}fdEntry_t;
+
+
+typedef struct
+{
+	bool isUsed;
+	int threadId;
+
+	int epollFd;
+	int eventFd;
+
+	int isWaiting;
+}threadEntry_t;
+
+
+// ******** local function prototypes ********
+static threadEntry_t* getThread(int threadIdIn, bool createIn);
+static uint32_t getWaitTime_ms(int threadIdIn);
+static uint32_t toEpollEvents(uint8_t eventsIn);
+
+
+// ********  local variable declarations *********
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static threadEntry_t threads[CXA_RUNLOOP_MAXNUM_THREADS];
+static fdEntry_t fdEntries[CXA_POSIX_RUNLOOP_MAXNUM_FDS];
+
+static bool isLoggerInit = false;
+static cxa_logger_t logger;
+
+
+// ******** global function implementations ********
+bool cxa_posix_runLoop_addFd(int threadIdIn, int fdIn, cxa_posix_runLoop_cb_fdReadable_t cbIn, void *const userVarIn)
+{
+	return cxa_posix_runLoop_addFd_events(threadIdIn, fdIn, CXA_POSIX_RUNLOOP_FDEVENT_READABLE, cbIn, userVarIn);
+}
+
+
+bool cxa_posix_runLoop_addFd_events(int threadIdIn, int fdIn, uint8_t eventsIn, cxa_posix_runLoop_cb_fdReadable_t cbIn, void *const userVarIn)
+{
+	cxa_assert(fdIn >= 0);
+
+	pthread_mutex_lock(&mutex);
+
+	threadEntry_t* thread = getThread(threadIdIn, true);
+	fdEntry_t* newEntry = NULL;
+	for( size_t i = 0; i < sizeof(fdEntries)/sizeof(*fdEntries); i++ )
+	{
+		if( !fdEntries[i].isUsed )
+		{
+			newEntry = &fdEntries[i];
+			break;
+		}
+	}
+	cxa_assert_msg(newEntry, "increase CXA_POSIX_RUNLOOP_MAXNUM_FDS");
+
+	newEntry->threadId = threadIdIn;
+	newEntry->fd = fdIn;
+	newEntry->cb = cbIn;
+	newEntry->userVar = userVarIn;
+
+	struct epoll_event ev = { .events = toEpollEvents(eventsIn), .data.ptr = (void*)newEntry };
+	bool retVal = (epoll_ctl(thread->epollFd, EPOLL_CTL_ADD, fdIn, &ev) == 0);
+	if( retVal )
+	{
+		newEntry->isUsed = true;
+	}
+	else
+	{
+		cxa_logger_warn(&logger, "unable to monitor fd %d: %d", fdIn, errno);
+	}
+
+	pthread_mutex_unlock(&mutex);
+
+	return retVal;
+}
+
+
+bool cxa_posix_runLoop_modifyFd(int threadIdIn, int fdIn, uint8_t eventsIn)
+{
+	bool retVal = false;
+
+	pthread_mutex_lock(&mutex);
+
+	threadEntry_t* thread = getThread(threadIdIn, false);
+	for( size_t i = 0; (thread != NULL) && (i < sizeof(fdEntries)/sizeof(*fdEntries)); i++ )
+	{
+		if( fdEntries[i].isUsed && (fdEntries[i].threadId == threadIdIn) && (fdEntries[i].fd == fdIn) )
+		{
+			struct epoll_event ev = { .events = toEpollEvents(eventsIn), .data.ptr = (void*)&fdEntries[i] };
+			retVal = (epoll_ctl(thread->epollFd, EPOLL_CTL_MOD, fdIn, &ev) == 0);
+			if( !retVal ) cxa_logger_warn(&logger, "unable to modify fd %d: %d", fdIn, errno);
+			break;
+		}
+	}
+
+	pthread_mutex_unlock(&mutex);
+
+	return retVal;
+}
+
+
+void cxa_posix_runLoop_removeFd(int threadIdIn, int fdIn)
+{
+	pthread_mutex_lock(&mutex);
+
+	threadEntry_t* thread = getThread(threadIdIn, false);
+	for( size_t i = 0; i < sizeof(fdEntries)/sizeof(*fdEntries); i++ )
+	{
+		if( fdEntries[i].isUsed && (fdEntries[i].threadId == threadIdIn) && (fdEntries[i].fd == fdIn) )
+		{
+			if( thread != NULL ) epoll_ctl(thread->epollFd, EPOLL_CTL_DEL, fdIn, NULL);
+			fdEntries[i].isUsed = false;
+		}
+	}
+
+	pthread_mutex_unlock(&mutex);
+}
+
+
+void cxa_posix_runLoop_wake(int threadIdIn)
+{
+	pthread_mutex_lock(&mutex);
+	threadEntry_t* thread = getThread(threadIdIn, false);
+	pthread_mutex_unlock(&mutex);
+	if( thread == NULL ) return;
+
+	uint64_t val = 1;
+	ssize_t retVal_write = write(thread->eventFd, &val, sizeof(val));
+	(void)retVal_write;		// EAGAIN means we're already signaled
+}
+
+
+void cxa_posix_runLoop_notifyWorkAdded(int threadIdIn)
+{
+	pthread_mutex_lock(&mutex);
+	threadEntry_t* thread = getThread(threadIdIn, false);
+	pthread_mutex_unlock(&mutex);
+
+	// only pay for the syscall if the thread is actually (about to be) asleep
+	if( (thread != NULL) && __atomic_load_n(&thread->isWaiting, __ATOMIC_SEQ_CST) )
+	{
+		uint64_t val = 1;
+		ssize_t retVal_write = write(thread->eventFd, &val, sizeof(val));
+		(void)retVal_write;
+	}
+}
+
+
+void cxa_posix_runLoop_waitForEvents(int threadIdIn)
+{
+	pthread_mutex_lock(&mutex);
+	threadEntry_t* thread = getThread(threadIdIn, true);
+	pthread_mutex_unlock(&mutex);
+
+	// announce that we're going to sleep _before_ we check for work so
+	// that any work added after our check will trigger our eventFd
+	__atomic_store_n(&thread->isWaiting, 1, __ATOMIC_SEQ_CST);
+
+	uint32_t waitTime_ms = getWaitTime_ms(threadIdIn);
+	if( waitTime_ms == 0 )
+	{
+		__atomic_store_n(&thread->isWaiting, 0, __ATOMIC_SEQ_CST);
+		return;
+	}
+
+	struct epoll_event events[MAX_EVENTS_PER_WAIT];
+	int numEvents = epoll_wait(thread->epollFd, events, MAX_EVENTS_PER_WAIT,
+							   (waitTime_ms == CXA_RUNLOOP_NO_DEADLINE) ? -1 : (int)waitTime_ms);
+	__atomic_store_n(&thread->isWaiting, 0, __ATOMIC_SEQ_CST);
+
+	for( int i = 0; i < numEvents; i++ )
+	{
+		fdEntry_t* currEntry = (fdEntry_t*)events[i].data.ptr;
+		if( currEntry == NULL )
+		{
+			// our eventFd...just clear it
+			uint64_t val;
+			ssize_t retVal_read = read(thread->eventFd, &val, sizeof(val));
+			(void)retVal_read;
+			continue;
+		}
+
+		// an earlier callback may have removed this fd
+		if( currEntry->isUsed && (currEntry->cb != NULL) ) currEntry->cb(currEntry->fd, currEntry->userVar);
+	}
+}
+
+
+// ******** local function implementations ********
+/**
+ * @note must be called with our mutex held
+ */
+static threadEntry_t* getThread(int threadIdIn, bool createIn)
+{
+	if( !isLoggerInit )
+	{
+		cxa_logger_init(&logger, "posixRunLoop");
+		isLoggerInit = true;
+	}
+
+	threadEntry_t* freeThread = NULL;
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
+	{
+		if( threads[i].isUsed && (threads[i].threadId == threadIdIn) ) return &threads[i];
+		if( !threads[i].isUsed && (freeThread == NULL) ) freeThread = &threads[i];
+	}
+	if( !createIn ) return NULL;
+	cxa_assert_msg(freeThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+
+	freeThread->threadId = threadIdIn;
+	freeThread->isWaiting = 0;
+
+	freeThread->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	cxa_assert(freeThread->epollFd >= 0);
+
+	freeThread->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	cxa_assert(freeThread->eventFd >= 0);
+
+	struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+	cxa_assert(epoll_ctl(freeThread->epollFd, EPOLL_CTL_ADD, freeThread->eventFd, &ev) == 0);
+
+	freeThread->isUsed = true;
+	return freeThread;
+}
+
+
+static uint32_t getWaitTime_ms(int threadIdIn)
+{
+	uint32_t retVal_ms = cxa_runLoop_getTimeToNextDeadline_ms(threadIdIn);
+	if( retVal_ms == 0 ) return 0;
+
+	switch( cxa_runLoop_getUntimedState(threadIdIn) )
+	{
+		case CXA_RUNLOOP_UNTIMED_PENDINGWORK:
+			retVal_ms = 0;
+			break;
+
+		case CXA_RUNLOOP_UNTIMED_MUSTPOLL:
+			if( retVal_ms > CXA_POSIX_RUNLOOP_MAX_POLLPERIOD_MS ) retVal_ms = CXA_POSIX_RUNLOOP_MAX_POLLPERIOD_MS;
+			break;
+
+		case CXA_RUNLOOP_UNTIMED_IDLE:
+			// nothing to poll...sleep until the next deadline, an fd or a dispatch
+			break;
+	}
+
+	return retVal_ms;
+}
+
+
+static uint32_t toEpollEvents(uint8_t eventsIn)
+{
+	uint32_t retVal = 0;
+	if( eventsIn & CXA_POSIX_RUNLOOP_FDEVENT_READABLE ) retVal |= EPOLLIN;
+	if( eventsIn & CXA_POSIX_RUNLOOP_FDEVENT_WRITABLE ) retVal |= EPOLLOUT;
+	if( eventsIn & CXA_POSIX_RUNLOOP_FDEVENT_EDGETRIGGERED ) retVal |= EPOLLET;
+	return retVal;
+}
@@ -15,9 +15,11 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/uio.h>
 
 
 // ******** local macro definitions ********
+#define MAXNUM_IOVECS_PER_WRITE					8
 
 
 // ******** local type definitions ********
@@ -28,7 +30,9 @@ static bool set_interface_attribs (int fd, int speed, int parity);
 static bool set_blocking (int fd, int should_block);
 
 static cxa_ioStream_readStatus_t ioStream_cb_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t ioStream_cb_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool ioStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool ioStream_cb_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn);
 
 
 // ********  local variable declarations *********
@@ -49,6 +53,8 @@ bool cxa_posix_usart_init_noHH(cxa_posix_usart_t *const usartIn, char *const pat
 	// setup our ioStream (last once everything is setup)
 	cxa_ioStream_init(&usartIn->super.ioStream);
 	cxa_ioStream_bind(&usartIn->super.ioStream, ioStream_cb_readByte, ioStream_cb_writeBytes, (void*)usartIn);
+	cxa_ioStream_bindReadBytes(&usartIn->super.ioStream, ioStream_cb_readBytes);
+	cxa_ioStream_bindWriteVectored(&usartIn->super.ioStream, ioStream_cb_writeVectored);
 
 	return true;
 }
@@ -62,15 +68,12 @@ void cxa_posix_usart_close(cxa_posix_usart_t *const usartIn)
 }
 
 
-/*
-FILE* cxa_usart_getFileDescriptor(cxa_usart_t *const superIn)
+int cxa_posix_usart_getFileDescriptor(cxa_posix_usart_t *const usartIn)
 {
-	cxa_assert(superIn);
-	cxa_x86posix_usart_t *const usartIn = (cxa_x86posix_usart_t *const)superIn;
+	cxa_assert(usartIn);
 
 	return usartIn->fd;
 }
-*/
 
 
 // ******** local function implementations ********
@@ -137,6 +140,20 @@ static cxa_ioStream_readStatus_t ioStream_cb_readByte(uint8_t *const byteOut, vo
 }
 
 
+static cxa_ioStream_readStatus_t ioStream_cb_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_posix_usart_t* usartIn = (cxa_posix_usart_t*)userVarIn;
+	cxa_assert(usartIn);
+
+	// one syscall for everything the driver has buffered
+	ssize_t retVal_read = read(usartIn->fd, buffOut, maxNumBytesIn);
+	if( retVal_read < 0 ) return CXA_IOSTREAM_READSTAT_ERROR;
+
+	*numBytesReadOut = (size_t)retVal_read;
+	return (retVal_read == 0) ? CXA_IOSTREAM_READSTAT_NODATA : CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
 static bool ioStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_posix_usart_t* usartIn = (cxa_posix_usart_t*)userVarIn;
@@ -156,3 +173,46 @@ static bool ioStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void
 
 	return true;
 }
+
+
+static bool ioStream_cb_writeVectored(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn)
+{
+	cxa_posix_usart_t* usartIn = (cxa_posix_usart_t*)userVarIn;
+	cxa_assert(usartIn);
+
+	struct iovec iovs[MAXNUM_IOVECS_PER_WRITE];
+	while( numVecsIn > 0 )
+	{
+		size_t numIovs = (numVecsIn < MAXNUM_IOVECS_PER_WRITE) ? numVecsIn : MAXNUM_IOVECS_PER_WRITE;
+		for( size_t i = 0; i < numIovs; i++ )
+		{
+			iovs[i].iov_base = vecsIn[i].buff;
+			iovs[i].iov_len = vecsIn[i].bufferSize_bytes;
+		}
+		vecsIn += numIovs;
+		numVecsIn -= numIovs;
+
+		// writev may not write everything...skip past whatever it did write and try again
+		struct iovec* currIov = iovs;
+		while( numIovs > 0 )
+		{
+			ssize_t retVal_write = writev(usartIn->fd, currIov, (int)numIovs);
+			if( retVal_write < 0 ) return false;
+
+			size_t numBytesSent = (size_t)retVal_write;
+			while( (numIovs > 0) && (numBytesSent >= currIov->iov_len) )
+			{
+				numBytesSent -= currIov->iov_len;
+				currIov++;
+				numIovs--;
+			}
+			if( numIovs > 0 )
+			{
+				currIov->iov_base = ((uint8_t*)currIov->iov_base) + numBytesSent;
+				currIov->iov_len -= numBytesSent;
+			}
+		}
+	}
+
+	return true;
+}
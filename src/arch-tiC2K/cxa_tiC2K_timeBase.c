@@ -42,4 +42,16 @@ uint32_t cxa_timeBase_getMaxCount_us(void)
 }
 
 
+uint64_t cxa_timeBase_getCount64_us(void)
+{
+	return cxa_timeBase_extendCount64_us();
+}
+
+
+uint64_t cxa_timeBase_getCount64_ns(void)
+{
+	return cxa_timeBase_getCount64_us() * 1000;
+}
+
+
 // ******** local function implementations ********
@@ -8,6 +8,8 @@
 
 
 // ******** includes ********
+#include <string.h>
+
 #include <cxa_assert.h>
 
 #define CXA_LOG_LEVEL			CXA_LOG_LEVEL_TRACE
@@ -18,17 +20,12 @@
 
 
 // ******** local type definitions ********
-typedef enum
-{
-	NEXT_FIELD_PARSE_RESULT_DONE,
-	NEXT_FIELD_PARSE_RESULT_MORE,
-	NEXT_FIELD_PARSE_RESULT_INVALID,
-}nextFieldParseResult_t;
 
 
 // ******** local function prototypes ********
-static nextFieldParseResult_t getByteIndexOfNextField(cxa_btle_advPacket_t *const advPacketIn, size_t currFieldByteIndexIn, size_t* nextFieldByteIndexOut);
-static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advField_t *advFieldIn, size_t fieldByteIndexIn);
+static bool indexFields(cxa_btle_advPacket_t *const advPacketIn);
+static size_t getUuidSize_bytes(uint8_t fieldTypeIn);
+static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advField_t *advFieldIn, cxa_btle_advPacket_fieldIndex_t *const fieldIndexIn);
 
 
 // ********  local variable declarations *********
@@ -48,11 +45,12 @@ bool cxa_btle_advPacket_init(cxa_btle_advPacket_t *const advPacketIn,
 	advPacketIn->isRandomAddress = isRandomAddressIn;
 	advPacketIn->rssi = rssiIn;
 
+	advPacketIn->numFields = 0;
 	cxa_fixedByteBuffer_initStd(&advPacketIn->fbb_data, advPacketIn->fbb_data_raw);
 	if( !cxa_fixedByteBuffer_append(&advPacketIn->fbb_data, dataIn, dataLen_bytesIn) ) return false;
 
 	// make sure we can do some rudimentary parsing of our packet
-	return cxa_btle_advPacket_getNumFields(advPacketIn, NULL);
+	return indexFields(advPacketIn);
 }
 
 
@@ -67,6 +65,10 @@ void cxa_btle_advPacket_initFromPacket(cxa_btle_advPacket_t *const advPacketIn,
 
 	cxa_fixedByteBuffer_initStd(&advPacketIn->fbb_data, advPacketIn->fbb_data_raw);
 	cxa_fixedByteBuffer_append_fbb(&advPacketIn->fbb_data, &sourcePacketIn->fbb_data);
+
+	// byte indices are relative to the data so the index carries over as-is
+	memcpy(advPacketIn->fields, sourcePacketIn->fields, sizeof(advPacketIn->fields));
+	advPacketIn->numFields = sourcePacketIn->numFields;
 }
 
 
@@ -82,16 +84,7 @@ bool cxa_btle_advPacket_getNumFields(cxa_btle_advPacket_t *const advPacketIn, si
 {
 	cxa_assert(advPacketIn);
 
-	int numAdvFields = 0;
-	size_t nextAdvFieldByteIndex = 0;
-	nextFieldParseResult_t parseResult;
-	while( (parseResult = getByteIndexOfNextField(advPacketIn, nextAdvFieldByteIndex, &nextAdvFieldByteIndex)) == NEXT_FIELD_PARSE_RESULT_MORE )
-	{
-		numAdvFields++;
-	}
-	if( parseResult != NEXT_FIELD_PARSE_RESULT_DONE ) return false;
-
-	if( numAdvFieldsOut != NULL ) *numAdvFieldsOut = numAdvFields;
+	if( numAdvFieldsOut != NULL ) *numAdvFieldsOut = advPacketIn->numFields;
 	return true;
 }
 
@@ -100,19 +93,20 @@ bool cxa_btle_advPacket_getField(cxa_btle_advPacket_t *const advPacketIn, size_t
 {
 	cxa_assert(advPacketIn);
 
-	int numAdvFields = 0;
-	size_t nextAdvFieldByteIndex = 0;
-	nextFieldParseResult_t parseResult;
-	do
+	if( fieldIndexIn >= advPacketIn->numFields ) return false;
+
+	return parseAdvField(advPacketIn, fieldOut, &advPacketIn->fields[fieldIndexIn]);
+}
+
+
+bool cxa_btle_advPacket_getField_byType(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advFieldType_t typeIn, cxa_btle_advField_t *const fieldOut)
+{
+	cxa_assert(advPacketIn);
+
+	for( size_t i = 0; i < advPacketIn->numFields; i++ )
 	{
-		if( numAdvFields == fieldIndexIn )
-		{
-			return parseAdvField(advPacketIn, fieldOut, nextAdvFieldByteIndex);
-		}
-		numAdvFields++;
+		if( advPacketIn->fields[i].type == typeIn ) return parseAdvField(advPacketIn, fieldOut, &advPacketIn->fields[i]);
 	}
-	while( (parseResult = getByteIndexOfNextField(advPacketIn, nextAdvFieldByteIndex, &nextAdvFieldByteIndex)) == NEXT_FIELD_PARSE_RESULT_MORE );
-	// if we made it here, we've failed
 
 	return false;
 }
@@ -122,29 +116,45 @@ bool cxa_btle_advPacket_isAdvertisingService(cxa_btle_advPacket_t *const advPack
 {
 	cxa_assert(advPacketIn);
 
-	size_t numAdvFields;
-	if( cxa_btle_advPacket_getNumFields(advPacketIn, &numAdvFields) )
+	// convert once up front rather than once per advertised uuid
+	cxa_btle_uuid_t targetUuid;
+	if( !cxa_btle_uuid_initFromString(&targetUuid, uuidIn) ) return false;
+
+	return cxa_btle_advPacket_isAdvertisingService_uuid(advPacketIn, &targetUuid);
+}
+
+
+bool cxa_btle_advPacket_isAdvertisingService_uuid(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_uuid_t *const uuidIn)
+{
+	cxa_assert(advPacketIn);
+	cxa_assert(uuidIn);
+
+	// get our target uuid in on-air (little endian) byte order
+	uint8_t targetBytes[sizeof(uuidIn->as128Bit.bytes)];
+	size_t uuidSize_bytes;
+	if( uuidIn->type == CXA_BTLE_UUID_TYPE_16BIT )
+	{
+		uuidSize_bytes = 2;
+		targetBytes[0] = (uint8_t)((uuidIn->as16Bit & 0x00FF) >> 0);
+		targetBytes[1] = (uint8_t)((uuidIn->as16Bit & 0xFF00) >> 8);
+	}
+	else
+	{
+		uuidSize_bytes = sizeof(uuidIn->as128Bit.bytes);
+		for( size_t i = 0; i < uuidSize_bytes; i++ ) targetBytes[i] = uuidIn->as128Bit.bytes[uuidSize_bytes-i-1];
+	}
+
+	// only look through the service uuid fields of the same size
+	for( size_t i = 0; i < advPacketIn->numFields; i++ )
 	{
-		for( size_t currFieldIndex = 0; currFieldIndex < numAdvFields; currFieldIndex++ )
+		cxa_btle_advPacket_fieldIndex_t* currField = &advPacketIn->fields[i];
+		if( getUuidSize_bytes(currField->type) != uuidSize_bytes ) continue;
+
+		uint8_t* uuidBytes = cxa_fixedByteBuffer_get_pointerToIndex(&advPacketIn->fbb_data, currField->byteIndex+2);
+		size_t numUuidBytes = currField->length - 1;
+		for( size_t currOffset = 0; (currOffset + uuidSize_bytes) <= numUuidBytes; currOffset += uuidSize_bytes )
 		{
-			cxa_btle_advField_t currField;
-			if( cxa_btle_advPacket_getField(advPacketIn, currFieldIndex, &currField) &&
-				((currField.type == CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS) ||
-				 (currField.type == CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS)) )
-			{
-				size_t numUuidsThisField;
-				if( cxa_btle_advField_getNumUuids(&currField, &numUuidsThisField) )
-				{
-					for( size_t currUuidIndex = 0; currUuidIndex < numUuidsThisField; currUuidIndex++ )
-					{
-						cxa_btle_uuid_t currUuid;
-						if( cxa_btle_advField_getUuid(&currField, currUuidIndex, &currUuid) )
-						{
-							if( cxa_btle_uuid_isEqualToString(&currUuid, uuidIn) ) return true;
-						}
-					}
-				}
-			}
+			if( memcmp(&uuidBytes[currOffset], targetBytes, uuidSize_bytes) == 0 ) return true;
 		}
 	}
 
@@ -155,10 +165,10 @@ bool cxa_btle_advPacket_isAdvertisingService(cxa_btle_advPacket_t *const advPack
 bool cxa_btle_advField_getNumUuids(cxa_btle_advField_t *const advFieldIn, size_t* numUuidsOut)
 {
 	// make sure this is the right type
-	if( (advFieldIn->type != CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS) &&
-		(advFieldIn->type != CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS) ) return false;
+	size_t uuidSize_bytes = getUuidSize_bytes(advFieldIn->type);
+	if( uuidSize_bytes == 0 ) return false;
 
-	if( numUuidsOut != NULL ) *numUuidsOut = cxa_fixedByteBuffer_getSize_bytes(&advFieldIn->asServiceUuids.uuidBytes) / 16;
+	if( numUuidsOut != NULL ) *numUuidsOut = cxa_fixedByteBuffer_getSize_bytes(&advFieldIn->asServiceUuids.uuidBytes) / uuidSize_bytes;
 
 	return true;
 }
@@ -169,64 +179,84 @@ bool cxa_btle_advField_getUuid(cxa_btle_advField_t *const advFieldIn, size_t uui
 	cxa_assert(advFieldIn);
 
 	// make sure this is the right type
-	if( (advFieldIn->type != CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS) &&
-		(advFieldIn->type != CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS) ) return false;
+	size_t uuidSize_bytes = getUuidSize_bytes(advFieldIn->type);
+	if( uuidSize_bytes == 0 ) return false;
 
 	// make sure we have enough bytes
-	if( cxa_fixedByteBuffer_getSize_bytes(&advFieldIn->asServiceUuids.uuidBytes) < ((uuidIndexIn*16) + 16) ) return false;
+	if( cxa_fixedByteBuffer_getSize_bytes(&advFieldIn->asServiceUuids.uuidBytes) < ((uuidIndexIn*uuidSize_bytes) + uuidSize_bytes) ) return false;
 
 	// parse it (if needed)
 	bool retVal = true;
 	if( uuidOut != NULL )
 	{
-		retVal = cxa_btle_uuid_initFromBuffer(uuidOut, &advFieldIn->asServiceUuids.uuidBytes, uuidIndexIn*16, 16, true);
+		retVal = cxa_btle_uuid_initFromBuffer(uuidOut, &advFieldIn->asServiceUuids.uuidBytes, uuidIndexIn*uuidSize_bytes, uuidSize_bytes, true);
 	}
 	return retVal;
 }
 
 
 // ******** local function implementations ********
-static nextFieldParseResult_t getByteIndexOfNextField(cxa_btle_advPacket_t *const advPacketIn, size_t currFieldByteIndexIn, size_t* nextFieldByteIndexOut)
+static bool indexFields(cxa_btle_advPacket_t *const advPacketIn)
 {
 	cxa_assert(advPacketIn);
 
-	// see if we're done
-	if( currFieldByteIndexIn == cxa_fixedByteBuffer_getSize_bytes(&advPacketIn->fbb_data) )
+	size_t dataSize_bytes = cxa_fixedByteBuffer_getSize_bytes(&advPacketIn->fbb_data);
+	uint8_t* data = cxa_fixedByteBuffer_get_pointerToIndex(&advPacketIn->fbb_data, 0);
+
+	advPacketIn->numFields = 0;
+	for( size_t currByteIndex = 0; currByteIndex < dataSize_bytes; )
 	{
-		return NEXT_FIELD_PARSE_RESULT_DONE;
+		// each field is <len> <type> <len-1 bytes of data>
+		uint8_t fieldLen = data[currByteIndex];
+		if( (fieldLen == 0) ||
+			((currByteIndex + fieldLen + 1) > dataSize_bytes) ||
+			(advPacketIn->numFields >= CXA_BTLE_ADVPACKET_MAXNUM_FIELDS) )
+		{
+			advPacketIn->numFields = 0;
+			return false;
+		}
+
+		cxa_btle_advPacket_fieldIndex_t* newField = &advPacketIn->fields[advPacketIn->numFields++];
+		newField->byteIndex = (uint8_t)currByteIndex;
+		newField->length = fieldLen;
+		newField->type = data[currByteIndex+1];
+
+		currByteIndex += fieldLen + 1;
 	}
 
-	// try to figure out where the next field is
-	uint8_t fieldLen;
-	if( (currFieldByteIndexIn > cxa_fixedByteBuffer_getSize_bytes(&advPacketIn->fbb_data)) ||
-		!cxa_fixedByteBuffer_get_uint8(&advPacketIn->fbb_data, currFieldByteIndexIn, fieldLen) ||
-		(fieldLen == 0) ||
-		(fieldLen + currFieldByteIndexIn + 1) > cxa_fixedByteBuffer_getSize_bytes(&advPacketIn->fbb_data) )
+	return true;
+}
+
+
+static size_t getUuidSize_bytes(uint8_t fieldTypeIn)
+{
+	switch( fieldTypeIn )
 	{
-		return NEXT_FIELD_PARSE_RESULT_INVALID;
-	}
+		case CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS16:
+		case CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS16:
+			return 2;
 
-	// return it
-	if( nextFieldByteIndexOut != NULL ) *nextFieldByteIndexOut = currFieldByteIndexIn + fieldLen + 1;
-	return NEXT_FIELD_PARSE_RESULT_MORE;
+		case CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS:
+		case CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS:
+			return 16;
+
+		default:
+			return 0;
+	}
 }
 
 
-static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advField_t *advFieldIn, size_t fieldByteIndexIn)
+static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advField_t *advFieldIn, cxa_btle_advPacket_fieldIndex_t *const fieldIndexIn)
 {
 	cxa_assert(advPacketIn);
+	cxa_assert(fieldIndexIn);
 
 	if( advFieldIn == NULL ) return true;
 
-	// first byte is always length byte
-	uint8_t length_raw;
-	if( !cxa_fixedByteBuffer_get_uint8(&advPacketIn->fbb_data, fieldByteIndexIn+0, length_raw) ) return false;
-	advFieldIn->length = length_raw;
-
-	// next is type
-	uint8_t type_raw;
-	if( !cxa_fixedByteBuffer_get_uint8(&advPacketIn->fbb_data, fieldByteIndexIn+1, type_raw) ) return false;
-	advFieldIn->type = type_raw;
+	// length and type were validated when the packet was indexed
+	size_t fieldByteIndexIn = fieldIndexIn->byteIndex;
+	advFieldIn->length = fieldIndexIn->length;
+	advFieldIn->type = fieldIndexIn->type;
 
 	// the rest depends on the type
 	switch( advFieldIn->type )
@@ -249,6 +279,8 @@ static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advF
 
 		case CXA_BTLE_ADVFIELDTYPE_MAN_DATA:
 		{
+			if( advFieldIn->length < 3 ) return false;
+
 			uint16_t companyId_raw;
 			if( !cxa_fixedByteBuffer_get_uint16LE(&advPacketIn->fbb_data, fieldByteIndexIn+2, companyId_raw) ) return false;
 			advFieldIn->asManufacturerData.companyId = companyId_raw;
@@ -258,6 +290,8 @@ static bool parseAdvField(cxa_btle_advPacket_t *const advPacketIn, cxa_btle_advF
 			break;
 		}
 
+		case CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS16:
+		case CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS16:
 		case CXA_BTLE_ADVFIELDTYPE_COMPLETE_SERVICE_UUIDS:
 		case CXA_BTLE_ADVFIELDTYPE_INCOMPLETE_SERVICE_UUIDS:
 		{
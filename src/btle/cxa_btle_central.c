@@ -17,12 +17,19 @@
 
 
 // ******** local macro definitions ********
+#define FNV1A_OFFSET_BASIS				0x811C9DC5
+#define FNV1A_PRIME						0x01000193
 
 
 // ******** local type definitions ********
 
 
 // ******** local function prototypes ********
+static bool scanFilters_isMatch(cxa_btle_central_t *const btlecIn, cxa_btle_advPacket_t *const packetIn);
+static bool scanFilters_append(cxa_btle_central_t *const btlecIn, cxa_btle_central_scanFilter_entry_t *const filterIn);
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+static bool dupCache_isDuplicate(cxa_btle_central_t *const btlecIn, cxa_btle_advPacket_t *const packetIn);
+#endif
 
 
 // ********  local variable declarations *********
@@ -51,6 +58,13 @@ void cxa_btle_central_init(cxa_btle_central_t *const btlecIn,
 	memset((void*)&btlecIn->cbs, 0, sizeof(btlecIn->cbs));
 	cxa_array_initStd(&btlecIn->listeners, btlecIn->listeners_raw);
 
+	// no filtering or duplicate suppression by default
+	cxa_array_initStd(&btlecIn->scanFilters, btlecIn->scanFilters_raw);
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	btlecIn->dupCache_numEntries = 0;
+	btlecIn->dupCache_window_ms = 0;
+#endif
+
 	// setup our logger
 	cxa_logger_init(&btlecIn->logger, "btleCentral");
 }
@@ -95,6 +109,9 @@ void cxa_btle_central_startScan_passive(cxa_btle_central_t *const btlecIn,
 
 	// start our scan
 	cxa_assert(btlecIn->scms.startScan);
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	btlecIn->dupCache_numEntries = 0;
+#endif
 	cxa_logger_info(&btlecIn->logger, "starting passive scan");
 	btlecIn->scms.startScan(btlecIn, false);
 }
@@ -125,6 +142,9 @@ void cxa_btle_central_startScan_active(cxa_btle_central_t *const btlecIn,
 
 	// start our scan
 	cxa_assert(btlecIn->scms.startScan);
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	btlecIn->dupCache_numEntries = 0;
+#endif
 	cxa_logger_info(&btlecIn->logger, "starting active scan");
 	btlecIn->scms.startScan(btlecIn, false);
 }
@@ -153,6 +173,64 @@ void cxa_btle_central_stopScan(cxa_btle_central_t *const btlecIn,
 }
 
 
+bool cxa_btle_central_addScanFilter_serviceUuid(cxa_btle_central_t *const btlecIn, cxa_btle_uuid_t *const uuidIn)
+{
+	cxa_assert(btlecIn);
+	cxa_assert(uuidIn);
+
+	cxa_btle_central_scanFilter_entry_t newFilter = { .type = CXA_BTLE_CENTRAL_SCANFILTER_SERVICE_UUID };
+	cxa_btle_uuid_initFromUuid(&newFilter.serviceUuid, uuidIn, false);
+
+	return scanFilters_append(btlecIn, &newFilter);
+}
+
+
+bool cxa_btle_central_addScanFilter_addressPrefix(cxa_btle_central_t *const btlecIn, uint8_t *const prefixBytesIn, size_t numPrefixBytesIn)
+{
+	cxa_assert(btlecIn);
+	cxa_assert(prefixBytesIn);
+
+	cxa_btle_central_scanFilter_entry_t newFilter = { .type = CXA_BTLE_CENTRAL_SCANFILTER_ADDR_PREFIX };
+	size_t numAddrBytes = sizeof(newFilter.addrPrefix.bytes);
+	cxa_assert( (numPrefixBytesIn > 0) && (numPrefixBytesIn <= numAddrBytes) );
+
+	// eui48 bytes are stored in reverse of the printed order...so is the prefix (at the end)
+	for( size_t i = 0; i < numPrefixBytesIn; i++ ) newFilter.addrPrefix.bytes[numAddrBytes-i-1] = prefixBytesIn[i];
+	newFilter.addrPrefix.numBytes = (uint8_t)numPrefixBytesIn;
+
+	return scanFilters_append(btlecIn, &newFilter);
+}
+
+
+bool cxa_btle_central_addScanFilter_companyId(cxa_btle_central_t *const btlecIn, uint16_t companyIdIn)
+{
+	cxa_assert(btlecIn);
+
+	cxa_btle_central_scanFilter_entry_t newFilter = { .type = CXA_BTLE_CENTRAL_SCANFILTER_COMPANY_ID, .companyId = companyIdIn };
+
+	return scanFilters_append(btlecIn, &newFilter);
+}
+
+
+void cxa_btle_central_clearScanFilters(cxa_btle_central_t *const btlecIn)
+{
+	cxa_assert(btlecIn);
+
+	cxa_array_clear(&btlecIn->scanFilters);
+}
+
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+void cxa_btle_central_setDuplicateWindow_ms(cxa_btle_central_t *const btlecIn, uint32_t window_msIn)
+{
+	cxa_assert(btlecIn);
+
+	btlecIn->dupCache_window_ms = window_msIn;
+	btlecIn->dupCache_numEntries = 0;
+}
+#endif
+
+
 cxa_btle_central_state_t cxa_btle_central_getState(cxa_btle_central_t *const btlecIn)
 {
 	cxa_assert(btlecIn);
@@ -231,8 +309,16 @@ void cxa_btle_central_notify_advertRx(cxa_btle_central_t *const btlecIn,
 									  cxa_btle_advPacket_t *packetIn)
 {
 	cxa_assert(btlecIn);
+	cxa_assert(packetIn);
+
+	// cheapest checks first...nobody listening, then filters, then duplicates
+	if( btlecIn->cbs.scanning.onAdvert == NULL ) return;
+	if( !scanFilters_isMatch(btlecIn, packetIn) ) return;
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+	if( dupCache_isDuplicate(btlecIn, packetIn) ) return;
+#endif
 
-	if( btlecIn->cbs.scanning.onAdvert != NULL ) btlecIn->cbs.scanning.onAdvert(packetIn, btlecIn->cbs.scanning.userVar);
+	btlecIn->cbs.scanning.onAdvert(packetIn, btlecIn->cbs.scanning.userVar);
 }
 
 
@@ -302,3 +388,109 @@ void cxa_btle_central_notify_connectionStarted(cxa_btle_central_t *const btlecIn
 
 
 // ******** local function implementations ********
+static bool scanFilters_isMatch(cxa_btle_central_t *const btlecIn, cxa_btle_advPacket_t *const packetIn)
+{
+	cxa_assert(btlecIn);
+	cxa_assert(packetIn);
+
+	// no filters means everything matches
+	if( cxa_array_isEmpty(&btlecIn->scanFilters) ) return true;
+
+	cxa_array_iterate(&btlecIn->scanFilters, currFilter, cxa_btle_central_scanFilter_entry_t)
+	{
+		if( currFilter == NULL ) continue;
+
+		switch( currFilter->type )
+		{
+			case CXA_BTLE_CENTRAL_SCANFILTER_SERVICE_UUID:
+				if( cxa_btle_advPacket_isAdvertisingService_uuid(packetIn, &currFilter->serviceUuid) ) return true;
+				break;
+
+			case CXA_BTLE_CENTRAL_SCANFILTER_ADDR_PREFIX:
+			{
+				size_t startIndex = sizeof(currFilter->addrPrefix.bytes) - currFilter->addrPrefix.numBytes;
+				if( memcmp(&packetIn->addr.bytes[startIndex], &currFilter->addrPrefix.bytes[startIndex], currFilter->addrPrefix.numBytes) == 0 ) return true;
+				break;
+			}
+
+			case CXA_BTLE_CENTRAL_SCANFILTER_COMPANY_ID:
+			{
+				cxa_btle_advField_t manField;
+				if( cxa_btle_advPacket_getField_byType(packetIn, CXA_BTLE_ADVFIELDTYPE_MAN_DATA, &manField) &&
+					(manField.asManufacturerData.companyId == currFilter->companyId) ) return true;
+				break;
+			}
+		}
+	}
+
+	return false;
+}
+
+
+static bool scanFilters_append(cxa_btle_central_t *const btlecIn, cxa_btle_central_scanFilter_entry_t *const filterIn)
+{
+	cxa_assert(btlecIn);
+	cxa_assert(filterIn);
+
+	if( !cxa_array_append(&btlecIn->scanFilters, filterIn) )
+	{
+		cxa_logger_warn(&btlecIn->logger, "too many scan filters");
+		return false;
+	}
+	return true;
+}
+
+
+#ifdef CXA_BTLE_CENTRAL_DUPCACHE_ENABLE
+static bool dupCache_isDuplicate(cxa_btle_central_t *const btlecIn, cxa_btle_advPacket_t *const packetIn)
+{
+	cxa_assert(btlecIn);
+	cxa_assert(packetIn);
+
+	if( btlecIn->dupCache_window_ms == 0 ) return false;
+
+	// FNV-1a over the advertisement data
+	uint32_t dataHash = FNV1A_OFFSET_BASIS;
+	size_t dataSize_bytes = cxa_fixedByteBuffer_getSize_bytes(&packetIn->fbb_data);
+	uint8_t* data = cxa_fixedByteBuffer_get_pointerToIndex(&packetIn->fbb_data, 0);
+	for( size_t i = 0; i < dataSize_bytes; i++ )
+	{
+		dataHash = (dataHash ^ data[i]) * FNV1A_PRIME;
+	}
+
+	// look for this address, keeping track of the stalest entry as we go
+	cxa_btle_central_dupCache_entry_t* oldestEntry = NULL;
+	uint32_t oldestAge_ms = 0;
+	for( size_t i = 0; i < btlecIn->dupCache_numEntries; i++ )
+	{
+		cxa_btle_central_dupCache_entry_t* currEntry = &btlecIn->dupCache[i];
+		uint32_t currAge_ms = cxa_timeDiff_getElapsedTime_ms(&currEntry->td_lastReported);
+
+		if( cxa_eui48_isEqual(&currEntry->addr, &packetIn->addr) )
+		{
+			// same payload within our window is a duplicate (the window runs from the last _reported_ copy)
+			if( (currEntry->dataHash == dataHash) && (currAge_ms < btlecIn->dupCache_window_ms) ) return true;
+
+			currEntry->dataHash = dataHash;
+			cxa_timeDiff_setStartTime_now(&currEntry->td_lastReported);
+			return false;
+		}
+
+		if( (oldestEntry == NULL) || (currAge_ms > oldestAge_ms) )
+		{
+			oldestEntry = currEntry;
+			oldestAge_ms = currAge_ms;
+		}
+	}
+
+	// haven't seen this address...add it (replacing the stalest entry if we're full)
+	cxa_btle_central_dupCache_entry_t* newEntry = (btlecIn->dupCache_numEntries < CXA_BTLE_CENTRAL_DUPCACHE_MAXNUM_ENTRIES) ?
+			&btlecIn->dupCache[btlecIn->dupCache_numEntries++] : oldestEntry;
+	cxa_assert(newEntry);
+	cxa_eui48_initFromEui48(&newEntry->addr, &packetIn->addr);
+	newEntry->dataHash = dataHash;
+	cxa_timeDiff_init(&newEntry->td_lastReported);
+
+	return false;
+}
+#endif
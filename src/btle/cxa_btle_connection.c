@@ -49,6 +49,11 @@ void cxa_btle_connection_init(cxa_btle_connection_t *const connIn,
 	connIn->scms.writeToCharacteristic = scm_writeToCharIn;
 	connIn->scms.changeNotifications = scm_changeNotiIndisIn;
 
+	// write commands are optional (see cxa_btle_connection_enableWriteNoResponse)
+	connIn->scms.writeToCharacteristic_noResponse = NULL;
+	connIn->numTxCredits = 0;
+	connIn->maxNumTxCredits = 0;
+
 	// clear out our callbacks
 	memset(&connIn->cbs, 0, sizeof(connIn->cbs));
 
@@ -66,6 +71,9 @@ void cxa_btle_connection_setTargetAddress(cxa_btle_connection_t *const connIn,
 	// set our address
 	cxa_eui48_initFromEui48(&connIn->targetAddr, targetAddrIn);
 
+	// new connection means the controller's buffers are empty
+	connIn->numTxCredits = connIn->maxNumTxCredits;
+
 	// clear out our callbacks
 	memset(&connIn->cbs, 0, sizeof(connIn->cbs));
 
@@ -74,6 +82,20 @@ void cxa_btle_connection_setTargetAddress(cxa_btle_connection_t *const connIn,
 }
 
 
+void cxa_btle_connection_enableWriteNoResponse(cxa_btle_connection_t *const connIn,
+											   cxa_btle_connection_scm_writeToCharacteristic_noResponse_t scm_writeNoRespIn,
+											   size_t maxNumTxCreditsIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(scm_writeNoRespIn);
+	cxa_assert(maxNumTxCreditsIn > 0);
+
+	connIn->scms.writeToCharacteristic_noResponse = scm_writeNoRespIn;
+	connIn->maxNumTxCredits = maxNumTxCreditsIn;
+	connIn->numTxCredits = maxNumTxCreditsIn;
+}
+
+
 void cxa_btle_connection_setOnClosedCb(cxa_btle_connection_t *const connIn, cxa_btle_connection_cb_onConnectionClosed_t cbIn, void* userVarIn)
 {
 	cxa_assert(connIn);
@@ -84,6 +106,16 @@ void cxa_btle_connection_setOnClosedCb(cxa_btle_connection_t *const connIn, cxa_
 }
 
 
+void cxa_btle_connection_setOnTxCreditsAvailableCb(cxa_btle_connection_t *const connIn, cxa_btle_connection_cb_onTxCreditsAvailable_t cbIn, void* userVarIn)
+{
+	cxa_assert(connIn);
+
+	// save our callback
+	connIn->cbs.txCreditsAvailable.func = cbIn;
+	connIn->cbs.txCreditsAvailable.userVar = userVarIn;
+}
+
+
 cxa_eui48_t* cxa_btle_connection_getTargetMacAddress(cxa_btle_connection_t *const connIn)
 {
 	cxa_assert(connIn);
@@ -167,6 +199,57 @@ void cxa_btle_connection_writeToCharacteristic_ptr(cxa_btle_connection_t *const
 }
 
 
+bool cxa_btle_connection_writeToCharacteristic_noResponse(cxa_btle_connection_t *const connIn,
+														  const char *const serviceUuidIn,
+														  const char *const characteristicUuidIn,
+														  cxa_fixedByteBuffer_t *const dataIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(serviceUuidIn);
+	cxa_assert(characteristicUuidIn);
+
+	// make sure the controller has room for it
+	if( (connIn->scms.writeToCharacteristic_noResponse == NULL) || (connIn->numTxCredits == 0) ) return false;
+
+	if( !connIn->scms.writeToCharacteristic_noResponse(connIn, serviceUuidIn, characteristicUuidIn, dataIn) ) return false;
+	connIn->numTxCredits--;
+
+	return true;
+}
+
+
+bool cxa_btle_connection_writeToCharacteristic_noResponse_ptr(cxa_btle_connection_t *const connIn,
+															  const char *const serviceUuidIn,
+															  const char *const characteristicUuidIn,
+															  void *const dataIn,
+															  size_t numBytesIn)
+{
+	cxa_assert(connIn);
+
+	// convert to a fbb
+	cxa_fixedByteBuffer_t fbbTmp;
+	cxa_fixedByteBuffer_init_inPlace(&fbbTmp, numBytesIn, dataIn, numBytesIn);
+
+	return cxa_btle_connection_writeToCharacteristic_noResponse(connIn, serviceUuidIn, characteristicUuidIn, &fbbTmp);
+}
+
+
+bool cxa_btle_connection_isWriteNoResponseSupported(cxa_btle_connection_t *const connIn)
+{
+	cxa_assert(connIn);
+
+	return (connIn->scms.writeToCharacteristic_noResponse != NULL);
+}
+
+
+size_t cxa_btle_connection_getNumTxCredits(cxa_btle_connection_t *const connIn)
+{
+	cxa_assert(connIn);
+
+	return connIn->numTxCredits;
+}
+
+
 void cxa_btle_connection_subscribeToNotifications(cxa_btle_connection_t *const connIn,
 												  const char *const serviceUuidIn,
 												  const char *const characteristicUuidIn,
@@ -293,6 +376,10 @@ void cxa_btle_connection_notify_connectionClose(cxa_btle_connection_t *const con
 {
 	cxa_assert(connIn);
 
+	// nothing more to send on this connection
+	connIn->cbs.txCreditsAvailable.func = NULL;
+	connIn->cbs.txCreditsAvailable.userVar = NULL;
+
 	// notify our callback
 	if( connIn->cbs.connectionClosed.func != NULL )
 	{
@@ -330,6 +417,19 @@ void cxa_btle_connection_notify_writeComplete(cxa_btle_connection_t *const connI
 }
 
 
+void cxa_btle_connection_notify_txCreditsAvailable(cxa_btle_connection_t *const connIn,
+												   size_t numCreditsIn)
+{
+	cxa_assert(connIn);
+
+	connIn->numTxCredits += numCreditsIn;
+	if( connIn->numTxCredits > connIn->maxNumTxCredits ) connIn->numTxCredits = connIn->maxNumTxCredits;
+
+	// notify our callback (stays registered)
+	if( (numCreditsIn > 0) && (connIn->cbs.txCreditsAvailable.func != NULL) ) connIn->cbs.txCreditsAvailable.func(connIn, connIn->cbs.txCreditsAvailable.userVar);
+}
+
+
 void cxa_btle_connection_notify_readComplete(cxa_btle_connection_t *const connIn,
 											 const char *const serviceUuidIn,
 											 const char *const characteristicUuidIn,
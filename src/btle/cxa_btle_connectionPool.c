@@ -0,0 +1,670 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_btle_connectionPool.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_runLoop.h>
+
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_DEBUG
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool queueOp(cxa_btle_connectionPool_link_t *const linkIn, cxa_btle_connectionPool_op_t *const opIn);
+static bool link_needsConnection(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_startConnection(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_enterStandoff(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_service(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_dispatchInFlightOp(cxa_btle_connectionPool_link_t *const linkIn);
+static cxa_btle_connectionPool_op_t link_completeInFlightOp(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_failInFlightOp(cxa_btle_connectionPool_link_t *const linkIn);
+static void link_requeueSubscriptions(cxa_btle_connectionPool_link_t *const linkIn);
+
+static void cb_onRunLoopUpdate(void* userVarIn);
+
+static void btleCb_onConnectionOpened(bool wasSuccessfulIn, cxa_btle_connection_t *const connectionIn, void* userVarIn);
+static void btleCb_onConnectionClosed(cxa_btle_connection_disconnectReason_t reasonIn, void* userVarIn);
+static void btleCb_onTxCreditsAvailable(cxa_btle_connection_t *const connectionIn, void* userVarIn);
+static void btleCb_onReadComplete(bool wasSuccessfulIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn);
+static void btleCb_onWriteComplete(bool wasSuccessfulIn, void* userVarIn);
+static void btleCb_onSubscribed(const char *const serviceUuidIn, const char *const characteristicUuidIn, bool wasSuccessfulIn, void* userVarIn);
+static void btleCb_onNotiIndiRx(const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_btle_connectionPool_init(cxa_btle_connectionPool_t *const poolIn, cxa_btle_central_t *const btlecIn, int threadIdIn)
+{
+	cxa_assert(poolIn);
+	cxa_assert(btlecIn);
+
+	// setup our internal state
+	poolIn->btlec = btlecIn;
+	poolIn->numLinks = 0;
+	poolIn->connectingLink = NULL;
+	poolIn->nextServiceIndex = 0;
+	poolIn->nextConnectIndex = 0;
+	cxa_logger_init(&poolIn->logger, "btlePool");
+
+	cxa_runLoop_addEntry(threadIdIn, NULL, cb_onRunLoopUpdate, (void*)poolIn);
+}
+
+
+cxa_btle_connectionPool_link_t* cxa_btle_connectionPool_addLink(cxa_btle_connectionPool_t *const poolIn,
+																 cxa_eui48_t *const targetAddrIn,
+																 bool isRandomAddrIn,
+																 bool isPersistentIn,
+																 cxa_btle_connectionPool_cb_onConnected_t cb_onConnectedIn,
+																 cxa_btle_connectionPool_cb_onDisconnected_t cb_onDisconnectedIn,
+																 void* userVarIn)
+{
+	cxa_assert(poolIn);
+	cxa_assert(targetAddrIn);
+
+	if( poolIn->numLinks >= CXA_BTLE_CONNECTIONPOOL_MAXNUM_LINKS ) return NULL;
+	cxa_btle_connectionPool_link_t* newLink = &poolIn->links[poolIn->numLinks++];
+
+	newLink->pool = poolIn;
+	cxa_eui48_initFromEui48(&newLink->targetAddr, targetAddrIn);
+	newLink->isRandomAddr = isRandomAddrIn;
+	newLink->isPersistent = isPersistentIn;
+
+	newLink->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE;
+	newLink->conn = NULL;
+
+	cxa_timeDiff_init(&newLink->td_standoff);
+	newLink->standoff_ms = CXA_BTLE_CONNECTIONPOOL_STANDOFF_MIN_MS;
+	cxa_timeDiff_init(&newLink->td_idle);
+
+	cxa_fixedFifo_initStd(&newLink->ops, CXA_FF_ON_FULL_DROP, newLink->ops_raw);
+	newLink->hasInFlightOp = false;
+	newLink->isServicing = false;
+	newLink->numDroppedWriteCmds = 0;
+	memset(newLink->subs, 0, sizeof(newLink->subs));
+
+	newLink->cb_onConnected = cb_onConnectedIn;
+	newLink->cb_onDisconnected = cb_onDisconnectedIn;
+	newLink->userVar = userVarIn;
+
+	return newLink;
+}
+
+
+bool cxa_btle_connectionPool_queueRead(cxa_btle_connectionPool_link_t *const linkIn,
+									   const char *const serviceUuidIn,
+									   const char *const characteristicUuidIn,
+									   cxa_btle_connection_cb_onReadComplete_t cbIn,
+									   void* userVarIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(serviceUuidIn);
+	cxa_assert(characteristicUuidIn);
+
+	cxa_btle_connectionPool_op_t newOp = {
+			.type = CXA_BTLE_CONNECTIONPOOL_OPTYPE_READ,
+			.serviceUuid_str = serviceUuidIn,
+			.characteristicUuid_str = characteristicUuidIn,
+			.numDataBytes = 0,
+			.cb.onReadComplete = cbIn,
+			.cb_onRx = NULL,
+			.userVar = userVarIn
+	};
+	return queueOp(linkIn, &newOp);
+}
+
+
+bool cxa_btle_connectionPool_queueWrite(cxa_btle_connectionPool_link_t *const linkIn,
+										const char *const serviceUuidIn,
+										const char *const characteristicUuidIn,
+										void *const dataIn,
+										size_t numBytesIn,
+										cxa_btle_connection_cb_onWriteComplete_t cbIn,
+										void* userVarIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(serviceUuidIn);
+	cxa_assert(characteristicUuidIn);
+	cxa_assert((dataIn != NULL) || (numBytesIn == 0));
+
+	if( numBytesIn > CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES ) return false;
+
+	cxa_btle_connectionPool_op_t newOp = {
+			.type = CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE,
+			.serviceUuid_str = serviceUuidIn,
+			.characteristicUuid_str = characteristicUuidIn,
+			.numDataBytes = numBytesIn,
+			.cb.onWriteComplete = cbIn,
+			.cb_onRx = NULL,
+			.userVar = userVarIn
+	};
+	if( numBytesIn > 0 ) memcpy(newOp.data, dataIn, numBytesIn);
+	return queueOp(linkIn, &newOp);
+}
+
+
+bool cxa_btle_connectionPool_queueWrite_noResponse(cxa_btle_connectionPool_link_t *const linkIn,
+												   const char *const serviceUuidIn,
+												   const char *const characteristicUuidIn,
+												   void *const dataIn,
+												   size_t numBytesIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(serviceUuidIn);
+	cxa_assert(characteristicUuidIn);
+	cxa_assert((dataIn != NULL) || (numBytesIn == 0));
+
+	if( numBytesIn > CXA_BTLE_CONNECTIONPOOL_MAXNUM_WRITE_BYTES ) return false;
+
+	cxa_btle_connectionPool_op_t newOp = {
+			.type = CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE_NORESPONSE,
+			.serviceUuid_str = serviceUuidIn,
+			.characteristicUuid_str = characteristicUuidIn,
+			.numDataBytes = numBytesIn,
+			.cb.onWriteComplete = NULL,
+			.cb_onRx = NULL,
+			.userVar = NULL
+	};
+	if( numBytesIn > 0 ) memcpy(newOp.data, dataIn, numBytesIn);
+	return queueOp(linkIn, &newOp);
+}
+
+
+bool cxa_btle_connectionPool_queueSubscribe(cxa_btle_connectionPool_link_t *const linkIn,
+											const char *const serviceUuidIn,
+											const char *const characteristicUuidIn,
+											cxa_btle_connection_cb_onNotiIndiSubscriptionChanged_t cb_onSubscribedIn,
+											cxa_btle_connection_cb_onNotiIndiRx_t cb_onRxIn,
+											void* userVarIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(serviceUuidIn);
+	cxa_assert(characteristicUuidIn);
+
+	cxa_btle_connectionPool_op_t newOp = {
+			.type = CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE,
+			.serviceUuid_str = serviceUuidIn,
+			.characteristicUuid_str = characteristicUuidIn,
+			.numDataBytes = 0,
+			.cb.onSubscribed = cb_onSubscribedIn,
+			.cb_onRx = cb_onRxIn,
+			.userVar = userVarIn
+	};
+	return queueOp(linkIn, &newOp);
+}
+
+
+bool cxa_btle_connectionPool_link_isConnected(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	return (linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED);
+}
+
+
+size_t cxa_btle_connectionPool_link_getNumQueuedOps(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	return cxa_fixedFifo_getSize_elems(&linkIn->ops);
+}
+
+
+size_t cxa_btle_connectionPool_link_getNumDroppedWriteCmds(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	return linkIn->numDroppedWriteCmds;
+}
+
+
+size_t cxa_btle_connectionPool_getNumActiveLinks(cxa_btle_connectionPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	size_t retVal = 0;
+	for( size_t i = 0; i < poolIn->numLinks; i++ )
+	{
+		switch( poolIn->links[i].state )
+		{
+			case CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTING:
+			case CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED:
+			case CXA_BTLE_CONNECTIONPOOL_LINKSTATE_DISCONNECTING:
+				retVal++;
+				break;
+
+			default:
+				break;
+		}
+	}
+	return retVal;
+}
+
+
+// ******** local function implementations ********
+static bool queueOp(cxa_btle_connectionPool_link_t *const linkIn, cxa_btle_connectionPool_op_t *const opIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(opIn);
+
+	if( !cxa_fixedFifo_queue(&linkIn->ops, (void*)opIn) ) return false;
+
+	// if we're already connected, get it moving right away
+	if( linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED ) link_service(linkIn);
+
+	return true;
+}
+
+
+static bool link_needsConnection(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	return (linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE) &&
+			(linkIn->isPersistent || !cxa_fixedFifo_isEmpty(&linkIn->ops));
+}
+
+
+static void link_startConnection(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+	cxa_btle_connectionPool_t* poolIn = linkIn->pool;
+
+	linkIn->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTING;
+	poolIn->connectingLink = linkIn;
+
+	// the central may fail this right away (eg. if someone else is connecting)
+	cxa_btle_central_startConnection(poolIn->btlec, &linkIn->targetAddr, linkIn->isRandomAddr, btleCb_onConnectionOpened, (void*)linkIn);
+}
+
+
+static void link_enterStandoff(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	linkIn->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_STANDOFF;
+	cxa_timeDiff_setStartTime_now(&linkIn->td_standoff);
+	cxa_logger_debug(&linkIn->pool->logger, "link %d standing off for %d ms", (int)(linkIn - linkIn->pool->links), linkIn->standoff_ms);
+}
+
+
+static void link_service(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	// operations may complete synchronously, in which case the outer call keeps going
+	if( linkIn->isServicing ) return;
+	linkIn->isServicing = true;
+
+	for( size_t numOpsIssued = 0; (numOpsIssued < CXA_BTLE_CONNECTIONPOOL_MAXNUM_OPS_PER_TURN) &&
+								  (linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED); numOpsIssued++ )
+	{
+		cxa_btle_connectionPool_op_t* nextOp;
+		if( cxa_fixedFifo_bulkDequeue_peek(&linkIn->ops, (void**)&nextOp) == 0 ) break;
+
+		// write commands don't need a response so they can go out behind an
+		// outstanding request, limited only by the controller's buffers
+		if( (nextOp->type == CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE_NORESPONSE) &&
+			cxa_btle_connection_isWriteNoResponseSupported(linkIn->conn) )
+		{
+			// out of controller buffers...the tx credits callback will resume us
+			if( cxa_btle_connection_getNumTxCredits(linkIn->conn) == 0 ) break;
+
+			// anything else is a rejection that won't go away by retrying, so
+			// drop it rather than stall everything queued behind it
+			if( !cxa_btle_connection_writeToCharacteristic_noResponse_ptr(linkIn->conn, nextOp->serviceUuid_str, nextOp->characteristicUuid_str,
+																		  nextOp->data, nextOp->numDataBytes) )
+			{
+				cxa_logger_warn(&linkIn->pool->logger, "link %d write command to '%s' rejected, dropped",
+								(int)(linkIn - linkIn->pool->links), nextOp->characteristicUuid_str);
+				linkIn->numDroppedWriteCmds++;
+			}
+			cxa_fixedFifo_bulkDequeue(&linkIn->ops, 1);
+			cxa_timeDiff_setStartTime_now(&linkIn->td_idle);
+			continue;
+		}
+
+		// everything else is an ATT request...only one may be outstanding per link
+		if( linkIn->hasInFlightOp ) break;
+		memcpy(&linkIn->inFlightOp, nextOp, sizeof(linkIn->inFlightOp));
+		cxa_fixedFifo_bulkDequeue(&linkIn->ops, 1);
+		linkIn->hasInFlightOp = true;
+
+		link_dispatchInFlightOp(linkIn);
+	}
+
+	linkIn->isServicing = false;
+}
+
+
+static void link_dispatchInFlightOp(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+	cxa_btle_connectionPool_op_t* op = &linkIn->inFlightOp;
+
+	switch( op->type )
+	{
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_READ:
+			cxa_btle_connection_readFromCharacteristic(linkIn->conn, op->serviceUuid_str, op->characteristicUuid_str, btleCb_onReadComplete, (void*)linkIn);
+			break;
+
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE:
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE_NORESPONSE:
+			cxa_btle_connection_writeToCharacteristic_ptr(linkIn->conn, op->serviceUuid_str, op->characteristicUuid_str, op->data, op->numDataBytes,
+														  btleCb_onWriteComplete, (void*)linkIn);
+			break;
+
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE:
+		{
+			// the connection hands the same userVar to both callbacks so give it one that leads back to us
+			cxa_btle_connectionPool_subscription_t* newSub = NULL;
+			for( size_t i = 0; i < (sizeof(linkIn->subs)/sizeof(*linkIn->subs)); i++ )
+			{
+				if( !linkIn->subs[i].isUsed )
+				{
+					newSub = &linkIn->subs[i];
+					break;
+				}
+			}
+			if( newSub == NULL )
+			{
+				link_failInFlightOp(linkIn);
+				break;
+			}
+			newSub->isUsed = true;
+			newSub->isSubscribed = false;
+			newSub->link = linkIn;
+			newSub->serviceUuid_str = op->serviceUuid_str;
+			newSub->characteristicUuid_str = op->characteristicUuid_str;
+			newSub->cb_onSubscribed = op->cb.onSubscribed;
+			newSub->cb_onRx = op->cb_onRx;
+			newSub->userVar = op->userVar;
+
+			cxa_btle_connection_subscribeToNotifications(linkIn->conn, op->serviceUuid_str, op->characteristicUuid_str,
+														 btleCb_onSubscribed, btleCb_onNotiIndiRx, (void*)newSub);
+			break;
+		}
+	}
+}
+
+
+static cxa_btle_connectionPool_op_t link_completeInFlightOp(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+	cxa_assert(linkIn->hasInFlightOp);
+
+	// copy it out so the callback can queue (and we can dispatch) the next one
+	cxa_btle_connectionPool_op_t retVal = linkIn->inFlightOp;
+	linkIn->hasInFlightOp = false;
+	cxa_timeDiff_setStartTime_now(&linkIn->td_idle);
+
+	return retVal;
+}
+
+
+static void link_failInFlightOp(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	if( !linkIn->hasInFlightOp ) return;
+	cxa_btle_connectionPool_op_t op = link_completeInFlightOp(linkIn);
+
+	switch( op.type )
+	{
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_READ:
+			if( op.cb.onReadComplete != NULL ) op.cb.onReadComplete(false, NULL, op.userVar);
+			break;
+
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE:
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_WRITE_NORESPONSE:
+			if( op.cb.onWriteComplete != NULL ) op.cb.onWriteComplete(false, op.userVar);
+			break;
+
+		case CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE:
+			if( op.cb.onSubscribed != NULL ) op.cb.onSubscribed(op.serviceUuid_str, op.characteristicUuid_str, false, op.userVar);
+			break;
+	}
+}
+
+
+static void link_requeueSubscriptions(cxa_btle_connectionPool_link_t *const linkIn)
+{
+	cxa_assert(linkIn);
+
+	// a subscription that was interrupted gets another try as well
+	if( linkIn->hasInFlightOp && (linkIn->inFlightOp.type == CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE) &&
+		cxa_fixedFifo_queue(&linkIn->ops, (void*)&linkIn->inFlightOp) )
+	{
+		linkIn->hasInFlightOp = false;
+	}
+
+	for( size_t i = 0; i < (sizeof(linkIn->subs)/sizeof(*linkIn->subs)); i++ )
+	{
+		cxa_btle_connectionPool_subscription_t* currSub = &linkIn->subs[i];
+		if( !currSub->isUsed || !currSub->isSubscribed ) continue;
+
+		cxa_btle_connectionPool_op_t newOp = {
+				.type = CXA_BTLE_CONNECTIONPOOL_OPTYPE_SUBSCRIBE,
+				.serviceUuid_str = currSub->serviceUuid_str,
+				.characteristicUuid_str = currSub->characteristicUuid_str,
+				.numDataBytes = 0,
+				.cb.onSubscribed = currSub->cb_onSubscribed,
+				.cb_onRx = currSub->cb_onRx,
+				.userVar = currSub->userVar
+		};
+		if( !cxa_fixedFifo_queue(&linkIn->ops, (void*)&newOp) )
+		{
+			cxa_logger_warn(&linkIn->pool->logger, "link %d queue full, subscription lost", (int)(linkIn - linkIn->pool->links));
+			if( newOp.cb.onSubscribed != NULL ) newOp.cb.onSubscribed(newOp.serviceUuid_str, newOp.characteristicUuid_str, false, newOp.userVar);
+		}
+	}
+}
+
+
+static void cb_onRunLoopUpdate(void* userVarIn)
+{
+	cxa_btle_connectionPool_t* poolIn = (cxa_btle_connectionPool_t*)userVarIn;
+	cxa_assert(poolIn);
+
+	if( poolIn->numLinks == 0 ) return;
+	if( cxa_btle_central_getState(poolIn->btlec) != CXA_BTLE_CENTRAL_STATE_READY ) return;
+
+	size_t numActiveLinks = 0;
+	size_t numWaitingLinks = 0;
+	for( size_t i = 0; i < poolIn->numLinks; i++ )
+	{
+		cxa_btle_connectionPool_link_t* currLink = &poolIn->links[i];
+
+		if( (currLink->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_STANDOFF) &&
+			cxa_timeDiff_isElapsed_ms(&currLink->td_standoff, currLink->standoff_ms) )
+		{
+			// back off further next time (reset once we connect)
+			currLink->standoff_ms = ((currLink->standoff_ms * 2) < CXA_BTLE_CONNECTIONPOOL_STANDOFF_MAX_MS) ?
+										(currLink->standoff_ms * 2) : CXA_BTLE_CONNECTIONPOOL_STANDOFF_MAX_MS;
+			currLink->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE;
+		}
+
+		if( link_needsConnection(currLink) ) numWaitingLinks++;
+		if( (currLink->state != CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE) &&
+			(currLink->state != CXA_BTLE_CONNECTIONPOOL_LINKSTATE_STANDOFF) ) numActiveLinks++;
+	}
+
+	// slots that are already on their way out count toward those waiting
+	for( size_t i = 0; i < poolIn->numLinks; i++ )
+	{
+		if( (poolIn->links[i].state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_DISCONNECTING) && (numWaitingLinks > 0) ) numWaitingLinks--;
+	}
+
+	// service connected links round-robin, starting with a different one each time
+	for( size_t i = 0; i < poolIn->numLinks; i++ )
+	{
+		cxa_btle_connectionPool_link_t* currLink = &poolIn->links[(poolIn->nextServiceIndex + i) % poolIn->numLinks];
+		if( currLink->state != CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED ) continue;
+
+		link_service(currLink);
+
+		// give up our slot if we're done and someone else needs it
+		if( (numWaitingLinks > 0) && !currLink->isPersistent && !currLink->hasInFlightOp && cxa_fixedFifo_isEmpty(&currLink->ops) &&
+			(numActiveLinks >= CXA_BTLE_CONNECTIONPOOL_MAXNUM_ACTIVE_LINKS) &&
+			cxa_timeDiff_isElapsed_ms(&currLink->td_idle, CXA_BTLE_CONNECTIONPOOL_IDLE_DISCONNECT_MS) )
+		{
+			cxa_logger_debug(&poolIn->logger, "link %d idle, releasing slot", (int)(currLink - poolIn->links));
+			currLink->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_DISCONNECTING;
+			cxa_btle_connection_stop(currLink->conn);
+			numWaitingLinks--;
+		}
+	}
+	poolIn->nextServiceIndex = (poolIn->nextServiceIndex + 1) % poolIn->numLinks;
+
+	// the central only handles one connection attempt at a time
+	if( (poolIn->connectingLink != NULL) || (numActiveLinks >= CXA_BTLE_CONNECTIONPOOL_MAXNUM_ACTIVE_LINKS) ) return;
+	for( size_t i = 0; i < poolIn->numLinks; i++ )
+	{
+		size_t currIndex = (poolIn->nextConnectIndex + i) % poolIn->numLinks;
+		cxa_btle_connectionPool_link_t* currLink = &poolIn->links[currIndex];
+		if( !link_needsConnection(currLink) ) continue;
+
+		poolIn->nextConnectIndex = (currIndex + 1) % poolIn->numLinks;
+		link_startConnection(currLink);
+		break;
+	}
+}
+
+
+static void btleCb_onConnectionOpened(bool wasSuccessfulIn, cxa_btle_connection_t *const connectionIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* linkIn = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_assert(linkIn);
+	cxa_btle_connectionPool_t* poolIn = linkIn->pool;
+
+	if( poolIn->connectingLink == linkIn ) poolIn->connectingLink = NULL;
+
+	if( !wasSuccessfulIn || (connectionIn == NULL) )
+	{
+		cxa_logger_debug(&poolIn->logger, "link %d connection failed", (int)(linkIn - poolIn->links));
+		link_enterStandoff(linkIn);
+		return;
+	}
+
+	cxa_logger_info(&poolIn->logger, "link %d connected", (int)(linkIn - poolIn->links));
+	linkIn->conn = connectionIn;
+	linkIn->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED;
+	linkIn->standoff_ms = CXA_BTLE_CONNECTIONPOOL_STANDOFF_MIN_MS;
+	cxa_timeDiff_setStartTime_now(&linkIn->td_idle);
+	cxa_btle_connection_setOnClosedCb(connectionIn, btleCb_onConnectionClosed, (void*)linkIn);
+	cxa_btle_connection_setOnTxCreditsAvailableCb(connectionIn, btleCb_onTxCreditsAvailable, (void*)linkIn);
+
+	if( linkIn->cb_onConnected != NULL ) linkIn->cb_onConnected(linkIn, linkIn->userVar);
+
+	link_service(linkIn);
+}
+
+
+static void btleCb_onConnectionClosed(cxa_btle_connection_disconnectReason_t reasonIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* linkIn = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_assert(linkIn);
+
+	bool wasRequested = (linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_DISCONNECTING);
+	cxa_logger_info(&linkIn->pool->logger, "link %d disconnected (%d)", (int)(linkIn - linkIn->pool->links), reasonIn);
+
+	linkIn->conn = NULL;
+
+	// subscriptions don't survive a disconnect...persistent links restore them once reconnected
+	if( linkIn->isPersistent ) link_requeueSubscriptions(linkIn);
+	memset(linkIn->subs, 0, sizeof(linkIn->subs));
+
+	// don't hammer a peripheral that just dropped us
+	if( wasRequested ) linkIn->state = CXA_BTLE_CONNECTIONPOOL_LINKSTATE_IDLE;
+	else link_enterStandoff(linkIn);
+
+	// queued operations stay queued (and will trigger a reconnect)
+	link_failInFlightOp(linkIn);
+
+	if( linkIn->cb_onDisconnected != NULL ) linkIn->cb_onDisconnected(linkIn, linkIn->userVar);
+}
+
+
+static void btleCb_onTxCreditsAvailable(cxa_btle_connection_t *const connectionIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* linkIn = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_assert(linkIn);
+
+	// write commands held back for lack of credits can go out right away
+	if( (linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED) && (linkIn->conn == connectionIn) ) link_service(linkIn);
+}
+
+
+static void btleCb_onReadComplete(bool wasSuccessfulIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* linkIn = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_assert(linkIn);
+
+	if( !linkIn->hasInFlightOp ) return;
+	cxa_btle_connectionPool_op_t op = link_completeInFlightOp(linkIn);
+
+	if( op.cb.onReadComplete != NULL ) op.cb.onReadComplete(wasSuccessfulIn, fbb_readDataIn, op.userVar);
+
+	// keep the link busy
+	if( linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED ) link_service(linkIn);
+}
+
+
+static void btleCb_onWriteComplete(bool wasSuccessfulIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_link_t* linkIn = (cxa_btle_connectionPool_link_t*)userVarIn;
+	cxa_assert(linkIn);
+
+	if( !linkIn->hasInFlightOp ) return;
+	cxa_btle_connectionPool_op_t op = link_completeInFlightOp(linkIn);
+
+	if( op.cb.onWriteComplete != NULL ) op.cb.onWriteComplete(wasSuccessfulIn, op.userVar);
+
+	// keep the link busy
+	if( linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED ) link_service(linkIn);
+}
+
+
+static void btleCb_onSubscribed(const char *const serviceUuidIn, const char *const characteristicUuidIn, bool wasSuccessfulIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_subscription_t* subIn = (cxa_btle_connectionPool_subscription_t*)userVarIn;
+	cxa_assert(subIn);
+	cxa_btle_connectionPool_link_t* linkIn = subIn->link;
+	cxa_assert(linkIn);
+
+	if( wasSuccessfulIn ) subIn->isSubscribed = true;
+	else subIn->isUsed = false;
+
+	if( !linkIn->hasInFlightOp ) return;
+	cxa_btle_connectionPool_op_t op = link_completeInFlightOp(linkIn);
+
+	if( op.cb.onSubscribed != NULL ) op.cb.onSubscribed(serviceUuidIn, characteristicUuidIn, wasSuccessfulIn, op.userVar);
+
+	// keep the link busy
+	if( linkIn->state == CXA_BTLE_CONNECTIONPOOL_LINKSTATE_CONNECTED ) link_service(linkIn);
+}
+
+
+static void btleCb_onNotiIndiRx(const char *const serviceUuidIn, const char *const characteristicUuidIn, cxa_fixedByteBuffer_t *fbb_readDataIn, void* userVarIn)
+{
+	cxa_btle_connectionPool_subscription_t* subIn = (cxa_btle_connectionPool_subscription_t*)userVarIn;
+	cxa_assert(subIn);
+
+	if( subIn->isUsed && (subIn->cb_onRx != NULL) ) subIn->cb_onRx(serviceUuidIn, characteristicUuidIn, fbb_readDataIn, subIn->userVar);
+}
@@ -20,6 +20,7 @@
 
 
 // ******** local function prototypes ********
+static void disableHeadroom(cxa_fixedByteBuffer_t *const fbbIn);
 
 
 // ********  local variable declarations *********
@@ -33,6 +34,7 @@ void cxa_fixedByteBuffer_init(cxa_fixedByteBuffer_t *const fbbIn, void *const bu
 
 	// setup our internal state
 	cxa_array_init(&fbbIn->bytes, 1, bufferLocIn, bufferMaxSize_bytesIn);
+	disableHeadroom(fbbIn);
 }
 
 
@@ -43,6 +45,23 @@ void cxa_fixedByteBuffer_init_inPlace(cxa_fixedByteBuffer_t *const fbbIn, const
 
 	// setup our internal state
 	cxa_array_init_inPlace(&fbbIn->bytes, 1, currNumElemsIn, bufferLocIn, bufferMaxSize_bytesIn);
+	disableHeadroom(fbbIn);
+}
+
+
+void cxa_fixedByteBuffer_init_withHeadroom(cxa_fixedByteBuffer_t *const fbbIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn, const size_t headroom_bytesIn)
+{
+	cxa_assert(fbbIn);
+	cxa_assert(bufferLocIn);
+	cxa_assert(headroom_bytesIn <= bufferMaxSize_bytesIn);
+
+	// save our references (so we can restore our headroom on clear)
+	fbbIn->headroomBase = (uint8_t*)bufferLocIn;
+	fbbIn->headroomBase_maxSize_bytes = bufferMaxSize_bytesIn;
+	fbbIn->initialHeadroom_bytes = headroom_bytesIn;
+
+	// our data starts _after_ the headroom
+	cxa_array_init(&fbbIn->bytes, 1, fbbIn->headroomBase + headroom_bytesIn, bufferMaxSize_bytesIn - headroom_bytesIn);
 }
 
 
@@ -54,6 +73,7 @@ void cxa_fixedByteBuffer_init_subBufferFixedSize(cxa_fixedByteBuffer_t *const su
 
 	// setup our internal state
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, numBytesIn, cxa_array_get(&parentFbbIn->bytes, startIndexIn), numBytesIn);
+	disableHeadroom(subFbbIn);
 }
 
 
@@ -66,6 +86,7 @@ void cxa_fixedByteBuffer_init_subBufferRemainingElems(cxa_fixedByteBuffer_t *con
 	// setup our internal state
 	size_t numElems = cxa_fixedByteBuffer_getSize_bytes(parentFbbIn) - startIndexIn;
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, numElems, cxa_array_get_noBoundsCheck(&parentFbbIn->bytes, startIndexIn), numElems);
+	disableHeadroom(subFbbIn);
 }
 
 
@@ -78,6 +99,7 @@ void cxa_fixedByteBuffer_init_subBufferParentMaxSize(cxa_fixedByteBuffer_t *cons
 	// setup our internal state
 	size_t maxSize_bytes = cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) - startIndexIn;
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, 0, cxa_array_get_noBoundsCheck(&parentFbbIn->bytes, startIndexIn), maxSize_bytes);
+	disableHeadroom(subFbbIn);
 }
 
 
@@ -168,13 +190,25 @@ bool cxa_fixedByteBuffer_remove(cxa_fixedByteBuffer_t *const fbbIn, const size_t
 	cxa_assert(fbbIn);
 
 	// make sure we have room for the operation
-	if( (indexIn + numBytesIn) > cxa_fixedByteBuffer_getSize_bytes(fbbIn) ) return false;
+	size_t currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(fbbIn);
+	if( (indexIn + numBytesIn) > currSize_bytes ) return false;
+	if( numBytesIn == 0 ) return true;
 
-	for( size_t i = 0; i < numBytesIn; i++ )
+	uint8_t* dataStart = (uint8_t*)cxa_array_get_noBoundsCheck(&fbbIn->bytes, 0);
+	size_t numLeadingBytes = indexIn;
+	size_t numTrailingBytes = currSize_bytes - (indexIn + numBytesIn);
+
+	// if we have headroom, move whichever side is smaller
+	if( (fbbIn->headroomBase != NULL) && (numLeadingBytes < numTrailingBytes) )
 	{
-		if( !cxa_array_remove_atIndex(&fbbIn->bytes, indexIn) ) return false;
+		memmove(dataStart + numBytesIn, dataStart, numLeadingBytes);
+		cxa_array_init_inPlace(&fbbIn->bytes, 1, currSize_bytes - numBytesIn, dataStart + numBytesIn, cxa_fixedByteBuffer_getMaxSize_bytes(fbbIn) - numBytesIn);
+		return true;
 	}
 
+	memmove(dataStart + indexIn, dataStart + indexIn + numBytesIn, numTrailingBytes);
+	cxa_array_init_inPlace(&fbbIn->bytes, 1, currSize_bytes - numBytesIn, dataStart, cxa_fixedByteBuffer_getMaxSize_bytes(fbbIn));
+
 	return true;
 }
 
@@ -348,17 +382,33 @@ bool cxa_fixedByteBuffer_insert(cxa_fixedByteBuffer_t *const fbbIn, const size_t
 	cxa_assert(fbbIn);
 	cxa_assert(ptrIn);
 
-	// make sure we have room for the operation
-	if( cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn) < numBytesIn ) return false;
-
 	// make sure the index is in bounds
-	if( indexIn > cxa_fixedByteBuffer_getSize_bytes(fbbIn) ) return false;
+	size_t currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(fbbIn);
+	if( indexIn > currSize_bytes ) return false;
+	if( numBytesIn == 0 ) return true;
 
-	for( size_t i = 0; i < numBytesIn; i++ )
+	uint8_t* dataStart = (uint8_t*)cxa_array_get_noBoundsCheck(&fbbIn->bytes, 0);
+	size_t numLeadingBytes = indexIn;
+	size_t numTrailingBytes = currSize_bytes - indexIn;
+	bool hasFreeSpace = (cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn) >= numBytesIn);
+
+	// if we have headroom (and it's cheaper or we're out of space), grow backwards
+	if( (cxa_fixedByteBuffer_getHeadroom_bytes(fbbIn) >= numBytesIn) && (!hasFreeSpace || (numLeadingBytes <= numTrailingBytes)) )
 	{
-		if( !cxa_array_insert(&fbbIn->bytes, indexIn+i, (void*)&(ptrIn[i])) ) return false;
+		uint8_t* newDataStart = dataStart - numBytesIn;
+		memmove(newDataStart, dataStart, numLeadingBytes);
+		cxa_array_init_inPlace(&fbbIn->bytes, 1, currSize_bytes + numBytesIn, newDataStart, cxa_fixedByteBuffer_getMaxSize_bytes(fbbIn) + numBytesIn);
+		memmove(newDataStart + indexIn, ptrIn, numBytesIn);
+		return true;
 	}
 
+	// make sure we have room for the operation
+	if( !hasFreeSpace ) return false;
+
+	memmove(dataStart + indexIn + numBytesIn, dataStart + indexIn, numTrailingBytes);
+	cxa_array_init_inPlace(&fbbIn->bytes, 1, currSize_bytes + numBytesIn, dataStart, cxa_fixedByteBuffer_getMaxSize_bytes(fbbIn));
+	memmove(dataStart + indexIn, ptrIn, numBytesIn);
+
 	return true;
 }
 
@@ -395,6 +445,16 @@ size_t cxa_fixedByteBuffer_getFreeSize_bytes(cxa_fixedByteBuffer_t *const fbbIn)
 }
 
 
+size_t cxa_fixedByteBuffer_getHeadroom_bytes(cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(fbbIn);
+
+	if( fbbIn->headroomBase == NULL ) return 0;
+
+	return (uint8_t*)cxa_array_get_noBoundsCheck(&fbbIn->bytes, 0) - fbbIn->headroomBase;
+}
+
+
 bool cxa_fixedByteBuffer_isFull(cxa_fixedByteBuffer_t *const fbbIn)
 {
 	cxa_assert(fbbIn);
@@ -413,8 +473,20 @@ void cxa_fixedByteBuffer_clear(cxa_fixedByteBuffer_t *const fbbIn)
 {
 	cxa_assert(fbbIn);
 
-	cxa_array_clear(&fbbIn->bytes);
+	if( fbbIn->headroomBase != NULL )
+	{
+		// restore our original headroom
+		cxa_array_init(&fbbIn->bytes, 1, fbbIn->headroomBase + fbbIn->initialHeadroom_bytes,
+					   fbbIn->headroomBase_maxSize_bytes - fbbIn->initialHeadroom_bytes);
+	}
+	else cxa_array_clear(&fbbIn->bytes);
 }
 
 
 // ******** local function implementations ********
+static void disableHeadroom(cxa_fixedByteBuffer_t *const fbbIn)
+{
+	fbbIn->headroomBase = NULL;
+	fbbIn->headroomBase_maxSize_bytes = 0;
+	fbbIn->initialHeadroom_bytes = 0;
+}
@@ -163,7 +163,25 @@ bool cxa_fixedFifo_bulkQueue(cxa_fixedFifo_t *const fifoIn, void *const elemsIn,
 	cxa_assert(fifoIn);
 	cxa_assert(elemsIn);
 
-	// simplistic implementation...we can probably make this more efficient
+	// if everything fits, copy in (at most) two contiguous spans
+	size_t numFree_elems = (fifoIn->maxNumElements - 1) - cxa_fixedFifo_getSize_elems(fifoIn);
+	if( numElemsIn <= numFree_elems )
+	{
+		size_t firstSpan_elems = fifoIn->maxNumElements - fifoIn->insertIndex;
+		if( firstSpan_elems > numElemsIn ) firstSpan_elems = numElemsIn;
+
+		memcpy((void*)(((uint8_t*)fifoIn->bufferLoc) + (fifoIn->insertIndex * fifoIn->datatypeSize_bytes)), elemsIn, firstSpan_elems * fifoIn->datatypeSize_bytes);
+		if( firstSpan_elems < numElemsIn )
+		{
+			memcpy(fifoIn->bufferLoc, (void*)(((uint8_t*)elemsIn) + (firstSpan_elems * fifoIn->datatypeSize_bytes)), (numElemsIn - firstSpan_elems) * fifoIn->datatypeSize_bytes);
+		}
+
+		size_t newInsertIndex = fifoIn->insertIndex + numElemsIn;
+		fifoIn->insertIndex = (newInsertIndex >= fifoIn->maxNumElements) ? (newInsertIndex - fifoIn->maxNumElements) : newInsertIndex;
+		return true;
+	}
+
+	// not enough room, fall back to element-by-element so we honor our onFullAction
 	for( size_t i = 0; i < numElemsIn; i++ )
 	{
 		if( !cxa_fixedFifo_queue(fifoIn, &(((uint8_t*)elemsIn)[i*fifoIn->datatypeSize_bytes])) ) return false;
@@ -177,13 +195,33 @@ bool cxa_fixedFifo_bulkDequeue(cxa_fixedFifo_t *const fifoIn, size_t numElemsIn)
 {
 	cxa_assert(fifoIn);
 
-	// simplistic implementation...we can probably make this more efficient
-	for( size_t i = 0; i < numElemsIn; i++ )
-	{
-		if( !cxa_fixedFifo_dequeue(fifoIn, NULL) ) return false;
-	}
+	// if we don't have enough elements, dequeue what we have (but still report failure)
+	size_t currSize_elems = cxa_fixedFifo_getSize_elems(fifoIn);
+	bool retVal = (numElemsIn <= currSize_elems);
+	if( !retVal ) numElemsIn = currSize_elems;
+	if( numElemsIn == 0 ) return retVal;
 
-	return true;
+	#if CXA_FF_MAX_LISTENERS > 0
+		bool wasFull = cxa_fixedFifo_isFull(fifoIn);
+	#endif
+
+	size_t newRemoveIndex = fifoIn->removeIndex + numElemsIn;
+	fifoIn->removeIndex = (newRemoveIndex >= fifoIn->maxNumElements) ? (newRemoveIndex - fifoIn->maxNumElements) : newRemoveIndex;
+
+	#if CXA_FF_MAX_LISTENERS > 0
+		// notify our listeners
+		if( wasFull )
+		{
+			cxa_array_iterate(&fifoIn->listeners, currEntry, cxa_fixedFifo_listener_entry_t)
+			{
+				if( currEntry == NULL ) continue;
+
+				if( currEntry->cb_noLongerFull != NULL ) currEntry->cb_noLongerFull(fifoIn, currEntry->userVarIn);
+			}
+		}
+	#endif
+
+	return retVal;
 }
 
 
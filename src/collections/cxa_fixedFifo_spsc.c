@@ -0,0 +1,211 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_fixedFifo_spsc.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <stdint.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+#ifdef __GNUC__
+	// acquire / release ordering so element copies are visible before the index update
+	#define LOAD_ACQUIRE(ptrIn)					__atomic_load_n((ptrIn), __ATOMIC_ACQUIRE)
+	#define STORE_RELEASE(ptrIn, valIn)			__atomic_store_n((ptrIn), (valIn), __ATOMIC_RELEASE)
+#else
+	// volatile accesses are sufficient on single-core targets
+	#define LOAD_ACQUIRE(ptrIn)					(*(ptrIn))
+	#define STORE_RELEASE(ptrIn, valIn)			(*(ptrIn) = (valIn))
+#endif
+
+#define ELEM_PTR(fifoIn, countIn)				((void*)(((uint8_t*)(fifoIn)->bufferLoc) + (((countIn) & (fifoIn)->indexMask) * (fifoIn)->datatypeSize_bytes)))
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_fixedFifo_spsc_init(cxa_fixedFifo_spsc_t *const fifoIn, const size_t datatypeSize_bytesIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(datatypeSize_bytesIn > 0);
+	cxa_assert(datatypeSize_bytesIn <= bufferMaxSize_bytesIn);
+	cxa_assert(bufferLocIn);
+
+	size_t maxNumElems = bufferMaxSize_bytesIn / datatypeSize_bytesIn;
+	cxa_assert_msg((maxNumElems & (maxNumElems - 1)) == 0, "number of elements must be a power of two");
+
+	// save our references
+	fifoIn->bufferLoc = bufferLocIn;
+	fifoIn->datatypeSize_bytes = datatypeSize_bytesIn;
+	fifoIn->indexMask = maxNumElems - 1;
+
+	// set some reasonable defaults
+	fifoIn->insertCount = 0;
+	fifoIn->removeCount = 0;
+}
+
+
+void cxa_fixedFifo_spsc_clear(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	fifoIn->removeCount = fifoIn->insertCount;
+}
+
+
+bool cxa_fixedFifo_spsc_queue(cxa_fixedFifo_spsc_t *const fifoIn, const void *const elemIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemIn);
+
+	size_t lcl_insertCount = fifoIn->insertCount;
+	if( (lcl_insertCount - LOAD_ACQUIRE(&fifoIn->removeCount)) > fifoIn->indexMask ) return false;
+
+	memcpy(ELEM_PTR(fifoIn, lcl_insertCount), elemIn, fifoIn->datatypeSize_bytes);
+	STORE_RELEASE(&fifoIn->insertCount, lcl_insertCount + 1);
+
+	return true;
+}
+
+
+size_t cxa_fixedFifo_spsc_bulkQueue(cxa_fixedFifo_spsc_t *const fifoIn, const void *const elemsIn, size_t numElemsIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemsIn);
+
+	size_t lcl_insertCount = fifoIn->insertCount;
+	size_t numFree = (fifoIn->indexMask + 1) - (lcl_insertCount - LOAD_ACQUIRE(&fifoIn->removeCount));
+	if( numElemsIn > numFree ) numElemsIn = numFree;
+	if( numElemsIn == 0 ) return 0;
+
+	// copy up to the end of the buffer, then whatever wraps around to the start
+	size_t startIndex = lcl_insertCount & fifoIn->indexMask;
+	size_t firstSpan_elems = (fifoIn->indexMask + 1) - startIndex;
+	if( firstSpan_elems > numElemsIn ) firstSpan_elems = numElemsIn;
+
+	memcpy(ELEM_PTR(fifoIn, lcl_insertCount), elemsIn, firstSpan_elems * fifoIn->datatypeSize_bytes);
+	if( firstSpan_elems < numElemsIn )
+	{
+		memcpy(fifoIn->bufferLoc, ((const uint8_t*)elemsIn) + (firstSpan_elems * fifoIn->datatypeSize_bytes),
+			   (numElemsIn - firstSpan_elems) * fifoIn->datatypeSize_bytes);
+	}
+	STORE_RELEASE(&fifoIn->insertCount, lcl_insertCount + numElemsIn);
+
+	return numElemsIn;
+}
+
+
+bool cxa_fixedFifo_spsc_peek(cxa_fixedFifo_spsc_t *const fifoIn, void *elemOut)
+{
+	cxa_assert(fifoIn);
+
+	size_t lcl_removeCount = fifoIn->removeCount;
+	if( LOAD_ACQUIRE(&fifoIn->insertCount) == lcl_removeCount ) return false;
+
+	if( elemOut != NULL ) memcpy(elemOut, ELEM_PTR(fifoIn, lcl_removeCount), fifoIn->datatypeSize_bytes);
+
+	return true;
+}
+
+
+bool cxa_fixedFifo_spsc_dequeue(cxa_fixedFifo_spsc_t *const fifoIn, void *elemOut)
+{
+	cxa_assert(fifoIn);
+
+	size_t lcl_removeCount = fifoIn->removeCount;
+	if( LOAD_ACQUIRE(&fifoIn->insertCount) == lcl_removeCount ) return false;
+
+	if( elemOut != NULL ) memcpy(elemOut, ELEM_PTR(fifoIn, lcl_removeCount), fifoIn->datatypeSize_bytes);
+	STORE_RELEASE(&fifoIn->removeCount, lcl_removeCount + 1);
+
+	return true;
+}
+
+
+size_t cxa_fixedFifo_spsc_bulkDequeue(cxa_fixedFifo_spsc_t *const fifoIn, void *elemsOut, size_t maxNumElemsIn)
+{
+	cxa_assert(fifoIn);
+
+	size_t lcl_removeCount = fifoIn->removeCount;
+	size_t numElems = LOAD_ACQUIRE(&fifoIn->insertCount) - lcl_removeCount;
+	if( numElems > maxNumElemsIn ) numElems = maxNumElemsIn;
+	if( numElems == 0 ) return 0;
+
+	if( elemsOut != NULL )
+	{
+		// copy up to the end of the buffer, then whatever wraps around to the start
+		size_t startIndex = lcl_removeCount & fifoIn->indexMask;
+		size_t firstSpan_elems = (fifoIn->indexMask + 1) - startIndex;
+		if( firstSpan_elems > numElems ) firstSpan_elems = numElems;
+
+		memcpy(elemsOut, ELEM_PTR(fifoIn, lcl_removeCount), firstSpan_elems * fifoIn->datatypeSize_bytes);
+		if( firstSpan_elems < numElems )
+		{
+			memcpy(((uint8_t*)elemsOut) + (firstSpan_elems * fifoIn->datatypeSize_bytes), fifoIn->bufferLoc,
+				   (numElems - firstSpan_elems) * fifoIn->datatypeSize_bytes);
+		}
+	}
+	STORE_RELEASE(&fifoIn->removeCount, lcl_removeCount + numElems);
+
+	return numElems;
+}
+
+
+size_t cxa_fixedFifo_spsc_getSize_elems(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	// load removeCount first so the result can never underflow...it _can_ momentarily
+	// overshoot if both sides move between our loads (hence the clamp)
+	size_t lcl_removeCount = LOAD_ACQUIRE(&fifoIn->removeCount);
+	size_t numElems = LOAD_ACQUIRE(&fifoIn->insertCount) - lcl_removeCount;
+	return (numElems > (fifoIn->indexMask + 1)) ? (fifoIn->indexMask + 1) : numElems;
+}
+
+
+size_t cxa_fixedFifo_spsc_getFreeSize_elems(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return (fifoIn->indexMask + 1) - cxa_fixedFifo_spsc_getSize_elems(fifoIn);
+}
+
+
+size_t cxa_fixedFifo_spsc_getMaxSize_elems(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return fifoIn->indexMask + 1;
+}
+
+
+bool cxa_fixedFifo_spsc_isFull(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return (cxa_fixedFifo_spsc_getSize_elems(fifoIn) > fifoIn->indexMask);
+}
+
+
+bool cxa_fixedFifo_spsc_isEmpty(cxa_fixedFifo_spsc_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return (cxa_fixedFifo_spsc_getSize_elems(fifoIn) == 0);
+}
+
+
+// ******** local function implementations ********
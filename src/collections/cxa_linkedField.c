@@ -21,13 +21,16 @@
 
 
 // ******** local function prototypes ********
-static cxa_fixedByteBuffer_t* getParentBufferFromChild(cxa_linkedField_t *const fbbLfIn);
-static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static size_t getStartIndexInParent(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static cxa_linkedField_t* getEndOfChain(cxa_linkedField_t *const fbbLfIn);
-static bool validateChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
+static void initCommon(cxa_linkedField_t *const fbbLfIn, bool isFixedLengthIn, size_t maxFixedLength_bytesIn, size_t initialSize_bytesIn);
+static bool linkToPrev(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn);
+static void unlinkFromPrev(cxa_linkedField_t *const fbbLfIn);
+static void recalculateChain(cxa_linkedField_t *const rootIn);
+static void setSize(cxa_linkedField_t *const fbbLfIn, size_t newSize_bytesIn);
+static bool appendToEndOfChain(cxa_linkedField_t *const fbbLfIn, uint8_t *const ptrIn, const size_t numBytesIn);
+static bool validateChain(cxa_linkedField_t *const fbbLfIn);
+static bool isUnfilledFixedLengthField(cxa_linkedField_t *const fbbLfIn);
+static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn);
+static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn);
 
 
 // ********  local variable declarations *********
@@ -42,11 +45,9 @@ bool cxa_linkedField_initRoot(cxa_linkedField_t *const fbbLfIn, cxa_fixedByteBuf
 	// save our internal state
 	fbbLfIn->parent = parentFbbIn;
 	fbbLfIn->prev = NULL;
-	fbbLfIn->next = NULL;
 	fbbLfIn->startIndex = startIndexInParentIn;
-	fbbLfIn->isFixedLength = false;
-	fbbLfIn->maxFixedLength_bytes = 0;
-	fbbLfIn->currSize_bytes = initialSize_bytesIn;
+	initCommon(fbbLfIn, false, 0, initialSize_bytesIn);
+	recalculateChain(fbbLfIn);
 
 	// make sure the start index isn't outside the max bounds for the parent
 	if( startIndexInParentIn+initialSize_bytesIn > cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) ) return false;
@@ -63,11 +64,9 @@ bool cxa_linkedField_initRoot_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_fix
 	// save our internal state
 	fbbLfIn->parent = parentFbbIn;
 	fbbLfIn->prev = NULL;
-	fbbLfIn->next = NULL;
 	fbbLfIn->startIndex = startIndexInParentIn;
-	fbbLfIn->isFixedLength = true;
-	fbbLfIn->maxFixedLength_bytes = maxLen_bytesIn;
-	fbbLfIn->currSize_bytes = CXA_MIN(maxLen_bytesIn, cxa_fixedByteBuffer_getSize_bytes(parentFbbIn));
+	initCommon(fbbLfIn, true, maxLen_bytesIn, CXA_MIN(maxLen_bytesIn, cxa_fixedByteBuffer_getSize_bytes(parentFbbIn)));
+	recalculateChain(fbbLfIn);
 
 	// make sure that our fixed size (with index) isn't bigger than the parent's capacity
 	if( (startIndexInParentIn + maxLen_bytesIn) > cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) ) return false;
@@ -78,28 +77,16 @@ bool cxa_linkedField_initRoot_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_fix
 bool cxa_linkedField_initChild(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn, const size_t initialSize_bytesIn)
 {
 	cxa_assert(fbbLfIn);
+	cxa_assert(prevFbbLfIn);
 
 	// save our internal state
-	fbbLfIn->prev = prevFbbLfIn;
-	fbbLfIn->next = NULL;
-	prevFbbLfIn->next = fbbLfIn;
-	fbbLfIn->parent = NULL;
-	fbbLfIn->parent = getParentBufferFromChild(fbbLfIn);
-	if( fbbLfIn->parent == NULL )
-	{
-		// we failed to initialize properly
-		prevFbbLfIn->next = NULL;
-		return false;
-	}
-
-	fbbLfIn->isFixedLength = false;
-	fbbLfIn->maxFixedLength_bytes = 0;
-	fbbLfIn->currSize_bytes = initialSize_bytesIn;
+	initCommon(fbbLfIn, false, 0, initialSize_bytesIn);
+	if( !linkToPrev(fbbLfIn, prevFbbLfIn) ) return false;
 
-	if( ((getStartIndexInParent(fbbLfIn, true) + fbbLfIn->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) || !validateChain(fbbLfIn, true) )
+	if( ((fbbLfIn->startIndex + fbbLfIn->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) || !validateChain(fbbLfIn) )
 	{
 		// we failed to initialize properly
-		prevFbbLfIn->next = NULL;
+		unlinkFromPrev(fbbLfIn);
 		return false;
 	}
 
@@ -110,23 +97,29 @@ bool cxa_linkedField_initChild(cxa_linkedField_t *const fbbLfIn, cxa_linkedField
 bool cxa_linkedField_initChild_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn, const size_t maxLen_bytesIn)
 {
 	cxa_assert(fbbLfIn);
+	cxa_assert(prevFbbLfIn);
 
-	// save our internal state
-	fbbLfIn->prev = prevFbbLfIn;
-	fbbLfIn->next = NULL;
-	prevFbbLfIn->next = fbbLfIn;
-	fbbLfIn->parent = NULL;
-	fbbLfIn->parent = getParentBufferFromChild(fbbLfIn);
-	if( fbbLfIn->parent == NULL ) return false;
+	// save our internal state (we need our start index before we know our size)
+	initCommon(fbbLfIn, true, maxLen_bytesIn, 0);
+	if( !linkToPrev(fbbLfIn, prevFbbLfIn) ) return false;
 
-	fbbLfIn->isFixedLength = true;
-	fbbLfIn->maxFixedLength_bytes = maxLen_bytesIn;
-	fbbLfIn->currSize_bytes = CXA_MIN(maxLen_bytesIn, (cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent) - getStartIndexInParent(fbbLfIn, true)));
+	size_t parentSize_bytes = cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent);
+	size_t availSize_bytes = (parentSize_bytes > fbbLfIn->startIndex) ? (parentSize_bytes - fbbLfIn->startIndex) : 0;
+	setSize(fbbLfIn, CXA_MIN(maxLen_bytesIn, availSize_bytes));
 
 	// make sure that that sizes of all fixed-length fields aren't too big...
-	if( getLengthOfAllFixedFields_bytes(fbbLfIn, true) > cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) ) return false;
+	if( fbbLfIn->root->chain.fixedFieldsLen_bytes > cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) ) return false;
+
+	return validateChain(fbbLfIn);
+}
+
+
+void cxa_linkedField_setBuilderMode(cxa_linkedField_t *const fbbLfIn, bool isBuilderModeIn)
+{
+	cxa_assert(fbbLfIn);
+	cxa_assert(fbbLfIn->root);
 
-	return validateChain(fbbLfIn, true);
+	fbbLfIn->root->chain.isBuilderMode = isBuilderModeIn;
 }
 
 
@@ -155,19 +148,19 @@ bool cxa_linkedField_remove(cxa_linkedField_t *const fbbLfIn, const size_t index
 {
 	cxa_assert(fbbLfIn);
 
-	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	// ensure our chain is valid (and builders only append)
+	if( !validateChain(fbbLfIn) || fbbLfIn->root->chain.isBuilderMode ) return false;
 
 	// we can't be removed if there is stuff after us and we are fixed length...
-	if( fbbLfIn->isFixedLength && isNonEmptyFieldDownChain(fbbLfIn, true) ) return false;
+	if( fbbLfIn->isFixedLength && isNonEmptyFieldDownChain(fbbLfIn) ) return false;
 
 	// make sure the index is in bounds
-	size_t removeIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t removeIndex = fbbLfIn->startIndex + indexIn;
 	if( ((indexIn + numBytesIn) > fbbLfIn->currSize_bytes) || ((removeIndex+ numBytesIn) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) ) return false;
 
 	// if we made it here, we can try the remove
 	if( !cxa_fixedByteBuffer_remove(fbbLfIn->parent, removeIndex , numBytesIn) ) return false;
-	fbbLfIn->currSize_bytes -= numBytesIn;
+	setSize(fbbLfIn, fbbLfIn->currSize_bytes - numBytesIn);
 
 	return true;
 }
@@ -178,7 +171,7 @@ bool cxa_linkedField_remove_cString(cxa_linkedField_t *const fbbLfIn, const size
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	uint8_t* targetString = cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
@@ -221,10 +214,10 @@ uint8_t* cxa_linkedField_get_pointerToIndex(cxa_linkedField_t *const fbbLfIn, co
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return NULL;
+	if( !validateChain(fbbLfIn) ) return NULL;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 
 	return cxa_fixedByteBuffer_get_pointerToIndex(fbbLfIn->parent, parentIndex);
 }
@@ -235,13 +228,13 @@ bool cxa_linkedField_get(cxa_linkedField_t *const fbbLfIn, const size_t indexIn,
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// make sure that we have enough bytes in _our_ buffer
 	if( numBytesIn > fbbLfIn->currSize_bytes ) return false;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 
 	return cxa_fixedByteBuffer_get(fbbLfIn->parent, parentIndex, transposeIn, valOut, numBytesIn);
 }
@@ -252,7 +245,7 @@ bool cxa_linkedField_get_cstring(cxa_linkedField_t *const fbbLfIn, const size_t
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	char* targetString = (char*)cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
@@ -264,7 +257,7 @@ bool cxa_linkedField_get_cstring(cxa_linkedField_t *const fbbLfIn, const size_t
 	// make sure that we have enough bytes in _our_ buffer
 	if( targetStringLen_bytes > fbbLfIn->currSize_bytes ) return false;
 
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_get_cString(fbbLfIn->parent, parentIndex, stringOut, maxOutputSize_bytes);
 }
 
@@ -274,13 +267,13 @@ bool cxa_linkedField_get_cstring_inPlace(cxa_linkedField_t *const fbbLfIn, const
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	char* targetString = (char*)cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
 	if( targetString == NULL ) return false;
 
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_get_cString_inPlace(fbbLfIn->parent, parentIndex, stringOut, strLen_bytesOut);
 }
 
@@ -310,13 +303,13 @@ bool cxa_linkedField_replace(cxa_linkedField_t *const fbbLfIn, const size_t inde
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// make sure that we have enough bytes in _our_ buffer
 	if( numBytesIn > fbbLfIn->currSize_bytes ) return false;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_replace(fbbLfIn->parent, parentIndex, ptrIn, numBytesIn);
 }
 
@@ -354,16 +347,22 @@ bool cxa_linkedField_insert(cxa_linkedField_t *const fbbLfIn, const size_t index
 	cxa_assert(ptrIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
+
+	// builders only append (to the end of the chain)
+	if( fbbLfIn->root->chain.isBuilderMode )
+	{
+		return (indexIn == fbbLfIn->currSize_bytes) ? appendToEndOfChain(fbbLfIn, ptrIn, numBytesIn) : false;
+	}
 
 	// make sure there aren't any unfilled fixed-length fields before us
-	if( isUnfilledFixedLengthFieldUpChain(fbbLfIn, true) ) return false;
+	if( isUnfilledFixedLengthFieldUpChain(fbbLfIn) ) return false;
 
 	// if we made it here, we can at least try to insert the item...
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	if( !cxa_fixedByteBuffer_insert(fbbLfIn->parent, parentIndex, ptrIn, numBytesIn) ) return false;
 
-	fbbLfIn->currSize_bytes += numBytesIn;
+	setSize(fbbLfIn, fbbLfIn->currSize_bytes + numBytesIn);
 
 	return true;
 }
@@ -372,7 +371,7 @@ bool cxa_linkedField_insert(cxa_linkedField_t *const fbbLfIn, const size_t index
 size_t cxa_linkedField_getSize_bytes(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
-	if( !validateChain(fbbLfIn, true) ) return 0;
+	if( !validateChain(fbbLfIn) ) return 0;
 
 	return fbbLfIn->currSize_bytes;
 }
@@ -400,12 +399,12 @@ bool cxa_linkedField_prependTo_lengthPrefixedField_uint16BE(cxa_linkedField_t *c
 size_t cxa_linkedField_getMaxSize_bytes(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
-	if( !validateChain(fbbLfIn, true) ) return 0;
+	if( !validateChain(fbbLfIn) ) return 0;
 
 	if( fbbLfIn->isFixedLength ) return fbbLfIn->maxFixedLength_bytes;
 
-	// if we made it here, this is a little more complicated...
-	return cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) - getLengthOfAllFixedFields_bytes(fbbLfIn, true);
+	// if we made it here, we can have whatever the fixed-length fields don't need
+	return cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) - fbbLfIn->root->chain.fixedFieldsLen_bytes;
 }
 
 
@@ -421,134 +420,172 @@ size_t cxa_linkedField_getStartIndexInParent(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	return getStartIndexInParent(fbbLfIn, true);
+	return fbbLfIn->startIndex;
 }
 
 
 // ******** local function implementations ********
-static cxa_fixedByteBuffer_t* getParentBufferFromChild(cxa_linkedField_t *const fbbLfIn)
+static void initCommon(cxa_linkedField_t *const fbbLfIn, bool isFixedLengthIn, size_t maxFixedLength_bytesIn, size_t initialSize_bytesIn)
 {
 	cxa_assert(fbbLfIn);
 
-	if( fbbLfIn->parent != NULL ) return fbbLfIn->parent;
-
-	// if we made it here, we need to recurse a little bit
-	if( fbbLfIn->prev != NULL ) return getParentBufferFromChild(fbbLfIn->prev);
+	fbbLfIn->next = NULL;
+	fbbLfIn->isFixedLength = isFixedLengthIn;
+	fbbLfIn->maxFixedLength_bytes = maxFixedLength_bytesIn;
+	fbbLfIn->currSize_bytes = initialSize_bytesIn;
 
-	// if we made it here, we're out of luck
-	return NULL;
+	// only meaningful for the root (set by recalculateChain)
+	fbbLfIn->chain.tail = NULL;
+	fbbLfIn->chain.fixedFieldsLen_bytes = 0;
+	fbbLfIn->chain.numUnfilledFixedFields = 0;
+	fbbLfIn->chain.isBuilderMode = false;
 }
 
 
-static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool linkToPrev(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn)
 {
 	cxa_assert(fbbLfIn);
+	cxa_assert(prevFbbLfIn);
 
-	if( isFirstCallIn )
-	{
-		cxa_linkedField_t *endOfChain = getEndOfChain(fbbLfIn);
-		if( endOfChain == NULL ) return 0;
+	cxa_linkedField_t* root = prevFbbLfIn->root;
+	if( (root == NULL) || (root->parent == NULL) ) return false;
 
-		return getLengthOfAllFixedFields_bytes(endOfChain, false);
+	fbbLfIn->root = root;
+	fbbLfIn->parent = root->parent;
+	fbbLfIn->prev = prevFbbLfIn;
+	fbbLfIn->startIndex = prevFbbLfIn->startIndex + prevFbbLfIn->currSize_bytes;
+
+	// if we're re-linking into the middle of a chain, whatever was after prev is dropped
+	bool isNewTail = (root->chain.tail == prevFbbLfIn);
+	prevFbbLfIn->next = fbbLfIn;
+	if( !isNewTail )
+	{
+		recalculateChain(root);
+		return true;
 	}
 
-	// if we made it here, this isn't our first call...
-	size_t retVal = (fbbLfIn->isFixedLength) ? fbbLfIn->maxFixedLength_bytes : 0;
-	if( fbbLfIn->prev != NULL ) retVal += getLengthOfAllFixedFields_bytes(fbbLfIn->prev, false);
+	// common case...just extend our totals
+	root->chain.tail = fbbLfIn;
+	if( fbbLfIn->isFixedLength ) root->chain.fixedFieldsLen_bytes += fbbLfIn->maxFixedLength_bytes;
+	if( isUnfilledFixedLengthField(fbbLfIn) ) root->chain.numUnfilledFixedFields++;
 
-	return retVal;
+	return true;
 }
 
 
-static size_t getStartIndexInParent(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static void unlinkFromPrev(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
+	cxa_assert(fbbLfIn->prev);
 
-	size_t retVal = 0;
+	fbbLfIn->prev->next = NULL;
+	recalculateChain(fbbLfIn->root);
+}
 
-	// add from the previous field
-	if( fbbLfIn->prev != NULL ) retVal += getStartIndexInParent(fbbLfIn->prev, false);
 
-	// now add ourselves
-	if( fbbLfIn->prev == NULL ) retVal += fbbLfIn->startIndex;
-	if( !isFirstCallIn) retVal += fbbLfIn->currSize_bytes;
+static void recalculateChain(cxa_linkedField_t *const rootIn)
+{
+	cxa_assert(rootIn);
 
-	return retVal;
+	rootIn->root = rootIn;
+	rootIn->chain.fixedFieldsLen_bytes = 0;
+	rootIn->chain.numUnfilledFixedFields = 0;
+
+	size_t currStartIndex = rootIn->startIndex;
+	for( cxa_linkedField_t* currField = rootIn; currField != NULL; currField = currField->next )
+	{
+		currField->root = rootIn;
+		currField->parent = rootIn->parent;
+		currField->startIndex = currStartIndex;
+		currStartIndex += currField->currSize_bytes;
+
+		if( currField->isFixedLength ) rootIn->chain.fixedFieldsLen_bytes += currField->maxFixedLength_bytes;
+		if( isUnfilledFixedLengthField(currField) ) rootIn->chain.numUnfilledFixedFields++;
+		rootIn->chain.tail = currField;
+	}
 }
 
 
-static cxa_linkedField_t* getEndOfChain(cxa_linkedField_t *const fbbLfIn)
+static void setSize(cxa_linkedField_t *const fbbLfIn, size_t newSize_bytesIn)
 {
 	cxa_assert(fbbLfIn);
 
-	return (fbbLfIn->next != NULL) ? getEndOfChain(fbbLfIn->next) : fbbLfIn;
+	bool wasUnfilled = isUnfilledFixedLengthField(fbbLfIn);
+	size_t oldSize_bytes = fbbLfIn->currSize_bytes;
+	fbbLfIn->currSize_bytes = newSize_bytesIn;
+
+	// everything after us moved by the same amount
+	for( cxa_linkedField_t* currField = fbbLfIn->next; currField != NULL; currField = currField->next )
+	{
+		currField->startIndex = currField->startIndex - oldSize_bytes + newSize_bytesIn;
+	}
+
+	bool isUnfilled = isUnfilledFixedLengthField(fbbLfIn);
+	if( wasUnfilled && !isUnfilled ) fbbLfIn->root->chain.numUnfilledFixedFields--;
+	else if( !wasUnfilled && isUnfilled ) fbbLfIn->root->chain.numUnfilledFixedFields++;
 }
 
 
-static bool validateChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool appendToEndOfChain(cxa_linkedField_t *const fbbLfIn, uint8_t *const ptrIn, const size_t numBytesIn)
 {
 	cxa_assert(fbbLfIn);
 
-	// if we were the first...
-	if( isFirstCallIn )
-	{
-		// start the recursion from the end of the chain
-		cxa_linkedField_t* endOfChain = getEndOfChain(fbbLfIn);
-		if( endOfChain == NULL ) return false;
-
-		// now that we found the end of the chain, calculate sizes for it
-		size_t calcSize_bytes = getStartIndexInParent(endOfChain, true) + endOfChain->currSize_bytes;
-		size_t actualSize_bytes = cxa_fixedByteBuffer_getSize_bytes(endOfChain->parent);
-
-		if( calcSize_bytes > actualSize_bytes ) return false;
+	// only the last field can grow, and only if it ends where the parent does
+	if( (fbbLfIn != fbbLfIn->root->chain.tail) ||
+		((fbbLfIn->startIndex + fbbLfIn->currSize_bytes) != cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) ) return false;
 
-		return validateChain(endOfChain, false);
-	}
+	if( isUnfilledFixedLengthFieldUpChain(fbbLfIn) ) return false;
 
-	// if we made it here, we're not the first...do basic checks
-	// make sure we have a parent
-	if( fbbLfIn->parent == NULL ) return false;
+	if( !cxa_fixedByteBuffer_append(fbbLfIn->parent, ptrIn, numBytesIn) ) return false;
+	setSize(fbbLfIn, fbbLfIn->currSize_bytes + numBytesIn);
 
-	// now validate the previous field (if applicable)
-	return (fbbLfIn->prev != NULL) ? validateChain(fbbLfIn->prev, false) : true;
+	return true;
 }
 
 
-static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool validateChain(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	// check ourselves (if we're not first)
-	if( !isFirstCallIn )
-	{
-		if( fbbLfIn->isFixedLength && (fbbLfIn->currSize_bytes != fbbLfIn->maxFixedLength_bytes) ) return true;
-	}
+	cxa_linkedField_t* root = fbbLfIn->root;
+	if( (root == NULL) || (root->parent == NULL) || (root->chain.tail == NULL) ) return false;
 
-	// check the previous field
-	if( fbbLfIn->prev != NULL)
-	{
-		if( isUnfilledFixedLengthFieldUpChain(fbbLfIn->prev, false) ) return true;
-	}
+	// the end of the chain must still fit in the parent (which may have been changed underneath us)
+	cxa_linkedField_t* tail = root->chain.tail;
+	return (tail->startIndex + tail->currSize_bytes) <= cxa_fixedByteBuffer_getSize_bytes(root->parent);
+}
 
-	return false;
+
+static bool isUnfilledFixedLengthField(cxa_linkedField_t *const fbbLfIn)
+{
+	cxa_assert(fbbLfIn);
+
+	return fbbLfIn->isFixedLength && (fbbLfIn->currSize_bytes != fbbLfIn->maxFixedLength_bytes);
 }
 
 
-static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	// check ourselves (if we're not first)
-	if( !isFirstCallIn )
-	{
-		if( fbbLfIn->currSize_bytes != 0 ) return true;
-	}
+	// usually there aren't any (not counting ourselves)
+	size_t numUnfilledOthers = fbbLfIn->root->chain.numUnfilledFixedFields - (isUnfilledFixedLengthField(fbbLfIn) ? 1 : 0);
+	if( numUnfilledOthers == 0 ) return false;
 
-	// check the next field
-	if( fbbLfIn->next != NULL )
+	for( cxa_linkedField_t* currField = fbbLfIn->prev; currField != NULL; currField = currField->prev )
 	{
-		if( isNonEmptyFieldDownChain(fbbLfIn->next, false) ) return true;
+		if( isUnfilledFixedLengthField(currField) ) return true;
 	}
 
 	return false;
 }
+
+
+static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn)
+{
+	cxa_assert(fbbLfIn);
+
+	// if the chain ends after we do, someone after us has data
+	cxa_linkedField_t* tail = fbbLfIn->root->chain.tail;
+	return (tail->startIndex + tail->currSize_bytes) > (fbbLfIn->startIndex + fbbLfIn->currSize_bytes);
+}
@@ -91,7 +91,7 @@ void cxa_console_init(const char* deviceNameIn, cxa_ioStream_t *const ioStreamIn
 	cxa_console_addCommand("help", "prints available commands", NULL, 0, command_help, NULL);
 
 	// register for our runLoop
-	cxa_runLoop_addEntry(threadIdIn, cb_onRunLoopStart, cb_onRunLoopUpdate, NULL);
+	cxa_runLoop_addEntry_named(threadIdIn, "console", cb_onRunLoopStart, cb_onRunLoopUpdate, NULL);
 }
 
 
@@ -22,19 +22,159 @@
 #include <cxa_console.h>
 #endif
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+#include <cxa_criticalSection.h>
+#include <cxa_runLoop.h>
+#endif
+
 
 // ******** local macro definitions ********
 #define CXA_LOGGER_TRUNCATE_STRING			"..."
 
+// time (32-bit hex + space), name, [pointer], level text, space
+#define HEADER_MAXLEN_BYTES					(9 + CXA_LOGGER_MAX_NAME_LEN_CHARS + (5 + (2*sizeof(void*))) + 5 + 1)
+
+#define MEMDUMP_CHUNK_SIZE_BYTES			48
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	#define RECORD_INDEX_MASK					(CXA_LOGGER_DEFERRED_NUM_RECORDS - 1)
+	#define SPEC_MAXLEN_BYTES					16
+
+	#ifdef __GNUC__
+		#define LOAD_ACQUIRE(ptrIn)					__atomic_load_n((ptrIn), __ATOMIC_ACQUIRE)
+		#define STORE_RELEASE(ptrIn, valIn)			__atomic_store_n((ptrIn), (valIn), __ATOMIC_RELEASE)
+	#else
+		// volatile accesses are sufficient on single-core targets
+		#define LOAD_ACQUIRE(ptrIn)					(*(ptrIn))
+		#define STORE_RELEASE(ptrIn, valIn)			(*(ptrIn) = (valIn))
+	#endif
+#endif
+
 
 // ******** local type definitions ********
+/**
+ * @private
+ * Accumulates text in a fixed-size buffer (instead of many small ioStream writes).
+ * The buffer must have room for maxLen_bytes plus a null terminator.
+ */
+typedef struct
+{
+	char* buffer;
+	size_t maxLen_bytes;
+	size_t len_bytes;
+	bool isTruncated;
+}textBuilder_t;
+
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+typedef enum
+{
+	RECORD_TYPE_FORMATTED,
+	RECORD_TYPE_UNTERM,
+	RECORD_TYPE_MEMDUMP
+}recordType_t;
+
+
+typedef enum
+{
+	ARG_NONE,
+	ARG_INT,
+	ARG_UINT,
+	ARG_LONG,
+	ARG_ULONG,
+	ARG_LLONG,
+	ARG_ULLONG,
+	ARG_SIZE,
+	ARG_INTMAX,
+	ARG_UINTMAX,
+	ARG_PTRDIFF,
+	ARG_DOUBLE,
+	ARG_LDOUBLE,
+	ARG_PTR,
+	ARG_STRING,
+	ARG_UNSUPPORTED
+}argType_t;
+
+
+typedef struct
+{
+	argType_t type;
+	bool isWidthArg;
+	bool isPrecisionArg;
+	int precision;
+
+	// includes the leading '%'
+	size_t specLen_bytes;
+}formatSpec_t;
+
+
+/**
+ * @private
+ * The binary form of a log statement...formatting is deferred until the
+ * record is flushed. The payload holds raw arguments (formatted records)
+ * or length-prefixed byte blobs (untermString / memdump records).
+ */
+typedef struct
+{
+	cxa_logger_t* logger;
+	const char* format;
+	uint32_t timestamp_us;
+	uint8_t type;
+	uint8_t level;
+	bool isTruncated;
+
+	uint16_t payloadLen_bytes;
+	uint8_t payload[CXA_LOGGER_DEFERRED_RECORD_PAYLOAD_SIZE_BYTES];
+}record_t;
+
+
+typedef struct
+{
+	// equals the enqueue position when free, enqueue position + 1 when ready to flush
+	volatile size_t sequence;
+	record_t record;
+}recordSlot_t;
+#endif
 
 
 // ******** local function prototypes ********
 static inline void checkInit(void);
 static void cxa_logger_log_varArgs(cxa_logger_t *const loggerIn, const uint8_t levelIn, const char* formatIn, va_list argsIn);
-static void writeField(const char *const stringIn, size_t maxFieldLenIn);
 static void writeHeader(cxa_logger_t *const loggerIn, const uint8_t levelIn);
+static void writeMemDump(const void *const bytesIn, size_t numBytesIn);
+
+static const char* getLevelText(const uint8_t levelIn);
+static size_t formatHexByte(char *const buffIn, uint8_t byteIn, bool isLastIn);
+
+static void textBuilder_init(textBuilder_t *const tbIn, char *const bufferIn, size_t maxLen_bytesIn);
+static void textBuilder_append(textBuilder_t *const tbIn, const void *const dataIn, size_t len_bytesIn);
+static void textBuilder_appendString(textBuilder_t *const tbIn, const char *const stringIn);
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static void textBuilder_appendFormatted(textBuilder_t *const tbIn, const char *const formatIn, ...);
+#endif
+static void textBuilder_appendField(textBuilder_t *const tbIn, const char *const stringIn, size_t maxFieldLenIn);
+static void textBuilder_appendHeader(textBuilder_t *const tbIn, cxa_logger_t *const loggerIn, const uint8_t levelIn, uint32_t timestamp_usIn);
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static void textBuilder_finishLine(textBuilder_t *const tbIn);
+#endif
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static record_t* deferred_reserveRecord(cxa_logger_t *const loggerIn, const uint8_t levelIn, recordType_t typeIn, size_t *const posOut);
+static void deferred_publishRecord(record_t *const recordIn, size_t posIn);
+static void deferred_logFormatted(cxa_logger_t *const loggerIn, const uint8_t levelIn, const char* formatIn, va_list argsIn);
+static void deferred_logBlobs(cxa_logger_t *const loggerIn, const uint8_t levelIn, recordType_t typeIn, const char* prefixIn, const void* dataIn, size_t dataLen_bytesIn, const char* postFixIn);
+static size_t deferred_flush(size_t maxNumRecordsIn);
+static void deferred_renderRecord(textBuilder_t *const tbIn, record_t *const recordIn);
+static void deferred_renderFormatted(textBuilder_t *const tbIn, record_t *const recordIn);
+
+static const char* parseSpec(const char* specIn, formatSpec_t *const specOut);
+static bool record_append(record_t *const recordIn, const void *const dataIn, size_t len_bytesIn);
+static bool record_appendBlob(record_t *const recordIn, const void *const dataIn, size_t len_bytesIn);
+static bool record_read(record_t *const recordIn, size_t *const offsetIn, void *const dataOut, size_t len_bytesIn);
+static bool record_readBlob(record_t *const recordIn, size_t *const offsetIn, const uint8_t** dataOut, size_t *const len_bytesOut);
+
+static void cb_onRunLoopUpdate(void* userVarIn);
+#endif
 
 
 // ********  local variable declarations *********
@@ -45,6 +185,18 @@ static cxa_ioStream_t* ioStream = NULL;
 static size_t largestloggerName_bytes = 0;
 static cxa_mutex_t* printMutex;
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static recordSlot_t recordSlots[CXA_LOGGER_DEFERRED_NUM_RECORDS];
+static volatile size_t enqueuePos = 0;
+static size_t dequeuePos = 0;
+
+static volatile size_t numDroppedLines = 0;
+static size_t numDroppedLines_reported = 0;
+
+static bool isRunLoopEntryAdded = false;
+static char flushBuffer[CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES + 1];
+#endif
+
 
 // ******** global function implementations ********
 void cxa_logger_setGlobalIoStream(cxa_ioStream_t *const ioStreamIn)
@@ -53,6 +205,14 @@ void cxa_logger_setGlobalIoStream(cxa_ioStream_t *const ioStreamIn)
 
 	ioStream = ioStreamIn;
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	if( !isRunLoopEntryAdded )
+	{
+		isRunLoopEntryAdded = true;
+		cxa_runLoop_addEntry_named(CXA_LOGGER_DEFERRED_THREADID, "logger", NULL, cb_onRunLoopUpdate, NULL);
+	}
+#endif
+
 	cxa_ioStream_writeBytes(ioStream, (void*)CXA_LINE_ENDING, sizeof(CXA_LINE_ENDING));
 	cxa_ioStream_writeBytes(ioStream, (void*)CXA_LINE_ENDING, sizeof(CXA_LINE_ENDING));
 	cxa_logger_log_formattedString_impl(&sysLog, CXA_LOG_LEVEL_INFO, "logging ioStream @ %p", ioStreamIn);
@@ -99,6 +259,26 @@ cxa_logger_t* cxa_logger_getSysLog(void)
 }
 
 
+void cxa_logger_flush(void)
+{
+	checkInit();
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	while( deferred_flush(CXA_LOGGER_DEFERRED_NUM_RECORDS) > 0 );
+#endif
+}
+
+
+size_t cxa_logger_getNumDroppedLines(void)
+{
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	return LOAD_ACQUIRE(&numDroppedLines);
+#else
+	return 0;
+#endif
+}
+
+
 void cxa_logger_log_formattedString_impl(cxa_logger_t *const loggerIn, const uint8_t levelIn, const char* formatIn, ...)
 {
 	cxa_assert(loggerIn);
@@ -127,6 +307,10 @@ void cxa_logger_log_untermString_impl(cxa_logger_t *const loggerIn, const uint8_
 	// if we don't have an ioStream, don't worry about it!
 	if( ioStream == NULL ) return;
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	deferred_logBlobs(loggerIn, levelIn, RECORD_TYPE_UNTERM, prefixIn, untermStringIn, untermStrLen_bytesIn, postFixIn);
+	return;
+#endif
 
 	cxa_mutex_aquire(printMutex);
 
@@ -172,6 +356,10 @@ void cxa_logger_log_memdump_impl(cxa_logger_t *const loggerIn, const uint8_t lev
 	// if we don't have an ioStream, don't worry about it!
 	if( ioStream == NULL ) return;
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	deferred_logBlobs(loggerIn, levelIn, RECORD_TYPE_MEMDUMP, prefixIn, ptrIn, ptrLen_bytes, postFixIn);
+	return;
+#endif
 
 	cxa_mutex_aquire(printMutex);
 
@@ -189,13 +377,7 @@ void cxa_logger_log_memdump_impl(cxa_logger_t *const loggerIn, const uint8_t lev
 
 	// write our message
 	if( prefixIn != NULL ) cxa_ioStream_writeString(ioStream, (char *const)prefixIn);
-	cxa_ioStream_writeString(ioStream, "{");
-	for( size_t i = 0; i < ptrLen_bytes; i++ )
-	{
-		cxa_ioStream_writeFormattedString(ioStream, "%02X", ((uint8_t*)ptrIn)[i]);
-		if( i != (ptrLen_bytes-1) ) cxa_ioStream_writeString(ioStream, ", ");
-	}
-	cxa_ioStream_writeString(ioStream, "}");
+	writeMemDump(ptrIn, ptrLen_bytes);
 	if( postFixIn != NULL ) cxa_ioStream_writeString(ioStream, (char *const)postFixIn);
 
 	// print EOL
@@ -291,13 +473,7 @@ void cxa_logger_stepDebug_memDump_impl(const char* fileIn, const int lineNumIn,
 	// print our message
 	cxa_ioStream_writeString(ioStream, msgIn);
 
-	cxa_ioStream_writeString(ioStream, "{");
-	for( size_t i = 0; i < numBytesIn; i++ )
-	{
-		cxa_ioStream_writeFormattedString(ioStream, "%02X", ((uint8_t*)bytesIn)[i]);
-		if( i != (numBytesIn-1) ) cxa_ioStream_writeString(ioStream, ", ");
-	}
-	cxa_ioStream_writeString(ioStream, "}");
+	writeMemDump(bytesIn, numBytesIn);
 
 
 	// print EOL
@@ -326,6 +502,10 @@ void cxa_logger_log_varArgs(cxa_logger_t *const loggerIn, const uint8_t levelIn,
 	// if we don't have an ioStream, don't worry about it!
 	if( ioStream == NULL ) return;
 
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+	deferred_logFormatted(loggerIn, levelIn, formatIn, argsIn);
+	return;
+#endif
 
 	cxa_mutex_aquire(printMutex);
 
@@ -362,80 +542,786 @@ static inline void checkInit(void)
 		// mark init first since we'll have a stack overflow (recursive call if not)
 		isInit = true;
 		cxa_assert(printMutex = cxa_mutex_reserve());
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+		cxa_assert_msg(((CXA_LOGGER_DEFERRED_NUM_RECORDS & RECORD_INDEX_MASK) == 0), "CXA_LOGGER_DEFERRED_NUM_RECORDS must be a power of two");
+		for( size_t i = 0; i < CXA_LOGGER_DEFERRED_NUM_RECORDS; i++ )
+		{
+			recordSlots[i].sequence = i;
+		}
+#endif
+
 		cxa_logger_init(&sysLog, "sysLog");
 	}
 }
 
 
-static void writeField(const char *const stringIn, size_t maxFieldLenIn)
+static void writeHeader(cxa_logger_t *const loggerIn, const uint8_t levelIn)
 {
-	size_t stringLen_bytes = strlen(stringIn);
+	cxa_assert(loggerIn);
 
-	if( stringLen_bytes > maxFieldLenIn )
-	{
-		cxa_ioStream_writeBytes(ioStream, (void*)stringIn, maxFieldLenIn-strlen(CXA_LOGGER_TRUNCATE_STRING));
-		cxa_ioStream_writeString(ioStream, CXA_LOGGER_TRUNCATE_STRING);
-	}
-	else
+	// render the whole header so it goes out in a single write
+	char buff[HEADER_MAXLEN_BYTES + 1];
+	textBuilder_t tb;
+	textBuilder_init(&tb, buff, HEADER_MAXLEN_BYTES);
+	textBuilder_appendHeader(&tb, loggerIn, levelIn, cxa_timeBase_getCount_us());
+
+	cxa_ioStream_writeBytes(ioStream, buff, tb.len_bytes);
+}
+
+
+static void writeMemDump(const void *const bytesIn, size_t numBytesIn)
+{
+	char buff[MEMDUMP_CHUNK_SIZE_BYTES];
+	size_t buffLen_bytes = 0;
+
+	buff[buffLen_bytes++] = '{';
+	for( size_t i = 0; i < numBytesIn; i++ )
 	{
-		cxa_ioStream_writeString(ioStream, (char*)stringIn);
-		for( size_t i = stringLen_bytes; i < maxFieldLenIn; i++ )
+		// worst case is "XX, "
+		if( (buffLen_bytes + 4) > sizeof(buff) )
 		{
-			cxa_ioStream_writeByte(ioStream, ' ');
+			cxa_ioStream_writeBytes(ioStream, buff, buffLen_bytes);
+			buffLen_bytes = 0;
 		}
+		buffLen_bytes += formatHexByte(&buff[buffLen_bytes], ((uint8_t*)bytesIn)[i], (i == (numBytesIn-1)));
+	}
+	if( buffLen_bytes == sizeof(buff) )
+	{
+		cxa_ioStream_writeBytes(ioStream, buff, buffLen_bytes);
+		buffLen_bytes = 0;
 	}
+	buff[buffLen_bytes++] = '}';
+
+	cxa_ioStream_writeBytes(ioStream, buff, buffLen_bytes);
 }
 
 
-static void writeHeader(cxa_logger_t *const loggerIn, const uint8_t levelIn)
+static const char* getLevelText(const uint8_t levelIn)
 {
-	cxa_assert(loggerIn);
-
-	// figure out our level text
-	const char *levelText = "UNKN";
 	switch( levelIn )
 	{
 		case CXA_LOG_LEVEL_ERROR:
-			levelText = "ERROR";
-			break;
+			return "ERROR";
 
 		case CXA_LOG_LEVEL_WARN:
-			levelText = "WARN";
-			break;
+			return "WARN";
 
 		case CXA_LOG_LEVEL_INFO:
-			levelText = "INFO";
-			break;
+			return "INFO";
 
 		case CXA_LOG_LEVEL_DEBUG:
-			levelText = "DEBUG";
-			break;
+			return "DEBUG";
 
 		case CXA_LOG_LEVEL_TRACE:
-			levelText = "TRACE";
-			break;
+			return "TRACE";
 	}
 
+	return "UNKN";
+}
+
+
+static size_t formatHexByte(char *const buffIn, uint8_t byteIn, bool isLastIn)
+{
+	static const char hexChars[] = "0123456789ABCDEF";
+
+	buffIn[0] = hexChars[byteIn >> 4];
+	buffIn[1] = hexChars[byteIn & 0x0F];
+	if( isLastIn ) return 2;
+
+	buffIn[2] = ',';
+	buffIn[3] = ' ';
+	return 4;
+}
+
+
+static void textBuilder_init(textBuilder_t *const tbIn, char *const bufferIn, size_t maxLen_bytesIn)
+{
+	tbIn->buffer = bufferIn;
+	tbIn->maxLen_bytes = maxLen_bytesIn;
+	tbIn->len_bytes = 0;
+	tbIn->isTruncated = false;
+}
+
+
+static void textBuilder_append(textBuilder_t *const tbIn, const void *const dataIn, size_t len_bytesIn)
+{
+	if( len_bytesIn == 0 ) return;
+
+	size_t free_bytes = tbIn->maxLen_bytes - tbIn->len_bytes;
+	if( len_bytesIn > free_bytes )
+	{
+		len_bytesIn = free_bytes;
+		tbIn->isTruncated = true;
+	}
+
+	memcpy(&tbIn->buffer[tbIn->len_bytes], dataIn, len_bytesIn);
+	tbIn->len_bytes += len_bytesIn;
+}
+
+
+static void textBuilder_appendString(textBuilder_t *const tbIn, const char *const stringIn)
+{
+	textBuilder_append(tbIn, stringIn, strlen(stringIn));
+}
+
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static void textBuilder_appendFormatted(textBuilder_t *const tbIn, const char *const formatIn, ...)
+{
+	size_t free_bytes = tbIn->maxLen_bytes - tbIn->len_bytes;
+
+	// the extra byte in our buffer leaves room for vsnprintf's null terminator
+	va_list varArgs;
+	va_start(varArgs, formatIn);
+	int numChars = vsnprintf(&tbIn->buffer[tbIn->len_bytes], free_bytes + 1, formatIn, varArgs);
+	va_end(varArgs);
+	if( numChars < 0 ) return;
+
+	if( (size_t)numChars > free_bytes )
+	{
+		numChars = free_bytes;
+		tbIn->isTruncated = true;
+	}
+	tbIn->len_bytes += numChars;
+}
+#endif
+
+
+static void textBuilder_appendField(textBuilder_t *const tbIn, const char *const stringIn, size_t maxFieldLenIn)
+{
+	size_t stringLen_bytes = strlen(stringIn);
+
+	if( stringLen_bytes > maxFieldLenIn )
+	{
+		textBuilder_append(tbIn, stringIn, maxFieldLenIn-strlen(CXA_LOGGER_TRUNCATE_STRING));
+		textBuilder_appendString(tbIn, CXA_LOGGER_TRUNCATE_STRING);
+	}
+	else
+	{
+		textBuilder_append(tbIn, stringIn, stringLen_bytes);
+		for( size_t i = stringLen_bytes; i < maxFieldLenIn; i++ )
+		{
+			textBuilder_append(tbIn, " ", 1);
+		}
+	}
+}
+
+
+static void textBuilder_appendHeader(textBuilder_t *const tbIn, cxa_logger_t *const loggerIn, const uint8_t levelIn, uint32_t timestamp_usIn)
+{
 	// our buffer for this go-round max...our pointer size
 	// plus [0x] plus null-term
 	char buff[sizeof(loggerIn)*2 + 4 + 1];
 
 	// print the time (if enabled)
 	#ifdef CXA_LOGGER_TIME_ENABLE
-		snprintf(buff, sizeof(buff), "%-8" PRIx32, cxa_timeBase_getCount_us());
+		snprintf(buff, sizeof(buff), "%-8" PRIx32, timestamp_usIn);
 		// 32-bit integer +space
-		writeField(buff, 9);
+		textBuilder_appendField(tbIn, buff, 9);
+	#else
+		(void)timestamp_usIn;
 	#endif
 
 
 	// print the name
-	writeField(loggerIn->name, largestloggerName_bytes);
+	textBuilder_appendField(tbIn, loggerIn->name, largestloggerName_bytes);
 
 	// pointer (id of logger)
 	snprintf(buff, sizeof(buff), "[%p]", loggerIn);
-	writeField(buff, 5+(2*sizeof(void*)));
+	textBuilder_appendField(tbIn, buff, 5+(2*sizeof(void*)));
 
 	// level text
-	writeField(levelText, 5);
-	cxa_ioStream_writeByte(ioStream, ' ');
+	textBuilder_appendField(tbIn, getLevelText(levelIn), 5);
+	textBuilder_append(tbIn, " ", 1);
+}
+
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static void textBuilder_finishLine(textBuilder_t *const tbIn)
+{
+	size_t eolLen_bytes = strlen(CXA_LINE_ENDING);
+	size_t truncLen_bytes = strlen(CXA_LOGGER_TRUNCATE_STRING);
+
+	if( (tbIn->len_bytes + eolLen_bytes) > tbIn->maxLen_bytes ) tbIn->isTruncated = true;
+
+	// make room for our trailer (backing over the end of the text if needed)
+	size_t trailerLen_bytes = eolLen_bytes + (tbIn->isTruncated ? truncLen_bytes : 0);
+	if( tbIn->maxLen_bytes < trailerLen_bytes )
+	{
+		// not even enough room for that
+		tbIn->len_bytes = 0;
+		tbIn->isTruncated = true;
+		return;
+	}
+	if( (tbIn->len_bytes + trailerLen_bytes) > tbIn->maxLen_bytes ) tbIn->len_bytes = tbIn->maxLen_bytes - trailerLen_bytes;
+
+	if( tbIn->isTruncated )
+	{
+		memcpy(&tbIn->buffer[tbIn->len_bytes], CXA_LOGGER_TRUNCATE_STRING, truncLen_bytes);
+		tbIn->len_bytes += truncLen_bytes;
+	}
+	memcpy(&tbIn->buffer[tbIn->len_bytes], CXA_LINE_ENDING, eolLen_bytes);
+	tbIn->len_bytes += eolLen_bytes;
 }
+#endif
+
+
+#ifdef CXA_LOGGER_DEFERRED_ENABLE
+static record_t* deferred_reserveRecord(cxa_logger_t *const loggerIn, const uint8_t levelIn, recordType_t typeIn, size_t *const posOut)
+{
+#ifdef CXA_CONSOLE_ENABLE
+	// logging is suppressed while commands are executing
+	if( cxa_console_isExecutingCommand() ) return NULL;
+#endif
+
+	recordSlot_t* slot = NULL;
+	size_t pos;
+
+#ifdef __GNUC__
+	// bounded multi-producer queue...claim a slot by advancing the enqueue position
+	pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+	while( true )
+	{
+		recordSlot_t* currSlot = &recordSlots[pos & RECORD_INDEX_MASK];
+		intptr_t diff = (intptr_t)LOAD_ACQUIRE(&currSlot->sequence) - (intptr_t)pos;
+
+		if( diff == 0 )
+		{
+			if( __atomic_compare_exchange_n(&enqueuePos, &pos, pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) )
+			{
+				slot = currSlot;
+				break;
+			}
+		}
+		else if( diff < 0 )
+		{
+			// full (the consumer hasn't flushed this slot yet)
+			break;
+		}
+		else pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+	}
+
+	if( slot == NULL )
+	{
+		__atomic_fetch_add(&numDroppedLines, 1, __ATOMIC_RELAXED);
+		return NULL;
+	}
+#else
+	cxa_criticalSection_enter();
+	pos = enqueuePos;
+	if( recordSlots[pos & RECORD_INDEX_MASK].sequence == pos )
+	{
+		slot = &recordSlots[pos & RECORD_INDEX_MASK];
+		enqueuePos = pos + 1;
+	}
+	else numDroppedLines++;
+	cxa_criticalSection_exit();
+
+	if( slot == NULL ) return NULL;
+#endif
+
+	record_t* retVal = &slot->record;
+	retVal->logger = loggerIn;
+	retVal->format = NULL;
+	retVal->timestamp_us = cxa_timeBase_getCount_us();
+	retVal->type = typeIn;
+	retVal->level = levelIn;
+	retVal->isTruncated = false;
+	retVal->payloadLen_bytes = 0;
+
+	*posOut = pos;
+	return retVal;
+}
+
+
+static void deferred_publishRecord(record_t *const recordIn, size_t posIn)
+{
+	recordSlot_t* slot = &recordSlots[posIn & RECORD_INDEX_MASK];
+	cxa_assert(&slot->record == recordIn);
+
+	STORE_RELEASE(&slot->sequence, posIn + 1);
+}
+
+
+static void deferred_logFormatted(cxa_logger_t *const loggerIn, const uint8_t levelIn, const char* formatIn, va_list argsIn)
+{
+	size_t pos;
+	record_t* record = deferred_reserveRecord(loggerIn, levelIn, RECORD_TYPE_FORMATTED, &pos);
+	if( record == NULL ) return;
+
+	record->format = formatIn;
+
+	// capture the raw arguments (in order) for formatting at flush time
+	for( const char* currChar = formatIn; *currChar != 0; currChar++ )
+	{
+		if( *currChar != '%' ) continue;
+
+		formatSpec_t spec;
+		currChar = parseSpec(currChar, &spec) - 1;
+		if( spec.type == ARG_UNSUPPORTED ) break;
+
+		bool didFit = true;
+		int precision = spec.precision;
+		if( spec.isWidthArg )
+		{
+			int width = va_arg(argsIn, int);
+			didFit = record_append(record, &width, sizeof(width));
+		}
+		if( didFit && spec.isPrecisionArg )
+		{
+			precision = va_arg(argsIn, int);
+			didFit = record_append(record, &precision, sizeof(precision));
+		}
+		if( !didFit ) break;
+
+		switch( spec.type )
+		{
+			case ARG_INT:		{ int val = va_arg(argsIn, int); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_UINT:		{ unsigned int val = va_arg(argsIn, unsigned int); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_LONG:		{ long val = va_arg(argsIn, long); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_ULONG:		{ unsigned long val = va_arg(argsIn, unsigned long); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_LLONG:		{ long long val = va_arg(argsIn, long long); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_ULLONG:	{ unsigned long long val = va_arg(argsIn, unsigned long long); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_SIZE:		{ size_t val = va_arg(argsIn, size_t); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_INTMAX:	{ intmax_t val = va_arg(argsIn, intmax_t); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_UINTMAX:	{ uintmax_t val = va_arg(argsIn, uintmax_t); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_PTRDIFF:	{ ptrdiff_t val = va_arg(argsIn, ptrdiff_t); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_DOUBLE:	{ double val = va_arg(argsIn, double); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_LDOUBLE:	{ long double val = va_arg(argsIn, long double); didFit = record_append(record, &val, sizeof(val)); break; }
+			case ARG_PTR:		{ void* val = va_arg(argsIn, void*); didFit = record_append(record, &val, sizeof(val)); break; }
+
+			case ARG_STRING:
+			{
+				// strings may not outlive this call so copy their contents
+				const char* val = va_arg(argsIn, const char*);
+				if( val == NULL ) val = "(null)";
+
+				size_t maxLen_bytes = sizeof(record->payload);
+				if( (precision >= 0) && ((size_t)precision < maxLen_bytes) ) maxLen_bytes = (size_t)precision;
+				size_t valLen_bytes = strnlen(val, maxLen_bytes);
+				if( (valLen_bytes == maxLen_bytes) && (maxLen_bytes != (size_t)precision) ) record->isTruncated = true;
+
+				didFit = record_appendBlob(record, val, valLen_bytes);
+				break;
+			}
+
+			default:
+				break;
+		}
+		if( !didFit ) break;
+	}
+
+	deferred_publishRecord(record, pos);
+}
+
+
+static void deferred_logBlobs(cxa_logger_t *const loggerIn, const uint8_t levelIn, recordType_t typeIn, const char* prefixIn, const void* dataIn, size_t dataLen_bytesIn, const char* postFixIn)
+{
+	size_t pos;
+	record_t* record = deferred_reserveRecord(loggerIn, levelIn, typeIn, &pos);
+	if( record == NULL ) return;
+
+	if( record_appendBlob(record, prefixIn, (prefixIn != NULL) ? strlen(prefixIn) : 0) &&
+		record_appendBlob(record, dataIn, dataLen_bytesIn) )
+	{
+		record_appendBlob(record, postFixIn, (postFixIn != NULL) ? strlen(postFixIn) : 0);
+	}
+
+	deferred_publishRecord(record, pos);
+}
+
+
+static size_t deferred_flush(size_t maxNumRecordsIn)
+{
+	if( ioStream == NULL ) return 0;
+
+	size_t numRecordsFlushed = 0;
+	size_t flushLen_bytes = 0;
+	textBuilder_t tb;
+
+	// we're the only consumer...but flushes can come from multiple threads
+	cxa_mutex_aquire(printMutex);
+
+#ifdef CXA_CONSOLE_ENABLE
+	bool isPrelogNeeded = true;
+#endif
+
+	while( numRecordsFlushed < maxNumRecordsIn )
+	{
+		recordSlot_t* slot = &recordSlots[dequeuePos & RECORD_INDEX_MASK];
+		if( LOAD_ACQUIRE(&slot->sequence) != (dequeuePos + 1) ) break;
+
+#ifdef CXA_CONSOLE_ENABLE
+		if( isPrelogNeeded )
+		{
+			cxa_console_prelog();
+			isPrelogNeeded = false;
+		}
+#endif
+
+		textBuilder_init(&tb, &flushBuffer[flushLen_bytes], CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES - flushLen_bytes);
+		deferred_renderRecord(&tb, &slot->record);
+		if( tb.isTruncated && (flushLen_bytes > 0) )
+		{
+			// didn't fit behind the other lines...write those and try again
+			cxa_ioStream_writeBytes(ioStream, flushBuffer, flushLen_bytes);
+			flushLen_bytes = 0;
+
+			textBuilder_init(&tb, flushBuffer, CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES);
+			deferred_renderRecord(&tb, &slot->record);
+		}
+		flushLen_bytes += tb.len_bytes;
+
+		// done with this slot, give it back to the producers
+		STORE_RELEASE(&slot->sequence, dequeuePos + CXA_LOGGER_DEFERRED_NUM_RECORDS);
+		dequeuePos++;
+		numRecordsFlushed++;
+	}
+
+	// let the user know if we've lost anything
+	size_t lcl_numDroppedLines = LOAD_ACQUIRE(&numDroppedLines);
+	if( lcl_numDroppedLines != numDroppedLines_reported )
+	{
+		textBuilder_init(&tb, &flushBuffer[flushLen_bytes], CXA_LOGGER_DEFERRED_FLUSH_BUFFER_SIZE_BYTES - flushLen_bytes);
+		textBuilder_appendHeader(&tb, &sysLog, CXA_LOG_LEVEL_WARN, cxa_timeBase_getCount_us());
+		textBuilder_appendFormatted(&tb, "%lu log lines dropped", (unsigned long)(lcl_numDroppedLines - numDroppedLines_reported));
+		textBuilder_finishLine(&tb);
+
+		// if it was truncated, that's ok...it'll be reported again next flush
+		if( !tb.isTruncated )
+		{
+			flushLen_bytes += tb.len_bytes;
+			numDroppedLines_reported = lcl_numDroppedLines;
+		}
+	}
+
+	if( flushLen_bytes > 0 ) cxa_ioStream_writeBytes(ioStream, flushBuffer, flushLen_bytes);
+
+#ifdef CXA_CONSOLE_ENABLE
+	if( !isPrelogNeeded ) cxa_console_postlog();
+#endif
+
+	cxa_mutex_release(printMutex);
+
+	return numRecordsFlushed;
+}
+
+
+static void deferred_renderRecord(textBuilder_t *const tbIn, record_t *const recordIn)
+{
+	textBuilder_appendHeader(tbIn, recordIn->logger, recordIn->level, recordIn->timestamp_us);
+
+	if( recordIn->type == RECORD_TYPE_FORMATTED )
+	{
+		deferred_renderFormatted(tbIn, recordIn);
+	}
+	else
+	{
+		size_t offset = 0;
+		const uint8_t* prefix = NULL;
+		const uint8_t* data = NULL;
+		const uint8_t* postFix = NULL;
+		size_t prefixLen_bytes = 0, dataLen_bytes = 0, postFixLen_bytes = 0;
+
+		record_readBlob(recordIn, &offset, &prefix, &prefixLen_bytes);
+		record_readBlob(recordIn, &offset, &data, &dataLen_bytes);
+		record_readBlob(recordIn, &offset, &postFix, &postFixLen_bytes);
+
+		textBuilder_append(tbIn, prefix, prefixLen_bytes);
+		if( recordIn->type == RECORD_TYPE_MEMDUMP )
+		{
+			char hexBuff[4];
+
+			textBuilder_append(tbIn, "{", 1);
+			for( size_t i = 0; i < dataLen_bytes; i++ )
+			{
+				bool isLast = (i == (dataLen_bytes-1)) && !recordIn->isTruncated;
+				textBuilder_append(tbIn, hexBuff, formatHexByte(hexBuff, data[i], isLast));
+			}
+			if( !recordIn->isTruncated ) textBuilder_append(tbIn, "}", 1);
+		}
+		else textBuilder_append(tbIn, data, dataLen_bytes);
+		textBuilder_append(tbIn, postFix, postFixLen_bytes);
+	}
+
+	if( recordIn->isTruncated ) tbIn->isTruncated = true;
+	textBuilder_finishLine(tbIn);
+}
+
+
+static void deferred_renderFormatted(textBuilder_t *const tbIn, record_t *const recordIn)
+{
+	#define APPEND_ARG(valIn)																	\
+		if( spec.isWidthArg && spec.isPrecisionArg ) textBuilder_appendFormatted(tbIn, specString, width, precision, (valIn));	\
+		else if( spec.isWidthArg ) textBuilder_appendFormatted(tbIn, specString, width, (valIn));	\
+		else if( spec.isPrecisionArg ) textBuilder_appendFormatted(tbIn, specString, precision, (valIn));	\
+		else textBuilder_appendFormatted(tbIn, specString, (valIn));
+
+	#define READ_AND_APPEND_ARG(typeIn)															\
+		{																						\
+			typeIn val;																			\
+			if( !(didFit = record_read(recordIn, &offset, &val, sizeof(val))) ) break;			\
+			APPEND_ARG(val);																	\
+			break;																				\
+		}
+
+	size_t offset = 0;
+	const char* currChar = recordIn->format;
+	while( *currChar != 0 )
+	{
+		// literal text up to the next specifier
+		const char* nextSpec = strchr(currChar, '%');
+		if( nextSpec == NULL )
+		{
+			textBuilder_appendString(tbIn, currChar);
+			break;
+		}
+		textBuilder_append(tbIn, currChar, nextSpec - currChar);
+
+		formatSpec_t spec;
+		currChar = parseSpec(nextSpec, &spec);
+		if( spec.type == ARG_UNSUPPORTED )
+		{
+			// arguments weren't captured beyond this point
+			textBuilder_appendString(tbIn, nextSpec);
+			break;
+		}
+		if( spec.type == ARG_NONE )
+		{
+			textBuilder_append(tbIn, "%", 1);
+			continue;
+		}
+
+		// format this argument on its own
+		char specString[SPEC_MAXLEN_BYTES];
+		memcpy(specString, nextSpec, spec.specLen_bytes);
+		specString[spec.specLen_bytes] = 0;
+
+		bool didFit = true;
+		int width = 0;
+		int precision = spec.precision;
+		if( spec.isWidthArg ) didFit = record_read(recordIn, &offset, &width, sizeof(width));
+		if( didFit && spec.isPrecisionArg ) didFit = record_read(recordIn, &offset, &precision, sizeof(precision));
+		if( !didFit ) break;
+
+		switch( spec.type )
+		{
+			case ARG_INT:		READ_AND_APPEND_ARG(int);
+			case ARG_UINT:		READ_AND_APPEND_ARG(unsigned int);
+			case ARG_LONG:		READ_AND_APPEND_ARG(long);
+			case ARG_ULONG:		READ_AND_APPEND_ARG(unsigned long);
+			case ARG_LLONG:		READ_AND_APPEND_ARG(long long);
+			case ARG_ULLONG:	READ_AND_APPEND_ARG(unsigned long long);
+			case ARG_SIZE:		READ_AND_APPEND_ARG(size_t);
+			case ARG_INTMAX:	READ_AND_APPEND_ARG(intmax_t);
+			case ARG_UINTMAX:	READ_AND_APPEND_ARG(uintmax_t);
+			case ARG_PTRDIFF:	READ_AND_APPEND_ARG(ptrdiff_t);
+			case ARG_DOUBLE:	READ_AND_APPEND_ARG(double);
+			case ARG_LDOUBLE:	READ_AND_APPEND_ARG(long double);
+			case ARG_PTR:		READ_AND_APPEND_ARG(void*);
+
+			case ARG_STRING:
+			{
+				const uint8_t* stringBytes;
+				size_t stringLen_bytes;
+				if( !(didFit = record_readBlob(recordIn, &offset, &stringBytes, &stringLen_bytes)) ) break;
+
+				char stringBuff[sizeof(recordIn->payload)+1];
+				memcpy(stringBuff, stringBytes, stringLen_bytes);
+				stringBuff[stringLen_bytes] = 0;
+				APPEND_ARG(stringBuff);
+				break;
+			}
+
+			default:
+				break;
+		}
+		if( !didFit ) break;
+	}
+
+	#undef READ_AND_APPEND_ARG
+	#undef APPEND_ARG
+}
+
+
+static const char* parseSpec(const char* specIn, formatSpec_t *const specOut)
+{
+	cxa_assert(*specIn == '%');
+
+	const char* currChar = specIn + 1;
+	specOut->type = ARG_UNSUPPORTED;
+	specOut->isWidthArg = false;
+	specOut->isPrecisionArg = false;
+	specOut->precision = -1;
+
+	// flags
+	while( (*currChar == '-') || (*currChar == '+') || (*currChar == ' ') || (*currChar == '#') || (*currChar == '0') ) currChar++;
+
+	// width
+	if( *currChar == '*' )
+	{
+		specOut->isWidthArg = true;
+		currChar++;
+	}
+	else while( (*currChar >= '0') && (*currChar <= '9') ) currChar++;
+
+	// precision
+	if( *currChar == '.' )
+	{
+		currChar++;
+		if( *currChar == '*' )
+		{
+			specOut->isPrecisionArg = true;
+			currChar++;
+		}
+		else
+		{
+			specOut->precision = 0;
+			while( (*currChar >= '0') && (*currChar <= '9') ) specOut->precision = (specOut->precision * 10) + (*currChar++ - '0');
+		}
+	}
+
+	// length
+	char length = 0;
+	switch( *currChar )
+	{
+		case 'h':
+			length = 'h';
+			currChar++;
+			if( *currChar == 'h' ) currChar++;
+			break;
+
+		case 'l':
+			length = 'l';
+			currChar++;
+			if( *currChar == 'l' )
+			{
+				length = 'q';
+				currChar++;
+			}
+			break;
+
+		case 'z': case 'j': case 't': case 'L':
+			length = *currChar++;
+			break;
+	}
+
+	// conversion
+	bool isSigned = false;
+	switch( *currChar )
+	{
+		case '%':
+			if( (currChar == (specIn + 1)) ) specOut->type = ARG_NONE;
+			break;
+
+		case 'd': case 'i':
+			isSigned = true;
+			// fall through
+		case 'o': case 'u': case 'x': case 'X':
+			switch( length )
+			{
+				case 0: case 'h':	specOut->type = isSigned ? ARG_INT : ARG_UINT; break;
+				case 'l':			specOut->type = isSigned ? ARG_LONG : ARG_ULONG; break;
+				case 'q':			specOut->type = isSigned ? ARG_LLONG : ARG_ULLONG; break;
+				case 'z':			specOut->type = ARG_SIZE; break;
+				case 'j':			specOut->type = isSigned ? ARG_INTMAX : ARG_UINTMAX; break;
+				case 't':			specOut->type = ARG_PTRDIFF; break;
+			}
+			break;
+
+		case 'c':
+			if( length == 0 ) specOut->type = ARG_INT;
+			break;
+
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+			if( length == 0 ) specOut->type = ARG_DOUBLE;
+			else if( length == 'L' ) specOut->type = ARG_LDOUBLE;
+			break;
+
+		case 'p':
+			if( length == 0 ) specOut->type = ARG_PTR;
+			break;
+
+		case 's':
+			if( length == 0 ) specOut->type = ARG_STRING;
+			break;
+	}
+	if( *currChar != 0 ) currChar++;
+
+	specOut->specLen_bytes = currChar - specIn;
+	if( specOut->specLen_bytes >= SPEC_MAXLEN_BYTES ) specOut->type = ARG_UNSUPPORTED;
+
+	return currChar;
+}
+
+
+static bool record_append(record_t *const recordIn, const void *const dataIn, size_t len_bytesIn)
+{
+	if( (recordIn->payloadLen_bytes + len_bytesIn) > sizeof(recordIn->payload) )
+	{
+		recordIn->isTruncated = true;
+		return false;
+	}
+
+	memcpy(&recordIn->payload[recordIn->payloadLen_bytes], dataIn, len_bytesIn);
+	recordIn->payloadLen_bytes += len_bytesIn;
+	return true;
+}
+
+
+static bool record_appendBlob(record_t *const recordIn, const void *const dataIn, size_t len_bytesIn)
+{
+	// blobs are stored as a length (which may be truncated) followed by the data
+	size_t free_bytes = sizeof(recordIn->payload) - recordIn->payloadLen_bytes;
+	if( free_bytes < sizeof(uint16_t) )
+	{
+		recordIn->isTruncated = true;
+		return false;
+	}
+	free_bytes -= sizeof(uint16_t);
+
+	bool retVal = true;
+	if( len_bytesIn > free_bytes )
+	{
+		len_bytesIn = free_bytes;
+		recordIn->isTruncated = true;
+		retVal = false;
+	}
+
+	uint16_t len_bytes = (uint16_t)len_bytesIn;
+	record_append(recordIn, &len_bytes, sizeof(len_bytes));
+	if( len_bytesIn > 0 ) record_append(recordIn, dataIn, len_bytesIn);
+
+	return retVal;
+}
+
+
+static bool record_read(record_t *const recordIn, size_t *const offsetIn, void *const dataOut, size_t len_bytesIn)
+{
+	if( (*offsetIn + len_bytesIn) > recordIn->payloadLen_bytes ) return false;
+
+	memcpy(dataOut, &recordIn->payload[*offsetIn], len_bytesIn);
+	*offsetIn += len_bytesIn;
+	return true;
+}
+
+
+static bool record_readBlob(record_t *const recordIn, size_t *const offsetIn, const uint8_t** dataOut, size_t *const len_bytesOut)
+{
+	uint16_t len_bytes;
+	if( !record_read(recordIn, offsetIn, &len_bytes, sizeof(len_bytes)) ) return false;
+	if( (*offsetIn + len_bytes) > recordIn->payloadLen_bytes ) return false;
+
+	*dataOut = &recordIn->payload[*offsetIn];
+	*len_bytesOut = len_bytes;
+	*offsetIn += len_bytes;
+	return true;
+}
+
+
+static void cb_onRunLoopUpdate(void* userVarIn)
+{
+	deferred_flush(CXA_LOGGER_DEFERRED_MAX_RECORDS_PER_FLUSH);
+}
+#endif
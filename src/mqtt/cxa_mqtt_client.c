@@ -17,6 +17,11 @@
 #include <cxa_mqtt_message_subscribe.h>
 #include <cxa_mqtt_message_suback.h>
 #include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_puback.h>
+#include <cxa_mqtt_message_pubrec.h>
+#include <cxa_mqtt_message_pubrel.h>
+#include <cxa_mqtt_message_pubcomp.h>
+#include <cxa_runLoop.h>
 #include <cxa_stringUtils.h>
 
 #define CXA_LOG_LEVEL		CXA_LOG_LEVEL_INFO
@@ -30,6 +35,10 @@
 
 #define SUBACK_TIMEOUT_MS				5000
 
+// PINGREQ is only a fixed header...PUBACK/PUBREC/PUBREL/PUBCOMP add a packetId
+#define PINGREQ_SIZE_BYTES				2
+#define PUBLISHRESPONSE_SIZE_BYTES		4
+
 
 // ******** local type definitions ********
 typedef enum
@@ -55,10 +64,30 @@ static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_me
 static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
 static void handleMessage_subAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
 static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
-
-static bool doesTopicMatchFilter(char* topicIn, char* filterIn);
+static void handleMessage_pubAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+static void handleMessage_pubRec(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+static void handleMessage_pubRel(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+static void handleMessage_pubComp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+
+static uint16_t getNextPacketId(cxa_mqtt_client_t *const clientIn);
+static cxa_mqtt_client_inFlightEntry_t* inFlight_getEntry(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static cxa_mqtt_client_inFlightEntry_t* inFlight_reserveEntry(cxa_mqtt_client_t *const clientIn);
+static void inFlight_releaseEntry(cxa_mqtt_client_inFlightEntry_t *const entryIn);
+static void inFlight_transmitEntry(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inFlightEntry_t *const entryIn);
+static bool inboundQos2_contains(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static void inboundQos2_add(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static void inboundQos2_remove(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static bool sendPublishResponse(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn);
+
+static void topicTrieCb_onMatch(void *const valueIn, void *const userVarIn);
 static void notify_activity(cxa_mqtt_client_t *const clientIn);
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+static void rxMsgs_retainIfHeld(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+static void cb_onRunLoopUpdate(void* userVarIn);
+static bool cb_hasPendingWork(void* userVarIn);
+#endif
+
 
 // ********  local variable declarations *********
 
@@ -77,6 +106,8 @@ void cxa_mqtt_client_init(cxa_mqtt_client_t *const clientIn, cxa_ioStream_t *con
 	// setup some initial values
 	clientIn->keepAliveTimeout_s = keepAliveTimeout_sIn;
 	clientIn->scm_onDisconnect = NULL;
+	clientIn->currPacketId = 1;
+	clientIn->cleanSession = true;
 	cxa_timeDiff_init(&clientIn->td_timeout);
 	cxa_timeDiff_init(&clientIn->td_sendKeepAlive);
 	cxa_timeDiff_init(&clientIn->td_receiveKeepAlive);
@@ -90,14 +121,39 @@ void cxa_mqtt_client_init(cxa_mqtt_client_t *const clientIn, cxa_ioStream_t *con
 	cxa_protocolParser_addProtocolListener(&clientIn->mpp.super, protoParseCb_onIoException, NULL, (void*)clientIn);
 	cxa_protocolParser_addPacketListener(&clientIn->mpp.super, protoParseCb_onPacketReceived, (void*)clientIn);
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	// more messages to receive into while subscribers hold on to previous ones
+	clientIn->rxMsgs[0] = msg;
+	clientIn->rxMsgs_isRetained[0] = false;
+	for( size_t i = 1; i < CXA_MQTT_CLIENT_NUM_RX_MESSAGES; i++ )
+	{
+		clientIn->rxMsgs[i] = cxa_mqtt_messageFactory_getFreeMessage_empty();
+		cxa_assert_msg(clientIn->rxMsgs[i], "increase CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES");
+		clientIn->rxMsgs_isRetained[i] = false;
+		cxa_protocolParser_addRxBuffer(&clientIn->mpp.super, clientIn->rxMsgs[i]->buffer);
+	}
+	cxa_runLoop_addEntry_idleAware(threadIdIn, "mqttC_rx", NULL, cb_onRunLoopUpdate, cb_hasPendingWork, (void*)clientIn);
+#endif
+
 	// setup our logger
 	cxa_logger_init(&clientIn->logger, "mqttC");
 
 	// setup our listeners array
 	cxa_array_initStd(&clientIn->listeners, clientIn->listeners_raw);
 
-	// setup our subscriptions array
+	// setup our subscriptions array (and the trie used to route to them)
 	cxa_array_initStd(&clientIn->subscriptions, clientIn->subscriptions_raw);
+	cxa_mqtt_topicTrie_initStd(&clientIn->subscriptionTrie, clientIn->subscriptionTrie_nodes, clientIn->subscriptionTrie_values);
+
+	// setup our in-flight window
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		clientIn->inFlight[i].state = CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE;
+		clientIn->inFlight[i].msg = NULL;
+		cxa_timeDiff_init(&clientIn->inFlight[i].td_retransmit);
+	}
+	memset(clientIn->inboundQos2PacketIds, 0, sizeof(clientIn->inboundQos2PacketIds));
+	clientIn->inboundQos2NextIndex = 0;
 
 	// setup our will
 	clientIn->will.topic[0] = 0;
@@ -162,6 +218,14 @@ void cxa_mqtt_client_addListener(cxa_mqtt_client_t *const clientIn,
 }
 
 
+void cxa_mqtt_client_setCleanSession(cxa_mqtt_client_t *const clientIn, bool cleanSessionIn)
+{
+	cxa_assert(clientIn);
+
+	clientIn->cleanSession = cleanSessionIn;
+}
+
+
 bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const usernameIn, uint8_t *const passwordIn, uint16_t passwordLen_bytesIn)
 {
 	cxa_assert(clientIn);
@@ -177,7 +241,7 @@ bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const user
 	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
 			!cxa_mqtt_message_connect_init(msg, clientIn->clientId, usernameIn, passwordIn, passwordLen_bytesIn,
 										   clientIn->will.qos, clientIn->will.retain, clientIn->will.topic, clientIn->will.payload, clientIn->will.payloadLen_bytes,
-										   true, clientIn->keepAliveTimeout_s) ||
+										   clientIn->cleanSession, clientIn->keepAliveTimeout_s) ||
 			!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
 	{
 		cxa_logger_warn(&clientIn->logger, "failed to reserve/initialize/send CONNECT ctrlPacket");
@@ -223,7 +287,7 @@ bool cxa_mqtt_client_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLeve
 
 	cxa_mqtt_message_t* msg = NULL;
 	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
-		!cxa_mqtt_message_publish_init(msg, false, qosIn, retainIn, topicNameIn, clientIn->currPacketId++, payloadIn, payloadLen_bytesIn) )
+		!cxa_mqtt_message_publish_init(msg, false, qosIn, retainIn, topicNameIn, 0, payloadIn, payloadLen_bytesIn) )
 	{
 		cxa_logger_warn(&clientIn->logger, "publish reserve/initialize failed, dropped");
 		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
@@ -245,7 +309,36 @@ bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt
 
 	char *topicName;
 	uint16_t topicNameLen_bytes;
-	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) ) return false;
+	cxa_mqtt_qosLevel_t qos;
+	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) ||
+		!cxa_mqtt_message_publish_getQos(msgIn, &qos) ) return false;
+
+	// higher QOS levels are tracked until acknowledged
+	if( qos != CXA_MQTT_QOS_ATMOST_ONCE )
+	{
+		cxa_mqtt_client_inFlightEntry_t* entry = inFlight_reserveEntry(clientIn);
+		if( entry == NULL )
+		{
+			cxa_logger_warn(&clientIn->logger, "in-flight window full, dropped");
+			return false;
+		}
+		if( !cxa_mqtt_message_publish_setPacketId(msgIn, entry->packetId) ||
+			!cxa_mqtt_message_publish_setDup(msgIn, false) )
+		{
+			cxa_logger_warn(&clientIn->logger, "malformed publish, dropped");
+			return false;
+		}
+
+		// hold on to the message until it is acknowledged
+		cxa_mqtt_messageFactory_incrementMessageRefCount(msgIn);
+		entry->msg = msgIn;
+		entry->state = (qos == CXA_MQTT_QOS_ATLEAST_ONCE) ? CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK : CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC;
+
+		// a failed send will be retried by our retransmission timer
+		inFlight_transmitEntry(clientIn, entry);
+		notify_activity(clientIn);
+		return true;
+	}
 
 //	cxa_logger_log_untermString(&clientIn->logger, CXA_LOG_LEVEL_INFO, "publish '", topicName, topicNameLen_bytes, "'");
 	bool retVal = true;
@@ -261,11 +354,23 @@ bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt
 }
 
 
-void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn)
+size_t cxa_mqtt_client_getNumInFlight(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	size_t retVal = 0;
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		if( clientIn->inFlight[i].state != CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE ) retVal++;
+	}
+	return retVal;
+}
+
+
+bool cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn)
 {
 	cxa_assert(clientIn);
 	cxa_assert(topicFilterIn);
-	cxa_assert(strlen(topicFilterIn) <= CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES);
 	cxa_assert(cb_onPublishIn);
 
 	// make sure we don't have exact duplicates
@@ -275,20 +380,39 @@ void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFil
 		if( cxa_stringUtils_equals(currSubscription->topicFilter, topicFilterIn) &&
 			(currSubscription->qos == qosIn) &&
 			(currSubscription->cb_onPublish == cb_onPublishIn) &&
-			(currSubscription->userVar == userVarIn) ) return;
+			(currSubscription->userVar == userVarIn) ) return true;
 
 	}
 
 	// create our subscription entry and add to our subscriptions
 	cxa_mqtt_client_subscriptionEntry_t newEntry = {
 			.state=CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED,
-			.packetId=clientIn->currPacketId++,
+			.packetId=getNextPacketId(clientIn),
 			.qos = qosIn,
 			.cb_onPublish=cb_onPublishIn,
-			.userVar=userVarIn
+			.userVar=userVarIn,
+			.nextMatch=NULL
 	};
-	cxa_assert(cxa_stringUtils_copy(newEntry.topicFilter, topicFilterIn, sizeof(newEntry.topicFilter)));
-	cxa_assert( cxa_array_append(&clientIn->subscriptions, &newEntry) );
+	if( !cxa_stringUtils_copy(newEntry.topicFilter, topicFilterIn, sizeof(newEntry.topicFilter)) )
+	{
+		cxa_logger_warn(&clientIn->logger, "topic filter too long, increase CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES");
+		return false;
+	}
+	if( !cxa_array_append(&clientIn->subscriptions, &newEntry) )
+	{
+		cxa_logger_warn(&clientIn->logger, "too many subscriptions, increase CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS");
+		return false;
+	}
+
+	// the trie references the topic filter stored in our array entry (subscriptions are never removed)
+	size_t addedIndex = cxa_array_getSize_elems(&clientIn->subscriptions) - 1;
+	cxa_mqtt_client_subscriptionEntry_t* addedEntry = (cxa_mqtt_client_subscriptionEntry_t*)cxa_array_get(&clientIn->subscriptions, addedIndex);
+	if( !cxa_mqtt_topicTrie_add(&clientIn->subscriptionTrie, addedEntry->topicFilter, (void*)addedEntry) )
+	{
+		cxa_logger_warn(&clientIn->logger, "malformed topic filter '%s' or no room (increase CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES)", topicFilterIn);
+		cxa_array_remove_atIndex(&clientIn->subscriptions, addedIndex);
+		return false;
+	}
 
 	// try to actually send our subscribe (if we're connected)
 	if( cxa_stateMachine_getCurrentState(&clientIn->stateMachine) == MQTT_STATE_CONNECTED )
@@ -303,6 +427,7 @@ void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFil
 		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 	}
 
+	return true;
 }
 
 
@@ -417,12 +542,33 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 	cxa_timeDiff_setStartTime_now(&clientIn->td_sendKeepAlive);
 	cxa_timeDiff_setStartTime_now(&clientIn->td_receiveKeepAlive);
 
+	// a clean session means the server has forgotten any QOS2 exchanges
+	if( clientIn->cleanSession )
+	{
+		memset(clientIn->inboundQos2PacketIds, 0, sizeof(clientIn->inboundQos2PacketIds));
+		for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+		{
+			if( clientIn->inFlight[i].state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP ) inFlight_releaseEntry(&clientIn->inFlight[i]);
+		}
+	}
+
+	// replay any unacknowledged messages
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		cxa_mqtt_client_inFlightEntry_t* currEntry = &clientIn->inFlight[i];
+		if( currEntry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE ) continue;
+
+		cxa_logger_debug(&clientIn->logger, "replaying in-flight packetId %d", currEntry->packetId);
+		if( currEntry->msg != NULL ) cxa_mqtt_message_publish_setDup(currEntry->msg, true);
+		inFlight_transmitEntry(clientIn, currEntry);
+	}
+
 	// re-subscribe to our subscriptions
 	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
 	{
 		if( currSubscription == NULL ) continue;
 
-		currSubscription->packetId = clientIn->currPacketId++;
+		currSubscription->packetId = getNextPacketId(clientIn);
 		currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED;
 
 		cxa_logger_trace(&clientIn->logger, "subscribing to stored '%s'", currSubscription->topicFilter);
@@ -456,7 +602,7 @@ static void stateCb_connected_state(cxa_stateMachine_t *const smIn, void *userVa
 	{
 		cxa_logger_trace(&clientIn->logger, "sending PINGREQ");
 		cxa_mqtt_message_t* msg = NULL;
-		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
+		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_sized(PINGREQ_SIZE_BYTES)) == NULL) ||
 				!cxa_mqtt_message_pingRequest_init(msg) ||
 				!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
 		{
@@ -474,6 +620,18 @@ static void stateCb_connected_state(cxa_stateMachine_t *const smIn, void *userVa
 		if( clientIn->scm_onDisconnect != NULL ) clientIn->scm_onDisconnect(clientIn);
 		return;
 	}
+
+	// retransmit any unacknowledged messages
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		cxa_mqtt_client_inFlightEntry_t* currEntry = &clientIn->inFlight[i];
+		if( (currEntry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE) ||
+			!cxa_timeDiff_isElapsed_ms(&currEntry->td_retransmit, CXA_MQTT_CLIENT_RETRANSMIT_TIMEOUT_MS) ) continue;
+
+		cxa_logger_debug(&clientIn->logger, "retransmitting packetId %d", currEntry->packetId);
+		if( currEntry->msg != NULL ) cxa_mqtt_message_publish_setDup(currEntry->msg, true);
+		inFlight_transmitEntry(clientIn, currEntry);
+	}
 }
 
 
@@ -528,10 +686,30 @@ static void protoParseCb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn,
 			handleMessage_publish(clientIn, msg);
 			break;
 
+		case CXA_MQTT_MSGTYPE_PUBACK:
+			handleMessage_pubAck(clientIn, msg);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREC:
+			handleMessage_pubRec(clientIn, msg);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREL:
+			handleMessage_pubRel(clientIn, msg);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			handleMessage_pubComp(clientIn, msg);
+			break;
+
 		default:
 			cxa_logger_trace(&clientIn->logger, "got unknown msgType: %d", msgType);
 			break;
 	}
+
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	rxMsgs_retainIfHeld(clientIn, msg);
+#endif
 }
 
 
@@ -617,36 +795,58 @@ static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_me
 	cxa_assert(clientIn);
 	cxa_assert(msgIn);
 
-	// iterate through our subscriptions to figure out where this goes
+	// figure out which subscriptions this goes to
 	char *topicName;
 	uint16_t topicNameLen_bytes;
 	cxa_linkedField_t* lf_payload;
 	void *payload;
 	size_t payloadSize_bytes;
-	if( cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) && cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) )
+	cxa_mqtt_qosLevel_t qos;
+	uint16_t packetId = 0;
+	if( cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) && cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) &&
+		cxa_mqtt_message_publish_getQos(msgIn, &qos) && ((qos == CXA_MQTT_QOS_ATMOST_ONCE) || cxa_mqtt_message_publish_getPacketId(msgIn, &packetId)) )
 	{
 		cxa_logger_info_untermString(&clientIn->logger, "got PUBLISH '", topicName, topicNameLen_bytes, "'");
 
+		// a QOS2 message we've already received (but not yet released) must not be delivered twice
+		if( (qos == CXA_MQTT_QOS_EXACTLY_ONCE) && inboundQos2_contains(clientIn, packetId) )
+		{
+			cxa_logger_debug(&clientIn->logger, "duplicate QOS2 packetId %d", packetId);
+			sendPublishResponse(clientIn, CXA_MQTT_MSGTYPE_PUBREC, packetId);
+			return;
+		}
+
 		payloadSize_bytes = cxa_linkedField_getSize_bytes(lf_payload);
 		payload = (payloadSize_bytes > 0) ? cxa_linkedField_get_pointerToIndex(lf_payload, 0) : NULL;
 
-		cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
-		{
-			if( currSubscription == NULL ) continue;
+		// find all matching subscriptions first (our subscribers may modify the message)
+		cxa_mqtt_client_subscriptionEntry_t* matches = NULL;
+		cxa_mqtt_topicTrie_match(&clientIn->subscriptionTrie, topicName, topicNameLen_bytes, topicTrieCb_onMatch, (void*)&matches);
 
-			// @TODO this is a hack...I'm using paho's topic matching code...but it expects a null-terminated string
-			// MQTT spec says all string are not null-terminated...I don't want to change the message data (add null)
-			// so we'll null term for the check, then un-null term
+		// matches are chained in reverse...reverse again to notify in subscription order
+		cxa_mqtt_client_subscriptionEntry_t* orderedMatches = NULL;
+		while( matches != NULL )
+		{
+			cxa_mqtt_client_subscriptionEntry_t* nextMatch = matches->nextMatch;
+			matches->nextMatch = orderedMatches;
+			orderedMatches = matches;
+			matches = nextMatch;
+		}
 
-			char oldVal = topicName[topicNameLen_bytes];
-			topicName[topicNameLen_bytes] = 0;
-			bool doesTopicMatch = doesTopicMatchFilter(topicName, currSubscription->topicFilter);
-			topicName[topicNameLen_bytes] = oldVal;
+		for( cxa_mqtt_client_subscriptionEntry_t* currSubscription = orderedMatches; currSubscription != NULL; currSubscription = currSubscription->nextMatch )
+		{
+			if( currSubscription->cb_onPublish ) currSubscription->cb_onPublish(clientIn, msgIn, topicName, topicNameLen_bytes, payload, payloadSize_bytes, currSubscription->userVar);
+		}
 
-			if( doesTopicMatch && currSubscription->cb_onPublish )
-			{
-				currSubscription->cb_onPublish(clientIn, msgIn, topicName, topicNameLen_bytes, payload, payloadSize_bytes, currSubscription->userVar);
-			}
+		// acknowledge (if needed)
+		if( qos == CXA_MQTT_QOS_ATLEAST_ONCE )
+		{
+			sendPublishResponse(clientIn, CXA_MQTT_MSGTYPE_PUBACK, packetId);
+		}
+		else if( qos == CXA_MQTT_QOS_EXACTLY_ONCE )
+		{
+			inboundQos2_add(clientIn, packetId);
+			sendPublishResponse(clientIn, CXA_MQTT_MSGTYPE_PUBREC, packetId);
 		}
 
 		// notify our listeners
@@ -655,43 +855,272 @@ static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_me
 }
 
 
+static void handleMessage_pubAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	uint16_t packetId;
+	if( !cxa_mqtt_message_puback_getPacketId(msgIn, &packetId) )
+	{
+		cxa_logger_warn(&clientIn->logger, "malformed PUBACK");
+		return;
+	}
+	cxa_logger_trace(&clientIn->logger, "got PUBACK for packetId %d", packetId);
+
+	cxa_mqtt_client_inFlightEntry_t* entry = inFlight_getEntry(clientIn, packetId);
+	if( (entry == NULL) || (entry->state != CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK) ) return;
+
+	inFlight_releaseEntry(entry);
+	notify_activity(clientIn);
+}
+
+
+static void handleMessage_pubRec(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	uint16_t packetId;
+	if( !cxa_mqtt_message_pubrec_getPacketId(msgIn, &packetId) )
+	{
+		cxa_logger_warn(&clientIn->logger, "malformed PUBREC");
+		return;
+	}
+	cxa_logger_trace(&clientIn->logger, "got PUBREC for packetId %d", packetId);
+
+	cxa_mqtt_client_inFlightEntry_t* entry = inFlight_getEntry(clientIn, packetId);
+	if( (entry == NULL) || (entry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK) ) return;
+
+	// the server now owns the message, we only need to release it
+	if( entry->msg != NULL )
+	{
+		cxa_mqtt_messageFactory_decrementMessageRefCount(entry->msg);
+		entry->msg = NULL;
+	}
+	entry->state = CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP;
+	inFlight_transmitEntry(clientIn, entry);
+	notify_activity(clientIn);
+}
+
+
+static void handleMessage_pubRel(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	uint16_t packetId;
+	if( !cxa_mqtt_message_pubrel_getPacketId(msgIn, &packetId) )
+	{
+		cxa_logger_warn(&clientIn->logger, "malformed PUBREL");
+		return;
+	}
+	cxa_logger_trace(&clientIn->logger, "got PUBREL for packetId %d", packetId);
+
+	// always complete (even if we don't know about it...we may have already completed it)
+	inboundQos2_remove(clientIn, packetId);
+	sendPublishResponse(clientIn, CXA_MQTT_MSGTYPE_PUBCOMP, packetId);
+	notify_activity(clientIn);
+}
+
+
+static void handleMessage_pubComp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	uint16_t packetId;
+	if( !cxa_mqtt_message_pubcomp_getPacketId(msgIn, &packetId) )
+	{
+		cxa_logger_warn(&clientIn->logger, "malformed PUBCOMP");
+		return;
+	}
+	cxa_logger_trace(&clientIn->logger, "got PUBCOMP for packetId %d", packetId);
+
+	cxa_mqtt_client_inFlightEntry_t* entry = inFlight_getEntry(clientIn, packetId);
+	if( (entry == NULL) || (entry->state != CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP) ) return;
+
+	inFlight_releaseEntry(entry);
+	notify_activity(clientIn);
+}
+
+
+static uint16_t getNextPacketId(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	// packetId 0 is reserved and ids used by in-flight messages must not be reused
+	uint16_t retVal;
+	do
+	{
+		retVal = clientIn->currPacketId++;
+	} while( (retVal == 0) || (inFlight_getEntry(clientIn, retVal) != NULL) );
+
+	return retVal;
+}
+
+
+static cxa_mqtt_client_inFlightEntry_t* inFlight_getEntry(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		cxa_mqtt_client_inFlightEntry_t* currEntry = &clientIn->inFlight[i];
+		if( (currEntry->state != CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE) && (currEntry->packetId == packetIdIn) ) return currEntry;
+	}
+	return NULL;
+}
+
+
+static cxa_mqtt_client_inFlightEntry_t* inFlight_reserveEntry(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	// the window is small...any free slot will do (getNextPacketId skips ids that are still in flight)
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INFLIGHT; i++ )
+	{
+		cxa_mqtt_client_inFlightEntry_t* currEntry = &clientIn->inFlight[i];
+		if( currEntry->state != CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE ) continue;
+
+		currEntry->packetId = getNextPacketId(clientIn);
+		currEntry->msg = NULL;
+		return currEntry;
+	}
+
+	return NULL;
+}
+
+
+static void inFlight_releaseEntry(cxa_mqtt_client_inFlightEntry_t *const entryIn)
+{
+	cxa_assert(entryIn);
+
+	if( entryIn->msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(entryIn->msg);
+	entryIn->msg = NULL;
+	entryIn->state = CXA_MQTT_CLIENT_INFLIGHT_STATE_FREE;
+}
+
+
+static void inFlight_transmitEntry(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inFlightEntry_t *const entryIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(entryIn);
+
+	cxa_timeDiff_setStartTime_now(&entryIn->td_retransmit);
+
+	bool didSend = false;
+	switch( entryIn->state )
+	{
+		case CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK:
+		case CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC:
+			didSend = (entryIn->msg != NULL) && cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(entryIn->msg));
+			break;
+
+		case CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP:
+			didSend = sendPublishResponse(clientIn, CXA_MQTT_MSGTYPE_PUBREL, entryIn->packetId);
+			break;
+
+		default:
+			return;
+	}
+
+	if( !didSend ) cxa_logger_warn(&clientIn->logger, "send failed for packetId %d, will retry", entryIn->packetId);
+}
 
-// taken from: http://git.eclipse.org/c/paho/org.eclipse.paho.mqtt.embedded-c.git/tree/MQTTClient-C/src/MQTTClient.c
-// assume topic filter and name is in correct format
-// # can only be at end
-// + and # can only be next to separator
-// modified to more-fully match specification
-static bool doesTopicMatchFilter(char* topicIn, char* filterIn)
+
+static bool inboundQos2_contains(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
 {
-    char* curf = filterIn;
-    char* curn = topicIn;
-    char* curn_end = curn + strlen(topicIn);
+	cxa_assert(clientIn);
 
-    while (*curf && curn < curn_end)
-    {
-        if (*curn == '/' && *curf != '/')
-            break;
-        if (*curf != '+' && *curf != '#' && *curf != *curn)
-            break;
-        if (*curf == '+')
-        {   // skip until we meet the next separator, or end of string
-            char* nextpos = curn + 1;
-            while (nextpos < curn_end && *nextpos != '/')
-                nextpos = ++curn + 1;
-        }
-        else if (*curf == '#')
-        {
-            curn = curn_end - 1;    // skip until end of string
-        }
-        curf++;
-        curn++;
-    };
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2; i++ )
+	{
+		if( clientIn->inboundQos2PacketIds[i] == packetIdIn ) return true;
+	}
+	return false;
+}
 
-    // special case...look for remaining /# in filter
-    if( *curf == '/' ) curf++;
-    if( *curf == '#' ) curf++;
 
-    return (curn == curn_end) && (*curf == '\0');
+static void inboundQos2_add(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	// prefer an empty slot...otherwise overwrite the oldest
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2; i++ )
+	{
+		if( clientIn->inboundQos2PacketIds[i] == 0 )
+		{
+			clientIn->inboundQos2PacketIds[i] = packetIdIn;
+			return;
+		}
+	}
+
+	cxa_logger_warn(&clientIn->logger, "increase CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2");
+	clientIn->inboundQos2PacketIds[clientIn->inboundQos2NextIndex] = packetIdIn;
+	clientIn->inboundQos2NextIndex = (clientIn->inboundQos2NextIndex + 1) % CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2;
+}
+
+
+static void inboundQos2_remove(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2; i++ )
+	{
+		if( clientIn->inboundQos2PacketIds[i] == packetIdIn ) clientIn->inboundQos2PacketIds[i] = 0;
+	}
+}
+
+
+static bool sendPublishResponse(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_sized(PUBLISHRESPONSE_SIZE_BYTES);
+	if( msg == NULL )
+	{
+		cxa_logger_warn(&clientIn->logger, "failed to reserve message for response");
+		return false;
+	}
+
+	bool didInit = false;
+	switch( typeIn )
+	{
+		case CXA_MQTT_MSGTYPE_PUBACK:
+			didInit = cxa_mqtt_message_puback_init(msg, packetIdIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREC:
+			didInit = cxa_mqtt_message_pubrec_init(msg, packetIdIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREL:
+			didInit = cxa_mqtt_message_pubrel_init(msg, packetIdIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			didInit = cxa_mqtt_message_pubcomp_init(msg, packetIdIn);
+			break;
+
+		default:
+			break;
+	}
+
+	bool retVal = didInit && cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg));
+	cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+	return retVal;
+}
+
+
+static void topicTrieCb_onMatch(void *const valueIn, void *const userVarIn)
+{
+	cxa_mqtt_client_subscriptionEntry_t* subscription = (cxa_mqtt_client_subscriptionEntry_t*)valueIn;
+	cxa_mqtt_client_subscriptionEntry_t** matchesHead = (cxa_mqtt_client_subscriptionEntry_t**)userVarIn;
+	cxa_assert(subscription);
+	cxa_assert(matchesHead);
+
+	subscription->nextMatch = *matchesHead;
+	*matchesHead = subscription;
 }
 
 
@@ -705,3 +1134,53 @@ static void notify_activity(cxa_mqtt_client_t *const clientIn)
 		if( currListener->cb_onActivity != NULL ) currListener->cb_onActivity(clientIn, currListener->userVar);
 	}
 }
+
+
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+static void rxMsgs_retainIfHeld(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	// we hold one reference...anything more is a subscriber keeping the message
+	if( cxa_mqtt_messageFactory_getReferenceCountForMessage(msgIn) <= 1 ) return;
+
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_NUM_RX_MESSAGES; i++ )
+	{
+		if( (clientIn->rxMsgs[i] != msgIn) || clientIn->rxMsgs_isRetained[i] ) continue;
+
+		// the parser moves on to another message until this one is dereferenced
+		clientIn->rxMsgs_isRetained[i] = cxa_protocolParser_retainBuffer(&clientIn->mpp.super, msgIn->buffer);
+		return;
+	}
+}
+
+
+static void cb_onRunLoopUpdate(void* userVarIn)
+{
+	cxa_mqtt_client_t* clientIn = (cxa_mqtt_client_t*)userVarIn;
+	cxa_assert(clientIn);
+
+	// once subscribers are done with a message, we can receive into it again
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_NUM_RX_MESSAGES; i++ )
+	{
+		if( !clientIn->rxMsgs_isRetained[i] || (cxa_mqtt_messageFactory_getReferenceCountForMessage(clientIn->rxMsgs[i]) > 1) ) continue;
+
+		clientIn->rxMsgs_isRetained[i] = false;
+		cxa_protocolParser_releaseBuffer(&clientIn->mpp.super, clientIn->rxMsgs[i]->buffer);
+	}
+}
+
+
+static bool cb_hasPendingWork(void* userVarIn)
+{
+	cxa_mqtt_client_t* clientIn = (cxa_mqtt_client_t*)userVarIn;
+	cxa_assert(clientIn);
+
+	for( size_t i = 0; i < CXA_MQTT_CLIENT_NUM_RX_MESSAGES; i++ )
+	{
+		if( clientIn->rxMsgs_isRetained[i] ) return true;
+	}
+	return false;
+}
+#endif
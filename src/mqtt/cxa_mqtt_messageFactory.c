@@ -9,7 +9,6 @@
 
 // ******** includes ********
 #include <stddef.h>
-#include <cxa_array.h>
 #include <cxa_assert.h>
 
 #define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
@@ -17,30 +16,60 @@
 
 
 // ******** local macro definitions ********
+#define NUM_MESSAGES_TOTAL			(CXA_MQTT_MESSAGEFACTORY_NUM_SMALL_MESSAGES + CXA_MQTT_MESSAGEFACTORY_NUM_MEDIUM_MESSAGES + CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES)
+#define NUM_BUFFER_BYTES_TOTAL		((CXA_MQTT_MESSAGEFACTORY_NUM_SMALL_MESSAGES * CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES) + \
+									 (CXA_MQTT_MESSAGEFACTORY_NUM_MEDIUM_MESSAGES * (CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES + CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES)) + \
+									 (CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES * (CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES + CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES)))
+
+#define NUM_SIZE_CLASSES			3
+#define SIZE_CLASS_LARGE			(NUM_SIZE_CLASSES - 1)
 
 
 // ******** local type definitions ********
-typedef struct
+typedef struct messageEntry messageEntry_t;
+struct messageEntry
 {
+	messageEntry_t* nextFree;
 	uint8_t refCount;
+	uint8_t sizeClass;
 
 	cxa_mqtt_message_t msg;
-
 	cxa_fixedByteBuffer_t msgFbb;
-	uint8_t msgBuffer_raw[CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES];
-}messageEntry_t;
+};
+
+
+typedef struct
+{
+	size_t numMessages;
+	size_t messageSize_bytes;
+	size_t headroom_bytes;
+}sizeClass_t;
 
 
 // ******** local function prototypes ********
 static void initIfNeeded(void);
 static messageEntry_t* getMsgEntryFromMessage(cxa_mqtt_message_t *const msgIn);
+static messageEntry_t* validateEntry(messageEntry_t *const entryIn);
 
 
 // ********  local variable declarations *********
 static bool isInit = false;
 
-static cxa_array_t msgEntries;
-static messageEntry_t msgEntries_raw[CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES];
+// ordered smallest to largest (small messages are never routed, so they don't need headroom)
+static const sizeClass_t sizeClasses[NUM_SIZE_CLASSES] =
+{
+	{ CXA_MQTT_MESSAGEFACTORY_NUM_SMALL_MESSAGES, CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES, 0 },
+	{ CXA_MQTT_MESSAGEFACTORY_NUM_MEDIUM_MESSAGES, CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES, CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES },
+	{ CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES, CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES, CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES }
+};
+
+static messageEntry_t msgEntries[NUM_MESSAGES_TOTAL];
+static uint8_t msgBuffers_raw[NUM_BUFFER_BYTES_TOTAL];
+static messageEntry_t* freeLists[NUM_SIZE_CLASSES];
+
+static size_t numFreeMessages = 0;
+static size_t highWaterMark = 0;
+static size_t numFailedAllocations = 0;
 
 static cxa_logger_t logger;
 
@@ -50,39 +79,48 @@ size_t cxa_mqtt_messageFactory_getNumFreeMessages(void)
 {
 	initIfNeeded();
 
-	size_t numFreeMessages = 0;
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
-	{
-		if( currEntry == NULL ) continue;
-
-		if( currEntry->refCount == 0 ) numFreeMessages++;
-	}
-
 	return numFreeMessages;
 }
 
 
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_empty(void)
+{
+	return cxa_mqtt_messageFactory_getFreeMessage_sized(CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES);
+}
+
+
+cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_sized(size_t minSize_bytesIn)
 {
 	initIfNeeded();
 
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	// find the smallest class that fits (and has a free message)
+	messageEntry_t* newEntry = NULL;
+	for( size_t i = 0; i < NUM_SIZE_CLASSES; i++ )
 	{
-		if( currEntry == NULL) continue;
+		if( (sizeClasses[i].messageSize_bytes < minSize_bytesIn) || (freeLists[i] == NULL) ) continue;
 
-		if( currEntry->refCount == 0 )
-		{
-			currEntry->refCount = 1;
-			cxa_logger_trace(&logger, "message %p newly reserved", &currEntry->msg);
+		newEntry = freeLists[i];
+		freeLists[i] = newEntry->nextFree;
+		break;
+	}
 
-			cxa_fixedByteBuffer_clear(&currEntry->msgFbb);
-			cxa_mqtt_message_initEmpty(&currEntry->msg, &currEntry->msgFbb);
-			return &currEntry->msg;
-		}
+	if( newEntry == NULL )
+	{
+		numFailedAllocations++;
+		cxa_logger_warn(&logger, "no free messages!");
+		return NULL;
 	}
 
-	cxa_logger_warn(&logger, "no free messages!");
-	return NULL;
+	newEntry->nextFree = NULL;
+	newEntry->refCount = 1;
+	numFreeMessages--;
+	size_t numInUse = NUM_MESSAGES_TOTAL - numFreeMessages;
+	if( numInUse > highWaterMark ) highWaterMark = numInUse;
+	cxa_logger_trace(&logger, "message %p newly reserved", &newEntry->msg);
+
+	cxa_fixedByteBuffer_clear(&newEntry->msgFbb);
+	cxa_mqtt_message_initEmpty(&newEntry->msg, &newEntry->msgFbb);
+	return &newEntry->msg;
 }
 
 
@@ -93,15 +131,9 @@ cxa_mqtt_message_t* cxa_mqtt_messageFactory_getMessage_byBuffer(cxa_fixedByteBuf
 	// simple case (better than an assert in this case)
 	if( fbbIn == NULL) return NULL;
 
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
-	{
-		if( currEntry == NULL) continue;
-
-		if( (currEntry->refCount != 0) && (&currEntry->msgFbb == fbbIn) ) return &currEntry->msg;
-	}
-
-	// if we made it here, we couldn't find a match
-	return NULL;
+	// buffers not from our pool are allowed (they just aren't ours)
+	messageEntry_t* targetEntry = validateEntry((messageEntry_t*)((uint8_t*)fbbIn - offsetof(messageEntry_t, msgFbb)));
+	return ((targetEntry != NULL) && (targetEntry->refCount != 0)) ? &targetEntry->msg : NULL;
 }
 
 
@@ -129,6 +161,14 @@ void cxa_mqtt_messageFactory_decrementMessageRefCount(cxa_mqtt_message_t *const
 	{
 		targetEntry->refCount--;
 		cxa_logger_trace(&logger, "message %p dereferenced (%d)", &targetEntry->msg, targetEntry->refCount);
+
+		// return to the free list of its size class
+		if( targetEntry->refCount == 0 )
+		{
+			targetEntry->nextFree = freeLists[targetEntry->sizeClass];
+			freeLists[targetEntry->sizeClass] = targetEntry;
+			numFreeMessages++;
+		}
 	}
 	else cxa_logger_warn(&logger, "mismatched decrement call for %p", &targetEntry->msg);
 }
@@ -145,24 +185,53 @@ uint8_t cxa_mqtt_messageFactory_getReferenceCountForMessage(cxa_mqtt_message_t *
 }
 
 
+size_t cxa_mqtt_messageFactory_getHighWaterMark(void)
+{
+	initIfNeeded();
+
+	return highWaterMark;
+}
+
+
+size_t cxa_mqtt_messageFactory_getNumFailedAllocations(void)
+{
+	initIfNeeded();
+
+	return numFailedAllocations;
+}
+
+
 // ******** local function implementations ********
 static void initIfNeeded(void)
 {
 	if( isInit ) return;
 
+	cxa_assert_msg((CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES > 0), "CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES must be > 0");
+
 	// initialize our logger
 	cxa_logger_init(&logger, "mqttMsgFactory");
 
-	// initialize our messages
-	cxa_array_init_inPlace(&msgEntries, sizeof(*msgEntries_raw), (sizeof(msgEntries_raw)/sizeof(*msgEntries_raw)), (void*)msgEntries_raw, sizeof(msgEntries_raw));
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	// carve our entries and buffers into size classes
+	size_t currEntryIndex = 0;
+	uint8_t* currBuffer = msgBuffers_raw;
+	for( size_t i = 0; i < NUM_SIZE_CLASSES; i++ )
 	{
-		cxa_assert(currEntry);
-		cxa_fixedByteBuffer_initStd(&currEntry->msgFbb, currEntry->msgBuffer_raw);
+		freeLists[i] = NULL;
+		for( size_t j = 0; j < sizeClasses[i].numMessages; j++ )
+		{
+			messageEntry_t* currEntry = &msgEntries[currEntryIndex++];
 
-		currEntry->refCount = 0;
-	}
+			size_t entrySize_bytes = sizeClasses[i].headroom_bytes + sizeClasses[i].messageSize_bytes;
+			cxa_fixedByteBuffer_init_withHeadroom(&currEntry->msgFbb, currBuffer, entrySize_bytes, sizeClasses[i].headroom_bytes);
+			currBuffer += entrySize_bytes;
 
+			currEntry->refCount = 0;
+			currEntry->sizeClass = i;
+			currEntry->nextFree = freeLists[i];
+			freeLists[i] = currEntry;
+		}
+	}
+	numFreeMessages = NUM_MESSAGES_TOTAL;
 
 	isInit = true;
 }
@@ -170,12 +239,17 @@ static void initIfNeeded(void)
 
 static messageEntry_t* getMsgEntryFromMessage(cxa_mqtt_message_t *const msgIn)
 {
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
-	{
-		if( currEntry == NULL ) continue;
+	if( msgIn == NULL ) return NULL;
 
-		if( &currEntry->msg == msgIn ) return currEntry;
-	}
+	return validateEntry((messageEntry_t*)((uint8_t*)msgIn - offsetof(messageEntry_t, msg)));
+}
+
+
+static messageEntry_t* validateEntry(messageEntry_t *const entryIn)
+{
+	// make sure this actually points to one of our entries
+	uintptr_t offset = (uintptr_t)entryIn - (uintptr_t)msgEntries;
+	if( ((uintptr_t)entryIn < (uintptr_t)msgEntries) || (offset >= sizeof(msgEntries)) || ((offset % sizeof(*msgEntries)) != 0) ) return NULL;
 
-	return NULL;
+	return entryIn;
 }
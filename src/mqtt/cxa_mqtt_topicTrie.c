@@ -0,0 +1,256 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_topicTrie.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+#define NODE_NONE					-1
+#define ROOT_NODE					0
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static int16_t getChild(cxa_mqtt_topicTrie_t *const trieIn, int16_t parentIn, const char *const levelIn, size_t levelLen_bytesIn);
+static int16_t getOrAddChild(cxa_mqtt_topicTrie_t *const trieIn, int16_t parentIn, const char *const levelIn, size_t levelLen_bytesIn);
+static int16_t addNode(cxa_mqtt_topicTrie_t *const trieIn, const char *const levelIn, size_t levelLen_bytesIn);
+static size_t matchFrom(cxa_mqtt_topicTrie_t *const trieIn, int16_t nodeIn, const char* levelIn, const char *const topicEndIn, bool isFirstLevelIn, bool isSysTopicIn,
+						cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn);
+static size_t notifyValues(cxa_mqtt_topicTrie_t *const trieIn, int16_t nodeIn, cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_mqtt_topicTrie_init(cxa_mqtt_topicTrie_t *const trieIn,
+							 cxa_mqtt_topicTrie_node_t *const nodesIn, size_t maxNumNodesIn,
+							 cxa_mqtt_topicTrie_value_t *const valuesIn, size_t maxNumValuesIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert(nodesIn);
+	cxa_assert(maxNumNodesIn > 0);
+	cxa_assert(maxNumNodesIn <= INT16_MAX);
+	cxa_assert(valuesIn || (maxNumValuesIn == 0));
+	cxa_assert(maxNumValuesIn <= INT16_MAX);
+
+	// save our references
+	trieIn->nodes = nodesIn;
+	trieIn->maxNumNodes = maxNumNodesIn;
+	trieIn->values = valuesIn;
+	trieIn->maxNumValues = maxNumValuesIn;
+
+	cxa_mqtt_topicTrie_clear(trieIn);
+}
+
+
+void cxa_mqtt_topicTrie_clear(cxa_mqtt_topicTrie_t *const trieIn)
+{
+	cxa_assert(trieIn);
+
+	trieIn->numNodes = 0;
+	trieIn->numValues = 0;
+
+	// the root node doesn't represent a level (it's the parent of the first level)
+	addNode(trieIn, NULL, 0);
+}
+
+
+bool cxa_mqtt_topicTrie_add(cxa_mqtt_topicTrie_t *const trieIn, const char *const filterIn, void *const valueIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert(filterIn);
+
+	size_t filterLen_bytes = strlen(filterIn);
+	if( filterLen_bytes == 0 ) return false;
+
+	// validate first so we don't leave a partial path for a malformed filter
+	const char* filterEnd = filterIn + filterLen_bytes;
+	for( const char* currLevel = filterIn; currLevel <= filterEnd; )
+	{
+		const char* levelEnd = memchr(currLevel, '/', filterEnd - currLevel);
+		if( levelEnd == NULL ) levelEnd = filterEnd;
+		size_t levelLen_bytes = levelEnd - currLevel;
+
+		// wildcards must occupy an entire level...and '#' must be the last level
+		if( (levelLen_bytes > 1) && ((memchr(currLevel, '+', levelLen_bytes) != NULL) || (memchr(currLevel, '#', levelLen_bytes) != NULL)) ) return false;
+		if( (levelLen_bytes == 1) && (*currLevel == '#') && (levelEnd != filterEnd) ) return false;
+
+		currLevel = levelEnd + 1;
+	}
+
+	// make sure we have room for the whole path (and value) so we don't leave a partial path when full
+	size_t numNewNodes = 0;
+	int16_t currNode = ROOT_NODE;
+	for( const char* currLevel = filterIn; currLevel <= filterEnd; )
+	{
+		const char* levelEnd = memchr(currLevel, '/', filterEnd - currLevel);
+		if( levelEnd == NULL ) levelEnd = filterEnd;
+
+		if( currNode != NODE_NONE ) currNode = getChild(trieIn, currNode, currLevel, levelEnd - currLevel);
+		if( currNode == NODE_NONE ) numNewNodes++;
+		currLevel = levelEnd + 1;
+	}
+	if( ((trieIn->numNodes + numNewNodes) > trieIn->maxNumNodes) || (trieIn->numValues >= trieIn->maxNumValues) ) return false;
+
+	// now walk/build our path
+	currNode = ROOT_NODE;
+	for( const char* currLevel = filterIn; currLevel <= filterEnd; )
+	{
+		const char* levelEnd = memchr(currLevel, '/', filterEnd - currLevel);
+		if( levelEnd == NULL ) levelEnd = filterEnd;
+
+		currNode = getOrAddChild(trieIn, currNode, currLevel, levelEnd - currLevel);
+		currLevel = levelEnd + 1;
+	}
+
+	// add our value to the terminal node
+	int16_t newValue = (int16_t)trieIn->numValues++;
+	trieIn->values[newValue].value = valueIn;
+	trieIn->values[newValue].next = NODE_NONE;
+
+	// append (so values are notified in the order they were added)
+	int16_t* nextPtr = &trieIn->nodes[currNode].firstValue;
+	while( *nextPtr != NODE_NONE ) nextPtr = &trieIn->values[*nextPtr].next;
+	*nextPtr = newValue;
+
+	return true;
+}
+
+
+size_t cxa_mqtt_topicTrie_match(cxa_mqtt_topicTrie_t *const trieIn, const char *const topicIn, size_t topicLen_bytesIn,
+								cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert(topicIn || (topicLen_bytesIn == 0));
+
+	// topic names must be at least one character
+	if( topicLen_bytesIn == 0 ) return 0;
+
+	bool isSysTopic = (topicIn[0] == '$');
+	return matchFrom(trieIn, ROOT_NODE, topicIn, topicIn + topicLen_bytesIn, true, isSysTopic, cbIn, userVarIn);
+}
+
+
+// ******** local function implementations ********
+static int16_t getChild(cxa_mqtt_topicTrie_t *const trieIn, int16_t parentIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	cxa_assert(trieIn);
+
+	cxa_mqtt_topicTrie_node_t* parent = &trieIn->nodes[parentIn];
+
+	// wildcards get their own slots so matching doesn't have to search for them
+	if( (levelLen_bytesIn == 1) && (*levelIn == '+') ) return parent->plusChild;
+	if( (levelLen_bytesIn == 1) && (*levelIn == '#') ) return parent->hashChild;
+
+	for( int16_t currChild = parent->firstChild; currChild != NODE_NONE; currChild = trieIn->nodes[currChild].nextSibling )
+	{
+		cxa_mqtt_topicTrie_node_t* child = &trieIn->nodes[currChild];
+		if( (child->levelLen_bytes == levelLen_bytesIn) && (memcmp(child->level, levelIn, levelLen_bytesIn) == 0) ) return currChild;
+	}
+	return NODE_NONE;
+}
+
+
+static int16_t getOrAddChild(cxa_mqtt_topicTrie_t *const trieIn, int16_t parentIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	cxa_assert(trieIn);
+
+	// see if we already have this level
+	int16_t retVal = getChild(trieIn, parentIn, levelIn, levelLen_bytesIn);
+	if( retVal != NODE_NONE ) return retVal;
+
+	// if we made it here, we need a new child
+	retVal = addNode(trieIn, levelIn, levelLen_bytesIn);
+	cxa_mqtt_topicTrie_node_t* parent = &trieIn->nodes[parentIn];
+	if( (levelLen_bytesIn == 1) && (*levelIn == '+') ) parent->plusChild = retVal;
+	else if( (levelLen_bytesIn == 1) && (*levelIn == '#') ) parent->hashChild = retVal;
+	else
+	{
+		trieIn->nodes[retVal].nextSibling = parent->firstChild;
+		parent->firstChild = retVal;
+	}
+	return retVal;
+}
+
+
+static int16_t addNode(cxa_mqtt_topicTrie_t *const trieIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert_msg((trieIn->numNodes < trieIn->maxNumNodes), "increase topicTrie nodes");
+	cxa_assert(levelLen_bytesIn <= UINT16_MAX);
+
+	int16_t retVal = (int16_t)trieIn->numNodes++;
+	cxa_mqtt_topicTrie_node_t* newNode = &trieIn->nodes[retVal];
+
+	newNode->level = levelIn;
+	newNode->levelLen_bytes = (uint16_t)levelLen_bytesIn;
+	newNode->firstChild = NODE_NONE;
+	newNode->nextSibling = NODE_NONE;
+	newNode->plusChild = NODE_NONE;
+	newNode->hashChild = NODE_NONE;
+	newNode->firstValue = NODE_NONE;
+
+	return retVal;
+}
+
+
+static size_t matchFrom(cxa_mqtt_topicTrie_t *const trieIn, int16_t nodeIn, const char* levelIn, const char *const topicEndIn, bool isFirstLevelIn, bool isSysTopicIn,
+						cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn)
+{
+	cxa_mqtt_topicTrie_node_t* node = &trieIn->nodes[nodeIn];
+	size_t retVal = 0;
+
+	// wildcards at the first level don't match '$' topics
+	bool canMatchWildcard = !(isFirstLevelIn && isSysTopicIn);
+
+	// '#' matches this level (and the parent level...ie. "a/#" matches "a")
+	if( canMatchWildcard && (node->hashChild != NODE_NONE) ) retVal += notifyValues(trieIn, node->hashChild, cbIn, userVarIn);
+
+	// if we've consumed all of our levels, this node is a match
+	if( levelIn == NULL ) return retVal + notifyValues(trieIn, nodeIn, cbIn, userVarIn);
+
+	// figure out where this level ends (and the next starts)
+	const char* levelEnd = memchr(levelIn, '/', topicEndIn - levelIn);
+	if( levelEnd == NULL ) levelEnd = topicEndIn;
+	const char* nextLevel = (levelEnd < topicEndIn) ? levelEnd + 1 : NULL;
+	size_t levelLen_bytes = levelEnd - levelIn;
+
+	// exact match
+	for( int16_t currChild = node->firstChild; currChild != NODE_NONE; currChild = trieIn->nodes[currChild].nextSibling )
+	{
+		cxa_mqtt_topicTrie_node_t* child = &trieIn->nodes[currChild];
+		if( (child->levelLen_bytes == levelLen_bytes) && (memcmp(child->level, levelIn, levelLen_bytes) == 0) )
+		{
+			retVal += matchFrom(trieIn, currChild, nextLevel, topicEndIn, false, isSysTopicIn, cbIn, userVarIn);
+			break;
+		}
+	}
+
+	// single-level wildcard
+	if( canMatchWildcard && (node->plusChild != NODE_NONE) ) retVal += matchFrom(trieIn, node->plusChild, nextLevel, topicEndIn, false, isSysTopicIn, cbIn, userVarIn);
+
+	return retVal;
+}
+
+
+static size_t notifyValues(cxa_mqtt_topicTrie_t *const trieIn, int16_t nodeIn, cxa_mqtt_topicTrie_cb_onMatch_t cbIn, void *const userVarIn)
+{
+	size_t retVal = 0;
+	for( int16_t currValue = trieIn->nodes[nodeIn].firstValue; currValue != NODE_NONE; currValue = trieIn->values[currValue].next )
+	{
+		if( cbIn != NULL ) cbIn(trieIn->values[currValue].value, userVarIn);
+		retVal++;
+	}
+	return retVal;
+}
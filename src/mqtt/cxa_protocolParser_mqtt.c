@@ -25,6 +25,9 @@
 #define ERR_MALFORMED_HEADER		"malformed header"
 #define ERR_INTERBYTE_TIMEOUT		"inter-byte timeout"
 
+// fixedHeader -> remainingLen -> dataBytes -> processPacket -> fixedHeader: one packet per iteration
+#define MAXNUM_TRANSITIONS_PER_UPDATE		4
+
 
 // ******** local type definitions ********
 typedef enum
@@ -79,6 +82,7 @@ void cxa_protocolParser_mqtt_init(cxa_protocolParser_mqtt_t *const mppIn, cxa_io
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_PROCESS_PACKET, "processPacket", rxStateCb_processPacket_enter, NULL, NULL, (void*)mppIn);
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_ERROR, "error", rxState_cb_error_enter, NULL, NULL, (void*)mppIn);
 	cxa_stateMachine_setInitialState(&mppIn->stateMachine, RX_STATE_IDLE);
+	cxa_stateMachine_setRunToCompletion(&mppIn->stateMachine, MAXNUM_TRANSITIONS_PER_UPDATE);
 }
 
 
@@ -177,10 +181,21 @@ static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, voi
 	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
 	cxa_assert(mppIn);
 
-	uint8_t rxByte;
-	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte);
-	if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&mppIn->super, &rxBytes, &numRxBytes);
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
 	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
+		return;
+	}
+
+	// skip through the chunk until we find a valid header byte
+	for( size_t i = 0; i < numRxBytes; i++ )
+	{
+		uint8_t rxByte = rxBytes[i];
+		cxa_protocolParser_consumeRxBytes(&mppIn->super, 1);
+
 		bool doFlagsMatch = false;
 		switch( cxa_mqtt_message_rxBytes_getType(rxByte) )
 		{
@@ -189,11 +204,15 @@ static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, voi
 			case CXA_MQTT_MSGTYPE_PINGREQ:
 			case CXA_MQTT_MSGTYPE_PINGRESP:
 			case CXA_MQTT_MSGTYPE_SUBACK:
+			case CXA_MQTT_MSGTYPE_PUBACK:
+			case CXA_MQTT_MSGTYPE_PUBREC:
+			case CXA_MQTT_MSGTYPE_PUBCOMP:
 				// make sure the flags match
 				doFlagsMatch = (rxByte & 0x0F) == 0;
 				break;
 
 			case CXA_MQTT_MSGTYPE_SUBSCRIBE:
+			case CXA_MQTT_MSGTYPE_PUBREL:
 				// make sure the flags match
 				doFlagsMatch = (rxByte & 0x0F) == 0x02;
 				break;
@@ -205,7 +224,7 @@ static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, voi
 
 			default:
 				cxa_logger_warn(&mppIn->super.logger, "unknown header byte: 0x%02X", rxByte);
-				return;
+				continue;
 		}
 
 		// if we made it here, we at least know what kind of packet this is...
@@ -225,11 +244,6 @@ static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, voi
 			else cxa_logger_warn(&mppIn->super.logger, ERR_FBB_OVERFLOW);
 		} else cxa_logger_warn(&mppIn->super.logger, ERR_MALFORMED_HEADER);
 	}
-	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
-	{
-		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
-		return;
-	}
 }
 
 
@@ -238,37 +252,44 @@ static void rxStateCb_waitRemainingLen_state(cxa_stateMachine_t *const smIn, voi
 	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
 	cxa_assert(mppIn);
 
-	uint8_t rxByte;
-	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte);
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&mppIn->super, &rxBytes, &numRxBytes);
 	if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
 	{
 		// reset our reception timeout timeDiff
 		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
 
-		// add to our buffer
-		if( !cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxByte) )
+		// the length field is at most 4 bytes...consume until it's complete
+		for( size_t i = 0; i < numRxBytes; i++ )
 		{
-			cxa_logger_warn(&mppIn->super.logger, ERR_FBB_OVERFLOW);
-			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
-			return;
-		}
+			cxa_protocolParser_consumeRxBytes(&mppIn->super, 1);
 
-		// process our variable length field (or the fraction we currently have)
-		bool isVarLengthComplete;
-		size_t actualLength;
-		if( !cxa_mqtt_message_rxBytes_parseVariableLengthField(mppIn->super.currBuffer, &isVarLengthComplete, &actualLength, NULL) )
-		{
-			cxa_logger_warn(&mppIn->super.logger, ERR_MALFORMED_HEADER);
-			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
-			return;
-		}
+			// add to our buffer
+			if( !cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxBytes[i]) )
+			{
+				cxa_logger_warn(&mppIn->super.logger, ERR_FBB_OVERFLOW);
+				cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+				return;
+			}
 
-		if( isVarLengthComplete )
-		{
-			mppIn->remainingBytesToReceive = actualLength;
-			cxa_logger_trace(&mppIn->super.logger, "waiting for %d bytes", mppIn->remainingBytesToReceive);
-			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_DATABYTES);
-			return;
+			// process our variable length field (or the fraction we currently have)
+			bool isVarLengthComplete;
+			size_t actualLength;
+			if( !cxa_mqtt_message_rxBytes_parseVariableLengthField(mppIn->super.currBuffer, &isVarLengthComplete, &actualLength, NULL) )
+			{
+				cxa_logger_warn(&mppIn->super.logger, ERR_MALFORMED_HEADER);
+				cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+				return;
+			}
+
+			if( isVarLengthComplete )
+			{
+				mppIn->remainingBytesToReceive = actualLength;
+				cxa_logger_trace(&mppIn->super.logger, "waiting for %d bytes", mppIn->remainingBytesToReceive);
+				cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_DATABYTES);
+				return;
+			}
 		}
 	}
 	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
@@ -299,24 +320,33 @@ static void rxStateCb_waitDataBytes_state(cxa_stateMachine_t *const smIn, void *
 		return;
 	}
 
-	// keep receiving bytes
-	uint8_t rxByte;
-	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte);
-	if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+	// keep receiving bytes (chunk by chunk, until we have them all or the ioStream runs dry)
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat;
+	while( (readStat = cxa_protocolParser_peekRxBytes(&mppIn->super, &rxBytes, &numRxBytes)) == CXA_IOSTREAM_READSTAT_GOTDATA )
 	{
 		// reset our reception timeout timeDiff
 		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
 
 		// add to our buffer
-		if( !cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxByte) )
+		if( numRxBytes > mppIn->remainingBytesToReceive ) numRxBytes = mppIn->remainingBytesToReceive;
+		if( !cxa_fixedByteBuffer_append(mppIn->super.currBuffer, rxBytes, numRxBytes) )
 		{
 			cxa_logger_warn(&mppIn->super.logger, ERR_FBB_OVERFLOW);
 			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
 			return;
 		}
-		mppIn->remainingBytesToReceive--;
+		cxa_protocolParser_consumeRxBytes(&mppIn->super, numRxBytes);
+		mppIn->remainingBytesToReceive -= numRxBytes;
+
+		if( mppIn->remainingBytesToReceive == 0 )
+		{
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_PROCESS_PACKET);
+			return;
+		}
 	}
-	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
 	{
 		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
 		return;
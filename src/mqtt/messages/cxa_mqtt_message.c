@@ -16,6 +16,10 @@
 #include <cxa_mqtt_message_suback.h>
 #include <cxa_mqtt_message_subscribe.h>
 #include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_puback.h>
+#include <cxa_mqtt_message_pubrec.h>
+#include <cxa_mqtt_message_pubrel.h>
+#include <cxa_mqtt_message_pubcomp.h>
 
 #define CXA_LOG_LEVEL				CXA_LOG_LEVEL_TRACE
 #include <cxa_logger_implementation.h>
@@ -101,6 +105,22 @@ bool cxa_mqtt_message_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 			didMsgValidate = cxa_mqtt_message_publish_validateReceivedBytes(msgIn);
 			break;
 
+		case CXA_MQTT_MSGTYPE_PUBACK:
+			didMsgValidate = cxa_mqtt_message_puback_validateReceivedBytes(msgIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREC:
+			didMsgValidate = cxa_mqtt_message_pubrec_validateReceivedBytes(msgIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREL:
+			didMsgValidate = cxa_mqtt_message_pubrel_validateReceivedBytes(msgIn);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			didMsgValidate = cxa_mqtt_message_pubcomp_validateReceivedBytes(msgIn);
+			break;
+
 		case CXA_MQTT_MSGTYPE_SUBSCRIBE:
 			didMsgValidate = cxa_mqtt_message_subscribe_validateReceivedBytes(msgIn);
 			break;
@@ -133,6 +153,10 @@ cxa_mqtt_message_type_t cxa_mqtt_message_rxBytes_getType(uint8_t headerByteIn)
 	if( (type_raw != CXA_MQTT_MSGTYPE_CONNECT) &&
 			(type_raw != CXA_MQTT_MSGTYPE_CONNACK) &&
 			(type_raw != CXA_MQTT_MSGTYPE_PUBLISH) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBACK) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBREC) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBREL) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBCOMP) &&
 			(type_raw != CXA_MQTT_MSGTYPE_SUBSCRIBE) &&
 			(type_raw != CXA_MQTT_MSGTYPE_SUBACK) &&
 			(type_raw != CXA_MQTT_MSGTYPE_PINGREQ) &&
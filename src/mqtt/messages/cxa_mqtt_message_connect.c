@@ -46,9 +46,10 @@ bool cxa_mqtt_message_connect_init(cxa_mqtt_message_t *const msgIn, char* client
 	size_t cidLen_bytes = strlen(clientIdIn);
 	cxa_assert( (cidLen_bytes >= 1) && (cidLen_bytes <= 23) );
 
-	// fixed header 1
+	// fixed header 1 (all fields are appended in order...no need to shift anything)
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
 			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, (CXA_MQTT_MSGTYPE_CONNECT << 4) ) ) return false;
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, true);
 
 	// remaining length
 	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
@@ -105,6 +106,7 @@ bool cxa_mqtt_message_connect_init(cxa_mqtt_message_t *const msgIn, char* client
 		prevField = &msgIn->fields_connect.field_password;
 	}
 
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, false);
 	msgIn->areFieldsConfigured = true;
 	return true;
 }
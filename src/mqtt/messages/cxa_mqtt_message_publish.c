@@ -33,9 +33,10 @@ bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn,
 	cxa_assert(topicNameIn);
 	if( payloadSize_bytesIn > 0 ) cxa_assert(payloadIn);
 
-	// fixed header 1
+	// fixed header 1 (all fields are appended in order...no need to shift anything)
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
 			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, ((CXA_MQTT_MSGTYPE_PUBLISH << 4) | (dupIn << 3) | (qosIn << 1) | retainIn)) ) return false;
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, true);
 
 	// remaining length
 	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
@@ -48,7 +49,7 @@ bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn,
 	// packet identifier (if higher-level QOS)
 	if( qosIn != CXA_MQTT_QOS_ATMOST_ONCE )
 	{
-		if( !cxa_linkedField_initRoot_fixedLen(&msgIn->fields_publish.field_packetId, msgIn->buffer, 0, 2) ||
+		if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publish.field_packetId, prevField, 2) ||
 					!cxa_linkedField_append_uint16BE(&msgIn->fields_publish.field_packetId, packedIdIn) ) return false;
 		prevField = &msgIn->fields_publish.field_packetId;
 	}
@@ -57,6 +58,7 @@ bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn,
 	if( !cxa_linkedField_initChild(&msgIn->fields_publish.field_payload, prevField, 0) ) return false;
 	if( (payloadIn != NULL) && !cxa_linkedField_append(&msgIn->fields_publish.field_payload, payloadIn, payloadSize_bytesIn) ) return false;
 
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, false);
 	msgIn->areFieldsConfigured = true;
 	return true;
 }
@@ -72,6 +74,63 @@ bool cxa_mqtt_message_publish_getTopicName(cxa_mqtt_message_t *const msgIn, char
 }
 
 
+bool cxa_mqtt_message_publish_getQos(cxa_mqtt_message_t *const msgIn, cxa_mqtt_qosLevel_t *const qosOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
+
+	uint8_t packetTypeAndFlags;
+	if( !cxa_linkedField_get_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags) ) return false;
+
+	if( qosOut != NULL ) *qosOut = (cxa_mqtt_qosLevel_t)((packetTypeAndFlags >> 1) & 0x03);
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_publish_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut)
+{
+	cxa_assert(msgIn);
+
+	// QOS0 messages don't have a packet id
+	cxa_mqtt_qosLevel_t qos;
+	if( !cxa_mqtt_message_publish_getQos(msgIn, &qos) || (qos == CXA_MQTT_QOS_ATMOST_ONCE) ) return false;
+
+	uint16_t packetId_lcl;
+	if( !cxa_linkedField_get_uint16BE(&msgIn->fields_publish.field_packetId, 0, packetId_lcl) ) return false;
+
+	if( packetIdOut != NULL ) *packetIdOut = packetId_lcl;
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_publish_setPacketId(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn)
+{
+	cxa_assert(msgIn);
+
+	cxa_mqtt_qosLevel_t qos;
+	if( !cxa_mqtt_message_publish_getQos(msgIn, &qos) || (qos == CXA_MQTT_QOS_ATMOST_ONCE) ) return false;
+
+	return cxa_linkedField_replace_uint16BE(&msgIn->fields_publish.field_packetId, 0, packetIdIn);
+}
+
+
+bool cxa_mqtt_message_publish_setDup(cxa_mqtt_message_t *const msgIn, bool dupIn)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
+
+	uint8_t packetTypeAndFlags;
+	if( !cxa_linkedField_get_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags) ) return false;
+
+	packetTypeAndFlags = dupIn ? (packetTypeAndFlags | 0x08) : (packetTypeAndFlags & ~0x08);
+	return cxa_linkedField_replace_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags);
+}
+
+
 bool cxa_mqtt_message_publish_getPayload(cxa_mqtt_message_t *const msgIn, cxa_linkedField_t **payloadLfOut)
 {
 	cxa_assert(msgIn);
@@ -0,0 +1,75 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_message_pubrel.h"
+
+
+// ******** includes ********
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+bool cxa_mqtt_message_pubrel_init(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn)
+{
+	cxa_assert(msgIn);
+
+	// fixed header 1
+	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
+			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, ((CXA_MQTT_MSGTYPE_PUBREL << 4) | 0x02)) ) return false;
+
+	// remaining length
+	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
+
+	// packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publishResponse.field_packetId, &msgIn->field_remainingLength, 2) ||
+			!cxa_linkedField_append_uint16BE(&msgIn->fields_publishResponse.field_packetId, packetIdIn) ) return false;
+
+	msgIn->areFieldsConfigured = true;
+	return true;
+}
+
+
+bool cxa_mqtt_message_pubrel_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBREL) ) return false;
+
+	uint16_t packetId_lcl;
+	if( !cxa_linkedField_get_uint16BE(&msgIn->fields_publishResponse.field_packetId, 0, packetId_lcl) ) return false;
+
+	if( packetIdOut != NULL ) *packetIdOut = packetId_lcl;
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_pubrel_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	// packet id (and nothing else)
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publishResponse.field_packetId, &msgIn->field_remainingLength, 2) ||
+			(cxa_linkedField_getSize_bytes(&msgIn->fields_publishResponse.field_packetId) != 2) ||
+			(cxa_linkedField_getStartIndexOfNextField(&msgIn->fields_publishResponse.field_packetId) != cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer)) ) return false;
+
+	return true;
+}
+
+
+// ******** local function implementations ********
@@ -35,9 +35,10 @@ bool cxa_mqtt_message_subscribe_init(cxa_mqtt_message_t *const msgIn, uint16_t p
 	cxa_assert(msgIn);
 	cxa_assert(topicFilterIn)
 
-	// fixed header 1
+	// fixed header 1 (all fields are appended in order...no need to shift anything)
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
 			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, ((CXA_MQTT_MSGTYPE_SUBSCRIBE << 4) | 0x02)) ) return false;
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, true);
 
 	// remaining length
 	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
@@ -54,6 +55,7 @@ bool cxa_mqtt_message_subscribe_init(cxa_mqtt_message_t *const msgIn, uint16_t p
 	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_qos, &msgIn->fields_subscribe.field_topicFilter, 1) ||
 			!cxa_linkedField_append_uint8(&msgIn->fields_subscribe.field_qos, qosLevelIn) ) return false;
 
+	cxa_linkedField_setBuilderMode(&msgIn->field_packetTypeAndFlags, false);
 	msgIn->areFieldsConfigured = true;
 	return true;
 }
@@ -63,10 +65,13 @@ bool cxa_mqtt_message_subscribe_validateReceivedBytes(cxa_mqtt_message_t *const
 {
 	cxa_assert(msgIn);
 
-	// first up is the topic filter
+	// first up is the packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_packetId, &msgIn->field_remainingLength, 2) ) return false;
+
+	// then the topic filter
 	uint16_t numBytesInTopicFilter;
-	if( !cxa_fixedByteBuffer_get_lengthPrefixedCString_uint16BE(msgIn->buffer, cxa_linkedField_getStartIndexOfNextField(&msgIn->field_remainingLength), NULL, &numBytesInTopicFilter, NULL) ||
-			!cxa_linkedField_initChild(&msgIn->fields_subscribe.field_topicFilter, &msgIn->field_remainingLength, numBytesInTopicFilter+2) ) return false;
+	if( !cxa_fixedByteBuffer_get_lengthPrefixedCString_uint16BE(msgIn->buffer, cxa_linkedField_getStartIndexOfNextField(&msgIn->fields_subscribe.field_packetId), NULL, &numBytesInTopicFilter, NULL) ||
+			!cxa_linkedField_initChild(&msgIn->fields_subscribe.field_topicFilter, &msgIn->fields_subscribe.field_packetId, numBytesInTopicFilter+2) ) return false;
 
 	// next is the qos
 	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_qos, &msgIn->fields_subscribe.field_topicFilter, 1) ) return false;
@@ -8,12 +8,14 @@
 
 
 // ******** includes ********
+#include <ctype.h>
 #include <string.h>
 #include <cxa_assert.h>
 #include <cxa_mqtt_messageFactory.h>
 #include <cxa_mqtt_message_publish.h>
 #include <cxa_mqtt_rpc_message.h>
 #include <cxa_mqtt_rpc_node_root.h>
+#include <cxa_numberUtils.h>
 #include <cxa_runLoop.h>
 #include <cxa_stringUtils.h>
 
@@ -22,7 +24,11 @@
 
 
 // ******** local macro definitions ********
-#define REQUEST_TIMEOUT_MS			3000
+#define INVALID_INDEX				UINT16_MAX
+#define REQUEST_ID_LEN_BYTES		4
+
+// request ids are sequential, so a simple modulo spreads them evenly
+#define NUM_HASH_BUCKETS			CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS
 
 
 // ******** local type definitions ********
@@ -42,8 +48,29 @@ static void sendResponse(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_methodR
 
 static bool addNodePathToTopic(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_message_t *const msgIn);
 
+static void inFlight_init(void);
+static uint16_t inFlight_getNextRequestId(void);
+static uint16_t inFlight_find(uint16_t idIn);
+static bool inFlight_add(cxa_mqtt_rpc_node_t *const nodeIn, uint16_t idIn, char *const methodNameIn, char *const pathToNodeIn,
+						 uint32_t timeout_msIn, cxa_mqtt_rpc_cb_methodResponse_t cbIn, void* userVarIn);
+static void inFlight_remove(uint16_t indexIn);
+static uint32_t inFlight_getRemainingTime_ms(uint16_t indexIn);
+static bool inFlight_handleResponse(cxa_mqtt_message_t *const msgIn);
+static void inFlight_checkTimeouts(void);
+static bool parseRequestId(const char *const idIn, size_t idLen_bytesIn, uint16_t *const idOut);
+static uint16_t getPathCrc(char *const pathIn, size_t pathLen_bytesIn);
+
 
 // ********  local variable declarations *********
+// outstanding requests from all nodes, hashed by request id and
+// linked in order of their deadline (so only the head must be checked)
+static bool isInFlightInit = false;
+static uint16_t currRequestId = 0;
+static cxa_mqtt_rpc_node_outstandingRequest_t inFlightRequests[CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS];
+static uint16_t inFlightBuckets[NUM_HASH_BUCKETS];
+static uint16_t inFlightFreeHead;
+static uint16_t inFlightDeadlineHead;
+static uint16_t inFlightDeadlineTail;
 
 
 // ******** global function implementations ********
@@ -94,10 +121,23 @@ void cxa_mqtt_rpc_node_vinit2(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_no
 	cxa_assert(vsnprintf(nodeIn->name, CXA_MQTT_RPCNODE_MAXLEN_NAME_BYTES, nameFmtIn, varArgsIn) < CXA_MQTT_RPCNODE_MAXLEN_NAME_BYTES);
 	nodeIn->name[CXA_MQTT_RPCNODE_MAXLEN_NAME_BYTES-1] = 0;
 
+	// cache our path (our parent is already initialized)
+	if( nodeIn->parentNode == NULL )
+	{
+		cxa_assert(snprintf(nodeIn->path, CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES, "%s", nodeIn->name) < CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES);
+		nodeIn->localPathStartIndex = strlen(nodeIn->path);
+	}
+	else
+	{
+		cxa_assert(snprintf(nodeIn->path, CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES, "%s/%s", nodeIn->parentNode->path, nodeIn->name) < CXA_MQTT_RPCNODE_MAXLEN_PATH_BYTES);
+		nodeIn->localPathStartIndex = (nodeIn->parentNode->parentNode == NULL) ? (nodeIn->parentNode->pathLen_bytes + 1) : nodeIn->parentNode->localPathStartIndex;
+	}
+	nodeIn->pathLen_bytes = strlen(nodeIn->path);
+
 	// setup our subnodes, methods, outstanding requests
 	cxa_array_initStd(&nodeIn->subNodes, nodeIn->subNodes_raw);
 	cxa_array_initStd(&nodeIn->methods, nodeIn->methods_raw);
-	cxa_array_initStd(&nodeIn->outstandingRequests, nodeIn->outstandingRequests_raw);
+	if( !isInFlightInit ) inFlight_init();
 
 	// setup our logger
 	cxa_logger_init_formattedString(&nodeIn->logger, "mRpcNode_%s", nodeIn->name);
@@ -108,7 +148,7 @@ void cxa_mqtt_rpc_node_vinit2(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_rpc_no
 	// register for run loop execution
 	cxa_mqtt_client_t* mqttClient = cxa_mqtt_rpc_node_getClient(nodeIn);
 	cxa_assert(mqttClient);
-	cxa_runLoop_addEntry(cxa_mqtt_client_getThreadId(mqttClient), NULL, cb_onRunLoopUpdate, (void*)nodeIn);
+	cxa_runLoop_addEntry_named(cxa_mqtt_client_getThreadId(mqttClient), nodeIn->name, NULL, cb_onRunLoopUpdate, (void*)nodeIn);
 }
 
 
@@ -130,12 +170,21 @@ void cxa_mqtt_rpc_node_addMethod(cxa_mqtt_rpc_node_t *const nodeIn, char *const
 bool cxa_mqtt_rpc_node_executeMethod(cxa_mqtt_rpc_node_t *const nodeIn,
 									 char *const methodNameIn, char *const pathToNodeIn, cxa_fixedByteBuffer_t *const paramsIn,
 									 cxa_mqtt_rpc_cb_methodResponse_t responseCbIn, void* userVarIn)
+{
+	return cxa_mqtt_rpc_node_executeMethod_withTimeout(nodeIn, methodNameIn, pathToNodeIn, paramsIn,
+													   CXA_MQTT_RPCNODE_REQUEST_TIMEOUT_MS, responseCbIn, userVarIn,
+													   NULL);
+}
+
+
+bool cxa_mqtt_rpc_node_executeMethod_withTimeout(cxa_mqtt_rpc_node_t *const nodeIn,
+												 char *const methodNameIn, char *const pathToNodeIn, cxa_fixedByteBuffer_t *const paramsIn,
+												 uint32_t timeout_msIn, cxa_mqtt_rpc_cb_methodResponse_t responseCbIn, void* userVarIn,
+												 uint16_t *const requestIdOut)
 {
 	cxa_assert(nodeIn);
 	cxa_assert(methodNameIn);
 
-	static uint16_t currRequestId = 0;
-
 	// first, we need to form our message
 	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_empty();
 	if( (msg == NULL) ||
@@ -148,22 +197,16 @@ bool cxa_mqtt_rpc_node_executeMethod(cxa_mqtt_rpc_node_t *const nodeIn,
 		return false;
 	}
 
-	// now we need to get our topic/path in order...first the request ID
-	char msgId[5];
-	uint16_t sentReqId = currRequestId++;
+	// now we need to get our topic/path in order...the method name and request ID
+	char msgId[REQUEST_ID_LEN_BYTES+1];
+	uint16_t sentReqId = inFlight_getNextRequestId();
 	snprintf(msgId, sizeof(msgId), "%04X", sentReqId);
-	msgId[4] = 0;
-	if( !cxa_mqtt_message_publish_topicName_prependCString(msg, msgId) ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, "/") )
-	{
-		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
-		return false;
-	}
+	msgId[REQUEST_ID_LEN_BYTES] = 0;
 
-	// now the method name
+	char methodTopic[sizeof(CXA_MQTT_RPCNODE_REQ_PREFIX) + CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES + sizeof(msgId)];
 	if( (strlen(methodNameIn) >= CXA_MQTT_RPCNODE_MAXLEN_METHOD_BYTES) ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, methodNameIn) ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, CXA_MQTT_RPCNODE_REQ_PREFIX) ||
+		((size_t)snprintf(methodTopic, sizeof(methodTopic), "%s%s/%s", CXA_MQTT_RPCNODE_REQ_PREFIX, methodNameIn, msgId) >= sizeof(methodTopic)) ||
+		!cxa_mqtt_message_publish_topicName_prependCString(msg, methodTopic) ||
 		((pathToNodeIn != NULL) && !cxa_mqtt_message_publish_topicName_prependCString(msg, "/")) )
 	{
 		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
@@ -187,28 +230,13 @@ bool cxa_mqtt_rpc_node_executeMethod(cxa_mqtt_rpc_node_t *const nodeIn,
 	}
 
 	// good, now add an outstanding request entry for this message (if desired)
-	if( responseCbIn != NULL )
+	if( (responseCbIn != NULL) && !inFlight_add(nodeIn, sentReqId, methodNameIn, pathToNodeIn, timeout_msIn, responseCbIn, userVarIn) )
 	{
-		cxa_mqtt_rpc_node_outstandingRequest_t newRequest = {
-				.cb = responseCbIn,
-				.userVar = userVarIn
-		};
-
-		// copy over the method name and the id
-		cxa_stringUtils_copy(newRequest.name, methodNameIn, sizeof(newRequest.name));
-		cxa_stringUtils_copy(newRequest.id, msgId, sizeof(newRequest.id));
-
-		// initialize our timeout
-		cxa_timeDiff_init(&newRequest.td_timeout);
-
-		// add to our list of outstanding requests
-		if( !cxa_array_append(&nodeIn->outstandingRequests, &newRequest) )
-		{
-			cxa_logger_warn(&nodeIn->logger, "too many outstanding requests, dropping");
-			cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
-			return false;
-		}
+		cxa_logger_warn(&nodeIn->logger, "too many outstanding requests, dropping");
+		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		return false;
 	}
+	if( requestIdOut != NULL ) *requestIdOut = sentReqId;
 
 	// excellent...now we need to figure out where this message is headed...
 	if( (pathToNodeIn != NULL) &&
@@ -232,6 +260,18 @@ bool cxa_mqtt_rpc_node_executeMethod(cxa_mqtt_rpc_node_t *const nodeIn,
 }
 
 
+bool cxa_mqtt_rpc_node_cancelRequest(cxa_mqtt_rpc_node_t *const nodeIn, uint16_t requestIdIn)
+{
+	cxa_assert(nodeIn);
+
+	uint16_t index = inFlight_find(requestIdIn);
+	if( (index == INVALID_INDEX) || (inFlightRequests[index].node != nodeIn) ) return false;
+
+	inFlight_remove(index);
+	return true;
+}
+
+
 bool cxa_mqtt_rpc_node_publishNotification(cxa_mqtt_rpc_node_t *const nodeIn, char *const notiNameIn, cxa_mqtt_qosLevel_t qosIn, void* dataIn, size_t dataSize_bytesIn)
 {
 	cxa_assert(nodeIn);
@@ -278,10 +318,7 @@ bool cxa_mqtt_rpc_node_publishNotification_appendSubTopic(cxa_mqtt_rpc_node_t *c
 		return false;
 	}
 	// and the message type and version
-	if( !cxa_mqtt_message_publish_topicName_prependCString(msg, "/") ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, CXA_MQTT_RPCNODE_NOTI_PREFIX) ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, "/") ||
-		!cxa_mqtt_message_publish_topicName_prependCString(msg, "v1") )
+	if( !cxa_mqtt_message_publish_topicName_prependCString(msg, CXA_MQTT_RPC_VERSION "/" CXA_MQTT_RPCNODE_NOTI_PREFIX "/") )
 	{
 		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 		return false;
@@ -316,6 +353,21 @@ cxa_mqtt_client_t* cxa_mqtt_rpc_node_getClient(cxa_mqtt_rpc_node_t *const nodeIn
 }
 
 
+bool cxa_mqtt_rpc_node_prependLocalPathToTopic(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(msgIn);
+
+	// the local root is represented by our prefix (rather than its name)
+	size_t localPathLen_bytes = nodeIn->pathLen_bytes - nodeIn->localPathStartIndex;
+	if( (localPathLen_bytes > 0) &&
+		(!cxa_mqtt_message_publish_topicName_prependCString(msgIn, "/") ||
+		 !cxa_mqtt_message_publish_topicName_prependString_withLength(msgIn, &nodeIn->path[nodeIn->localPathStartIndex], localPathLen_bytes)) ) return false;
+
+	return cxa_mqtt_message_publish_topicName_prependCString(msgIn, CXA_MQTT_RPCNODE_LOCALROOT_PREFIX);
+}
+
+
 // ******** local function implementations ********
 static void scm_handleMessage_upstream(cxa_mqtt_rpc_node_t *const superIn, cxa_mqtt_message_t *const msgIn)
 {
@@ -352,6 +404,9 @@ static bool scm_handleRequest_downstream(cxa_mqtt_rpc_node_t *const superIn,
 
 	cxa_logger_trace_untermString(&superIn->logger, ">> '", remainingTopicIn, remainingTopicLen_bytesIn, "'");
 
+	// local responses make their way back to the local root...see if we were waiting for it
+	if( (superIn->parentNode == NULL) && inFlight_handleResponse(msgIn) ) return true;
+
 	// make sure that the topic starts with our name (handle the special "localroot" case)
 	size_t nodeNameLen_bytes = strlen(superIn->name);
 	if( superIn->parentNode != NULL )
@@ -381,7 +436,18 @@ static bool scm_handleRequest_downstream(cxa_mqtt_rpc_node_t *const superIn,
 	}
 
 	// count our remaining separators to tell us if the message is bound for one of our methods
-	if( cxa_stringUtils_countOccurences_withLengths(currTopic, currTopicLen_bytes, "/", 1) == 0 )
+	size_t numSeparators = cxa_stringUtils_countOccurences_withLengths(currTopic, currTopicLen_bytes, "/", 1);
+
+	// requests from cxa_mqtt_rpc_node_executeMethod are tagged with an id (eg. "->method/0001")
+	size_t reqPrefixLen_bytes = strlen(CXA_MQTT_RPCNODE_REQ_PREFIX);
+	if( (numSeparators == 1) && cxa_stringUtils_startsWith_withLengths(currTopic, currTopicLen_bytes, CXA_MQTT_RPCNODE_REQ_PREFIX, reqPrefixLen_bytes) )
+	{
+		currTopic += reqPrefixLen_bytes;
+		currTopicLen_bytes -= reqPrefixLen_bytes;
+		numSeparators = 0;
+	}
+
+	if( numSeparators == 0 )
 	{
 		// no more separators...start looking for a method
 		cxa_array_iterate(&superIn->methods, currMethodEntry, cxa_mqtt_rpc_node_methodEntry_t)
@@ -441,18 +507,8 @@ static void cb_onRunLoopUpdate(void* userVarIn)
 	cxa_mqtt_rpc_node_t* nodeIn = (cxa_mqtt_rpc_node_t*)userVarIn;
 	cxa_assert(nodeIn);
 
-	// check our outstanding requests for timeouts
-	cxa_array_iterate(&nodeIn->outstandingRequests, currRequest, cxa_mqtt_rpc_node_outstandingRequest_t)
-	{
-		if( currRequest == NULL ) continue;
-
-		if( cxa_timeDiff_isElapsed_ms(&currRequest->td_timeout, REQUEST_TIMEOUT_MS) )
-		{
-			currRequest->cb(nodeIn, CXA_MQTT_RPC_METHODRETVAL_FAIL_TIMEOUT, NULL, currRequest->userVar);
-			cxa_array_remove(&nodeIn->outstandingRequests, currRequest);
-			break;
-		}
-	}
+	// check for timeouts (shared by all nodes, but only the earliest deadline is checked)
+	inFlight_checkTimeouts();
 
 	// iterate through our subnodes and update them as well
 	cxa_array_iterate(&nodeIn->subNodes, currSubNode, cxa_mqtt_rpc_node_t*)
@@ -484,6 +540,7 @@ static cxa_mqtt_message_t* prepForResponse(cxa_mqtt_rpc_node_t *const nodeIn, cx
 		!cxa_mqtt_message_publish_getPayload(reqMsgIn, lf_payloadIn) || !cxa_mqtt_message_publish_getPayload(respMsg, lf_retPayloadIn) )	// setup payloads
 	{
 		cxa_logger_warn(&nodeIn->logger, "error reserving/init'ing response");
+		cxa_mqtt_messageFactory_decrementMessageRefCount(respMsg);
 		return NULL;
 	}
 
@@ -511,13 +568,215 @@ static bool addNodePathToTopic(cxa_mqtt_rpc_node_t *const nodeIn, cxa_mqtt_messa
 	cxa_assert(nodeIn);
 	cxa_assert(msgIn);
 
-	// add ourselves first
-	if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, nodeIn->name) ) return false;
+	// our path is cached, so this is a single copy
+	return cxa_mqtt_message_publish_topicName_prependString_withLength(msgIn, nodeIn->path, nodeIn->pathLen_bytes);
+}
+
+
+static void inFlight_init(void)
+{
+	for( uint16_t i = 0; i < NUM_HASH_BUCKETS; i++ )
+	{
+		inFlightBuckets[i] = INVALID_INDEX;
+	}
+
+	// unused entries are chained through nextInBucket
+	for( uint16_t i = 0; i < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS; i++ )
+	{
+		inFlightRequests[i].node = NULL;
+		inFlightRequests[i].nextInBucket = ((i+1) < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS) ? (i+1) : INVALID_INDEX;
+	}
+	inFlightFreeHead = 0;
+
+	inFlightDeadlineHead = INVALID_INDEX;
+	inFlightDeadlineTail = INVALID_INDEX;
+
+	isInFlightInit = true;
+}
+
+
+static uint16_t inFlight_getNextRequestId(void)
+{
+	// don't reuse an id that is still waiting for a response
+	uint16_t retVal;
+	do
+	{
+		retVal = currRequestId++;
+	} while( inFlight_find(retVal) != INVALID_INDEX );
+
+	return retVal;
+}
+
+
+static uint16_t inFlight_find(uint16_t idIn)
+{
+	for( uint16_t currIndex = inFlightBuckets[idIn % NUM_HASH_BUCKETS]; currIndex != INVALID_INDEX; currIndex = inFlightRequests[currIndex].nextInBucket )
+	{
+		if( inFlightRequests[currIndex].id == idIn ) return currIndex;
+	}
+	return INVALID_INDEX;
+}
+
+
+static bool inFlight_add(cxa_mqtt_rpc_node_t *const nodeIn, uint16_t idIn, char *const methodNameIn, char *const pathToNodeIn,
+						 uint32_t timeout_msIn, cxa_mqtt_rpc_cb_methodResponse_t cbIn, void* userVarIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(methodNameIn);
+
+	if( inFlightFreeHead == INVALID_INDEX ) return false;
+
+	// take a free entry
+	uint16_t newIndex = inFlightFreeHead;
+	cxa_mqtt_rpc_node_outstandingRequest_t* newRequest = &inFlightRequests[newIndex];
+	inFlightFreeHead = newRequest->nextInBucket;
+
+	newRequest->node = nodeIn;
+	newRequest->id = idIn;
+	cxa_stringUtils_copy(newRequest->methodName, methodNameIn, sizeof(newRequest->methodName));
+	newRequest->pathCrc = getPathCrc(pathToNodeIn, (pathToNodeIn != NULL) ? strlen(pathToNodeIn) : 0);
+	newRequest->timeout_ms = timeout_msIn;
+	newRequest->cb = cbIn;
+	newRequest->userVar = userVarIn;
+	cxa_timeDiff_init(&newRequest->td_sent);
+
+	// add to its hash bucket
+	uint16_t bucketIndex = idIn % NUM_HASH_BUCKETS;
+	newRequest->nextInBucket = inFlightBuckets[bucketIndex];
+	inFlightBuckets[bucketIndex] = newIndex;
+
+	// insert by deadline...most requests use the same timeout so this is usually the tail
+	uint16_t prevIndex = inFlightDeadlineTail;
+	while( (prevIndex != INVALID_INDEX) && (inFlight_getRemainingTime_ms(prevIndex) > timeout_msIn) )
+	{
+		prevIndex = inFlightRequests[prevIndex].prevByDeadline;
+	}
+	uint16_t nextIndex = (prevIndex != INVALID_INDEX) ? inFlightRequests[prevIndex].nextByDeadline : inFlightDeadlineHead;
+
+	newRequest->prevByDeadline = prevIndex;
+	newRequest->nextByDeadline = nextIndex;
+	if( prevIndex != INVALID_INDEX ) inFlightRequests[prevIndex].nextByDeadline = newIndex; else inFlightDeadlineHead = newIndex;
+	if( nextIndex != INVALID_INDEX ) inFlightRequests[nextIndex].prevByDeadline = newIndex; else inFlightDeadlineTail = newIndex;
+
+	return true;
+}
+
+
+static void inFlight_remove(uint16_t indexIn)
+{
+	cxa_assert(indexIn < CXA_MQTT_RPCNODE_MAXNUM_OUTSTANDING_REQS);
+	cxa_mqtt_rpc_node_outstandingRequest_t* request = &inFlightRequests[indexIn];
+	cxa_assert(request->node != NULL);
+
+	// remove from its hash bucket
+	uint16_t* currLink = &inFlightBuckets[request->id % NUM_HASH_BUCKETS];
+	while( *currLink != indexIn )
+	{
+		cxa_assert(*currLink != INVALID_INDEX);
+		currLink = &inFlightRequests[*currLink].nextInBucket;
+	}
+	*currLink = request->nextInBucket;
+
+	// remove from the deadline list
+	if( request->prevByDeadline != INVALID_INDEX ) inFlightRequests[request->prevByDeadline].nextByDeadline = request->nextByDeadline; else inFlightDeadlineHead = request->nextByDeadline;
+	if( request->nextByDeadline != INVALID_INDEX ) inFlightRequests[request->nextByDeadline].prevByDeadline = request->prevByDeadline; else inFlightDeadlineTail = request->prevByDeadline;
+
+	// and return it to the free list
+	request->node = NULL;
+	request->nextInBucket = inFlightFreeHead;
+	inFlightFreeHead = indexIn;
+}
+
+
+static uint32_t inFlight_getRemainingTime_ms(uint16_t indexIn)
+{
+	cxa_mqtt_rpc_node_outstandingRequest_t* request = &inFlightRequests[indexIn];
+
+	uint32_t elapsed_ms = cxa_timeDiff_getElapsedTime_ms(&request->td_sent);
+	return (elapsed_ms < request->timeout_ms) ? (request->timeout_ms - elapsed_ms) : 0;
+}
+
+
+static bool inFlight_handleResponse(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	char *topic, *methodName, *id;
+	uint16_t topicLen_bytes;
+	size_t methodNameLen_bytes, idLen_bytes;
+	uint16_t requestId;
+	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topic, &topicLen_bytes) ||
+		!cxa_mqtt_rpc_message_isActionableResponse(msgIn, &methodName, &methodNameLen_bytes, &id, &idLen_bytes) ||
+		!parseRequestId(id, idLen_bytes, &requestId) ) return false;
+
+	uint16_t index = inFlight_find(requestId);
+	if( index == INVALID_INDEX ) return false;
+
+	// the id only has to be unique locally...make sure this is the response to _our_ request
+	// (same method, sent to the same path: "<path>/<-<method>/<id>")
+	size_t pathLen_bytes = (size_t)(methodName - topic) - strlen(CXA_MQTT_RPCNODE_RESP_PREFIX);
+	if( (pathLen_bytes > 0) && (topic[pathLen_bytes-1] == '/') ) pathLen_bytes--;
+	if( (strlen(inFlightRequests[index].methodName) != methodNameLen_bytes) ||
+		(memcmp(inFlightRequests[index].methodName, methodName, methodNameLen_bytes) != 0) ||
+		(inFlightRequests[index].pathCrc != getPathCrc(topic, pathLen_bytes)) ) return false;
+
+	// we were expecting this response...remove it first (the callback may send another request)
+	cxa_mqtt_rpc_node_outstandingRequest_t request = inFlightRequests[index];
+	inFlight_remove(index);
+
+	// get the return value (and remove it leaving only parameters)
+	cxa_linkedField_t* lf_payload;
+	uint8_t retVal_raw;
+	if( !cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) ||
+		!cxa_linkedField_get_uint8(lf_payload, 0, retVal_raw) ||
+		!cxa_linkedField_remove(lf_payload, 0, 1) )
+	{
+		cxa_logger_warn(&request.node->logger, "no return value found in response");
+		request.cb(request.node, CXA_MQTT_RPC_METHODRETVAL_FAIL_INTERNAL, NULL, request.userVar);
+		return true;
+	}
+
+	request.cb(request.node, (cxa_mqtt_rpc_methodRetVal_t)retVal_raw, lf_payload, request.userVar);
+	return true;
+}
+
+
+static void inFlight_checkTimeouts(void)
+{
+	while( (inFlightDeadlineHead != INVALID_INDEX) &&
+		   cxa_timeDiff_isElapsed_ms(&inFlightRequests[inFlightDeadlineHead].td_sent, inFlightRequests[inFlightDeadlineHead].timeout_ms) )
+	{
+		cxa_mqtt_rpc_node_outstandingRequest_t request = inFlightRequests[inFlightDeadlineHead];
+		inFlight_remove(inFlightDeadlineHead);
+
+		cxa_logger_debug(&request.node->logger, "request %04X timed out", request.id);
+		request.cb(request.node, CXA_MQTT_RPC_METHODRETVAL_FAIL_TIMEOUT, NULL, request.userVar);
+	}
+}
+
+
+static bool parseRequestId(const char *const idIn, size_t idLen_bytesIn, uint16_t *const idOut)
+{
+	cxa_assert(idIn);
+	cxa_assert(idOut);
 
-	// add our parent if it exists
-	if( (nodeIn->parentNode != NULL) &&
-		( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, "/") ||
-		  !addNodePathToTopic(nodeIn->parentNode, msgIn)) ) return false;
+	if( idLen_bytesIn != REQUEST_ID_LEN_BYTES ) return false;
 
+	uint16_t retVal = 0;
+	for( size_t i = 0; i < idLen_bytesIn; i++ )
+	{
+		char currChar = idIn[i];
+		if( !isxdigit((unsigned char)currChar) ) return false;
+
+		retVal = (retVal << 4) | (isdigit((unsigned char)currChar) ? (currChar - '0') : (toupper((unsigned char)currChar) - 'A' + 10));
+	}
+
+	*idOut = retVal;
 	return true;
 }
+
+
+static uint16_t getPathCrc(char *const pathIn, size_t pathLen_bytesIn)
+{
+	return ((pathIn != NULL) && (pathLen_bytesIn > 0)) ? cxa_numberUtils_crc16_oneShot(pathIn, pathLen_bytesIn) : 0;
+}
@@ -24,6 +24,9 @@
 
 
 // ******** local macro definitions ********
+#define NODE_NONE					-1
+#define FNV1A_OFFSET_BASIS			2166136261UL
+#define FNV1A_PRIME					16777619UL
 
 
 // ******** local type definitions ********
@@ -40,6 +43,13 @@ static bool scm_handleMessage_downstream(cxa_mqtt_rpc_node_t *const superIn,
 										 char *const remainingTopicIn, uint16_t remainingTopicLen_bytesIn,
 										 cxa_mqtt_message_t *const msgIn);
 
+static void handleConnStateMessage(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, char* topicNameIn, uint16_t topicNameLen_bytesIn, cxa_mqtt_message_t *const msgIn);
+
+static void resetRemoteNodes(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn);
+static bool removeRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn);
+static int16_t findRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn);
+static int16_t* getRouteBucket(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn);
+
 
 // ********  local variable declarations *********
 
@@ -53,6 +63,8 @@ void cxa_mqtt_rpc_node_bridge_multi_init(cxa_mqtt_rpc_node_bridge_multi_t *const
 	cxa_assert(parentNodeIn);
 	cxa_assert(mppIn);
 	cxa_assert(nameFmtIn);
+	cxa_assert(CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES <= INT16_MAX);
+	cxa_assert((CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS & (CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS - 1)) == 0);
 
 	// initialize our super class
 	va_list varArgs;
@@ -69,7 +81,8 @@ void cxa_mqtt_rpc_node_bridge_multi_init(cxa_mqtt_rpc_node_bridge_multi_t *const
 	nodeIn->localAuthUserVar = NULL;
 
 	// setup our remote nodes
-	cxa_array_initStd(&nodeIn->remoteNodes, nodeIn->remoteNodes_raw);
+	resetRemoteNodes(nodeIn);
+	nodeIn->numUnroutableMessages = 0;
 }
 
 
@@ -85,7 +98,7 @@ void cxa_mqtt_rpc_node_bridge_multi_setAuthCb(cxa_mqtt_rpc_node_bridge_multi_t *
 size_t cxa_mqtt_rpc_node_bridge_multi_getNumRemoteNodes(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn)
 {
 	cxa_assert(nodeIn);
-	return cxa_array_getSize_elems(&nodeIn->remoteNodes);
+	return nodeIn->numRemoteNodes;
 }
 
 
@@ -93,7 +106,59 @@ void cxa_mqtt_rpc_node_bridge_multi_clearRemoteNodes(cxa_mqtt_rpc_node_bridge_mu
 {
 	cxa_assert(nodeIn);
 
-	cxa_array_clear(&nodeIn->remoteNodes);
+	resetRemoteNodes(nodeIn);
+}
+
+
+bool cxa_mqtt_rpc_node_bridge_multi_removeRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(clientIdIn);
+
+	return removeRemoteNode(nodeIn, clientIdIn, strlen(clientIdIn));
+}
+
+
+bool cxa_mqtt_rpc_node_bridge_multi_getRouteStats(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, size_t indexIn, cxa_mqtt_rpc_node_bridge_multi_routeStats_t *const statsOut)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(statsOut);
+
+	for( size_t i = 0; i < CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES; i++ )
+	{
+		cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* currEntry = &nodeIn->remoteNodes[i];
+		if( !currEntry->isUsed ) continue;
+		if( indexIn-- > 0 ) continue;
+
+		statsOut->clientId = currEntry->clientId;
+		statsOut->mappedName = currEntry->mappedName;
+		statsOut->numMessages = currEntry->numMessages;
+		statsOut->numBytes = currEntry->numBytes;
+		return true;
+	}
+
+	return false;
+}
+
+
+uint32_t cxa_mqtt_rpc_node_bridge_multi_getNumUnroutableMessages(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn)
+{
+	cxa_assert(nodeIn);
+
+	return nodeIn->numUnroutableMessages;
+}
+
+
+void cxa_mqtt_rpc_node_bridge_multi_resetRouteStats(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn)
+{
+	cxa_assert(nodeIn);
+
+	for( size_t i = 0; i < CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES; i++ )
+	{
+		nodeIn->remoteNodes[i].numMessages = 0;
+		nodeIn->remoteNodes[i].numBytes = 0;
+	}
+	nodeIn->numUnroutableMessages = 0;
 }
 
 
@@ -110,47 +175,51 @@ static cxa_mqtt_rpc_node_bridge_authorization_t bridgeAuthCb(char *const clientI
 	if( nodeIn->cb_localAuth == NULL ) return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_IGNORE;
 
 	// check out our current remote nodes to see if someone is connecting again (reboot maybe?)
-	cxa_array_iterate(&nodeIn->remoteNodes, currRemoteNode, cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t)
+	if( findRemoteNode(nodeIn, clientIdIn, clientIdLen_bytes) != NODE_NONE )
 	{
-		if( currRemoteNode ) continue;
-
-		if( cxa_stringUtils_equals(currRemoteNode->clientId, clientIdIn) )
-		{
-			cxa_logger_debug_untermString(&nodeIn->super.super.logger, "reauth attempt for '", clientIdIn, clientIdLen_bytes, "'");
-			return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_ALLOW;
-		}
+		cxa_logger_debug_untermString(&nodeIn->super.super.logger, "reauth attempt for '", clientIdIn, clientIdLen_bytes, "'");
+		return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_ALLOW;
 	}
 
 	// make sure we have space
-	if( cxa_array_isFull(&nodeIn->remoteNodes) )
+	if( nodeIn->firstFreeRemoteNode == NODE_NONE )
 	{
 		cxa_logger_warn(&nodeIn->super.super.logger, "too many remote dropping");
 		return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_IGNORE;
 	}
 
 	// get our new entry ready to record the remote client
-	cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t newEntry;
-	newEntry.clientId[0] = 0;
-	newEntry.mappedName[0] = 0;
+	int16_t newIndex = nodeIn->firstFreeRemoteNode;
+	cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* newEntry = &nodeIn->remoteNodes[newIndex];
+	newEntry->clientId[0] = 0;
+	newEntry->mappedName[0] = 0;
 
 	// make sure the client ID OK
-	if( clientIdLen_bytes >= sizeof(newEntry.clientId) )
+	if( clientIdLen_bytes >= sizeof(newEntry->clientId) )
 	{
 		cxa_logger_warn(&nodeIn->super.super.logger, "remote clientId too long");
 		return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_IGNORE;
 	}
-	cxa_stringUtils_concat_withLengths(newEntry.clientId, sizeof(newEntry.clientId), clientIdIn, clientIdLen_bytes);
+	cxa_stringUtils_concat_withLengths(newEntry->clientId, sizeof(newEntry->clientId), clientIdIn, clientIdLen_bytes);
+	newEntry->clientIdLen_bytes = (uint8_t)clientIdLen_bytes;
 
 	// call _our_ authorization callback
 	cxa_mqtt_rpc_node_bridge_authorization_t retVal = nodeIn->cb_localAuth(clientIdIn, clientIdLen_bytes,
 																		   usernameIn, usernameLen_bytesIn,
 																		   passwordIn, passwordLen_bytesIn,
-																		   newEntry.mappedName, sizeof(newEntry.mappedName),
+																		   newEntry->mappedName, sizeof(newEntry->mappedName),
 																		   nodeIn->localAuthUserVar);
 	if( retVal != CXA_MQTT_RPC_NODE_BRIDGE_AUTH_ALLOW ) return retVal;
 
-	// if we made it here, we are allowing it (assuming we have space)
-	cxa_assert( cxa_array_append(&nodeIn->remoteNodes, &newEntry) );
+	// if we made it here, we are allowing it...take it off our free list and add it to its bucket
+	int16_t* bucket = getRouteBucket(nodeIn, clientIdIn, clientIdLen_bytes);
+	nodeIn->firstFreeRemoteNode = newEntry->next;
+	newEntry->isUsed = true;
+	newEntry->numMessages = 0;
+	newEntry->numBytes = 0;
+	newEntry->next = *bucket;
+	*bucket = newIndex;
+	nodeIn->numRemoteNodes++;
 
 	return CXA_MQTT_RPC_NODE_BRIDGE_AUTH_ALLOW;
 }
@@ -168,8 +237,12 @@ static void scm_handleMessage_upstream(cxa_mqtt_rpc_node_t *const superIn, cxa_m
 	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) ||
 		(topicName == NULL) || (topicNameLen_bytes == 0) ) return;
 
-	// this _may_ be our client state message...if so, we don't need to do anything
-	if( cxa_stringUtils_endsWith_withLengths(topicName, topicNameLen_bytes, CXA_MQTT_RPCNODE_CONNSTATE_STREAM_NAME) ) return;
+	// this _may_ be a client state message...if so, it's for us (not upstream)
+	if( cxa_stringUtils_indexOfFirstOccurence_withLengths(topicName, topicNameLen_bytes, "/" CXA_MQTT_RPCNODE_CONNSTATE_STREAM_NAME "/", strlen("/" CXA_MQTT_RPCNODE_CONNSTATE_STREAM_NAME "/")) >= 0 )
+	{
+		handleConnStateMessage(nodeIn, topicName, topicNameLen_bytes, msgIn);
+		return;
+	}
 
 	cxa_logger_trace_untermString(&nodeIn->super.super.logger, "<< '", topicName, topicNameLen_bytes, "'");
 
@@ -186,38 +259,27 @@ static void scm_handleMessage_upstream(cxa_mqtt_rpc_node_t *const superIn, cxa_m
 	{
 		// we'll need to do some remapping here...
 
-		// ensure that our publish topic actually matches one of our remote nodes
-		cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* targetRne = NULL;
-		cxa_array_iterate(&nodeIn->remoteNodes, currRemNode, cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t)
+		// ensure that our publish topic starts with the clientId of one of our remote nodes
+		char* clientIdEnd = memchr(topicName, '/', topicNameLen_bytes);
+		int16_t targetIndex = (clientIdEnd != NULL) ? findRemoteNode(nodeIn, topicName, clientIdEnd - topicName) : NODE_NONE;
+		if( targetIndex == NODE_NONE )
 		{
-			if( currRemNode == NULL ) continue;
-
-			if( cxa_stringUtils_contains_withLengths(topicName, topicNameLen_bytes, currRemNode->clientId, strlen(currRemNode->clientId)) )
-			{
-				targetRne = currRemNode;
-				break;
-			}
+			nodeIn->numUnroutableMessages++;
+			return;
 		}
-		if( targetRne == NULL ) return;
+		cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* targetRne = &nodeIn->remoteNodes[targetIndex];
+		targetRne->numMessages++;
+		targetRne->numBytes += cxa_fixedByteBuffer_getSize_bytes(cxa_mqtt_message_getBuffer(msgIn));
 
 		// ok...get rid of everything up to, and including, the clientId (+1 is for separator)
-		if( !cxa_mqtt_message_publish_topicName_trimToPointer(msgIn, topicName+strlen(targetRne->clientId)+1) ) return;
+		if( !cxa_mqtt_message_publish_topicName_trimToPointer(msgIn, clientIdEnd+1) ) return;
 
 		// prepend our mapped name first
 		if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, "/") ||
 			!cxa_mqtt_message_publish_topicName_prependCString(msgIn, targetRne->mappedName) ) return;
 
-		// now we need to prepend our node structure
-		cxa_mqtt_rpc_node_t* currNode = &nodeIn->super.super;
-		while( (currNode != NULL) && (currNode->parentNode != NULL) )
-		{
-			if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, "/") ||
-				!cxa_mqtt_message_publish_topicName_prependCString(msgIn, currNode->name) ) return;
-
-			currNode = currNode->parentNode;
-		}
-		// and finally our local root prefix
-		if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, CXA_MQTT_RPCNODE_LOCALROOT_PREFIX) ) return;
+		// now we need to prepend our node structure (and our local root prefix)
+		if( !cxa_mqtt_rpc_node_prependLocalPathToTopic(&nodeIn->super.super, msgIn) ) return;
 
 		// message should be now be mapped properly...hand upstream!
 		if( superIn->parentNode != NULL ) superIn->parentNode->scm_handleMessage_upstream(superIn->parentNode, msgIn);
@@ -315,3 +377,114 @@ static bool scm_handleMessage_downstream(cxa_mqtt_rpc_node_t *const superIn,
 
 	return false;
 }
+
+
+static void handleConnStateMessage(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, char* topicNameIn, uint16_t topicNameLen_bytesIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(topicNameIn);
+	cxa_assert(msgIn);
+
+	// we only care when a remote node goes away (its last-will, see cxa_mqtt_rpc_node_root)
+	cxa_linkedField_t* lf_payload;
+	if( !cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) ) return;
+	size_t payloadLen_bytes = cxa_linkedField_getSize_bytes(lf_payload);
+	char* payload = (char*)cxa_linkedField_get_pointerToIndex(lf_payload, 0);
+	if( (payload == NULL) ||
+		!cxa_stringUtils_equals_withLengths(payload, payloadLen_bytes, CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_DISCONN, strlen(CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_DISCONN)) ) return;
+
+	// v1/^^/<clientId>/streams/upstreamConnState/onStreamUpdate (the prefix is optional)
+	const char* notiPrefix = CXA_MQTT_RPC_VERSION "/" CXA_MQTT_RPCNODE_NOTI_PREFIX "/";
+	if( cxa_stringUtils_startsWith_withLengths(topicNameIn, topicNameLen_bytesIn, notiPrefix, strlen(notiPrefix)) )
+	{
+		topicNameIn += strlen(notiPrefix);
+		topicNameLen_bytesIn -= strlen(notiPrefix);
+	}
+	char* clientIdEnd = memchr(topicNameIn, '/', topicNameLen_bytesIn);
+	if( clientIdEnd == NULL ) return;
+
+	if( !removeRemoteNode(nodeIn, topicNameIn, clientIdEnd - topicNameIn) )
+	{
+		cxa_logger_debug_untermString(&nodeIn->super.super.logger, "disconnect from unknown remote '", topicNameIn, clientIdEnd - topicNameIn, "'");
+	}
+}
+
+
+static void resetRemoteNodes(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn)
+{
+	cxa_assert(nodeIn);
+
+	for( size_t i = 0; i < CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS; i++ )
+	{
+		nodeIn->routeBuckets[i] = NODE_NONE;
+	}
+
+	// all entries start on the free list
+	for( size_t i = 0; i < CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES; i++ )
+	{
+		nodeIn->remoteNodes[i].isUsed = false;
+		nodeIn->remoteNodes[i].next = ((i+1) < CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES) ? (int16_t)(i+1) : NODE_NONE;
+	}
+	nodeIn->firstFreeRemoteNode = (CXA_MQTT_RPC_NODE_BRIDGE_MAXNUM_REMOTE_NODES > 0) ? 0 : NODE_NONE;
+	nodeIn->numRemoteNodes = 0;
+}
+
+
+static bool removeRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(clientIdIn);
+
+	// find the link pointing to our entry
+	int16_t* prevLink = getRouteBucket(nodeIn, clientIdIn, clientIdLen_bytesIn);
+	while( *prevLink != NODE_NONE )
+	{
+		cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* currEntry = &nodeIn->remoteNodes[*prevLink];
+		if( (currEntry->clientIdLen_bytes == clientIdLen_bytesIn) && (memcmp(currEntry->clientId, clientIdIn, clientIdLen_bytesIn) == 0) )
+		{
+			// unlink from our bucket and return to the free list
+			int16_t removedIndex = *prevLink;
+			*prevLink = currEntry->next;
+			currEntry->isUsed = false;
+			currEntry->next = nodeIn->firstFreeRemoteNode;
+			nodeIn->firstFreeRemoteNode = removedIndex;
+			nodeIn->numRemoteNodes--;
+
+			cxa_logger_debug(&nodeIn->super.super.logger, "removed '%s'", currEntry->clientId);
+			return true;
+		}
+		prevLink = &currEntry->next;
+	}
+
+	return false;
+}
+
+
+static int16_t findRemoteNode(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn)
+{
+	cxa_assert(nodeIn);
+
+	for( int16_t currIndex = *getRouteBucket(nodeIn, clientIdIn, clientIdLen_bytesIn); currIndex != NODE_NONE; currIndex = nodeIn->remoteNodes[currIndex].next )
+	{
+		cxa_mqtt_rpc_node_bridge_multi_remoteNodeEntry_t* currEntry = &nodeIn->remoteNodes[currIndex];
+		if( (currEntry->clientIdLen_bytes == clientIdLen_bytesIn) && (memcmp(currEntry->clientId, clientIdIn, clientIdLen_bytesIn) == 0) ) return currIndex;
+	}
+
+	return NODE_NONE;
+}
+
+
+static int16_t* getRouteBucket(cxa_mqtt_rpc_node_bridge_multi_t *const nodeIn, const char *const clientIdIn, size_t clientIdLen_bytesIn)
+{
+	cxa_assert(nodeIn);
+
+	// FNV-1a
+	uint32_t hash = FNV1A_OFFSET_BASIS;
+	for( size_t i = 0; i < clientIdLen_bytesIn; i++ )
+	{
+		hash ^= (uint8_t)clientIdIn[i];
+		hash *= FNV1A_PRIME;
+	}
+
+	return &nodeIn->routeBuckets[hash & (CXA_MQTT_RPC_NODE_BRIDGE_NUM_ROUTE_BUCKETS - 1)];
+}
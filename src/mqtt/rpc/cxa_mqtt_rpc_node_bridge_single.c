@@ -166,17 +166,8 @@ static void scm_handleMessage_upstream(cxa_mqtt_rpc_node_t *const superIn, cxa_m
 		// ok...get rid of everything up to, and including, the clientId (+1 is for separator)
 		if( !cxa_mqtt_message_publish_topicName_trimToPointer(msgIn, topicName+strlen(nodeIn->clientId)+1) ) return;
 
-		// now we need to prepend our node structure
-		cxa_mqtt_rpc_node_t* currNode = &nodeIn->super.super;
-		while( (currNode != NULL) && (currNode->parentNode != NULL) )
-		{
-			if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, "/") ||
-				!cxa_mqtt_message_publish_topicName_prependCString(msgIn, currNode->name) ) return;
-
-			currNode = currNode->parentNode;
-		}
-		// and finally our local root prefix
-		if( !cxa_mqtt_message_publish_topicName_prependCString(msgIn, CXA_MQTT_RPCNODE_LOCALROOT_PREFIX) ) return;
+		// now we need to prepend our node structure (and our local root prefix)
+		if( !cxa_mqtt_rpc_node_prependLocalPathToTopic(&nodeIn->super.super, msgIn) ) return;
 
 		// message should be now be mapped properly...hand upstream!
 		if( superIn->parentNode != NULL ) superIn->parentNode->scm_handleMessage_upstream(superIn->parentNode, msgIn);
@@ -20,8 +20,6 @@
 
 
 // ******** local macro definitions ********
-#define CONN_STATE_PAYLOAD_CONN			"{\"value_num\":1}"
-#define CONN_STATE_PAYLOAD_DISCONN		"{\"value_num\":0}"
 
 
 // ******** local type definitions ********
@@ -75,7 +73,7 @@ void cxa_mqtt_rpc_node_root_init(cxa_mqtt_rpc_node_root_t *const nodeIn, cxa_mqt
 											  CXA_MQTT_QOS_ATMOST_ONCE,
 											  false,
 											  stateTopic,
-											  CONN_STATE_PAYLOAD_DISCONN, strlen(CONN_STATE_PAYLOAD_DISCONN)));
+											  CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_DISCONN, strlen(CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_DISCONN)));
 
 	// we can subscribe immediately because the mqtt client will cache subscribes if we're offline
 	char subscriptTopic[CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES];
@@ -83,7 +81,7 @@ void cxa_mqtt_rpc_node_root_init(cxa_mqtt_rpc_node_root_t *const nodeIn, cxa_mqt
 	cxa_assert( cxa_stringUtils_concat(subscriptTopic, CXA_MQTT_RPC_MESSAGE_VERSION "/->/", sizeof(subscriptTopic)) );
 	cxa_assert( cxa_stringUtils_concat(subscriptTopic, nodeIn->super.name, sizeof(subscriptTopic)) );
 	cxa_assert( cxa_stringUtils_concat(subscriptTopic, "/#", sizeof(subscriptTopic)) );
-	cxa_mqtt_client_subscribe(nodeIn->mqttClient, subscriptTopic, CXA_MQTT_QOS_ATMOST_ONCE, mqttClientCb_onPublish, (void*)nodeIn);
+	cxa_assert_msg(cxa_mqtt_client_subscribe(nodeIn->mqttClient, subscriptTopic, CXA_MQTT_QOS_ATMOST_ONCE, mqttClientCb_onPublish, (void*)nodeIn), "subscribe failed");
 
 	// register for MQTT events
 	cxa_mqtt_client_addListener(nodeIn->mqttClient, mqttClientCb_onConnect, NULL, NULL, NULL,  (void*)nodeIn);
@@ -111,7 +109,7 @@ static void mqttClientCb_onConnect(cxa_mqtt_client_t *const clientIn, void* user
 							CXA_MQTT_QOS_ATMOST_ONCE,
 							false,
 							stateTopic,
-							CONN_STATE_PAYLOAD_CONN, strlen(CONN_STATE_PAYLOAD_CONN));
+							CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_CONN, strlen(CXA_MQTT_RPCNODE_CONNSTATE_PAYLOAD_CONN));
 }
 
 
@@ -0,0 +1,99 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_rpc_node_runLoopProfiler.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_runLoop_profiler.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static cxa_mqtt_rpc_methodRetVal_t mqttRpcCb_getStats(cxa_mqtt_rpc_node_t *const superIn,
+													  cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const returnParamsOut,
+													  void* userVarIn);
+static cxa_mqtt_rpc_methodRetVal_t mqttRpcCb_resetStats(cxa_mqtt_rpc_node_t *const superIn,
+														cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const returnParamsOut,
+														void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_mqtt_rpc_node_runLoopProfiler_init(cxa_mqtt_rpc_node_runLoopProfiler_t *const nodeIn, cxa_mqtt_rpc_node_t *const parentNodeIn)
+{
+	cxa_assert(nodeIn);
+	cxa_assert(parentNodeIn);
+
+	// initialize our superclass
+	cxa_mqtt_rpc_node_init_formattedString(&nodeIn->super, parentNodeIn, "runLoop");
+
+	// setup our methods
+	cxa_mqtt_rpc_node_addMethod(&nodeIn->super, "getStats", mqttRpcCb_getStats, (void*)nodeIn);
+	cxa_mqtt_rpc_node_addMethod(&nodeIn->super, "resetStats", mqttRpcCb_resetStats, (void*)nodeIn);
+}
+
+
+// ******** local function implementations ********
+static cxa_mqtt_rpc_methodRetVal_t mqttRpcCb_getStats(cxa_mqtt_rpc_node_t *const superIn,
+													  cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const returnParamsOut,
+													  void* userVarIn)
+{
+	cxa_mqtt_rpc_node_runLoopProfiler_t* nodeIn = (cxa_mqtt_rpc_node_runLoopProfiler_t*)superIn;
+	cxa_assert(nodeIn);
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	cxa_runLoop_entryStats_t currStats;
+	for( size_t i = 0; cxa_runLoop_getEntryStats(i, &currStats); i++ )
+	{
+		// entries are separated by a line ending (none after the last)
+		char line[CXA_RUNLOOP_PROFILER_MAXLEN_LINE_BYTES + 2];
+		size_t separatorLen_bytes = (i != 0) ? 2 : 0;
+		memcpy(line, "\r\n", separatorLen_bytes);
+		cxa_runLoop_profiler_formatEntry(&currStats, &line[separatorLen_bytes], sizeof(line) - separatorLen_bytes);
+
+		// leave room for our null terminator
+		if( (strlen(line) + 1) > cxa_linkedField_getFreeSize_bytes(returnParamsOut) )
+		{
+			cxa_logger_warn(&nodeIn->super.logger, "response truncated at entry %d", (int)i);
+			break;
+		}
+		cxa_linkedField_append(returnParamsOut, (uint8_t*)line, strlen(line));
+	}
+	cxa_linkedField_append_uint8(returnParamsOut, 0);
+
+	return CXA_MQTT_RPC_METHODRETVAL_SUCCESS;
+#else
+	cxa_logger_warn(&nodeIn->super.logger, "profiling not enabled (CXA_RUNLOOP_PROFILER_ENABLE)");
+	return CXA_MQTT_RPC_METHODRETVAL_FAIL_BAD_STATE;
+#endif
+}
+
+
+static cxa_mqtt_rpc_methodRetVal_t mqttRpcCb_resetStats(cxa_mqtt_rpc_node_t *const superIn,
+														cxa_linkedField_t *const paramsIn, cxa_linkedField_t *const returnParamsOut,
+														void* userVarIn)
+{
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	cxa_runLoop_resetEntryStats();
+	return CXA_MQTT_RPC_METHODRETVAL_SUCCESS;
+#else
+	return CXA_MQTT_RPC_METHODRETVAL_FAIL_BAD_STATE;
+#endif
+}
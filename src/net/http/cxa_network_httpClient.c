@@ -8,6 +8,9 @@
 
 
 // ******** includes ********
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <cxa_assert.h>
@@ -19,33 +22,43 @@
 
 
 // ******** local macro definitions ********
-#define MAXNUM_RX_BYTES_PER_ITERATION			8
+#define MAXNUM_RX_CHUNKS_PER_ITERATION			8
 
 
 // ******** local type definitions ********
 typedef enum
 {
-	STATE_IDLE_DISCONNECTED,
-	STATE_IDLE_CONNECTED,
+	STATE_IDLE,
 	STATE_CONNECTING,
 	STATE_CONNECTED_SEND_DEFAULT_HEADERS,
 	STATE_CONNECTED_CALC_USER_BODY,
 	STATE_CONNECTED_GEN_USER_HEADERS,
 	STATE_CONNECTED_GEN_USER_BODY,
 	STATE_CONNECTED_PARSE_STATUS_CODE,
-	STATE_CONNECTED_PARSE_CONTENT_LENGTH,
-	STATE_CONNECTED_FORWARD_TO_BODY,
+	STATE_CONNECTED_PARSE_HEADERS,
 	STATE_CONNECTED_READ_BODY,
-	STATE_WAIT_DISCONNECT,
+	STATE_CONNECTED_READ_CHUNK_SIZE,
+	STATE_CONNECTED_READ_TRAILERS,
 	STATE_TRANSACTION_ERROR,
 }state_t;
 
 
 // ******** local function prototypes ********
 static bool parseStatusCodeFromString(char *const lineIn, uint16_t* statusCodeOut);
-static bool parseContentLengthFromString(char *const lineIn, size_t *const contentLength_bytesOut);
+static char* getHeaderValue(char *const lineIn, const char *const headerNameIn);
+static const char* getMethodString(cxa_network_httpClient_method_t methodIn);
+
+static cxa_network_httpClient_connection_t* getConnectionForRequest(cxa_network_httpClient_t *const netClientIn, bool *const isReusedOut);
+static void closeConnection(cxa_network_httpClient_connection_t *const connIn);
+static void discardRxBytes(cxa_network_httpClient_connection_t *const connIn);
+
+static void startResponseBody(cxa_network_httpClient_t *const netClientIn);
+static bool deliverBodyBytes(cxa_network_httpClient_t *const netClientIn, uint8_t *const bytesIn, size_t numBytesIn);
+static void handleConnectionLost(cxa_network_httpClient_t *const netClientIn);
+static void finishTransaction(cxa_network_httpClient_t *const netClientIn, bool wasSuccessfulIn);
 
 static void stateCb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
+static void stateCb_idle_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void stateCb_connecting_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void stateCb_sendDefaultHeaders_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void stateCb_genUserHeaders_state(cxa_stateMachine_t *const smIn, void *userVarIn);
@@ -54,12 +67,7 @@ static void stateCb_genUserBody_enter(cxa_stateMachine_t *const smIn, int prevSt
 static void stateCb_xxxUserBody_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void stateCb_parseStatusCode_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void stateCb_xxxCheckTimeout_state(cxa_stateMachine_t *const smIn, void *userVarIn);
-static void stateCb_parseContentLength_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
-static void stateCb_forwardToBody_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
-static void stateCb_readBody_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void stateCb_readBody_state(cxa_stateMachine_t *const smIn, void *userVarIn);
-static void stateCb_waitDisconnect_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
-static void stateCb_waitDisconnect_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void stateCb_transactionError_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 
 static void cb_tcpClient_onConnect(cxa_network_tcpClient_t *const superIn, void* userVarIn);
@@ -70,6 +78,11 @@ static void cb_headerParser_onIoException(void *const userVarIn);
 static void cb_headerParser_onReceptionTimeout(cxa_fixedByteBuffer_t *const incompletePacketIn, void *const userVarIn);
 static void cb_headerParser_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
 
+static cxa_ioStream_readStatus_t cb_chunkedBody_readByte(uint8_t *const byteOut, void *const userVarIn);
+static bool cb_chunkedBody_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool writeChunk(cxa_network_httpClient_t *const netClientIn, void* buffIn, size_t bufferSize_bytesIn);
+static bool flushChunkBuffer(cxa_network_httpClient_t *const netClientIn);
+
 
 // ********  local variable declarations *********
 
@@ -81,60 +94,89 @@ void cxa_network_httpClient_init(cxa_network_httpClient_t *const netClientIn, in
 
 	cxa_logger_init(&netClientIn->logger, "httpClient");
 
-	// try to get a client we can use
-	netClientIn->tcpClient = cxa_network_factory_reserveTcpClient(threadIdIn);
-	cxa_assert(netClientIn->tcpClient);
-	cxa_network_tcpClient_addListener(netClientIn->tcpClient, cb_tcpClient_onConnect, cb_tcpClient_onConnectFail, cb_tcpClient_onDisconnect, (void*)netClientIn);
+	// reserve as many clients as we can (up to our pool size)
+	netClientIn->numConnections = 0;
+	netClientIn->currConnection = NULL;
+	for( size_t i = 0; i < CXA_NETWORK_HTTPCLIENT_MAXNUM_CONNECTIONS; i++ )
+	{
+		cxa_network_tcpClient_t* currTcpClient = cxa_network_factory_reserveTcpClient(threadIdIn);
+		if( currTcpClient == NULL ) break;
+
+		cxa_network_httpClient_connection_t* currConn = &netClientIn->connections[netClientIn->numConnections++];
+		currConn->parent = netClientIn;
+		currConn->tcpClient = currTcpClient;
+		currConn->hostname[0] = 0;
+		currConn->isReusable = false;
+		cxa_timeDiff_init(&currConn->td_idle);
+		cxa_network_tcpClient_addListener(currConn->tcpClient, cb_tcpClient_onConnect, cb_tcpClient_onConnectFail, cb_tcpClient_onDisconnect, (void*)currConn);
+
+		// each connection gets its own parser (bound to its own ioStream)
+		cxa_fixedByteBuffer_initStd(&currConn->headerLineBuffer, currConn->headerLineBuffer_raw);
+		cxa_protocolParser_crlf_init(&currConn->headerLineParser, cxa_network_tcpClient_getIoStream(currConn->tcpClient), &currConn->headerLineBuffer, threadIdIn);
+		cxa_protocolParser_addProtocolListener(&currConn->headerLineParser.super, cb_headerParser_onIoException, cb_headerParser_onReceptionTimeout, (void*)currConn);
+		cxa_protocolParser_addPacketListener(&currConn->headerLineParser.super, cb_headerParser_onPacketReceived, (void*)currConn);
+	}
+	cxa_assert(netClientIn->numConnections > 0);
 
 	// setup for body generation
 	cxa_ioStream_nullablePassthrough_init(&netClientIn->ios_bodyGeneration);
+	cxa_ioStream_init(&netClientIn->ios_chunkedBody);
+	cxa_ioStream_bind(&netClientIn->ios_chunkedBody, cb_chunkedBody_readByte, cb_chunkedBody_writeBytes, (void*)netClientIn);
+	netClientIn->chunkBuffer_currSize_bytes = 0;
 
 	// setup for responses
-	cxa_fixedByteBuffer_initStd(&netClientIn->headerLineBuffer, netClientIn->headerLineBuffer_raw);
-	cxa_protocolParser_crlf_init(&netClientIn->headerLineParser, cxa_network_tcpClient_getIoStream(netClientIn->tcpClient), &netClientIn->headerLineBuffer, threadIdIn);
-	cxa_protocolParser_addProtocolListener(&netClientIn->headerLineParser.super, cb_headerParser_onIoException, cb_headerParser_onReceptionTimeout, (void*)netClientIn);
-	cxa_protocolParser_addPacketListener(&netClientIn->headerLineParser.super, cb_headerParser_onPacketReceived, (void*)netClientIn);
 	cxa_timeDiff_init(&netClientIn->td_receptionTimeout);
+	netClientIn->isBusy = false;
 
 	// setup our state machine
 	cxa_stateMachine_init(&netClientIn->stateMachine, "httpClient", threadIdIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_IDLE_DISCONNECTED, "idle (disconn)", stateCb_idle_enter, NULL, NULL, (void*)netClientIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_IDLE_CONNECTED, "idle (conn)", stateCb_idle_enter, NULL, NULL, (void*)netClientIn);
+	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_IDLE, "idle", stateCb_idle_enter, stateCb_idle_state, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTING, "connecting", stateCb_connecting_enter, NULL, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_SEND_DEFAULT_HEADERS, "sendDefaultHead", stateCb_sendDefaultHeaders_enter, NULL, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_CALC_USER_BODY, "calcBody", stateCb_calcUserBody_enter, stateCb_xxxUserBody_state, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_GEN_USER_HEADERS, "genHeaders", NULL, stateCb_genUserHeaders_state, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_GEN_USER_BODY, "genBody", stateCb_genUserBody_enter, stateCb_xxxUserBody_state, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_STATUS_CODE, "parseStatusCode", stateCb_parseStatusCode_enter, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_CONTENT_LENGTH, "parseContentLength", stateCb_parseContentLength_enter, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_FORWARD_TO_BODY, "forwardToBody", stateCb_forwardToBody_enter, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_READ_BODY, "readBody", stateCb_readBody_enter, stateCb_readBody_state, NULL, (void*)netClientIn);
-	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_WAIT_DISCONNECT, "waitDisconn", stateCb_waitDisconnect_enter, stateCb_waitDisconnect_state, NULL, (void*)netClientIn);
+	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_HEADERS, "parseHeaders", NULL, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
+	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_READ_BODY, "readBody", NULL, stateCb_readBody_state, NULL, (void*)netClientIn);
+	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_READ_CHUNK_SIZE, "readChunkSize", NULL, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
+	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_CONNECTED_READ_TRAILERS, "readTrailers", NULL, stateCb_xxxCheckTimeout_state, NULL, (void*)netClientIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR, "transError", stateCb_transactionError_enter, NULL, NULL, (void*)netClientIn);
-	cxa_stateMachine_setInitialState(&netClientIn->stateMachine, STATE_IDLE_DISCONNECTED);
+	cxa_stateMachine_setInitialState(&netClientIn->stateMachine, STATE_IDLE);
 }
 
 
-void cxa_network_httpClient_post_async(cxa_network_httpClient_t *const netClientIn,
-								 	   char *const hostNameIn, uint16_t portNumIn, bool useTlsIn,
-									   const char *const urlIn, uint32_t timeout_msIn, bool keepOpenIn,
-									   cxa_network_httpClient_cb_asyncGenHeaders_t cb_genHeadersIn,
-									   cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn,
-									   cxa_network_httpClient_cb_onPostComplete_t cb_postCompleteIn,
-									   uint8_t *const responseBodyBufferIn, size_t responseBody_maxSize_bytesIn,
-									   void* userVarIn)
+bool cxa_network_httpClient_request_async(cxa_network_httpClient_t *const netClientIn,
+										  cxa_network_httpClient_method_t methodIn,
+										  char *const hostNameIn, uint16_t portNumIn, bool useTlsIn,
+										  const char *const urlIn, uint32_t timeout_msIn, bool keepOpenIn,
+										  cxa_network_httpClient_cb_asyncGenHeaders_t cb_genHeadersIn,
+										  cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn, bool sendChunkedIn,
+										  cxa_network_httpClient_cb_onResponseData_t cb_responseDataIn,
+										  cxa_network_httpClient_cb_onPostComplete_t cb_completeIn,
+										  uint8_t *const responseBodyBufferIn, size_t responseBody_maxSize_bytesIn,
+										  void* userVarIn)
 {
 	cxa_assert(netClientIn);
 	cxa_assert(hostNameIn);
 	cxa_assert(urlIn);
 	if( responseBody_maxSize_bytesIn > 0 ) cxa_assert(responseBodyBufferIn);
 
+	// one transaction at a time (our state transition won't happen until the next runLoop iteration)
+	if( netClientIn->isBusy )
+	{
+		cxa_logger_warn(&netClientIn->logger, "request already in progress");
+		return false;
+	}
+
 	// save our info for later
 	netClientIn->cbs.genHeaders = cb_genHeadersIn;
 	netClientIn->cbs.genBody = cb_genBodyIn;
-	netClientIn->cbs.postComplete = cb_postCompleteIn;
+	netClientIn->cbs.responseData = cb_responseDataIn;
+	netClientIn->cbs.postComplete = cb_completeIn;
 	netClientIn->cbs.userVar = userVarIn;
 
+	netClientIn->method = methodIn;
 	cxa_assert(cxa_stringUtils_copy(netClientIn->hostname, hostNameIn, sizeof(netClientIn->hostname)));
 	netClientIn->portNum = portNumIn;
 	netClientIn->useTls = useTlsIn;
@@ -142,11 +184,38 @@ void cxa_network_httpClient_post_async(cxa_network_httpClient_t *const netClient
 	netClientIn->timeout_ms = timeout_msIn;
 	netClientIn->keepOpen = keepOpenIn;
 
+	// GET requests without a body generator don't get a body at all
+	netClientIn->hasRequestBody = (methodIn != CXA_NETWORK_HTTPCLIENT_METHOD_GET) || (cb_genBodyIn != NULL);
+	netClientIn->sendChunked = sendChunkedIn && netClientIn->hasRequestBody;
+
 	netClientIn->responseBodyBuffer = responseBodyBufferIn;
 	netClientIn->responseBody_maxSize_bytes = responseBody_maxSize_bytesIn;
+	netClientIn->responseStatusCode = 0;
+
+	netClientIn->hasRetried = false;
+	netClientIn->isRequestSent = false;
+	netClientIn->isBusy = true;
 
 	// start our connection process
 	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTING);
+	return true;
+}
+
+
+bool cxa_network_httpClient_post_async(cxa_network_httpClient_t *const netClientIn,
+								 	   char *const hostNameIn, uint16_t portNumIn, bool useTlsIn,
+									   const char *const urlIn, uint32_t timeout_msIn, bool keepOpenIn,
+									   cxa_network_httpClient_cb_asyncGenHeaders_t cb_genHeadersIn,
+									   cxa_network_httpClient_cb_postAsyncGenBody_t cb_genBodyIn,
+									   cxa_network_httpClient_cb_onPostComplete_t cb_postCompleteIn,
+									   uint8_t *const responseBodyBufferIn, size_t responseBody_maxSize_bytesIn,
+									   void* userVarIn)
+{
+	return cxa_network_httpClient_request_async(netClientIn, CXA_NETWORK_HTTPCLIENT_METHOD_POST,
+												hostNameIn, portNumIn, useTlsIn, urlIn, timeout_msIn, keepOpenIn,
+												cb_genHeadersIn, cb_genBodyIn, false,
+												NULL, cb_postCompleteIn,
+												responseBodyBufferIn, responseBody_maxSize_bytesIn, userVarIn);
 }
 
 
@@ -174,47 +243,275 @@ static bool parseStatusCodeFromString(char *const lineIn, uint16_t* statusCodeOu
 }
 
 
-static bool parseContentLengthFromString(char *const lineIn, size_t *const contentLength_bytesOut)
+static char* getHeaderValue(char *const lineIn, const char *const headerNameIn)
 {
-	const char contentLenStr[] = "Content-Length:";
+	// header names are case-insensitive
+	size_t nameLen_bytes = strlen(headerNameIn);
+	for( size_t i = 0; i < nameLen_bytes; i++ )
+	{
+		if( tolower((unsigned char)lineIn[i]) != tolower((unsigned char)headerNameIn[i]) ) return NULL;
+	}
+	if( lineIn[nameLen_bytes] != ':' ) return NULL;
 
-	// if we made it here we got a line...see if it starts with the right string
+	// skip any leading whitespace on the value
+	char* retVal = &lineIn[nameLen_bytes+1];
+	while( (*retVal == ' ') || (*retVal == '\t') ) retVal++;
+	return retVal;
+}
 
-	if( !cxa_stringUtils_startsWith(lineIn, contentLenStr) ) return false;
 
-	// if we made it here, we got the right line...parse it
-	char* save_ptr;
-	char* currToken = strtok_r(lineIn, " ", &save_ptr);
-	if( currToken == NULL ) return false;
+static const char* getMethodString(cxa_network_httpClient_method_t methodIn)
+{
+	switch( methodIn )
+	{
+		case CXA_NETWORK_HTTPCLIENT_METHOD_GET:
+			return "GET";
 
-	// one more tokenization should give us the value
-	currToken = strtok_r(NULL, " ", &save_ptr);
-	if( currToken == NULL ) return false;
+		case CXA_NETWORK_HTTPCLIENT_METHOD_PUT:
+			return "PUT";
 
-	long contentLength = strtol(currToken, NULL, 10);
+		case CXA_NETWORK_HTTPCLIENT_METHOD_POST:
+			return "POST";
+	}
+	return "";
+}
 
-	if( contentLength_bytesOut != NULL ) *contentLength_bytesOut = (size_t)contentLength;
+
+static cxa_network_httpClient_connection_t* getConnectionForRequest(cxa_network_httpClient_t *const netClientIn, bool *const isReusedOut)
+{
+	cxa_assert(netClientIn);
+	cxa_assert(isReusedOut);
+
+	// first preference is an open connection to the same server
+	for( size_t i = 0; i < netClientIn->numConnections; i++ )
+	{
+		cxa_network_httpClient_connection_t* currConn = &netClientIn->connections[i];
+
+		if( cxa_network_tcpClient_isConnected(currConn->tcpClient) && currConn->isReusable &&
+			(currConn->portNum == netClientIn->portNum) && (currConn->useTls == netClientIn->useTls) &&
+			cxa_stringUtils_equals(currConn->hostname, netClientIn->hostname) )
+		{
+			*isReusedOut = true;
+			return currConn;
+		}
+	}
+	*isReusedOut = false;
+
+	// next is an unused connection
+	for( size_t i = 0; i < netClientIn->numConnections; i++ )
+	{
+		cxa_network_httpClient_connection_t* currConn = &netClientIn->connections[i];
+		if( !cxa_network_tcpClient_isConnected(currConn->tcpClient) ) return currConn;
+	}
+
+	// otherwise, close the connection which has been idle the longest
+	cxa_network_httpClient_connection_t* retVal = &netClientIn->connections[0];
+	for( size_t i = 1; i < netClientIn->numConnections; i++ )
+	{
+		cxa_network_httpClient_connection_t* currConn = &netClientIn->connections[i];
+		if( cxa_timeDiff_getElapsedTime_ms(&currConn->td_idle) > cxa_timeDiff_getElapsedTime_ms(&retVal->td_idle) ) retVal = currConn;
+	}
+	cxa_logger_debug(&netClientIn->logger, "closing idle connection to %s:%d", retVal->hostname, retVal->portNum);
+	closeConnection(retVal);
+
+	return retVal;
+}
+
+
+static void closeConnection(cxa_network_httpClient_connection_t *const connIn)
+{
+	cxa_assert(connIn);
+
+	connIn->isReusable = false;
+	cxa_protocolParser_crlf_pause(&connIn->headerLineParser);
+	if( cxa_network_tcpClient_isConnected(connIn->tcpClient) ) cxa_network_tcpClient_disconnect(connIn->tcpClient);
+
+	// don't let anything from this connection leak into the next one
+	discardRxBytes(connIn);
+}
+
+
+static void discardRxBytes(cxa_network_httpClient_connection_t *const connIn)
+{
+	cxa_assert(connIn);
+
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	if( cxa_protocolParser_peekRxBytes(&connIn->headerLineParser.super, &rxBytes, &numRxBytes) == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		cxa_protocolParser_consumeRxBytes(&connIn->headerLineParser.super, numRxBytes);
+	}
+}
+
+
+static void startResponseBody(cxa_network_httpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	// informational responses are followed by the real response
+	if( (netClientIn->responseStatusCode >= 100) && (netClientIn->responseStatusCode < 200) )
+	{
+		cxa_logger_debug(&netClientIn->logger, "informational response, waiting for final status");
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_STATUS_CODE);
+		return;
+	}
+
+	// reset our response body buffer
+	netClientIn->responseBody_currSize_bytes = 0;
+	if( netClientIn->responseBodyBuffer != NULL ) netClientIn->responseBodyBuffer[0] = 0;
+
+	if( (netClientIn->responseStatusCode == 204) || (netClientIn->responseStatusCode == 304) ||
+		(!netClientIn->isResponseChunked && netClientIn->hasResponseContentLength && (netClientIn->responseContentLength_bytes == 0)) )
+	{
+		cxa_logger_debug(&netClientIn->logger, "no body");
+		finishTransaction(netClientIn, true);
+		return;
+	}
+
+	if( netClientIn->isResponseChunked )
+	{
+		// parser stays running for the chunk size line
+		cxa_logger_debug(&netClientIn->logger, "expecting chunked body");
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_CHUNK_SIZE);
+		return;
+	}
+
+	if( netClientIn->hasResponseContentLength )
+	{
+		cxa_logger_debug(&netClientIn->logger, "expecting body of %d bytes", netClientIn->responseContentLength_bytes);
+		netClientIn->responseRemaining_bytes = netClientIn->responseContentLength_bytes;
+	}
+	else
+	{
+		// no way to tell where the body ends except for the server closing the connection
+		cxa_logger_debug(&netClientIn->logger, "expecting body until close");
+		netClientIn->isResponseUntilClose = true;
+		netClientIn->currConnection->isReusable = false;
+	}
+
+	// body bytes are read directly from the parser's receive buffer
+	cxa_protocolParser_crlf_pause(&netClientIn->currConnection->headerLineParser);
+	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_BODY);
+}
+
+
+static bool deliverBodyBytes(cxa_network_httpClient_t *const netClientIn, uint8_t *const bytesIn, size_t numBytesIn)
+{
+	cxa_assert(netClientIn);
+
+	if( netClientIn->cbs.responseData != NULL )
+	{
+		netClientIn->cbs.responseData(netClientIn, netClientIn->responseStatusCode, bytesIn, numBytesIn, netClientIn->cbs.userVar);
+	}
+	else if( netClientIn->responseBodyBuffer != NULL )
+	{
+		// make sure we won't overflow (-1 is for null term)
+		if( (netClientIn->responseBody_currSize_bytes + numBytesIn) > (netClientIn->responseBody_maxSize_bytes-1) )
+		{
+			cxa_logger_warn(&netClientIn->logger, "body too big for response buffer");
+			return false;
+		}
+
+		// null term our body for ease-of-use
+		memcpy(&netClientIn->responseBodyBuffer[netClientIn->responseBody_currSize_bytes], bytesIn, numBytesIn);
+		netClientIn->responseBodyBuffer[netClientIn->responseBody_currSize_bytes + numBytesIn] = 0;
+	}
+	netClientIn->responseBody_currSize_bytes += numBytesIn;
 
 	return true;
 }
 
 
+static void handleConnectionLost(cxa_network_httpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	switch( cxa_stateMachine_getCurrentState(&netClientIn->stateMachine) )
+	{
+		case STATE_IDLE:
+		case STATE_TRANSACTION_ERROR:
+			// do nothing
+			break;
+
+		case STATE_CONNECTED_READ_BODY:
+			if( netClientIn->isResponseUntilClose )
+			{
+				cxa_logger_debug(&netClientIn->logger, "done reading body (%d bytes)", netClientIn->responseBody_currSize_bytes);
+				finishTransaction(netClientIn, true);
+				break;
+			}
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			break;
+
+		default:
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			break;
+	}
+}
+
+
+static void finishTransaction(cxa_network_httpClient_t *const netClientIn, bool wasSuccessfulIn)
+{
+	cxa_assert(netClientIn);
+
+	// clear this first (closing our connection can notify synchronously)
+	cxa_network_httpClient_connection_t* conn = netClientIn->currConnection;
+	netClientIn->currConnection = NULL;
+
+	if( conn != NULL )
+	{
+		if( wasSuccessfulIn && netClientIn->keepOpen && conn->isReusable && cxa_network_tcpClient_isConnected(conn->tcpClient) )
+		{
+			cxa_logger_debug(&netClientIn->logger, "keeping connection to %s:%d open", conn->hostname, conn->portNum);
+			cxa_protocolParser_crlf_pause(&conn->headerLineParser);
+			cxa_timeDiff_setStartTime_now(&conn->td_idle);
+		}
+		else closeConnection(conn);
+	}
+
+	// transition first so a new request can be started from our callback
+	netClientIn->isBusy = false;
+	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_IDLE);
+
+	if( netClientIn->cbs.postComplete != NULL )
+	{
+		if( wasSuccessfulIn )
+		{
+			netClientIn->cbs.postComplete(netClientIn, true, netClientIn->responseStatusCode,
+										  (netClientIn->cbs.responseData == NULL) ? (char*)netClientIn->responseBodyBuffer : NULL,
+										  netClientIn->responseBody_currSize_bytes, netClientIn->cbs.userVar);
+		}
+		else netClientIn->cbs.postComplete(netClientIn, false, 0, NULL, 0, netClientIn->cbs.userVar);
+	}
+}
+
+
 static void stateCb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
 {
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	state_t currState = cxa_stateMachine_getCurrentState(&netClientIn->stateMachine);
+	cxa_logger_debug(&netClientIn->logger, "idle");
+}
+
 
-	// see if we need to disconnect
-	if( (currState == STATE_IDLE_DISCONNECTED) && cxa_network_tcpClient_isConnected(netClientIn->tcpClient) )
+static void stateCb_idle_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	// close any pooled connections which have been idle too long
+	for( size_t i = 0; i < netClientIn->numConnections; i++ )
 	{
-		cxa_network_tcpClient_disconnect(netClientIn->tcpClient);
-	}
+		cxa_network_httpClient_connection_t* currConn = &netClientIn->connections[i];
 
-	cxa_logger_debug(&netClientIn->logger, "idle (%s)",
-					(currState == STATE_IDLE_CONNECTED) ?
-					"connected" : "disconnected");
+		if( cxa_network_tcpClient_isConnected(currConn->tcpClient) &&
+			cxa_timeDiff_isElapsed_ms(&currConn->td_idle, CXA_NETWORK_HTTPCLIENT_KEEPALIVE_TIMEOUT_MS) )
+		{
+			cxa_logger_debug(&netClientIn->logger, "closing idle connection to %s:%d", currConn->hostname, currConn->portNum);
+			closeConnection(currConn);
+		}
+	}
 }
 
 
@@ -223,8 +520,23 @@ static void stateCb_connecting_enter(cxa_stateMachine_t *const smIn, int prevSta
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
+	cxa_network_httpClient_connection_t* conn = getConnectionForRequest(netClientIn, &netClientIn->isCurrConnectionReused);
+	netClientIn->currConnection = conn;
+
+	if( netClientIn->isCurrConnectionReused )
+	{
+		cxa_logger_info(&netClientIn->logger, "reusing connection to %s::%d", conn->hostname, conn->portNum);
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_SEND_DEFAULT_HEADERS);
+		return;
+	}
+
+	cxa_assert(cxa_stringUtils_copy(conn->hostname, netClientIn->hostname, sizeof(conn->hostname)));
+	conn->portNum = netClientIn->portNum;
+	conn->useTls = netClientIn->useTls;
+	conn->isReusable = false;
+
 	cxa_logger_info(&netClientIn->logger, "connecting to %s::%d", netClientIn->hostname, netClientIn->portNum);
-	if( !cxa_network_tcpClient_connectToHost(netClientIn->tcpClient, netClientIn->hostname, netClientIn->portNum, netClientIn->useTls, netClientIn->timeout_ms) )
+	if( !cxa_network_tcpClient_connectToHost(conn->tcpClient, netClientIn->hostname, netClientIn->portNum, netClientIn->useTls, netClientIn->timeout_ms) )
 	{
 		cxa_logger_warn(&netClientIn->logger, "error initiating connection");
 		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
@@ -242,12 +554,33 @@ static void stateCb_sendDefaultHeaders_enter(cxa_stateMachine_t *const smIn, int
 
 	cxa_logger_debug(&netClientIn->logger, "connected, sending default headers");
 
-	cxa_ioStream_t* ios = cxa_network_tcpClient_getIoStream(netClientIn->tcpClient);
+	// the entire request is buffered and sent in as few writes as possible
+	cxa_ioStream_buffered_initStd(&netClientIn->ios_tx, cxa_network_tcpClient_getIoStream(netClientIn->currConnection->tcpClient), netClientIn->ios_tx_raw);
+	cxa_ioStream_t* ios = &netClientIn->ios_tx.super;
 
-	cxa_ioStream_writeFormattedLine(ios, "POST %s HTTP/1.1", netClientIn->url);
-	cxa_ioStream_writeFormattedLine(ios, "Host: %s", netClientIn->hostname);
-	cxa_ioStream_writeLine(ios, "Content-Type: application/json");
+	// url may be too long for a formatted line
+	cxa_ioStream_writeString(ios, getMethodString(netClientIn->method));
+	cxa_ioStream_writeString(ios, " ");
+	cxa_ioStream_writeString(ios, netClientIn->url);
+	cxa_ioStream_writeLine(ios, " HTTP/1.1");
+	cxa_ioStream_writeString(ios, "Host: ");
+	cxa_ioStream_writeLine(ios, netClientIn->hostname);
+	if( !netClientIn->keepOpen ) cxa_ioStream_writeLine(ios, "Connection: close");
 
+	if( !netClientIn->hasRequestBody )
+	{
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_GEN_USER_HEADERS);
+		return;
+	}
+
+	cxa_ioStream_writeLine(ios, "Content-Type: application/json");
+	if( netClientIn->sendChunked )
+	{
+		// no need to calculate our body size ahead of time
+		cxa_ioStream_writeLine(ios, "Transfer-Encoding: chunked");
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_GEN_USER_HEADERS);
+		return;
+	}
 	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_CALC_USER_BODY);
 }
 
@@ -257,7 +590,7 @@ static void stateCb_genUserHeaders_state(cxa_stateMachine_t *const smIn, void *u
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	cxa_ioStream_t* ios = cxa_network_tcpClient_getIoStream(netClientIn->tcpClient);
+	cxa_ioStream_t* ios = &netClientIn->ios_tx.super;
 
 	cxa_logger_debug(&netClientIn->logger, "generating user headers (if any)");
 	bool askAgain = (netClientIn->cbs.genHeaders != NULL) ?
@@ -289,13 +622,14 @@ static void stateCb_genUserBody_enter(cxa_stateMachine_t *const smIn, int prevSt
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	cxa_logger_debug(&netClientIn->logger, "generating user body size (2nd pass)");
+	cxa_logger_debug(&netClientIn->logger, "generating user body");
 
-	cxa_ioStream_t* ios = cxa_network_tcpClient_getIoStream(netClientIn->tcpClient);
+	cxa_ioStream_t* ios = &netClientIn->ios_tx.super;
 
 	// make our body generation stream nonnull so we actually generate and send the body
 	cxa_ioStream_nullablePassthrough_setNullableStream(&netClientIn->ios_bodyGeneration, ios);
 	cxa_ioStream_nullablePassthrough_resetNumByesWritten(&netClientIn->ios_bodyGeneration);
+	netClientIn->chunkBuffer_currSize_bytes = 0;
 
 	// need to send our end-of-header
 	cxa_ioStream_writeString(ios, "\r\n");
@@ -307,28 +641,44 @@ static void stateCb_xxxUserBody_state(cxa_stateMachine_t *const smIn, void *user
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	cxa_ioStream_t* ios = cxa_ioStream_nullablePassthrough_getNonullStream(&netClientIn->ios_bodyGeneration);
+	state_t currState = cxa_stateMachine_getCurrentState(&netClientIn->stateMachine);
+	cxa_ioStream_t* ios = (netClientIn->sendChunked && (currState == STATE_CONNECTED_GEN_USER_BODY)) ?
+						  &netClientIn->ios_chunkedBody :
+						  cxa_ioStream_nullablePassthrough_getNonullStream(&netClientIn->ios_bodyGeneration);
 
-	bool askAgain = (netClientIn->cbs.genBody != NULL) ?
+	bool askAgain = (netClientIn->hasRequestBody && (netClientIn->cbs.genBody != NULL)) ?
 					 netClientIn->cbs.genBody(netClientIn, ios, netClientIn->cbs.userVar) :
 					 false;
 
 	if( !askAgain )
 	{
 		// we're done...where we go now depends on our state
-		if( cxa_stateMachine_getCurrentState(&netClientIn->stateMachine) == STATE_CONNECTED_CALC_USER_BODY )
+		if( currState == STATE_CONNECTED_CALC_USER_BODY )
 		{
 			// write our content length
-			ios = cxa_network_tcpClient_getIoStream(netClientIn->tcpClient);
 			size_t numBytes = cxa_ioStream_nullablePassthrough_getNumBytesWritten(&netClientIn->ios_bodyGeneration);
 			cxa_logger_debug(&netClientIn->logger, "user body size is %d bytes", numBytes);
-			cxa_ioStream_writeFormattedLine(ios, "Content-Length: %d", numBytes);
+			cxa_ioStream_writeFormattedLine(&netClientIn->ios_tx.super, "Content-Length: %d", numBytes);
 			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_GEN_USER_HEADERS);
+			return;
 		}
-		else
+
+		if( netClientIn->sendChunked )
 		{
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_STATUS_CODE);
+			flushChunkBuffer(netClientIn);
+			cxa_ioStream_writeString(&netClientIn->ios_tx.super, "0\r\n\r\n");
 		}
+		if( !cxa_ioStream_buffered_flush(&netClientIn->ios_tx) )
+		{
+			cxa_logger_warn(&netClientIn->logger, "error sending request");
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			return;
+		}
+		netClientIn->isRequestSent = true;
+
+		// turn on our header parser
+		cxa_protocolParser_crlf_resume(&netClientIn->currConnection->headerLineParser);
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_STATUS_CODE);
 	}
 }
 
@@ -341,8 +691,12 @@ static void stateCb_parseStatusCode_enter(cxa_stateMachine_t *const smIn, int pr
 	cxa_logger_debug(&netClientIn->logger, "waiting for status code");
 	cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
 
-	// turn on our header parser
-	cxa_protocolParser_crlf_resume(&netClientIn->headerLineParser);
+	// reset what we know about the response
+	netClientIn->hasResponseContentLength = false;
+	netClientIn->isResponseChunked = false;
+	netClientIn->isResponseUntilClose = false;
+	netClientIn->responseContentLength_bytes = 0;
+	netClientIn->responseRemaining_bytes = 0;
 
 	// wait for protocol parser callbacks
 }
@@ -362,144 +716,64 @@ static void stateCb_xxxCheckTimeout_state(cxa_stateMachine_t *const smIn, void *
 }
 
 
-
-static void stateCb_parseContentLength_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
-{
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
-
-	cxa_logger_debug(&netClientIn->logger, "waiting for content length");
-	cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
-
-	// header parser should still be on at this point
-	// wait for protocol parser callbacks
-}
-
-
-static void stateCb_forwardToBody_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
-{
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
-
-	cxa_logger_debug(&netClientIn->logger, "waiting for start of body");
-	cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
-
-	// wait for protocol parser callbacks
-}
-
-
-static void stateCb_readBody_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
-{
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
-
-	// reset our response body buffer
-	netClientIn->responseBody_currSize_bytes = 0;
-	if(netClientIn->responseBodyBuffer != NULL) memset(netClientIn->responseBodyBuffer, 0, netClientIn->responseBody_maxSize_bytes);
-	cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
-
-	cxa_logger_debug(&netClientIn->logger, "expecting body of %d bytes", netClientIn->responseContentLength_bytes);
-
-	// make sure we have a body to receive
-	if( netClientIn->responseContentLength_bytes == 0 )
-	{
-		cxa_logger_debug(&netClientIn->logger, "done reading body");
-		cxa_stateMachine_transition(&netClientIn->stateMachine, netClientIn->keepOpen ? STATE_IDLE_CONNECTED : STATE_IDLE_DISCONNECTED);
-		return;
-	}
-}
-
-
 static void stateCb_readBody_state(cxa_stateMachine_t *const smIn, void *userVarIn)
 {
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	for( int i = 0; i < MAXNUM_RX_BYTES_PER_ITERATION; i++ )
+	cxa_network_httpClient_connection_t* conn = netClientIn->currConnection;
+	cxa_assert(conn);
+
+	for( int i = 0; i < MAXNUM_RX_CHUNKS_PER_ITERATION; i++ )
 	{
-		uint8_t rxByte;
-		cxa_ioStream_readStatus_t readState = cxa_ioStream_readByte(cxa_network_tcpClient_getIoStream(netClientIn->tcpClient), &rxByte);
+		// bytes after the headers are already sitting in the parser's buffer
+		uint8_t* rxBytes;
+		size_t numRxBytes;
+		cxa_ioStream_readStatus_t readState = cxa_protocolParser_peekRxBytes(&conn->headerLineParser.super, &rxBytes, &numRxBytes);
 		if( readState == CXA_IOSTREAM_READSTAT_ERROR )
 		{
-			cxa_logger_warn(&netClientIn->logger, "error reading body");
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			// disconnect may have been handled already (during the read)
+			if( netClientIn->currConnection == conn ) handleConnectionLost(netClientIn);
 			return;
 		}
-		else if( readState == CXA_IOSTREAM_READSTAT_GOTDATA )
-		{
-			// reset our reception timeout
-			cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
+		else if( readState != CXA_IOSTREAM_READSTAT_GOTDATA ) break;
 
-			// store to our buffer if we have one
-			if( netClientIn->responseBodyBuffer != NULL )
-			{
-				netClientIn->responseBodyBuffer[netClientIn->responseBody_currSize_bytes] = rxByte;
-			}
-			netClientIn->responseBody_currSize_bytes++;
-
-			// see if we're done
-			if( netClientIn->responseBody_currSize_bytes == netClientIn->responseContentLength_bytes )
-			{
-				// we're done!
-				cxa_logger_debug(&netClientIn->logger, "done reading body (%d bytes) %d", netClientIn->responseBody_currSize_bytes);
-
-				// null term our body for ease-of-use
-				if( netClientIn->responseBodyBuffer != NULL ) netClientIn->responseBodyBuffer[netClientIn->responseBody_currSize_bytes] = '\0';
+		// reset our reception timeout
+		cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
 
-				// call our callback (if any)
-				if( netClientIn->cbs.postComplete != NULL )
-				{
-					netClientIn->cbs.postComplete(netClientIn, true, netClientIn->responseStatusCode, (char*)netClientIn->responseBodyBuffer, netClientIn->responseBody_currSize_bytes, netClientIn->cbs.userVar);
-				}
+		if( !netClientIn->isResponseUntilClose && (numRxBytes > netClientIn->responseRemaining_bytes) ) numRxBytes = netClientIn->responseRemaining_bytes;
+		cxa_protocolParser_consumeRxBytes(&conn->headerLineParser.super, numRxBytes);
 
-				// move on
-				cxa_stateMachine_transition(&netClientIn->stateMachine, netClientIn->keepOpen ? STATE_IDLE_CONNECTED : STATE_IDLE_DISCONNECTED);
-				return;
-			}
-			// if we made it here, we've got more bytes to receive
+		if( !deliverBodyBytes(netClientIn, rxBytes, numRxBytes) )
+		{
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			return;
+		}
+		if( netClientIn->isResponseUntilClose ) continue;
 
-			// make sure we won't overflow (-1 is for null term)
-			if( (netClientIn->responseBodyBuffer != NULL) &&
-				(netClientIn->responseBody_currSize_bytes >= (netClientIn->responseBody_maxSize_bytes-1)) )
+		// see if we're done (with the body or the current chunk)
+		netClientIn->responseRemaining_bytes -= numRxBytes;
+		if( netClientIn->responseRemaining_bytes == 0 )
+		{
+			if( netClientIn->isResponseChunked )
 			{
-				cxa_logger_warn(&netClientIn->logger, "body too big for response buffer");
-				cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+				cxa_protocolParser_crlf_resume(&conn->headerLineParser);
+				cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_CHUNK_SIZE);
 				return;
 			}
-		}
 
-		// check our body reception timeout
-		if( cxa_timeDiff_isElapsed_ms(&netClientIn->td_receptionTimeout, netClientIn->timeout_ms) )
-		{
-			cxa_logger_warn(&netClientIn->logger, "body reception timeout");
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+			cxa_logger_debug(&netClientIn->logger, "done reading body (%d bytes)", netClientIn->responseBody_currSize_bytes);
+			finishTransaction(netClientIn, true);
 			return;
 		}
 	}
-}
-
-
-static void stateCb_waitDisconnect_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
-{
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
 
-	cxa_logger_debug(&netClientIn->logger, "waiting for disconnect");
-
-	// disconnect if we're connected
-	if( cxa_network_tcpClient_isConnected(netClientIn->tcpClient) ) cxa_network_tcpClient_disconnect(netClientIn->tcpClient);
-}
-
-
-static void stateCb_waitDisconnect_state(cxa_stateMachine_t *const smIn, void *userVarIn)
-{
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
-
-	// transition can happen here OR in tcpClient callback
-	if( cxa_network_tcpClient_isConnected(netClientIn->tcpClient) )
+	// check our body reception timeout
+	if( cxa_timeDiff_isElapsed_ms(&netClientIn->td_receptionTimeout, netClientIn->timeout_ms) )
 	{
-		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_IDLE_DISCONNECTED);
+		cxa_logger_warn(&netClientIn->logger, "body reception timeout");
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+		return;
 	}
 }
 
@@ -509,17 +783,34 @@ static void stateCb_transactionError_enter(cxa_stateMachine_t *const smIn, int p
 	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	if( netClientIn->cbs.postComplete != NULL )
+	// a pooled connection may have been closed by the server while idle...try once more on a new connection.
+	// once a non-idempotent request has gone out the server may have acted on it, so that's up to the caller
+	bool isRetrySafe = (netClientIn->method == CXA_NETWORK_HTTPCLIENT_METHOD_GET) || !netClientIn->isRequestSent;
+	if( netClientIn->isCurrConnectionReused && !netClientIn->hasRetried && (netClientIn->responseStatusCode == 0) && isRetrySafe )
 	{
-		netClientIn->cbs.postComplete(netClientIn, false, 0, NULL, 0, netClientIn->cbs.userVar);
+		cxa_logger_info(&netClientIn->logger, "reused connection failed, retrying");
+
+		cxa_network_httpClient_connection_t* conn = netClientIn->currConnection;
+		netClientIn->currConnection = NULL;
+		if( conn != NULL ) closeConnection(conn);
+
+		netClientIn->hasRetried = true;
+		netClientIn->isRequestSent = false;
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTING);
+		return;
 	}
+
+	finishTransaction(netClientIn, false);
 }
 
 
 static void cb_tcpClient_onConnect(cxa_network_tcpClient_t *const superIn, void* userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
+	cxa_network_httpClient_t *const netClientIn = connIn->parent;
+
+	if( netClientIn->currConnection != connIn ) return;
 
 	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_SEND_DEFAULT_HEADERS);
 }
@@ -527,8 +818,11 @@ static void cb_tcpClient_onConnect(cxa_network_tcpClient_t *const superIn, void*
 
 static void cb_tcpClient_onConnectFail(cxa_network_tcpClient_t *const tcpClientIn, void* userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
+	cxa_network_httpClient_t *const netClientIn = connIn->parent;
+
+	if( netClientIn->currConnection != connIn ) return;
 
 	cxa_logger_debug(&netClientIn->logger, "connection failed");
 	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
@@ -537,115 +831,205 @@ static void cb_tcpClient_onConnectFail(cxa_network_tcpClient_t *const tcpClientI
 
 static void cb_tcpClient_onDisconnect(cxa_network_tcpClient_t *const superIn, void* userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
+	cxa_network_httpClient_t *const netClientIn = connIn->parent;
 
-	switch( cxa_stateMachine_getCurrentState(&netClientIn->stateMachine) )
+	if( netClientIn->currConnection != connIn )
 	{
-		case STATE_IDLE_DISCONNECTED:
-			// do nothing
-			break;
-
-		case STATE_WAIT_DISCONNECT:
-		case STATE_TRANSACTION_ERROR:
-		case STATE_IDLE_CONNECTED:
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_IDLE_DISCONNECTED);
-			break;
-
-		case STATE_CONNECTING:
-		case STATE_CONNECTED_SEND_DEFAULT_HEADERS:
-		case STATE_CONNECTED_CALC_USER_BODY:
-		case STATE_CONNECTED_GEN_USER_HEADERS:
-		case STATE_CONNECTED_GEN_USER_BODY:
-		case STATE_CONNECTED_PARSE_STATUS_CODE:
-		case STATE_CONNECTED_PARSE_CONTENT_LENGTH:
-		case STATE_CONNECTED_FORWARD_TO_BODY:
-		case STATE_CONNECTED_READ_BODY:
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
-			break;
+		// one of our pooled connections
+		cxa_logger_debug(&netClientIn->logger, "connection to %s:%d closed", connIn->hostname, connIn->portNum);
+		connIn->isReusable = false;
+		discardRxBytes(connIn);
+		return;
 	}
+
+	handleConnectionLost(netClientIn);
 }
 
 
 static void cb_headerParser_onIoException(void *const userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
+	cxa_network_httpClient_t *const netClientIn = connIn->parent;
+
+	if( netClientIn->currConnection != connIn ) return;
 
 	cxa_logger_warn(&netClientIn->logger, "ioException");
-	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
+	handleConnectionLost(netClientIn);
 }
 
 
 static void cb_headerParser_onReceptionTimeout(cxa_fixedByteBuffer_t *const incompletePacketIn, void *const userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
 
-	cxa_logger_warn(&netClientIn->logger, "reception timeout");
+	cxa_logger_warn(&connIn->parent->logger, "reception timeout");
 //	cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
 }
 
 
 static void cb_headerParser_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
 {
-	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
-	cxa_assert(netClientIn);
+	cxa_network_httpClient_connection_t *const connIn = (cxa_network_httpClient_connection_t*)userVarIn;
+	cxa_assert(connIn);
+	cxa_network_httpClient_t *const netClientIn = connIn->parent;
+
+	if( netClientIn->currConnection != connIn ) return;
 
 	state_t currState = cxa_stateMachine_getCurrentState(&netClientIn->stateMachine);
 	char *const currLine = (char *const)cxa_fixedByteBuffer_get_pointerToIndex(packetIn, 0);
 
 	cxa_logger_trace(&netClientIn->logger, "rx header: '%s'", currLine);
+	cxa_timeDiff_setStartTime_now(&netClientIn->td_receptionTimeout);
 
 	if( currState == STATE_CONNECTED_PARSE_STATUS_CODE )
 	{
+		// HTTP/1.1 connections are persistent unless the server says otherwise
+		connIn->isReusable = cxa_stringUtils_startsWith(currLine, "HTTP/1.1");
+
 		// we've received the line that should contain the status code...now try to parse the status code
 		uint16_t statusCode;
 		if( parseStatusCodeFromString(currLine, &statusCode) )
 		{
 			netClientIn->responseStatusCode = statusCode;
 			cxa_logger_debug(&netClientIn->logger, "got status code: %d", netClientIn->responseStatusCode);
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_CONTENT_LENGTH);
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_PARSE_HEADERS);
 			return;
 		}
 		else
 		{
 			// status code MUST be the first line received from the server...
 			cxa_logger_warn(&netClientIn->logger, "invalid status line received");
-			cxa_protocolParser_crlf_pause(&netClientIn->headerLineParser);
+			cxa_protocolParser_crlf_pause(&connIn->headerLineParser);
 			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
 			return;
 		}
 	}
-	else if( currState == STATE_CONNECTED_PARSE_CONTENT_LENGTH )
+	else if( currState == STATE_CONNECTED_PARSE_HEADERS )
 	{
-		// always look for end of headers
+		// end of headers
 		if( strlen(currLine) == 0 )
 		{
-			cxa_logger_warn(&netClientIn->logger, "end of headers before content length received");
-			cxa_protocolParser_crlf_pause(&netClientIn->headerLineParser);
+			startResponseBody(netClientIn);
+			return;
+		}
+
+		char* value;
+		if( (value = getHeaderValue(currLine, "Content-Length")) != NULL )
+		{
+			netClientIn->hasResponseContentLength = true;
+			netClientIn->responseContentLength_bytes = (size_t)strtoul(value, NULL, 10);
+		}
+		else if( (value = getHeaderValue(currLine, "Transfer-Encoding")) != NULL )
+		{
+			netClientIn->isResponseChunked = cxa_stringUtils_contains(value, "chunked");
+		}
+		else if( (value = getHeaderValue(currLine, "Connection")) != NULL )
+		{
+			if( cxa_stringUtils_equals_ignoreCase(value, "close") ) connIn->isReusable = false;
+			else if( cxa_stringUtils_equals_ignoreCase(value, "keep-alive") ) connIn->isReusable = true;
+		}
+	}
+	else if( currState == STATE_CONNECTED_READ_CHUNK_SIZE )
+	{
+		// skip the CRLF which ends the previous chunk's data
+		if( strlen(currLine) == 0 ) return;
+
+		// ignore any chunk extensions
+		char* endPtr;
+		unsigned long chunkSize_bytes = strtoul(currLine, &endPtr, 16);
+		if( (endPtr == currLine) || ((*endPtr != '\0') && (*endPtr != ';') && (*endPtr != ' ')) )
+		{
+			cxa_logger_warn(&netClientIn->logger, "invalid chunk size received");
+			cxa_protocolParser_crlf_pause(&connIn->headerLineParser);
 			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_TRANSACTION_ERROR);
 			return;
 		}
 
-		// see if we can parse the content length from this line...
-		size_t contentLength_bytes;
-		if( parseContentLengthFromString(currLine, &contentLength_bytes) )
+		if( chunkSize_bytes == 0 )
 		{
-			netClientIn->responseContentLength_bytes = contentLength_bytes;
-			cxa_logger_debug(&netClientIn->logger, "expecting %d bytes", netClientIn->responseContentLength_bytes);
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_FORWARD_TO_BODY);
+			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_TRAILERS);
 			return;
 		}
+
+		netClientIn->responseRemaining_bytes = chunkSize_bytes;
+		cxa_protocolParser_crlf_pause(&connIn->headerLineParser);
+		cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_BODY);
 	}
-	else if( currState == STATE_CONNECTED_FORWARD_TO_BODY )
+	else if( currState == STATE_CONNECTED_READ_TRAILERS )
 	{
+		// trailers are ignored...a blank line ends the response
 		if( strlen(currLine) == 0 )
 		{
-			// looking for crlf line
-			cxa_protocolParser_crlf_pause(&netClientIn->headerLineParser);
-			cxa_stateMachine_transition(&netClientIn->stateMachine, STATE_CONNECTED_READ_BODY);
-			return;
+			cxa_logger_debug(&netClientIn->logger, "done reading chunked body (%d bytes)", netClientIn->responseBody_currSize_bytes);
+			finishTransaction(netClientIn, true);
 		}
 	}
 }
+
+
+static cxa_ioStream_readStatus_t cb_chunkedBody_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	// body generation is write-only
+	return CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
+static bool cb_chunkedBody_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	cxa_network_httpClient_t *const netClientIn = (cxa_network_httpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	// a zero-length chunk would end our body
+	if( bufferSize_bytesIn == 0 ) return true;
+
+	// writes too big to stage go out as their own chunk (without copying the data)
+	if( bufferSize_bytesIn >= sizeof(netClientIn->chunkBuffer) )
+	{
+		return flushChunkBuffer(netClientIn) && writeChunk(netClientIn, buffIn, bufferSize_bytesIn);
+	}
+
+	// otherwise collect them until we have a full chunk
+	size_t numFree_bytes = sizeof(netClientIn->chunkBuffer) - netClientIn->chunkBuffer_currSize_bytes;
+	size_t numToCopy_bytes = (bufferSize_bytesIn < numFree_bytes) ? bufferSize_bytesIn : numFree_bytes;
+	memcpy(&netClientIn->chunkBuffer[netClientIn->chunkBuffer_currSize_bytes], buffIn, numToCopy_bytes);
+	netClientIn->chunkBuffer_currSize_bytes += numToCopy_bytes;
+	if( netClientIn->chunkBuffer_currSize_bytes < sizeof(netClientIn->chunkBuffer) ) return true;
+
+	if( !flushChunkBuffer(netClientIn) ) return false;
+	memcpy(netClientIn->chunkBuffer, &((uint8_t*)buffIn)[numToCopy_bytes], bufferSize_bytesIn - numToCopy_bytes);
+	netClientIn->chunkBuffer_currSize_bytes = bufferSize_bytesIn - numToCopy_bytes;
+
+	return true;
+}
+
+
+static bool flushChunkBuffer(cxa_network_httpClient_t *const netClientIn)
+{
+	cxa_assert(netClientIn);
+
+	if( netClientIn->chunkBuffer_currSize_bytes == 0 ) return true;
+
+	size_t numBytes = netClientIn->chunkBuffer_currSize_bytes;
+	netClientIn->chunkBuffer_currSize_bytes = 0;
+	return writeChunk(netClientIn, netClientIn->chunkBuffer, numBytes);
+}
+
+
+static bool writeChunk(cxa_network_httpClient_t *const netClientIn, void* buffIn, size_t bufferSize_bytesIn)
+{
+	cxa_assert(netClientIn);
+
+	char chunkHeader[12];
+	snprintf(chunkHeader, sizeof(chunkHeader), "%X\r\n", (unsigned int)bufferSize_bytesIn);
+
+	cxa_ioStream_ioVec_t vecs[] = {
+		{ .buff = chunkHeader, .bufferSize_bytes = strlen(chunkHeader) },
+		{ .buff = buffIn, .bufferSize_bytes = bufferSize_bytesIn },
+		{ .buff = "\r\n", .bufferSize_bytes = 2 },
+	};
+	return cxa_ioStream_writeVectored(&netClientIn->ios_tx.super, vecs, sizeof(vecs)/sizeof(*vecs));
+}
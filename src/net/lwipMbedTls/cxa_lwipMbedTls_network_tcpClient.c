@@ -56,7 +56,10 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 static void stateCb_connected_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn);
 static void stateCb_connectFail_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 
+static cxa_ioStream_readStatus_t sslRead(cxa_lwipMbedTls_network_tcpClient_t *const netClientIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
+
 static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
@@ -76,6 +79,8 @@ void cxa_lwipMbedTls_network_tcpClient_init(cxa_lwipMbedTls_network_tcpClient_t
 	netClientIn->targetHostName[0] = 0;
 	netClientIn->targetPortNum[0] = 0;
 	netClientIn->useClientCert = false;
+	netClientIn->rxBuffer_numBytes = 0;
+	netClientIn->rxBuffer_readIndex = 0;
 
 	cxa_timeDiff_init(&netClientIn->td_writeTimeout);
 
@@ -444,8 +449,11 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 		return;
 	}
 
-	// bind our ioStream
+	// bind our ioStream (with an empty receive buffer)
+	netClientIn->rxBuffer_numBytes = 0;
+	netClientIn->rxBuffer_readIndex = 0;
 	cxa_ioStream_bind(&netClientIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)netClientIn);
+	cxa_ioStream_bindReadBytes(&netClientIn->super.ioStream, cb_ioStream_readBytes);
 
 	cxa_logger_trace(&netClientIn->super.logger, "connected");
 
@@ -492,12 +500,12 @@ static void stateCb_connectFail_enter(cxa_stateMachine_t *const smIn, int prevSt
 }
 
 
-static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+static cxa_ioStream_readStatus_t sslRead(cxa_lwipMbedTls_network_tcpClient_t *const netClientIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
 {
-	cxa_lwipMbedTls_network_tcpClient_t* netClientIn = (cxa_lwipMbedTls_network_tcpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-	int tmpRet = mbedtls_ssl_read(&netClientIn->tls.sslContext, byteOut, 1);
+	// returns as much of the current record as will fit
+	int tmpRet = mbedtls_ssl_read(&netClientIn->tls.sslContext, buffOut, maxNumBytesIn);
 	if( (tmpRet < 0) && (tmpRet != MBEDTLS_ERR_SSL_WANT_READ) )
 	{
 		cxa_logger_warn(&netClientIn->super.logger, "error during read: %d", tmpRet);
@@ -505,10 +513,64 @@ static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, vo
 		return CXA_IOSTREAM_READSTAT_ERROR;
 	}
 
+	*numBytesReadOut = (tmpRet > 0) ? (size_t)tmpRet : 0;
 	return (tmpRet > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
 }
 
 
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	cxa_lwipMbedTls_network_tcpClient_t* netClientIn = (cxa_lwipMbedTls_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	// refill our buffer if needed
+	if( netClientIn->rxBuffer_readIndex >= netClientIn->rxBuffer_numBytes )
+	{
+		netClientIn->rxBuffer_readIndex = 0;
+		netClientIn->rxBuffer_numBytes = 0;
+
+		cxa_ioStream_readStatus_t retVal = sslRead(netClientIn, netClientIn->rxBuffer, sizeof(netClientIn->rxBuffer), &netClientIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
+
+	uint8_t rxByte = netClientIn->rxBuffer[netClientIn->rxBuffer_readIndex++];
+	if( byteOut != NULL ) *byteOut = rxByte;
+
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_lwipMbedTls_network_tcpClient_t* netClientIn = (cxa_lwipMbedTls_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	*numBytesReadOut = 0;
+	if( maxNumBytesIn == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+
+	// if our buffer is empty...
+	if( netClientIn->rxBuffer_readIndex >= netClientIn->rxBuffer_numBytes )
+	{
+		netClientIn->rxBuffer_readIndex = 0;
+		netClientIn->rxBuffer_numBytes = 0;
+
+		// ...large reads can go directly to the caller (no need for an extra copy)
+		if( maxNumBytesIn >= sizeof(netClientIn->rxBuffer) ) return sslRead(netClientIn, buffOut, maxNumBytesIn, numBytesReadOut);
+
+		cxa_ioStream_readStatus_t retVal = sslRead(netClientIn, netClientIn->rxBuffer, sizeof(netClientIn->rxBuffer), &netClientIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
+
+	size_t numBytesAvailable = netClientIn->rxBuffer_numBytes - netClientIn->rxBuffer_readIndex;
+	size_t numBytesToCopy = (maxNumBytesIn < numBytesAvailable) ? maxNumBytesIn : numBytesAvailable;
+	memcpy(buffOut, &netClientIn->rxBuffer[netClientIn->rxBuffer_readIndex], numBytesToCopy);
+	netClientIn->rxBuffer_readIndex += numBytesToCopy;
+
+	*numBytesReadOut = numBytesToCopy;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
 static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_lwipMbedTls_network_tcpClient_t* netClientIn = (cxa_lwipMbedTls_network_tcpClient_t*)userVarIn;
@@ -8,6 +8,8 @@
 
 
 // ******** includes ********
+#include <string.h>
+
 #include <cxa_assert.h>
 #include <cxa_stringUtils.h>
 
@@ -29,7 +31,10 @@ static bool scm_isBound(cxa_network_tcpServer_connectedClient_t *const superIn);
 static void scm_unbindAndClose(cxa_network_tcpServer_connectedClient_t *const superIn);
 static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *const superIn);
 
+static cxa_ioStream_readStatus_t socketRead(cxa_lwipMbedTls_network_tcpServer_connectedClient_t *const ccIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
+
 static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
@@ -44,6 +49,8 @@ void cxa_lwipMbedTls_network_tcpServer_connectedClient_initUnbound(cxa_lwipMbedT
 	cxa_network_tcpServer_connectedClient_initUnbound(&ccIn->super, scm_isBound, scm_unbindAndClose, scm_getDescriptiveString);
 
 	ccIn->socket = -1;
+	ccIn->rxBuffer_numBytes = 0;
+	ccIn->rxBuffer_readIndex = 0;
 	cxa_timeDiff_init(&ccIn->td_writeTimeout);
 }
 
@@ -57,7 +64,10 @@ void cxa_lwipMbedTls_network_tcpServer_connectedClient_bindToSocket(cxa_lwipMbed
 	if( cxa_network_tcpServer_connectedClient_isBound(&ccIn->super) ) return;
 
 	ccIn->socket = socketIn;
+	ccIn->rxBuffer_numBytes = 0;
+	ccIn->rxBuffer_readIndex = 0;
 	cxa_ioStream_bind(&ccIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)ccIn);
+	cxa_ioStream_bindReadBytes(&ccIn->super.ioStream, cb_ioStream_readBytes);
 
 	ccIn->descriptiveString[0] = 0;
 	inet_ntop(AF_INET, &clientAddressIn->sin_addr, ccIn->descriptiveString, sizeof(ccIn->descriptiveString));
@@ -102,13 +112,11 @@ static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *c
 }
 
 
-static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+static cxa_ioStream_readStatus_t socketRead(cxa_lwipMbedTls_network_tcpServer_connectedClient_t *const ccIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
 {
-	cxa_lwipMbedTls_network_tcpServer_connectedClient_t* ccIn = (cxa_lwipMbedTls_network_tcpServer_connectedClient_t*)userVarIn;
 	cxa_assert(ccIn);
 
-	uint8_t rxByte;
-	int rc = recv(ccIn->socket, (void*)&rxByte, 1, 0);
+	int rc = recv(ccIn->socket, (void*)buffOut, maxNumBytesIn, 0);
 	if( (rc == 0) || ((rc == -1) && (errno != ENOTCONN)) )
 	{
 		// the connection has been closed
@@ -127,12 +135,64 @@ static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, vo
 	}
 	// if we made it here one of two things are true: rc==-1 -> no data...rc>0 -> data
 
-	if( (rc > 0) && (byteOut != NULL) ) *byteOut = rxByte;
-
+	*numBytesReadOut = (rc > 0) ? (size_t)rc : 0;
 	return (rc > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
 }
 
 
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	cxa_lwipMbedTls_network_tcpServer_connectedClient_t* ccIn = (cxa_lwipMbedTls_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	// refill our buffer if needed
+	if( ccIn->rxBuffer_readIndex >= ccIn->rxBuffer_numBytes )
+	{
+		ccIn->rxBuffer_readIndex = 0;
+		ccIn->rxBuffer_numBytes = 0;
+
+		cxa_ioStream_readStatus_t retVal = socketRead(ccIn, ccIn->rxBuffer, sizeof(ccIn->rxBuffer), &ccIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
+
+	uint8_t rxByte = ccIn->rxBuffer[ccIn->rxBuffer_readIndex++];
+	if( byteOut != NULL ) *byteOut = rxByte;
+
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_lwipMbedTls_network_tcpServer_connectedClient_t* ccIn = (cxa_lwipMbedTls_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	*numBytesReadOut = 0;
+	if( maxNumBytesIn == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+
+	// if our buffer is empty...
+	if( ccIn->rxBuffer_readIndex >= ccIn->rxBuffer_numBytes )
+	{
+		ccIn->rxBuffer_readIndex = 0;
+		ccIn->rxBuffer_numBytes = 0;
+
+		// ...large reads can go directly to the caller (no need for an extra copy)
+		if( maxNumBytesIn >= sizeof(ccIn->rxBuffer) ) return socketRead(ccIn, buffOut, maxNumBytesIn, numBytesReadOut);
+
+		cxa_ioStream_readStatus_t retVal = socketRead(ccIn, ccIn->rxBuffer, sizeof(ccIn->rxBuffer), &ccIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
+
+	size_t numBytesAvailable = ccIn->rxBuffer_numBytes - ccIn->rxBuffer_readIndex;
+	size_t numBytesToCopy = (maxNumBytesIn < numBytesAvailable) ? maxNumBytesIn : numBytesAvailable;
+	memcpy(buffOut, &ccIn->rxBuffer[ccIn->rxBuffer_readIndex], numBytesToCopy);
+	ccIn->rxBuffer_readIndex += numBytesToCopy;
+
+	*numBytesReadOut = numBytesToCopy;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
 static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_lwipMbedTls_network_tcpServer_connectedClient_t* ccIn = (cxa_lwipMbedTls_network_tcpServer_connectedClient_t*)userVarIn;
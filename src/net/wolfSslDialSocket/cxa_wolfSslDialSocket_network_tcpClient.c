@@ -8,6 +8,7 @@
 
 
 // ******** includes ********
+#include <limits.h>
 #include <string.h>
 
 #include <cxa_assert.h>
@@ -51,7 +52,10 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 static void stateCb_connected_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn);
 static void stateCb_connectFail_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 
+static cxa_ioStream_readStatus_t sslRead(cxa_wolfSslDialSocket_network_tcpClient_t *const netClientIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
+
 static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 static int wolfSsl_ioRx(WOLFSSL *ssl, char *buf, int sz, void *ctx);
@@ -84,6 +88,8 @@ void cxa_wolfSslDialSocket_network_tcpClient_init(cxa_wolfSslDialSocket_network_
 	netClientIn->targetHostName[0] = 0;
 	netClientIn->targetPortNum = 0;
 	netClientIn->useClientCert = false;
+	netClientIn->rxBuffer_numBytes = 0;
+	netClientIn->rxBuffer_readIndex = 0;
 
 	cxa_stateMachine_init(&netClientIn->stateMachine, "tcpClient", threadIdIn);
 	cxa_stateMachine_addState(&netClientIn->stateMachine, STATE_IDLE, "idle", NULL, NULL, NULL, (void*)netClientIn);
@@ -279,8 +285,11 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 	// make sure our socket is non-blocking now
     cxa_logger_trace(&netClientIn->super.logger, "connected");
 
-	// bind our ioStream
+	// bind our ioStream (with an empty receive buffer)
+	netClientIn->rxBuffer_numBytes = 0;
+	netClientIn->rxBuffer_readIndex = 0;
 	cxa_ioStream_bind(&netClientIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)netClientIn);
+	cxa_ioStream_bindReadBytes(&netClientIn->super.ioStream, cb_ioStream_readBytes);
 
 	// notify our listeners
 	cxa_array_iterate(&netClientIn->super.listeners, currListener, cxa_network_tcpClient_listenerEntry_t)
@@ -325,18 +334,74 @@ static void stateCb_connectFail_enter(cxa_stateMachine_t *const smIn, int prevSt
 }
 
 
+static cxa_ioStream_readStatus_t sslRead(cxa_wolfSslDialSocket_network_tcpClient_t *const netClientIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
+{
+	cxa_assert(netClientIn);
+
+	// returns as much of the current record as will fit
+	int tmpRet = wolfSSL_read(netClientIn->tls.ssl, buffOut, (maxNumBytesIn > INT_MAX) ? INT_MAX : (int)maxNumBytesIn);
+
+	cxa_logger_trace(&netClientIn->super. logger, "read retVal: %d", tmpRet);
+
+	// a positive return is always a byte count (so don't compare it against SSL_ERROR_WANT_READ)
+	if( tmpRet == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+	if( tmpRet < 0 ) return (wolfSSL_get_error(netClientIn->tls.ssl, tmpRet) == SSL_ERROR_WANT_READ) ? CXA_IOSTREAM_READSTAT_NODATA : CXA_IOSTREAM_READSTAT_ERROR;
+
+	*numBytesReadOut = (size_t)tmpRet;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
 static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
 {
 	cxa_wolfSslDialSocket_network_tcpClient_t* netClientIn = (cxa_wolfSslDialSocket_network_tcpClient_t*)userVarIn;
 	cxa_assert(netClientIn);
 
-    int tmpRet = wolfSSL_read(netClientIn->tls.ssl, byteOut, 1);
+	// refill our buffer if needed
+	if( netClientIn->rxBuffer_readIndex >= netClientIn->rxBuffer_numBytes )
+	{
+		netClientIn->rxBuffer_readIndex = 0;
+		netClientIn->rxBuffer_numBytes = 0;
+
+		cxa_ioStream_readStatus_t retVal = sslRead(netClientIn, netClientIn->rxBuffer, sizeof(netClientIn->rxBuffer), &netClientIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
+
+	uint8_t rxByte = netClientIn->rxBuffer[netClientIn->rxBuffer_readIndex++];
+	if( byteOut != NULL ) *byteOut = rxByte;
+
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readBytes(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_wolfSslDialSocket_network_tcpClient_t* netClientIn = (cxa_wolfSslDialSocket_network_tcpClient_t*)userVarIn;
+	cxa_assert(netClientIn);
+
+	*numBytesReadOut = 0;
+	if( maxNumBytesIn == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+
+	// if our buffer is empty...
+	if( netClientIn->rxBuffer_readIndex >= netClientIn->rxBuffer_numBytes )
+	{
+		netClientIn->rxBuffer_readIndex = 0;
+		netClientIn->rxBuffer_numBytes = 0;
+
+		// ...large reads can go directly to the caller (no need for an extra copy)
+		if( maxNumBytesIn >= sizeof(netClientIn->rxBuffer) ) return sslRead(netClientIn, buffOut, maxNumBytesIn, numBytesReadOut);
+
+		cxa_ioStream_readStatus_t retVal = sslRead(netClientIn, netClientIn->rxBuffer, sizeof(netClientIn->rxBuffer), &netClientIn->rxBuffer_numBytes);
+		if( retVal != CXA_IOSTREAM_READSTAT_GOTDATA ) return retVal;
+	}
 
-    cxa_logger_trace(&netClientIn->super. logger, "read retVal: %d", tmpRet);
+	size_t numBytesAvailable = netClientIn->rxBuffer_numBytes - netClientIn->rxBuffer_readIndex;
+	size_t numBytesToCopy = (maxNumBytesIn < numBytesAvailable) ? maxNumBytesIn : numBytesAvailable;
+	memcpy(buffOut, &netClientIn->rxBuffer[netClientIn->rxBuffer_readIndex], numBytesToCopy);
+	netClientIn->rxBuffer_readIndex += numBytesToCopy;
 
-    return  ((tmpRet == SSL_ERROR_WANT_READ) || (tmpRet == 0)) ?
-            CXA_IOSTREAM_READSTAT_NODATA :
-            ((tmpRet == 1) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_ERROR);
+	*numBytesReadOut = numBytesToCopy;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
 }
 
 
@@ -8,6 +8,7 @@
 
 
 // ******** includes ********
+#include <stddef.h>
 #include <stdint.h>
 #include <cxa_assert.h>
 #include <cxa_config.h>
@@ -17,30 +18,56 @@
 
 
 // ******** local macro definitions ********
-#ifndef CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES
-	#define CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES			256
-#endif
+#define NUM_MSGS_TOTAL				(CXA_RPC_MSGFACTORY_POOL_NUM_SMALL_MSGS + CXA_RPC_MSGFACTORY_POOL_NUM_MSGS)
+#define NUM_BUFFER_BYTES_TOTAL		((CXA_RPC_MSGFACTORY_POOL_NUM_SMALL_MSGS * CXA_RPC_MSGFACTORY_SMALL_BUFFER_SIZE_BYTES) + \
+									 (CXA_RPC_MSGFACTORY_POOL_NUM_MSGS * CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES))
+
+#define NUM_SIZE_CLASSES			2
 
 
 // ******** local type definitions ********
-typedef struct
+typedef struct cxa_rpc_messageFactory_msgEntry cxa_rpc_messageFactory_msgEntry_t;
+struct cxa_rpc_messageFactory_msgEntry
 {
+	cxa_rpc_messageFactory_msgEntry_t* nextFree;
 	uint8_t refCount;
+	uint8_t sizeClass;
 
 	cxa_rpc_message_t msg;
 	cxa_fixedByteBuffer_t msgFbb;
-	uint8_t msg_raw[CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES];
-}cxa_rpc_messageFactory_msgEntry_t;
+};
+
+
+typedef struct
+{
+	size_t numMsgs;
+	size_t bufferSize_bytes;
+}sizeClass_t;
 
 
 // ******** local function prototypes ********
 static cxa_rpc_messageFactory_msgEntry_t* getMsgEntryFromMessage(cxa_rpc_message_t *const msgIn);
+static cxa_rpc_messageFactory_msgEntry_t* validateEntry(cxa_rpc_messageFactory_msgEntry_t *const entryIn);
 
 
 // ********  local variable declarations *********
 static bool isInit = false;
 static cxa_logger_t logger;
-static cxa_rpc_messageFactory_msgEntry_t msgPool[CXA_RPC_MSGFACTORY_POOL_NUM_MSGS];
+
+// ordered smallest to largest
+static const sizeClass_t sizeClasses[NUM_SIZE_CLASSES] =
+{
+	{ CXA_RPC_MSGFACTORY_POOL_NUM_SMALL_MSGS, CXA_RPC_MSGFACTORY_SMALL_BUFFER_SIZE_BYTES },
+	{ CXA_RPC_MSGFACTORY_POOL_NUM_MSGS, CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES }
+};
+
+static cxa_rpc_messageFactory_msgEntry_t msgPool[NUM_MSGS_TOTAL];
+static uint8_t msgBuffers_raw[NUM_BUFFER_BYTES_TOTAL];
+static cxa_rpc_messageFactory_msgEntry_t* freeLists[NUM_SIZE_CLASSES];
+
+static size_t numFreeMsgs = 0;
+static size_t highWaterMark = 0;
+static size_t numFailedAllocations = 0;
 
 
 // ******** global function implementations ********
@@ -48,19 +75,33 @@ void cxa_rpc_messageFactory_init(void)
 {
 	if( isInit ) return;
 
+	cxa_assert_msg((CXA_RPC_MSGFACTORY_POOL_NUM_MSGS > 0), "CXA_RPC_MSGFACTORY_POOL_NUM_MSGS must be > 0");
+
 	// setup our logger
 	cxa_logger_init(&logger, "rpcMsgFactory");
 
-	// setup our message pool
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
+	// setup our message pool (carving our buffers into size classes)
+	size_t currEntryIndex = 0;
+	uint8_t* currBuffer = msgBuffers_raw;
+	for( size_t i = 0; i < NUM_SIZE_CLASSES; i++ )
 	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
+		freeLists[i] = NULL;
+		for( size_t j = 0; j < sizeClasses[i].numMsgs; j++ )
+		{
+			cxa_rpc_messageFactory_msgEntry_t* currEntry = &msgPool[currEntryIndex++];
+
+			cxa_fixedByteBuffer_init(&currEntry->msgFbb, currBuffer, sizeClasses[i].bufferSize_bytes);
+			currBuffer += sizeClasses[i].bufferSize_bytes;
 
-		currEntry->refCount = 0;
-		cxa_fixedByteBuffer_initStd(&currEntry->msgFbb, currEntry->msg_raw);
+			currEntry->refCount = 0;
+			currEntry->sizeClass = i;
+			currEntry->nextFree = freeLists[i];
+			freeLists[i] = currEntry;
 
-		cxa_logger_trace(&logger, "message %p added to pool", &currBuffer->msg);
+			cxa_logger_trace(&logger, "message %p added to pool", &currEntry->msg);
+		}
 	}
+	numFreeMsgs = NUM_MSGS_TOTAL;
 
 	isInit = true;
 }
@@ -70,39 +111,48 @@ size_t cxa_rpc_messageFactory_getNumFreeMessages(void)
 {
 	if( !isInit ) cxa_rpc_messageFactory_init();
 
-	size_t retVal = 0;
+	return numFreeMsgs;
+}
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
-		if( currEntry->refCount == 0 ) retVal++;
-	}
 
-	return retVal;
+cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void)
+{
+	return cxa_rpc_messageFactory_getFreeMessage_sized(CXA_RPC_MSGFACTORY_BUFFER_SIZE_BYTES);
 }
 
 
-cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void)
+cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_sized(size_t minSize_bytesIn)
 {
 	if( !isInit ) cxa_rpc_messageFactory_init();
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
+	// find the smallest class that fits (and has a free message)
+	cxa_rpc_messageFactory_msgEntry_t* newEntry = NULL;
+	for( size_t i = 0; i < NUM_SIZE_CLASSES; i++ )
 	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
+		if( (sizeClasses[i].bufferSize_bytes < minSize_bytesIn) || (freeLists[i] == NULL) ) continue;
 
-		if( currEntry->refCount == 0 )
-		{
-			currEntry->refCount = 1;
-			cxa_logger_trace(&logger, "message %p newly reserved", &currEntry->msg);
+		newEntry = freeLists[i];
+		freeLists[i] = newEntry->nextFree;
+		break;
+	}
 
-			cxa_fixedByteBuffer_clear(&currEntry->msgFbb);
-			cxa_rpc_message_initEmpty(&currEntry->msg, &currEntry->msgFbb);
-			return &currEntry->msg;
-		}
+	if( newEntry == NULL )
+	{
+		numFailedAllocations++;
+		cxa_logger_warn(&logger, "no free messages!");
+		return NULL;
 	}
 
-	cxa_logger_warn(&logger, "no free messages!");
-	return NULL;
+	newEntry->nextFree = NULL;
+	newEntry->refCount = 1;
+	numFreeMsgs--;
+	size_t numInUse = NUM_MSGS_TOTAL - numFreeMsgs;
+	if( numInUse > highWaterMark ) highWaterMark = numInUse;
+	cxa_logger_trace(&logger, "message %p newly reserved", &newEntry->msg);
+
+	cxa_fixedByteBuffer_clear(&newEntry->msgFbb);
+	cxa_rpc_message_initEmpty(&newEntry->msg, &newEntry->msgFbb);
+	return &newEntry->msg;
 }
 
 
@@ -113,15 +163,9 @@ cxa_rpc_message_t* cxa_rpc_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffe
 	// simple case (better than an assert in this case)
 	if( fbbIn == NULL) return NULL;
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
-
-		if( (currEntry->refCount != 0) && (&currEntry->msgFbb == fbbIn) ) return &currEntry->msg;
-	}
-
-	// if we made it here, we couldn't find a match
-	return NULL;
+	// buffers not from our pool are allowed (they just aren't ours)
+	cxa_rpc_messageFactory_msgEntry_t* targetEntry = validateEntry((cxa_rpc_messageFactory_msgEntry_t*)((uint8_t*)fbbIn - offsetof(cxa_rpc_messageFactory_msgEntry_t, msgFbb)));
+	return ((targetEntry != NULL) && (targetEntry->refCount != 0)) ? &targetEntry->msg : NULL;
 }
 
 
@@ -133,7 +177,7 @@ void cxa_rpc_messageFactory_incrementMessageRefCount(cxa_rpc_message_t *const ms
 	cxa_assert(targetEntry && (targetEntry->refCount < UINT8_MAX));
 
 	targetEntry->refCount++;
-	cxa_logger_trace(&logger, "message %p referenced", &currBuffer->msg);
+	cxa_logger_trace(&logger, "message %p referenced", &targetEntry->msg);
 }
 
 
@@ -148,6 +192,14 @@ void cxa_rpc_messageFactory_decrementMessageRefCount(cxa_rpc_message_t *const ms
 	{
 		targetEntry->refCount--;
 		cxa_logger_trace(&logger, "message %p dereferenced", &targetEntry->msg);
+
+		// return to the free list of its size class
+		if( targetEntry->refCount == 0 )
+		{
+			targetEntry->nextFree = freeLists[targetEntry->sizeClass];
+			freeLists[targetEntry->sizeClass] = targetEntry;
+			numFreeMsgs++;
+		}
 	}
 	else cxa_logger_warn(&logger, "mismatched decrement call for %p", &targetEntry->msg);
 }
@@ -164,15 +216,36 @@ uint8_t cxa_rpc_messageFactory_getReferenceCountForMessage(cxa_rpc_message_t *co
 }
 
 
+size_t cxa_rpc_messageFactory_getHighWaterMark(void)
+{
+	if( !isInit ) cxa_rpc_messageFactory_init();
+
+	return highWaterMark;
+}
+
+
+size_t cxa_rpc_messageFactory_getNumFailedAllocations(void)
+{
+	if( !isInit ) cxa_rpc_messageFactory_init();
+
+	return numFailedAllocations;
+}
+
+
 // ******** local function implementations ********
 static cxa_rpc_messageFactory_msgEntry_t* getMsgEntryFromMessage(cxa_rpc_message_t *const msgIn)
 {
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
+	if( msgIn == NULL ) return NULL;
 
-		if( &currEntry->msg == msgIn ) return currEntry;
-	}
+	return validateEntry((cxa_rpc_messageFactory_msgEntry_t*)((uint8_t*)msgIn - offsetof(cxa_rpc_messageFactory_msgEntry_t, msg)));
+}
+
+
+static cxa_rpc_messageFactory_msgEntry_t* validateEntry(cxa_rpc_messageFactory_msgEntry_t *const entryIn)
+{
+	// make sure this actually points to one of our entries
+	uintptr_t offset = (uintptr_t)entryIn - (uintptr_t)msgPool;
+	if( ((uintptr_t)entryIn < (uintptr_t)msgPool) || (offset >= sizeof(msgPool)) || ((offset % sizeof(*msgPool)) != 0) ) return NULL;
 
-	return NULL;
+	return entryIn;
 }
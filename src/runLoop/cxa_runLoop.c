@@ -8,7 +8,11 @@
 
 
 // ******** includes ********
+#include <string.h>
+
 #include <cxa_assert.h>
+#include <cxa_criticalSection.h>
+#include <cxa_timeBase.h>
 #include <cxa_timeDiff.h>
 
 // include for our target build system
@@ -20,6 +24,9 @@
     #include "freertos/FreeRTOS.h"
     #include "freertos/task.h"
     #include <esp_task_wdt.h>
+#elif defined CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+	// posix (epoll-based idle)
+	#include <cxa_posix_runLoop.h>
 #endif
 
 
@@ -28,6 +35,8 @@
 #include <cxa_config.h>
 
 // ******** local macro definitions ********
+#define HEAP_PARENT(indexIn)				(((indexIn) - 1) / 2)
+#define HEAP_LEFTCHILD(indexIn)				((2 * (indexIn)) + 1)
 
 
 // ******** local type definitions ********
@@ -47,31 +56,91 @@ typedef enum
 }type_t;
 
 
-typedef struct
+typedef struct cxa_runLoop_entry cxa_runLoop_entry_t;
+struct cxa_runLoop_entry
 {
 	state_t state;
 	type_t type;
 
 	int threadId;
+	const char* name;
 
 	uint32_t execPeriod_ms;
-	cxa_timeDiff_t td_exec;
+	uint32_t nextExec_ms;
 
 	cxa_runLoop_cb_t startupCb;
 	cxa_runLoop_cb_t updateCb;
+	cxa_runLoop_cb_hasPendingWork_t hasPendingWorkCb;
+	cxa_runLoop_cb_getUntimedState_t getUntimedStateCb;
 	void *userVar;
-}cxa_runLoop_entry_t;
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	cxa_runLoop_entryStats_t stats;
+#endif
+
+	cxa_runLoop_entry_t* next;
+};
+
+
+typedef struct
+{
+	cxa_runLoop_entry_t* head;
+	cxa_runLoop_entry_t* tail;
+}cxa_runLoop_list_t;
+
+
+typedef struct
+{
+	bool isUsed;
+	int threadId;
+
+	// entries waiting for their startupCb (may be added from any context)
+	cxa_runLoop_list_t unstarted;
+
+	// started, untimed entries...updated every iteration (only touched by the owning thread)
+	cxa_runLoop_list_t ready;
+
+	// untimed one-shots waiting for the next iteration
+	cxa_runLoop_list_t oneShots;
+
+	// timed entries and delayed one-shots, min-heap ordered by nextExec_ms
+	cxa_runLoop_entry_t* timers[CXA_RUNLOOP_MAXNUM_ENTRIES];
+	size_t numTimers;
+}cxa_runLoop_thread_t;
 
 
 // ******** local function prototypes ********
 static void init(void);
+static cxa_runLoop_thread_t* getThread(int threadIdIn);
 static cxa_runLoop_entry_t* reserveUnusedEntry(void);
+static void releaseEntry(cxa_runLoop_entry_t *const entryIn);
+static void addEntry(int threadIdIn, const char *const nameIn, type_t typeIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_hasPendingWork_t hasPendingWorkCbIn, cxa_runLoop_cb_getUntimedState_t getUntimedStateCbIn, void *const userVarIn);
+static inline void executeEntry(cxa_runLoop_entry_t *const entryIn);
+static void scheduleStartedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn);
+
+static void list_append(cxa_runLoop_list_t *const listIn, cxa_runLoop_entry_t *const entryIn);
+static cxa_runLoop_entry_t* list_takeAll(cxa_runLoop_list_t *const listIn);
+
+static void heap_push(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn);
+static cxa_runLoop_entry_t* heap_pop(cxa_runLoop_thread_t *const threadIn);
+static inline bool isBefore(uint32_t lhs_msIn, uint32_t rhs_msIn);
+
+static inline uint32_t clock_getNow_ms(void);
+static inline uint32_t getElapsed_us(uint64_t startCount_usIn, uint64_t endCount_usIn);
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+static void stats_reset(cxa_runLoop_entry_t *const entryIn);
+static void stats_recordExecution(cxa_runLoop_entry_t *const entryIn, uint32_t execTime_usIn);
+#endif
 
 
 // ********  local variable declarations *********
 static bool isInit = false;
 
 static cxa_runLoop_entry_t entries[CXA_RUNLOOP_MAXNUM_ENTRIES];
+static cxa_runLoop_entry_t* freeEntries;
+
+static cxa_runLoop_thread_t threads[CXA_RUNLOOP_MAXNUM_THREADS];
 
 static cxa_logger_t logger;
 
@@ -81,17 +150,7 @@ void cxa_runLoop_addEntry(int threadIdIn, cxa_runLoop_cb_t startupCbIn, cxa_runL
 {
 	if( !isInit ) init();
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
-
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_STANDARD;
-	newEntry->execPeriod_ms=0;
-	newEntry->startupCb=startupCbIn;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+	addEntry(threadIdIn, NULL, TYPE_STANDARD, 0, startupCbIn, updateCbIn, NULL, NULL, userVarIn);
 }
 
 
@@ -99,17 +158,43 @@ void cxa_runLoop_addTimedEntry(int threadIdIn, uint32_t execPeriod_msIn, cxa_run
 {
 	if( !isInit ) init();
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
+	addEntry(threadIdIn, NULL, TYPE_STANDARD, execPeriod_msIn, startupCbIn, updateCbIn, NULL, NULL, userVarIn);
+}
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_STANDARD;
-	newEntry->execPeriod_ms=execPeriod_msIn;
-	newEntry->startupCb=startupCbIn;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+
+void cxa_runLoop_addEntry_named(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	if( !isInit ) init();
+
+	addEntry(threadIdIn, nameIn, TYPE_STANDARD, 0, startupCbIn, updateCbIn, NULL, NULL, userVarIn);
+}
+
+
+void cxa_runLoop_addTimedEntry_named(int threadIdIn, const char *const nameIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	if( !isInit ) init();
+
+	addEntry(threadIdIn, nameIn, TYPE_STANDARD, execPeriod_msIn, startupCbIn, updateCbIn, NULL, NULL, userVarIn);
+}
+
+
+void cxa_runLoop_addEntry_idleAware(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_hasPendingWork_t hasPendingWorkCbIn, void *const userVarIn)
+{
+	cxa_assert(hasPendingWorkCbIn);
+
+	if( !isInit ) init();
+
+	addEntry(threadIdIn, nameIn, TYPE_STANDARD, 0, startupCbIn, updateCbIn, hasPendingWorkCbIn, NULL, userVarIn);
+}
+
+
+void cxa_runLoop_addEntry_pollAware(int threadIdIn, const char *const nameIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_getUntimedState_t getUntimedStateCbIn, void *const userVarIn)
+{
+	cxa_assert(getUntimedStateCbIn);
+
+	if( !isInit ) init();
+
+	addEntry(threadIdIn, nameIn, TYPE_STANDARD, 0, startupCbIn, updateCbIn, NULL, getUntimedStateCbIn, userVarIn);
 }
 
 
@@ -124,17 +209,7 @@ void cxa_runLoop_dispatchNextIteration(int threadIdIn, cxa_runLoop_cb_t updateCb
 {
 	if( !isInit ) init();
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
-
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_ONESHOT;
-	newEntry->execPeriod_ms=0;
-	newEntry->startupCb=NULL;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+	addEntry(threadIdIn, NULL, TYPE_ONESHOT, 0, NULL, updateCbIn, NULL, NULL, userVarIn);
 }
 
 
@@ -142,17 +217,57 @@ void cxa_runLoop_dispatchAfter(int threadIdIn, uint32_t delay_msIn, cxa_runLoop_
 {
 	if( !isInit ) init();
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
+	addEntry(threadIdIn, NULL, TYPE_ONESHOT, delay_msIn, NULL, updateCbIn, NULL, NULL, userVarIn);
+}
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_ONESHOT;
-	newEntry->execPeriod_ms=delay_msIn;
-	newEntry->startupCb=NULL;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+
+uint32_t cxa_runLoop_getTimeToNextDeadline_ms(int threadIdIn)
+{
+	if( !isInit ) init();
+
+	uint32_t retVal_ms = CXA_RUNLOOP_NO_DEADLINE;
+
+	cxa_criticalSection_enter();
+	cxa_runLoop_thread_t* thread = getThread(threadIdIn);
+	if( (thread->unstarted.head != NULL) || (thread->oneShots.head != NULL) )
+	{
+		// we have work to do right away
+		retVal_ms = 0;
+	}
+	else if( thread->numTimers > 0 )
+	{
+		uint32_t now_ms = clock_getNow_ms();
+		uint32_t nextExec_ms = thread->timers[0]->nextExec_ms;
+		retVal_ms = isBefore(now_ms, nextExec_ms) ? (nextExec_ms - now_ms) : 0;
+	}
+	cxa_criticalSection_exit();
+
+	return retVal_ms;
+}
+
+
+cxa_runLoop_untimedState_t cxa_runLoop_getUntimedState(int threadIdIn)
+{
+	if( !isInit ) init();
+
+	cxa_criticalSection_enter();
+	cxa_runLoop_entry_t* currEntry = getThread(threadIdIn)->ready.head;
+	cxa_criticalSection_exit();
+
+	// the ready list is only modified by the owning thread (which we are)
+	cxa_runLoop_untimedState_t retVal = CXA_RUNLOOP_UNTIMED_IDLE;
+	for( ; currEntry != NULL; currEntry = currEntry->next )
+	{
+		// entries that can't tell us must be polled
+		cxa_runLoop_untimedState_t currState = CXA_RUNLOOP_UNTIMED_MUSTPOLL;
+		if( currEntry->getUntimedStateCb != NULL ) currState = currEntry->getUntimedStateCb(currEntry->userVar);
+		else if( currEntry->hasPendingWorkCb != NULL ) currState = currEntry->hasPendingWorkCb(currEntry->userVar) ? CXA_RUNLOOP_UNTIMED_PENDINGWORK : CXA_RUNLOOP_UNTIMED_IDLE;
+
+		if( currState == CXA_RUNLOOP_UNTIMED_PENDINGWORK ) return CXA_RUNLOOP_UNTIMED_PENDINGWORK;
+		if( currState == CXA_RUNLOOP_UNTIMED_MUSTPOLL ) retVal = CXA_RUNLOOP_UNTIMED_MUSTPOLL;
+	}
+
+	return retVal;
 }
 
 
@@ -160,37 +275,100 @@ uint32_t cxa_runLoop_iterate(int threadIdIn)
 {
 	if( !isInit ) init();
 
-	uint32_t iter_startTime_us = cxa_timeBase_getCount_us();
+	uint64_t iter_startTime_us = cxa_timeBase_getCount64_us();
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+	// all timeDiffs evaluated during this iteration see the same "now"
+	cxa_timeDiff_setCachedNow(iter_startTime_us);
+#endif
 
-	// iterate first and make sure all of our entries have been started
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	cxa_criticalSection_enter();
+	cxa_runLoop_thread_t* thread = getThread(threadIdIn);
+	cxa_runLoop_entry_t* currEntry = list_takeAll(&thread->unstarted);
+	cxa_criticalSection_exit();
+
+	// make sure all of our new entries have been started
+	while( currEntry != NULL )
 	{
-		if( (entries[i].threadId == threadIdIn) &&
-			(entries[i].state == STATE_RESERVED_CONFIGURED_UNSTARTED) )
-		{
-			if( entries[i].startupCb != NULL ) entries[i].startupCb(entries[i].userVar);
-			entries[i].state = STATE_RESERVED_CONFIGURED_STARTED;
-		}
+		cxa_runLoop_entry_t* nextEntry = currEntry->next;
+
+		if( currEntry->startupCb != NULL ) currEntry->startupCb(currEntry->userVar);
+
+		cxa_criticalSection_enter();
+		currEntry->state = STATE_RESERVED_CONFIGURED_STARTED;
+		scheduleStartedEntry(thread, currEntry);
+		cxa_criticalSection_exit();
+
+		currEntry = nextEntry;
 	}
 
-	// now iterate again and call our update functions
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	// untimed entries run every iteration (this list is only modified above, by this thread)
+	for( currEntry = thread->ready.head; currEntry != NULL; currEntry = currEntry->next )
+	{
+		executeEntry(currEntry);
+	}
+
+	// one-shots dispatched before this iteration (anything dispatched from here on waits for the next one)
+	cxa_criticalSection_enter();
+	currEntry = list_takeAll(&thread->oneShots);
+	cxa_criticalSection_exit();
+	while( currEntry != NULL )
+	{
+		cxa_runLoop_entry_t* nextEntry = currEntry->next;
+
+		if( currEntry->updateCb != NULL ) currEntry->updateCb(currEntry->userVar);
+
+		cxa_criticalSection_enter();
+		releaseEntry(currEntry);
+		cxa_criticalSection_exit();
+
+		currEntry = nextEntry;
+	}
+
+	// timed entries...only touch those that are actually due
+	cxa_criticalSection_enter();
+	uint32_t now_ms = clock_getNow_ms();
+	while( (thread->numTimers > 0) && !isBefore(now_ms, thread->timers[0]->nextExec_ms) )
 	{
-		if( (entries[i].threadId == threadIdIn) &&
-			(entries[i].state == STATE_RESERVED_CONFIGURED_STARTED) )
+		currEntry = heap_pop(thread);
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+		// includes time spent running entries that were due before this one
+		uint32_t lateness_ms = clock_getNow_ms() - currEntry->nextExec_ms;
+#endif
+		cxa_criticalSection_exit();
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+		if( currEntry->type != TYPE_ONESHOT )
 		{
-			// we know this is valid callback for this thread...
-			// if it's timed, make sure we're calling it at the right pace
-			if( (entries[i].execPeriod_ms == 0) ||
-				 cxa_timeDiff_isElapsed_recurring_ms(&entries[i].td_exec, entries[i].execPeriod_ms) )
+			if( lateness_ms > 0 )
 			{
-				if( entries[i].updateCb != NULL ) entries[i].updateCb(entries[i].userVar);
+				currEntry->stats.numLateCalls++;
+				currEntry->stats.totalLateness_ms += lateness_ms;
+				if( lateness_ms > currEntry->stats.maxLateness_ms ) currEntry->stats.maxLateness_ms = lateness_ms;
+			}
+		}
+#endif
+		executeEntry(currEntry);
 
-				// free this entry if it's a one-shot
-				if( entries[i].type == TYPE_ONESHOT ) entries[i].state = STATE_UNUSED;
+		cxa_criticalSection_enter();
+		if( currEntry->type == TYPE_ONESHOT )
+		{
+			releaseEntry(currEntry);
+		}
+		else
+		{
+			// fixed rate: advance by whole periods so execution time doesn't accumulate as drift...
+			// ...but skip any periods we've already missed (cannot be due again this iteration)
+			uint32_t postExecNow_ms = clock_getNow_ms();
+			currEntry->nextExec_ms += currEntry->execPeriod_ms;
+			if( !isBefore(postExecNow_ms, currEntry->nextExec_ms) )
+			{
+				uint32_t numMissedPeriods = ((postExecNow_ms - currEntry->nextExec_ms) / currEntry->execPeriod_ms) + 1;
+				currEntry->nextExec_ms += numMissedPeriods * currEntry->execPeriod_ms;
 			}
+			heap_push(thread, currEntry);
 		}
 	}
+	cxa_criticalSection_exit();
 
 #ifdef ESP32
     esp_task_wdt_feed();        // esp32 only
@@ -200,7 +378,11 @@ uint32_t cxa_runLoop_iterate(int threadIdIn)
 	taskYIELD();
 #endif
 
-	return cxa_timeBase_getCount_us() - iter_startTime_us;
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+	cxa_timeDiff_clearCachedNow();
+#endif
+
+	return getElapsed_us(iter_startTime_us, cxa_timeBase_getCount64_us());
 }
 
 
@@ -212,8 +394,47 @@ void cxa_runLoop_execute(int threadIdIn)
 	while(1)
 	{
 		cxa_runLoop_iterate(threadIdIn);
+
+#ifdef CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+		// sleep until we have something to do
+		cxa_posix_runLoop_waitForEvents(threadIdIn);
+#endif
+	}
+}
+
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+bool cxa_runLoop_getEntryStats(size_t indexIn, cxa_runLoop_entryStats_t *const statsOut)
+{
+	cxa_assert(statsOut);
+
+	if( !isInit ) init();
+
+	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	{
+		if( (entries[i].state != STATE_RESERVED_CONFIGURED_STARTED) || (entries[i].type == TYPE_ONESHOT) ) continue;
+
+		if( indexIn-- == 0 )
+		{
+			*statsOut = entries[i].stats;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void cxa_runLoop_resetEntryStats(void)
+{
+	if( !isInit ) init();
+
+	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	{
+		stats_reset(&entries[i]);
 	}
 }
+#endif
 
 
 // ******** local function implementations ********
@@ -221,26 +442,270 @@ static void init(void)
 {
 	if( isInit ) return;
 
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	cxa_criticalSection_enter();
+	freeEntries = NULL;
+	for( size_t i = sizeof(entries)/sizeof(*entries); i > 0; i-- )
+	{
+		entries[i-1].state = STATE_UNUSED;
+		entries[i-1].next = freeEntries;
+		freeEntries = &entries[i-1];
+	}
+
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
 	{
-		entries[i].state = STATE_UNUSED;
+		threads[i].isUsed = false;
 	}
+
+	cxa_criticalSection_exit();
+
 	cxa_logger_init(&logger, "runLoop");
 
 	isInit = true;
 }
 
 
+/**
+ * @note must be called from within a critical section
+ */
+static cxa_runLoop_thread_t* getThread(int threadIdIn)
+{
+	cxa_runLoop_thread_t* freeThread = NULL;
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
+	{
+		if( threads[i].isUsed && (threads[i].threadId == threadIdIn) ) return &threads[i];
+		if( !threads[i].isUsed && (freeThread == NULL) ) freeThread = &threads[i];
+	}
+	cxa_assert_msg(freeThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+
+	freeThread->isUsed = true;
+	freeThread->threadId = threadIdIn;
+	freeThread->unstarted.head = freeThread->unstarted.tail = NULL;
+	freeThread->ready.head = freeThread->ready.tail = NULL;
+	freeThread->oneShots.head = freeThread->oneShots.tail = NULL;
+	freeThread->numTimers = 0;
+
+	return freeThread;
+}
+
+
+/**
+ * @note must be called from within a critical section
+ */
 static cxa_runLoop_entry_t* reserveUnusedEntry(void)
 {
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	cxa_runLoop_entry_t* retVal = freeEntries;
+	if( retVal == NULL ) return NULL;
+
+	freeEntries = retVal->next;
+	retVal->next = NULL;
+	retVal->state = STATE_RESERVED_CONFIGURING;
+	return retVal;
+}
+
+
+/**
+ * @note must be called from within a critical section
+ */
+static void releaseEntry(cxa_runLoop_entry_t *const entryIn)
+{
+	entryIn->state = STATE_UNUSED;
+	entryIn->next = freeEntries;
+	freeEntries = entryIn;
+}
+
+
+static void addEntry(int threadIdIn, const char *const nameIn, type_t typeIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, cxa_runLoop_cb_hasPendingWork_t hasPendingWorkCbIn, cxa_runLoop_cb_getUntimedState_t getUntimedStateCbIn, void *const userVarIn)
+{
+	cxa_criticalSection_enter();
+
+	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
+	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
+
+	newEntry->threadId = threadIdIn;
+	newEntry->name = nameIn;
+	newEntry->type = typeIn;
+	newEntry->execPeriod_ms = execPeriod_msIn;
+	newEntry->nextExec_ms = clock_getNow_ms() + execPeriod_msIn;
+	newEntry->startupCb = startupCbIn;
+	newEntry->updateCb = updateCbIn;
+	newEntry->hasPendingWorkCb = hasPendingWorkCbIn;
+	newEntry->getUntimedStateCb = getUntimedStateCbIn;
+	newEntry->userVar = userVarIn;
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	stats_reset(newEntry);
+#endif
+
+	cxa_runLoop_thread_t* thread = getThread(threadIdIn);
+	if( typeIn == TYPE_ONESHOT )
 	{
-		if( entries[i].state == STATE_UNUSED )
-		{
-			entries[i].state = STATE_RESERVED_CONFIGURING;
-			return &entries[i];
-		}
+		// one-shots have no startup, schedule them directly
+		newEntry->state = STATE_RESERVED_CONFIGURED_STARTED;
+		scheduleStartedEntry(thread, newEntry);
+	}
+	else
+	{
+		newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+		list_append(&thread->unstarted, newEntry);
+	}
+
+	cxa_criticalSection_exit();
+
+#ifdef CXA_RUNLOOP_POSIX_EVENTS_ENABLE
+	// in case the target thread is currently sleeping
+	cxa_posix_runLoop_notifyWorkAdded(threadIdIn);
+#endif
+}
+
+
+static inline void executeEntry(cxa_runLoop_entry_t *const entryIn)
+{
+	if( entryIn->updateCb == NULL ) return;
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+	uint64_t startTime_us = cxa_timeBase_getCount64_us();
+	entryIn->updateCb(entryIn->userVar);
+	if( entryIn->type != TYPE_ONESHOT ) stats_recordExecution(entryIn, getElapsed_us(startTime_us, cxa_timeBase_getCount64_us()));
+#else
+	entryIn->updateCb(entryIn->userVar);
+#endif
+}
+
+
+/**
+ * @note must be called from within a critical section
+ */
+static void scheduleStartedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn)
+{
+	entryIn->next = NULL;
+
+	if( entryIn->execPeriod_ms != 0 )
+	{
+		heap_push(threadIn, entryIn);
+	}
+	else if( entryIn->type == TYPE_ONESHOT )
+	{
+		list_append(&threadIn->oneShots, entryIn);
+	}
+	else
+	{
+		list_append(&threadIn->ready, entryIn);
+	}
+}
+
+
+static void list_append(cxa_runLoop_list_t *const listIn, cxa_runLoop_entry_t *const entryIn)
+{
+	entryIn->next = NULL;
+	if( listIn->tail != NULL ) listIn->tail->next = entryIn;
+	else listIn->head = entryIn;
+	listIn->tail = entryIn;
+}
+
+
+static cxa_runLoop_entry_t* list_takeAll(cxa_runLoop_list_t *const listIn)
+{
+	cxa_runLoop_entry_t* retVal = listIn->head;
+	listIn->head = NULL;
+	listIn->tail = NULL;
+	return retVal;
+}
+
+
+static void heap_push(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(threadIn->numTimers < (sizeof(threadIn->timers)/sizeof(*threadIn->timers)));
+
+	// sift up
+	size_t currIndex = threadIn->numTimers++;
+	while( currIndex > 0 )
+	{
+		size_t parentIndex = HEAP_PARENT(currIndex);
+		if( !isBefore(entryIn->nextExec_ms, threadIn->timers[parentIndex]->nextExec_ms) ) break;
+
+		threadIn->timers[currIndex] = threadIn->timers[parentIndex];
+		currIndex = parentIndex;
+	}
+	threadIn->timers[currIndex] = entryIn;
+}
+
+
+static cxa_runLoop_entry_t* heap_pop(cxa_runLoop_thread_t *const threadIn)
+{
+	cxa_assert(threadIn->numTimers > 0);
+
+	cxa_runLoop_entry_t* retVal = threadIn->timers[0];
+	cxa_runLoop_entry_t* lastEntry = threadIn->timers[--threadIn->numTimers];
+
+	// sift down
+	size_t currIndex = 0;
+	while( 1 )
+	{
+		size_t childIndex = HEAP_LEFTCHILD(currIndex);
+		if( childIndex >= threadIn->numTimers ) break;
+		if( ((childIndex + 1) < threadIn->numTimers) &&
+			isBefore(threadIn->timers[childIndex + 1]->nextExec_ms, threadIn->timers[childIndex]->nextExec_ms) ) childIndex++;
+		if( !isBefore(threadIn->timers[childIndex]->nextExec_ms, lastEntry->nextExec_ms) ) break;
+
+		threadIn->timers[currIndex] = threadIn->timers[childIndex];
+		currIndex = childIndex;
 	}
+	threadIn->timers[currIndex] = lastEntry;
+
+	return retVal;
+}
+
 
-	return NULL;
+static inline bool isBefore(uint32_t lhs_msIn, uint32_t rhs_msIn)
+{
+	// wrap-safe as long as deadlines are less than ~24 days apart
+	return ((int32_t)(lhs_msIn - rhs_msIn) < 0);
+}
+
+
+/**
+ * Deadlines are kept as a millisecond clock that wraps cleanly at 32 bits
+ * (truncated from the 64-bit timeBase). This lets us compare deadlines with
+ * simple (signed) subtraction.
+ */
+static inline uint32_t clock_getNow_ms(void)
+{
+	return (uint32_t)(cxa_timeBase_getCount64_us() / 1000);
 }
+
+
+static inline uint32_t getElapsed_us(uint64_t startCount_usIn, uint64_t endCount_usIn)
+{
+	uint64_t elapsed_us = (endCount_usIn > startCount_usIn) ? (endCount_usIn - startCount_usIn) : 0;
+	return (elapsed_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_us;
+}
+
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+static void stats_reset(cxa_runLoop_entry_t *const entryIn)
+{
+	memset(&entryIn->stats, 0, sizeof(entryIn->stats));
+	entryIn->stats.name = entryIn->name;
+	entryIn->stats.updateCb = entryIn->updateCb;
+	entryIn->stats.threadId = entryIn->threadId;
+	entryIn->stats.execPeriod_ms = entryIn->execPeriod_ms;
+}
+
+
+static void stats_recordExecution(cxa_runLoop_entry_t *const entryIn, uint32_t execTime_usIn)
+{
+	cxa_runLoop_entryStats_t* stats = &entryIn->stats;
+
+	stats->numCalls++;
+	stats->totalExecTime_us += execTime_usIn;
+	if( execTime_usIn > stats->maxExecTime_us ) stats->maxExecTime_us = execTime_usIn;
+
+	// bucket is the number of significant bits in the execution time
+	size_t bucket = 0;
+	while( (execTime_usIn != 0) && (bucket < (CXA_RUNLOOP_PROFILER_NUM_HIST_BUCKETS - 1)) )
+	{
+		execTime_usIn >>= 1;
+		bucket++;
+	}
+	stats->execTimeHist[bucket]++;
+}
+#endif
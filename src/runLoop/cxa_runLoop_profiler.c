@@ -0,0 +1,98 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_runLoop_profiler.h"
+
+
+// ******** includes ********
+#include <stdio.h>
+
+#include <cxa_assert.h>
+#include <cxa_console.h>
+#include <cxa_stringUtils.h>
+
+
+#ifdef CXA_RUNLOOP_PROFILER_ENABLE
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static void consoleCb_printStats(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
+static void consoleCb_resetStats(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+bool cxa_runLoop_profiler_formatEntry(const cxa_runLoop_entryStats_t *const statsIn, char *const lineOut, size_t maxLen_bytesIn)
+{
+	cxa_assert(statsIn);
+	cxa_assert(lineOut);
+	cxa_assert(maxLen_bytesIn > 0);
+
+	lineOut[0] = 0;
+
+	// unnamed entries are identified by their callback
+	bool retVal = (statsIn->name != NULL) ?
+			cxa_stringUtils_concat(lineOut, statsIn->name, maxLen_bytesIn) :
+			cxa_stringUtils_concat_formattedString(lineOut, maxLen_bytesIn, "cb@%p", (void*)statsIn->updateCb);
+
+	uint32_t avgExecTime_us = (statsIn->numCalls > 0) ? (uint32_t)(statsIn->totalExecTime_us / statsIn->numCalls) : 0;
+	retVal = retVal && cxa_stringUtils_concat_formattedString(lineOut, maxLen_bytesIn, " t%d p%lums calls:%lu avg:%luus max:%luus late:%lu maxLate:%lums hist:",
+															  statsIn->threadId, (unsigned long)statsIn->execPeriod_ms,
+															  (unsigned long)statsIn->numCalls, (unsigned long)avgExecTime_us, (unsigned long)statsIn->maxExecTime_us,
+															  (unsigned long)statsIn->numLateCalls, (unsigned long)statsIn->maxLateness_ms);
+
+	// skip trailing empty buckets (but always print the first)
+	size_t numBuckets = CXA_RUNLOOP_PROFILER_NUM_HIST_BUCKETS;
+	while( (numBuckets > 1) && (statsIn->execTimeHist[numBuckets-1] == 0) ) numBuckets--;
+	for( size_t i = 0; retVal && (i < numBuckets); i++ )
+	{
+		retVal = cxa_stringUtils_concat_formattedString(lineOut, maxLen_bytesIn, (i == 0) ? "%lu" : ",%lu", (unsigned long)statsIn->execTimeHist[i]);
+	}
+
+	return retVal;
+}
+
+
+void cxa_runLoop_profiler_writeReport(cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(ioStreamIn);
+
+	cxa_runLoop_entryStats_t currStats;
+	for( size_t i = 0; cxa_runLoop_getEntryStats(i, &currStats); i++ )
+	{
+		char line[CXA_RUNLOOP_PROFILER_MAXLEN_LINE_BYTES];
+		cxa_runLoop_profiler_formatEntry(&currStats, line, sizeof(line));
+		cxa_ioStream_writeLine(ioStreamIn, line);
+	}
+}
+
+
+void cxa_runLoop_profiler_addConsoleCommands(void)
+{
+	cxa_console_addCommand("rl_stats", "prints runLoop entry statistics", NULL, 0, consoleCb_printStats, NULL);
+	cxa_console_addCommand("rl_resetStats", "clears runLoop entry statistics", NULL, 0, consoleCb_resetStats, NULL);
+}
+
+
+// ******** local function implementations ********
+static void consoleCb_printStats(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn)
+{
+	cxa_runLoop_profiler_writeReport(ioStreamIn);
+}
+
+
+static void consoleCb_resetStats(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn)
+{
+	cxa_runLoop_resetEntryStats();
+	cxa_ioStream_writeLine(ioStreamIn, "OK");
+}
+#endif
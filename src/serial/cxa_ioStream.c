@@ -56,7 +56,9 @@ void cxa_ioStream_bind(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readByt
 
 	// save our references
 	ioStreamIn->readCb = readCbIn;
+	ioStreamIn->readBytesCb = NULL;
 	ioStreamIn->writeCb = writeCbIn;
+	ioStreamIn->writeVectoredCb = NULL;
 	ioStreamIn->userVar = userVarIn;
 }
 
@@ -66,11 +68,31 @@ void cxa_ioStream_unbind(cxa_ioStream_t *const ioStreamIn)
 	cxa_assert(ioStreamIn);
 
 	ioStreamIn->readCb = NULL;
+	ioStreamIn->readBytesCb = NULL;
 	ioStreamIn->writeCb = NULL;
+	ioStreamIn->writeVectoredCb = NULL;
 	ioStreamIn->userVar = NULL;
 }
 
 
+void cxa_ioStream_bindReadBytes(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readBytes_t readBytesCbIn)
+{
+	cxa_assert(ioStreamIn);
+
+	// shares the userVar supplied to cxa_ioStream_bind (so must be called after it)
+	ioStreamIn->readBytesCb = readBytesCbIn;
+}
+
+
+void cxa_ioStream_bindWriteVectored(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_writeVectored_t writeVectoredCbIn)
+{
+	cxa_assert(ioStreamIn);
+
+	// shares the userVar supplied to cxa_ioStream_bind (so must be called after it)
+	ioStreamIn->writeVectoredCb = writeVectoredCbIn;
+}
+
+
 bool cxa_ioStream_isBound(cxa_ioStream_t *const ioStreamIn)
 {
 	cxa_assert(ioStreamIn);
@@ -90,6 +112,34 @@ cxa_ioStream_readStatus_t cxa_ioStream_readByte(cxa_ioStream_t *const ioStreamIn
 }
 
 
+cxa_ioStream_readStatus_t cxa_ioStream_readBytes(cxa_ioStream_t *const ioStreamIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
+{
+	cxa_assert(ioStreamIn);
+	cxa_assert(buffOut);
+	cxa_assert(numBytesReadOut);
+
+	*numBytesReadOut = 0;
+
+	// make sure we're bound
+	if( !cxa_ioStream_isBound(ioStreamIn) ) return CXA_IOSTREAM_READSTAT_ERROR;
+	if( maxNumBytesIn == 0 ) return CXA_IOSTREAM_READSTAT_NODATA;
+
+	if( ioStreamIn->readBytesCb != NULL ) return ioStreamIn->readBytesCb(buffOut, maxNumBytesIn, numBytesReadOut, ioStreamIn->userVar);
+
+	// underlying stream only supports single-byte reads...read until it runs dry
+	cxa_ioStream_readStatus_t readStat = CXA_IOSTREAM_READSTAT_NODATA;
+	while( *numBytesReadOut < maxNumBytesIn )
+	{
+		readStat = ioStreamIn->readCb(&buffOut[*numBytesReadOut], ioStreamIn->userVar);
+		if( readStat != CXA_IOSTREAM_READSTAT_GOTDATA ) break;
+		(*numBytesReadOut)++;
+	}
+
+	// report any error on the _next_ read so we don't lose the bytes we have
+	return (*numBytesReadOut > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : readStat;
+}
+
+
 bool cxa_ioStream_waitForCharSequence_withTimeout(cxa_ioStream_t *const ioStreamIn, const char* targetSeqIn, uint32_t timeout_msIn)
 {
 	cxa_assert(ioStreamIn);
@@ -99,7 +149,7 @@ bool cxa_ioStream_waitForCharSequence_withTimeout(cxa_ioStream_t *const ioStream
 	cxa_timeDiff_init(&td_timeout);
 
 	uint8_t rxByte;
-	while( !cxa_timeDiff_isElapsed_ms(&td_timeout, timeout_msIn) )
+	while( !cxa_timeDiff_isElapsed_uncached_ms(&td_timeout, timeout_msIn) )
 	{
 		// see if we've found the end of the stream
 		if( *targetSeqIn == 0 ) return true;
@@ -153,6 +203,27 @@ bool cxa_ioStream_writeBytes(cxa_ioStream_t *const ioStreamIn, void* buffIn, siz
 	return ioStreamIn->writeCb(buffIn, bufferSize_bytesIn, ioStreamIn->userVar);
 }
 
+
+bool cxa_ioStream_writeVectored(cxa_ioStream_t *const ioStreamIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn)
+{
+	cxa_assert(ioStreamIn);
+	if( numVecsIn > 0 ) cxa_assert(vecsIn);
+
+	// make sure we're bound
+	if( !cxa_ioStream_isBound(ioStreamIn) ) return false;
+
+	if( ioStreamIn->writeVectoredCb != NULL ) return ioStreamIn->writeVectoredCb(vecsIn, numVecsIn, ioStreamIn->userVar);
+
+	// underlying stream doesn't support vectored writes...one write per segment
+	for( size_t i = 0; i < numVecsIn; i++ )
+	{
+		if( vecsIn[i].bufferSize_bytes == 0 ) continue;
+		if( !ioStreamIn->writeCb(vecsIn[i].buff, vecsIn[i].bufferSize_bytes, ioStreamIn->userVar) ) return false;
+	}
+
+	return true;
+}
+
 bool cxa_ioStream_writeBytes_hex(cxa_ioStream_t *const ioStreamIn, void* buffIn, size_t bufferSize_bytesIn)
 {
 	cxa_assert(ioStreamIn);
@@ -0,0 +1,175 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_ioStream_buffered.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_runLoop.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool bufferOrWrite(cxa_ioStream_buffered_t *const ioStreamIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn);
+
+static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
+static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool writeVectored_cb(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn);
+
+static void cb_onRunLoopUpdate(void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_ioStream_buffered_init(cxa_ioStream_buffered_t *const ioStreamIn, cxa_ioStream_t *const underlyingStreamIn,
+								void *const bufferIn, size_t bufferSize_bytesIn)
+{
+	cxa_assert(ioStreamIn);
+	cxa_assert(underlyingStreamIn);
+	cxa_assert(bufferIn);
+	cxa_assert(bufferSize_bytesIn > 0);
+
+	// save our references and set our initial state
+	ioStreamIn->underlyingStream = underlyingStreamIn;
+	ioStreamIn->buffer = (uint8_t*)bufferIn;
+	ioStreamIn->maxSize_bytes = bufferSize_bytesIn;
+	ioStreamIn->size_bytes = 0;
+
+	// initialize our super class
+	cxa_ioStream_init(&ioStreamIn->super);
+	cxa_ioStream_bind(&ioStreamIn->super, read_cb, write_cb, (void*)ioStreamIn);
+	cxa_ioStream_bindReadBytes(&ioStreamIn->super, readBytes_cb);
+	cxa_ioStream_bindWriteVectored(&ioStreamIn->super, writeVectored_cb);
+}
+
+
+void cxa_ioStream_buffered_enableRunLoopFlush(cxa_ioStream_buffered_t *const ioStreamIn, int threadIdIn)
+{
+	cxa_assert(ioStreamIn);
+
+	cxa_runLoop_addEntry(threadIdIn, NULL, cb_onRunLoopUpdate, (void*)ioStreamIn);
+}
+
+
+bool cxa_ioStream_buffered_flush(cxa_ioStream_buffered_t *const ioStreamIn)
+{
+	cxa_assert(ioStreamIn);
+
+	if( ioStreamIn->size_bytes == 0 ) return true;
+
+	bool retVal = cxa_ioStream_writeBytes(ioStreamIn->underlyingStream, ioStreamIn->buffer, ioStreamIn->size_bytes);
+	ioStreamIn->size_bytes = 0;
+
+	return retVal;
+}
+
+
+size_t cxa_ioStream_buffered_getNumBufferedBytes(cxa_ioStream_buffered_t *const ioStreamIn)
+{
+	cxa_assert(ioStreamIn);
+
+	return ioStreamIn->size_bytes;
+}
+
+
+// ******** local function implementations ********
+static bool bufferOrWrite(cxa_ioStream_buffered_t *const ioStreamIn, const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn)
+{
+	size_t totalSize_bytes = 0;
+	for( size_t i = 0; i < numVecsIn; i++ )
+	{
+		totalSize_bytes += vecsIn[i].bufferSize_bytes;
+	}
+	if( totalSize_bytes == 0 ) return true;
+
+	// simple case...it fits in our buffer
+	if( (ioStreamIn->size_bytes + totalSize_bytes) <= ioStreamIn->maxSize_bytes )
+	{
+		for( size_t i = 0; i < numVecsIn; i++ )
+		{
+			memcpy(&ioStreamIn->buffer[ioStreamIn->size_bytes], vecsIn[i].buff, vecsIn[i].bufferSize_bytes);
+			ioStreamIn->size_bytes += vecsIn[i].bufferSize_bytes;
+		}
+
+		// no sense waiting if we're full
+		return (ioStreamIn->size_bytes == ioStreamIn->maxSize_bytes) ? cxa_ioStream_buffered_flush(ioStreamIn) : true;
+	}
+
+	// doesn't fit...
+	if( (ioStreamIn->size_bytes == 0) || (numVecsIn >= CXA_IOSTREAM_BUFFERED_MAXNUM_VECS) )
+	{
+		// nothing to prepend (or too many segments to do so)
+		if( !cxa_ioStream_buffered_flush(ioStreamIn) ) return false;
+		return cxa_ioStream_writeVectored(ioStreamIn->underlyingStream, vecsIn, numVecsIn);
+	}
+
+	// send what we have buffered along with the new data (without copying it)
+	cxa_ioStream_ioVec_t vecs[CXA_IOSTREAM_BUFFERED_MAXNUM_VECS];
+	vecs[0].buff = ioStreamIn->buffer;
+	vecs[0].bufferSize_bytes = ioStreamIn->size_bytes;
+	memcpy(&vecs[1], vecsIn, numVecsIn * sizeof(*vecsIn));
+
+	ioStreamIn->size_bytes = 0;
+	return cxa_ioStream_writeVectored(ioStreamIn->underlyingStream, vecs, numVecsIn + 1);
+}
+
+
+static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const userVarIn)
+{
+	cxa_ioStream_buffered_t *const ioStreamIn = (cxa_ioStream_buffered_t*)userVarIn;
+	cxa_assert(ioStreamIn);
+
+	// call through to the underlying stream...
+	return cxa_ioStream_readByte(ioStreamIn->underlyingStream, byteOut);
+}
+
+
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_ioStream_buffered_t *const ioStreamIn = (cxa_ioStream_buffered_t*)userVarIn;
+	cxa_assert(ioStreamIn);
+
+	return cxa_ioStream_readBytes(ioStreamIn->underlyingStream, buffOut, maxNumBytesIn, numBytesReadOut);
+}
+
+
+static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	cxa_ioStream_buffered_t *const ioStreamIn = (cxa_ioStream_buffered_t*)userVarIn;
+	cxa_assert(ioStreamIn);
+
+	cxa_ioStream_ioVec_t vec = { .buff = buffIn, .bufferSize_bytes = bufferSize_bytesIn };
+	return bufferOrWrite(ioStreamIn, &vec, 1);
+}
+
+
+static bool writeVectored_cb(const cxa_ioStream_ioVec_t* vecsIn, size_t numVecsIn, void *const userVarIn)
+{
+	cxa_ioStream_buffered_t *const ioStreamIn = (cxa_ioStream_buffered_t*)userVarIn;
+	cxa_assert(ioStreamIn);
+
+	return bufferOrWrite(ioStreamIn, vecsIn, numVecsIn);
+}
+
+
+static void cb_onRunLoopUpdate(void* userVarIn)
+{
+	cxa_ioStream_buffered_t *const ioStreamIn = (cxa_ioStream_buffered_t*)userVarIn;
+	cxa_assert(ioStreamIn);
+
+	cxa_ioStream_buffered_flush(ioStreamIn);
+}
@@ -22,6 +22,7 @@
 
 // ******** local function prototypes ********
 static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
@@ -39,6 +40,7 @@ void cxa_ioStream_loopback_init(cxa_ioStream_loopback_t *const ioStreamIn)
 	// initialize our super class
 	cxa_ioStream_init(&ioStreamIn->super);
 	cxa_ioStream_bind(&ioStreamIn->super, read_cb, write_cb, (void*)ioStreamIn);
+	cxa_ioStream_bindReadBytes(&ioStreamIn->super, readBytes_cb);
 }
 
 
@@ -52,6 +54,29 @@ static cxa_ioStream_readStatus_t read_cb(uint8_t *const byteOut, void *const use
 }
 
 
+static cxa_ioStream_readStatus_t readBytes_cb(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_assert(userVarIn);
+	cxa_ioStream_loopback_t* ioStreamIn = (cxa_ioStream_loopback_t*)userVarIn;
+	*numBytesReadOut = 0;
+
+	// at most two contiguous runs (if the fifo has wrapped)
+	for( int i = 0; (i < 2) && (*numBytesReadOut < maxNumBytesIn); i++ )
+	{
+		void* elems = NULL;
+		size_t numContiguous_bytes = cxa_fixedFifo_bulkDequeue_peek(&ioStreamIn->fifo, &elems);
+		if( numContiguous_bytes == 0 ) break;
+		if( numContiguous_bytes > (maxNumBytesIn - *numBytesReadOut) ) numContiguous_bytes = maxNumBytesIn - *numBytesReadOut;
+
+		memcpy(&buffOut[*numBytesReadOut], elems, numContiguous_bytes);
+		cxa_fixedFifo_bulkDequeue(&ioStreamIn->fifo, numContiguous_bytes);
+		*numBytesReadOut += numContiguous_bytes;
+	}
+
+	return (*numBytesReadOut > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
 static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_assert(userVarIn);
@@ -21,9 +21,13 @@
 
 
 // ******** local function prototypes ********
+static cxa_ioStream_readStatus_t readBytesFromFifo(cxa_fixedFifo_t *const fifoIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut);
+
 static cxa_ioStream_readStatus_t read_cb_ep1(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t readBytes_cb_ep1(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool write_cb_ep1(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 static cxa_ioStream_readStatus_t read_cb_ep2(uint8_t *const byteOut, void *const userVarIn);
+static cxa_ioStream_readStatus_t readBytes_cb_ep2(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn);
 static bool write_cb_ep2(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
@@ -38,10 +42,12 @@ void cxa_ioStream_pipe_init(cxa_ioStream_pipe_t *const ioStreamIn)
 	// initialize our ioStreams
 	cxa_ioStream_init(&ioStreamIn->endPoint1);
 	cxa_ioStream_bind(&ioStreamIn->endPoint1, read_cb_ep1, write_cb_ep1, (void*)ioStreamIn);
+	cxa_ioStream_bindReadBytes(&ioStreamIn->endPoint1, readBytes_cb_ep1);
 	cxa_fixedFifo_initStd(&ioStreamIn->fifo_ep1Read, CXA_FF_ON_FULL_DROP, ioStreamIn->fifo_ep1Read_raw);
 
 	cxa_ioStream_init(&ioStreamIn->endPoint2);
 	cxa_ioStream_bind(&ioStreamIn->endPoint2, read_cb_ep2, write_cb_ep2, (void*)ioStreamIn);
+	cxa_ioStream_bindReadBytes(&ioStreamIn->endPoint2, readBytes_cb_ep2);
 	cxa_fixedFifo_initStd(&ioStreamIn->fifo_ep2Read, CXA_FF_ON_FULL_DROP, ioStreamIn->fifo_ep2Read_raw);
 }
 
@@ -60,6 +66,27 @@ cxa_ioStream_t* cxa_ioStream_pipe_getEndpoint2(cxa_ioStream_pipe_t* const ioStre
 
 
 // ******** local function implementations ********
+static cxa_ioStream_readStatus_t readBytesFromFifo(cxa_fixedFifo_t *const fifoIn, uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut)
+{
+	*numBytesReadOut = 0;
+
+	// at most two contiguous runs (if the fifo has wrapped)
+	for( int i = 0; (i < 2) && (*numBytesReadOut < maxNumBytesIn); i++ )
+	{
+		void* elems = NULL;
+		size_t numContiguous_bytes = cxa_fixedFifo_bulkDequeue_peek(fifoIn, &elems);
+		if( numContiguous_bytes == 0 ) break;
+		if( numContiguous_bytes > (maxNumBytesIn - *numBytesReadOut) ) numContiguous_bytes = maxNumBytesIn - *numBytesReadOut;
+
+		memcpy(&buffOut[*numBytesReadOut], elems, numContiguous_bytes);
+		cxa_fixedFifo_bulkDequeue(fifoIn, numContiguous_bytes);
+		*numBytesReadOut += numContiguous_bytes;
+	}
+
+	return (*numBytesReadOut > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
 static cxa_ioStream_readStatus_t read_cb_ep1(uint8_t *const byteOut, void *const userVarIn)
 {
 	cxa_assert(userVarIn);
@@ -69,6 +96,15 @@ static cxa_ioStream_readStatus_t read_cb_ep1(uint8_t *const byteOut, void *const
 }
 
 
+static cxa_ioStream_readStatus_t readBytes_cb_ep1(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_assert(userVarIn);
+	cxa_ioStream_pipe_t* ioStreamIn = (cxa_ioStream_pipe_t*)userVarIn;
+
+	return readBytesFromFifo(&ioStreamIn->fifo_ep1Read, buffOut, maxNumBytesIn, numBytesReadOut);
+}
+
+
 static bool write_cb_ep1(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_assert(userVarIn);
@@ -93,6 +129,15 @@ static cxa_ioStream_readStatus_t read_cb_ep2(uint8_t *const byteOut, void *const
 }
 
 
+static cxa_ioStream_readStatus_t readBytes_cb_ep2(uint8_t *const buffOut, size_t maxNumBytesIn, size_t *const numBytesReadOut, void *const userVarIn)
+{
+	cxa_assert(userVarIn);
+	cxa_ioStream_pipe_t* ioStreamIn = (cxa_ioStream_pipe_t*)userVarIn;
+
+	return readBytesFromFifo(&ioStreamIn->fifo_ep2Read, buffOut, maxNumBytesIn, numBytesReadOut);
+}
+
+
 static bool write_cb_ep2(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
 {
 	cxa_assert(userVarIn);
@@ -10,6 +10,7 @@
 // ******** includes ********
 #include <stdio.h>
 #include <cxa_assert.h>
+#include <cxa_numberUtils.h>
 
 #define CXA_LOG_LEVEL		CXA_LOG_LEVEL_DEBUG
 #include <cxa_logger_implementation.h>
@@ -22,6 +23,11 @@
 
 
 // ******** local function prototypes ********
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+static cxa_protocolParser_rxPoolEntry_t* rxPool_getEntry(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn);
+static size_t rxPool_countFree(cxa_protocolParser_t *const ppIn);
+static cxa_fixedByteBuffer_t* rxPool_getFreeBuffer(cxa_protocolParser_t *const ppIn);
+#endif
 
 
 // ********  local variable declarations *********
@@ -43,6 +49,8 @@ void cxa_protocolParser_init(cxa_protocolParser_t *const ppIn, cxa_ioStream_t *c
 
 	// save our references
 	ppIn->ioStream = ioStreamIn;
+	ppIn->rxChunk_size_bytes = 0;
+	ppIn->rxChunk_index = 0;
 	ppIn->currBuffer = buffIn;
 	ppIn->scm_canSetBuffer = scm_canSetBufferIn;
 	ppIn->scm_gotoIdle = scm_gotoIdleIn;
@@ -59,6 +67,15 @@ void cxa_protocolParser_init(cxa_protocolParser_t *const ppIn, cxa_ioStream_t *c
 	// setup our listeners
 	cxa_array_initStd(&ppIn->protocolListeners, ppIn->protocolListeners_raw);
 	cxa_array_initStd(&ppIn->packetListeners, ppIn->packetListeners_raw);
+
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	// setup our receive pool (starting with the buffer we were given)
+	cxa_array_initStd(&ppIn->rxPool, ppIn->rxPool_raw);
+	ppIn->rxPool_isStalled = false;
+	ppIn->rxPool_minNumFree = 0;
+	ppIn->rxPool_numExhausted = 0;
+	if( buffIn != NULL ) cxa_protocolParser_addRxBuffer(ppIn, buffIn);
+#endif
 }
 
 
@@ -99,6 +116,11 @@ void cxa_protocolParser_setBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByt
 {
 	cxa_assert(ppIn);
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	// an explicit buffer overrides any pool stall
+	ppIn->rxPool_isStalled = false;
+#endif
+
 	// handle our special cases
 	if( buffIn == NULL)
 	{
@@ -148,6 +170,75 @@ bool cxa_protocolParser_writePacket_bytes(cxa_protocolParser_t *const ppIn, void
 }
 
 
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+void cxa_protocolParser_addRxBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(ppIn);
+	cxa_assert(fbbIn);
+	cxa_assert(rxPool_getEntry(ppIn, fbbIn) == NULL);
+
+	cxa_protocolParser_rxPoolEntry_t newEntry = {.fbb=fbbIn, .refCount=0};
+	cxa_assert_msg( cxa_array_append(&ppIn->rxPool, &newEntry), "increase CXA_PROTOCOLPARSER_RXPOOL_MAXNUM_BUFFERS" );
+
+	// this is configuration time...start our low-water mark over
+	ppIn->rxPool_minNumFree = rxPool_countFree(ppIn);
+
+	// if we were waiting on a buffer, we have one now
+	if( ppIn->rxPool_isStalled )
+	{
+		ppIn->rxPool_isStalled = false;
+		ppIn->currBuffer = fbbIn;
+	}
+}
+
+
+bool cxa_protocolParser_retainBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(ppIn);
+	cxa_assert(fbbIn);
+
+	cxa_protocolParser_rxPoolEntry_t* entry = rxPool_getEntry(ppIn, fbbIn);
+	if( entry == NULL ) return false;
+
+	entry->refCount++;
+	return true;
+}
+
+
+void cxa_protocolParser_releaseBuffer(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(ppIn);
+	cxa_assert(fbbIn);
+
+	cxa_protocolParser_rxPoolEntry_t* entry = rxPool_getEntry(ppIn, fbbIn);
+	cxa_assert_msg(entry, "buffer not in rxPool");
+	cxa_assert_msg((entry->refCount > 0), "buffer not retained");
+
+	entry->refCount--;
+
+	// if the parser was waiting on a buffer, give it this one
+	if( (entry->refCount == 0) && ppIn->rxPool_isStalled )
+	{
+		cxa_logger_debug(&ppIn->logger, "rx buffer released, resuming");
+		ppIn->rxPool_isStalled = false;
+		ppIn->currBuffer = fbbIn;
+	}
+}
+
+
+void cxa_protocolParser_getRxPoolStats(cxa_protocolParser_t *const ppIn, cxa_protocolParser_rxPoolStats_t *const statsOut)
+{
+	cxa_assert(ppIn);
+	cxa_assert(statsOut);
+
+	statsOut->numBuffers = cxa_array_getSize_elems(&ppIn->rxPool);
+	statsOut->numFree = rxPool_countFree(ppIn);
+	statsOut->minNumFree = ppIn->rxPool_minNumFree;
+	statsOut->numExhausted = ppIn->rxPool_numExhausted;
+}
+#endif
+
+
 void cxa_protocolParser_resetError(cxa_protocolParser_t *const ppIn)
 {
 	cxa_assert(ppIn);
@@ -158,6 +249,47 @@ void cxa_protocolParser_resetError(cxa_protocolParser_t *const ppIn)
 }
 
 
+cxa_ioStream_readStatus_t cxa_protocolParser_peekRxBytes(cxa_protocolParser_t *const ppIn, uint8_t **const bytesOut, size_t *const numBytesOut)
+{
+	cxa_assert(ppIn);
+	cxa_assert(bytesOut);
+	cxa_assert(numBytesOut);
+
+	// without a buffer there is nowhere to put a packet...leave the data in the ioStream
+	if( ppIn->currBuffer == NULL )
+	{
+		*numBytesOut = 0;
+		return CXA_IOSTREAM_READSTAT_NODATA;
+	}
+
+	// refill (with as much as the ioStream has available) once we've consumed everything
+	if( ppIn->rxChunk_index >= ppIn->rxChunk_size_bytes )
+	{
+		ppIn->rxChunk_index = 0;
+		cxa_ioStream_readStatus_t readStat = cxa_ioStream_readBytes(ppIn->ioStream, ppIn->rxChunk, sizeof(ppIn->rxChunk), &ppIn->rxChunk_size_bytes);
+		if( readStat != CXA_IOSTREAM_READSTAT_GOTDATA )
+		{
+			ppIn->rxChunk_size_bytes = 0;
+			*numBytesOut = 0;
+			return readStat;
+		}
+	}
+
+	*bytesOut = &ppIn->rxChunk[ppIn->rxChunk_index];
+	*numBytesOut = ppIn->rxChunk_size_bytes - ppIn->rxChunk_index;
+	return CXA_IOSTREAM_READSTAT_GOTDATA;
+}
+
+
+void cxa_protocolParser_consumeRxBytes(cxa_protocolParser_t *const ppIn, size_t numBytesIn)
+{
+	cxa_assert(ppIn);
+	cxa_assert(numBytesIn <= (ppIn->rxChunk_size_bytes - ppIn->rxChunk_index));
+
+	ppIn->rxChunk_index += numBytesIn;
+}
+
+
 void cxa_protocolParser_notify_ioException(cxa_protocolParser_t *const ppIn)
 {
 	cxa_assert(ppIn);
@@ -203,7 +335,70 @@ void cxa_protocolParser_notify_packetReceived(cxa_protocolParser_t *const ppIn,
 			currEntry->cb(ppIn->currBuffer, currEntry->userVar);
 		}
 	}
+
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+	// if a listener kept this packet, keep receiving into another buffer
+	cxa_protocolParser_rxPoolEntry_t* entry = (ppIn->currBuffer != NULL) ? rxPool_getEntry(ppIn, ppIn->currBuffer) : NULL;
+	if( (entry != NULL) && (entry->refCount > 0) )
+	{
+		ppIn->currBuffer = rxPool_getFreeBuffer(ppIn);
+		if( ppIn->currBuffer == NULL )
+		{
+			cxa_logger_warn(&ppIn->logger, "rx buffers exhausted, pausing reception");
+			ppIn->rxPool_isStalled = true;
+			ppIn->rxPool_numExhausted++;
+		}
+		else
+		{
+			ppIn->rxPool_minNumFree = CXA_MIN(ppIn->rxPool_minNumFree, rxPool_countFree(ppIn));
+		}
+	}
+#endif
 }
 
 
 // ******** local function implementations ********
+#ifdef CXA_PROTOCOLPARSER_RXPOOL_ENABLE
+static cxa_protocolParser_rxPoolEntry_t* rxPool_getEntry(cxa_protocolParser_t *const ppIn, cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(ppIn);
+
+	cxa_array_iterate(&ppIn->rxPool, currEntry, cxa_protocolParser_rxPoolEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+
+		if( currEntry->fbb == fbbIn ) return currEntry;
+	}
+	return NULL;
+}
+
+
+static size_t rxPool_countFree(cxa_protocolParser_t *const ppIn)
+{
+	cxa_assert(ppIn);
+
+	size_t retVal = 0;
+	cxa_array_iterate(&ppIn->rxPool, currEntry, cxa_protocolParser_rxPoolEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+
+		// the buffer we're currently receiving into isn't free
+		if( (currEntry->refCount == 0) && (currEntry->fbb != ppIn->currBuffer) ) retVal++;
+	}
+	return retVal;
+}
+
+
+static cxa_fixedByteBuffer_t* rxPool_getFreeBuffer(cxa_protocolParser_t *const ppIn)
+{
+	cxa_assert(ppIn);
+
+	cxa_array_iterate(&ppIn->rxPool, currEntry, cxa_protocolParser_rxPoolEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+
+		if( (currEntry->refCount == 0) && (currEntry->fbb != ppIn->currBuffer) ) return currEntry->fbb;
+	}
+	return NULL;
+}
+#endif
@@ -8,16 +8,24 @@
 
 
 // ******** includes ********
+#include <string.h>
 #include <cxa_assert.h>
+#include <cxa_numberUtils.h>
 
 #define CXA_LOG_LEVEL		CXA_LOG_LEVEL_INFO
 #include <cxa_logger_implementation.h>
 
 
 // ******** local macro definitions ********
-#define MAX_NUM_RX_BYTES_PER_UPDATE		16
 #define RECEPTION_TIMEOUT_MS			5000
 
+#define HEADER_SIZE_BYTES				4
+#define TRAILER_SIZE_BYTES_V1			1
+#define TRAILER_SIZE_BYTES_V2			3
+
+// wait0x80 -> wait0x81 -> waitLen -> waitDataBytes -> processPacket -> wait0x80: one packet per iteration
+#define MAXNUM_TRANSITIONS_PER_UPDATE	5
+
 
 // ******** local type definitions ********
 typedef enum
@@ -39,6 +47,7 @@ static void scm_gotoIdle(cxa_protocolParser_t *const superIn);
 static void scm_reset(cxa_protocolParser_t *const superIn);
 static bool scm_writeBytes(cxa_protocolParser_t *const superIn, cxa_fixedByteBuffer_t *const fbbIn);
 
+static size_t getTrailerSize_bytes(cxa_protocolParser_cleProto_t *const clePpIn);
 
 static void rxState_cb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void rxState_cb_idle_state(cxa_stateMachine_t *const smIn, void *userVarIn);
@@ -60,6 +69,8 @@ void cxa_protocolParser_cleProto_init(cxa_protocolParser_cleProto_t *const clePp
 	cxa_assert(clePpIn);
 	cxa_assert(ioStreamIn);
 
+	clePpIn->framing = CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V1;
+
 	// initialize our super class
 	cxa_protocolParser_init(&clePpIn->super, ioStreamIn, buffIn, scm_isInErrorState, scm_canSetBuffer, scm_gotoIdle, scm_reset, scm_writeBytes);
 
@@ -73,6 +84,24 @@ void cxa_protocolParser_cleProto_init(cxa_protocolParser_cleProto_t *const clePp
 	cxa_stateMachine_addState(&clePpIn->stateMachine, RX_STATE_PROCESS_PACKET, "processPacket", NULL, rxState_cb_processPacket_state, NULL, (void*)clePpIn);
 	cxa_stateMachine_addState(&clePpIn->stateMachine, RX_STATE_ERROR, "error", rxState_cb_error_enter, NULL, NULL, (void*)clePpIn);
 	cxa_stateMachine_setInitialState(&clePpIn->stateMachine, RX_STATE_IDLE);
+	cxa_stateMachine_setRunToCompletion(&clePpIn->stateMachine, MAXNUM_TRANSITIONS_PER_UPDATE);
+}
+
+
+void cxa_protocolParser_cleProto_setFraming(cxa_protocolParser_cleProto_t *const clePpIn, cxa_protocolParser_cleProto_framing_t framingIn)
+{
+	cxa_assert(clePpIn);
+	cxa_assert( (framingIn == CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V1) || (framingIn == CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2) );
+
+	if( clePpIn->framing == framingIn ) return;
+	clePpIn->framing = framingIn;
+
+	// anything we've received so far was framed the old way
+	rxState_t currState = (rxState_t)cxa_stateMachine_getCurrentState(&clePpIn->stateMachine);
+	if( (currState == RX_STATE_WAIT_0x81) || (currState == RX_STATE_WAIT_LEN) || (currState == RX_STATE_WAIT_DATA_BYTES) )
+	{
+		cxa_stateMachine_transitionNow(&clePpIn->stateMachine, RX_STATE_WAIT_0x80);
+	}
 }
 
 
@@ -126,26 +155,42 @@ static bool scm_writeBytes(cxa_protocolParser_t *const superIn, cxa_fixedByteBuf
 
 	// message _should_ be configured properly...get our size
 	size_t msgSize_bytes = (fbbIn != NULL) ? cxa_fixedByteBuffer_getSize_bytes(fbbIn) : 0;
-	cxa_assert(msgSize_bytes <= (65535-3));
+	size_t trailerSize_bytes = getTrailerSize_bytes(clePpIn);
+	cxa_assert(msgSize_bytes <= (65535-TRAILER_SIZE_BYTES_V2));
 
 	// make sure we're in a good state
 	if( clePpIn->super.scm_isInError(&clePpIn->super) || !cxa_ioStream_isBound(clePpIn->super.ioStream) ) return false;
 
-	// write our header
-	if( !cxa_ioStream_writeByte(clePpIn->super.ioStream, 0x80) ) return false;
-	if( !cxa_ioStream_writeByte(clePpIn->super.ioStream, 0x81) ) return false;
+	// build our header and trailer so the whole frame goes out in a single write
+	size_t len = msgSize_bytes + trailerSize_bytes;
+	uint8_t header[HEADER_SIZE_BYTES] = { 0x80, 0x81, ((len & 0x00FF) >> 0), ((len & 0xFF00) >> 8) };
+	uint8_t* payload = (msgSize_bytes > 0) ? cxa_fixedByteBuffer_get_pointerToIndex(fbbIn, 0) : NULL;
+
+	uint8_t trailer[TRAILER_SIZE_BYTES_V2];
+	if( clePpIn->framing == CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2 )
+	{
+		uint16_t crc = cxa_numberUtils_crc16_update(0, &header[2], 2);
+		crc = cxa_numberUtils_crc16_update(crc, payload, msgSize_bytes);
+		trailer[0] = ((crc & 0x00FF) >> 0);
+		trailer[1] = ((crc & 0xFF00) >> 8);
+	}
+	trailer[trailerSize_bytes-1] = 0x82;
 
-	size_t len = msgSize_bytes + 1;
-	if( !cxa_ioStream_writeByte(clePpIn->super.ioStream, ((len & 0x00FF) >> 0)) ) return false;
-	if( !cxa_ioStream_writeByte(clePpIn->super.ioStream, ((len & 0xFF00) >> 8)) ) return false;
+	cxa_ioStream_ioVec_t vecs[] =
+	{
+		{ .buff = header, .bufferSize_bytes = sizeof(header) },
+		{ .buff = payload, .bufferSize_bytes = msgSize_bytes },
+		{ .buff = trailer, .bufferSize_bytes = trailerSize_bytes }
+	};
+	return cxa_ioStream_writeVectored(clePpIn->super.ioStream, vecs, sizeof(vecs)/sizeof(*vecs));
+}
 
-	// write our data
-	if( (fbbIn != NULL) && !cxa_ioStream_writeFixedByteBuffer(clePpIn->super.ioStream, fbbIn) ) return false;
 
-	// write our footer
-	if( !cxa_ioStream_writeByte(clePpIn->super.ioStream, 0x82) ) return false;
+static size_t getTrailerSize_bytes(cxa_protocolParser_cleProto_t *const clePpIn)
+{
+	cxa_assert(clePpIn);
 
-	return true;
+	return (clePpIn->framing == CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2) ? TRAILER_SIZE_BYTES_V2 : TRAILER_SIZE_BYTES_V1;
 }
 
 
@@ -186,26 +231,30 @@ static void rxState_cb_wait0x80_state(cxa_stateMachine_t *const smIn, void *user
 	cxa_protocolParser_cleProto_t* clePpIn = (cxa_protocolParser_cleProto_t*)userVarIn;
 	cxa_assert(clePpIn);
 
-	uint8_t rxByte;
-	for( uint8_t i = 0; i < MAX_NUM_RX_BYTES_PER_UPDATE; i++ )
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&clePpIn->super, &rxBytes, &numRxBytes);
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
+	else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
 	{
-		cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(clePpIn->super.ioStream, &rxByte);
-		if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
-		else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+		// skip everything up to our first header byte
+		uint8_t* headerByte = memchr(rxBytes, 0x80, numRxBytes);
+		if( headerByte == NULL )
 		{
-			if( rxByte == 0x80 )
-			{
-				// we've gotten our first header byte
-				cxa_fixedByteBuffer_clear(clePpIn->super.currBuffer);
-				if( !cxa_fixedByteBuffer_append_uint8(clePpIn->super.currBuffer, rxByte) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
+			cxa_protocolParser_consumeRxBytes(&clePpIn->super, numRxBytes);
+			return;
+		}
+		cxa_protocolParser_consumeRxBytes(&clePpIn->super, (size_t)(headerByte - rxBytes) + 1);
 
-				// start our reception timeout timeDiff
-				cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
+		// we've gotten our first header byte
+		cxa_fixedByteBuffer_clear(clePpIn->super.currBuffer);
+		if( !cxa_fixedByteBuffer_append_uint8(clePpIn->super.currBuffer, 0x80) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
 
-				cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_WAIT_0x81);
-				return;
-			}
-		}
+		// start our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
+
+		cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_WAIT_0x81);
+		return;
 	}
 }
 
@@ -215,14 +264,18 @@ static void rxState_cb_wait0x81_state(cxa_stateMachine_t *const smIn, void *user
 	cxa_protocolParser_cleProto_t* clePpIn = (cxa_protocolParser_cleProto_t*)userVarIn;
 	cxa_assert(clePpIn);
 
-	uint8_t rxByte;
-	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(clePpIn->super.ioStream, &rxByte);
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&clePpIn->super, &rxBytes, &numRxBytes);
 	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
 	else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
 	{
 		// reset our reception timeout timeDiff
 		cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
 
+		uint8_t rxByte = rxBytes[0];
+		cxa_protocolParser_consumeRxBytes(&clePpIn->super, 1);
+
 		if( rxByte == 0x81 )
 		{
 			// we have a valid second header byte
@@ -253,24 +306,33 @@ static void rxState_cb_waitLen_state(cxa_stateMachine_t *const smIn, void *userV
 	cxa_protocolParser_cleProto_t* clePpIn = (cxa_protocolParser_cleProto_t*)userVarIn;
 	cxa_assert(clePpIn);
 
-	uint8_t rxByte;
-	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(clePpIn->super.ioStream, &rxByte);
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&clePpIn->super, &rxBytes, &numRxBytes);
 	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
 	else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
 	{
 		// reset our reception timeout timeDiff
 		cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
 
-		// just append the byte
-		if( !cxa_fixedByteBuffer_append_uint8(clePpIn->super.currBuffer, rxByte) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
-		if( cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer) == 4 )
+		// append as many length bytes as we need (and have)
+		size_t numLenBytes = HEADER_SIZE_BYTES - cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer);
+		if( numLenBytes > numRxBytes ) numLenBytes = numRxBytes;
+		if( !cxa_fixedByteBuffer_append(clePpIn->super.currBuffer, rxBytes, numLenBytes) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
+		cxa_protocolParser_consumeRxBytes(&clePpIn->super, numLenBytes);
+
+		if( cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer) == HEADER_SIZE_BYTES )
 		{
 			// we have all of our length bytes...make sure it's valid
 			uint16_t len_bytes;
-			if( cxa_fixedByteBuffer_get_uint16LE(clePpIn->super.currBuffer, 2, len_bytes) && (len_bytes >= 1) )
+			if( cxa_fixedByteBuffer_get_uint16LE(clePpIn->super.currBuffer, 2, len_bytes) && (len_bytes >= getTrailerSize_bytes(clePpIn)) )
 			{
 				cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_WAIT_DATA_BYTES);
 			}
+			else
+			{
+				cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_WAIT_0x80);
+			}
 			return;
 		}
 	}
@@ -292,7 +354,8 @@ static void rxState_cb_waitDataBytes_state(cxa_stateMachine_t *const smIn, void
 
 	// allocate here to avoid stack issues on TI TMS320
 	size_t currSize_bytes;
-	uint8_t rxByte;
+	uint8_t* rxBytes;
+	size_t numRxBytes;
 	cxa_ioStream_readStatus_t readStat;
 
 	// get our expected size
@@ -303,31 +366,32 @@ static void rxState_cb_waitDataBytes_state(cxa_stateMachine_t *const smIn, void
 		return;
 	}
 
-	// do a limited number of iterations
-	for( uint8_t i = 0; i < MAX_NUM_RX_BYTES_PER_UPDATE; i++ )
+	currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer) - HEADER_SIZE_BYTES;
+	if( currSize_bytes >= expectedSize_bytes )
 	{
-		currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer) - 4;
+		// we're done receiving our data bytes
+		cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_PROCESS_PACKET);
+		return;
+	}
 
-		if( currSize_bytes < expectedSize_bytes )
-		{
-			// we have more bytes to receive
-			readStat = cxa_ioStream_readByte(clePpIn->super.ioStream, &rxByte);
-			if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
-			else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
-			{
-				// reset our reception timeout timeDiff
-				cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
+	// we have more bytes to receive...take as many as we can, chunk by chunk, until the ioStream runs dry
+	while( (readStat = cxa_protocolParser_peekRxBytes(&clePpIn->super, &rxBytes, &numRxBytes)) == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		// reset our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&clePpIn->super.td_timeout);
 
-				if( !cxa_fixedByteBuffer_append_uint8(clePpIn->super.currBuffer, rxByte) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
-			}
-		}
-		else
+		if( numRxBytes > (expectedSize_bytes - currSize_bytes) ) numRxBytes = expectedSize_bytes - currSize_bytes;
+		if( !cxa_fixedByteBuffer_append(clePpIn->super.currBuffer, rxBytes, numRxBytes) ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
+		cxa_protocolParser_consumeRxBytes(&clePpIn->super, numRxBytes);
+		currSize_bytes += numRxBytes;
+
+		if( currSize_bytes >= expectedSize_bytes )
 		{
-			// we're done receiving our data bytes
 			cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_PROCESS_PACKET);
 			return;
 		}
 	}
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&clePpIn->stateMachine, RX_STATE_ERROR); return; }
 
 	// check to see if we've had a reception timeout
 	if( cxa_timeDiff_isElapsed_ms(&clePpIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
@@ -345,23 +409,34 @@ static void rxState_cb_processPacket_state(cxa_stateMachine_t *const smIn, void
 	cxa_assert(clePpIn);
 
 	size_t currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer);
+	size_t trailerSize_bytes = getTrailerSize_bytes(clePpIn);
 
 	uint8_t tmpVal8;
 	uint16_t tmpVal16;
 
 	// make sure our packet is kosher
-	if( (currSize_bytes >= 5) &&
-		(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, 0, tmpVal8) && (tmpVal8 == 0x80)) &&
-		(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, 1, tmpVal8) && (tmpVal8 == 0x81)) &&
-		(cxa_fixedByteBuffer_get_uint16LE(clePpIn->super.currBuffer, 2, tmpVal16) && (tmpVal16 == (currSize_bytes-4))) &&
-		(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, currSize_bytes-1, tmpVal8) && (tmpVal8 == 0x82)) )
+	bool isValid = (currSize_bytes >= (HEADER_SIZE_BYTES + trailerSize_bytes)) &&
+			(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, 0, tmpVal8) && (tmpVal8 == 0x80)) &&
+			(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, 1, tmpVal8) && (tmpVal8 == 0x81)) &&
+			(cxa_fixedByteBuffer_get_uint16LE(clePpIn->super.currBuffer, 2, tmpVal16) && (tmpVal16 == (currSize_bytes-HEADER_SIZE_BYTES))) &&
+			(cxa_fixedByteBuffer_get_uint8(clePpIn->super.currBuffer, currSize_bytes-1, tmpVal8) && (tmpVal8 == 0x82));
+
+	// v2 also carries a crc over the length field and payload
+	if( isValid && (clePpIn->framing == CXA_PROTOCOLPARSER_CLEPROTO_FRAMING_V2) )
+	{
+		uint16_t calcCrc = cxa_numberUtils_crc16_oneShot(cxa_fixedByteBuffer_get_pointerToIndex(clePpIn->super.currBuffer, 2), currSize_bytes - 2 - trailerSize_bytes);
+		isValid = cxa_fixedByteBuffer_get_uint16LE(clePpIn->super.currBuffer, currSize_bytes-trailerSize_bytes, tmpVal16) && (tmpVal16 == calcCrc);
+		if( !isValid ) cxa_logger_debug(&clePpIn->super.logger, "crc mismatch");
+	}
+
+	if( isValid )
 	{
 		// we received a message
 		cxa_logger_trace(&clePpIn->super.logger, "message received...calling listeners");
 
-		// ...but first, strip the header and footer
-		cxa_fixedByteBuffer_remove(clePpIn->super.currBuffer, 0, 4);
-		cxa_fixedByteBuffer_remove(clePpIn->super.currBuffer, cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer)-1, 1);
+		// ...but first, strip the header and trailer
+		cxa_fixedByteBuffer_remove(clePpIn->super.currBuffer, 0, HEADER_SIZE_BYTES);
+		cxa_fixedByteBuffer_remove(clePpIn->super.currBuffer, cxa_fixedByteBuffer_getSize_bytes(clePpIn->super.currBuffer)-trailerSize_bytes, trailerSize_bytes);
 
 		cxa_protocolParser_notify_packetReceived(&clePpIn->super, clePpIn->super.currBuffer);
 	}
@@ -15,9 +15,12 @@
 
 
 // ******** local macro definitions ********
-#define MAX_NUM_RX_BYTES_PER_UPDATE		16
 #define RECEPTION_TIMEOUT_MS			5000
 
+// waitFirstByte -> processPacket -> waitFirstByte: one line per iteration (listeners' own
+// transitions are deferred, so they need to see each line before the next one arrives)
+#define MAXNUM_TRANSITIONS_PER_UPDATE	2
+
 
 // ******** local type definitions ********
 typedef enum
@@ -39,6 +42,8 @@ static void scm_reset(cxa_protocolParser_t *const superIn);
 static bool scm_writeBytes(cxa_protocolParser_t *const superIn, cxa_fixedByteBuffer_t *const fbbIn);
 
 
+static void consumeLineBytes(cxa_protocolParser_crlf_t *const crlfPpIn, rxState_t currStateIn, uint8_t* rxBytesIn, size_t numRxBytesIn);
+
 static void rxState_cb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void rxState_cb_idle_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void rxState_cb_idle_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void *userVarIn);
@@ -72,6 +77,7 @@ void cxa_protocolParser_crlf_init(cxa_protocolParser_crlf_t *const crlfPpIn, cxa
 	cxa_stateMachine_addState(&crlfPpIn->stateMachine, RX_STATE_PROCESS_PACKET, "processPacket", NULL, rxState_cb_processPacket_state, NULL, (void*)crlfPpIn);
 	cxa_stateMachine_addState(&crlfPpIn->stateMachine, RX_STATE_ERROR, "error", rxState_cb_error_enter, NULL, NULL, (void*)crlfPpIn);
 	cxa_stateMachine_setInitialState(&crlfPpIn->stateMachine, RX_STATE_IDLE);
+	cxa_stateMachine_setRunToCompletion(&crlfPpIn->stateMachine, MAXNUM_TRANSITIONS_PER_UPDATE);
 }
 
 
@@ -152,6 +158,41 @@ static bool scm_writeBytes(cxa_protocolParser_t *const superIn, cxa_fixedByteBuf
 }
 
 
+static void consumeLineBytes(cxa_protocolParser_crlf_t *const crlfPpIn, rxState_t currStateIn, uint8_t* rxBytesIn, size_t numRxBytesIn)
+{
+	cxa_assert(crlfPpIn);
+
+	// walk the chunks until we've found the end of the line (or the ioStream runs dry)...
+	// a line that straddles chunks still goes straight to processPacket
+	rxState_t nextState = currStateIn;
+	do
+	{
+		size_t numBytesConsumed = 0;
+		while( (numBytesConsumed < numRxBytesIn) && (nextState != RX_STATE_PROCESS_PACKET) )
+		{
+			uint8_t rxByte = rxBytesIn[numBytesConsumed++];
+
+			if( nextState == RX_STATE_WAIT_LF )
+			{
+				// if we don't get our LF, we need to start looking for a CR again
+				nextState = (rxByte == '\n') ? RX_STATE_PROCESS_PACKET : RX_STATE_WAIT_CR;
+			}
+			else
+			{
+				nextState = (rxByte == '\r') ? RX_STATE_WAIT_LF : RX_STATE_WAIT_CR;
+			}
+		}
+
+		// save the bytes (leaving any after the line for the next packet)
+		cxa_fixedByteBuffer_append(crlfPpIn->super.currBuffer, rxBytesIn, numBytesConsumed);
+		cxa_protocolParser_consumeRxBytes(&crlfPpIn->super, numBytesConsumed);
+	} while( (nextState != RX_STATE_PROCESS_PACKET) &&
+			 (cxa_protocolParser_peekRxBytes(&crlfPpIn->super, &rxBytesIn, &numRxBytesIn) == CXA_IOSTREAM_READSTAT_GOTDATA) );
+
+	if( nextState != currStateIn ) cxa_stateMachine_transition(&crlfPpIn->stateMachine, nextState);
+}
+
+
 static void rxState_cb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
 {
 	cxa_protocolParser_crlf_t* crlfPpIn = (cxa_protocolParser_crlf_t*)userVarIn;
@@ -189,34 +230,23 @@ static void rxState_cb_waitFirstByte_state(cxa_stateMachine_t *const smIn, void
 	cxa_protocolParser_crlf_t* crlfPpIn = (cxa_protocolParser_crlf_t*)userVarIn;
 	cxa_assert(crlfPpIn);
 
-	uint8_t rxByte;
-	for( uint8_t i = 0; i < MAX_NUM_RX_BYTES_PER_UPDATE; i++ )
-	{
-		// make sure we haven't been paused
-		if( crlfPpIn->isPaused ) return;
+	// make sure we haven't been paused
+	if( crlfPpIn->isPaused ) return;
 
-		cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(crlfPpIn->super.ioStream, &rxByte);
-		if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_ERROR); return; }
-		else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
-		{
-			// we've gotten our first byte
-			cxa_fixedByteBuffer_clear(crlfPpIn->super.currBuffer);
-			cxa_fixedByteBuffer_append_uint8(crlfPpIn->super.currBuffer, rxByte);
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&crlfPpIn->super, &rxBytes, &numRxBytes);
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_ERROR); return; }
+	else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		// we've gotten our first byte
+		cxa_fixedByteBuffer_clear(crlfPpIn->super.currBuffer);
 
-			// reset our reception timeout timeDiff
-			cxa_timeDiff_setStartTime_now(&crlfPpIn->super.td_timeout);
+		// reset our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&crlfPpIn->super.td_timeout);
 
-			// next state depends on the byte
-			if( rxByte == '\r' )
-			{
-				cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_LF);
-			}
-			else
-			{
-				cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_CR);
-			}
-			return;
-		}
+		// the rest of the chunk may well contain the remainder of the line
+		consumeLineBytes(crlfPpIn, RX_STATE_WAIT_FIRSTBYTE, rxBytes, numRxBytes);
 	}
 }
 
@@ -226,59 +256,29 @@ static void rxState_cb_waitCrLf_state(cxa_stateMachine_t *const smIn, void *user
 	cxa_protocolParser_crlf_t* crlfPpIn = (cxa_protocolParser_crlf_t*)userVarIn;
 	cxa_assert(crlfPpIn);
 
-	uint8_t rxByte;
-	for( uint8_t i = 0; i < MAX_NUM_RX_BYTES_PER_UPDATE; i++ )
-	{
-		// make sure we haven't been paused
-		if( crlfPpIn->isPaused ) return;
-
-		cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(crlfPpIn->super.ioStream, &rxByte);
-		if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_ERROR); return; }
-		else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
-		{
-			// reset our reception timeout timeDiff
-			cxa_timeDiff_setStartTime_now(&crlfPpIn->super.td_timeout);
-
-			// save the byte
-			cxa_fixedByteBuffer_append_uint8(crlfPpIn->super.currBuffer, rxByte);
+	// make sure we haven't been paused
+	if( crlfPpIn->isPaused ) return;
 
-			// see if we got the next byte we're looking for
-			rxState_t currState = cxa_stateMachine_getCurrentState(&crlfPpIn->stateMachine);
-			uint8_t targetByte = (currState == RX_STATE_WAIT_LF) ? '\n' : '\r';
+	uint8_t* rxBytes;
+	size_t numRxBytes;
+	cxa_ioStream_readStatus_t readStat = cxa_protocolParser_peekRxBytes(&crlfPpIn->super, &rxBytes, &numRxBytes);
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR ) { cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_ERROR); return; }
+	else if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		// reset our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&crlfPpIn->super.td_timeout);
 
-			if( rxByte == targetByte )
-			{
-				// this is the byte we're looking for
-				if( currState == RX_STATE_WAIT_CR )
-				{
-					cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_LF);
-					return;
-				}
-				else if( currState == RX_STATE_WAIT_LF )
-				{
-					cxa_stateMachine_transition(smIn, RX_STATE_PROCESS_PACKET);
-					return;
-				}
-			}
-			else
-			{
-				// if we already moved on in the state machine, reset ourselves
-				if( currState == RX_STATE_WAIT_LF )
-				{
-					cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_CR);
-					return;
-				}
-			}
-		}
+		consumeLineBytes(crlfPpIn, (rxState_t)cxa_stateMachine_getCurrentState(&crlfPpIn->stateMachine), rxBytes, numRxBytes);
+		return;
+	}
 
-		// check to see if we've had a reception timeout
-		if( cxa_timeDiff_isElapsed_ms(&crlfPpIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
-		{
-			cxa_logger_debug_memDump_fbb(&crlfPpIn->super.logger, "buff: ", crlfPpIn->super.currBuffer, NULL);
-			cxa_protocolParser_notify_receptionTimeout(&crlfPpIn->super);
-			cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_FIRSTBYTE);
-			return;
-		}
+	// check to see if we've had a reception timeout
+	if( cxa_timeDiff_isElapsed_ms(&crlfPpIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
+	{
+		cxa_logger_debug_memDump_fbb(&crlfPpIn->super.logger, "buff: ", crlfPpIn->super.currBuffer, NULL);
+		cxa_protocolParser_notify_receptionTimeout(&crlfPpIn->super);
+		cxa_stateMachine_transition(&crlfPpIn->stateMachine, RX_STATE_WAIT_FIRSTBYTE);
+		return;
 	}
 }
 
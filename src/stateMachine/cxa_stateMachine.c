@@ -24,6 +24,13 @@
 
 // ******** local function prototypes ********
 static void cb_onRunLoopUpdate(void* userVarIn);
+static cxa_runLoop_untimedState_t cb_getUntimedState(void* userVarIn);
+
+static void processTransition(cxa_stateMachine_t *const smIn);
+static void updateCurrentState(cxa_stateMachine_t *const smIn);
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+static void dispatchEvents(cxa_stateMachine_t *const smIn);
+#endif
 
 static cxa_stateMachine_state_t* getState_byId(cxa_stateMachine_t *const smIn, int idIn);
 
@@ -41,10 +48,17 @@ void cxa_stateMachine_init(cxa_stateMachine_t *const smIn, const char* nameIn, i
 	smIn->currState = NULL;
 	smIn->nextState = NULL;
 	smIn->hasStarted = false;
+	smIn->isStateUpdatePending = false;
+	smIn->maxTransitionsPerUpdate = 0;
 
 	// setup our internal state
 	cxa_array_init(&smIn->states, sizeof(*smIn->states_raw), (void*)smIn->states_raw, sizeof(smIn->states_raw));
 
+	#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+	cxa_array_initStd(&smIn->eventTransitions, smIn->eventTransitions_raw);
+	cxa_fixedFifo_initStd(&smIn->eventQueue, CXA_FF_ON_FULL_DROP, smIn->eventQueue_raw);
+	#endif
+
 	// setup our logger if it's enabled
 	#ifdef CXA_STATE_MACHINE_ENABLE_LOGGING
 	cxa_logger_init_formattedString(&smIn->logger, "fsm::%s", nameIn);
@@ -57,8 +71,8 @@ void cxa_stateMachine_init(cxa_stateMachine_t *const smIn, const char* nameIn, i
 	smIn->timedStatesEnabled = true;
 	#endif
 
-	// register for run loop execution
-	cxa_runLoop_addEntry(threadIdIn, NULL, cb_onRunLoopUpdate, (void*)smIn);
+	// register for run loop execution (reporting pending transitions so an idle thread doesn't sleep through them)
+	cxa_runLoop_addEntry_pollAware(threadIdIn, nameIn, NULL, cb_onRunLoopUpdate, cb_getUntimedState, (void*)smIn);
 }
 
 
@@ -160,6 +174,43 @@ void cxa_stateMachine_setInitialState(cxa_stateMachine_t *const smIn, int stateI
 }
 
 
+void cxa_stateMachine_setRunToCompletion(cxa_stateMachine_t *const smIn, uint8_t maxTransitionsPerUpdateIn)
+{
+	cxa_assert(smIn);
+
+	smIn->maxTransitionsPerUpdate = maxTransitionsPerUpdateIn;
+}
+
+
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+void cxa_stateMachine_addEventTransition(cxa_stateMachine_t *const smIn, int fromStateIdIn, int eventIdIn, int toStateIdIn,
+		cxa_stateMachine_cb_guard_t cb_guardIn, void *userVarIn)
+{
+	cxa_assert(smIn);
+	cxa_assert(!smIn->hasStarted);
+	cxa_assert((fromStateIdIn == CXA_STATE_MACHINE_STATE_UNKNOWN) || (getState_byId(smIn, fromStateIdIn) != NULL));
+	cxa_assert(getState_byId(smIn, toStateIdIn) != NULL);
+
+	cxa_stateMachine_eventTransition_t newTransition = {
+															.fromStateId=fromStateIdIn,
+															.eventId=eventIdIn,
+															.toStateId=toStateIdIn,
+															.cb_guard=cb_guardIn,
+															.userVar=userVarIn
+														};
+	cxa_assert_msg(cxa_array_append(&smIn->eventTransitions, &newTransition), "increase 'CXA_STATE_MACHINE_MAXNUM_EVENT_TRANSITIONS'");
+}
+
+
+bool cxa_stateMachine_postEvent(cxa_stateMachine_t *const smIn, int eventIdIn)
+{
+	cxa_assert(smIn);
+
+	return cxa_fixedFifo_queue(&smIn->eventQueue, (void*)&eventIdIn);
+}
+#endif
+
+
 void cxa_stateMachine_transition(cxa_stateMachine_t *const smIn, int stateIdIn)
 {
 	cxa_assert(smIn);
@@ -187,8 +238,9 @@ void cxa_stateMachine_transitionNow(cxa_stateMachine_t *const smIn, int stateIdI
 	cxa_assert(smIn);
 	cxa_assert(smIn->hasStarted);
 
+	// only this transition (even when running to completion)
 	cxa_stateMachine_transition(smIn, stateIdIn);
-	cb_onRunLoopUpdate((void*)smIn);
+	processTransition(smIn);
 }
 
 
@@ -209,63 +261,159 @@ static void cb_onRunLoopUpdate(void* userVarIn)
 	// make sure we've been marked as started
 	if( !smIn->hasStarted ) smIn->hasStarted = true;
 
+	#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+	if( smIn->nextState == NULL ) dispatchEvents(smIn);
+	#endif
+
 	// see if we should transition
-	if( smIn->nextState != NULL )
+	if( smIn->maxTransitionsPerUpdate == 0 )
+	{
+		if( smIn->nextState != NULL ) processTransition(smIn);
+		else updateCurrentState(smIn);
+		return;
+	}
+
+	// run to completion...keep going as long as our states keep transitioning (within limits)
+	for( uint8_t numTransitions = 0; ; numTransitions++ )
 	{
-		// call the leaving function of our old state
-		if( smIn->currState != NULL )
+		if( smIn->nextState == NULL )
 		{
-			if( smIn->currState->cb_leaving != NULL ) smIn->currState->cb_leaving(smIn, smIn->nextState->stateId, smIn->currState->userVar);
+			updateCurrentState(smIn);
+			#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+			if( smIn->nextState == NULL ) dispatchEvents(smIn);
+			#endif
+			if( smIn->nextState == NULL ) break;
 		}
+		if( numTransitions >= smIn->maxTransitionsPerUpdate ) break;
+
+		processTransition(smIn);
+	}
+}
+
+
+static cxa_runLoop_untimedState_t cb_getUntimedState(void* userVarIn)
+{
+	cxa_stateMachine_t* smIn = (cxa_stateMachine_t*)userVarIn;
+	cxa_assert(smIn);
+
+	// a transition (or our initial state) or an event waiting to be processed
+	if( !smIn->hasStarted || (smIn->nextState != NULL) ) return CXA_RUNLOOP_UNTIMED_PENDINGWORK;
+	#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+	if( !cxa_fixedFifo_isEmpty(&smIn->eventQueue) ) return CXA_RUNLOOP_UNTIMED_PENDINGWORK;
+	#endif
+
+	// state callbacks (and timed states) check their own conditions...right after entering, then polled
+	if( smIn->currState == NULL ) return CXA_RUNLOOP_UNTIMED_IDLE;
+	bool isPolled = (smIn->currState->cb_state != NULL);
+	#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
+	if( smIn->timedStatesEnabled && (smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) ) isPolled = true;
+	#endif
+	if( !isPolled ) return CXA_RUNLOOP_UNTIMED_IDLE;
+	return smIn->isStateUpdatePending ? CXA_RUNLOOP_UNTIMED_PENDINGWORK : CXA_RUNLOOP_UNTIMED_MUSTPOLL;
+}
+
 
-		// call the entering function of our new state
-		if( smIn->nextState->cb_entering != NULL ) smIn->nextState->cb_entering(smIn, ((smIn->currState != NULL) ? smIn->currState->stateId : CXA_STATE_MACHINE_STATE_UNKNOWN), smIn->nextState->userVar);
+static void processTransition(cxa_stateMachine_t *const smIn)
+{
+	cxa_assert(smIn);
+	if( smIn->nextState == NULL ) return;
 
-		// actually do our transition
-		cxa_stateMachine_state_t* prevState = smIn->currState;
-		smIn->currState = smIn->nextState;
-		smIn->nextState = NULL;
+	// call the leaving function of our old state
+	if( smIn->currState != NULL )
+	{
+		if( smIn->currState->cb_leaving != NULL ) smIn->currState->cb_leaving(smIn, smIn->nextState->stateId, smIn->currState->userVar);
+	}
 
-		#ifdef CXA_STATE_MACHINE_ENABLE_LOGGING
-			cxa_logger_info(&smIn->logger, "new state: '%s'", smIn->currState->stateName);
-		#endif
+	// call the entering function of our new state
+	if( smIn->nextState->cb_entering != NULL ) smIn->nextState->cb_entering(smIn, ((smIn->currState != NULL) ? smIn->currState->stateId : CXA_STATE_MACHINE_STATE_UNKNOWN), smIn->nextState->userVar);
+
+	// actually do our transition
+	cxa_stateMachine_state_t* prevState = smIn->currState;
+	smIn->currState = smIn->nextState;
+	smIn->nextState = NULL;
+	smIn->isStateUpdatePending = true;
+
+	#ifdef CXA_STATE_MACHINE_ENABLE_LOGGING
+		cxa_logger_info(&smIn->logger, "new state: '%s'", smIn->currState->stateName);
+	#endif
 
-		// call the left function of our previous state
-		if( prevState != NULL )
+	// call the left function of our previous state
+	if( prevState != NULL )
+	{
+		if( prevState->cb_left != NULL ) prevState->cb_left(smIn, smIn->currState->stateId, prevState->userVar);
+	}
+
+	// call the entered function of our new state
+	if( smIn->currState->cb_entered != NULL ) smIn->currState->cb_entered(smIn, ((prevState != NULL) ? prevState->stateId : CXA_STATE_MACHINE_STATE_UNKNOWN), smIn->currState->userVar);
+
+	#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
+		if( smIn->timedStatesEnabled && (smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) ) cxa_timeDiff_setStartTime_now(&smIn->td_timedTransition);
+	#endif
+}
+
+
+static void updateCurrentState(cxa_stateMachine_t *const smIn)
+{
+	cxa_assert(smIn);
+	smIn->isStateUpdatePending = false;
+
+	#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
+		// see if our state's time has expired...if so, transition into our next state
+		if(  smIn->timedStatesEnabled &&
+			(smIn->currState != NULL) &&
+			(smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) &&
+			 cxa_timeDiff_isElapsed_ms(&smIn->td_timedTransition, smIn->currState->stateTime_ms) )
 		{
-			if( prevState->cb_left != NULL ) prevState->cb_left(smIn, smIn->currState->stateId, prevState->userVar);
+			cxa_stateMachine_transition(smIn, smIn->currState->nextStateId);
+			return;
 		}
+	#endif
+
+	// keep updating our state
+	if( (smIn->currState != NULL) && (smIn->currState->cb_state != NULL) ) smIn->currState->cb_state(smIn, smIn->currState->userVar);
+}
 
-		// call the entered function of our new state
-		if( smIn->currState->cb_entered != NULL ) smIn->currState->cb_entered(smIn, ((prevState != NULL) ? prevState->stateId : CXA_STATE_MACHINE_STATE_UNKNOWN), smIn->currState->userVar);
 
-		#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
-			if( smIn->timedStatesEnabled && (smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) ) cxa_timeDiff_setStartTime_now(&smIn->td_timedTransition);
-		#endif
-	}
-	else
+#ifdef CXA_STATE_MACHINE_ENABLE_EVENTS
+static void dispatchEvents(cxa_stateMachine_t *const smIn)
+{
+	cxa_assert(smIn);
+
+	// stop at the first event which causes a transition (the rest should see our new state)
+	int currEventId;
+	while( (smIn->nextState == NULL) && cxa_fixedFifo_dequeue(&smIn->eventQueue, (void*)&currEventId) )
 	{
-		#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
-			// see if our state's time has expired...if so, transition into our next state
-			if(  smIn->timedStatesEnabled &&
-				(smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) &&
-				 cxa_timeDiff_isElapsed_ms(&smIn->td_timedTransition, smIn->currState->stateTime_ms) )
+		int currStateId = cxa_stateMachine_getCurrentState(smIn);
+
+		cxa_array_iterate(&smIn->eventTransitions, currTransition, cxa_stateMachine_eventTransition_t)
+		{
+			if( currTransition == NULL ) continue;
+
+			if( (currTransition->eventId != currEventId) ||
+				((currTransition->fromStateId != CXA_STATE_MACHINE_STATE_UNKNOWN) && (currTransition->fromStateId != currStateId)) ) continue;
+
+			if( (currTransition->cb_guard == NULL) || currTransition->cb_guard(smIn, currEventId, currTransition->userVar) )
 			{
-				cxa_stateMachine_transition(smIn, smIn->currState->nextStateId);
-				return;
+				cxa_stateMachine_transition(smIn, currTransition->toStateId);
+				break;
 			}
-		#endif
-
-		// keep updating our state
-		if( (smIn->currState != NULL) && (smIn->currState->cb_state != NULL) ) smIn->currState->cb_state(smIn, smIn->currState->userVar);
+		}
 	}
 }
+#endif
 
 
 static cxa_stateMachine_state_t* getState_byId(cxa_stateMachine_t *const smIn, int idIn)
 {
 	cxa_assert(smIn);
 
+	// states are usually added in order of their (enum) ids...so try a direct index first
+	if( idIn >= 0 )
+	{
+		cxa_stateMachine_state_t* indexedState = (cxa_stateMachine_state_t*)cxa_array_get(&smIn->states, (size_t)idIn);
+		if( (indexedState != NULL) && (indexedState->stateId == idIn) ) return indexedState;
+	}
+
 	for( size_t i = 0; i < cxa_array_getSize_elems(&smIn->states); i++ )
 	{
 		cxa_stateMachine_state_t* currState = (cxa_stateMachine_state_t*)cxa_array_get(&smIn->states, i);
@@ -18,9 +18,15 @@
 
 
 // ******** local function prototypes ********
+static inline uint64_t getNow_us(void);
+static inline uint64_t getElapsed_us(cxa_timeDiff_t *const tdIn, uint64_t now_usIn);
 
 
 // ********  local variable declarations *********
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+static CXA_TIMEDIFF_THREAD_LOCAL bool isNowCached = false;
+static CXA_TIMEDIFF_THREAD_LOCAL uint64_t cachedNow_us;
+#endif
 
 
 // ******** global function implementations ********
@@ -36,7 +42,7 @@ void cxa_timeDiff_setStartTime_now(cxa_timeDiff_t *const tdIn)
 {
 	cxa_assert(tdIn);
 
-	tdIn->startTime_us = cxa_timeBase_getCount_us();
+	tdIn->startTime_us = getNow_us();
 }
 
 
@@ -44,11 +50,16 @@ uint32_t cxa_timeDiff_getElapsedTime_ms(cxa_timeDiff_t *const tdIn)
 {
 	cxa_assert(tdIn);
 
-	uint32_t curr_us = cxa_timeBase_getCount_us();
-	uint32_t elapsedTime_us = (curr_us >= tdIn->startTime_us) ?
-							  (curr_us - tdIn->startTime_us) :
-							  ((cxa_timeBase_getMaxCount_us() - tdIn->startTime_us) + curr_us);
-	return elapsedTime_us / 1000;
+	uint64_t elapsedTime_ms = getElapsed_us(tdIn, getNow_us()) / 1000;
+	return (elapsedTime_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsedTime_ms;
+}
+
+
+uint64_t cxa_timeDiff_getElapsedTime_us(cxa_timeDiff_t *const tdIn)
+{
+	cxa_assert(tdIn);
+
+	return getElapsed_us(tdIn, getNow_us());
 }
 
 
@@ -56,7 +67,15 @@ bool cxa_timeDiff_isElapsed_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn)
 {
 	cxa_assert(tdIn);
 
-	return (cxa_timeDiff_getElapsedTime_ms(tdIn) >= msIn);
+	return (getElapsed_us(tdIn, getNow_us()) >= ((uint64_t)msIn * 1000));
+}
+
+
+bool cxa_timeDiff_isElapsed_uncached_ms(cxa_timeDiff_t *const tdIn, uint32_t msIn)
+{
+	cxa_assert(tdIn);
+
+	return (getElapsed_us(tdIn, cxa_timeBase_getCount64_us()) >= ((uint64_t)msIn * 1000));
 }
 
 
@@ -71,4 +90,33 @@ bool cxa_timeDiff_isElapsed_recurring_ms(cxa_timeDiff_t *const tdIn, uint32_t ms
 }
 
 
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+void cxa_timeDiff_setCachedNow(uint64_t now_usIn)
+{
+	cachedNow_us = now_usIn;
+	isNowCached = true;
+}
+
+
+void cxa_timeDiff_clearCachedNow(void)
+{
+	isNowCached = false;
+}
+#endif
+
+
 // ******** local function implementations ********
+static inline uint64_t getNow_us(void)
+{
+#ifdef CXA_RUNLOOP_CACHED_NOW_ENABLE
+	if( isNowCached ) return cachedNow_us;
+#endif
+	return cxa_timeBase_getCount64_us();
+}
+
+
+static inline uint64_t getElapsed_us(cxa_timeDiff_t *const tdIn, uint64_t now_usIn)
+{
+	// a startTime taken from a fresh read may be slightly ahead of a cached "now"
+	return (now_usIn > tdIn->startTime_us) ? (now_usIn - tdIn->startTime_us) : 0;
+}